@@ -7,11 +7,15 @@ typedef void JNIEnv;
 typedef void* jclass;
 typedef void* jdoubleArray;
 typedef void* jintArray;
+typedef void* jlongArray;
 typedef void* jstring;
 typedef double jdouble;
 typedef int jint;
 typedef int jsize;
 typedef void* jobjectArray;
+typedef void* jfloatArray;
+typedef float jfloat;
+typedef long long jlong;
 typedef unsigned char jboolean;
 #ifndef JNI_TRUE
 #define JNI_TRUE 1
@@ -23,12 +27,19 @@ typedef unsigned char jboolean;
 #define JNICALL
 #endif
 
+#include <algorithm>
+#include <cstdint>
 #include <vector>
 #include <string>
+#include <string_view>
 
 #include "../../../../shared/cpp/ClusterEngine.hpp"
 #include "../../../../shared/cpp/GeometryEngine.hpp"
 #include "../../../../shared/cpp/ColorParser.hpp"
+#include "../../../../shared/cpp/HeatmapRasterizer.hpp"
+#include "../../../../shared/cpp/TrajectoryAnalyzer.hpp"
+#include "../../../../shared/cpp/GpsSmoother.hpp"
+#include "../../../../shared/cpp/PathSimilarity.hpp"
 
 extern "C" JNIEXPORT jintArray JNICALL
 Java_expo_modules_gaodemap_utils_ClusterNative_clusterPoints(
@@ -126,19 +137,13 @@ Java_expo_modules_gaodemap_utils_GeometryUtils_nativeGetNearestPointOnPath(
     jdouble* latValues = env->GetDoubleArrayElements(latitudes, nullptr);
     jdouble* lonValues = env->GetDoubleArrayElements(longitudes, nullptr);
 
-    std::vector<gaodemap::GeoPoint> points;
-    points.reserve(static_cast<size_t>(countLat));
-
-    for (jsize i = 0; i < countLat; ++i) {
-        points.push_back({latValues[i], lonValues[i]});
-    }
+    const gaodemap::CoordSpan points(latValues, lonValues, static_cast<size_t>(countLat));
+    gaodemap::GeoPoint target = {static_cast<double>(targetLat), static_cast<double>(targetLon)};
+    gaodemap::NearestPointResult result = gaodemap::getNearestPointOnPath(points, target);
 
     env->ReleaseDoubleArrayElements(latitudes, latValues, JNI_ABORT);
     env->ReleaseDoubleArrayElements(longitudes, lonValues, JNI_ABORT);
 
-    gaodemap::GeoPoint target = {static_cast<double>(targetLat), static_cast<double>(targetLon)};
-    gaodemap::NearestPointResult result = gaodemap::getNearestPointOnPath(points, target);
-
     jdoubleArray resultArray = env->NewDoubleArray(4);
     if (resultArray == nullptr) return nullptr;
     
@@ -208,21 +213,17 @@ Java_expo_modules_gaodemap_utils_GeometryUtils_nativeIsPointInPolygon(
     jdouble* latValues = env->GetDoubleArrayElements(latitudes, nullptr);
     jdouble* lonValues = env->GetDoubleArrayElements(longitudes, nullptr);
 
-    std::vector<gaodemap::GeoPoint> polygon;
-    polygon.reserve(static_cast<size_t>(countLat));
-
-    for (jsize i = 0; i < countLat; ++i) {
-        polygon.push_back({latValues[i], lonValues[i]});
-    }
+    const gaodemap::CoordSpan polygon(latValues, lonValues, static_cast<size_t>(countLat));
+    const bool inside = gaodemap::isPointInPolygon(
+        static_cast<double>(pointLat),
+        static_cast<double>(pointLon),
+        polygon
+    );
 
     env->ReleaseDoubleArrayElements(latitudes, latValues, JNI_ABORT);
     env->ReleaseDoubleArrayElements(longitudes, lonValues, JNI_ABORT);
 
-    return gaodemap::isPointInPolygon(
-        static_cast<double>(pointLat),
-        static_cast<double>(pointLon),
-        polygon
-    ) ? JNI_TRUE : JNI_FALSE;
+    return inside ? JNI_TRUE : JNI_FALSE;
 #else
     (void)env;
     (void)pointLat;
@@ -233,6 +234,54 @@ Java_expo_modules_gaodemap_utils_GeometryUtils_nativeIsPointInPolygon(
 #endif
 }
 
+extern "C" JNIEXPORT jlongArray JNICALL
+Java_expo_modules_gaodemap_utils_GeometryUtils_nativePointsInPolygon(
+    JNIEnv* env,
+    jclass,
+    jdoubleArray pointLatitudes,
+    jdoubleArray pointLongitudes,
+    jdoubleArray latitudes,
+    jdoubleArray longitudes
+) {
+#if GAODE_HAVE_JNI
+    if (!pointLatitudes || !pointLongitudes || !latitudes || !longitudes) {
+        return nullptr;
+    }
+
+    const jsize pointCount = env->GetArrayLength(pointLatitudes);
+    const jsize countLat = env->GetArrayLength(latitudes);
+    if (pointCount != env->GetArrayLength(pointLongitudes) || countLat != env->GetArrayLength(longitudes)) {
+        return nullptr;
+    }
+
+    jdouble* pointLatValues = env->GetDoubleArrayElements(pointLatitudes, nullptr);
+    jdouble* pointLonValues = env->GetDoubleArrayElements(pointLongitudes, nullptr);
+    jdouble* latValues = env->GetDoubleArrayElements(latitudes, nullptr);
+    jdouble* lonValues = env->GetDoubleArrayElements(longitudes, nullptr);
+
+    // 位图布局与 java.util.BitSet.valueOf(long[]) 一致
+    std::vector<uint64_t> bits((static_cast<size_t>(pointCount) + 63) / 64);
+    gaodemap::pointsInPolygon(
+        gaodemap::CoordSpan(latValues, lonValues, static_cast<size_t>(countLat)),
+        gaodemap::CoordSpan(pointLatValues, pointLonValues, static_cast<size_t>(pointCount)),
+        bits.data()
+    );
+
+    env->ReleaseDoubleArrayElements(pointLatitudes, pointLatValues, JNI_ABORT);
+    env->ReleaseDoubleArrayElements(pointLongitudes, pointLonValues, JNI_ABORT);
+    env->ReleaseDoubleArrayElements(latitudes, latValues, JNI_ABORT);
+    env->ReleaseDoubleArrayElements(longitudes, lonValues, JNI_ABORT);
+
+    jlongArray result = env->NewLongArray(static_cast<jsize>(bits.size()));
+    if (result == nullptr) return nullptr;
+    env->SetLongArrayRegion(result, 0, static_cast<jsize>(bits.size()), reinterpret_cast<const jlong*>(bits.data()));
+    return result;
+#else
+    (void)env; (void)pointLatitudes; (void)pointLongitudes; (void)latitudes; (void)longitudes;
+    return nullptr;
+#endif
+}
+
 extern "C" JNIEXPORT jint JNICALL
 Java_expo_modules_gaodemap_utils_GeometryUtils_nativeFindPointInPolygons(
     JNIEnv* env,
@@ -287,7 +336,8 @@ Java_expo_modules_gaodemap_utils_GeometryUtils_nativeCalculatePolygonArea(
     JNIEnv* env,
     jclass,
     jdoubleArray latitudes,
-    jdoubleArray longitudes
+    jdoubleArray longitudes,
+    jint earthModel
 ) {
 #if GAODE_HAVE_JNI
     if (!latitudes || !longitudes) {
@@ -303,21 +353,21 @@ Java_expo_modules_gaodemap_utils_GeometryUtils_nativeCalculatePolygonArea(
     jdouble* latValues = env->GetDoubleArrayElements(latitudes, nullptr);
     jdouble* lonValues = env->GetDoubleArrayElements(longitudes, nullptr);
 
-    std::vector<gaodemap::GeoPoint> polygon;
-    polygon.reserve(static_cast<size_t>(countLat));
-
-    for (jsize i = 0; i < countLat; ++i) {
-        polygon.push_back({latValues[i], lonValues[i]});
-    }
+    const gaodemap::CoordSpan polygon(latValues, lonValues, static_cast<size_t>(countLat));
+    const jdouble result = static_cast<jdouble>(gaodemap::calculatePolygonArea(
+        polygon,
+        earthModel == 1 ? gaodemap::EarthModel::WGS84 : gaodemap::EarthModel::Sphere
+    ));
 
     env->ReleaseDoubleArrayElements(latitudes, latValues, JNI_ABORT);
     env->ReleaseDoubleArrayElements(longitudes, lonValues, JNI_ABORT);
 
-    return static_cast<jdouble>(gaodemap::calculatePolygonArea(polygon));
+    return result;
 #else
     (void)env;
     (void)latitudes;
     (void)longitudes;
+    (void)earthModel;
     return 0.0;
 #endif
 }
@@ -356,7 +406,8 @@ Java_expo_modules_gaodemap_utils_GeometryUtils_nativeCalculateDistance(
     jdouble lat1,
     jdouble lon1,
     jdouble lat2,
-    jdouble lon2
+    jdouble lon2,
+    jint earthModel
 ) {
 #if GAODE_HAVE_JNI
     (void)env;
@@ -364,7 +415,8 @@ Java_expo_modules_gaodemap_utils_GeometryUtils_nativeCalculateDistance(
         static_cast<double>(lat1),
         static_cast<double>(lon1),
         static_cast<double>(lat2),
-        static_cast<double>(lon2)
+        static_cast<double>(lon2),
+        earthModel == 1 ? gaodemap::EarthModel::WGS84 : gaodemap::EarthModel::Sphere
     ));
 #else
     (void)env;
@@ -372,11 +424,13 @@ Java_expo_modules_gaodemap_utils_GeometryUtils_nativeCalculateDistance(
     (void)lon1;
     (void)lat2;
     (void)lon2;
+    (void)earthModel;
     return 0.0;
 #endif
 }
 
-extern "C" JNIEXPORT jint JNICALL
+// 返回 0xAARRGGBB（0 ~ 0xFFFFFFFF），解析失败返回 -1，与合法的 transparent (0) 区分
+extern "C" JNIEXPORT jlong JNICALL
 Java_expo_modules_gaodemap_utils_ColorParser_nativeParseColor(
     JNIEnv* env,
     jclass,
@@ -384,20 +438,22 @@ Java_expo_modules_gaodemap_utils_ColorParser_nativeParseColor(
 ) {
 #if GAODE_HAVE_JNI
     if (!colorString) {
-        return 0; // Black or 0
+        return -1;
     }
     const char* nativeString = env->GetStringUTFChars(colorString, nullptr);
     if (!nativeString) {
-        return 0;
+        return -1;
     }
-    std::string str(nativeString);
+    // 直接解析 JNI 返回的 UTF-8 缓冲区，释放前完成，不再复制到 std::string
+    uint32_t color = 0;
+    const bool ok = gaodemap::tryParseColor(std::string_view(nativeString), color);
     env->ReleaseStringUTFChars(colorString, nativeString);
 
-    return static_cast<jint>(gaodemap::parseColor(str));
+    return ok ? static_cast<jlong>(color) : -1;
 #else
     (void)env;
     (void)colorString;
-    return 0;
+    return -1;
 #endif
 }
 
@@ -423,18 +479,12 @@ Java_expo_modules_gaodemap_utils_GeometryUtils_nativeSimplifyPolyline(
     jdouble* latValues = env->GetDoubleArrayElements(latitudes, nullptr);
     jdouble* lonValues = env->GetDoubleArrayElements(longitudes, nullptr);
 
-    std::vector<gaodemap::GeoPoint> points;
-    points.reserve(static_cast<size_t>(countLat));
-
-    for (jsize i = 0; i < countLat; ++i) {
-        points.push_back({latValues[i], lonValues[i]});
-    }
+    const gaodemap::CoordSpan points(latValues, lonValues, static_cast<size_t>(countLat));
+    const auto simplified = gaodemap::simplifyPolyline(points, static_cast<double>(toleranceMeters));
 
     env->ReleaseDoubleArrayElements(latitudes, latValues, JNI_ABORT);
     env->ReleaseDoubleArrayElements(longitudes, lonValues, JNI_ABORT);
 
-    const auto simplified = gaodemap::simplifyPolyline(points, static_cast<double>(toleranceMeters));
-
     jdoubleArray result = env->NewDoubleArray(static_cast<jsize>(simplified.size() * 2));
     if (result == nullptr) {
         return nullptr;
@@ -463,7 +513,8 @@ Java_expo_modules_gaodemap_utils_GeometryUtils_nativeCalculatePathLength(
     JNIEnv* env,
     jclass,
     jdoubleArray latitudes,
-    jdoubleArray longitudes
+    jdoubleArray longitudes,
+    jint earthModel
 ) {
 #if GAODE_HAVE_JNI
     if (!latitudes || !longitudes) {
@@ -479,21 +530,21 @@ Java_expo_modules_gaodemap_utils_GeometryUtils_nativeCalculatePathLength(
     jdouble* latValues = env->GetDoubleArrayElements(latitudes, nullptr);
     jdouble* lonValues = env->GetDoubleArrayElements(longitudes, nullptr);
 
-    std::vector<gaodemap::GeoPoint> points;
-    points.reserve(static_cast<size_t>(countLat));
-
-    for (jsize i = 0; i < countLat; ++i) {
-        points.push_back({latValues[i], lonValues[i]});
-    }
+    const gaodemap::CoordSpan points(latValues, lonValues, static_cast<size_t>(countLat));
+    const jdouble result = static_cast<jdouble>(gaodemap::calculatePathLength(
+        points,
+        earthModel == 1 ? gaodemap::EarthModel::WGS84 : gaodemap::EarthModel::Sphere
+    ));
 
     env->ReleaseDoubleArrayElements(latitudes, latValues, JNI_ABORT);
     env->ReleaseDoubleArrayElements(longitudes, lonValues, JNI_ABORT);
 
-    return static_cast<jdouble>(gaodemap::calculatePathLength(points));
+    return result;
 #else
     (void)env;
     (void)latitudes;
     (void)longitudes;
+    (void)earthModel;
     return 0.0;
 #endif
 }
@@ -520,19 +571,13 @@ Java_expo_modules_gaodemap_utils_GeometryUtils_nativeGetPointAtDistance(
     jdouble* latValues = env->GetDoubleArrayElements(latitudes, nullptr);
     jdouble* lonValues = env->GetDoubleArrayElements(longitudes, nullptr);
 
-    std::vector<gaodemap::GeoPoint> points;
-    points.reserve(static_cast<size_t>(countLat));
-
-    for (jsize i = 0; i < countLat; ++i) {
-        points.push_back({latValues[i], lonValues[i]});
-    }
+    const gaodemap::CoordSpan points(latValues, lonValues, static_cast<size_t>(countLat));
+    double outLat, outLon, outAngle;
+    bool success = gaodemap::getPointAtDistance(points, static_cast<double>(distanceMeters), &outLat, &outLon, &outAngle);
 
     env->ReleaseDoubleArrayElements(latitudes, latValues, JNI_ABORT);
     env->ReleaseDoubleArrayElements(longitudes, lonValues, JNI_ABORT);
 
-    double outLat, outLon, outAngle;
-    bool success = gaodemap::getPointAtDistance(points, static_cast<double>(distanceMeters), &outLat, &outLon, &outAngle);
-
     if (success) {
         jdoubleArray result = env->NewDoubleArray(3);
         if (result == nullptr) return nullptr;
@@ -573,18 +618,12 @@ Java_expo_modules_gaodemap_utils_GeometryUtils_nativeCalculatePathBounds(
     jdouble* latValues = env->GetDoubleArrayElements(latitudes, nullptr);
     jdouble* lonValues = env->GetDoubleArrayElements(longitudes, nullptr);
 
-    std::vector<gaodemap::GeoPoint> points;
-    points.reserve(static_cast<size_t>(countLat));
-
-    for (jsize i = 0; i < countLat; ++i) {
-        points.push_back({latValues[i], lonValues[i]});
-    }
+    const gaodemap::CoordSpan points(latValues, lonValues, static_cast<size_t>(countLat));
+    gaodemap::PathBounds bounds = gaodemap::calculatePathBounds(points);
 
     env->ReleaseDoubleArrayElements(latitudes, latValues, JNI_ABORT);
     env->ReleaseDoubleArrayElements(longitudes, lonValues, JNI_ABORT);
 
-    gaodemap::PathBounds bounds = gaodemap::calculatePathBounds(points);
-
     jdoubleArray resultArray = env->NewDoubleArray(6);
     if (resultArray == nullptr) return nullptr;
     
@@ -632,16 +671,8 @@ Java_expo_modules_gaodemap_utils_GeometryUtils_nativeCalculateFitZoom(
     jdouble* latValues = env->GetDoubleArrayElements(latitudes, nullptr);
     jdouble* lonValues = env->GetDoubleArrayElements(longitudes, nullptr);
 
-    std::vector<gaodemap::GeoPoint> points;
-    points.reserve(static_cast<size_t>(countLat));
-    for (jsize i = 0; i < countLat; ++i) {
-        points.push_back({latValues[i], lonValues[i]});
-    }
-
-    env->ReleaseDoubleArrayElements(latitudes, latValues, JNI_ABORT);
-    env->ReleaseDoubleArrayElements(longitudes, lonValues, JNI_ABORT);
-
-    return static_cast<jdouble>(gaodemap::calculateFitZoomForPoints(
+    const gaodemap::CoordSpan points(latValues, lonValues, static_cast<size_t>(countLat));
+    const jdouble result = static_cast<jdouble>(gaodemap::calculateFitZoomForPoints(
         points,
         static_cast<double>(viewportWidthPx),
         static_cast<double>(viewportHeightPx),
@@ -649,6 +680,11 @@ Java_expo_modules_gaodemap_utils_GeometryUtils_nativeCalculateFitZoom(
         static_cast<int>(minZoom),
         static_cast<int>(maxZoom)
     ));
+
+    env->ReleaseDoubleArrayElements(latitudes, latValues, JNI_ABORT);
+    env->ReleaseDoubleArrayElements(longitudes, lonValues, JNI_ABORT);
+
+    return result;
 #else
     (void)env;
     (void)latitudes;
@@ -683,18 +719,12 @@ Java_expo_modules_gaodemap_utils_GeometryUtils_nativeCalculateCentroid(
     jdouble* latValues = env->GetDoubleArrayElements(latitudes, nullptr);
     jdouble* lonValues = env->GetDoubleArrayElements(longitudes, nullptr);
 
-    std::vector<gaodemap::GeoPoint> polygon;
-    polygon.reserve(static_cast<size_t>(countLat));
-
-    for (jsize i = 0; i < countLat; ++i) {
-        polygon.push_back({latValues[i], lonValues[i]});
-    }
+    const gaodemap::CoordSpan polygon(latValues, lonValues, static_cast<size_t>(countLat));
+    gaodemap::GeoPoint centroid = gaodemap::calculateCentroid(polygon);
 
     env->ReleaseDoubleArrayElements(latitudes, latValues, JNI_ABORT);
     env->ReleaseDoubleArrayElements(longitudes, lonValues, JNI_ABORT);
 
-    gaodemap::GeoPoint centroid = gaodemap::calculateCentroid(polygon);
-
     jdoubleArray result = env->NewDoubleArray(2);
     if (result == nullptr) return nullptr;
     
@@ -775,6 +805,175 @@ Java_expo_modules_gaodemap_utils_GeometryUtils_nativeParsePolyline(
 #endif
 }
 
+extern "C" JNIEXPORT jdoubleArray JNICALL
+Java_expo_modules_gaodemap_utils_GeometryUtils_nativeParsePolylineRings(
+    JNIEnv* env,
+    jclass,
+    jstring polylineStr,
+    jboolean dedupeAdjacent
+) {
+#if GAODE_HAVE_JNI
+    if (!polylineStr) {
+        return nullptr;
+    }
+
+    const char* nativeString = env->GetStringUTFChars(polylineStr, nullptr);
+    if (!nativeString) return nullptr;
+
+    std::string cppPolylineStr(nativeString);
+    env->ReleaseStringUTFChars(polylineStr, nativeString);
+
+    const gaodemap::PolylineRings rings = gaodemap::parsePolylineRings(cppPolylineStr, dedupeAdjacent == JNI_TRUE);
+
+    // 编码格式: [ringCount, offset0, ..., offsetN(=pointCount), lat0, lon0, lat1, lon1, ...]
+    const size_t ringCount = rings.ringOffsets.size() - 1;
+    const size_t totalSize = 1 + rings.ringOffsets.size() + rings.points.size() * 2;
+
+    std::vector<jdouble> buffer;
+    buffer.reserve(totalSize);
+    buffer.push_back(static_cast<jdouble>(ringCount));
+    for (int offset : rings.ringOffsets) {
+        buffer.push_back(static_cast<jdouble>(offset));
+    }
+    for (const auto& p : rings.points) {
+        buffer.push_back(p.lat);
+        buffer.push_back(p.lon);
+    }
+
+    jdoubleArray result = env->NewDoubleArray(static_cast<jsize>(buffer.size()));
+    if (result == nullptr) return nullptr;
+    env->SetDoubleArrayRegion(result, 0, static_cast<jsize>(buffer.size()), buffer.data());
+    return result;
+#else
+    (void)env;
+    (void)polylineStr;
+    (void)dedupeAdjacent;
+    return nullptr;
+#endif
+}
+
+extern "C" JNIEXPORT jstring JNICALL
+Java_expo_modules_gaodemap_utils_GeometryUtils_nativeEncodePolyline(
+    JNIEnv* env,
+    jclass,
+    jdoubleArray latitudes,
+    jdoubleArray longitudes,
+    jint precision
+) {
+#if GAODE_HAVE_JNI
+    if (!latitudes || !longitudes) {
+        return env->NewStringUTF("");
+    }
+
+    const jsize countLat = env->GetArrayLength(latitudes);
+    const jsize countLon = env->GetArrayLength(longitudes);
+    if (countLat == 0 || countLat != countLon) {
+        return env->NewStringUTF("");
+    }
+
+    jdouble* latValues = env->GetDoubleArrayElements(latitudes, nullptr);
+    jdouble* lonValues = env->GetDoubleArrayElements(longitudes, nullptr);
+
+    const gaodemap::CoordSpan points(latValues, lonValues, static_cast<size_t>(countLat));
+    // 编码结果只包含 ASCII 63~126，可直接作为 Modified UTF-8 传入
+    const std::string encoded = gaodemap::encodePolyline(points, static_cast<int>(precision));
+
+    env->ReleaseDoubleArrayElements(latitudes, latValues, JNI_ABORT);
+    env->ReleaseDoubleArrayElements(longitudes, lonValues, JNI_ABORT);
+    return env->NewStringUTF(encoded.c_str());
+#else
+    (void)env;
+    (void)latitudes;
+    (void)longitudes;
+    (void)precision;
+    return nullptr;
+#endif
+}
+
+extern "C" JNIEXPORT jdoubleArray JNICALL
+Java_expo_modules_gaodemap_utils_GeometryUtils_nativeDecodePolyline(
+    JNIEnv* env,
+    jclass,
+    jstring encoded,
+    jint precision
+) {
+#if GAODE_HAVE_JNI
+    if (!encoded) {
+        return nullptr;
+    }
+
+    const char* nativeString = env->GetStringUTFChars(encoded, nullptr);
+    if (!nativeString) return nullptr;
+
+    std::string cppEncoded(nativeString);
+    env->ReleaseStringUTFChars(encoded, nativeString);
+
+    const auto points = gaodemap::decodePolyline(cppEncoded, static_cast<int>(precision));
+
+    jdoubleArray result = env->NewDoubleArray(static_cast<jsize>(points.size() * 2));
+    if (result == nullptr) return nullptr;
+    if (points.empty()) return result;
+
+    // GeoPoint 为两个连续 double，可直接作为扁平 [lat, lon, ...] 缓冲区写入
+    static_assert(sizeof(gaodemap::GeoPoint) == sizeof(jdouble) * 2, "GeoPoint must be two packed doubles");
+    env->SetDoubleArrayRegion(result, 0, static_cast<jsize>(points.size() * 2), reinterpret_cast<const jdouble*>(points.data()));
+    return result;
+#else
+    (void)env;
+    (void)encoded;
+    (void)precision;
+    return nullptr;
+#endif
+}
+
+extern "C" JNIEXPORT jdoubleArray JNICALL
+Java_expo_modules_gaodemap_utils_GeometryUtils_nativeResamplePolyline(
+    JNIEnv* env,
+    jclass,
+    jdoubleArray latitudes,
+    jdoubleArray longitudes,
+    jdouble spacingMeters,
+    jint count,
+    jdouble cornerAngleDegrees
+) {
+#if GAODE_HAVE_JNI
+    if (!latitudes || !longitudes) {
+        return nullptr;
+    }
+
+    const jsize countLat = env->GetArrayLength(latitudes);
+    if (countLat != env->GetArrayLength(longitudes)) {
+        return nullptr;
+    }
+
+    jdouble* latValues = env->GetDoubleArrayElements(latitudes, nullptr);
+    jdouble* lonValues = env->GetDoubleArrayElements(longitudes, nullptr);
+
+    // count > 0 时按个数，否则按间距；cornerAngleDegrees > 0 时保留转角
+    const gaodemap::CoordSpan span(latValues, lonValues, static_cast<size_t>(countLat));
+    std::vector<gaodemap::GeoPoint> points;
+    if (count > 0) {
+        points = gaodemap::resamplePolylineByCount(span, static_cast<size_t>(count));
+    } else if (cornerAngleDegrees > 0.0) {
+        points = gaodemap::resamplePolylinePreservingCorners(span, spacingMeters, cornerAngleDegrees);
+    } else {
+        points = gaodemap::resamplePolyline(span, spacingMeters);
+    }
+
+    env->ReleaseDoubleArrayElements(latitudes, latValues, JNI_ABORT);
+    env->ReleaseDoubleArrayElements(longitudes, lonValues, JNI_ABORT);
+
+    jdoubleArray result = env->NewDoubleArray(static_cast<jsize>(points.size() * 2));
+    if (result == nullptr) return nullptr;
+    if (points.empty()) return result;
+    env->SetDoubleArrayRegion(result, 0, static_cast<jsize>(points.size() * 2), reinterpret_cast<const jdouble*>(points.data()));
+    return result;
+#else
+    (void)env; (void)latitudes; (void)longitudes; (void)spacingMeters; (void)count; (void)cornerAngleDegrees;
+    return nullptr;
+#endif
+}
+
 extern "C" JNIEXPORT jintArray JNICALL
 Java_expo_modules_gaodemap_utils_GeometryUtils_nativeLatLngToTile(
     JNIEnv* env,
@@ -855,37 +1054,363 @@ Java_expo_modules_gaodemap_utils_GeometryUtils_nativePixelToLatLng(
 #endif
 }
 
-extern "C" JNIEXPORT jdoubleArray JNICALL
-Java_expo_modules_gaodemap_utils_GeometryUtils_nativeGenerateHeatmapGrid(
+extern "C" JNIEXPORT jboolean JNICALL
+Java_expo_modules_gaodemap_utils_GeometryUtils_nativeConvertCoordinates(
     JNIEnv* env,
     jclass,
     jdoubleArray latitudes,
     jdoubleArray longitudes,
-    jdoubleArray weights,
-    jdouble gridSizeMeters
+    jint from,
+    jint to
 ) {
 #if GAODE_HAVE_JNI
-    if (!latitudes || !longitudes || !weights) return nullptr;
-    const jsize count = env->GetArrayLength(latitudes);
-    if (count == 0 || count != env->GetArrayLength(longitudes) || count != env->GetArrayLength(weights)) {
-        return nullptr;
+    if (!latitudes || !longitudes || from < 0 || from > 2 || to < 0 || to > 2) {
+        return JNI_FALSE;
     }
 
-    jdouble* latVals = env->GetDoubleArrayElements(latitudes, nullptr);
-    jdouble* lonVals = env->GetDoubleArrayElements(longitudes, nullptr);
-    jdouble* weightVals = env->GetDoubleArrayElements(weights, nullptr);
-
-    std::vector<gaodemap::HeatmapPoint> points;
-    points.reserve(count);
-    for (jsize i = 0; i < count; ++i) {
-        points.push_back({latVals[i], lonVals[i], weightVals[i]});
+    const jsize countLat = env->GetArrayLength(latitudes);
+    const jsize countLon = env->GetArrayLength(longitudes);
+    if (countLat != countLon) {
+        return JNI_FALSE;
     }
 
-    env->ReleaseDoubleArrayElements(latitudes, latVals, JNI_ABORT);
-    env->ReleaseDoubleArrayElements(longitudes, lonVals, JNI_ABORT);
-    env->ReleaseDoubleArrayElements(weights, weightVals, JNI_ABORT);
+    jdouble* latValues = env->GetDoubleArrayElements(latitudes, nullptr);
+    jdouble* lonValues = env->GetDoubleArrayElements(longitudes, nullptr);
+
+    gaodemap::convertCoordinates(
+        latValues,
+        lonValues,
+        static_cast<size_t>(countLat),
+        static_cast<gaodemap::CoordSystem>(from),
+        static_cast<gaodemap::CoordSystem>(to)
+    );
+
+    // 结果写回 Java 数组
+    env->ReleaseDoubleArrayElements(latitudes, latValues, 0);
+    env->ReleaseDoubleArrayElements(longitudes, lonValues, 0);
+    return JNI_TRUE;
+#else
+    (void)env; (void)latitudes; (void)longitudes; (void)from; (void)to;
+    return JNI_FALSE;
+#endif
+}
+
+extern "C" JNIEXPORT jdoubleArray JNICALL
+Java_expo_modules_gaodemap_utils_GeometryUtils_nativeClipToViewport(
+    JNIEnv* env,
+    jclass,
+    jdoubleArray latitudes,
+    jdoubleArray longitudes,
+    jboolean closed,
+    jdouble centerLat,
+    jdouble centerLon,
+    jdouble zoom,
+    jdouble width,
+    jdouble height,
+    jdouble margin,
+    jdouble tolerancePx
+) {
+#if GAODE_HAVE_JNI
+    if (!latitudes || !longitudes) {
+        return nullptr;
+    }
+
+    const jsize countLat = env->GetArrayLength(latitudes);
+    const jsize countLon = env->GetArrayLength(longitudes);
+    if (countLat != countLon) {
+        return nullptr;
+    }
+
+    jdouble* latValues = env->GetDoubleArrayElements(latitudes, nullptr);
+    jdouble* lonValues = env->GetDoubleArrayElements(longitudes, nullptr);
+
+    const gaodemap::CoordSpan span(latValues, lonValues, static_cast<size_t>(countLat));
+    const gaodemap::ScreenViewport viewport = gaodemap::makeScreenViewport(centerLat, centerLon, zoom, width, height, margin);
+    gaodemap::PolylineRings rings;
+    if (closed == JNI_TRUE) {
+        rings.points = gaodemap::clipPolygonToViewport(span, viewport, tolerancePx);
+        rings.ringOffsets.push_back(0);
+        if (!rings.points.empty()) rings.ringOffsets.push_back(static_cast<int>(rings.points.size()));
+    } else {
+        rings = gaodemap::clipPolylineToViewport(span, viewport, tolerancePx);
+    }
+
+    env->ReleaseDoubleArrayElements(latitudes, latValues, JNI_ABORT);
+    env->ReleaseDoubleArrayElements(longitudes, lonValues, JNI_ABORT);
+
+    // 编码格式同 nativeParsePolylineRings: [ringCount, offset0, ..., offsetN(=pointCount), lat0, lon0, ...]
+    std::vector<jdouble> buffer;
+    buffer.reserve(1 + rings.ringOffsets.size() + rings.points.size() * 2);
+    buffer.push_back(static_cast<jdouble>(rings.ringOffsets.size() - 1));
+    for (int offset : rings.ringOffsets) {
+        buffer.push_back(static_cast<jdouble>(offset));
+    }
+    for (const auto& p : rings.points) {
+        buffer.push_back(p.lat);
+        buffer.push_back(p.lon);
+    }
 
-    auto cells = gaodemap::generateHeatmapGrid(points, gridSizeMeters);
+    jdoubleArray result = env->NewDoubleArray(static_cast<jsize>(buffer.size()));
+    if (result == nullptr) return nullptr;
+    env->SetDoubleArrayRegion(result, 0, static_cast<jsize>(buffer.size()), buffer.data());
+    return result;
+#else
+    (void)env; (void)latitudes; (void)longitudes; (void)closed; (void)centerLat; (void)centerLon;
+    (void)zoom; (void)width; (void)height; (void)margin; (void)tolerancePx;
+    return nullptr;
+#endif
+}
+
+extern "C" JNIEXPORT jdoubleArray JNICALL
+Java_expo_modules_gaodemap_utils_GeometryUtils_nativeComputeClusterHulls(
+    JNIEnv* env,
+    jclass,
+    jdoubleArray latitudes,
+    jdoubleArray longitudes,
+    jintArray clusters,
+    jdouble maxEdgeMeters
+) {
+#if GAODE_HAVE_JNI
+    if (!latitudes || !longitudes || !clusters) {
+        return nullptr;
+    }
+
+    const jsize countLat = env->GetArrayLength(latitudes);
+    const jsize countLon = env->GetArrayLength(longitudes);
+    const jsize encodedLength = env->GetArrayLength(clusters);
+    if (countLat != countLon || encodedLength == 0) {
+        return nullptr;
+    }
+
+    // clusters 为 clusterPoints 的编码结果: [count, centerIndex, size, idx..., centerIndex, size, idx..., ...]
+    std::vector<jint> encoded(static_cast<size_t>(encodedLength));
+    env->GetIntArrayRegion(clusters, 0, encodedLength, encoded.data());
+    std::vector<gaodemap::ClusterOutput> outputs;
+    outputs.reserve(static_cast<size_t>(std::max(encoded[0], 0)));
+    size_t cursor = 1;
+    for (jint c = 0; c < encoded[0] && cursor + 2 <= encoded.size(); ++c) {
+        gaodemap::ClusterOutput cluster;
+        cluster.centerIndex = encoded[cursor];
+        const size_t size = static_cast<size_t>(std::max(encoded[cursor + 1], 0));
+        cursor += 2;
+        if (size > encoded.size() - cursor) {
+            return nullptr;
+        }
+        cluster.indices.assign(encoded.begin() + cursor, encoded.begin() + cursor + size);
+        cursor += size;
+        outputs.push_back(std::move(cluster));
+    }
+
+    jdouble* latValues = env->GetDoubleArrayElements(latitudes, nullptr);
+    jdouble* lonValues = env->GetDoubleArrayElements(longitudes, nullptr);
+
+    const gaodemap::CoordSpan span(latValues, lonValues, static_cast<size_t>(countLat));
+    const gaodemap::PolylineRings rings = gaodemap::computeClusterHulls(span, outputs, maxEdgeMeters);
+
+    env->ReleaseDoubleArrayElements(latitudes, latValues, JNI_ABORT);
+    env->ReleaseDoubleArrayElements(longitudes, lonValues, JNI_ABORT);
+
+    // 编码格式同 nativeParsePolylineRings，每个簇一个环
+    std::vector<jdouble> buffer;
+    buffer.reserve(1 + rings.ringOffsets.size() + rings.points.size() * 2);
+    buffer.push_back(static_cast<jdouble>(rings.ringOffsets.size() - 1));
+    for (int offset : rings.ringOffsets) {
+        buffer.push_back(static_cast<jdouble>(offset));
+    }
+    for (const auto& p : rings.points) {
+        buffer.push_back(p.lat);
+        buffer.push_back(p.lon);
+    }
+
+    jdoubleArray result = env->NewDoubleArray(static_cast<jsize>(buffer.size()));
+    if (result == nullptr) return nullptr;
+    env->SetDoubleArrayRegion(result, 0, static_cast<jsize>(buffer.size()), buffer.data());
+    return result;
+#else
+    (void)env; (void)latitudes; (void)longitudes; (void)clusters; (void)maxEdgeMeters;
+    return nullptr;
+#endif
+}
+
+extern "C" JNIEXPORT jdoubleArray JNICALL
+Java_expo_modules_gaodemap_utils_GeometryUtils_nativeAnalyzeTrajectory(
+    JNIEnv* env,
+    jclass,
+    jdoubleArray timestamps,
+    jdoubleArray latitudes,
+    jdoubleArray longitudes,
+    jdouble stopSpeedMps,
+    jdouble stopRadiusMeters,
+    jdouble minStopSeconds,
+    jdouble maxSpeedMps,
+    jdouble maxGapSeconds,
+    jboolean includeSegments
+) {
+#if GAODE_HAVE_JNI
+    if (!timestamps || !latitudes || !longitudes) {
+        return nullptr;
+    }
+
+    const jsize count = env->GetArrayLength(latitudes);
+    if (count != env->GetArrayLength(longitudes) || count != env->GetArrayLength(timestamps)) {
+        return nullptr;
+    }
+
+    gaodemap::TrajectoryOptions options;
+    options.stopSpeedMps = stopSpeedMps;
+    options.stopRadiusMeters = stopRadiusMeters;
+    options.minStopSeconds = minStopSeconds;
+    options.maxSpeedMps = maxSpeedMps;
+    options.maxGapSeconds = maxGapSeconds;
+    gaodemap::TrajectoryAnalyzer analyzer(options);
+
+    std::vector<gaodemap::TrajectorySegment> segments(includeSegments ? static_cast<size_t>(count) : 0);
+
+    jdouble* timeValues = env->GetDoubleArrayElements(timestamps, nullptr);
+    jdouble* latValues = env->GetDoubleArrayElements(latitudes, nullptr);
+    jdouble* lonValues = env->GetDoubleArrayElements(longitudes, nullptr);
+
+    analyzer.add(
+        timeValues,
+        gaodemap::CoordSpan(latValues, lonValues, static_cast<size_t>(count)),
+        includeSegments ? segments.data() : nullptr
+    );
+    analyzer.finish();
+
+    env->ReleaseDoubleArrayElements(timestamps, timeValues, JNI_ABORT);
+    env->ReleaseDoubleArrayElements(latitudes, latValues, JNI_ABORT);
+    env->ReleaseDoubleArrayElements(longitudes, lonValues, JNI_ABORT);
+
+    // 编码格式: [11 项统计, 每个停留 7 项 (lat, lon, start, end, firstIndex, lastIndex, pointCount), 每个点 3 项 (speed, heading, flags)]
+    const gaodemap::TrajectorySummary summary = analyzer.summary();
+    const std::vector<gaodemap::TrajectoryStop> stops = analyzer.takeStops();
+    std::vector<jdouble> buffer;
+    buffer.reserve(11 + stops.size() * 7 + segments.size() * 3);
+    buffer.push_back(static_cast<jdouble>(summary.pointCount));
+    buffer.push_back(static_cast<jdouble>(summary.acceptedCount));
+    buffer.push_back(static_cast<jdouble>(summary.outlierCount));
+    buffer.push_back(summary.totalDistanceMeters);
+    buffer.push_back(summary.totalSeconds);
+    buffer.push_back(summary.movingSeconds);
+    buffer.push_back(summary.stoppedSeconds);
+    buffer.push_back(summary.maxSpeedMps);
+    buffer.push_back(summary.averageSpeedMps);
+    buffer.push_back(summary.movingAverageSpeedMps);
+    buffer.push_back(static_cast<jdouble>(stops.size()));
+    for (const auto& stop : stops) {
+        buffer.push_back(stop.lat);
+        buffer.push_back(stop.lon);
+        buffer.push_back(stop.startTime);
+        buffer.push_back(stop.endTime);
+        buffer.push_back(static_cast<jdouble>(stop.firstIndex));
+        buffer.push_back(static_cast<jdouble>(stop.lastIndex));
+        buffer.push_back(static_cast<jdouble>(stop.pointCount));
+    }
+    for (const auto& segment : segments) {
+        buffer.push_back(segment.speedMps);
+        buffer.push_back(segment.headingDegrees);
+        buffer.push_back(static_cast<jdouble>(segment.flags));
+    }
+
+    jdoubleArray result = env->NewDoubleArray(static_cast<jsize>(buffer.size()));
+    if (result == nullptr) return nullptr;
+    env->SetDoubleArrayRegion(result, 0, static_cast<jsize>(buffer.size()), buffer.data());
+    return result;
+#else
+    (void)env; (void)timestamps; (void)latitudes; (void)longitudes; (void)stopSpeedMps; (void)stopRadiusMeters;
+    (void)minStopSeconds; (void)maxSpeedMps; (void)maxGapSeconds; (void)includeSegments;
+    return nullptr;
+#endif
+}
+
+extern "C" JNIEXPORT jdoubleArray JNICALL
+Java_expo_modules_gaodemap_utils_GeometryUtils_nativeComparePaths(
+    JNIEnv* env,
+    jclass,
+    jdoubleArray referenceLatitudes,
+    jdoubleArray referenceLongitudes,
+    jdoubleArray latitudes,
+    jdoubleArray longitudes,
+    jdouble thresholdMeters
+) {
+#if GAODE_HAVE_JNI
+    if (!referenceLatitudes || !referenceLongitudes || !latitudes || !longitudes) {
+        return nullptr;
+    }
+
+    const jsize referenceCount = env->GetArrayLength(referenceLatitudes);
+    const jsize count = env->GetArrayLength(latitudes);
+    if (referenceCount != env->GetArrayLength(referenceLongitudes) || count != env->GetArrayLength(longitudes)) {
+        return nullptr;
+    }
+
+    jdouble* referenceLatValues = env->GetDoubleArrayElements(referenceLatitudes, nullptr);
+    jdouble* referenceLonValues = env->GetDoubleArrayElements(referenceLongitudes, nullptr);
+    jdouble* latValues = env->GetDoubleArrayElements(latitudes, nullptr);
+    jdouble* lonValues = env->GetDoubleArrayElements(longitudes, nullptr);
+
+    const gaodemap::CoordSpan reference(referenceLatValues, referenceLonValues, static_cast<size_t>(referenceCount));
+    const gaodemap::CoordSpan path(latValues, lonValues, static_cast<size_t>(count));
+    const gaodemap::PathSegmentIndex referenceIndex(reference);
+    const gaodemap::PathDeviation deviation = gaodemap::measurePathDeviation(referenceIndex, path, thresholdMeters);
+    const double reverse = gaodemap::directedHausdorffDistance(gaodemap::PathSegmentIndex(path), reference);
+    const double frechet = gaodemap::discreteFrechetDistance(reference, path);
+
+    env->ReleaseDoubleArrayElements(referenceLatitudes, referenceLatValues, JNI_ABORT);
+    env->ReleaseDoubleArrayElements(referenceLongitudes, referenceLonValues, JNI_ABORT);
+    env->ReleaseDoubleArrayElements(latitudes, latValues, JNI_ABORT);
+    env->ReleaseDoubleArrayElements(longitudes, lonValues, JNI_ABORT);
+
+    // [averageDeviation, maxDeviation, exceededCount, hausdorff, frechet]
+    const jdouble values[5] = {
+        deviation.averageMeters,
+        deviation.maxMeters,
+        static_cast<jdouble>(deviation.exceededCount),
+        std::max(deviation.maxMeters, reverse),
+        frechet
+    };
+    jdoubleArray result = env->NewDoubleArray(5);
+    if (result == nullptr) return nullptr;
+    env->SetDoubleArrayRegion(result, 0, 5, values);
+    return result;
+#else
+    (void)env; (void)referenceLatitudes; (void)referenceLongitudes; (void)latitudes; (void)longitudes; (void)thresholdMeters;
+    return nullptr;
+#endif
+}
+
+extern "C" JNIEXPORT jdoubleArray JNICALL
+Java_expo_modules_gaodemap_utils_GeometryUtils_nativeGenerateHeatmapGrid(
+    JNIEnv* env,
+    jclass,
+    jdoubleArray latitudes,
+    jdoubleArray longitudes,
+    jdoubleArray weights,
+    jdouble gridSizeMeters
+) {
+#if GAODE_HAVE_JNI
+    if (!latitudes || !longitudes || !weights) return nullptr;
+    const jsize count = env->GetArrayLength(latitudes);
+    if (count == 0 || count != env->GetArrayLength(longitudes) || count != env->GetArrayLength(weights)) {
+        return nullptr;
+    }
+
+    jdouble* latVals = env->GetDoubleArrayElements(latitudes, nullptr);
+    jdouble* lonVals = env->GetDoubleArrayElements(longitudes, nullptr);
+    jdouble* weightVals = env->GetDoubleArrayElements(weights, nullptr);
+
+    std::vector<gaodemap::HeatmapPoint> points;
+    points.reserve(count);
+    for (jsize i = 0; i < count; ++i) {
+        points.push_back({latVals[i], lonVals[i], weightVals[i]});
+    }
+
+    env->ReleaseDoubleArrayElements(latitudes, latVals, JNI_ABORT);
+    env->ReleaseDoubleArrayElements(longitudes, lonVals, JNI_ABORT);
+    env->ReleaseDoubleArrayElements(weights, weightVals, JNI_ABORT);
+
+    // 大数据量时按 CPU 核数并行分桶，点数较少时引擎内部自动退回单线程
+    auto cells = gaodemap::generateHeatmapGrid(points, gridSizeMeters, 0);
     
     jdoubleArray result = env->NewDoubleArray(static_cast<jsize>(cells.size() * 3));
     std::vector<double> buffer;
@@ -902,3 +1427,274 @@ Java_expo_modules_gaodemap_utils_GeometryUtils_nativeGenerateHeatmapGrid(
     return nullptr;
 #endif
 }
+
+// --- 热力图瓦片 ---
+
+extern "C" JNIEXPORT jlong JNICALL
+Java_expo_modules_gaodemap_utils_HeatmapTileNative_nativeCreate(
+    JNIEnv* env,
+    jclass,
+    jint maxCachedTiles
+) {
+    (void)env;
+    auto* provider = new gaodemap::HeatmapTileProvider(static_cast<size_t>(maxCachedTiles > 0 ? maxCachedTiles : 1));
+    return static_cast<jlong>(reinterpret_cast<intptr_t>(provider));
+}
+
+extern "C" JNIEXPORT void JNICALL
+Java_expo_modules_gaodemap_utils_HeatmapTileNative_nativeDestroy(
+    JNIEnv* env,
+    jclass,
+    jlong handle
+) {
+    (void)env;
+    delete reinterpret_cast<gaodemap::HeatmapTileProvider*>(static_cast<intptr_t>(handle));
+}
+
+extern "C" JNIEXPORT void JNICALL
+Java_expo_modules_gaodemap_utils_HeatmapTileNative_nativeSetPoints(
+    JNIEnv* env,
+    jclass,
+    jlong handle,
+    jdoubleArray latitudes,
+    jdoubleArray longitudes,
+    jdoubleArray weights
+) {
+#if GAODE_HAVE_JNI
+    auto* provider = reinterpret_cast<gaodemap::HeatmapTileProvider*>(static_cast<intptr_t>(handle));
+    if (!provider || !latitudes || !longitudes || !weights) return;
+
+    const jsize count = env->GetArrayLength(latitudes);
+    if (env->GetArrayLength(longitudes) != count || env->GetArrayLength(weights) != count) return;
+
+    jdouble* latVals = env->GetDoubleArrayElements(latitudes, nullptr);
+    jdouble* lonVals = env->GetDoubleArrayElements(longitudes, nullptr);
+    jdouble* weightVals = env->GetDoubleArrayElements(weights, nullptr);
+
+    std::vector<gaodemap::HeatmapPoint> points;
+    points.reserve(static_cast<size_t>(count));
+    for (jsize i = 0; i < count; ++i) {
+        points.push_back({latVals[i], lonVals[i], weightVals[i]});
+    }
+
+    env->ReleaseDoubleArrayElements(latitudes, latVals, JNI_ABORT);
+    env->ReleaseDoubleArrayElements(longitudes, lonVals, JNI_ABORT);
+    env->ReleaseDoubleArrayElements(weights, weightVals, JNI_ABORT);
+
+    provider->setPoints(points);
+#else
+    (void)env; (void)handle; (void)latitudes; (void)longitudes; (void)weights;
+#endif
+}
+
+extern "C" JNIEXPORT void JNICALL
+Java_expo_modules_gaodemap_utils_HeatmapTileNative_nativeSetStyle(
+    JNIEnv* env,
+    jclass,
+    jlong handle,
+    jint tileSize,
+    jdouble radiusPx,
+    jint kernel,
+    jintArray colors,
+    jfloatArray startPoints,
+    jfloat maxIntensity
+) {
+#if GAODE_HAVE_JNI
+    auto* provider = reinterpret_cast<gaodemap::HeatmapTileProvider*>(static_cast<intptr_t>(handle));
+    if (!provider) return;
+
+    gaodemap::HeatmapRasterOptions options;
+    options.tileSize = static_cast<int>(tileSize);
+    options.radiusPx = static_cast<double>(radiusPx);
+    options.kernel = kernel == 1 ? gaodemap::HeatmapKernel::Epanechnikov : gaodemap::HeatmapKernel::Gaussian;
+
+    // colors 为 null（JS 清除了 gradient）时传空 LUT，setStyle 会恢复默认色带
+    std::vector<uint32_t> lut;
+    if (colors && startPoints) {
+        const jsize count = env->GetArrayLength(colors);
+        if (count > 0 && env->GetArrayLength(startPoints) == count) {
+            std::vector<uint32_t> argb(static_cast<size_t>(count));
+            std::vector<jfloat> stops(static_cast<size_t>(count));
+            env->GetIntArrayRegion(colors, 0, count, reinterpret_cast<jint*>(argb.data()));
+            env->GetFloatArrayRegion(startPoints, 0, count, stops.data());
+            lut = gaodemap::buildHeatmapGradientLutArgb(argb, std::vector<double>(stops.begin(), stops.end()));
+        }
+    }
+
+    provider->setStyle(options, lut, static_cast<float>(maxIntensity));
+#else
+    (void)env; (void)handle; (void)tileSize; (void)radiusPx; (void)kernel;
+    (void)colors; (void)startPoints; (void)maxIntensity;
+#endif
+}
+
+extern "C" JNIEXPORT jintArray JNICALL
+Java_expo_modules_gaodemap_utils_HeatmapTileNative_nativeGetTile(
+    JNIEnv* env,
+    jclass,
+    jlong handle,
+    jint x,
+    jint y,
+    jint zoom
+) {
+#if GAODE_HAVE_JNI
+    auto* provider = reinterpret_cast<gaodemap::HeatmapTileProvider*>(static_cast<intptr_t>(handle));
+    if (!provider) return nullptr;
+
+    const auto pixels = provider->getTile(static_cast<int>(x), static_cast<int>(y), static_cast<int>(zoom));
+    if (!pixels || pixels->empty()) return nullptr;
+
+    jintArray result = env->NewIntArray(static_cast<jsize>(pixels->size()));
+    if (result == nullptr) return nullptr;
+    env->SetIntArrayRegion(result, 0, static_cast<jsize>(pixels->size()), reinterpret_cast<const jint*>(pixels->data()));
+    return result;
+#else
+    (void)env; (void)handle; (void)x; (void)y; (void)zoom;
+    return nullptr;
+#endif
+}
+
+extern "C" JNIEXPORT jlong JNICALL
+Java_expo_modules_gaodemap_utils_GpsSmootherNative_nativeCreate(
+    JNIEnv* env,
+    jclass,
+    jint capacity,
+    jdouble accelerationNoise,
+    jdouble minGateMeters,
+    jdouble gateScale,
+    jint maxRejected,
+    jdouble resetAfterSeconds
+) {
+    (void)env;
+    gaodemap::GpsSmootherOptions options;
+    options.accelerationNoise = accelerationNoise;
+    options.minGateMeters = minGateMeters;
+    options.gateScale = gateScale;
+    options.maxRejected = static_cast<int>(maxRejected);
+    options.resetAfterSeconds = resetAfterSeconds;
+    auto* pool = new gaodemap::GpsSmootherPool(static_cast<size_t>(capacity > 0 ? capacity : 1), options);
+    return static_cast<jlong>(reinterpret_cast<intptr_t>(pool));
+}
+
+extern "C" JNIEXPORT void JNICALL
+Java_expo_modules_gaodemap_utils_GpsSmootherNative_nativeDestroy(
+    JNIEnv* env,
+    jclass,
+    jlong handle
+) {
+    (void)env;
+    delete reinterpret_cast<gaodemap::GpsSmootherPool*>(static_cast<intptr_t>(handle));
+}
+
+extern "C" JNIEXPORT jint JNICALL
+Java_expo_modules_gaodemap_utils_GpsSmootherNative_nativeAcquire(
+    JNIEnv* env,
+    jclass,
+    jlong handle
+) {
+    (void)env;
+    auto* pool = reinterpret_cast<gaodemap::GpsSmootherPool*>(static_cast<intptr_t>(handle));
+    return pool ? static_cast<jint>(pool->acquire()) : -1;
+}
+
+extern "C" JNIEXPORT void JNICALL
+Java_expo_modules_gaodemap_utils_GpsSmootherNative_nativeRelease(
+    JNIEnv* env,
+    jclass,
+    jlong handle,
+    jint slot
+) {
+    (void)env;
+    auto* pool = reinterpret_cast<gaodemap::GpsSmootherPool*>(static_cast<intptr_t>(handle));
+    if (pool) pool->release(static_cast<int>(slot));
+}
+
+extern "C" JNIEXPORT jdoubleArray JNICALL
+Java_expo_modules_gaodemap_utils_GpsSmootherNative_nativeUpdate(
+    JNIEnv* env,
+    jclass,
+    jlong handle,
+    jintArray slots,
+    jdoubleArray timestamps,
+    jdoubleArray latitudes,
+    jdoubleArray longitudes,
+    jdoubleArray accuracies
+) {
+#if GAODE_HAVE_JNI
+    auto* pool = reinterpret_cast<gaodemap::GpsSmootherPool*>(static_cast<intptr_t>(handle));
+    if (!pool || !slots || !timestamps || !latitudes || !longitudes) return nullptr;
+
+    const jsize count = env->GetArrayLength(latitudes);
+    if (count != env->GetArrayLength(longitudes) || count != env->GetArrayLength(timestamps) ||
+        count != env->GetArrayLength(slots) || (accuracies && count != env->GetArrayLength(accuracies))) {
+        return nullptr;
+    }
+
+    std::vector<jint> slotValues(static_cast<size_t>(count));
+    env->GetIntArrayRegion(slots, 0, count, slotValues.data());
+    std::vector<gaodemap::SmoothedFix> fixes(static_cast<size_t>(count));
+
+    jdouble* timeValues = env->GetDoubleArrayElements(timestamps, nullptr);
+    jdouble* latValues = env->GetDoubleArrayElements(latitudes, nullptr);
+    jdouble* lonValues = env->GetDoubleArrayElements(longitudes, nullptr);
+    jdouble* accuracyValues = accuracies ? env->GetDoubleArrayElements(accuracies, nullptr) : nullptr;
+
+    static_assert(sizeof(jint) == sizeof(int32_t), "jint must be 32-bit");
+    pool->update(
+        reinterpret_cast<const int32_t*>(slotValues.data()),
+        timeValues,
+        gaodemap::CoordSpan(latValues, lonValues, static_cast<size_t>(count)),
+        accuracyValues,
+        fixes.data()
+    );
+
+    env->ReleaseDoubleArrayElements(timestamps, timeValues, JNI_ABORT);
+    env->ReleaseDoubleArrayElements(latitudes, latValues, JNI_ABORT);
+    env->ReleaseDoubleArrayElements(longitudes, lonValues, JNI_ABORT);
+    if (accuracyValues) env->ReleaseDoubleArrayElements(accuracies, accuracyValues, JNI_ABORT);
+
+    // 每个定位点 5 项: lat, lon, speed, heading, flags
+    std::vector<jdouble> buffer;
+    buffer.reserve(fixes.size() * 5);
+    for (const auto& fix : fixes) {
+        buffer.push_back(fix.lat);
+        buffer.push_back(fix.lon);
+        buffer.push_back(fix.speedMps);
+        buffer.push_back(fix.headingDegrees);
+        buffer.push_back(static_cast<jdouble>(fix.flags));
+    }
+
+    jdoubleArray result = env->NewDoubleArray(static_cast<jsize>(buffer.size()));
+    if (result == nullptr) return nullptr;
+    env->SetDoubleArrayRegion(result, 0, static_cast<jsize>(buffer.size()), buffer.data());
+    return result;
+#else
+    (void)env; (void)handle; (void)slots; (void)timestamps; (void)latitudes; (void)longitudes; (void)accuracies;
+    return nullptr;
+#endif
+}
+
+extern "C" JNIEXPORT jdoubleArray JNICALL
+Java_expo_modules_gaodemap_utils_GpsSmootherNative_nativePredict(
+    JNIEnv* env,
+    jclass,
+    jlong handle,
+    jint slot,
+    jdouble time
+) {
+#if GAODE_HAVE_JNI
+    auto* pool = reinterpret_cast<gaodemap::GpsSmootherPool*>(static_cast<intptr_t>(handle));
+    double lat = 0.0;
+    double lon = 0.0;
+    if (!pool || !pool->predict(static_cast<int>(slot), time, lat, lon)) return nullptr;
+
+    const jdouble values[2] = {lat, lon};
+    jdoubleArray result = env->NewDoubleArray(2);
+    if (result == nullptr) return nullptr;
+    env->SetDoubleArrayRegion(result, 0, 2, values);
+    return result;
+#else
+    (void)env; (void)handle; (void)slot; (void)time;
+    return nullptr;
+#endif
+}
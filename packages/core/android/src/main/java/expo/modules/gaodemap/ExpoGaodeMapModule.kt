@@ -184,13 +184,14 @@ class ExpoGaodeMapModule : Module() {
      * 计算两个坐标点之间的距离
      * @param coordinate1 第一个坐标点
      * @param coordinate2 第二个坐标点
+     * @param earthModel 地球模型 'sphere' | 'wgs84'，默认球面
      * @returns 两点之间的距离（单位：米）
      */
-    Function("distanceBetweenCoordinates") { p1: Map<String, Any>?, p2: Map<String, Any>? ->
+    Function("distanceBetweenCoordinates") { p1: Map<String, Any>?, p2: Map<String, Any>?, earthModel: String? ->
       val cord1 = LatLngParser.parseLatLng(p1)
       val cord2 = LatLngParser.parseLatLng(p2)
       jsValue(if (cord1 != null && cord2 != null) {
-        GeometryUtils.calculateDistance(cord1, cord2)
+        GeometryUtils.calculateDistance(cord1, cord2, GeometryUtils.parseEarthModel(earthModel))
       } else {
         0.0
       })
@@ -230,19 +231,21 @@ class ExpoGaodeMapModule : Module() {
     /**
      * 计算多边形面积
      * @param points 多边形顶点坐标数组，支持嵌套数组（多边形空洞）
+     * @param earthModel 地球模型 'sphere' | 'wgs84'，默认球面
      * @return 面积（平方米）
      */
-    Function("calculatePolygonArea") { points: List<Any>? ->
+    Function("calculatePolygonArea") { points: List<Any>?, earthModel: String? ->
       val rings = LatLngParser.parseLatLngListList(points)
       if (rings.isEmpty()) return@Function jsValue(0.0)
+      val model = GeometryUtils.parseEarthModel(earthModel)
       
       // 第一项是外轮廓
-      var totalArea = GeometryUtils.calculatePolygonArea(rings[0])
+      var totalArea = GeometryUtils.calculatePolygonArea(rings[0], model)
       
       // 后续项是内孔，需要减去面积
       if (rings.size > 1) {
         for (i in 1 until rings.size) {
-          totalArea -= GeometryUtils.calculatePolygonArea(rings[i])
+          totalArea -= GeometryUtils.calculatePolygonArea(rings[i], model)
         }
       }
       
@@ -447,11 +450,12 @@ class ExpoGaodeMapModule : Module() {
     /**
      * 计算路径总长度
      * @param points 路径点
+     * @param earthModel 地球模型 'sphere' | 'wgs84'，默认球面
      * @return 长度(米)
      */
-    Function("calculatePathLength") { points: List<Any>? ->
+    Function("calculatePathLength") { points: List<Any>?, earthModel: String? ->
       val poly = LatLngParser.parseLatLngList(points)
-      jsValue(GeometryUtils.calculatePathLength(poly))
+      jsValue(GeometryUtils.calculatePathLength(poly, GeometryUtils.parseEarthModel(earthModel)))
     }
 
     /**
@@ -469,6 +473,110 @@ class ExpoGaodeMapModule : Module() {
       })
     }
 
+    /**
+     * 解析高德多环 / 多段 Polyline 字符串
+     * @param polylineStr 高德原始 polyline 字符串，`|` 分隔环，`;` 分隔坐标点
+     * @param dedupeAdjacent 是否去除环内相邻重复点
+     * @return 扁平坐标数组与环偏移
+     */
+    Function("parsePolylineRings") { polylineStr: String?, dedupeAdjacent: Boolean? ->
+      val result = GeometryUtils.parsePolylineRings(polylineStr, dedupeAdjacent ?: true)
+      jsValue(mapOf(
+        "coordinates" to result.coordinates,
+        "ringOffsets" to result.ringOffsets
+      ))
+    }
+
+    /**
+     * 将路径编码为紧凑字符串（Encoded Polyline 格式）
+     * @param points 路径点
+     * @param precision 小数精度位数 (1-9)，默认 5
+     * @return 编码字符串
+     */
+    Function("encodePolyline") { points: List<Any>?, precision: Int? ->
+      val poly = LatLngParser.parseLatLngList(points)
+      jsValue(GeometryUtils.encodePolyline(poly, precision ?: 5))
+    }
+
+    /**
+     * 解码 encodePolyline 生成的字符串
+     * @param encoded 编码字符串
+     * @param precision 编码时使用的精度位数，默认 5
+     * @return 坐标点列表
+     */
+    Function("decodePolyline") { encoded: String?, precision: Int? ->
+      val result = GeometryUtils.decodePolyline(encoded, precision ?: 5)
+      jsValue(result.map {
+        mapOf(
+          "latitude" to it.latitude,
+          "longitude" to it.longitude
+        )
+      })
+    }
+
+    /**
+     * 按间距重采样路径
+     * @param points 路径点
+     * @param spacingMeters 目标间距(米)
+     * @param cornerAngleDegrees > 0 时保留航向变化超过该角度的转角
+     * @return 重采样后的路径点
+     */
+    Function("resamplePolyline") { points: List<Any>?, spacingMeters: Double, cornerAngleDegrees: Double? ->
+      val poly = LatLngParser.parseLatLngList(points)
+      val angle = cornerAngleDegrees ?: 0.0
+      val result = if (angle > 0) {
+        GeometryUtils.resamplePolylinePreservingCorners(poly, spacingMeters, angle)
+      } else {
+        GeometryUtils.resamplePolyline(poly, spacingMeters)
+      }
+      jsValue(result.map {
+        mapOf(
+          "latitude" to it.latitude,
+          "longitude" to it.longitude
+        )
+      })
+    }
+
+    /**
+     * 沿路径等距取点
+     * @param points 路径点
+     * @param count 点数（含首尾）
+     * @return 重采样后的路径点
+     */
+    Function("resamplePolylineByCount") { points: List<Any>?, count: Int ->
+      val poly = LatLngParser.parseLatLngList(points)
+      jsValue(GeometryUtils.resamplePolylineByCount(poly, count).map {
+        mapOf(
+          "latitude" to it.latitude,
+          "longitude" to it.longitude
+        )
+      })
+    }
+
+    /**
+     * 比较候选路线与参考路线（如 Web 规划线）的相似程度
+     * @param reference 参考路线
+     * @param points 候选路线
+     * @param thresholdMeters 统计超限顶点数的距离阈值(米)
+     * @return 平均/最大偏差、超限顶点数、Hausdorff 与离散 Fréchet 距离
+     */
+    Function("comparePaths") { reference: List<Any>?, points: List<Any>?, thresholdMeters: Double ->
+      val result = GeometryUtils.comparePaths(
+        LatLngParser.parseLatLngList(reference),
+        LatLngParser.parseLatLngList(points),
+        thresholdMeters
+      )
+      jsValue(result?.let {
+        mapOf(
+          "averageDeviationMeters" to it.averageDeviationMeters,
+          "maxDeviationMeters" to it.maxDeviationMeters,
+          "exceededCount" to it.exceededCount,
+          "hausdorffMeters" to it.hausdorffMeters,
+          "frechetMeters" to it.frechetMeters
+        )
+      })
+    }
+
     /**
      * 获取路径上指定距离的点
      * @param points 路径点
@@ -2,7 +2,6 @@ package expo.modules.gaodemap.overlays
 
 import android.annotation.SuppressLint
 import android.content.Context
-import android.graphics.Color
 import android.os.Looper
 import android.util.Log
 import com.amap.api.maps.AMap
@@ -12,12 +11,15 @@ import com.amap.api.maps.model.HeatmapTileProvider
 import com.amap.api.maps.model.LatLng
 import com.amap.api.maps.model.TileOverlay
 import com.amap.api.maps.model.TileOverlayOptions
+import com.amap.api.maps.model.TileProvider
 import com.amap.api.maps.model.WeightedLatLng
 import expo.modules.kotlin.AppContext
 import expo.modules.kotlin.views.ExpoView
+import expo.modules.gaodemap.utils.ColorParser
 import expo.modules.gaodemap.utils.LatLngParser
 import java.util.concurrent.ExecutorService
 import java.util.concurrent.Executors
+import kotlin.concurrent.thread
 
 @SuppressLint("ViewConstructor")
 class HeatMapView(context: Context, appContext: AppContext) : ExpoView(context, appContext) {
@@ -37,6 +39,14 @@ class HeatMapView(context: Context, appContext: AppContext) : ExpoView(context,
   private var radius: Int = 50
   private var opacity: Double = 0.6
   private var gradient: Gradient? = null
+  private var gradientStops: GradientStops? = null
+
+  // 原生瓦片源：跨数据更新复用，仅重新生成输入点发生变化的瓦片；原生库不可用时退回 SDK 的 HeatmapTileProvider
+  @Volatile private var nativeProvider: NativeHeatmapTileProvider? = null
+  private var nativeUnavailable: Boolean = false
+  private var overlayProvider: TileProvider? = null
+
+  private class GradientStops(val colors: IntArray, val startPoints: FloatArray)
   
   /**
    * 设置地图实例
@@ -83,7 +93,8 @@ class HeatMapView(context: Context, appContext: AppContext) : ExpoView(context,
   }
 
   fun setGradient(gradientValue: Map<String, Any>?) {
-    gradient = parseGradient(gradientValue)
+    gradientStops = parseGradient(gradientValue)
+    gradient = gradientStops?.let { Gradient(it.colors, it.startPoints) }
     Log.d(TAG, "setGradient: hasGradient=${gradient != null}, raw=${gradientValue != null}")
     needsRebuild = true
     scheduleUpdate()
@@ -134,6 +145,7 @@ class HeatMapView(context: Context, appContext: AppContext) : ExpoView(context,
       if (!visible) {
         overlay.remove()
         heatmapOverlay = null
+        overlayProvider = null
         needsRebuild = true
       }
     }
@@ -169,6 +181,7 @@ class HeatMapView(context: Context, appContext: AppContext) : ExpoView(context,
     val radiusValue = radius.coerceIn(10, 200)
     val opacityValue = opacity.coerceIn(0.0, 1.0)
     val gradientValue = gradient
+    val gradientStopsValue = gradientStops
     Log.d(TAG, "applyUpdate: token=$token, visible=$visible, points=${pointsSnapshot.size}, radius=$radiusValue, opacity=$opacityValue, gradient=${gradientValue != null}, ${formatPointStats(pointsSnapshot)}")
 
     if (!visible) {
@@ -180,6 +193,7 @@ class HeatMapView(context: Context, appContext: AppContext) : ExpoView(context,
       Log.w(TAG, "applyUpdate: no valid heatmap points, removing overlay")
       heatmapOverlay?.remove()
       heatmapOverlay = null
+      overlayProvider = null
       return
     }
 
@@ -191,13 +205,16 @@ class HeatMapView(context: Context, appContext: AppContext) : ExpoView(context,
 
     executor.execute {
       try {
-        val builder = HeatmapTileProvider.Builder()
-          .data(latLngSnapshot)
-          .radius(radiusValue)
+        val nativeTiles = buildNativeProvider(pointsSnapshot, radiusValue, gradientStopsValue)
+        val provider: TileProvider = nativeTiles ?: run {
+          val builder = HeatmapTileProvider.Builder()
+            .data(latLngSnapshot)
+            .radius(radiusValue)
 
-        gradientValue?.let { builder.gradient(it) }
+          gradientValue?.let { builder.gradient(it) }
 
-        val provider = builder.build()
+          builder.build()
+        }
 
         post {
           if (token != updateToken) {
@@ -213,6 +230,18 @@ class HeatMapView(context: Context, appContext: AppContext) : ExpoView(context,
             return@post
           }
 
+          val currentOverlay = heatmapOverlay
+          if (currentOverlay != null && nativeTiles != null && overlayProvider === nativeTiles) {
+            // 复用现有图层：清除 SDK 的瓦片缓存后重新请求，未变化的瓦片由原生缓存直接返回
+            needsRebuild = false
+            runCatching { currentOverlay.clearTileCache() }
+            applyOverlayVisibility()
+            applyOverlayOpacity()
+            forceRefresh()
+            Log.i(TAG, "native tiles refreshed: points=${pointsSnapshot.size}, radius=$radiusValue")
+            return@post
+          }
+
           heatmapOverlay?.remove()
 
           val options = TileOverlayOptions().tileProvider(provider)
@@ -228,6 +257,7 @@ class HeatMapView(context: Context, appContext: AppContext) : ExpoView(context,
           }
 
           heatmapOverlay = map.addTileOverlay(options)
+          overlayProvider = provider
           needsRebuild = false
           runCatching { heatmapOverlay?.clearTileCache() }
           applyOverlayVisibility()
@@ -241,6 +271,42 @@ class HeatMapView(context: Context, appContext: AppContext) : ExpoView(context,
     }
   }
   
+  /**
+   * 在后台线程更新原生瓦片源的数据与样式，原生库不可用时返回 null
+   */
+  private fun buildNativeProvider(
+    points: List<WeightedLatLng>,
+    radiusValue: Int,
+    stops: GradientStops?
+  ): NativeHeatmapTileProvider? {
+    if (nativeUnavailable) return null
+    return try {
+      val provider = nativeProvider ?: NativeHeatmapTileProvider().also { nativeProvider = it }
+      val latitudes = DoubleArray(points.size)
+      val longitudes = DoubleArray(points.size)
+      val weights = DoubleArray(points.size)
+      points.forEachIndexed { index, point ->
+        latitudes[index] = point.latLng.latitude
+        longitudes[index] = point.latLng.longitude
+        weights[index] = point.intensity
+      }
+      provider.setStyle(radiusValue, stops?.colors, stops?.startPoints)
+      provider.setPoints(latitudes, longitudes, weights)
+      provider
+    } catch (t: Throwable) {
+      Log.w(TAG, "native heatmap tiles unavailable, falling back to HeatmapTileProvider", t)
+      nativeUnavailable = true
+      null
+    }
+  }
+
+  private fun releaseNativeProvider() {
+    val provider = nativeProvider ?: return
+    nativeProvider = null
+    // release 会等待进行中的瓦片请求结束，放到独立线程避免阻塞主线程
+    thread(name = "HeatmapTileRelease") { provider.release() }
+  }
+
   private fun forceRefresh() {
     runCatching { aMap?.moveCamera(CameraUpdateFactory.zoomBy(0f)) }
   }
@@ -254,6 +320,8 @@ class HeatMapView(context: Context, appContext: AppContext) : ExpoView(context,
     Log.d(TAG, "removeHeatMap")
     heatmapOverlay?.remove()
     heatmapOverlay = null
+    overlayProvider = null
+    releaseNativeProvider()
     dataList.clear()
     needsRebuild = true
   }
@@ -285,7 +353,7 @@ class HeatMapView(context: Context, appContext: AppContext) : ExpoView(context,
     return WeightedLatLng(latLng, weight)
   }
 
-  private fun parseGradient(gradientValue: Map<String, Any>?): Gradient? {
+  private fun parseGradient(gradientValue: Map<String, Any>?): GradientStops? {
     if (gradientValue == null) return null
     val rawColors = gradientValue["colors"] as? List<*> ?: return null
     val rawStartPoints = gradientValue["startPoints"] as? List<*> ?: return null
@@ -308,13 +376,14 @@ class HeatMapView(context: Context, appContext: AppContext) : ExpoView(context,
       colors[index] = color
       startPoints[index] = startPoint.coerceIn(0f, 1f)
     }
-    return Gradient(colors, startPoints)
+    return GradientStops(colors, startPoints)
   }
 
   private fun parseColor(value: Any?): Int? {
     return when (value) {
       is Number -> value.toInt()
-      is String -> runCatching { Color.parseColor(value) }.getOrNull()
+      // 与其它覆盖物一致，#RRGGBBAA 的透明度在最后
+      is String -> ColorParser.tryParseColor(value)
       else -> null
     }
   }
@@ -0,0 +1,69 @@
+package expo.modules.gaodemap.overlays
+
+import android.graphics.Bitmap
+import com.amap.api.maps.model.Tile
+import com.amap.api.maps.model.TileProvider
+import expo.modules.gaodemap.utils.HeatmapTileNative
+import java.io.ByteArrayOutputStream
+import java.util.concurrent.locks.ReentrantReadWriteLock
+import kotlin.concurrent.read
+import kotlin.concurrent.write
+
+/**
+ * 基于 C++ 核密度栅格化的热力图瓦片源
+ *
+ * 瓦片按 (x, y, zoom) 在原生侧生成并进行 LRU 缓存；更新数据后只有输入点发生变化的瓦片会重新计算，
+ * 平移 / 缩放回到已访问区域时直接复用缓存，无需为每个点创建 SDK 对象
+ */
+class NativeHeatmapTileProvider(maxCachedTiles: Int = 256) : TileProvider {
+  companion object {
+    const val TILE_SIZE = 256
+  }
+
+  private val lock = ReentrantReadWriteLock()
+  private var handle: Long = HeatmapTileNative.nativeCreate(maxCachedTiles)
+
+  fun setPoints(latitudes: DoubleArray, longitudes: DoubleArray, weights: DoubleArray) {
+    lock.read {
+      if (handle != 0L) {
+        HeatmapTileNative.nativeSetPoints(handle, latitudes, longitudes, weights)
+      }
+    }
+  }
+
+  fun setStyle(radiusPx: Int, colors: IntArray?, startPoints: FloatArray?) {
+    lock.read {
+      if (handle != 0L) {
+        HeatmapTileNative.nativeSetStyle(handle, TILE_SIZE, radiusPx.toDouble(), 0, colors, startPoints, 0f)
+      }
+    }
+  }
+
+  override fun getTile(x: Int, y: Int, zoom: Int): Tile {
+    val pixels = lock.read {
+      if (handle == 0L) null else HeatmapTileNative.nativeGetTile(handle, x, y, zoom)
+    } ?: return TileProvider.NO_TILE
+
+    val bitmap = Bitmap.createBitmap(pixels, TILE_SIZE, TILE_SIZE, Bitmap.Config.ARGB_8888)
+    val stream = ByteArrayOutputStream()
+    bitmap.compress(Bitmap.CompressFormat.PNG, 100, stream)
+    bitmap.recycle()
+    return Tile(TILE_SIZE, TILE_SIZE, stream.toByteArray())
+  }
+
+  override fun getTileWidth(): Int = TILE_SIZE
+
+  override fun getTileHeight(): Int = TILE_SIZE
+
+  /**
+   * 释放原生对象，等待进行中的 getTile 完成
+   */
+  fun release() {
+    lock.write {
+      if (handle != 0L) {
+        HeatmapTileNative.nativeDestroy(handle)
+        handle = 0L
+      }
+    }
+  }
+}
@@ -4,10 +4,12 @@ import android.annotation.SuppressLint
 import android.content.Context
 import android.graphics.Color
 import com.amap.api.maps.AMap
+import com.amap.api.maps.model.CameraPosition
 import com.amap.api.maps.model.LatLng
 import com.amap.api.maps.model.Polygon
 import com.amap.api.maps.model.PolygonHoleOptions
 import com.amap.api.maps.model.PolygonOptions
+import expo.modules.gaodemap.ExpoGaodeMapView
 import expo.modules.gaodemap.utils.ColorParser
 import expo.modules.gaodemap.utils.GeometryUtils
 import expo.modules.gaodemap.utils.LatLngParser
@@ -16,15 +18,18 @@ import expo.modules.kotlin.viewevent.EventDispatcher
 import expo.modules.kotlin.views.ExpoView
 
 @SuppressLint("ViewConstructor")
-class PolygonView(context: Context, appContext: AppContext) : ExpoView(context, appContext) {
+class PolygonView(context: Context, appContext: AppContext) : ExpoView(context, appContext), AMap.OnCameraChangeListener {
   
   private val onPolygonPress by EventDispatcher()
   private val onPolygonSimplified by EventDispatcher()
   
   private var polygon: Polygon? = null
   private var aMap: AMap? = null
+  private var mapContainer: ExpoGaodeMapView? = null
   private var points: List<LatLng> = emptyList()
   private var holes: List<List<LatLng>> = emptyList()
+  // 简化后、裁剪前的外轮廓
+  private var displayPoints: List<LatLng> = emptyList()
   private var strokeWidth: Float = 10f
   private var simplificationTolerance: Double = 0.0
 
@@ -40,6 +45,9 @@ class PolygonView(context: Context, appContext: AppContext) : ExpoView(context,
   @Suppress("unused")
   fun setMap(map: AMap) {
     aMap = map
+    // addView 时调用，此时 parent 已是地图视图
+    mapContainer = parent as? ExpoGaodeMapView
+    mapContainer?.addCameraChangeListener(this)
     post { createOrUpdatePolygon() }
 
   }
@@ -57,12 +65,22 @@ class PolygonView(context: Context, appContext: AppContext) : ExpoView(context,
       holes = emptyList()
     }
     
-    polygon?.let {
-      it.points = points
-      it.holeOptions = holes.map { holePoints ->
-        PolygonHoleOptions().addAll(holePoints)
-      }
-    } ?: createOrUpdatePolygon()
+    if (polygon == null) {
+      createOrUpdatePolygon()
+    } else {
+      displayPoints = simplifiedPoints()
+      updateShape()
+    }
+  }
+
+  override fun onCameraChange(cameraPosition: CameraPosition?) {
+    // 移动过程中不裁剪，相机停止后再更新
+  }
+
+  override fun onCameraChangeFinish(cameraPosition: CameraPosition?) {
+    if (cameraPosition != null && clipEnabled()) {
+      updateShape(cameraPosition)
+    }
   }
   
   /**
@@ -121,43 +139,81 @@ class PolygonView(context: Context, appContext: AppContext) : ExpoView(context,
    * 创建或更新多边形
    */
   private fun createOrUpdatePolygon() {
-    aMap?.let { map ->
-      // 移除旧的多边形
-      polygon?.remove()
-      polygon = null
-      
-      if (points.isNotEmpty()) {
-        val displayPoints = if (simplificationTolerance > 0) {
-          GeometryUtils.simplifyPolyline(points, simplificationTolerance)
-        } else {
-          points
-        }
+    if (aMap == null) return
+    // 移除旧的多边形
+    polygon?.remove()
+    polygon = null
+
+    if (points.isNotEmpty()) {
+      displayPoints = simplifiedPoints()
+
+      // 至少3个点
+      if (displayPoints.size < 3) return
+
+      updateShape()
 
-        // 至少3个点
-        if (displayPoints.size < 3) return
-
-        val options = PolygonOptions()
-          .addAll(displayPoints)
-          .fillColor(fillColor)
-          .strokeColor(strokeColor)
-          .strokeWidth(strokeWidth)
-          .zIndex(_zIndex)
-        
-        if (holes.isNotEmpty()) {
-          holes.forEach { holePoints ->
-            options.addHoles(PolygonHoleOptions().addAll(holePoints))
-          }
+      // 派发简化事件
+      onPolygonSimplified(mapOf(
+        "originalCount" to points.size,
+        "simplifiedCount" to displayPoints.size
+      ))
+    }
+  }
+
+  private fun simplifiedPoints(): List<LatLng> {
+    return if (simplificationTolerance > 0) {
+      GeometryUtils.simplifyPolyline(points, simplificationTolerance)
+    } else {
+      points
+    }
+  }
+
+  private fun clipEnabled(): Boolean {
+    return displayPoints.size + holes.sumOf { it.size } >= GeometryUtils.VIEWPORT_CLIP_MIN_POINTS
+  }
+
+  /**
+   * 按当前相机裁剪外轮廓与内孔后交给 SDK，完全移出视口时移除多边形
+   */
+  private fun updateShape(camera: CameraPosition? = aMap?.cameraPosition) {
+    val map = aMap ?: return
+    var outer = displayPoints
+    var visibleHoles = holes
+    val container = mapContainer
+    if (camera != null && container != null && clipEnabled()) {
+      val density = context.resources.displayMetrics.density.toDouble()
+      val widthDp = container.width / density
+      val heightDp = container.height / density
+      GeometryUtils.clipToCamera(displayPoints, true, camera, widthDp, heightDp)?.let { rings ->
+        outer = rings.firstOrNull() ?: emptyList()
+        // 内孔被外轮廓包含，裁剪到同一视口后仍在裁剪后的外轮廓内
+        visibleHoles = holes.mapNotNull { hole ->
+          val clipped = GeometryUtils.clipToCamera(hole, true, camera, widthDp, heightDp)
+          if (clipped == null) hole else clipped.firstOrNull()?.takeIf { it.size >= 3 }
         }
-        
-        polygon = map.addPolygon(options)
-        
-        // 派发简化事件
-        onPolygonSimplified(mapOf(
-          "originalCount" to points.size,
-          "simplifiedCount" to displayPoints.size
-        ))
       }
     }
+
+    if (outer.size < 3) {
+      polygon?.remove()
+      polygon = null
+      return
+    }
+
+    val holeOptions = visibleHoles.map { PolygonHoleOptions().addAll(it) }
+    polygon?.let {
+      it.points = outer
+      it.holeOptions = holeOptions
+    } ?: run {
+      val options = PolygonOptions()
+        .addAll(outer)
+        .fillColor(fillColor)
+        .strokeColor(strokeColor)
+        .strokeWidth(strokeWidth)
+        .zIndex(_zIndex)
+      holeOptions.forEach { options.addHoles(it) }
+      polygon = map.addPolygon(options)
+    }
   }
   
   /**
@@ -190,6 +246,8 @@ class PolygonView(context: Context, appContext: AppContext) : ExpoView(context,
     post {
       if (parent == null) {
         removePolygon()
+        mapContainer?.removeCameraChangeListener(this)
+        mapContainer = null
         aMap = null
       }
     }
@@ -4,11 +4,14 @@ import android.annotation.SuppressLint
 import android.content.Context
 import android.graphics.Color
 import com.amap.api.maps.AMap
+import com.amap.api.maps.model.BitmapDescriptor
 import com.amap.api.maps.model.BitmapDescriptorFactory
+import com.amap.api.maps.model.CameraPosition
 import com.amap.api.maps.model.LatLng
 import com.amap.api.maps.model.Polyline
 import com.amap.api.maps.model.PolylineOptions
   
+import expo.modules.gaodemap.ExpoGaodeMapView
 import expo.modules.gaodemap.utils.LatLngParser
 import expo.modules.gaodemap.utils.ColorParser
 import expo.modules.gaodemap.utils.GeometryUtils
@@ -18,15 +21,21 @@ import expo.modules.kotlin.views.ExpoView
 import java.net.URL
 
 @SuppressLint("ViewConstructor")
-class PolylineView(context: Context, appContext: AppContext) : ExpoView(context, appContext) {
+class PolylineView(context: Context, appContext: AppContext) : ExpoView(context, appContext), AMap.OnCameraChangeListener {
   
   private val onPolylinePress by EventDispatcher()
   
-  private var polyline: Polyline? = null
+  // 点数较多时按视口裁剪，折线可能断成多段，每段一个 SDK 折线
+  private val polylines = mutableListOf<Polyline>()
   private var aMap: AMap? = null
+  private var mapContainer: ExpoGaodeMapView? = null
   private var points: List<LatLng> = emptyList()
+  // 简化后、裁剪前的点
+  private var displayPoints: List<LatLng> = emptyList()
+  private var textureDescriptor: BitmapDescriptor? = null
   private var strokeWidth: Float = 10f
   private var strokeColor: Int = Color.BLUE
+  private var lineZIndex: Float = 0f
   private var isDotted: Boolean = false
   private var isGeodesic: Boolean = false
   private var textureUrl: String? = null
@@ -38,6 +47,9 @@ class PolylineView(context: Context, appContext: AppContext) : ExpoView(context,
   @Suppress("unused")
   fun setMap(map: AMap) {
     aMap = map
+    // addView 时调用，此时 parent 已是地图视图
+    mapContainer = parent as? ExpoGaodeMapView
+    mapContainer?.addCameraChangeListener(this)
     post {
       createOrUpdatePolyline()
     }
@@ -50,9 +62,22 @@ class PolylineView(context: Context, appContext: AppContext) : ExpoView(context,
    */
   fun setPoints(pointsList: List<Any>?) {
     points = LatLngParser.parseLatLngList(pointsList)
-    polyline?.let {
-      it.points = points
-    } ?: createOrUpdatePolyline()
+    if (polylines.isEmpty()) {
+      createOrUpdatePolyline()
+    } else {
+      displayPoints = simplifiedPoints()
+      updateSegments()
+    }
+  }
+
+  override fun onCameraChange(cameraPosition: CameraPosition?) {
+    // 移动过程中不裁剪，相机停止后再更新
+  }
+
+  override fun onCameraChangeFinish(cameraPosition: CameraPosition?) {
+    if (cameraPosition != null && displayPoints.size >= GeometryUtils.VIEWPORT_CLIP_MIN_POINTS) {
+      updateSegments(cameraPosition)
+    }
   }
   
   /**
@@ -62,9 +87,11 @@ class PolylineView(context: Context, appContext: AppContext) : ExpoView(context,
     // Android 需要乘以屏幕密度以匹配 iOS 的视觉效果
     val density = context.resources.displayMetrics.density
     strokeWidth = width * density
-    polyline?.let {
-      it.width = strokeWidth
-    } ?: createOrUpdatePolyline()
+    if (polylines.isEmpty()) {
+      createOrUpdatePolyline()
+    } else {
+      polylines.forEach { it.width = strokeWidth }
+    }
   }
   
   /**
@@ -72,9 +99,11 @@ class PolylineView(context: Context, appContext: AppContext) : ExpoView(context,
    */
   fun setStrokeColor(color: String?) {
     strokeColor = ColorParser.parseColor(color)
-    polyline?.let {
-      it.color = strokeColor
-    } ?: createOrUpdatePolyline()
+    if (polylines.isEmpty()) {
+      createOrUpdatePolyline()
+    } else {
+      polylines.forEach { it.color = strokeColor }
+    }
   }
   
   /**
@@ -101,9 +130,12 @@ class PolylineView(context: Context, appContext: AppContext) : ExpoView(context,
    * 设置 z-index
    */
   fun setZIndex(zIndex: Float) {
-    polyline?.let {
-      it.zIndex = zIndex
-    } ?: createOrUpdatePolyline()
+    lineZIndex = zIndex
+    if (polylines.isEmpty()) {
+      createOrUpdatePolyline()
+    } else {
+      polylines.forEach { it.zIndex = zIndex }
+    }
   }
 
     fun setGradient(gradient: Boolean){
@@ -115,11 +147,10 @@ class PolylineView(context: Context, appContext: AppContext) : ExpoView(context,
    */
   @Suppress("unused")
   fun setOpacity(opacity: Float) {
-    polyline?.let { line ->
-      val currentColor = line.color
-      val alpha = (opacity * 255).toInt()
-      line.color = Color.argb(alpha, Color.red(currentColor), Color.green(currentColor), Color.blue(currentColor))
-    }
+    // 写回 strokeColor，之后裁剪新增的分段保持相同透明度
+    val alpha = (opacity * 255).toInt()
+    strokeColor = Color.argb(alpha, Color.red(strokeColor), Color.green(strokeColor), Color.blue(strokeColor))
+    polylines.forEach { it.color = strokeColor }
   }
   
   /**
@@ -140,84 +171,132 @@ class PolylineView(context: Context, appContext: AppContext) : ExpoView(context,
   /**
    * 创建或更新折线
    */
-  @SuppressLint("DiscouragedApi")
   private fun createOrUpdatePolyline() {
-    aMap?.let { map ->
-      try {
-        // 移除旧折线
-        polyline?.remove()
-        polyline = null
-        
-        if (points.isNotEmpty()) {
-          val displayPoints = if (simplificationTolerance > 0) {
-            GeometryUtils.simplifyPolyline(points, simplificationTolerance)
-          } else {
-            points
-          }
+    if (aMap == null) return
+    try {
+      // 移除旧折线
+      removePolyline()
+      displayPoints = simplifiedPoints()
+      textureDescriptor = null
+      loadTexture()
+      updateSegments()
+    } catch (e: Throwable) {
+      android.util.Log.e("PolylineView", "Error creating/updating polyline", e)
+    }
+  }
 
-          val options = PolylineOptions()
-            .addAll(displayPoints)
-            .width(strokeWidth)
-            .color(strokeColor)
-            .geodesic(isGeodesic)
+  private fun simplifiedPoints(): List<LatLng> {
+    return if (simplificationTolerance > 0) {
+      GeometryUtils.simplifyPolyline(points, simplificationTolerance)
+    } else {
+      points
+    }
+  }
 
-          
-          // 设置虚线样式
-          try {
-              options.isDottedLine = isDotted
-              if (isDotted) {
-                  options.dottedLineType = PolylineOptions.DOTTEDLINE_TYPE_SQUARE
-              }
-          } catch (e: Throwable) {
-              // 忽略虚线设置错误，防止崩溃
-              android.util.Log.e("PolylineView", "设置虚线失败", e)
-          }
-          
-          // 设置纹理
-          textureUrl?.let { url ->
+  /**
+   * 把折线按当前相机裁剪后交给 SDK，复用已有的折线对象，只增删段数的差额
+   */
+  private fun updateSegments(camera: CameraPosition? = aMap?.cameraPosition) {
+    val map = aMap ?: return
+    val segments = visibleSegments(camera)
+    while (polylines.size > segments.size) {
+      polylines.removeAt(polylines.size - 1).remove()
+    }
+    segments.forEachIndexed { index, segment ->
+      if (index < polylines.size) {
+        polylines[index].points = segment
+      } else {
+        polylines.add(map.addPolyline(buildOptions(segment)))
+      }
+    }
+  }
+
+  /**
+   * 点数较少或为大地线时整条显示；否则只保留视口（外扩半个视图）内的部分
+   */
+  private fun visibleSegments(camera: CameraPosition?): List<List<LatLng>> {
+    if (displayPoints.size < 2) return emptyList()
+    val container = mapContainer
+    if (camera == null || container == null || isGeodesic || displayPoints.size < GeometryUtils.VIEWPORT_CLIP_MIN_POINTS) {
+      return listOf(displayPoints)
+    }
+    val density = context.resources.displayMetrics.density
+    val clipped = GeometryUtils.clipToCamera(
+      displayPoints,
+      false,
+      camera,
+      container.width / density.toDouble(),
+      container.height / density.toDouble()
+    ) ?: return listOf(displayPoints)
+    return clipped.filter { it.size >= 2 }
+  }
+
+  private fun buildOptions(segment: List<LatLng>): PolylineOptions {
+    val options = PolylineOptions()
+      .addAll(segment)
+      .width(strokeWidth)
+      .color(strokeColor)
+      .zIndex(lineZIndex)
+      .geodesic(isGeodesic)
+
+    // 设置虚线样式
+    try {
+        options.isDottedLine = isDotted
+        if (isDotted) {
+            options.dottedLineType = PolylineOptions.DOTTEDLINE_TYPE_SQUARE
+        }
+    } catch (e: Throwable) {
+        // 忽略虚线设置错误，防止崩溃
+        android.util.Log.e("PolylineView", "设置虚线失败", e)
+    }
+
+    textureDescriptor?.let { options.setCustomTexture(it) }
+    return options
+  }
+
+  /**
+   * 加载纹理，本地图片同步加载，网络图片加载完成后应用到全部分段
+   */
+  @SuppressLint("DiscouragedApi")
+  private fun loadTexture() {
+    val url = textureUrl ?: return
+    try {
+      when {
+        url.startsWith("http://") || url.startsWith("https://") -> {
+          // 网络图片异步加载
+          Thread {
             try {
-              when {
-                url.startsWith("http://") || url.startsWith("https://") -> {
-                  // 网络图片异步加载
-                  Thread {
-                    try {
-                      val connection = URL(url).openConnection()
-                      val inputStream = connection.getInputStream()
-                      val bitmap = android.graphics.BitmapFactory.decodeStream(inputStream)
-                      inputStream.close()
-                      post {
-                        polyline?.setCustomTexture(BitmapDescriptorFactory.fromBitmap(bitmap))
-                      }
-                    } catch (e: Exception) {
-                      e.printStackTrace()
-                    }
-                  }.start()
-                }
-                url.startsWith("file://") -> {
-                  val path = url.substring(7)
-                  val bitmap = android.graphics.BitmapFactory.decodeFile(path)
-                  bitmap?.let { options.setCustomTexture(BitmapDescriptorFactory.fromBitmap(it)) }
-                }
-                else -> {
-                  val resId = context.resources.getIdentifier(url, "drawable", context.packageName)
-                  if (resId != 0) {
-                    val bitmap = android.graphics.BitmapFactory.decodeResource(context.resources, resId)
-                    options.setCustomTexture(BitmapDescriptorFactory.fromBitmap(bitmap))
-                  }else{
-                    
-                  }
+              val connection = URL(url).openConnection()
+              val inputStream = connection.getInputStream()
+              val bitmap = android.graphics.BitmapFactory.decodeStream(inputStream)
+              inputStream.close()
+              post {
+                if (textureUrl == url) {
+                  val descriptor = BitmapDescriptorFactory.fromBitmap(bitmap)
+                  textureDescriptor = descriptor
+                  polylines.forEach { it.setCustomTexture(descriptor) }
                 }
               }
             } catch (e: Exception) {
               e.printStackTrace()
             }
+          }.start()
+        }
+        url.startsWith("file://") -> {
+          val path = url.substring(7)
+          val bitmap = android.graphics.BitmapFactory.decodeFile(path)
+          bitmap?.let { textureDescriptor = BitmapDescriptorFactory.fromBitmap(it) }
+        }
+        else -> {
+          val resId = context.resources.getIdentifier(url, "drawable", context.packageName)
+          if (resId != 0) {
+            val bitmap = android.graphics.BitmapFactory.decodeResource(context.resources, resId)
+            textureDescriptor = BitmapDescriptorFactory.fromBitmap(bitmap)
           }
-          
-          polyline = map.addPolyline(options)
         }
-      } catch (e: Throwable) {
-        android.util.Log.e("PolylineView", "Error creating/updating polyline", e)
       }
+    } catch (e: Exception) {
+      e.printStackTrace()
     }
   }
   
@@ -225,10 +304,10 @@ class PolylineView(context: Context, appContext: AppContext) : ExpoView(context,
    * 检查点击位置是否在折线附近
    */
   fun checkPress(latLng: LatLng): Boolean {
-    polyline?.let { line ->
-      val threshold = 20.0 // 20米容差
+    val threshold = 20.0 // 20米容差
+    for (line in polylines) {
       val linePoints = line.points
-      if (linePoints.size < 2) return false
+      if (linePoints.size < 2) continue
       
       for (i in 0 until linePoints.size - 1) {
         val distance = distanceToSegment(latLng, linePoints[i], linePoints[i + 1])
@@ -283,8 +362,8 @@ class PolylineView(context: Context, appContext: AppContext) : ExpoView(context,
    * 移除折线
    */
   fun removePolyline() {
-    polyline?.remove()
-    polyline = null
+    polylines.forEach { it.remove() }
+    polylines.clear()
   }
   
   override fun onDetachedFromWindow() {
@@ -293,6 +372,8 @@ class PolylineView(context: Context, appContext: AppContext) : ExpoView(context,
     post {
       if (parent == null) {
         removePolyline()
+        mapContainer?.removeCameraChangeListener(this)
+        mapContainer = null
         aMap = null
       }
     }
@@ -1,7 +1,9 @@
 package expo.modules.gaodemap.utils
 
 import com.amap.api.maps.AMapUtils
+import com.amap.api.maps.model.CameraPosition
 import com.amap.api.maps.model.LatLng
+import java.util.BitSet
 import kotlin.math.*
 
 /**
@@ -11,10 +13,25 @@ import kotlin.math.*
  */
 object GeometryUtils {
 
+    /** 地球模型：球面（Haversine，默认） */
+    const val EARTH_MODEL_SPHERE = 0
+    /** 地球模型：WGS-84 椭球（测地线距离 / 椭球面积） */
+    const val EARTH_MODEL_WGS84 = 1
+
+    /** 折线 / 多边形点数达到该值时，相机停止后只把视口内的部分交给 SDK */
+    const val VIEWPORT_CLIP_MIN_POINTS = 500
+
     init {
         System.loadLibrary("gaodecluster")
     }
 
+    /**
+     * JS 端地球模型名（'sphere' | 'wgs84'）转为 EARTH_MODEL_*，缺省或无法识别时为球面
+     */
+    fun parseEarthModel(name: String?): Int {
+        return if (name.equals("wgs84", ignoreCase = true)) EARTH_MODEL_WGS84 else EARTH_MODEL_SPHERE
+    }
+
     private external fun nativeIsPointInCircle(
         pointLat: Double,
         pointLon: Double,
@@ -30,9 +47,17 @@ object GeometryUtils {
         longitudes: DoubleArray
     ): Boolean
 
-    private external fun nativeCalculatePolygonArea(
+    private external fun nativePointsInPolygon(
+        pointLatitudes: DoubleArray,
+        pointLongitudes: DoubleArray,
         latitudes: DoubleArray,
         longitudes: DoubleArray
+    ): LongArray?
+
+    private external fun nativeCalculatePolygonArea(
+        latitudes: DoubleArray,
+        longitudes: DoubleArray,
+        earthModel: Int
     ): Double
 
     private external fun nativeCalculateRectangleArea(
@@ -46,7 +71,8 @@ object GeometryUtils {
         lat1: Double,
         lon1: Double,
         lat2: Double,
-        lon2: Double
+        lon2: Double,
+        earthModel: Int
     ): Double
 
     private external fun nativeSimplifyPolyline(
@@ -57,7 +83,8 @@ object GeometryUtils {
 
     private external fun nativeCalculatePathLength(
         latitudes: DoubleArray,
-        longitudes: DoubleArray
+        longitudes: DoubleArray,
+        earthModel: Int
     ): Double
 
     private external fun nativeGetPointAtDistance(
@@ -130,6 +157,53 @@ object GeometryUtils {
         polygonsLon: Array<DoubleArray>
     ): Int
 
+    private external fun nativeConvertCoordinates(
+        latitudes: DoubleArray,
+        longitudes: DoubleArray,
+        from: Int,
+        to: Int
+    ): Boolean
+
+    private external fun nativeClipToViewport(
+        latitudes: DoubleArray,
+        longitudes: DoubleArray,
+        closed: Boolean,
+        centerLat: Double,
+        centerLon: Double,
+        zoom: Double,
+        width: Double,
+        height: Double,
+        margin: Double,
+        tolerancePx: Double
+    ): DoubleArray?
+
+    private external fun nativeComputeClusterHulls(
+        latitudes: DoubleArray,
+        longitudes: DoubleArray,
+        clusters: IntArray,
+        maxEdgeMeters: Double
+    ): DoubleArray?
+
+    private external fun nativeAnalyzeTrajectory(
+        timestamps: DoubleArray,
+        latitudes: DoubleArray,
+        longitudes: DoubleArray,
+        stopSpeedMps: Double,
+        stopRadiusMeters: Double,
+        minStopSeconds: Double,
+        maxSpeedMps: Double,
+        maxGapSeconds: Double,
+        includeSegments: Boolean
+    ): DoubleArray?
+
+    private external fun nativeComparePaths(
+        referenceLatitudes: DoubleArray,
+        referenceLongitudes: DoubleArray,
+        latitudes: DoubleArray,
+        longitudes: DoubleArray,
+        thresholdMeters: Double
+    ): DoubleArray?
+
     private external fun nativeGenerateHeatmapGrid(
         latitudes: DoubleArray,
         longitudes: DoubleArray,
@@ -196,7 +270,36 @@ object GeometryUtils {
         }
     }
 
-    fun calculatePolygonArea(polygon: List<LatLng>): Double {
+    /**
+     * 批量判断多个点是否在同一个围栏内（配送区分配等），围栏只向原生层传一次
+     * @return 第 i 位为 true 表示第 i 个点在围栏内
+     */
+    fun isPointsInPolygon(latitudes: DoubleArray, longitudes: DoubleArray, polygon: List<LatLng>): BitSet {
+        if (latitudes.size != longitudes.size || polygon.size < 3) return BitSet()
+        val polygonLatitudes = DoubleArray(polygon.size)
+        val polygonLongitudes = DoubleArray(polygon.size)
+        for (i in polygon.indices) {
+            polygonLatitudes[i] = polygon[i].latitude
+            polygonLongitudes[i] = polygon[i].longitude
+        }
+        return try {
+            val words = nativePointsInPolygon(latitudes, longitudes, polygonLatitudes, polygonLongitudes)
+                ?: return BitSet()
+            BitSet.valueOf(words)
+        } catch (_: Throwable) {
+            val result = BitSet(latitudes.size)
+            for (i in latitudes.indices) {
+                if (isPointInPolygon(LatLng(latitudes[i], longitudes[i]), polygon)) result.set(i)
+            }
+            result
+        }
+    }
+
+    /**
+     * 计算多边形面积（平方米）
+     * @param earthModel EARTH_MODEL_SPHERE 或 EARTH_MODEL_WGS84
+     */
+    fun calculatePolygonArea(polygon: List<LatLng>, earthModel: Int = EARTH_MODEL_SPHERE): Double {
         if (polygon.size < 3) {
             return 0.0
         }
@@ -207,7 +310,7 @@ object GeometryUtils {
                 latitudes[i] = polygon[i].latitude
                 longitudes[i] = polygon[i].longitude
             }
-            nativeCalculatePolygonArea(latitudes, longitudes)
+            nativeCalculatePolygonArea(latitudes, longitudes, earthModel)
         } catch (_: Throwable) {
             AMapUtils.calculateArea(polygon).toDouble()
         }
@@ -236,11 +339,12 @@ object GeometryUtils {
      * 计算两点之间的距离
      * @param p1 第一个点
      * @param p2 第二个点
+     * @param earthModel EARTH_MODEL_SPHERE 或 EARTH_MODEL_WGS84
      * @return 两点之间的距离（单位：米）
      */
-    fun calculateDistance(p1: LatLng, p2: LatLng): Double {
+    fun calculateDistance(p1: LatLng, p2: LatLng, earthModel: Int = EARTH_MODEL_SPHERE): Double {
         return try {
-            nativeCalculateDistance(p1.latitude, p1.longitude, p2.latitude, p2.longitude)
+            nativeCalculateDistance(p1.latitude, p1.longitude, p2.latitude, p2.longitude, earthModel)
         } catch (_: Throwable) {
             val lat1 = Math.toRadians(p1.latitude)
             val lat2 = Math.toRadians(p2.latitude)
@@ -282,8 +386,9 @@ object GeometryUtils {
 
     /**
      * 计算路径总长度
+     * @param earthModel EARTH_MODEL_SPHERE 或 EARTH_MODEL_WGS84
      */
-    fun calculatePathLength(points: List<LatLng>): Double {
+    fun calculatePathLength(points: List<LatLng>, earthModel: Int = EARTH_MODEL_SPHERE): Double {
         if (points.size < 2) return 0.0
         return try {
             val latitudes = DoubleArray(points.size)
@@ -292,11 +397,11 @@ object GeometryUtils {
                 latitudes[i] = points[i].latitude
                 longitudes[i] = points[i].longitude
             }
-            nativeCalculatePathLength(latitudes, longitudes)
+            nativeCalculatePathLength(latitudes, longitudes, earthModel)
         } catch (_: Throwable) {
             var total = 0.0
             for (i in 0 until points.size - 1) {
-                total += calculateDistance(points[i], points[i+1])
+                total += calculateDistance(points[i], points[i+1], earthModel)
             }
             total
         }
@@ -538,6 +643,140 @@ object GeometryUtils {
         polylineStr: String
     ): DoubleArray?
 
+    private external fun nativeParsePolylineRings(
+        polylineStr: String,
+        dedupeAdjacent: Boolean
+    ): DoubleArray?
+
+    data class PolylineRings(
+        /** 扁平坐标 [lat0, lon0, lat1, lon1, ...] */
+        val coordinates: DoubleArray,
+        /** 每个环的起始点下标，末尾追加总点数 */
+        val ringOffsets: IntArray
+    )
+
+    /**
+     * 解析高德多环 / 多段 Polyline 字符串
+     * 格式: "lng,lat;lng,lat|lng,lat;..."，`|` 分隔环
+     */
+    fun parsePolylineRings(polylineStr: String?, dedupeAdjacent: Boolean = true): PolylineRings {
+        val empty = PolylineRings(DoubleArray(0), IntArray(1))
+        if (polylineStr.isNullOrEmpty()) return empty
+        return try {
+            val result = nativeParsePolylineRings(polylineStr, dedupeAdjacent) ?: return empty
+            if (result.isEmpty()) return empty
+            val ringCount = result[0].toInt()
+            val ringOffsets = IntArray(ringCount + 1) { i -> result[1 + i].toInt() }
+            val coordStart = 2 + ringCount
+            PolylineRings(result.copyOfRange(coordStart, result.size), ringOffsets)
+        } catch (_: Throwable) {
+            empty
+        }
+    }
+
+    private external fun nativeEncodePolyline(
+        latitudes: DoubleArray,
+        longitudes: DoubleArray,
+        precision: Int
+    ): String
+
+    private external fun nativeDecodePolyline(
+        encoded: String,
+        precision: Int
+    ): DoubleArray?
+
+    private external fun nativeResamplePolyline(
+        latitudes: DoubleArray,
+        longitudes: DoubleArray,
+        spacingMeters: Double,
+        count: Int,
+        cornerAngleDegrees: Double
+    ): DoubleArray?
+
+    private fun resamplePolylineNative(
+        points: List<LatLng>,
+        spacingMeters: Double,
+        count: Int,
+        cornerAngleDegrees: Double
+    ): List<LatLng> {
+        if (points.isEmpty()) return emptyList()
+        return try {
+            val latitudes = DoubleArray(points.size) { i -> points[i].latitude }
+            val longitudes = DoubleArray(points.size) { i -> points[i].longitude }
+            val result = nativeResamplePolyline(latitudes, longitudes, spacingMeters, count, cornerAngleDegrees)
+                ?: return points
+            val resampled = ArrayList<LatLng>(result.size / 2)
+            for (i in 0 until result.size - 1 step 2) {
+                resampled.add(LatLng(result[i], result[i + 1]))
+            }
+            resampled
+        } catch (_: Throwable) {
+            points
+        }
+    }
+
+    /**
+     * 按间距重采样路径，总长按最接近 spacingMeters 的间距均分，首尾点保留
+     */
+    fun resamplePolyline(points: List<LatLng>, spacingMeters: Double): List<LatLng> {
+        return resamplePolylineNative(points, spacingMeters, 0, 0.0)
+    }
+
+    /**
+     * 沿路径等距取 count 个点（含首尾）
+     */
+    fun resamplePolylineByCount(points: List<LatLng>, count: Int): List<LatLng> {
+        if (count <= 0) return emptyList()
+        return resamplePolylineNative(points, 0.0, count, 0.0)
+    }
+
+    /**
+     * 保留转角的重采样：航向变化超过 cornerAngleDegrees 的顶点原样保留，转角之间按间距均分
+     */
+    fun resamplePolylinePreservingCorners(
+        points: List<LatLng>,
+        spacingMeters: Double,
+        cornerAngleDegrees: Double = 30.0
+    ): List<LatLng> {
+        return resamplePolylineNative(points, spacingMeters, 0, cornerAngleDegrees)
+    }
+
+    /**
+     * 将路径编码为紧凑字符串（Encoded Polyline 格式）
+     * @param precision 小数精度位数 (1-9)
+     */
+    fun encodePolyline(points: List<LatLng>, precision: Int = 5): String {
+        if (points.isEmpty()) return ""
+        return try {
+            val latitudes = DoubleArray(points.size)
+            val longitudes = DoubleArray(points.size)
+            for (i in points.indices) {
+                latitudes[i] = points[i].latitude
+                longitudes[i] = points[i].longitude
+            }
+            nativeEncodePolyline(latitudes, longitudes, precision)
+        } catch (_: Throwable) {
+            ""
+        }
+    }
+
+    /**
+     * 解码 encodePolyline 生成的字符串
+     */
+    fun decodePolyline(encoded: String?, precision: Int = 5): List<LatLng> {
+        if (encoded.isNullOrEmpty()) return emptyList()
+        return try {
+            val result = nativeDecodePolyline(encoded, precision) ?: return emptyList()
+            val points = ArrayList<LatLng>(result.size / 2)
+            for (i in 0 until result.size - 1 step 2) {
+                points.add(LatLng(result[i], result[i + 1]))
+            }
+            points
+        } catch (_: Throwable) {
+            emptyList()
+        }
+    }
+
     fun latLngToTile(latLng: LatLng, zoom: Int): IntArray? {
         return try {
             nativeLatLngToTile(latLng.latitude, latLng.longitude, zoom)
@@ -580,6 +819,239 @@ object GeometryUtils {
         }
     }
 
+    /**
+     * 批量原地转换坐标系，结果写回传入的数组
+     * @param from / to 坐标系：0 = WGS-84，1 = GCJ-02（高德），2 = BD-09（百度）
+     * @return 是否转换成功；数组长度不一致或坐标系非法时返回 false 且不修改数组
+     */
+    fun convertCoordinates(latitudes: DoubleArray, longitudes: DoubleArray, from: Int, to: Int): Boolean {
+        if (latitudes.size != longitudes.size) return false
+        return try {
+            nativeConvertCoordinates(latitudes, longitudes, from, to)
+        } catch (_: Throwable) {
+            false
+        }
+    }
+
+    /**
+     * 把折线 / 多边形的环裁剪到视口（四周外扩 marginPx）并按像素容差抽稀，相机变化后只把可见部分交给 SDK
+     * @param closed true 时按多边形的环裁剪（结果最多一个环），false 时按折线裁剪（可能断成多段）
+     * @param zoom 当前缩放级别，widthPx / heightPx 为地图视图尺寸（像素）
+     * @return 格式同 parsePolylineRings；完全不可见时没有任何环
+     */
+    fun clipToViewport(
+        latitudes: DoubleArray,
+        longitudes: DoubleArray,
+        closed: Boolean,
+        center: LatLng,
+        zoom: Double,
+        widthPx: Double,
+        heightPx: Double,
+        marginPx: Double,
+        tolerancePx: Double = 0.5
+    ): PolylineRings {
+        val empty = PolylineRings(DoubleArray(0), IntArray(1))
+        if (latitudes.size != longitudes.size || latitudes.isEmpty()) return empty
+        return try {
+            val result = nativeClipToViewport(
+                latitudes, longitudes, closed, center.latitude, center.longitude,
+                zoom, widthPx, heightPx, marginPx, tolerancePx
+            ) ?: return empty
+            if (result.isEmpty()) return empty
+            val ringCount = result[0].toInt()
+            val ringOffsets = IntArray(ringCount + 1) { i -> result[1 + i].toInt() }
+            val coordStart = 2 + ringCount
+            PolylineRings(result.copyOfRange(coordStart, result.size), ringOffsets)
+        } catch (_: Throwable) {
+            empty
+        }
+    }
+
+    /**
+     * 按相机把折线 / 多边形的环裁剪到地图视图，四周各外扩半个视图，平移时边缘不会立刻露出缺口
+     * 地图旋转时按视图的外接正方形裁剪；有俯仰角时可见区域不是矩形，不裁剪
+     * @param widthDp / heightDp 地图视图尺寸（dp，与 256 像素瓦片的世界坐标一致）
+     * @return 可见的各段（多边形最多一段，完全不可见时为空）；不裁剪或原生调用失败时返回 null，调用方应使用原始点
+     */
+    fun clipToCamera(
+        points: List<LatLng>,
+        closed: Boolean,
+        camera: CameraPosition,
+        widthDp: Double,
+        heightDp: Double
+    ): List<List<LatLng>>? {
+        if (points.isEmpty() || camera.tilt > 0f || widthDp <= 0.0 || heightDp <= 0.0) return null
+        val rotated = camera.bearing % 360f != 0f
+        val width = if (rotated) hypot(widthDp, heightDp) else widthDp
+        val height = if (rotated) width else heightDp
+        val latitudes = DoubleArray(points.size) { points[it].latitude }
+        val longitudes = DoubleArray(points.size) { points[it].longitude }
+        return try {
+            val result = nativeClipToViewport(
+                latitudes, longitudes, closed, camera.target.latitude, camera.target.longitude,
+                camera.zoom.toDouble(), width, height, max(width, height) * 0.5, 0.5
+            ) ?: return null
+            if (result.isEmpty()) return null
+            val ringCount = result[0].toInt()
+            val coordStart = 2 + ringCount
+            List(ringCount) { r ->
+                val begin = result[1 + r].toInt()
+                val end = result[2 + r].toInt()
+                List(end - begin) { i ->
+                    val k = coordStart + (begin + i) * 2
+                    LatLng(result[k], result[k + 1])
+                }
+            }
+        } catch (_: Throwable) {
+            null
+        }
+    }
+
+    /**
+     * 批量计算聚合簇覆盖的区域（点击聚合点时展示）
+     * @param clusters ClusterNative.clusterPoints 的返回值，下标指向 latitudes / longitudes
+     * @param maxEdgeMeters > 0 时为凹包（边界边不长于该值，取聚合半径左右即可），否则为凸包
+     * @return 每个簇一个环，格式同 parsePolylineRings；单点或共线的簇环中只有 1~2 个点
+     */
+    fun computeClusterHulls(
+        latitudes: DoubleArray,
+        longitudes: DoubleArray,
+        clusters: IntArray,
+        maxEdgeMeters: Double = 0.0
+    ): PolylineRings {
+        val empty = PolylineRings(DoubleArray(0), IntArray(1))
+        if (latitudes.size != longitudes.size || clusters.isEmpty()) return empty
+        return try {
+            val result = nativeComputeClusterHulls(latitudes, longitudes, clusters, maxEdgeMeters) ?: return empty
+            if (result.isEmpty()) return empty
+            val ringCount = result[0].toInt()
+            val ringOffsets = IntArray(ringCount + 1) { i -> result[1 + i].toInt() }
+            val coordStart = 2 + ringCount
+            PolylineRings(result.copyOfRange(coordStart, result.size), ringOffsets)
+        } catch (_: Throwable) {
+            empty
+        }
+    }
+
+    data class TrajectoryStop(
+        val point: LatLng,
+        val startTime: Double,
+        val endTime: Double,
+        val firstIndex: Int,
+        val lastIndex: Int,
+        val pointCount: Int
+    )
+
+    data class TrajectoryAnalysis(
+        val pointCount: Int,
+        val acceptedCount: Int,
+        val outlierCount: Int,
+        val totalDistanceMeters: Double,
+        val totalSeconds: Double,
+        val movingSeconds: Double,
+        val stoppedSeconds: Double,
+        val maxSpeedMps: Double,
+        val averageSpeedMps: Double,
+        val movingAverageSpeedMps: Double,
+        val stops: List<TrajectoryStop>,
+        /** 每个点相对上一个有效点的速度 (m/s)，includeSegments 为 false 时为空 */
+        val speeds: DoubleArray,
+        /** 每个点的航向（正北为 0，顺时针），首个点为 NaN */
+        val headings: DoubleArray,
+        /** 每个点的标记位：1 跳点，2 静止，4 断档，8 重新定位 */
+        val flags: IntArray
+    )
+
+    /**
+     * 轨迹分析：一次遍历计算速度 / 航向、剔除跳点、识别停留并统计里程与时长
+     * @param timestamps 时间戳（秒），与坐标一一对应
+     */
+    fun analyzeTrajectory(
+        timestamps: DoubleArray,
+        latitudes: DoubleArray,
+        longitudes: DoubleArray,
+        stopSpeedMps: Double = 0.5,
+        stopRadiusMeters: Double = 30.0,
+        minStopSeconds: Double = 120.0,
+        maxSpeedMps: Double = 70.0,
+        maxGapSeconds: Double = 300.0,
+        includeSegments: Boolean = false
+    ): TrajectoryAnalysis? {
+        if (latitudes.size != longitudes.size || latitudes.size != timestamps.size) return null
+        return try {
+            val result = nativeAnalyzeTrajectory(
+                timestamps, latitudes, longitudes,
+                stopSpeedMps, stopRadiusMeters, minStopSeconds, maxSpeedMps, maxGapSeconds, includeSegments
+            ) ?: return null
+            if (result.size < 11) return null
+            val stopCount = result[10].toInt()
+            val stops = ArrayList<TrajectoryStop>(stopCount)
+            for (k in 0 until stopCount) {
+                val base = 11 + k * 7
+                stops.add(TrajectoryStop(
+                    LatLng(result[base], result[base + 1]),
+                    result[base + 2],
+                    result[base + 3],
+                    result[base + 4].toInt(),
+                    result[base + 5].toInt(),
+                    result[base + 6].toInt()
+                ))
+            }
+            val segmentStart = 11 + stopCount * 7
+            val segmentCount = (result.size - segmentStart) / 3
+            TrajectoryAnalysis(
+                pointCount = result[0].toInt(),
+                acceptedCount = result[1].toInt(),
+                outlierCount = result[2].toInt(),
+                totalDistanceMeters = result[3],
+                totalSeconds = result[4],
+                movingSeconds = result[5],
+                stoppedSeconds = result[6],
+                maxSpeedMps = result[7],
+                averageSpeedMps = result[8],
+                movingAverageSpeedMps = result[9],
+                stops = stops,
+                speeds = DoubleArray(segmentCount) { i -> result[segmentStart + i * 3] },
+                headings = DoubleArray(segmentCount) { i -> result[segmentStart + i * 3 + 1] },
+                flags = IntArray(segmentCount) { i -> result[segmentStart + i * 3 + 2].toInt() }
+            )
+        } catch (_: Throwable) {
+            null
+        }
+    }
+
+    data class PathComparison(
+        /** 路线各顶点到参考路线的平均距离 */
+        val averageDeviationMeters: Double,
+        /** 路线各顶点到参考路线的最大距离 */
+        val maxDeviationMeters: Double,
+        /** 到参考路线的距离超过阈值的顶点数 */
+        val exceededCount: Int,
+        /** 双向 Hausdorff 距离 */
+        val hausdorffMeters: Double,
+        /** 离散 Fréchet 距离（考虑行进顺序） */
+        val frechetMeters: Double
+    )
+
+    /**
+     * 比较候选路线与参考路线（如 Web 规划线）的相似程度
+     */
+    fun comparePaths(reference: List<LatLng>, path: List<LatLng>, thresholdMeters: Double): PathComparison? {
+        if (reference.isEmpty() || path.isEmpty()) return null
+        return try {
+            val result = nativeComparePaths(
+                DoubleArray(reference.size) { i -> reference[i].latitude },
+                DoubleArray(reference.size) { i -> reference[i].longitude },
+                DoubleArray(path.size) { i -> path[i].latitude },
+                DoubleArray(path.size) { i -> path[i].longitude },
+                thresholdMeters
+            ) ?: return null
+            PathComparison(result[0], result[1], result[2].toInt(), result[3], result[4])
+        } catch (_: Throwable) {
+            null
+        }
+    }
+
     fun findPointInPolygons(point: LatLng, polygons: List<List<LatLng>>): Int {
         if (polygons.isEmpty()) return -1
         return try {
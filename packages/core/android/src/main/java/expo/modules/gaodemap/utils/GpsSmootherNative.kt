@@ -0,0 +1,65 @@
+package expo.modules.gaodemap.utils
+
+/**
+ * C++ GPS 平滑器对象池 (GpsSmootherPool) 的 JNI 入口
+ *
+ * 每个槽位对应一辆车的卡尔曼滤波器，每帧把所有车辆的新定位点放在一次 [nativeUpdate] 中批量处理；
+ * 通过 handle 持有原生对象，使用方负责在不再需要时调用 [nativeDestroy]
+ */
+object GpsSmootherNative {
+    init {
+        System.loadLibrary("gaodecluster")
+    }
+
+    /** 标记位：定位点被剔除，输出为预测位置 */
+    const val FLAG_REJECTED = 1
+    /** 标记位：滤波器在该定位点重新初始化 */
+    const val FLAG_RESET = 2
+    /** 标记位：槽位无效 */
+    const val FLAG_INVALID = 4
+
+    /**
+     * @param accelerationNoise 加速度标准差 (m/s²)，越大越跟手、越小越平滑
+     * @param minGateMeters 定位点与预测位置的距离不超过该值时总是接受
+     * @param gateScale 距离超过最近新息中值的该倍数时视为跳点
+     * @param maxRejected 连续剔除达到该次数时在新位置重新初始化
+     * @param resetAfterSeconds 超过该间隔未更新时重新初始化
+     */
+    external fun nativeCreate(
+        capacity: Int,
+        accelerationNoise: Double,
+        minGateMeters: Double,
+        gateScale: Double,
+        maxRejected: Int,
+        resetAfterSeconds: Double
+    ): Long
+
+    external fun nativeDestroy(handle: Long)
+
+    /**
+     * @return 槽位号，池已满时返回 -1
+     */
+    external fun nativeAcquire(handle: Long): Int
+
+    external fun nativeRelease(handle: Long, slot: Int)
+
+    /**
+     * @param timestamps 时间戳（秒）
+     * @param accuracies 定位精度（米），为 null 时使用默认值
+     * @return 每个定位点 5 项 [lat, lon, speedMps, headingDegrees, flags]
+     */
+    external fun nativeUpdate(
+        handle: Long,
+        slots: IntArray,
+        timestamps: DoubleArray,
+        latitudes: DoubleArray,
+        longitudes: DoubleArray,
+        accuracies: DoubleArray?
+    ): DoubleArray?
+
+    /**
+     * 按当前速度外推到指定时间的位置，用于两次定位之间的标记动画
+     * @return [lat, lon]，槽位无效或尚未初始化时返回 null
+     */
+    external fun nativePredict(handle: Long, slot: Int, time: Double): DoubleArray?
+}
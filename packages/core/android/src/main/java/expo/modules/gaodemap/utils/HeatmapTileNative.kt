@@ -0,0 +1,43 @@
+package expo.modules.gaodemap.utils
+
+/**
+ * C++ 热力图瓦片生成器 (HeatmapTileProvider) 的 JNI 入口
+ *
+ * 通过 handle 持有原生对象，使用方负责在不再需要时调用 [nativeDestroy]
+ */
+object HeatmapTileNative {
+    init {
+        System.loadLibrary("gaodecluster")
+    }
+
+    external fun nativeCreate(maxCachedTiles: Int): Long
+
+    external fun nativeDestroy(handle: Long)
+
+    external fun nativeSetPoints(
+        handle: Long,
+        latitudes: DoubleArray,
+        longitudes: DoubleArray,
+        weights: DoubleArray
+    )
+
+    /**
+     * @param kernel 0 = Gaussian，1 = Epanechnikov
+     * @param colors 渐变颜色 (ARGB)，为 null 时使用默认蓝-绿-红渐变
+     * @param maxIntensity 映射为渐变末端的密度值，<= 0 时自动估计
+     */
+    external fun nativeSetStyle(
+        handle: Long,
+        tileSize: Int,
+        radiusPx: Double,
+        kernel: Int,
+        colors: IntArray?,
+        startPoints: FloatArray?,
+        maxIntensity: Float
+    )
+
+    /**
+     * @return tileSize * tileSize 个 ARGB 像素，瓦片内无数据时返回 null
+     */
+    external fun nativeGetTile(handle: Long, x: Int, y: Int, zoom: Int): IntArray?
+}
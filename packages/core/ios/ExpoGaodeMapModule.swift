@@ -260,6 +260,109 @@ public class ExpoGaodeMapModule: Module {
             return result
         }
 
+        /**
+         * 解析高德多环 / 多段 Polyline 字符串
+         * @param polylineStr 折线字符串，`|` 分隔环，`;` 分隔坐标点
+         * @param dedupeAdjacent 是否去除环内相邻重复点
+         * @return 扁平坐标数组与环偏移
+         */
+        Function("parsePolylineRings") { (polylineStr: String?, dedupeAdjacent: Bool?) -> [String: Any] in
+            guard let polylineStr = polylineStr, !polylineStr.isEmpty else {
+                return ["coordinates": [Double](), "ringOffsets": [0]]
+            }
+            return (ClusterNative.parsePolylineRings(polylineStr: polylineStr, dedupeAdjacent: dedupeAdjacent ?? true) as? [String: Any])
+                ?? ["coordinates": [Double](), "ringOffsets": [0]]
+        }
+
+        /**
+         * 将路径编码为紧凑字符串 (Encoded Polyline)
+         * @param points 路径点
+         * @param precision 小数精度位数 (1-9)，默认 5
+         */
+        Function("encodePolyline") { (points: [Any]?, precision: Int?) -> String in
+            let coords = LatLngParser.parseLatLngList(points)
+            if coords.isEmpty {
+                return ""
+            }
+            let lats = coords.map { NSNumber(value: $0.latitude) }
+            let lons = coords.map { NSNumber(value: $0.longitude) }
+            return ClusterNative.encodePolyline(latitudes: lats, longitudes: lons, precision: Int32(precision ?? 5))
+        }
+
+        /**
+         * 解码 encodePolyline 生成的字符串
+         * @param encoded 编码字符串
+         * @param precision 编码时使用的精度位数，默认 5
+         */
+        Function("decodePolyline") { (encoded: String?, precision: Int?) -> [[String: Double]] in
+            guard let encoded = encoded, !encoded.isEmpty else {
+                return []
+            }
+
+            let flatCoords = ClusterNative.decodePolyline(encoded: encoded, precision: Int32(precision ?? 5))
+            var result: [[String: Double]] = []
+            result.reserveCapacity(flatCoords.count / 2)
+            for i in stride(from: 0, to: flatCoords.count - 1, by: 2) {
+                result.append([
+                    "latitude": flatCoords[i].doubleValue,
+                    "longitude": flatCoords[i + 1].doubleValue
+                ])
+            }
+            return result
+        }
+
+        /**
+         * 按间距重采样路径
+         * @param spacingMeters 目标间距(米)
+         * @param cornerAngleDegrees > 0 时保留航向变化超过该角度的转角
+         */
+        Function("resamplePolyline") { (points: [[String: Double]]?, spacingMeters: Double, cornerAngleDegrees: Double?) -> [[String: Double]] in
+            let coords = LatLngParser.parseLatLngList(points)
+            let resampled = GeometryUtils.resamplePolyline(coords, spacingMeters: spacingMeters, cornerAngleDegrees: cornerAngleDegrees ?? 0)
+            return resampled.map {
+                [
+                    "latitude": $0.latitude,
+                    "longitude": $0.longitude
+                ]
+            }
+        }
+
+        /**
+         * 沿路径等距取点
+         * @param count 点数（含首尾）
+         */
+        Function("resamplePolylineByCount") { (points: [[String: Double]]?, count: Int) -> [[String: Double]] in
+            let coords = LatLngParser.parseLatLngList(points)
+            let resampled = GeometryUtils.resamplePolyline(coords, count: count)
+            return resampled.map {
+                [
+                    "latitude": $0.latitude,
+                    "longitude": $0.longitude
+                ]
+            }
+        }
+
+        /**
+         * 比较候选路线与参考路线（如 Web 规划线）的相似程度
+         * @param thresholdMeters 统计超限顶点数的距离阈值(米)
+         */
+        Function("comparePaths") { (reference: [[String: Double]]?, points: [[String: Double]]?, thresholdMeters: Double) -> [String: Any]? in
+            let referenceCoords = LatLngParser.parseLatLngList(reference)
+            let coords = LatLngParser.parseLatLngList(points)
+            if referenceCoords.isEmpty || coords.isEmpty {
+                return nil
+            }
+            
+            let result = ClusterNative.comparePaths(
+                referenceLatitudes: referenceCoords.map { NSNumber(value: $0.latitude) },
+                referenceLongitudes: referenceCoords.map { NSNumber(value: $0.longitude) },
+                latitudes: coords.map { NSNumber(value: $0.latitude) },
+                longitudes: coords.map { NSNumber(value: $0.longitude) },
+                thresholdMeters: thresholdMeters
+            )
+            return result.isEmpty ? nil : result as? [String: Any]
+        }
+
         /**
          * 坐标转换
          * @param coordinate 原始坐标
@@ -280,12 +383,18 @@ public class ExpoGaodeMapModule: Module {
         /**
          * 计算两点之间的距离
          */
-        Function("distanceBetweenCoordinates") { (p1: [String: Double]?, p2: [String: Double]?) -> Double in
+        Function("distanceBetweenCoordinates") { (p1: [String: Double]?, p2: [String: Double]?, earthModel: String?) -> Double in
             guard let coord1 = LatLngParser.parseLatLng(p1),
                   let coord2 = LatLngParser.parseLatLng(p2) else {
                 return 0.0
             }
-            return ClusterNative.calculateDistance(lat1: coord1.latitude, lon1: coord1.longitude, lat2: coord2.latitude, lon2: coord2.longitude)
+            return ClusterNative.calculateDistance(
+                lat1: coord1.latitude,
+                lon1: coord1.longitude,
+                lat2: coord2.latitude,
+                lon2: coord2.longitude,
+                earthModel: self.earthModelValue(earthModel)
+            )
         }
 
         /**
@@ -317,15 +426,17 @@ public class ExpoGaodeMapModule: Module {
          * 计算多边形面积
          * @param points 多边形顶点坐标数组，支持嵌套数组（多边形空洞）
          */
-        Function("calculatePolygonArea") { (points: [Any]?) -> Double in
+        Function("calculatePolygonArea") { (points: [Any]?, earthModel: String?) -> Double in
             let rings = LatLngParser.parseLatLngListList(points)
             if rings.isEmpty { return 0.0 }
+            let model = self.earthModelValue(earthModel)
             
             // 第一项是外轮廓
             let outerCoords = rings[0]
             var totalArea = ClusterNative.calculatePolygonArea(
                 latitudes: outerCoords.map { NSNumber(value: $0.latitude) },
-                longitudes: outerCoords.map { NSNumber(value: $0.longitude) }
+                longitudes: outerCoords.map { NSNumber(value: $0.longitude) },
+                earthModel: model
             )
             
             // 后续项是内孔，需要减去面积
@@ -334,7 +445,8 @@ public class ExpoGaodeMapModule: Module {
                     let ring = rings[i]
                     totalArea -= ClusterNative.calculatePolygonArea(
                         latitudes: ring.map { NSNumber(value: $0.latitude) },
-                        longitudes: ring.map { NSNumber(value: $0.longitude) }
+                        longitudes: ring.map { NSNumber(value: $0.longitude) },
+                        earthModel: model
                     )
                 }
             }
@@ -449,7 +561,7 @@ public class ExpoGaodeMapModule: Module {
                 let lats = coords.map { NSNumber(value: $0.latitude) }
                 let lons = coords.map { NSNumber(value: $0.longitude) }
                 
-                let area = ClusterNative.calculatePolygonArea(latitudes: lats, longitudes: lons)
+                let area = ClusterNative.calculatePolygonArea(latitudes: lats, longitudes: lons, earthModel: 0)
                 if let centroid = ClusterNative.calculateCentroid(latitudes: lats, longitudes: lons) as? [String: Double],
                    let cLat = centroid["latitude"], let cLon = centroid["longitude"] {
                     
@@ -516,11 +628,11 @@ public class ExpoGaodeMapModule: Module {
         /**
          * 计算路径总长度
          */
-        Function("calculatePathLength") { (points: [[String: Double]]?) -> Double in
+        Function("calculatePathLength") { (points: [[String: Double]]?, earthModel: String?) -> Double in
             let coords = LatLngParser.parseLatLngList(points)
             let lats = coords.map { NSNumber(value: $0.latitude) }
             let lons = coords.map { NSNumber(value: $0.longitude) }
-            return ClusterNative.calculatePathLength(latitudes: lats, longitudes: lons)
+            return ClusterNative.calculatePathLength(latitudes: lats, longitudes: lons, earthModel: self.earthModelValue(earthModel))
         }
         
         /**
@@ -882,6 +994,11 @@ public class ExpoGaodeMapModule: Module {
         return result
     }
 
+    /// JS 端地球模型名（'sphere' | 'wgs84'）转为 ClusterNative 使用的取值，缺省或无法识别时为球面
+    private func earthModelValue(_ name: String?) -> Int {
+        return name?.lowercased() == "wgs84" ? 1 : 0
+    }
+
     private func getAccuracyAuthorizationString(granted: Bool) -> String {
         guard granted else { return "none" }
         if #available(iOS 14.0, *) {
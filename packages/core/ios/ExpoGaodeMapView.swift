@@ -353,8 +353,8 @@ class ExpoGaodeMapView: ExpoView, MAMapViewDelegate, UIGestureRecognizerDelegate
             }
         } else if let polylineView = subview as? PolylineView {
             unregisterOverlayView(polylineView)
-            if let mapView, let polyline = polylineView.polyline {
-                mapView.remove(polyline)
+            if let mapView, !polylineView.polylines.isEmpty {
+                mapView.removeOverlays(polylineView.polylines)
             }
         } else if let polygonView = subview as? PolygonView {
             unregisterOverlayView(polygonView)
@@ -1091,6 +1091,10 @@ extension ExpoGaodeMapView {
                 if clusterView.superview != nil && clusterView.window != nil {
                     clusterView.mapRegionDidChange()
                 }
+            } else if let polylineView = view as? PolylineView {
+                polylineView.mapRegionDidChange()
+            } else if let polygonView = view as? PolygonView {
+                polygonView.mapRegionDidChange()
             }
         }
         
@@ -1280,11 +1284,8 @@ extension ExpoGaodeMapView {
         let threshold: Double = 20.0 // 20米容差
         
         for polylineView in polylineViews {
-            guard let polyline = polylineView.polyline else {
-                continue
-            }
-            
-            if isPoint(coordinate, nearPolyline: polyline, threshold: threshold) {
+            // 按视口裁剪后一条折线可能有多段
+            for polyline in polylineView.polylines where isPoint(coordinate, nearPolyline: polyline, threshold: threshold) {
                 polylineView.onPolylinePress([
                     "latitude": coordinate.latitude,
                     "longitude": coordinate.longitude
@@ -1567,8 +1568,8 @@ extension ExpoGaodeMapView {
                 if circle === overlay {
                     return circleView.getRenderer()
                 }
-            } else if let polylineView = view as? PolylineView, let polyline = polylineView.polyline, polyline === overlay {
-                return polylineView.getRenderer()
+            } else if let polylineView = view as? PolylineView, polylineView.owns(overlay) {
+                return polylineView.getRenderer(for: overlay)
             } else if let polygonView = view as? PolygonView, let polygon = polygonView.polygon, polygon === overlay {
                 return polygonView.getRenderer()
             } else if let heatMapView = view as? HeatMapView, let heatmap = heatMapView.heatmapOverlay, heatmap === overlay {
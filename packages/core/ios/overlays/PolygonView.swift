@@ -33,6 +33,10 @@ class PolygonView: ExpoView {
     var polygon: MAPolygon?
     /// 多边形渲染器
     private var renderer: MAPolygonRenderer?
+    /// 简化后、裁剪前的外轮廓
+    private var displayCoords: [CLLocationCoordinate2D] = []
+    /// 内孔
+    private var holeCoords: [[CLLocationCoordinate2D]] = []
     /// 上次设置的地图引用（防止重复调用）
     private weak var lastSetMapView: MAMapView?
     
@@ -77,12 +81,16 @@ class PolygonView: ExpoView {
      * 更新多边形覆盖物
      */
     private func updatePolygon() {
-        guard let mapView = mapView else { return }
-        if let old = polygon { mapView.remove(old) }
+        guard mapView != nil else { return }
         
         // 🔑 使用支持嵌套列表的坐标解析器
         let nestedCoords = LatLngParser.parseLatLngListList(points)
-        guard !nestedCoords.isEmpty else { return }
+        guard !nestedCoords.isEmpty else {
+            displayCoords = []
+            holeCoords = []
+            updateShape()
+            return
+        }
         
         // 第一项是外轮廓
         var outerCoords = nestedCoords[0]
@@ -99,19 +107,57 @@ class PolygonView: ExpoView {
             ])
         }
         
+        displayCoords = outerCoords
+        // 处理内孔 (hollowShapes)
+        holeCoords = nestedCoords.dropFirst().filter { $0.count >= 3 }
+        updateShape()
+    }
+    
+    /**
+     * 相机停止后按新的视口重新裁剪
+     */
+    func mapRegionDidChange() {
+        if clipEnabled() {
+            updateShape()
+        }
+    }
+    
+    private func clipEnabled() -> Bool {
+        return displayCoords.count + holeCoords.reduce(0) { $0 + $1.count } >= GeometryUtils.viewportClipMinPoints
+    }
+    
+    /**
+     * 按当前视口裁剪外轮廓与内孔后交给地图，完全移出视口时不添加多边形
+     */
+    private func updateShape() {
+        guard let mapView = mapView else { return }
+        if let old = polygon {
+            mapView.remove(old)
+            polygon = nil
+        }
+        renderer = nil
+        
+        var outerCoords = displayCoords
+        var holes = holeCoords
+        if clipEnabled(), let rings = GeometryUtils.clipToMapView(displayCoords, closed: true, mapView: mapView) {
+            outerCoords = rings.first ?? []
+            // 内孔被外轮廓包含，裁剪到同一视口后仍在裁剪后的外轮廓内
+            holes = holeCoords.compactMap { hole in
+                guard let clipped = GeometryUtils.clipToMapView(hole, closed: true, mapView: mapView) else {
+                    return hole
+                }
+                guard let ring = clipped.first, ring.count >= 3 else { return nil }
+                return ring
+            }
+        }
+        
         // 🔑 至少需要3个点才能绘制多边形
         guard outerCoords.count >= 3 else { return }
         
-        // 处理内孔 (hollowShapes)
         var hollowShapes: [MAOverlay] = []
-        if nestedCoords.count > 1 {
-            for i in 1..<nestedCoords.count {
-                var ring = nestedCoords[i]
-                if ring.count >= 3 {
-                    if let hole = MAPolygon(coordinates: &ring, count: UInt(ring.count)) {
-                        hollowShapes.append(hole)
-                    }
-                }
+        for var ring in holes {
+            if let hole = MAPolygon(coordinates: &ring, count: UInt(ring.count)) {
+                hollowShapes.append(hole)
             }
         }
         
@@ -125,8 +171,6 @@ class PolygonView: ExpoView {
             self.polygon = mainPolygon
             mapView.add(mainPolygon)
         }
-        
-        renderer = nil
     }
     
     /**
@@ -29,10 +29,15 @@ class PolylineView: ExpoView {
     
     /// 地图视图引用
     private var mapView: MAMapView?
-    /// 折线覆盖物对象
-    var polyline: MAPolyline?
-    /// 折线渲染器
-    private var renderer: MAPolylineRenderer?
+    /// 折线覆盖物对象，点数较多时按视口裁剪，可能断成多段
+    private(set) var polylines: [MAPolyline] = []
+    /// 各段的渲染器
+    private var renderers: [ObjectIdentifier: MAPolylineRenderer] = [:]
+    /// 简化后、裁剪前的点
+    private var displayCoords: [CLLocationCoordinate2D] = []
+    /// 已加载的纹理，裁剪新增的分段直接复用
+    private var textureImage: UIImage?
+    private var isLoadingTexture = false
     /// 上次设置的地图引用（防止重复调用）
     private weak var lastSetMapView: MAMapView?
     
@@ -71,7 +76,7 @@ class PolylineView: ExpoView {
     func setMap(_ map: MAMapView) {
         // 🔑 关键优化：如果是同一个地图引用，跳过重复设置
         if lastSetMapView === map {
-            if polyline == nil {
+            if polylines.isEmpty {
                 updatePolyline()
             }
             return
@@ -94,8 +99,7 @@ class PolylineView: ExpoView {
      * 更新折线覆盖物
      */
     private func updatePolyline() {
-        guard let mapView = mapView else { return }
-        if let old = polyline { mapView.remove(old) }
+        guard mapView != nil else { return }
         
         // 🔑 使用统一的坐标解析器
         var coords = LatLngParser.parseLatLngList(points)
@@ -105,64 +109,116 @@ class PolylineView: ExpoView {
             coords = GeometryUtils.simplifyPolyline(coords, tolerance: simplificationTolerance)
         }
         
+        displayCoords = coords
+        renderers.removeAll()
+        updateSegments()
+    }
+    
+    /**
+     * 相机停止后按新的视口重新裁剪
+     */
+    func mapRegionDidChange() {
+        if displayCoords.count >= GeometryUtils.viewportClipMinPoints {
+            updateSegments()
+        }
+    }
+    
+    /**
+     * 把折线按当前视口裁剪后重新交给地图
+     */
+    private func updateSegments() {
+        guard let mapView = mapView else { return }
+        mapView.removeOverlays(polylines)
+        polylines.removeAll()
+        
         // 🔑 至少需要2个点才能绘制折线
-        guard coords.count >= 2 else { return }
+        guard displayCoords.count >= 2 else {
+            renderers.removeAll()
+            return
+        }
         
-        renderer = nil
-        polyline = MAPolyline(coordinates: &coords, count: UInt(coords.count))
-        mapView.add(polyline!)
+        var segments = [displayCoords]
+        if displayCoords.count >= GeometryUtils.viewportClipMinPoints,
+           let clipped = GeometryUtils.clipToMapView(displayCoords, closed: false, mapView: mapView) {
+            segments = clipped
+        }
+        
+        // 旧分段已移除，渲染器随新分段重新创建
+        renderers.removeAll()
+        for var segment in segments where segment.count >= 2 {
+            if let polyline = MAPolyline(coordinates: &segment, count: UInt(segment.count)) {
+                polylines.append(polyline)
+            }
+        }
+        mapView.addOverlays(polylines)
+    }
+    
+    /**
+     * 是否为本视图的折线分段
+     */
+    func owns(_ overlay: MAOverlay) -> Bool {
+        return polylines.contains { $0 === overlay }
     }
     
     /**
-     * 获取折线渲染器
+     * 获取折线分段的渲染器
      * @return 渲染器实例
      */
-    func getRenderer() -> MAOverlayRenderer {
-        if renderer == nil, let polyline = polyline {
-            renderer = MAPolylineRenderer(polyline: polyline)
-            renderer?.lineWidth = CGFloat(strokeWidth)
-            // MALineDashType 是 C enum,Swift 导入为全局常量 kMALineDashType*;square 与 Android DOTTEDLINE_TYPE_SQUARE 对齐
-            renderer?.lineDashType = isDotted ? kMALineDashTypeSquare : kMALineDashTypeNone
-            
-            if let url = textureUrl {
-                loadTexture(url: url, renderer: renderer!)
+    func getRenderer(for overlay: MAOverlay) -> MAOverlayRenderer {
+        let key = ObjectIdentifier(overlay)
+        if let existing = renderers[key] {
+            return existing
+        }
+        guard let polyline = overlay as? MAPolyline, let renderer = MAPolylineRenderer(polyline: polyline) else {
+            return MAOverlayRenderer(overlay: overlay)
+        }
+        renderer.lineWidth = CGFloat(strokeWidth)
+        // MALineDashType 是 C enum,Swift 导入为全局常量 kMALineDashType*;square 与 Android DOTTEDLINE_TYPE_SQUARE 对齐
+        renderer.lineDashType = isDotted ? kMALineDashTypeSquare : kMALineDashTypeNone
+        
+        if let url = textureUrl {
+            if let image = textureImage {
+                renderer.strokeImage = image
             } else {
-                let parsedColor = ColorParser.parseColor(strokeColor)
-                renderer?.strokeColor = parsedColor ?? UIColor.clear
+                loadTexture(url: url)
             }
+        } else {
+            let parsedColor = ColorParser.parseColor(strokeColor)
+            renderer.strokeColor = parsedColor ?? UIColor.clear
         }
-        return renderer!
+        renderers[key] = renderer
+        return renderer
     }
     
     /**
-     * 加载纹理图片
+     * 加载纹理图片，完成后应用到全部分段
      * @param url 图片 URL (支持 http/https/file/本地资源)
-     * @param renderer 折线渲染器
      */
-    private func loadTexture(url: String, renderer: MAPolylineRenderer) {
+    private func loadTexture(url: String) {
+        if isLoadingTexture { return }
         if url.hasPrefix("http://") || url.hasPrefix("https://") {
             guard let imageUrl = URL(string: url) else {
                 return
             }
+            isLoadingTexture = true
             URLSession.shared.dataTask(with: imageUrl) { [weak self] data, _, error in
-                if error != nil {
-                    return
-                }
-                guard let data = data, let image = UIImage(data: data) else {
-                    return
-                }
                 DispatchQueue.main.async {
-                    self?.applyTexture(image: image, to: renderer)
+                    guard let self = self else { return }
+                    self.isLoadingTexture = false
+                    guard error == nil, let data = data, let image = UIImage(data: data), self.textureUrl == url else {
+                        return
+                    }
+                    self.applyTexture(image: image)
                 }
             }.resume()
         } else if url.hasPrefix("file://") {
             let path = String(url.dropFirst(7))
             if let image = UIImage(contentsOfFile: path) {
-                applyTexture(image: image, to: renderer)
+                applyTexture(image: image)
             }
         } else {
             if let image = UIImage(named: url) {
-                applyTexture(image: image, to: renderer)
+                applyTexture(image: image)
             }
         }
     }
@@ -176,11 +232,13 @@ class PolylineView: ExpoView {
      * - 若设置了纹理，线颜色、连接类型和端点类型将无效
      * 
      * @param image 纹理图片
-     * @param renderer 折线渲染器
      */
-    private func applyTexture(image: UIImage, to renderer: MAPolylineRenderer) {
+    private func applyTexture(image: UIImage) {
+        textureImage = image
         // 🔑 关键修复：使用 strokeImage 属性设置纹理（与命令式 API 一致）
-        renderer.strokeImage = image
+        for renderer in renderers.values {
+            renderer.strokeImage = image
+        }
         mapView?.setNeedsDisplay()
     }
     
@@ -199,7 +257,6 @@ class PolylineView: ExpoView {
      */
     func setStrokeWidth(_ width: Float) {
         strokeWidth = width
-        renderer = nil
         forceRerender()
     }
     
@@ -209,7 +266,6 @@ class PolylineView: ExpoView {
      */
     func setStrokeColor(_ color: String?) {
         strokeColor = color
-        renderer = nil
         forceRerender()
     }
     
@@ -219,7 +275,7 @@ class PolylineView: ExpoView {
      */
     func setTexture(_ url: String?) {
         textureUrl = url
-        renderer = nil
+        textureImage = nil
         forceRerender()
     }
     
@@ -233,7 +289,6 @@ class PolylineView: ExpoView {
     
     func setDotted(_ dotted: Bool) {
         isDotted = dotted
-        renderer = nil
         forceRerender()
     }
     
@@ -247,10 +302,11 @@ class PolylineView: ExpoView {
         
         // 当 newSuperview 为 nil 时，表示视图正在从父视图移除
         if newSuperview == nil {
-            if let mapView = mapView, let polyline = polyline {
-                mapView.remove(polyline)
-                self.polyline = nil
+            if let mapView = mapView {
+                mapView.removeOverlays(polylines)
             }
+            polylines.removeAll()
+            renderers.removeAll()
         }
     }
     
@@ -258,11 +314,11 @@ class PolylineView: ExpoView {
      * 析构时移除折线（双重保险）
      */
     deinit {
-        if let mapView = mapView, let polyline = polyline {
-            mapView.remove(polyline)
+        if let mapView = mapView {
+            mapView.removeOverlays(polylines)
         }
         mapView = nil
-        polyline = nil
-        renderer = nil
+        polylines.removeAll()
+        renderers.removeAll()
     }
 }
@@ -20,8 +20,22 @@ NS_ASSUME_NONNULL_BEGIN
                           latitudes:(NSArray<NSNumber *> *)latitudes
                          longitudes:(NSArray<NSNumber *> *)longitudes NS_SWIFT_NAME(isPointInPolygon(pointLat:pointLon:latitudes:longitudes:));
 
+/**
+ * 批量判断多个点是否在同一个围栏内（配送区分配等）
+ * @return 在围栏内的点的下标
+ */
++ (NSIndexSet *)pointsInPolygonWithPointLatitudes:(NSArray<NSNumber *> *)pointLatitudes
+                                  pointLongitudes:(NSArray<NSNumber *> *)pointLongitudes
+                                        latitudes:(NSArray<NSNumber *> *)latitudes
+                                       longitudes:(NSArray<NSNumber *> *)longitudes NS_SWIFT_NAME(pointsInPolygon(pointLatitudes:pointLongitudes:latitudes:longitudes:));
+
+/**
+ * 多边形面积（平方米）
+ * @param earthModel 地球模型：0 = 球面，1 = WGS-84 椭球（calculateDistance / calculatePathLength 相同）
+ */
 + (double)calculatePolygonAreaWithLatitudes:(NSArray<NSNumber *> *)latitudes
-                                  longitudes:(NSArray<NSNumber *> *)longitudes NS_SWIFT_NAME(calculatePolygonArea(latitudes:longitudes:));
+                                  longitudes:(NSArray<NSNumber *> *)longitudes
+                                  earthModel:(NSInteger)earthModel NS_SWIFT_NAME(calculatePolygonArea(latitudes:longitudes:earthModel:));
 
 + (double)calculateRectangleAreaWithSouthWestLat:(double)swLat
                                      southWestLon:(double)swLon
@@ -31,14 +45,16 @@ NS_ASSUME_NONNULL_BEGIN
 + (double)calculateDistanceWithLat1:(double)lat1
                                lon1:(double)lon1
                                lat2:(double)lat2
-                               lon2:(double)lon2 NS_SWIFT_NAME(calculateDistance(lat1:lon1:lat2:lon2:));
+                               lon2:(double)lon2
+                         earthModel:(NSInteger)earthModel NS_SWIFT_NAME(calculateDistance(lat1:lon1:lat2:lon2:earthModel:));
 
 + (NSArray<NSNumber *> *)simplifyPolylineWithLatitudes:(NSArray<NSNumber *> *)latitudes
                                            longitudes:(NSArray<NSNumber *> *)longitudes
                                       toleranceMeters:(double)toleranceMeters NS_SWIFT_NAME(simplifyPolyline(latitudes:longitudes:tolerance:));
 
 + (double)calculatePathLengthWithLatitudes:(NSArray<NSNumber *> *)latitudes
-                                longitudes:(NSArray<NSNumber *> *)longitudes NS_SWIFT_NAME(calculatePathLength(latitudes:longitudes:));
+                                longitudes:(NSArray<NSNumber *> *)longitudes
+                                earthModel:(NSInteger)earthModel NS_SWIFT_NAME(calculatePathLength(latitudes:longitudes:earthModel:));
 
 + (NSDictionary * _Nullable)getPointAtDistanceWithLatitudes:(NSArray<NSNumber *> *)latitudes
                                                longitudes:(NSArray<NSNumber *> *)longitudes
@@ -67,7 +83,11 @@ NS_ASSUME_NONNULL_BEGIN
                                lon:(double)lon
                          precision:(int)precision NS_SWIFT_NAME(encodeGeoHash(lat:lon:precision:));
 
-+ (uint32_t)parseColorWithString:(NSString *)colorString NS_SWIFT_NAME(parseColor(colorString:));
+/**
+ * 解析颜色字符串
+ * @return ARGB 颜色 (0xAARRGGBB)，解析失败返回 -1（与合法的 transparent 即 0 区分）
+ */
++ (int64_t)parseColorWithString:(NSString *)colorString NS_SWIFT_NAME(parseColor(colorString:));
 
 + (CLLocationCoordinate2D)coordinateForMapPointWithX:(double)x y:(double)y NS_SWIFT_NAME(coordinateForMapPoint(x:y:));
 
@@ -79,12 +99,129 @@ NS_ASSUME_NONNULL_BEGIN
  */
 + (NSArray<NSNumber *> *)parsePolyline:(NSString *)polylineStr NS_SWIFT_NAME(parsePolyline(polylineStr:));
 
+/**
+ * 解析高德多环 / 多段 Polyline 字符串
+ * 格式: "lng,lat;lng,lat|lng,lat;..."，`|` 分隔环，`;` 分隔坐标点
+ * @param polylineStr 高德原始 polyline 字符串
+ * @param dedupeAdjacent 是否去除环内相邻重复点
+ * @return @{ @"coordinates": [lat1, lon1, ...], @"ringOffsets": [0, ..., pointCount] }
+ */
++ (NSDictionary *)parsePolylineRings:(NSString *)polylineStr
+                      dedupeAdjacent:(BOOL)dedupeAdjacent NS_SWIFT_NAME(parsePolylineRings(polylineStr:dedupeAdjacent:));
+
+/**
+ * 将路径编码为紧凑字符串（Encoded Polyline 格式：差分 + zigzag + 变长分组）
+ * @param precision 小数精度位数 (1-9)
+ */
++ (NSString *)encodePolylineWithLatitudes:(NSArray<NSNumber *> *)latitudes
+                               longitudes:(NSArray<NSNumber *> *)longitudes
+                                precision:(int)precision NS_SWIFT_NAME(encodePolyline(latitudes:longitudes:precision:));
+
+/**
+ * 解码 encodePolyline 生成的字符串
+ * @return 扁平化的坐标数组 [lat1, lon1, lat2, lon2, ...]
+ */
++ (NSArray<NSNumber *> *)decodePolyline:(NSString *)encoded
+                              precision:(int)precision NS_SWIFT_NAME(decodePolyline(encoded:precision:));
+
+/**
+ * 重采样路径
+ * @param count > 0 时沿路径等距取 count 个点（含首尾），否则按 spacingMeters 均分
+ * @param cornerAngleDegrees > 0 时保留航向变化超过该角度的转角顶点（仅按间距重采样时有效）
+ * @return 扁平化的坐标数组 [lat1, lon1, lat2, lon2, ...]
+ */
++ (NSArray<NSNumber *> *)resamplePolylineWithLatitudes:(NSArray<NSNumber *> *)latitudes
+                                            longitudes:(NSArray<NSNumber *> *)longitudes
+                                         spacingMeters:(double)spacingMeters
+                                                 count:(int)count
+                                    cornerAngleDegrees:(double)cornerAngleDegrees NS_SWIFT_NAME(resamplePolyline(latitudes:longitudes:spacingMeters:count:cornerAngleDegrees:));
+
 // --- 瓦片与坐标转换 ---
 + (NSDictionary *)latLngToTileWithLat:(double)lat lon:(double)lon zoom:(int)zoom NS_SWIFT_NAME(latLngToTile(lat:lon:zoom:));
 + (NSDictionary *)tileToLatLngWithX:(int)x y:(int)y zoom:(int)zoom NS_SWIFT_NAME(tileToLatLng(x:y:zoom:));
 + (NSDictionary *)latLngToPixelWithLat:(double)lat lon:(double)lon zoom:(int)zoom NS_SWIFT_NAME(latLngToPixel(lat:lon:zoom:));
 + (NSDictionary *)pixelToLatLngWithX:(double)x y:(double)y zoom:(int)zoom NS_SWIFT_NAME(pixelToLatLng(x:y:zoom:));
 
+// --- 坐标系转换 ---
+// 坐标系：0 = WGS-84，1 = GCJ-02（高德），2 = BD-09（百度）
+
+/**
+ * 原地批量转换坐标系，供已持有原生缓冲区的调用方（聚合、渲染前处理）直接使用
+ * @return 坐标系非法时返回 NO 且不修改缓冲区
+ */
++ (BOOL)convertCoordinatesInPlaceWithLatitudes:(double *)latitudes
+                                    longitudes:(double *)longitudes
+                                         count:(NSInteger)count
+                                          from:(int)from
+                                            to:(int)to NS_SWIFT_NAME(convertCoordinatesInPlace(latitudes:longitudes:count:from:to:));
+
+/**
+ * 批量转换坐标系
+ * @return 扁平化的坐标数组 [lat1, lon1, lat2, lon2, ...]；输入长度不一致或坐标系非法时返回空数组
+ */
++ (NSArray<NSNumber *> *)convertCoordinatesWithLatitudes:(NSArray<NSNumber *> *)latitudes
+                                              longitudes:(NSArray<NSNumber *> *)longitudes
+                                                    from:(int)from
+                                                      to:(int)to NS_SWIFT_NAME(convertCoordinates(latitudes:longitudes:from:to:));
+
+// --- 视口裁剪 ---
+
+/**
+ * 把折线 / 多边形的环裁剪到视口（四周外扩 margin 像素）并按像素容差抽稀，相机变化后只把可见部分交给 SDK
+ * @param closed YES 时按多边形的环裁剪（结果最多一个环），NO 时按折线裁剪（可能断成多段）
+ * @return 格式同 parsePolylineRings：@{ @"coordinates": [lat, lon, ...], @"ringOffsets": [...] }
+ */
++ (NSDictionary *)clipToViewportWithLatitudes:(NSArray<NSNumber *> *)latitudes
+                                   longitudes:(NSArray<NSNumber *> *)longitudes
+                                       closed:(BOOL)closed
+                                    centerLat:(double)centerLat
+                                    centerLon:(double)centerLon
+                                         zoom:(double)zoom
+                                        width:(double)width
+                                       height:(double)height
+                                       margin:(double)margin
+                                    tolerance:(double)tolerancePx NS_SWIFT_NAME(clipToViewport(latitudes:longitudes:closed:centerLat:centerLon:zoom:width:height:margin:tolerance:));
+
+// --- 聚合簇外轮廓 ---
+
+/**
+ * 批量计算聚合簇覆盖的区域（点击聚合点时展示）
+ * @param clusters clusterPoints 的返回值，下标指向 latitudes / longitudes
+ * @param maxEdgeMeters > 0 时为凹包（边界边不长于该值），否则为凸包
+ * @return 每个簇一个环，格式同 parsePolylineRings：@{ @"coordinates": [lat, lon, ...], @"ringOffsets": [...] }
+ */
++ (NSDictionary *)clusterHullsWithLatitudes:(NSArray<NSNumber *> *)latitudes
+                                 longitudes:(NSArray<NSNumber *> *)longitudes
+                                   clusters:(NSArray<NSNumber *> *)clusters
+                              maxEdgeMeters:(double)maxEdgeMeters NS_SWIFT_NAME(clusterHulls(latitudes:longitudes:clusters:maxEdgeMeters:));
+
+// --- 轨迹分析 ---
+
+/**
+ * 轨迹分析：一次遍历计算速度 / 航向、剔除跳点、识别停留并统计里程与时长
+ * @param timestamps 时间戳（秒），与坐标一一对应
+ * @param options 可选键: stopSpeedMps, stopRadiusMeters, minStopSeconds, maxSpeedMps, maxGapSeconds, includeSegments
+ * @return 统计值（pointCount, acceptedCount, outlierCount, totalDistanceMeters, totalSeconds, movingSeconds, stoppedSeconds,
+ *         maxSpeedMps, averageSpeedMps, movingAverageSpeedMps）、stops 数组，includeSegments 时另含 speeds / headings / flags
+ */
++ (NSDictionary *)analyzeTrajectoryWithTimestamps:(NSArray<NSNumber *> *)timestamps
+                                        latitudes:(NSArray<NSNumber *> *)latitudes
+                                       longitudes:(NSArray<NSNumber *> *)longitudes
+                                          options:(nullable NSDictionary *)options NS_SWIFT_NAME(analyzeTrajectory(timestamps:latitudes:longitudes:options:));
+
+// --- 路线相似度 ---
+
+/**
+ * 比较候选路线与参考路线（如 Web 规划线）的相似程度
+ * @return @{ @"averageDeviationMeters", @"maxDeviationMeters", @"exceededCount"（距离超过阈值的顶点数）,
+ *            @"hausdorffMeters", @"frechetMeters" }
+ */
++ (NSDictionary *)comparePathsWithReferenceLatitudes:(NSArray<NSNumber *> *)referenceLatitudes
+                                 referenceLongitudes:(NSArray<NSNumber *> *)referenceLongitudes
+                                           latitudes:(NSArray<NSNumber *> *)latitudes
+                                          longitudes:(NSArray<NSNumber *> *)longitudes
+                                     thresholdMeters:(double)thresholdMeters NS_SWIFT_NAME(comparePaths(referenceLatitudes:referenceLongitudes:latitudes:longitudes:thresholdMeters:));
+
 // --- 批量地理围栏与网格聚合 ---
 + (int)findPointInPolygonsWithPointLat:(double)pointLat
                               pointLon:(double)pointLon
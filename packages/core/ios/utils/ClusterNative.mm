@@ -7,12 +7,26 @@
 #define HAS_MAMAPKIT 0
 #endif
 
+#include <algorithm>
 #include <vector>
 #include <string>
+#include <string_view>
 
 #include "../../shared/cpp/ClusterEngine.hpp"
 #include "../../shared/cpp/GeometryEngine.hpp"
 #include "../../shared/cpp/ColorParser.hpp"
+#include "../../shared/cpp/TrajectoryAnalyzer.hpp"
+#include "../../shared/cpp/PathSimilarity.hpp"
+
+// 与 gaodemap::CoordSystem 的取值一致
+static inline BOOL isValidCoordSystem(int system) {
+    return system >= 0 && system <= 2;
+}
+
+// 0 = 球面，1 = WGS-84 椭球，其他值按球面处理
+static inline gaodemap::EarthModel toEarthModel(NSInteger model) {
+    return model == 1 ? gaodemap::EarthModel::WGS84 : gaodemap::EarthModel::Sphere;
+}
 
 @implementation ClusterNative
 
@@ -76,8 +90,41 @@
     return gaodemap::isPointInPolygon(pointLat, pointLon, polygon);
 }
 
++ (NSIndexSet *)pointsInPolygonWithPointLatitudes:(NSArray<NSNumber *> *)pointLatitudes
+                                  pointLongitudes:(NSArray<NSNumber *> *)pointLongitudes
+                                        latitudes:(NSArray<NSNumber *> *)latitudes
+                                       longitudes:(NSArray<NSNumber *> *)longitudes {
+    if (pointLatitudes.count != pointLongitudes.count || latitudes.count < 3 || latitudes.count != longitudes.count) {
+        return [NSIndexSet indexSet];
+    }
+
+    std::vector<gaodemap::GeoPoint> polygon;
+    polygon.reserve(latitudes.count);
+    for (NSUInteger i = 0; i < latitudes.count; i++) {
+        polygon.push_back({latitudes[i].doubleValue, longitudes[i].doubleValue});
+    }
+
+    std::vector<gaodemap::GeoPoint> points;
+    points.reserve(pointLatitudes.count);
+    for (NSUInteger i = 0; i < pointLatitudes.count; i++) {
+        points.push_back({pointLatitudes[i].doubleValue, pointLongitudes[i].doubleValue});
+    }
+
+    std::vector<uint64_t> bits((points.size() + 63) / 64);
+    gaodemap::pointsInPolygon(gaodemap::CoordSpan(polygon), gaodemap::CoordSpan(points), bits.data());
+
+    NSMutableIndexSet *result = [NSMutableIndexSet indexSet];
+    for (size_t word = 0; word < bits.size(); word++) {
+        for (uint64_t w = bits[word]; w != 0; w &= w - 1) {
+            [result addIndex:word * 64 + __builtin_ctzll(w)];
+        }
+    }
+    return result;
+}
+
 + (double)calculatePolygonAreaWithLatitudes:(NSArray<NSNumber *> *)latitudes
-                                  longitudes:(NSArray<NSNumber *> *)longitudes {
+                                  longitudes:(NSArray<NSNumber *> *)longitudes
+                                  earthModel:(NSInteger)earthModel {
     if (latitudes.count < 3 || latitudes.count != longitudes.count) {
         return 0.0;
     }
@@ -89,7 +136,7 @@
         polygon.push_back({latitudes[i].doubleValue, longitudes[i].doubleValue});
     }
 
-    return gaodemap::calculatePolygonArea(polygon);
+    return gaodemap::calculatePolygonArea(gaodemap::CoordSpan(polygon), toEarthModel(earthModel));
 }
 
 + (double)calculateRectangleAreaWithSouthWestLat:(double)swLat
@@ -102,8 +149,9 @@
 + (double)calculateDistanceWithLat1:(double)lat1
                                lon1:(double)lon1
                                lat2:(double)lat2
-                               lon2:(double)lon2 {
-    return gaodemap::calculateDistance(lat1, lon1, lat2, lon2);
+                               lon2:(double)lon2
+                         earthModel:(NSInteger)earthModel {
+    return gaodemap::calculateDistance(lat1, lon1, lat2, lon2, toEarthModel(earthModel));
 }
 
 + (NSArray<NSNumber *> *)simplifyPolylineWithLatitudes:(NSArray<NSNumber *> *)latitudes
@@ -132,7 +180,8 @@
 }
 
 + (double)calculatePathLengthWithLatitudes:(NSArray<NSNumber *> *)latitudes
-                                longitudes:(NSArray<NSNumber *> *)longitudes {
+                                longitudes:(NSArray<NSNumber *> *)longitudes
+                                earthModel:(NSInteger)earthModel {
     if (latitudes.count != longitudes.count || latitudes.count < 2) {
         return 0.0;
     }
@@ -143,7 +192,7 @@
         points.push_back({[latitudes[i] doubleValue], [longitudes[i] doubleValue]});
     }
     
-    return gaodemap::calculatePathLength(points);
+    return gaodemap::calculatePathLength(gaodemap::CoordSpan(points), toEarthModel(earthModel));
 }
 
 + (NSDictionary * _Nullable)getPointAtDistanceWithLatitudes:(NSArray<NSNumber *> *)latitudes
@@ -276,10 +325,13 @@
     return [NSString stringWithUTF8String:geoHash.c_str()];
 }
 
-+ (uint32_t)parseColorWithString:(NSString *)colorString {
-    if (!colorString) return 0;
-    std::string colorStr = [colorString UTF8String];
-    return gaodemap::parseColor(colorStr);
++ (int64_t)parseColorWithString:(NSString *)colorString {
+    if (!colorString) return -1;
+    // UTF8String 指向的缓冲区在当前自动释放池内有效，直接解析，不复制到 std::string
+    const char *utf8 = [colorString UTF8String];
+    if (!utf8) return -1;
+    uint32_t color = 0;
+    return gaodemap::tryParseColor(std::string_view(utf8), color) ? static_cast<int64_t>(color) : -1;
 }
 
 + (CLLocationCoordinate2D)coordinateForMapPointWithX:(double)x y:(double)y {
@@ -310,6 +362,99 @@
     return result;
 }
 
++ (NSDictionary *)parsePolylineRings:(NSString *)polylineStr
+                      dedupeAdjacent:(BOOL)dedupeAdjacent {
+    if (!polylineStr || polylineStr.length == 0) {
+        return @{ @"coordinates": @[], @"ringOffsets": @[@0] };
+    }
+
+    std::string cppPolylineStr([polylineStr UTF8String]);
+    const auto rings = gaodemap::parsePolylineRings(cppPolylineStr, dedupeAdjacent);
+
+    NSMutableArray<NSNumber *> *coordinates = [NSMutableArray arrayWithCapacity:rings.points.size() * 2];
+    for (const auto &p : rings.points) {
+        [coordinates addObject:@(p.lat)];
+        [coordinates addObject:@(p.lon)];
+    }
+
+    NSMutableArray<NSNumber *> *ringOffsets = [NSMutableArray arrayWithCapacity:rings.ringOffsets.size()];
+    for (int offset : rings.ringOffsets) {
+        [ringOffsets addObject:@(offset)];
+    }
+
+    return @{
+        @"coordinates": coordinates,
+        @"ringOffsets": ringOffsets
+    };
+}
+
++ (NSString *)encodePolylineWithLatitudes:(NSArray<NSNumber *> *)latitudes
+                               longitudes:(NSArray<NSNumber *> *)longitudes
+                                precision:(int)precision {
+    if (latitudes.count == 0 || latitudes.count != longitudes.count) {
+        return @"";
+    }
+
+    std::vector<gaodemap::GeoPoint> points;
+    points.reserve(latitudes.count);
+    for (NSUInteger i = 0; i < latitudes.count; i++) {
+        points.push_back({[latitudes[i] doubleValue], [longitudes[i] doubleValue]});
+    }
+
+    std::string encoded = gaodemap::encodePolyline(points, precision);
+    return [NSString stringWithUTF8String:encoded.c_str()];
+}
+
++ (NSArray<NSNumber *> *)decodePolyline:(NSString *)encoded
+                              precision:(int)precision {
+    if (!encoded || encoded.length == 0) {
+        return @[];
+    }
+
+    std::string cppEncoded([encoded UTF8String]);
+    const auto points = gaodemap::decodePolyline(cppEncoded, precision);
+
+    NSMutableArray<NSNumber *> *result = [NSMutableArray arrayWithCapacity:points.size() * 2];
+    for (const auto &p : points) {
+        [result addObject:@(p.lat)];
+        [result addObject:@(p.lon)];
+    }
+
+    return result;
+}
+
++ (NSArray<NSNumber *> *)resamplePolylineWithLatitudes:(NSArray<NSNumber *> *)latitudes
+                                            longitudes:(NSArray<NSNumber *> *)longitudes
+                                         spacingMeters:(double)spacingMeters
+                                                 count:(int)count
+                                    cornerAngleDegrees:(double)cornerAngleDegrees {
+    if (latitudes.count == 0 || latitudes.count != longitudes.count) {
+        return @[];
+    }
+
+    std::vector<gaodemap::GeoPoint> input;
+    input.reserve(latitudes.count);
+    for (NSUInteger i = 0; i < latitudes.count; i++) {
+        input.push_back({latitudes[i].doubleValue, longitudes[i].doubleValue});
+    }
+
+    std::vector<gaodemap::GeoPoint> points;
+    if (count > 0) {
+        points = gaodemap::resamplePolylineByCount(input, static_cast<size_t>(count));
+    } else if (cornerAngleDegrees > 0.0) {
+        points = gaodemap::resamplePolylinePreservingCorners(input, spacingMeters, cornerAngleDegrees);
+    } else {
+        points = gaodemap::resamplePolyline(input, spacingMeters);
+    }
+
+    NSMutableArray<NSNumber *> *result = [NSMutableArray arrayWithCapacity:points.size() * 2];
+    for (const auto &p : points) {
+        [result addObject:@(p.lat)];
+        [result addObject:@(p.lon)];
+    }
+    return result;
+}
+
 // --- 瓦片与坐标转换 ---
 
 + (NSDictionary *)latLngToTileWithLat:(double)lat lon:(double)lon zoom:(int)zoom {
@@ -345,6 +490,269 @@
     };
 }
 
+// --- 坐标系转换 ---
+
++ (BOOL)convertCoordinatesInPlaceWithLatitudes:(double *)latitudes
+                                    longitudes:(double *)longitudes
+                                         count:(NSInteger)count
+                                          from:(int)from
+                                            to:(int)to {
+    if (!isValidCoordSystem(from) || !isValidCoordSystem(to) || count < 0) return NO;
+    if (count == 0) return YES;
+    if (latitudes == NULL || longitudes == NULL) return NO;
+    gaodemap::convertCoordinates(latitudes, longitudes, (size_t)count,
+                                 static_cast<gaodemap::CoordSystem>(from),
+                                 static_cast<gaodemap::CoordSystem>(to));
+    return YES;
+}
+
++ (NSArray<NSNumber *> *)convertCoordinatesWithLatitudes:(NSArray<NSNumber *> *)latitudes
+                                              longitudes:(NSArray<NSNumber *> *)longitudes
+                                                    from:(int)from
+                                                      to:(int)to {
+    if (latitudes.count != longitudes.count || !isValidCoordSystem(from) || !isValidCoordSystem(to)) {
+        return @[];
+    }
+
+    std::vector<gaodemap::GeoPoint> points;
+    points.reserve(latitudes.count);
+    for (NSUInteger i = 0; i < latitudes.count; i++) {
+        points.push_back({latitudes[i].doubleValue, longitudes[i].doubleValue});
+    }
+
+    gaodemap::convertCoordinates(points,
+                                 static_cast<gaodemap::CoordSystem>(from),
+                                 static_cast<gaodemap::CoordSystem>(to));
+
+    NSMutableArray<NSNumber *> *result = [NSMutableArray arrayWithCapacity:points.size() * 2];
+    for (const auto &point : points) {
+        [result addObject:@(point.lat)];
+        [result addObject:@(point.lon)];
+    }
+    return result;
+}
+
+// --- 视口裁剪 ---
+
++ (NSDictionary *)clipToViewportWithLatitudes:(NSArray<NSNumber *> *)latitudes
+                                   longitudes:(NSArray<NSNumber *> *)longitudes
+                                       closed:(BOOL)closed
+                                    centerLat:(double)centerLat
+                                    centerLon:(double)centerLon
+                                         zoom:(double)zoom
+                                        width:(double)width
+                                       height:(double)height
+                                       margin:(double)margin
+                                    tolerance:(double)tolerancePx {
+    if (latitudes.count != longitudes.count || latitudes.count == 0) {
+        return @{ @"coordinates": @[], @"ringOffsets": @[@0] };
+    }
+
+    std::vector<gaodemap::GeoPoint> points;
+    points.reserve(latitudes.count);
+    for (NSUInteger i = 0; i < latitudes.count; i++) {
+        points.push_back({latitudes[i].doubleValue, longitudes[i].doubleValue});
+    }
+
+    const gaodemap::ScreenViewport viewport = gaodemap::makeScreenViewport(centerLat, centerLon, zoom, width, height, margin);
+    gaodemap::PolylineRings rings;
+    if (closed) {
+        rings.points = gaodemap::clipPolygonToViewport(gaodemap::CoordSpan(points), viewport, tolerancePx);
+        rings.ringOffsets.push_back(0);
+        if (!rings.points.empty()) rings.ringOffsets.push_back(static_cast<int>(rings.points.size()));
+    } else {
+        rings = gaodemap::clipPolylineToViewport(gaodemap::CoordSpan(points), viewport, tolerancePx);
+    }
+
+    NSMutableArray<NSNumber *> *coordinates = [NSMutableArray arrayWithCapacity:rings.points.size() * 2];
+    for (const auto &p : rings.points) {
+        [coordinates addObject:@(p.lat)];
+        [coordinates addObject:@(p.lon)];
+    }
+
+    NSMutableArray<NSNumber *> *ringOffsets = [NSMutableArray arrayWithCapacity:rings.ringOffsets.size()];
+    for (int offset : rings.ringOffsets) {
+        [ringOffsets addObject:@(offset)];
+    }
+
+    return @{
+        @"coordinates": coordinates,
+        @"ringOffsets": ringOffsets
+    };
+}
+
+// --- 聚合簇外轮廓 ---
+
++ (NSDictionary *)clusterHullsWithLatitudes:(NSArray<NSNumber *> *)latitudes
+                                 longitudes:(NSArray<NSNumber *> *)longitudes
+                                   clusters:(NSArray<NSNumber *> *)clusters
+                              maxEdgeMeters:(double)maxEdgeMeters {
+    NSDictionary *empty = @{ @"coordinates": @[], @"ringOffsets": @[@0] };
+    if (latitudes.count != longitudes.count || clusters.count == 0) {
+        return empty;
+    }
+
+    // clusters 为 clusterPoints 的编码结果: [count, centerIndex, size, idx..., ...]
+    const NSUInteger encodedCount = clusters.count;
+    const int clusterCount = clusters[0].intValue;
+    std::vector<gaodemap::ClusterOutput> outputs;
+    outputs.reserve(clusterCount > 0 ? clusterCount : 0);
+    NSUInteger cursor = 1;
+    for (int c = 0; c < clusterCount && cursor + 2 <= encodedCount; c++) {
+        gaodemap::ClusterOutput cluster;
+        cluster.centerIndex = clusters[cursor].intValue;
+        const int size = clusters[cursor + 1].intValue;
+        cursor += 2;
+        if (size < 0 || (NSUInteger)size > encodedCount - cursor) {
+            return empty;
+        }
+        cluster.indices.reserve(size);
+        for (int k = 0; k < size; k++) {
+            cluster.indices.push_back(clusters[cursor + k].intValue);
+        }
+        cursor += size;
+        outputs.push_back(std::move(cluster));
+    }
+
+    std::vector<gaodemap::GeoPoint> points;
+    points.reserve(latitudes.count);
+    for (NSUInteger i = 0; i < latitudes.count; i++) {
+        points.push_back({latitudes[i].doubleValue, longitudes[i].doubleValue});
+    }
+
+    const gaodemap::PolylineRings rings = gaodemap::computeClusterHulls(gaodemap::CoordSpan(points), outputs, maxEdgeMeters);
+
+    NSMutableArray<NSNumber *> *coordinates = [NSMutableArray arrayWithCapacity:rings.points.size() * 2];
+    for (const auto &p : rings.points) {
+        [coordinates addObject:@(p.lat)];
+        [coordinates addObject:@(p.lon)];
+    }
+
+    NSMutableArray<NSNumber *> *ringOffsets = [NSMutableArray arrayWithCapacity:rings.ringOffsets.size()];
+    for (int offset : rings.ringOffsets) {
+        [ringOffsets addObject:@(offset)];
+    }
+
+    return @{
+        @"coordinates": coordinates,
+        @"ringOffsets": ringOffsets
+    };
+}
+
+// --- 轨迹分析 ---
+
++ (NSDictionary *)analyzeTrajectoryWithTimestamps:(NSArray<NSNumber *> *)timestamps
+                                        latitudes:(NSArray<NSNumber *> *)latitudes
+                                       longitudes:(NSArray<NSNumber *> *)longitudes
+                                          options:(NSDictionary *)options {
+    if (latitudes.count != longitudes.count || latitudes.count != timestamps.count) {
+        return @{};
+    }
+
+    gaodemap::TrajectoryOptions trajectoryOptions;
+    if (options[@"stopSpeedMps"]) trajectoryOptions.stopSpeedMps = [options[@"stopSpeedMps"] doubleValue];
+    if (options[@"stopRadiusMeters"]) trajectoryOptions.stopRadiusMeters = [options[@"stopRadiusMeters"] doubleValue];
+    if (options[@"minStopSeconds"]) trajectoryOptions.minStopSeconds = [options[@"minStopSeconds"] doubleValue];
+    if (options[@"maxSpeedMps"]) trajectoryOptions.maxSpeedMps = [options[@"maxSpeedMps"] doubleValue];
+    if (options[@"maxGapSeconds"]) trajectoryOptions.maxGapSeconds = [options[@"maxGapSeconds"] doubleValue];
+    const BOOL includeSegments = [options[@"includeSegments"] boolValue];
+
+    const NSUInteger count = latitudes.count;
+    std::vector<double> times(count);
+    std::vector<gaodemap::GeoPoint> points;
+    points.reserve(count);
+    for (NSUInteger i = 0; i < count; i++) {
+        times[i] = timestamps[i].doubleValue;
+        points.push_back({latitudes[i].doubleValue, longitudes[i].doubleValue});
+    }
+
+    std::vector<gaodemap::TrajectorySegment> segments(includeSegments ? count : 0);
+    gaodemap::TrajectoryAnalyzer analyzer(trajectoryOptions);
+    analyzer.add(times.data(), gaodemap::CoordSpan(points), includeSegments ? segments.data() : nullptr);
+    analyzer.finish();
+
+    const gaodemap::TrajectorySummary summary = analyzer.summary();
+    const std::vector<gaodemap::TrajectoryStop> stops = analyzer.takeStops();
+
+    NSMutableArray<NSDictionary *> *stopList = [NSMutableArray arrayWithCapacity:stops.size()];
+    for (const auto &stop : stops) {
+        [stopList addObject:@{
+            @"latitude": @(stop.lat),
+            @"longitude": @(stop.lon),
+            @"startTime": @(stop.startTime),
+            @"endTime": @(stop.endTime),
+            @"firstIndex": @(stop.firstIndex),
+            @"lastIndex": @(stop.lastIndex),
+            @"pointCount": @(stop.pointCount)
+        }];
+    }
+
+    NSMutableDictionary *result = [@{
+        @"pointCount": @(summary.pointCount),
+        @"acceptedCount": @(summary.acceptedCount),
+        @"outlierCount": @(summary.outlierCount),
+        @"totalDistanceMeters": @(summary.totalDistanceMeters),
+        @"totalSeconds": @(summary.totalSeconds),
+        @"movingSeconds": @(summary.movingSeconds),
+        @"stoppedSeconds": @(summary.stoppedSeconds),
+        @"maxSpeedMps": @(summary.maxSpeedMps),
+        @"averageSpeedMps": @(summary.averageSpeedMps),
+        @"movingAverageSpeedMps": @(summary.movingAverageSpeedMps),
+        @"stops": stopList
+    } mutableCopy];
+
+    if (includeSegments) {
+        NSMutableArray<NSNumber *> *speeds = [NSMutableArray arrayWithCapacity:count];
+        NSMutableArray<NSNumber *> *headings = [NSMutableArray arrayWithCapacity:count];
+        NSMutableArray<NSNumber *> *flags = [NSMutableArray arrayWithCapacity:count];
+        for (const auto &segment : segments) {
+            [speeds addObject:@(segment.speedMps)];
+            [headings addObject:@(segment.headingDegrees)];
+            [flags addObject:@(segment.flags)];
+        }
+        result[@"speeds"] = speeds;
+        result[@"headings"] = headings;
+        result[@"flags"] = flags;
+    }
+    return result;
+}
+
+// --- 路线相似度 ---
+
++ (NSDictionary *)comparePathsWithReferenceLatitudes:(NSArray<NSNumber *> *)referenceLatitudes
+                                 referenceLongitudes:(NSArray<NSNumber *> *)referenceLongitudes
+                                           latitudes:(NSArray<NSNumber *> *)latitudes
+                                          longitudes:(NSArray<NSNumber *> *)longitudes
+                                     thresholdMeters:(double)thresholdMeters {
+    if (referenceLatitudes.count == 0 || referenceLatitudes.count != referenceLongitudes.count ||
+        latitudes.count == 0 || latitudes.count != longitudes.count) {
+        return @{};
+    }
+
+    std::vector<gaodemap::GeoPoint> reference;
+    reference.reserve(referenceLatitudes.count);
+    for (NSUInteger i = 0; i < referenceLatitudes.count; i++) {
+        reference.push_back({referenceLatitudes[i].doubleValue, referenceLongitudes[i].doubleValue});
+    }
+    std::vector<gaodemap::GeoPoint> path;
+    path.reserve(latitudes.count);
+    for (NSUInteger i = 0; i < latitudes.count; i++) {
+        path.push_back({latitudes[i].doubleValue, longitudes[i].doubleValue});
+    }
+
+    const gaodemap::PathSegmentIndex referenceIndex{gaodemap::CoordSpan(reference)};
+    const gaodemap::PathDeviation deviation = gaodemap::measurePathDeviation(referenceIndex, gaodemap::CoordSpan(path), thresholdMeters);
+    const double reverse = gaodemap::directedHausdorffDistance(gaodemap::PathSegmentIndex(gaodemap::CoordSpan(path)), gaodemap::CoordSpan(reference));
+
+    return @{
+        @"averageDeviationMeters": @(deviation.averageMeters),
+        @"maxDeviationMeters": @(deviation.maxMeters),
+        @"exceededCount": @(deviation.exceededCount),
+        @"hausdorffMeters": @(std::max(deviation.maxMeters, reverse)),
+        @"frechetMeters": @(gaodemap::discreteFrechetDistance(gaodemap::CoordSpan(reference), gaodemap::CoordSpan(path)))
+    };
+}
+
 // --- 批量地理围栏与热力图 ---
 
 + (int)findPointInPolygonsWithPointLat:(double)pointLat
@@ -388,7 +796,8 @@
         });
     }
 
-    auto cells = gaodemap::generateHeatmapGrid(points, gridSizeMeters);
+    // 大数据量时按 CPU 核数并行分桶，点数较少时引擎内部自动退回单线程
+    auto cells = gaodemap::generateHeatmapGrid(points, gridSizeMeters, 0);
     
     NSMutableArray *result = [NSMutableArray arrayWithCapacity:cells.size()];
     for (const auto &c : cells) {
@@ -11,3 +11,13 @@
 #include "../../shared/cpp/GeometryEngine.cpp"
 #include "../../shared/cpp/ColorParser.cpp"
 #include "../../shared/cpp/QuadTree.cpp"
+#include "../../shared/cpp/HeatmapRasterizer.cpp"
+#include "../../shared/cpp/HeatmapAccumulator.cpp"
+#include "../../shared/cpp/CellId.cpp"
+#include "../../shared/cpp/CollisionEngine.cpp"
+#include "../../shared/cpp/Geodesic.cpp"
+#include "../../shared/cpp/PolygonClipper.cpp"
+#include "../../shared/cpp/Triangulator.cpp"
+#include "../../shared/cpp/TrajectoryAnalyzer.cpp"
+#include "../../shared/cpp/GpsSmoother.cpp"
+#include "../../shared/cpp/PathSimilarity.cpp"
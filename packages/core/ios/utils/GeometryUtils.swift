@@ -1,4 +1,5 @@
 import CoreLocation
+import MAMapKit
 
 /**
  * 几何计算工具类 (iOS)
@@ -6,6 +7,58 @@ import CoreLocation
  * 桥接 ClusterNative (C++) 实现的几何计算功能
  */
 public enum GeometryUtils {
+
+    /// 折线 / 多边形点数达到该值时，相机停止后只把视口内的部分交给 SDK
+    public static let viewportClipMinPoints = 500
+
+    /**
+     * 按地图当前相机把折线 / 多边形的环裁剪到地图视图，四周各外扩半个视图，平移时边缘不会立刻露出缺口
+     * 地图旋转时按视图的外接正方形裁剪；有俯仰角时可见区域不是矩形，不裁剪
+     * @param closed true 时按多边形的环裁剪（结果最多一个环），false 时按折线裁剪（可能断成多段）
+     * @return 可见的各段，完全不可见时为空；不裁剪时返回 nil，调用方应使用原始点
+     */
+    public static func clipToMapView(_ points: [CLLocationCoordinate2D], closed: Bool, mapView: MAMapView) -> [[CLLocationCoordinate2D]]? {
+        let size = mapView.bounds.size
+        guard !points.isEmpty, mapView.cameraDegree == 0, size.width > 0, size.height > 0 else {
+            return nil
+        }
+        let rotated = mapView.rotationDegree.truncatingRemainder(dividingBy: 360) != 0
+        let width = rotated ? Double(hypot(size.width, size.height)) : Double(size.width)
+        let height = rotated ? width : Double(size.height)
+        let center = mapView.centerCoordinate
+
+        let result = ClusterNative.clipToViewport(
+            latitudes: points.map { NSNumber(value: $0.latitude) },
+            longitudes: points.map { NSNumber(value: $0.longitude) },
+            closed: closed,
+            centerLat: center.latitude,
+            centerLon: center.longitude,
+            zoom: Double(mapView.zoomLevel),
+            width: width,
+            height: height,
+            margin: max(width, height) * 0.5,
+            tolerance: 0.5
+        )
+        guard let coordinates = result["coordinates"] as? [NSNumber],
+              let offsets = result["ringOffsets"] as? [NSNumber] else {
+            return nil
+        }
+
+        var rings: [[CLLocationCoordinate2D]] = []
+        if offsets.count > 1 {
+            for r in 0..<(offsets.count - 1) {
+                let begin = offsets[r].intValue
+                let end = offsets[r + 1].intValue
+                var ring: [CLLocationCoordinate2D] = []
+                ring.reserveCapacity(max(end - begin, 0))
+                for i in begin..<end where i * 2 + 1 < coordinates.count {
+                    ring.append(CLLocationCoordinate2D(latitude: coordinates[i * 2].doubleValue, longitude: coordinates[i * 2 + 1].doubleValue))
+                }
+                rings.append(ring)
+            }
+        }
+        return rings
+    }
     
     /**
      * 轨迹抽稀 (RDP 算法)
@@ -29,6 +82,48 @@ public enum GeometryUtils {
                 simplified.append(CLLocationCoordinate2D(latitude: result[i].doubleValue, longitude: result[i+1].doubleValue))
             }
         }
+
         return simplified
     }
+    
+    /**
+     * 按间距重采样路径，cornerAngleDegrees > 0 时保留转角
+     */
+    public static func resamplePolyline(_ points: [CLLocationCoordinate2D], spacingMeters: Double, cornerAngleDegrees: Double = 0) -> [CLLocationCoordinate2D] {
+        return resample(points, spacingMeters: spacingMeters, count: 0, cornerAngleDegrees: cornerAngleDegrees)
+    }
+    
+    /**
+     * 沿路径等距取 count 个点（含首尾）
+     */
+    public static func resamplePolyline(_ points: [CLLocationCoordinate2D], count: Int) -> [CLLocationCoordinate2D] {
+        if count <= 0 {
+            return []
+        }
+        return resample(points, spacingMeters: 0, count: count, cornerAngleDegrees: 0)
+    }
+    
+    private static func resample(_ points: [CLLocationCoordinate2D], spacingMeters: Double, count: Int, cornerAngleDegrees: Double) -> [CLLocationCoordinate2D] {
+        if points.isEmpty {
+            return []
+        }
+        
+        let lats = points.map { NSNumber(value: $0.latitude) }
+        let lons = points.map { NSNumber(value: $0.longitude) }
+        
+        let result = ClusterNative.resamplePolyline(
+            latitudes: lats,
+            longitudes: lons,
+            spacingMeters: spacingMeters,
+            count: Int32(clamping: count),
+            cornerAngleDegrees: cornerAngleDegrees
+        )
+        
+        var resampled: [CLLocationCoordinate2D] = []
+        resampled.reserveCapacity(result.count / 2)
+        for i in stride(from: 0, to: result.count - 1, by: 2) {
+            resampled.append(CLLocationCoordinate2D(latitude: result[i].doubleValue, longitude: result[i + 1].doubleValue))
+        }
+        return resampled
+    }
 }
@@ -0,0 +1,46 @@
+#import <Foundation/Foundation.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+ * C++ GPS 平滑器对象池 (GpsSmootherPool) 的封装
+ *
+ * 每个槽位对应一辆车的卡尔曼滤波器，每帧把所有车辆的新定位点放在一次 update 中批量处理
+ */
+@interface GpsSmootherNative : NSObject
+
+/**
+ * @param options 可选键: accelerationNoise, minGateMeters, gateScale, maxRejected, resetAfterSeconds
+ */
+- (instancetype)initWithCapacity:(NSInteger)capacity options:(nullable NSDictionary *)options NS_DESIGNATED_INITIALIZER;
+- (instancetype)init NS_UNAVAILABLE;
+
+/**
+ * @return 槽位号，池已满时返回 -1
+ */
+- (NSInteger)acquire;
+
+- (void)releaseSlot:(NSInteger)slot NS_SWIFT_NAME(release(slot:));
+
+/**
+ * 批量输入定位点
+ * @param timestamps 时间戳（秒）
+ * @param accuracies 定位精度（米），为 nil 时使用默认值
+ * @return 每个定位点一项：@{ @"latitude", @"longitude", @"speed", @"heading", @"flags" }；
+ *         flags 按位组合：1 被剔除（输出为预测位置），2 重新初始化，4 槽位无效
+ */
+- (NSArray<NSDictionary *> *)updateWithSlots:(NSArray<NSNumber *> *)slots
+                                  timestamps:(NSArray<NSNumber *> *)timestamps
+                                   latitudes:(NSArray<NSNumber *> *)latitudes
+                                  longitudes:(NSArray<NSNumber *> *)longitudes
+                                  accuracies:(nullable NSArray<NSNumber *> *)accuracies NS_SWIFT_NAME(update(slots:timestamps:latitudes:longitudes:accuracies:));
+
+/**
+ * 按当前速度外推到指定时间的位置，用于两次定位之间的标记动画
+ * @return @{ @"latitude", @"longitude" }，槽位无效或尚未初始化时返回 nil
+ */
+- (nullable NSDictionary *)predictSlot:(NSInteger)slot time:(double)time NS_SWIFT_NAME(predict(slot:time:));
+
+@end
+
+NS_ASSUME_NONNULL_END
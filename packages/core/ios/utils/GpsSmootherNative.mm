@@ -0,0 +1,82 @@
+#import "GpsSmootherNative.h"
+
+#include <memory>
+#include <vector>
+
+#include "../../shared/cpp/GpsSmoother.hpp"
+
+@implementation GpsSmootherNative {
+    std::unique_ptr<gaodemap::GpsSmootherPool> _pool;
+}
+
+- (instancetype)initWithCapacity:(NSInteger)capacity options:(NSDictionary *)options {
+    if (self = [super init]) {
+        gaodemap::GpsSmootherOptions smootherOptions;
+        if (options[@"accelerationNoise"]) smootherOptions.accelerationNoise = [options[@"accelerationNoise"] doubleValue];
+        if (options[@"minGateMeters"]) smootherOptions.minGateMeters = [options[@"minGateMeters"] doubleValue];
+        if (options[@"gateScale"]) smootherOptions.gateScale = [options[@"gateScale"] doubleValue];
+        if (options[@"maxRejected"]) smootherOptions.maxRejected = [options[@"maxRejected"] intValue];
+        if (options[@"resetAfterSeconds"]) smootherOptions.resetAfterSeconds = [options[@"resetAfterSeconds"] doubleValue];
+        _pool = std::make_unique<gaodemap::GpsSmootherPool>(static_cast<size_t>(MAX(capacity, 1)), smootherOptions);
+    }
+    return self;
+}
+
+- (NSInteger)acquire {
+    return _pool->acquire();
+}
+
+- (void)releaseSlot:(NSInteger)slot {
+    _pool->release(static_cast<int>(slot));
+}
+
+- (NSArray<NSDictionary *> *)updateWithSlots:(NSArray<NSNumber *> *)slots
+                                  timestamps:(NSArray<NSNumber *> *)timestamps
+                                   latitudes:(NSArray<NSNumber *> *)latitudes
+                                  longitudes:(NSArray<NSNumber *> *)longitudes
+                                  accuracies:(NSArray<NSNumber *> *)accuracies {
+    const NSUInteger count = latitudes.count;
+    if (longitudes.count != count || timestamps.count != count || slots.count != count ||
+        (accuracies && accuracies.count != count)) {
+        return @[];
+    }
+
+    std::vector<int32_t> slotValues(count);
+    std::vector<double> times(count);
+    std::vector<double> accuracyValues(accuracies ? count : 0);
+    std::vector<gaodemap::GeoPoint> points;
+    points.reserve(count);
+    for (NSUInteger i = 0; i < count; i++) {
+        slotValues[i] = slots[i].intValue;
+        times[i] = timestamps[i].doubleValue;
+        if (accuracies) accuracyValues[i] = accuracies[i].doubleValue;
+        points.push_back({latitudes[i].doubleValue, longitudes[i].doubleValue});
+    }
+
+    std::vector<gaodemap::SmoothedFix> fixes(count);
+    _pool->update(slotValues.data(), times.data(), gaodemap::CoordSpan(points),
+                  accuracies ? accuracyValues.data() : nullptr, fixes.data());
+
+    NSMutableArray<NSDictionary *> *result = [NSMutableArray arrayWithCapacity:count];
+    for (const auto &fix : fixes) {
+        [result addObject:@{
+            @"latitude": @(fix.lat),
+            @"longitude": @(fix.lon),
+            @"speed": @(fix.speedMps),
+            @"heading": @(fix.headingDegrees),
+            @"flags": @(fix.flags)
+        }];
+    }
+    return result;
+}
+
+- (NSDictionary *)predictSlot:(NSInteger)slot time:(double)time {
+    double lat = 0.0;
+    double lon = 0.0;
+    if (!_pool->predict(static_cast<int>(slot), time, lat, lon)) {
+        return nil;
+    }
+    return @{ @"latitude": @(lat), @"longitude": @(lon) };
+}
+
+@end
@@ -0,0 +1,168 @@
+#include "HeatmapAccumulator.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace gaodemap {
+
+// 与 generateHeatmapGrid 相同的米 / 度换算
+static constexpr double kHeatmapAccMetersPerDegree = 111320.0;
+// 累积放大倍数超过 e^30 时重新设定时间基准，避免 stored 溢出
+static constexpr double kHeatmapAccMaxExponent = 30.0;
+static constexpr int64_t kHeatmapAccIndexBias = int64_t(1) << 31;
+
+static inline int64_t heatmapAcc_clampIndex(double value) {
+    const double limit = static_cast<double>(kHeatmapAccIndexBias - 1);
+    if (value > limit) return kHeatmapAccIndexBias - 1;
+    if (value < -limit) return -(kHeatmapAccIndexBias - 1);
+    return static_cast<int64_t>(value);
+}
+
+HeatmapAccumulator::HeatmapAccumulator(double gridSizeMeters, double referenceLatitude, double halfLifeSeconds, double pruneBelow)
+    : pruneBelow(std::max(0.0, pruneBelow)) {
+    const double size = (std::isfinite(gridSizeMeters) && gridSizeMeters > 0.0) ? gridSizeMeters : 100.0;
+    const double refLat = std::isfinite(referenceLatitude) ? std::max(-85.0, std::min(85.0, referenceLatitude)) : 0.0;
+    latStep = size / kHeatmapAccMetersPerDegree;
+    lonStep = size / (kHeatmapAccMetersPerDegree * std::cos(refLat * 3.14159265358979323846 / 180.0));
+    lambda = (std::isfinite(halfLifeSeconds) && halfLifeSeconds > 0.0) ? std::log(2.0) / halfLifeSeconds : 0.0;
+}
+
+bool HeatmapAccumulator::cellKey(const HeatmapPoint& point, uint64_t& key) const {
+    if (!std::isfinite(point.lat) || !std::isfinite(point.lon) || !std::isfinite(point.weight) || point.weight == 0.0) {
+        return false;
+    }
+    const int64_t row = heatmapAcc_clampIndex(std::floor(point.lat / latStep));
+    const int64_t col = heatmapAcc_clampIndex(std::floor(point.lon / lonStep));
+    // 加偏移后按无符号比较即 (row, col) 的字典序
+    key = (static_cast<uint64_t>(row + kHeatmapAccIndexBias) << 32) | static_cast<uint64_t>(col + kHeatmapAccIndexBias);
+    return true;
+}
+
+double HeatmapAccumulator::scaleAt(double timestampSeconds) const {
+    return lambda > 0.0 ? std::exp(lambda * (timestampSeconds - epoch)) : 1.0;
+}
+
+double HeatmapAccumulator::currentScale() const {
+    return lambda > 0.0 ? std::exp(-lambda * (now - epoch)) : 1.0;
+}
+
+void HeatmapAccumulator::add(const HeatmapPoint& point, double timestampSeconds) {
+    uint64_t key = 0;
+    if (!cellKey(point, key)) return;
+    if (std::isfinite(timestampSeconds)) {
+        advanceTime(timestampSeconds);
+    } else {
+        timestampSeconds = now;
+    }
+
+    auto inserted = cells.try_emplace(key, Cell{0.0, 0, timestampSeconds});
+    Cell& cell = inserted.first->second;
+    cell.stored += point.weight * scaleAt(timestampSeconds);
+    cell.count += 1;
+    cell.since = std::min(cell.since, timestampSeconds);
+    dirty.insert(key);
+}
+
+void HeatmapAccumulator::add(const std::vector<HeatmapPoint>& points, double timestampSeconds) {
+    for (const auto& p : points) {
+        add(p, timestampSeconds);
+    }
+}
+
+void HeatmapAccumulator::remove(const HeatmapPoint& point, double timestampSeconds) {
+    uint64_t key = 0;
+    if (!cellKey(point, key)) return;
+    auto found = cells.find(key);
+    if (found == cells.end()) return;  // 已被衰减清理或从未添加
+    if (!std::isfinite(timestampSeconds)) timestampSeconds = now;
+    // 早于网格重建时间的点已随旧网格一起被清理，不能再从新点的权重中扣除
+    if (timestampSeconds < found->second.since) return;
+
+    Cell& cell = found->second;
+    cell.count -= 1;
+    if (cell.count <= 0) {
+        cells.erase(found);
+    } else {
+        cell.stored = std::max(0.0, cell.stored - point.weight * scaleAt(timestampSeconds));
+    }
+    dirty.insert(key);
+}
+
+void HeatmapAccumulator::advanceTime(double nowSeconds) {
+    if (!(nowSeconds > now)) return;
+    now = nowSeconds;
+    if (lambda * (now - epoch) > kHeatmapAccMaxExponent) {
+        rebase();
+    }
+}
+
+void HeatmapAccumulator::rebase() {
+    // 只改变时间基准，网格的实际强度不变，因此不产生脏网格
+    const double scale = currentScale();
+    for (auto& entry : cells) {
+        entry.second.stored *= scale;
+    }
+    epoch = now;
+}
+
+void HeatmapAccumulator::prune() {
+    // 强度至少减半后才扫描一次，避免每次取增量都遍历全部网格
+    if (lambda <= 0.0 || lambda * (now - lastPrunedTime) < std::log(2.0)) return;
+    lastPrunedTime = now;
+
+    const double scale = currentScale();
+    for (auto it = cells.begin(); it != cells.end();) {
+        if (it->second.stored * scale < pruneBelow) {
+            dirty.insert(it->first);
+            it = cells.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
+HeatmapDelta HeatmapAccumulator::takeDirty() {
+    prune();
+
+    HeatmapDelta delta;
+    delta.decayFactor = lambda > 0.0 ? std::exp(-lambda * (now - lastTakenTime)) : 1.0;
+    lastTakenTime = now;
+
+    std::vector<uint64_t> keys(dirty.begin(), dirty.end());
+    std::sort(keys.begin(), keys.end());
+    dirty.clear();
+
+    const double scale = currentScale();
+    delta.cells.reserve(keys.size());
+    for (uint64_t key : keys) {
+        const int64_t row = static_cast<int64_t>(key >> 32) - kHeatmapAccIndexBias;
+        const int64_t col = static_cast<int64_t>(key & 0xffffffffULL) - kHeatmapAccIndexBias;
+        auto found = cells.find(key);
+        const double intensity = found == cells.end() ? 0.0 : std::max(0.0, found->second.stored * scale);
+        delta.cells.push_back({row, col, (row + 0.5) * latStep, (col + 0.5) * lonStep, intensity});
+    }
+    return delta;
+}
+
+std::vector<HeatmapGridCell> HeatmapAccumulator::snapshot() const {
+    std::vector<uint64_t> keys;
+    keys.reserve(cells.size());
+    const double scale = currentScale();
+    for (const auto& entry : cells) {
+        if (entry.second.stored * scale >= pruneBelow || lambda <= 0.0) {
+            keys.push_back(entry.first);
+        }
+    }
+    std::sort(keys.begin(), keys.end());
+
+    std::vector<HeatmapGridCell> result;
+    result.reserve(keys.size());
+    for (uint64_t key : keys) {
+        const int64_t row = static_cast<int64_t>(key >> 32) - kHeatmapAccIndexBias;
+        const int64_t col = static_cast<int64_t>(key & 0xffffffffULL) - kHeatmapAccIndexBias;
+        result.push_back({(row + 0.5) * latStep, (col + 0.5) * lonStep, std::max(0.0, cells.at(key).stored * scale)});
+    }
+    return result;
+}
+
+}
@@ -0,0 +1,720 @@
+#include "PolygonClipper.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace gaodemap {
+
+static constexpr double kClipperEarthRadiusMeters = 6371000.0;
+static constexpr double kClipperPi = 3.14159265358979323846;
+static constexpr double kClipperMinUnitMeters = 1e-3;
+// 坐标绝对值不超过 2^27，二倍坐标之差不超过 2^29，叉积不超过 2^58，int64 不会溢出
+static constexpr double kClipperGridSpan = 268435456.0;  // 2^28
+static constexpr int kClipperMaxNodingRounds = 6;
+static constexpr size_t kClipperMaxBands = 1u << 20;
+static constexpr uint32_t kClipperNone = 0xFFFFFFFFu;
+
+static inline bool clipper_equal(const ClipperPoint& a, const ClipperPoint& b) {
+    return a.x == b.x && a.y == b.y;
+}
+
+static inline bool clipper_less(const ClipperPoint& a, const ClipperPoint& b) {
+    return a.x < b.x || (a.x == b.x && a.y < b.y);
+}
+
+// (a - o) × (b - o)，> 0 表示 o -> a -> b 左转
+static inline int64_t clipper_cross(const ClipperPoint& o, const ClipperPoint& a, const ClipperPoint& b) {
+    return (a.x - o.x) * (b.y - o.y) - (a.y - o.y) * (b.x - o.x);
+}
+
+static inline int clipper_sign(int64_t value) {
+    return (value > 0) - (value < 0);
+}
+
+// p 与 a-b 共线时，是否严格位于线段内部
+static inline bool clipper_strictlyInside(const ClipperPoint& a, const ClipperPoint& b, const ClipperPoint& p) {
+    const int64_t dx = b.x - a.x;
+    const int64_t dy = b.y - a.y;
+    return (p.x - a.x) * dx + (p.y - a.y) * dy > 0 && (b.x - p.x) * dx + (b.y - p.y) * dy > 0;
+}
+
+// 方向按极角（从 +x 逆时针）排序，精确比较
+static inline bool clipper_angleLess(int64_t ax, int64_t ay, int64_t bx, int64_t by) {
+    const int halfA = (ay < 0 || (ay == 0 && ax < 0)) ? 1 : 0;
+    const int halfB = (by < 0 || (by == 0 && bx < 0)) ? 1 : 0;
+    if (halfA != halfB) return halfA < halfB;
+    return ax * by - ay * bx > 0;
+}
+
+static inline bool clipper_filled(FillRule rule, int32_t wind) {
+    switch (rule) {
+        case FillRule::EvenOdd: return (wind & 1) != 0;
+        case FillRule::NonZero: return wind != 0;
+        case FillRule::Positive: return wind > 0;
+    }
+    return false;
+}
+
+static inline bool clipper_apply(BooleanOp op, bool subject, bool clip) {
+    switch (op) {
+        case BooleanOp::Union: return subject || clip;
+        case BooleanOp::Intersection: return subject && clip;
+        case BooleanOp::Difference: return subject && !clip;
+        case BooleanOp::Xor: return subject != clip;
+    }
+    return false;
+}
+
+// 射线法（二倍坐标，点不在环上）
+static bool clipper_pointInRing(const std::vector<ClipperPoint>& ring, int64_t x2, int64_t y2) {
+    bool inside = false;
+    const size_t n = ring.size();
+    for (size_t i = 0, j = n - 1; i < n; j = i++) {
+        const int64_t ay = ring[j].y * 2;
+        const int64_t by = ring[i].y * 2;
+        if ((ay > y2) == (by > y2)) continue;
+        const int64_t ax = ring[j].x * 2;
+        const int64_t bx = ring[i].x * 2;
+        const int64_t cross = (bx - ax) * (y2 - ay) - (x2 - ax) * (by - ay);
+        if (cross != 0 && (cross > 0) == (by > ay)) inside = !inside;
+    }
+    return inside;
+}
+
+void PolygonClipper::setupFrame(const PolygonRings& first, const PolygonRings* second, double marginMeters) {
+    bool hasReference = false;
+    double referenceLon = 0.0;
+    double minLat = 0.0, maxLat = 0.0, minDLon = 0.0, maxDLon = 0.0;
+    auto visit = [&](const PolygonRings& rings) {
+        for (const auto& ring : rings) {
+            for (const auto& point : ring) {
+                if (!std::isfinite(point.lat) || !std::isfinite(point.lon)) continue;
+                if (!hasReference) {
+                    hasReference = true;
+                    referenceLon = point.lon;
+                    minLat = maxLat = point.lat;
+                    continue;
+                }
+                // 以第一个点为参考展开经度，跨 180° 经线的区域保持连续
+                const double dLon = std::remainder(point.lon - referenceLon, 360.0);
+                minLat = std::min(minLat, point.lat);
+                maxLat = std::max(maxLat, point.lat);
+                minDLon = std::min(minDLon, dLon);
+                maxDLon = std::max(maxDLon, dLon);
+            }
+        }
+    };
+    visit(first);
+    if (second != nullptr) visit(*second);
+
+    originLat = (minLat + maxLat) * 0.5;
+    originLon = referenceLon + (minDLon + maxDLon) * 0.5;
+    const double metersPerDegreeLat = kClipperEarthRadiusMeters * kClipperPi / 180.0;
+    const double metersPerDegreeLon = metersPerDegreeLat * std::max(std::cos(originLat * kClipperPi / 180.0), 0.01);
+    const double extent = std::max((maxLat - minLat) * metersPerDegreeLat, (maxDLon - minDLon) * metersPerDegreeLon)
+        + 2.0 * std::abs(marginMeters);
+    metersPerUnit = std::max(kClipperMinUnitMeters, extent / kClipperGridSpan);
+    unitsPerDegreeLat = metersPerDegreeLat / metersPerUnit;
+    unitsPerDegreeLon = metersPerDegreeLon / metersPerUnit;
+}
+
+ClipperPoint PolygonClipper::project(const GeoPoint& point) const {
+    return {
+        std::llround(std::remainder(point.lon - originLon, 360.0) * unitsPerDegreeLon),
+        std::llround((point.lat - originLat) * unitsPerDegreeLat)
+    };
+}
+
+GeoPoint PolygonClipper::unproject(const ClipperPoint& point) const {
+    double lon = originLon + static_cast<double>(point.x) / unitsPerDegreeLon;
+    if (lon > 180.0) lon -= 360.0;
+    if (lon < -180.0) lon += 360.0;
+    return {originLat + static_cast<double>(point.y) / unitsPerDegreeLat, lon};
+}
+
+void PolygonClipper::addRing(const std::vector<ClipperPoint>& ring, uint8_t operand) {
+    // 去掉相邻重复点和首尾重复点，少于 3 个点的环没有面积
+    size_t count = ring.size();
+    while (count > 1 && clipper_equal(ring[count - 1], ring[0])) --count;
+    size_t first = edges.size();
+    const ClipperPoint* previous = nullptr;
+    for (size_t i = 0; i < count; ++i) {
+        if (previous != nullptr && clipper_equal(*previous, ring[i])) continue;
+        if (previous != nullptr) edges.push_back({*previous, ring[i], operand});
+        previous = &ring[i];
+    }
+    if (previous == nullptr || edges.size() - first < 2) {
+        edges.resize(first);
+        return;
+    }
+    edges.push_back({*previous, edges[first].a, operand});
+}
+
+void PolygonClipper::addRings(const PolygonRings& input, uint8_t operand) {
+    std::vector<ClipperPoint> ring;
+    for (const auto& points : input) {
+        ring.clear();
+        ring.reserve(points.size());
+        for (const auto& point : points) {
+            if (std::isfinite(point.lat) && std::isfinite(point.lon)) ring.push_back(project(point));
+        }
+        addRing(ring, operand);
+    }
+}
+
+void PolygonClipper::intersect(uint32_t first, uint32_t second) {
+    const Edge& s = edges[first];
+    const Edge& t = edges[second];
+    const int64_t o1 = clipper_cross(s.a, s.b, t.a);
+    const int64_t o2 = clipper_cross(s.a, s.b, t.b);
+    const int64_t o3 = clipper_cross(t.a, t.b, s.a);
+    const int64_t o4 = clipper_cross(t.a, t.b, s.b);
+
+    if (clipper_sign(o1) * clipper_sign(o2) < 0 && clipper_sign(o3) * clipper_sign(o4) < 0) {
+        // 真交叉：交点取整到网格，并限制在两条边的外包框内
+        const double u = static_cast<double>(o3) / (static_cast<double>(o3) - static_cast<double>(o4));
+        ClipperPoint p{
+            std::llround(static_cast<double>(s.a.x) + static_cast<double>(s.b.x - s.a.x) * u),
+            std::llround(static_cast<double>(s.a.y) + static_cast<double>(s.b.y - s.a.y) * u)
+        };
+        const Box& bs = boxes[first];
+        const Box& bt = boxes[second];
+        p.x = std::min(std::max(p.x, std::max(bs.minX, bt.minX)), std::min(bs.maxX, bt.maxX));
+        p.y = std::min(std::max(p.y, std::max(bs.minY, bt.minY)), std::min(bs.maxY, bt.maxY));
+        if (!clipper_equal(p, s.a) && !clipper_equal(p, s.b)) splits.push_back({first, p});
+        if (!clipper_equal(p, t.a) && !clipper_equal(p, t.b)) splits.push_back({second, p});
+        return;
+    }
+    // 接触与共线重叠：端点落在另一条边内部时拆分那条边
+    if (o1 == 0 && clipper_strictlyInside(s.a, s.b, t.a)) splits.push_back({first, t.a});
+    if (o2 == 0 && clipper_strictlyInside(s.a, s.b, t.b)) splits.push_back({first, t.b});
+    if (o3 == 0 && clipper_strictlyInside(t.a, t.b, s.a)) splits.push_back({second, s.a});
+    if (o4 == 0 && clipper_strictlyInside(t.a, t.b, s.b)) splits.push_back({second, s.b});
+}
+
+// 枚举线段经过的网格：逐行求出线段在该行内的 x 范围（外扩 1 个单位），保守覆盖
+template <typename Visit>
+static inline void clipper_forEachCell(const ClipperPoint& a, const ClipperPoint& b, int64_t originX, int64_t originY,
+                                       int64_t cellSize, int64_t columns, Visit visit) {
+    const int64_t minY = std::min(a.y, b.y);
+    const int64_t maxY = std::max(a.y, b.y);
+    const int64_t minX = std::min(a.x, b.x);
+    const int64_t maxX = std::max(a.x, b.x);
+    const int64_t firstRow = (minY - originY) / cellSize;
+    const int64_t lastRow = (maxY - originY) / cellSize;
+    const double slope = a.y == b.y ? 0.0 : static_cast<double>(b.x - a.x) / static_cast<double>(b.y - a.y);
+    for (int64_t row = firstRow; row <= lastRow; ++row) {
+        int64_t left = minX;
+        int64_t right = maxX;
+        if (a.y != b.y) {
+            const int64_t low = std::max(minY, originY + row * cellSize);
+            const int64_t high = std::min(maxY, originY + (row + 1) * cellSize);
+            const double x0 = static_cast<double>(a.x) + static_cast<double>(low - a.y) * slope;
+            const double x1 = static_cast<double>(a.x) + static_cast<double>(high - a.y) * slope;
+            left = std::max(minX, static_cast<int64_t>(std::floor(std::min(x0, x1))) - 1);
+            right = std::min(maxX, static_cast<int64_t>(std::ceil(std::max(x0, x1))) + 1);
+        }
+        const int64_t lastColumn = (right - originX) / cellSize;
+        for (int64_t column = (left - originX) / cellSize; column <= lastColumn; ++column) {
+            visit(static_cast<size_t>(row * columns + column));
+        }
+    }
+}
+
+bool PolygonClipper::splitIntersections() {
+    const size_t n = edges.size();
+    if (n == 0) return false;
+    boxes.resize(n);
+    Box bounds{std::numeric_limits<int64_t>::max(), std::numeric_limits<int64_t>::max(),
+               std::numeric_limits<int64_t>::min(), std::numeric_limits<int64_t>::min()};
+    double totalSpan = 0.0;
+    for (size_t i = 0; i < n; ++i) {
+        const Edge& e = edges[i];
+        const Box box{std::min(e.a.x, e.b.x), std::min(e.a.y, e.b.y), std::max(e.a.x, e.b.x), std::max(e.a.y, e.b.y)};
+        boxes[i] = box;
+        bounds = {std::min(bounds.minX, box.minX), std::min(bounds.minY, box.minY), std::max(bounds.maxX, box.maxX), std::max(bounds.maxY, box.maxY)};
+        totalSpan += static_cast<double>(box.maxX - box.minX + box.maxY - box.minY);
+    }
+
+    // 候选边对来自均匀网格：网格边长取边的平均跨度与 sqrt(面积 / 边数) 的较大者，网格数不超过边数的 4 倍
+    const double width = static_cast<double>(bounds.maxX - bounds.minX) + 1.0;
+    const double height = static_cast<double>(bounds.maxY - bounds.minY) + 1.0;
+    double cell = std::max({totalSpan / static_cast<double>(n), std::sqrt(width * height / static_cast<double>(n)), 1.0});
+    const double maxCells = 4.0 * static_cast<double>(n) + 16.0;
+    if ((width / cell + 1.0) * (height / cell + 1.0) > maxCells) {
+        cell = std::sqrt(width * height / maxCells) * 1.5;
+    }
+    const int64_t cellSize = std::max<int64_t>(1, static_cast<int64_t>(std::ceil(cell)));
+    const int64_t columns = (bounds.maxX - bounds.minX) / cellSize + 1;
+    const int64_t rows = (bounds.maxY - bounds.minY) / cellSize + 1;
+    cellOffsets.assign(static_cast<size_t>(columns * rows) + 1, 0);
+    for (size_t i = 0; i < n; ++i) {
+        clipper_forEachCell(edges[i].a, edges[i].b, bounds.minX, bounds.minY, cellSize, columns,
+            [this](size_t c) { ++cellOffsets[c + 1]; });
+    }
+    for (size_t c = 1; c < cellOffsets.size(); ++c) cellOffsets[c] += cellOffsets[c - 1];
+    cellItems.resize(cellOffsets.back());
+    cursor.assign(cellOffsets.begin(), cellOffsets.end() - 1);
+    for (size_t i = 0; i < n; ++i) {
+        clipper_forEachCell(edges[i].a, edges[i].b, bounds.minX, bounds.minY, cellSize, columns,
+            [this, i](size_t c) { cellItems[cursor[c]++] = static_cast<uint32_t>(i); });
+    }
+
+    // 同一对边可能在多个网格中重复检测，重复的拆分点在重建时去掉；上一轮都没有变化的边对无需再测
+    splits.clear();
+    for (size_t c = 0; c + 1 < cellOffsets.size(); ++c) {
+        for (uint32_t i = cellOffsets[c]; i < cellOffsets[c + 1]; ++i) {
+            const Box& first = boxes[cellItems[i]];
+            const bool firstFresh = fresh[cellItems[i]] != 0;
+            for (uint32_t j = i + 1; j < cellOffsets[c + 1]; ++j) {
+                if (!firstFresh && !fresh[cellItems[j]]) continue;
+                const Box& second = boxes[cellItems[j]];
+                if (first.maxX < second.minX || second.maxX < first.minX || first.maxY < second.minY || second.maxY < first.minY) continue;
+                intersect(cellItems[i], cellItems[j]);
+            }
+        }
+    }
+    if (splits.empty()) return false;
+
+    std::sort(splits.begin(), splits.end(), [this](const Split& l, const Split& r) {
+        if (l.edge != r.edge) return l.edge < r.edge;
+        const Edge& e = edges[l.edge];
+        const int64_t dx = e.b.x - e.a.x;
+        const int64_t dy = e.b.y - e.a.y;
+        return (l.point.x - e.a.x) * dx + (l.point.y - e.a.y) * dy < (r.point.x - e.a.x) * dx + (r.point.y - e.a.y) * dy;
+    });
+    scratch.clear();
+    scratch.reserve(n + splits.size());
+    freshScratch.clear();
+    size_t next = 0;
+    for (size_t i = 0; i < n; ++i) {
+        const Edge& e = edges[i];
+        ClipperPoint previous = e.a;
+        const size_t before = scratch.size();
+        for (; next < splits.size() && splits[next].edge == i; ++next) {
+            const ClipperPoint& p = splits[next].point;
+            if (clipper_equal(p, previous) || clipper_equal(p, e.b)) continue;
+            scratch.push_back({previous, p, e.operand});
+            previous = p;
+        }
+        scratch.push_back({previous, e.b, e.operand});
+        freshScratch.resize(scratch.size(), scratch.size() - before > 1 ? 1 : 0);
+    }
+    edges.swap(scratch);
+    fresh.swap(freshScratch);
+    return true;
+}
+
+void PolygonClipper::buildUniqueEdges() {
+    // 统一为规范方向后排序合并，方向相反的重复边互相抵消
+    scratch.clear();
+    scratch.reserve(edges.size());
+    for (const Edge& e : edges) {
+        const bool forward = e.a.y < e.b.y || (e.a.y == e.b.y && e.a.x < e.b.x);
+        // operand 的第 2 位记录方向
+        scratch.push_back(forward ? Edge{e.a, e.b, e.operand} : Edge{e.b, e.a, static_cast<uint8_t>(e.operand | 2)});
+    }
+    std::sort(scratch.begin(), scratch.end(), [](const Edge& l, const Edge& r) {
+        if (!clipper_equal(l.a, r.a)) return clipper_less(l.a, r.a);
+        return clipper_less(l.b, r.b);
+    });
+    unique.clear();
+    for (size_t i = 0; i < scratch.size();) {
+        UniqueEdge merged{scratch[i].a, scratch[i].b, {0, 0}};
+        size_t j = i;
+        for (; j < scratch.size() && clipper_equal(scratch[j].a, merged.u) && clipper_equal(scratch[j].b, merged.v); ++j) {
+            merged.wind[scratch[j].operand & 1] += (scratch[j].operand & 2) ? -1 : 1;
+        }
+        if (merged.wind[0] != 0 || merged.wind[1] != 0) unique.push_back(merged);
+        i = j;
+    }
+}
+
+size_t PolygonClipper::bandOf(int64_t y) const {
+    if (y <= bandMinY) return 0;
+    const size_t band = static_cast<size_t>((y - bandMinY) / bandHeight);
+    return std::min(band, bandOffsets.size() - 2);
+}
+
+void PolygonClipper::buildBandIndex() {
+    int64_t minY = std::numeric_limits<int64_t>::max();
+    int64_t maxY = std::numeric_limits<int64_t>::min();
+    size_t sloped = 0;
+    double totalSpan = 0.0;
+    for (const UniqueEdge& e : unique) {
+        if (e.u.y == e.v.y) continue;
+        minY = std::min(minY, e.u.y);
+        maxY = std::max(maxY, e.v.y);
+        totalSpan += static_cast<double>(e.v.y - e.u.y);
+        ++sloped;
+    }
+    // 带高取边的平均 y 跨度，每条边平均只登记到一两个带中
+    const double span = static_cast<double>(maxY - minY);
+    const size_t bandCount = sloped == 0 ? 1
+        : static_cast<size_t>(std::clamp(span * static_cast<double>(sloped) / std::max(totalSpan, 1.0), 1.0, static_cast<double>(kClipperMaxBands)));
+    bandMinY = sloped == 0 ? 0 : minY;
+    bandHeight = sloped == 0 ? 1 : (maxY - bandMinY) / static_cast<int64_t>(bandCount) + 1;
+
+    bandOffsets.assign(bandCount + 1, 0);
+    for (const UniqueEdge& e : unique) {
+        if (e.u.y == e.v.y) continue;
+        const size_t last = bandOf(e.v.y);
+        for (size_t b = bandOf(e.u.y); b <= last; ++b) ++bandOffsets[b + 1];
+    }
+    for (size_t b = 0; b < bandCount; ++b) bandOffsets[b + 1] += bandOffsets[b];
+    bandEdges.resize(bandOffsets[bandCount]);
+    cursor.assign(bandOffsets.begin(), bandOffsets.end() - 1);
+    for (size_t i = 0; i < unique.size(); ++i) {
+        const UniqueEdge& e = unique[i];
+        if (e.u.y == e.v.y) continue;
+        const size_t last = bandOf(e.v.y);
+        for (size_t b = bandOf(e.u.y); b <= last; ++b) bandEdges[cursor[b]++] = static_cast<uint32_t>(i);
+    }
+}
+
+// 从略低于 p 的位置向 +x 的射线上的环绕数，水平边不参与计算
+void PolygonClipper::windingAt(const ClipperPoint& p, int32_t wind[2]) const {
+    const size_t band = bandOf(p.y);
+    for (uint32_t k = bandOffsets[band]; k < bandOffsets[band + 1]; ++k) {
+        const UniqueEdge& e = unique[bandEdges[k]];
+        if (!(e.u.y < p.y && p.y <= e.v.y)) continue;
+        if ((e.v.x - e.u.x) * (p.y - e.u.y) - (p.x - e.u.x) * (e.v.y - e.u.y) > 0) {
+            wind[0] += e.wind[0];
+            wind[1] += e.wind[1];
+        }
+    }
+}
+
+void PolygonClipper::buildFaces() {
+    // 每条去重边拆成两条半边（下标 2i 为规范方向），按起点和极角排序
+    halfEdges.clear();
+    halfEdges.reserve(unique.size() * 2);
+    for (size_t i = 0; i < unique.size(); ++i) {
+        halfEdges.push_back({unique[i].u, unique[i].v, static_cast<uint32_t>(i * 2)});
+        halfEdges.push_back({unique[i].v, unique[i].u, static_cast<uint32_t>(i * 2 + 1)});
+    }
+    std::sort(halfEdges.begin(), halfEdges.end(), [](const HalfEdge& l, const HalfEdge& r) {
+        if (!clipper_equal(l.a, r.a)) return clipper_less(l.a, r.a);
+        return clipper_angleLess(l.b.x - l.a.x, l.b.y - l.a.y, r.b.x - r.a.x, r.b.y - r.a.y);
+    });
+    const size_t count = halfEdges.size();
+    halfPosition.resize(count);
+    vertexFirst.resize(count);
+    vertexLast.resize(count);
+    for (size_t k = 0; k < count; ++k) {
+        halfPosition[halfEdges[k].id] = static_cast<uint32_t>(k);
+        vertexFirst[k] = (k > 0 && clipper_equal(halfEdges[k].a, halfEdges[k - 1].a)) ? vertexFirst[k - 1] : static_cast<uint32_t>(k);
+    }
+    for (size_t k = count; k-- > 0;) {
+        vertexLast[k] = (k + 1 < count && vertexFirst[k + 1] == vertexFirst[k]) ? vertexLast[k + 1] : static_cast<uint32_t>(k);
+    }
+
+    // 沿半边左侧追踪面：下一条半边是终点处反向半边按极角顺时针方向的前一条
+    faceOf.assign(count, kClipperNone);
+    faceStart.clear();
+    faceArea.clear();
+    for (uint32_t start = 0; start < count; ++start) {
+        if (faceOf[start] != kClipperNone) continue;
+        const uint32_t face = static_cast<uint32_t>(faceStart.size());
+        double area = 0.0;
+        uint32_t k = start;
+        do {
+            faceOf[k] = face;
+            const HalfEdge& h = halfEdges[k];
+            area += static_cast<double>(h.a.x) * static_cast<double>(h.b.y) - static_cast<double>(h.b.x) * static_cast<double>(h.a.y);
+            k = nextHalfEdge(k);
+        } while (k != start && faceOf[k] == kClipperNone);
+        faceStart.push_back(start);
+        faceArea.push_back(area);
+    }
+}
+
+uint32_t PolygonClipper::nextHalfEdge(uint32_t k) const {
+    const uint32_t twin = halfPosition[halfEdges[k].id ^ 1];
+    return twin == vertexFirst[twin] ? vertexLast[twin] : twin - 1;
+}
+
+void PolygonClipper::propagateWinding() {
+    // 相邻面的环绕数相差两者之间那条边的环绕数；每个连通分量从它的外侧面出发，
+    // 外侧面的环绕数由其最低点处的射线给出（射线只会穿过其他分量的边）
+    const size_t faceCount = faceStart.size();
+    faceWind.assign(faceCount * 2, 0);
+    std::vector<uint8_t> state(faceCount, 0);   // 0 未访问，1 已归入分量，2 已求出环绕数
+    std::vector<uint32_t> component;
+    for (uint32_t seed = 0; seed < faceCount; ++seed) {
+        if (state[seed] != 0) continue;
+        component.assign(1, seed);
+        state[seed] = 1;
+        uint32_t outer = seed;
+        for (size_t c = 0; c < component.size(); ++c) {
+            const uint32_t face = component[c];
+            if (faceArea[face] < faceArea[outer]) outer = face;
+            uint32_t k = faceStart[face];
+            do {
+                const uint32_t neighbor = faceOf[halfPosition[halfEdges[k].id ^ 1]];
+                if (state[neighbor] == 0) {
+                    state[neighbor] = 1;
+                    component.push_back(neighbor);
+                }
+                k = nextHalfEdge(k);
+            } while (k != faceStart[face]);
+        }
+
+        ClipperPoint lowest = halfEdges[faceStart[outer]].a;
+        uint32_t k = faceStart[outer];
+        do {
+            const ClipperPoint& p = halfEdges[k].a;
+            if (p.y < lowest.y || (p.y == lowest.y && p.x < lowest.x)) lowest = p;
+            k = nextHalfEdge(k);
+        } while (k != faceStart[outer]);
+        windingAt(lowest, &faceWind[outer * 2]);
+
+        component.assign(1, outer);
+        state[outer] = 2;
+        for (size_t c = 0; c < component.size(); ++c) {
+            const uint32_t face = component[c];
+            uint32_t h = faceStart[face];
+            do {
+                const uint32_t id = halfEdges[h].id;
+                const uint32_t neighbor = faceOf[halfPosition[id ^ 1]];
+                if (state[neighbor] != 2) {
+                    // 左侧 = 右侧 + 规范方向的环绕数
+                    const UniqueEdge& e = unique[id >> 1];
+                    const int32_t sign = (id & 1) ? -1 : 1;
+                    faceWind[neighbor * 2] = faceWind[face * 2] - sign * e.wind[0];
+                    faceWind[neighbor * 2 + 1] = faceWind[face * 2 + 1] - sign * e.wind[1];
+                    state[neighbor] = 2;
+                    component.push_back(neighbor);
+                }
+                h = nextHalfEdge(h);
+            } while (h != faceStart[face]);
+        }
+    }
+}
+
+void PolygonClipper::overlay(BooleanOp op, FillRule subjectFill, FillRule clipFill) {
+    fresh.assign(edges.size(), 1);
+    for (int round = 0; round < kClipperMaxNodingRounds && splitIntersections(); ++round) {}
+    buildUniqueEdges();
+    buildBandIndex();
+    buildFaces();
+    propagateWinding();
+
+    resultEdges.clear();
+    for (size_t i = 0; i < unique.size(); ++i) {
+        const UniqueEdge& e = unique[i];
+        const int32_t* left = &faceWind[faceOf[halfPosition[i * 2]] * 2];
+        const int32_t* right = &faceWind[faceOf[halfPosition[i * 2 + 1]] * 2];
+        const bool insideLeft = clipper_apply(op, clipper_filled(subjectFill, left[0]), clipper_filled(clipFill, left[1]));
+        const bool insideRight = clipper_apply(op, clipper_filled(subjectFill, right[0]), clipper_filled(clipFill, right[1]));
+        if (insideLeft != insideRight) {
+            resultEdges.push_back(insideLeft ? Edge{e.u, e.v, 0} : Edge{e.v, e.u, 0});
+        }
+    }
+}
+
+uint32_t PolygonClipper::nextEdge(uint32_t edge) const {
+    const ClipperPoint& from = resultEdges[edge].a;
+    const ClipperPoint& vertex = resultEdges[edge].b;
+    auto range = std::equal_range(resultEdges.begin(), resultEdges.end(), Edge{vertex, vertex, 0},
+        [](const Edge& l, const Edge& r) { return clipper_less(l.a, r.a); });
+    if (range.first == range.second) return edge;
+    // 出边按极角排序，取从入边反方向顺时针转过的第一条
+    const int64_t backX = from.x - vertex.x;
+    const int64_t backY = from.y - vertex.y;
+    auto position = std::lower_bound(range.first, range.second, Edge{vertex, vertex, 0},
+        [&](const Edge& e, const Edge&) {
+            return clipper_angleLess(e.b.x - e.a.x, e.b.y - e.a.y, backX, backY);
+        });
+    if (position == range.first) position = range.second;
+    return static_cast<uint32_t>(std::distance(resultEdges.begin(), position) - 1);
+}
+
+void PolygonClipper::assembleRings() {
+    std::sort(resultEdges.begin(), resultEdges.end(), [](const Edge& l, const Edge& r) {
+        if (!clipper_equal(l.a, r.a)) return clipper_less(l.a, r.a);
+        return clipper_angleLess(l.b.x - l.a.x, l.b.y - l.a.y, r.b.x - r.a.x, r.b.y - r.a.y);
+    });
+    usedEdges.assign(resultEdges.size(), 0);
+    rings.clear();
+    std::vector<ClipperPoint> ring;
+    for (uint32_t start = 0; start < resultEdges.size(); ++start) {
+        if (usedEdges[start]) continue;
+        ring.clear();
+        uint32_t edge = start;
+        bool closed = false;
+        while (!usedEdges[edge]) {
+            usedEdges[edge] = 1;
+            const ClipperPoint& p = resultEdges[edge].a;
+            // 去掉共线点
+            while (ring.size() >= 2 && clipper_cross(ring[ring.size() - 2], ring.back(), p) == 0) ring.pop_back();
+            ring.push_back(p);
+            edge = nextEdge(edge);
+            if (edge == start) {
+                closed = true;
+                break;
+            }
+        }
+        if (!closed) continue;
+        size_t begin = 0;
+        while (ring.size() - begin >= 3 && clipper_cross(ring[ring.size() - 2], ring.back(), ring[begin]) == 0) ring.pop_back();
+        while (ring.size() - begin >= 3 && clipper_cross(ring.back(), ring[begin], ring[begin + 1]) == 0) ++begin;
+        if (ring.size() - begin < 3) continue;
+        rings.emplace_back(ring.begin() + static_cast<std::ptrdiff_t>(begin), ring.end());
+    }
+
+    // 逆时针为外环，洞归入包含它的面积最小的外环
+    const size_t count = rings.size();
+    std::vector<double> areas(count);
+    std::vector<Box> ringBoxes(count);
+    std::vector<uint32_t> outers;
+    for (size_t i = 0; i < count; ++i) {
+        const auto& r = rings[i];
+        double area = 0.0;
+        Box box{r[0].x, r[0].y, r[0].x, r[0].y};
+        for (size_t k = 0, j = r.size() - 1; k < r.size(); j = k++) {
+            area += static_cast<double>(r[j].x) * static_cast<double>(r[k].y) - static_cast<double>(r[k].x) * static_cast<double>(r[j].y);
+            box = {std::min(box.minX, r[k].x), std::min(box.minY, r[k].y), std::max(box.maxX, r[k].x), std::max(box.maxY, r[k].y)};
+        }
+        areas[i] = area;
+        ringBoxes[i] = box;
+        if (area > 0.0) outers.push_back(static_cast<uint32_t>(i));
+    }
+    std::sort(outers.begin(), outers.end(), [&](uint32_t l, uint32_t r) { return areas[l] < areas[r]; });
+    ringParent.assign(count, -1);
+    for (size_t i = 0; i < count; ++i) {
+        if (areas[i] > 0.0) continue;
+        ringParent[i] = -2;
+        // 洞与外环不共享边，洞第一条边的中点一定不在外环上
+        const int64_t x2 = rings[i][0].x + rings[i][1].x;
+        const int64_t y2 = rings[i][0].y + rings[i][1].y;
+        for (uint32_t outer : outers) {
+            const Box& box = ringBoxes[outer];
+            if (x2 < box.minX * 2 || x2 > box.maxX * 2 || y2 < box.minY * 2 || y2 > box.maxY * 2) continue;
+            if (clipper_pointInRing(rings[outer], x2, y2)) {
+                ringParent[i] = static_cast<int32_t>(outer);
+                break;
+            }
+        }
+    }
+}
+
+std::vector<PolygonRings> PolygonClipper::output() const {
+    std::vector<PolygonRings> result;
+    std::vector<int32_t> polygonOf(rings.size(), -1);
+    auto convert = [this](const std::vector<ClipperPoint>& ring) {
+        std::vector<GeoPoint> points;
+        points.reserve(ring.size());
+        for (const auto& p : ring) points.push_back(unproject(p));
+        return points;
+    };
+    for (size_t i = 0; i < rings.size(); ++i) {
+        if (ringParent[i] != -1) continue;
+        polygonOf[i] = static_cast<int32_t>(result.size());
+        result.push_back({convert(rings[i])});
+    }
+    for (size_t i = 0; i < rings.size(); ++i) {
+        if (ringParent[i] < 0) continue;
+        result[static_cast<size_t>(polygonOf[static_cast<size_t>(ringParent[i])])].push_back(convert(rings[i]));
+    }
+    return result;
+}
+
+std::vector<PolygonRings> PolygonClipper::compute(const PolygonRings& subject, const PolygonRings& clip, BooleanOp op, FillRule fillRule) {
+    setupFrame(subject, &clip, 0.0);
+    edges.clear();
+    addRings(subject, 0);
+    addRings(clip, 1);
+    overlay(op, fillRule, fillRule);
+    assembleRings();
+    return output();
+}
+
+std::vector<PolygonRings> PolygonClipper::buffer(const PolygonRings& polygon, double meters, double arcToleranceMeters) {
+    if (!std::isfinite(meters)) return {};
+    setupFrame(polygon, nullptr, meters);
+
+    // 先规整化：去自交、外环逆时针、洞顺时针（内部都在左侧）
+    edges.clear();
+    addRings(polygon, 0);
+    overlay(BooleanOp::Union, FillRule::EvenOdd, FillRule::EvenOdd);
+    assembleRings();
+    if (meters == 0.0 || rings.empty()) return output();
+
+    // 每个环沿右侧法向（外侧）偏移 delta 得到原始偏移环：
+    // 偏移方向上的凸角用圆弧连接，凹角经原顶点折返（两段偏移边之间形成的小环与主环同向），
+    // 原始环自身相交，按 Positive 规则合并后即为缓冲区；收缩过度翻转的部分环绕数为负，自然被去掉
+    const double delta = meters / metersPerUnit;
+    const double radius = std::abs(delta);
+    double tolerance = arcToleranceMeters > 0.0 ? arcToleranceMeters : std::max(std::abs(meters) * 0.005, 0.01);
+    tolerance = std::min(tolerance / metersPerUnit, radius);
+    const double maxStep = std::max(2.0 * std::acos(1.0 - tolerance / radius), kClipperPi / 512.0);
+
+    std::vector<std::vector<ClipperPoint>> normalized;
+    normalized.swap(rings);
+    edges.clear();
+    std::vector<ClipperPoint> offset;
+    std::vector<double> normalX, normalY;
+    for (const auto& ring : normalized) {
+        const size_t n = ring.size();
+        normalX.resize(n);
+        normalY.resize(n);
+        for (size_t i = 0; i < n; ++i) {
+            const ClipperPoint& a = ring[i];
+            const ClipperPoint& b = ring[(i + 1) % n];
+            const double dx = static_cast<double>(b.x - a.x);
+            const double dy = static_cast<double>(b.y - a.y);
+            const double length = std::sqrt(dx * dx + dy * dy);
+            normalX[i] = dy / length;
+            normalY[i] = -dx / length;
+        }
+        offset.clear();
+        auto emit = [&](double x, double y) {
+            offset.push_back({std::llround(x), std::llround(y)});
+        };
+        for (size_t i = 0; i < n; ++i) {
+            const size_t previous = (i + n - 1) % n;
+            const double vx = static_cast<double>(ring[i].x);
+            const double vy = static_cast<double>(ring[i].y);
+            const double n1x = normalX[previous], n1y = normalY[previous];
+            const double n2x = normalX[i], n2y = normalY[i];
+            // 法向夹角即边的转角，sinA > 0 为左转
+            const double sinA = n1x * n2y - n1y * n2x;
+            const double cosA = n1x * n2x + n1y * n2y;
+            if (sinA * delta < 0.0 || (std::abs(sinA) < 1e-12 && cosA > 0.0)) {
+                emit(vx + n1x * delta, vy + n1y * delta);
+                if (sinA * delta < 0.0) emit(vx, vy);
+                emit(vx + n2x * delta, vy + n2y * delta);
+                continue;
+            }
+            const double angle = std::atan2(sinA, cosA);
+            const int steps = std::max(1, static_cast<int>(std::ceil(std::abs(angle) / maxStep)));
+            const double stepCos = std::cos(angle / steps);
+            const double stepSin = std::sin(angle / steps);
+            double nx = n1x, ny = n1y;
+            for (int k = 0; k <= steps; ++k) {
+                emit(vx + nx * delta, vy + ny * delta);
+                const double rx = nx * stepCos - ny * stepSin;
+                ny = nx * stepSin + ny * stepCos;
+                nx = rx;
+            }
+        }
+        addRing(offset, 0);
+    }
+    overlay(BooleanOp::Union, FillRule::Positive, FillRule::Positive);
+    assembleRings();
+    return output();
+}
+
+std::vector<PolygonRings> polygonBoolean(const PolygonRings& subject, const PolygonRings& clip, BooleanOp op, FillRule fillRule) {
+    PolygonClipper clipper;
+    return clipper.compute(subject, clip, op, fillRule);
+}
+
+std::vector<PolygonRings> bufferPolygon(const PolygonRings& polygon, double meters, double arcToleranceMeters) {
+    PolygonClipper clipper;
+    return clipper.buffer(polygon, meters, arcToleranceMeters);
+}
+
+}
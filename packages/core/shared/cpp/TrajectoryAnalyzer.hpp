@@ -0,0 +1,139 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "GeometryEngine.hpp"
+
+namespace gaodemap {
+
+// 每个输入点的分段标记，可按位组合
+enum TrajectoryFlags : uint8_t {
+    kTrajectoryOutlier = 1,      // 跳点（速度超限、时间倒退或坐标非法），已剔除，不参与统计
+    kTrajectoryStationary = 2,   // 分段速度低于 stopSpeedMps
+    kTrajectoryGap = 4,          // 与上一个有效点的时间间隔超过 maxGapSeconds
+    kTrajectoryReanchored = 8    // 连续跳点彼此一致，视为重新定位（如出隧道）；与上一个有效点之间的距离不计入里程
+};
+
+struct TrajectoryOptions {
+    double stopSpeedMps = 0.5;        // 分段速度低于该值视为静止
+    double stopRadiusMeters = 30.0;   // 停留点的空间范围（相对停留开始的点）
+    double minStopSeconds = 120.0;    // 停留的最短时长
+    double maxSpeedMps = 70.0;        // 超过该速度的分段视为跳点（约 250 km/h）
+    double maxGapSeconds = 300.0;     // 超过该间隔的分段标记为断档
+    int reanchorAfter = 3;            // 连续多少个彼此一致的跳点后改为接受
+};
+
+// 相对上一个有效点的分段信息，对应一个输入点
+struct TrajectorySegment {
+    double distanceMeters;
+    double seconds;
+    double speedMps;
+    double headingDegrees;   // 正北为 0、顺时针 [0, 360)；位移小于 1 m 时沿用上一个航向，首个点为 NaN
+    uint8_t flags;           // TrajectoryFlags
+};
+
+// 停留（在 stopRadiusMeters 范围内持续至少 minStopSeconds）
+struct TrajectoryStop {
+    double lat;              // 停留期间有效点的平均位置
+    double lon;
+    double startTime;
+    double endTime;
+    size_t firstIndex;       // 全局点序号（从第一次 add 开始计数）
+    size_t lastIndex;
+    size_t pointCount;
+};
+
+struct TrajectorySummary {
+    size_t pointCount = 0;              // 输入点数
+    size_t acceptedCount = 0;           // 有效点数
+    size_t outlierCount = 0;
+    size_t stopCount = 0;
+    double totalDistanceMeters = 0.0;
+    double totalSeconds = 0.0;          // 首个到最后一个有效点
+    double movingSeconds = 0.0;         // 非静止分段的时长
+    double stoppedSeconds = 0.0;        // 各停留的时长之和
+    double maxSpeedMps = 0.0;
+    double averageSpeedMps = 0.0;       // 里程 / 总时长
+    double movingAverageSpeedMps = 0.0; // 非静止分段的里程 / 时长
+    PathBounds bounds{};                // 有效点的边界（跨 180° 经线感知）
+};
+
+/**
+ * 轨迹分析（流式）：一次遍历计算分段速度与航向、剔除跳点、识别停留并累计统计
+ *
+ * 可分块输入，分块与一次性输入结果相同；内部只保留上一个有效点、当前停留候选等 O(1) 状态，
+ * 已确认的停留在 takeStops 之前暂存，百万点级别的轨迹内存占用与点数无关
+ * 停留识别：以候选开始的点为圆心，后续有效点都在 stopRadiusMeters 内时延续候选，
+ * 离开范围时若已持续 minStopSeconds 则确认为停留，然后以离开的点开始新的候选
+ * 分段距离使用 calculateDistance（球面模型），停留半径用候选圆心处的局部等距投影判断
+ * 非线程安全
+ */
+class TrajectoryAnalyzer {
+public:
+    explicit TrajectoryAnalyzer(const TrajectoryOptions& options = TrajectoryOptions());
+
+    void reset();
+
+    /**
+     * 追加一段轨迹
+     * @param timestamps 时间戳（秒），应单调不减，与 points 一一对应
+     * @param outSegments 可选（可为 nullptr），写入每个输入点的分段信息，至少 points.size() 项
+     */
+    void add(const double* timestamps, const CoordSpan& points, TrajectorySegment* outSegments = nullptr);
+
+    /**
+     * 轨迹结束：判定最后一个停留候选；之后继续 add 相当于接着同一条轨迹
+     */
+    void finish();
+
+    /**
+     * 取出已确认的停留（按时间顺序）并清空
+     */
+    std::vector<TrajectoryStop> takeStops();
+
+    TrajectorySummary summary() const;
+
+private:
+    struct StopCandidate {
+        double anchorLat;
+        double anchorLon;
+        double metersPerDegreeLon;
+        double startTime;
+        double endTime;
+        double sumLat;
+        double sumLonOffset;   // 相对 anchorLon 展开后的经度差之和
+        size_t firstIndex;
+        size_t lastIndex;
+        size_t count;
+    };
+
+    void accept(double time, double lat, double lon, size_t index);
+    void updateStop(double time, double lat, double lon, size_t index);
+    void closeStop();
+
+    TrajectoryOptions options;
+    TrajectorySummary stats;
+    BoundsAccumulator boundsAccumulator;
+    double movingDistance = 0.0;
+
+    bool hasLast = false;
+    double lastTime = 0.0;
+    double lastLat = 0.0;
+    double lastLon = 0.0;
+    double firstTime = 0.0;
+    double heading;
+
+    bool hasRejected = false;
+    double rejectedTime = 0.0;
+    double rejectedLat = 0.0;
+    double rejectedLon = 0.0;
+    int rejectedRun = 0;
+
+    bool hasCandidate = false;
+    StopCandidate candidate{};
+    std::vector<TrajectoryStop> stops;
+};
+
+}
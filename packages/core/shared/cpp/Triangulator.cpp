@@ -0,0 +1,556 @@
+#include "Triangulator.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace gaodemap {
+
+static constexpr double kTriangulatorEarthRadiusMeters = 6371000.0;
+static constexpr double kTriangulatorPi = 3.14159265358979323846;
+static constexpr uint32_t kTriangulatorNone = 0xFFFFFFFFu;
+// 顶点数超过该值时使用 z-order 索引
+static constexpr size_t kTriangulatorHashThreshold = 80;
+
+static inline bool triangulator_pointInTriangle(double ax, double ay, double bx, double by, double cx, double cy, double px, double py) {
+    return (cx - px) * (ay - py) >= (ax - px) * (cy - py) &&
+           (ax - px) * (by - py) >= (bx - px) * (ay - py) &&
+           (bx - px) * (cy - py) >= (cx - px) * (by - py);
+}
+
+static inline int triangulator_sign(double value) {
+    return (value > 0.0) - (value < 0.0);
+}
+
+// 16 位整数的二进制位交错展开
+static inline uint32_t triangulator_spread(uint32_t v) {
+    v = (v | (v << 8)) & 0x00FF00FFu;
+    v = (v | (v << 4)) & 0x0F0F0F0Fu;
+    v = (v | (v << 2)) & 0x33333333u;
+    v = (v | (v << 1)) & 0x55555555u;
+    return v;
+}
+
+double PolygonTriangulator::area(uint32_t p, uint32_t q, uint32_t r) const {
+    const Node& a = nodes[p];
+    const Node& b = nodes[q];
+    const Node& c = nodes[r];
+    return (b.y - a.y) * (c.x - b.x) - (b.x - a.x) * (c.y - b.y);
+}
+
+bool PolygonTriangulator::equals(uint32_t a, uint32_t b) const {
+    return nodes[a].x == nodes[b].x && nodes[a].y == nodes[b].y;
+}
+
+int32_t PolygonTriangulator::zOrder(double x, double y) const {
+    const uint32_t zx = triangulator_spread(static_cast<uint32_t>((x - minX) * invSize));
+    const uint32_t zy = triangulator_spread(static_cast<uint32_t>((y - minY) * invSize));
+    return static_cast<int32_t>(zx | (zy << 1));
+}
+
+// 在 last 之后插入一个节点，last 为 kTriangulatorNone 时新建环
+uint32_t PolygonTriangulator::insertNode(uint32_t index, uint32_t last) {
+    const uint32_t p = static_cast<uint32_t>(nodes.size());
+    nodes.push_back({index, xs[index], ys[index], p, p, kTriangulatorNone, kTriangulatorNone, 0, false});
+    if (last != kTriangulatorNone) {
+        Node& node = nodes[p];
+        node.next = nodes[last].next;
+        node.prev = last;
+        nodes[nodes[last].next].prev = p;
+        nodes[last].next = p;
+    }
+    return p;
+}
+
+void PolygonTriangulator::removeNode(uint32_t p) {
+    Node& node = nodes[p];
+    nodes[node.next].prev = node.prev;
+    nodes[node.prev].next = node.next;
+    if (node.prevZ != kTriangulatorNone) nodes[node.prevZ].nextZ = node.nextZ;
+    if (node.nextZ != kTriangulatorNone) nodes[node.nextZ].prevZ = node.prevZ;
+}
+
+// 按指定方向建立环形链表；clockwise 沿用 earcut 的屏幕坐标约定（y 向下），即经度向东、纬度向北时的逆时针
+// 外环逆时针、洞顺时针，切下的耳朵 (prev, ear, next) 均为逆时针
+uint32_t PolygonTriangulator::linkedList(size_t begin, size_t end, bool clockwise) {
+    double sum = 0.0;
+    for (size_t i = begin, j = end - 1; i < end; j = i++) {
+        sum += (xs[j] - xs[i]) * (ys[i] + ys[j]);
+    }
+    uint32_t last = kTriangulatorNone;
+    if (clockwise == (sum > 0.0)) {
+        for (size_t i = begin; i < end; ++i) last = insertNode(static_cast<uint32_t>(i), last);
+    } else {
+        for (size_t i = end; i-- > begin;) last = insertNode(static_cast<uint32_t>(i), last);
+    }
+    if (last != kTriangulatorNone && equals(last, nodes[last].next)) {
+        const uint32_t next = nodes[last].next;
+        removeNode(last);
+        last = next;
+    }
+    return last;
+}
+
+// 去掉重复点与共线点
+uint32_t PolygonTriangulator::filterPoints(uint32_t start, uint32_t end) {
+    if (start == kTriangulatorNone) return start;
+    if (end == kTriangulatorNone) end = start;
+    uint32_t p = start;
+    bool again;
+    do {
+        again = false;
+        const Node& node = nodes[p];
+        if (!node.steiner && (equals(p, node.next) || area(node.prev, p, node.next) == 0.0)) {
+            const uint32_t prev = node.prev;
+            removeNode(p);
+            p = end = prev;
+            if (p == nodes[p].next) break;
+            again = true;
+        } else {
+            p = node.next;
+        }
+    } while (again || p != end);
+    return end;
+}
+
+// 用对角线 a-b 把环拆成两个，返回新环中 b 的副本
+uint32_t PolygonTriangulator::splitPolygon(uint32_t a, uint32_t b) {
+    const uint32_t a2 = static_cast<uint32_t>(nodes.size());
+    const uint32_t b2 = a2 + 1;
+    nodes.push_back({nodes[a].index, nodes[a].x, nodes[a].y, kTriangulatorNone, kTriangulatorNone, kTriangulatorNone, kTriangulatorNone, 0, false});
+    nodes.push_back({nodes[b].index, nodes[b].x, nodes[b].y, kTriangulatorNone, kTriangulatorNone, kTriangulatorNone, kTriangulatorNone, 0, false});
+    const uint32_t an = nodes[a].next;
+    const uint32_t bp = nodes[b].prev;
+    nodes[a].next = b;
+    nodes[b].prev = a;
+    nodes[a2].next = an;
+    nodes[an].prev = a2;
+    nodes[b2].next = a2;
+    nodes[a2].prev = b2;
+    nodes[bp].next = b2;
+    nodes[b2].prev = bp;
+    return b2;
+}
+
+void PolygonTriangulator::emit(uint32_t a, uint32_t b, uint32_t c) {
+    output->push_back(nodes[a].index);
+    output->push_back(nodes[b].index);
+    output->push_back(nodes[c].index);
+}
+
+bool PolygonTriangulator::isEar(uint32_t ear) const {
+    const uint32_t a = nodes[ear].prev;
+    const uint32_t c = nodes[ear].next;
+    if (area(a, ear, c) >= 0.0) return false;   // 凹点或共线
+    const Node& na = nodes[a];
+    const Node& nb = nodes[ear];
+    const Node& nc = nodes[c];
+    const double x0 = std::min({na.x, nb.x, nc.x});
+    const double y0 = std::min({na.y, nb.y, nc.y});
+    const double x1 = std::max({na.x, nb.x, nc.x});
+    const double y1 = std::max({na.y, nb.y, nc.y});
+    for (uint32_t p = nc.next; p != a; p = nodes[p].next) {
+        const Node& np = nodes[p];
+        if (np.x >= x0 && np.x <= x1 && np.y >= y0 && np.y <= y1 &&
+            triangulator_pointInTriangle(na.x, na.y, nb.x, nb.y, nc.x, nc.y, np.x, np.y) &&
+            area(np.prev, p, np.next) >= 0.0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool PolygonTriangulator::isEarHashed(uint32_t ear) const {
+    const uint32_t a = nodes[ear].prev;
+    const uint32_t c = nodes[ear].next;
+    if (area(a, ear, c) >= 0.0) return false;
+    const Node& na = nodes[a];
+    const Node& nb = nodes[ear];
+    const Node& nc = nodes[c];
+    const double x0 = std::min({na.x, nb.x, nc.x});
+    const double y0 = std::min({na.y, nb.y, nc.y});
+    const double x1 = std::max({na.x, nb.x, nc.x});
+    const double y1 = std::max({na.y, nb.y, nc.y});
+    const int32_t minZ = zOrder(x0, y0);
+    const int32_t maxZ = zOrder(x1, y1);
+
+    auto blocks = [&](uint32_t p) {
+        const Node& np = nodes[p];
+        return np.x >= x0 && np.x <= x1 && np.y >= y0 && np.y <= y1 && p != a && p != c &&
+               triangulator_pointInTriangle(na.x, na.y, nb.x, nb.y, nc.x, nc.y, np.x, np.y) &&
+               area(np.prev, p, np.next) >= 0.0;
+    };
+    // 沿 z-order 链表向两侧查找包围盒内的点
+    uint32_t p = nb.prevZ;
+    uint32_t n = nb.nextZ;
+    while (p != kTriangulatorNone && nodes[p].z >= minZ && n != kTriangulatorNone && nodes[n].z <= maxZ) {
+        if (blocks(p) || blocks(n)) return false;
+        p = nodes[p].prevZ;
+        n = nodes[n].nextZ;
+    }
+    for (; p != kTriangulatorNone && nodes[p].z >= minZ; p = nodes[p].prevZ) {
+        if (blocks(p)) return false;
+    }
+    for (; n != kTriangulatorNone && nodes[n].z <= maxZ; n = nodes[n].nextZ) {
+        if (blocks(n)) return false;
+    }
+    return true;
+}
+
+// pass 0：正常切耳；1：先去掉重复点；2：再去掉局部自交；之后沿合法对角线拆分
+void PolygonTriangulator::earcutLinked(uint32_t ear, int pass) {
+    if (ear == kTriangulatorNone) return;
+    if (pass == 0 && invSize > 0.0) indexCurve(ear);
+    uint32_t stop = ear;
+    while (nodes[ear].prev != nodes[ear].next) {
+        const uint32_t prev = nodes[ear].prev;
+        const uint32_t next = nodes[ear].next;
+        if (invSize > 0.0 ? isEarHashed(ear) : isEar(ear)) {
+            emit(prev, ear, next);
+            removeNode(ear);
+            // 跳过下一个顶点，得到的三角形更均匀
+            ear = stop = nodes[next].next;
+            continue;
+        }
+        ear = next;
+        if (ear == stop) {
+            if (pass == 0) {
+                earcutLinked(filterPoints(ear, kTriangulatorNone), 1);
+            } else if (pass == 1) {
+                earcutLinked(cureLocalIntersections(filterPoints(ear, kTriangulatorNone)), 2);
+            } else {
+                splitEarcut(ear);
+            }
+            break;
+        }
+    }
+}
+
+uint32_t PolygonTriangulator::cureLocalIntersections(uint32_t start) {
+    uint32_t p = start;
+    do {
+        const uint32_t a = nodes[p].prev;
+        const uint32_t b = nodes[nodes[p].next].next;
+        if (!equals(a, b) && intersects(a, p, nodes[p].next, b) && locallyInside(a, b) && locallyInside(b, a)) {
+            emit(a, p, b);
+            removeNode(nodes[p].next);
+            removeNode(p);
+            p = start = b;
+        }
+        p = nodes[p].next;
+    } while (p != start);
+    return filterPoints(p, kTriangulatorNone);
+}
+
+void PolygonTriangulator::splitEarcut(uint32_t start) {
+    uint32_t a = start;
+    do {
+        for (uint32_t b = nodes[nodes[a].next].next; b != nodes[a].prev; b = nodes[b].next) {
+            if (nodes[a].index != nodes[b].index && isValidDiagonal(a, b)) {
+                uint32_t c = splitPolygon(a, b);
+                a = filterPoints(a, nodes[a].next);
+                c = filterPoints(c, nodes[c].next);
+                earcutLinked(a, 0);
+                earcutLinked(c, 0);
+                return;
+            }
+        }
+        a = nodes[a].next;
+    } while (a != start);
+}
+
+void PolygonTriangulator::indexCurve(uint32_t start) {
+    uint32_t p = start;
+    do {
+        Node& node = nodes[p];
+        if (node.z == 0) node.z = zOrder(node.x, node.y);
+        node.prevZ = node.prev;
+        node.nextZ = node.next;
+        p = node.next;
+    } while (p != start);
+    nodes[nodes[p].prevZ].nextZ = kTriangulatorNone;
+    nodes[p].prevZ = kTriangulatorNone;
+    sortLinked(p);
+}
+
+// z-order 链表的自底向上归并排序
+uint32_t PolygonTriangulator::sortLinked(uint32_t list) {
+    size_t inSize = 1;
+    size_t merges;
+    do {
+        uint32_t p = list;
+        uint32_t tail = kTriangulatorNone;
+        list = kTriangulatorNone;
+        merges = 0;
+        while (p != kTriangulatorNone) {
+            ++merges;
+            uint32_t q = p;
+            size_t pSize = 0;
+            for (size_t i = 0; i < inSize && q != kTriangulatorNone; ++i) {
+                ++pSize;
+                q = nodes[q].nextZ;
+            }
+            size_t qSize = inSize;
+            while (pSize > 0 || (qSize > 0 && q != kTriangulatorNone)) {
+                uint32_t e;
+                if (pSize != 0 && (qSize == 0 || q == kTriangulatorNone || nodes[p].z <= nodes[q].z)) {
+                    e = p;
+                    p = nodes[p].nextZ;
+                    --pSize;
+                } else {
+                    e = q;
+                    q = nodes[q].nextZ;
+                    --qSize;
+                }
+                if (tail != kTriangulatorNone) nodes[tail].nextZ = e;
+                else list = e;
+                nodes[e].prevZ = tail;
+                tail = e;
+            }
+            p = q;
+        }
+        nodes[tail].nextZ = kTriangulatorNone;
+        inSize *= 2;
+    } while (merges > 1);
+    return list;
+}
+
+uint32_t PolygonTriangulator::eliminateHoles(const std::vector<int>& ringOffsets, uint32_t outer) {
+    holeQueue.clear();
+    for (size_t r = 1; r + 1 < ringOffsets.size(); ++r) {
+        const size_t begin = static_cast<size_t>(ringOffsets[r]);
+        const size_t end = static_cast<size_t>(ringOffsets[r + 1]);
+        if (end <= begin) continue;
+        const uint32_t list = linkedList(begin, end, false);
+        if (list == kTriangulatorNone) continue;
+        if (list == nodes[list].next) nodes[list].steiner = true;
+        uint32_t leftmost = list;
+        uint32_t p = list;
+        do {
+            if (nodes[p].x < nodes[leftmost].x || (nodes[p].x == nodes[leftmost].x && nodes[p].y < nodes[leftmost].y)) leftmost = p;
+            p = nodes[p].next;
+        } while (p != list);
+        holeQueue.push_back(leftmost);
+    }
+    std::sort(holeQueue.begin(), holeQueue.end(), [this](uint32_t a, uint32_t b) { return nodes[a].x < nodes[b].x; });
+    // 由左到右并入洞，每个洞通过一条桥接边与外环相连
+    for (uint32_t hole : holeQueue) {
+        const uint32_t bridge = findHoleBridge(hole, outer);
+        if (bridge == kTriangulatorNone) continue;
+        const uint32_t bridgeReverse = splitPolygon(bridge, hole);
+        filterPoints(bridgeReverse, nodes[bridgeReverse].next);
+        outer = filterPoints(bridge, nodes[bridge].next);
+    }
+    return outer;
+}
+
+// 从洞的最左点向左发射线，找到外环上可以与之相连的顶点
+uint32_t PolygonTriangulator::findHoleBridge(uint32_t hole, uint32_t outer) const {
+    const double hx = nodes[hole].x;
+    const double hy = nodes[hole].y;
+    double qx = -std::numeric_limits<double>::infinity();
+    uint32_t m = kTriangulatorNone;
+    uint32_t p = outer;
+    do {
+        const Node& np = nodes[p];
+        const Node& nn = nodes[np.next];
+        if (hy <= np.y && hy >= nn.y && nn.y != np.y) {
+            const double x = np.x + (hy - np.y) * (nn.x - np.x) / (nn.y - np.y);
+            if (x <= hx && x > qx) {
+                qx = x;
+                m = np.x < nn.x ? p : np.next;
+                if (x == hx) return m;   // 洞的顶点恰好在外环的边上
+            }
+        }
+        p = np.next;
+    } while (p != outer);
+    if (m == kTriangulatorNone) return m;
+
+    // 射线交点与 m 之间若有外环顶点落在三角形内，取与射线夹角最小的那个
+    const uint32_t stop = m;
+    const double mx = nodes[m].x;
+    const double my = nodes[m].y;
+    double tanMin = std::numeric_limits<double>::infinity();
+    p = m;
+    do {
+        const Node& np = nodes[p];
+        if (hx >= np.x && np.x >= mx && hx != np.x &&
+            triangulator_pointInTriangle(hy < my ? hx : qx, hy, mx, my, hy < my ? qx : hx, hy, np.x, np.y)) {
+            const double tan = std::abs(hy - np.y) / (hx - np.x);
+            if (locallyInside(p, hole) &&
+                (tan < tanMin || (tan == tanMin && (np.x > nodes[m].x ||
+                    (np.x == nodes[m].x && area(nodes[m].prev, m, np.prev) < 0.0 && area(np.next, m, nodes[m].next) < 0.0))))) {
+                m = p;
+                tanMin = tan;
+            }
+        }
+        p = np.next;
+    } while (p != stop);
+    return m;
+}
+
+bool PolygonTriangulator::intersects(uint32_t p1, uint32_t q1, uint32_t p2, uint32_t q2) const {
+    auto onSegment = [this](uint32_t p, uint32_t q, uint32_t r) {
+        const Node& a = nodes[p];
+        const Node& b = nodes[q];
+        const Node& c = nodes[r];
+        return b.x <= std::max(a.x, c.x) && b.x >= std::min(a.x, c.x) && b.y <= std::max(a.y, c.y) && b.y >= std::min(a.y, c.y);
+    };
+    const int o1 = triangulator_sign(area(p1, q1, p2));
+    const int o2 = triangulator_sign(area(p1, q1, q2));
+    const int o3 = triangulator_sign(area(p2, q2, p1));
+    const int o4 = triangulator_sign(area(p2, q2, q1));
+    if (o1 != o2 && o3 != o4) return true;
+    if (o1 == 0 && onSegment(p1, p2, q1)) return true;
+    if (o2 == 0 && onSegment(p1, q2, q1)) return true;
+    if (o3 == 0 && onSegment(p2, p1, q2)) return true;
+    if (o4 == 0 && onSegment(p2, q1, q2)) return true;
+    return false;
+}
+
+bool PolygonTriangulator::intersectsPolygon(uint32_t a, uint32_t b) const {
+    const uint32_t ia = nodes[a].index;
+    const uint32_t ib = nodes[b].index;
+    uint32_t p = a;
+    do {
+        const uint32_t next = nodes[p].next;
+        if (nodes[p].index != ia && nodes[next].index != ia && nodes[p].index != ib && nodes[next].index != ib &&
+            intersects(p, next, a, b)) {
+            return true;
+        }
+        p = next;
+    } while (p != a);
+    return false;
+}
+
+// 对角线 a-b 在 a 处是否位于多边形内侧
+bool PolygonTriangulator::locallyInside(uint32_t a, uint32_t b) const {
+    const uint32_t prev = nodes[a].prev;
+    const uint32_t next = nodes[a].next;
+    return area(prev, a, next) < 0.0
+        ? area(a, b, next) >= 0.0 && area(a, prev, b) >= 0.0
+        : area(a, b, prev) < 0.0 || area(a, next, b) < 0.0;
+}
+
+bool PolygonTriangulator::middleInside(uint32_t a, uint32_t b) const {
+    const double px = (nodes[a].x + nodes[b].x) * 0.5;
+    const double py = (nodes[a].y + nodes[b].y) * 0.5;
+    bool inside = false;
+    uint32_t p = a;
+    do {
+        const Node& np = nodes[p];
+        const Node& nn = nodes[np.next];
+        if ((np.y > py) != (nn.y > py) && nn.y != np.y && px < (nn.x - np.x) * (py - np.y) / (nn.y - np.y) + np.x) {
+            inside = !inside;
+        }
+        p = np.next;
+    } while (p != a);
+    return inside;
+}
+
+bool PolygonTriangulator::isValidDiagonal(uint32_t a, uint32_t b) const {
+    const Node& na = nodes[a];
+    const Node& nb = nodes[b];
+    if (nodes[na.next].index == nb.index || nodes[na.prev].index == nb.index || intersectsPolygon(a, b)) return false;
+    if (locallyInside(a, b) && locallyInside(b, a) && middleInside(a, b) &&
+        (area(na.prev, a, nb.prev) != 0.0 || area(a, nb.prev, b) != 0.0)) {
+        return true;
+    }
+    // 重合的顶点（洞与外环接触处）两侧都为凸角时也可以拆分
+    return equals(a, b) && area(na.prev, a, na.next) > 0.0 && area(nb.prev, b, nb.next) > 0.0;
+}
+
+bool PolygonTriangulator::triangulate(const CoordSpan& points, const std::vector<int>& ringOffsets, PolygonTriangulation& result) {
+    result.indices.clear();
+    result.areaSquareMeters = 0.0;
+    result.centroid = {0.0, 0.0};
+    const size_t n = points.size();
+    if (n < 3 || n >= kTriangulatorNone / 4) return false;
+    const std::vector<int> wholeRing = {0, static_cast<int>(n)};
+    const std::vector<int>& rings = ringOffsets.empty() ? wholeRing : ringOffsets;
+    if (rings.size() < 2 || rings.front() != 0 || static_cast<size_t>(rings.back()) != n) return false;
+    for (size_t r = 0; r + 1 < rings.size(); ++r) {
+        if (rings[r] > rings[r + 1]) return false;
+    }
+
+    // 等面积圆柱投影，经度以第一个点为参考展开
+    const double referenceLon = points.lonAt(0);
+    xs.resize(n);
+    ys.resize(n);
+    for (size_t i = 0; i < n; ++i) {
+        const double lat = points.latAt(i);
+        const double lon = points.lonAt(i);
+        if (!std::isfinite(lat) || !std::isfinite(lon)) return false;
+        xs[i] = kTriangulatorEarthRadiusMeters * std::remainder(lon - referenceLon, 360.0) * kTriangulatorPi / 180.0;
+        ys[i] = kTriangulatorEarthRadiusMeters * std::sin(lat * kTriangulatorPi / 180.0);
+    }
+
+    nodes.clear();
+    nodes.reserve(n * 3 / 2 + 16);
+    output = &result.indices;
+    result.indices.reserve((n + 2 * (rings.size() - 2)) * 3);
+    uint32_t outer = linkedList(static_cast<size_t>(rings[0]), static_cast<size_t>(rings[1]), true);
+    if (outer == kTriangulatorNone || nodes[outer].next == nodes[outer].prev) return false;
+    if (rings.size() > 2) outer = eliminateHoles(rings, outer);
+
+    invSize = 0.0;
+    if (n > kTriangulatorHashThreshold) {
+        minX = *std::min_element(xs.begin(), xs.end());
+        minY = *std::min_element(ys.begin(), ys.end());
+        const double size = std::max(*std::max_element(xs.begin(), xs.end()) - minX, *std::max_element(ys.begin(), ys.end()) - minY);
+        invSize = size > 0.0 ? 32767.0 / size : 0.0;
+    }
+    earcutLinked(outer, 0);
+    output = nullptr;
+
+    // 三角形的面积与面积加权质心
+    double totalArea = 0.0;
+    double sumX = 0.0;
+    double sumY = 0.0;
+    const auto& indices = result.indices;
+    for (size_t t = 0; t + 2 < indices.size(); t += 3) {
+        const uint32_t a = indices[t];
+        const uint32_t b = indices[t + 1];
+        const uint32_t c = indices[t + 2];
+        const double doubled = (xs[b] - xs[a]) * (ys[c] - ys[a]) - (xs[c] - xs[a]) * (ys[b] - ys[a]);
+        totalArea += doubled;
+        sumX += doubled * (xs[a] + xs[b] + xs[c]);
+        sumY += doubled * (ys[a] + ys[b] + ys[c]);
+    }
+    result.areaSquareMeters = std::abs(totalArea) * 0.5;
+    double cx = 0.0;
+    double cy = 0.0;
+    if (totalArea != 0.0) {
+        cx = sumX / (3.0 * totalArea);
+        cy = sumY / (3.0 * totalArea);
+    } else {
+        for (size_t i = 0; i < n; ++i) {
+            cx += xs[i];
+            cy += ys[i];
+        }
+        cx /= static_cast<double>(n);
+        cy /= static_cast<double>(n);
+    }
+    double lon = referenceLon + cx / kTriangulatorEarthRadiusMeters * 180.0 / kTriangulatorPi;
+    if (lon > 180.0) lon -= 360.0;
+    if (lon < -180.0) lon += 360.0;
+    const double sinLat = std::clamp(cy / kTriangulatorEarthRadiusMeters, -1.0, 1.0);
+    result.centroid = {std::asin(sinLat) * 180.0 / kTriangulatorPi, lon};
+    return !result.indices.empty();
+}
+
+PolygonTriangulation triangulatePolygon(const CoordSpan& points, const std::vector<int>& ringOffsets) {
+    PolygonTriangulation result;
+    PolygonTriangulator().triangulate(points, ringOffsets, result);
+    return result;
+}
+
+PolygonTriangulation triangulatePolygon(const PolylineRings& rings) {
+    return triangulatePolygon(CoordSpan(rings.points), rings.ringOffsets);
+}
+
+PolygonTriangulation triangulatePolygon(const std::vector<GeoPoint>& polygon) {
+    return triangulatePolygon(CoordSpan(polygon), {});
+}
+
+}
@@ -0,0 +1,93 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "GeometryEngine.hpp"
+
+namespace gaodemap {
+
+struct PolygonTriangulation {
+    std::vector<uint32_t> indices;   // 每 3 个为一个三角形，指向输入点的下标，逆时针（经度向东、纬度向北）
+    double areaSquareMeters = 0.0;   // 外环面积减去洞的面积
+    GeoPoint centroid{0.0, 0.0};     // 面积加权质心，退化（面积为 0）时为顶点平均值
+};
+
+/**
+ * 多边形三角剖分（earcut 耳切法，支持洞）
+ *
+ * 输入与 PolylineRings 相同：第一个环为外环，其余为洞，环的方向不限，首尾重复点会被忽略。
+ * 顶点超过 80 个时按 z-order 曲线索引，判断耳朵时只检查三角形包围盒内的顶点。
+ * 洞按最左顶点由左到右依次用桥接边并入外环，之后逐个切耳；遇到自交等无法切耳的情况，
+ * 依次尝试去掉局部自交、沿合法对角线拆分，保证输出覆盖整个多边形。
+ *
+ * 剖分在 Lambert 等面积圆柱投影（x = R·Δλ，y = R·sinφ）中进行，同一趟遍历三角形得到面积与质心：
+ * 面积与 calculatePolygonArea（球面模型）的公式一致，并正确扣除洞；质心为投影平面上的面积加权质心。
+ * 三角形下标可直接作为自定义 GL 覆盖物的索引缓冲区。
+ *
+ * 内部节点缓冲区在多次调用间复用；非线程安全
+ */
+class PolygonTriangulator {
+public:
+    /**
+     * @param points 所有环的坐标，按环顺序连续存放
+     * @param ringOffsets 每个环的起始下标，末尾额外追加 points.size()；为空时整个 points 作为一个环
+     * @return 是否得到了至少一个三角形
+     */
+    bool triangulate(const CoordSpan& points, const std::vector<int>& ringOffsets, PolygonTriangulation& result);
+
+private:
+    struct Node {
+        uint32_t index;       // 输入点下标
+        double x;
+        double y;
+        uint32_t prev;
+        uint32_t next;
+        uint32_t prevZ;       // z-order 链表
+        uint32_t nextZ;
+        int32_t z;
+        bool steiner;         // 只有一个点的洞
+    };
+
+    uint32_t linkedList(size_t begin, size_t end, bool clockwise);
+    uint32_t insertNode(uint32_t index, uint32_t last);
+    void removeNode(uint32_t p);
+    uint32_t splitPolygon(uint32_t a, uint32_t b);
+    uint32_t filterPoints(uint32_t start, uint32_t end);
+    uint32_t eliminateHoles(const std::vector<int>& ringOffsets, uint32_t outer);
+    uint32_t findHoleBridge(uint32_t hole, uint32_t outer) const;
+    void earcutLinked(uint32_t ear, int pass);
+    bool isEar(uint32_t ear) const;
+    bool isEarHashed(uint32_t ear) const;
+    uint32_t cureLocalIntersections(uint32_t start);
+    void splitEarcut(uint32_t start);
+    void indexCurve(uint32_t start);
+    uint32_t sortLinked(uint32_t list);
+    int32_t zOrder(double x, double y) const;
+    double area(uint32_t p, uint32_t q, uint32_t r) const;
+    bool equals(uint32_t a, uint32_t b) const;
+    bool intersects(uint32_t p1, uint32_t q1, uint32_t p2, uint32_t q2) const;
+    bool intersectsPolygon(uint32_t a, uint32_t b) const;
+    bool locallyInside(uint32_t a, uint32_t b) const;
+    bool middleInside(uint32_t a, uint32_t b) const;
+    bool isValidDiagonal(uint32_t a, uint32_t b) const;
+    void emit(uint32_t a, uint32_t b, uint32_t c);
+
+    std::vector<Node> nodes;
+    std::vector<double> xs;        // 投影坐标（米）
+    std::vector<double> ys;
+    std::vector<uint32_t> holeQueue;
+    std::vector<uint32_t>* output = nullptr;
+    double minX = 0.0;
+    double minY = 0.0;
+    double invSize = 0.0;          // z-order 坐标缩放，0 表示不使用 z-order 索引
+};
+
+/**
+ * 一次性三角剖分，等价于 PolygonTriangulator().triangulate(...)
+ */
+PolygonTriangulation triangulatePolygon(const CoordSpan& points, const std::vector<int>& ringOffsets);
+PolygonTriangulation triangulatePolygon(const PolylineRings& rings);
+PolygonTriangulation triangulatePolygon(const std::vector<GeoPoint>& polygon);
+
+}
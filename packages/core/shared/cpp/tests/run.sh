@@ -8,10 +8,20 @@ clang++ -std=c++17 \
     ../ColorParser.cpp \
     ../ClusterEngine.cpp \
     ../QuadTree.cpp \
+    ../HeatmapRasterizer.cpp \
+    ../HeatmapAccumulator.cpp \
+    ../CellId.cpp \
+    ../CollisionEngine.cpp \
+    ../Geodesic.cpp \
+    ../PolygonClipper.cpp \
+    ../Triangulator.cpp \
+    ../TrajectoryAnalyzer.cpp \
+    ../GpsSmoother.cpp \
+    ../PathSimilarity.cpp \
     -o test_runner
 
-# Run the test
-./test_runner
+# Run the test（传入 --bench 时同时运行基准）
+./test_runner "$@"
 
 # Clean up
 rm test_runner
@@ -5,11 +5,23 @@
 #include <iomanip>
 #include <algorithm>
 #include <chrono>
+#include <map>
+#include <limits>
 
 #include "../GeometryEngine.hpp"
 #include "../ColorParser.hpp"
 #include "../QuadTree.hpp"
 #include "../ClusterEngine.hpp"
+#include "../HeatmapRasterizer.hpp"
+#include "../HeatmapAccumulator.hpp"
+#include "../CellId.hpp"
+#include "../CollisionEngine.hpp"
+#include "../Geodesic.hpp"
+#include "../PolygonClipper.hpp"
+#include "../Triangulator.hpp"
+#include "../TrajectoryAnalyzer.hpp"
+#include "../GpsSmoother.hpp"
+#include "../PathSimilarity.hpp"
 
 using namespace gaodemap;
 
@@ -39,6 +51,101 @@ void testDistance() {
     std::cout << "PASSED" << std::endl;
 }
 
+void testEllipsoidDistance() {
+    std::cout << "Running testEllipsoidDistance..." << std::endl;
+    // 参考值：GeographicLib (Karney) WGS-84 反解
+    struct Case { double lat1, lon1, lat2, lon2, meters; };
+    const Case cases[] = {
+        {39.9042, 116.4074, 31.2304, 121.4737, 1065846.4894532142},   // 北京 - 上海
+        {39.9042, 116.4074, 39.9142, 116.4174, 1401.4180188025557},   // 短线段（切平面近似）
+        {-33.8688, 151.2093, 51.5074, -0.1278, 16989295.77054045},    // 悉尼 - 伦敦
+        {0.0, 0.0, 0.5, 179.7, 19944127.420750458},                  // 近对跖点，Vincenty 不收敛
+        {0.0, 0.0, 0.0, 180.0, 20003931.458625447},                  // 赤道对跖点，测地线经过两极
+        {30.0, 10.0, -30.0, -170.0, 20003931.458625447},
+        {89.9, 0.0, -89.9, 180.0, 20003931.458625447},
+        {10.0, 0.0, -10.0, 179.5, 19980861.908890963},
+    };
+    for (const Case& c : cases) {
+        const double d = calculateDistance(c.lat1, c.lon1, c.lat2, c.lon2, EarthModel::WGS84);
+        assert(approxEqual(d, c.meters, 1e-4));
+        assert(approxEqual(Geodesic::WGS84().distance(c.lat1, c.lon1, c.lat2, c.lon2), c.meters, 1e-6));
+        // 对称
+        assert(approxEqual(calculateDistance(c.lat2, c.lon2, c.lat1, c.lon1, EarthModel::WGS84), c.meters, 1e-4));
+    }
+    assert(calculateDistance(39.9, 116.4, 39.9, 116.4, EarthModel::WGS84) == 0.0);
+    // 球面与椭球在北京 - 上海上相差约 0.1%
+    const double sphere = calculateDistance(39.9042, 116.4074, 31.2304, 121.4737, EarthModel::Sphere);
+    assert(sphere == calculateDistance(39.9042, 116.4074, 31.2304, 121.4737));
+    assert(std::abs(sphere - 1065846.49) > 100.0 && std::abs(sphere - 1065846.49) < 2000.0);
+
+    // 未传入地球模型的重载始终为球面
+    assert(calculatePathLength(CoordSpan(std::vector<GeoPoint>{{39.9042, 116.4074}, {31.2304, 121.4737}})) == sphere);
+
+    // 批量接口与逐点结果一致，非有限坐标输出 NaN
+    const double nan = std::numeric_limits<double>::quiet_NaN();
+    std::vector<GeoPoint> from = {{39.9042, 116.4074}, {nan, 0.0}, {0.0, 0.0}, {-33.8688, 151.2093}};
+    std::vector<GeoPoint> to = {{31.2304, 121.4737}, {1.0, 1.0}, {0.5, 179.7}, {51.5074, -0.1278}};
+    double out[4];
+    for (EarthModel model : {EarthModel::Sphere, EarthModel::WGS84}) {
+        calculateDistances(CoordSpan(from), CoordSpan(to), out, model);
+        assert(std::isnan(out[1]));
+        for (int i : {0, 2, 3}) {
+            assert(out[i] == calculateDistance(from[i].lat, from[i].lon, to[i].lat, to[i].lon, model));
+        }
+        calculateDistancesFrom(39.9042, 116.4074, CoordSpan(to), out, model);
+        for (int i = 0; i < 4; ++i) {
+            assert(approxEqual(out[i], calculateDistance(39.9042, 116.4074, to[i].lat, to[i].lon, model), 1e-6));
+        }
+    }
+
+    // 路径长度：切平面近似的短线段累加与 Vincenty 逐段一致
+    std::vector<GeoPoint> track;
+    uint32_t seed = 99;
+    double lat = 39.9, lon = 116.4;
+    for (int i = 0; i < 2000; ++i) {
+        seed = seed * 1664525u + 1013904223u;
+        lat += ((seed >> 8) / static_cast<double>(1u << 24) - 0.5) * 0.002;
+        seed = seed * 1664525u + 1013904223u;
+        lon += ((seed >> 8) / static_cast<double>(1u << 24) - 0.5) * 0.002;
+        track.push_back({lat, lon});
+    }
+    double expected = 0.0;
+    for (size_t i = 0; i + 1 < track.size(); ++i) {
+        expected += Geodesic::WGS84().distance(track[i].lat, track[i].lon, track[i + 1].lat, track[i + 1].lon);
+    }
+    assert(approxEqual(calculatePathLength(CoordSpan(track), EarthModel::WGS84), expected, 1e-3));
+
+    // 面积：北半球为椭球表面积的一半 (WGS-84 表面积 510065621.724 km²)
+    std::vector<GeoPoint> hemisphere = {{0.0, -180.0}, {0.0, 180.0}, {90.0, 180.0}, {90.0, -180.0}};
+    assert(std::abs(calculatePolygonArea(CoordSpan(hemisphere), EarthModel::WGS84) / 255032810862044.22 - 1.0) < 1e-12);
+    std::vector<GeoPoint> block = {{39.90, 116.30}, {39.90, 116.40}, {39.95, 116.40}, {39.95, 116.30}};
+    const double sphereArea = calculatePolygonArea(CoordSpan(block), EarthModel::Sphere);
+    const double ellipsoidArea = calculatePolygonArea(CoordSpan(block), EarthModel::WGS84);
+    assert(sphereArea == calculatePolygonArea(block));
+    assert(std::abs(ellipsoidArea / sphereArea - 1.0) < 0.005 && ellipsoidArea != sphereArea);
+
+    // 基准：短线段路径长度（常见负载）
+    std::vector<GeoPoint> longTrack;
+    for (int i = 0; i < 500000; ++i) {
+        seed = seed * 1664525u + 1013904223u;
+        lat += ((seed >> 8) / static_cast<double>(1u << 24) - 0.5) * 0.001;
+        seed = seed * 1664525u + 1013904223u;
+        lon += ((seed >> 8) / static_cast<double>(1u << 24) - 0.5) * 0.001;
+        longTrack.push_back({lat, lon});
+    }
+    auto t0 = std::chrono::high_resolution_clock::now();
+    volatile double sink = calculatePathLength(CoordSpan(longTrack), EarthModel::Sphere);
+    auto t1 = std::chrono::high_resolution_clock::now();
+    sink = calculatePathLength(CoordSpan(longTrack), EarthModel::WGS84);
+    auto t2 = std::chrono::high_resolution_clock::now();
+    (void)sink;
+    std::cout << "  path length (" << longTrack.size() << " points): haversine "
+              << std::chrono::duration<double, std::milli>(t1 - t0).count() << " ms, WGS-84 "
+              << std::chrono::duration<double, std::milli>(t2 - t1).count() << " ms" << std::endl;
+
+    std::cout << "PASSED" << std::endl;
+}
+
 void testColorParser() {
     std::cout << "Running testColorParser..." << std::endl;
     
@@ -64,6 +171,132 @@ void testColorParser() {
     assert(parseColor("#XYZ") == 0);
     assert(parseColor("") == 0);
 
+    // 命名颜色：完整 CSS 列表、不区分大小写，与旧版本重名的颜色取值不变
+    assert(parseColor("AliceBlue") == 0xFFF0F8FF);
+    assert(parseColor("rebeccapurple") == 0xFF663399);
+    assert(parseColor("lightgoldenrodyellow") == 0xFFFAFAD2);
+    assert(parseColor("lime") == 0xFF00FF00);
+    assert(parseColor("green") == 0xFF00FF00);
+    assert(parseColor("grey") == 0xFF888888);
+    assert(parseColor("  Tan ") == 0xFFD2B48C);
+    assert(parseColor("reds") == 0);
+    assert(parseColor("re d") == 0);
+    assert(parseColor("lightgoldenrodyellows") == 0);
+
+    // tryParseColor 区分 transparent 与解析失败
+    uint32_t color = 1;
+    assert(tryParseColor("transparent", color) && color == 0);
+    color = 1;
+    assert(!tryParseColor("bogus", color) && color == 1);
+    assert(!tryParseColor("   ", color));
+
+    // 十六进制
+    assert(parseColor("#F00") == 0xFFFF0000);
+    assert(parseColor("#F008") == 0x88FF0000);
+    assert(parseColor("#FF000080") == 0x80FF0000);
+    assert(parseColor("#12345678") == 0x78123456);
+    assert(parseColor("00ff00") == 0xFF00FF00);
+    assert(parseColor("#FF00000") == 0);
+    assert(parseColor("#GG0000") == 0);
+    assert(parseColor("#") == 0);
+
+    // 函数格式：空白、大小写、截断与限幅，非法输入不抛异常
+    assert(parseColor(" rgb( 1 , 2 , 3 ) ") == 0xFF010203);
+    assert(parseColor("RGBA(255,0,0,1)") == 0xFFFF0000);
+    assert(parseColor("rgba(0,0,255,0)") == 0x000000FF);
+    assert(parseColor("rgb(300,-5,12.7)") == 0xFFFF000D);
+    assert(parseColor("rgba(0,0,0,5e-1)") == 0x80000000);
+    assert(parseColor("rgb(1,2,3,0.5)") == 0x80010203);
+    assert(parseColor("rgb(1,2)") == 0);
+    assert(parseColor("rgb(1,2,x)") == 0);
+    assert(parseColor("rgba(1,2,3,0.5") == 0);
+    assert(parseColor("rgb(1,2,3) junk") == 0);
+    assert(parseColor("rgb") == 0);
+
+    // CSS Color 4：百分比、空格分隔语法、/ 透明度、none
+    assert(parseColor("rgb(100%, 0%, 50%)") == 0xFFFF0080);
+    assert(parseColor("rgb(255 0 0 / 50%)") == 0x80FF0000);
+    assert(parseColor("rgba(0 0 255 / 0.25)") == 0x400000FF);
+    assert(parseColor("rgb(none 255 none)") == 0xFF00FF00);
+    assert(parseColor("rgb(1 2, 3)") == 0);
+    assert(parseColor("rgb(1, 2 3)") == 0);
+    assert(parseColor("rgb(1 2 3, 0.5)") == 0);
+    assert(parseColor("rgb(1, 2, 3 / 0.5)") == 0);
+    assert(parseColor("rgb(10deg 0 0)") == 0);
+
+    // hsl / hsla：角度单位、色相取模
+    assert(parseColor("hsl(0, 100%, 50%)") == 0xFFFF0000);
+    assert(parseColor("hsl(120deg 100% 25%)") == 0xFF008000);
+    assert(parseColor("hsla(240, 100%, 50%, 0.5)") == 0x800000FF);
+    assert(parseColor("HSL(0.5turn 100% 50% / 25%)") == 0x4000FFFF);
+    assert(parseColor("hsl(200grad 100% 50%)") == 0xFF00FFFF);
+    assert(parseColor("hsl(3.14159265rad 100% 50%)") == 0xFF00FFFF);
+    assert(parseColor("hsl(-120, 100%, 50%)") == 0xFF0000FF);
+    assert(parseColor("hsl(480 100 50)") == 0xFF00FF00);
+    assert(parseColor("hsl(0 0% 50%)") == 0xFF808080);
+    assert(parseColor("hsl(10%, 50%, 50%)") == 0);
+    assert(parseColor("hsl(0 50% 50% / )") == 0);
+    assert(parseColor("hsl(0 50% 50%") == 0);
+
+    // hwb：白度与黑度之和超过 100% 时为灰色
+    assert(parseColor("hwb(0 0% 0%)") == 0xFFFF0000);
+    assert(parseColor("hwb(120 20% 30%)") == 0xFF33B333);
+    assert(parseColor("hwb(0 60% 60% / 0)") == 0x00808080);
+
+    // 解析缓存：重复解析、淘汰后重新解析与超长字符串的结果不变
+    const uint32_t cached = parseColor("hsla(210, 50%, 40%, 0.75)");
+    assert(cached == parseColor("hsla(210, 50%, 40%, 0.75)"));
+    for (int i = 0; i < 300; ++i) {
+        const std::string value = "rgb(" + std::to_string(i % 256) + ", 0, " + std::to_string(i / 256) + ")";
+        assert(parseColor(value) == (0xFF000000u | (static_cast<uint32_t>(i % 256) << 16) | static_cast<uint32_t>(i / 256)));
+    }
+    assert(parseColor("hsla(210, 50%, 40%, 0.75)") == cached);
+    assert(parseColor("rgba(  255  ,  255  ,  255  ,  0.50000000  )") == 0x80FFFFFF);
+    color = 1;
+    assert(!tryParseColor("rgb(1 2)", color) && !tryParseColor("rgb(1 2)", color) && color == 1);
+
+    std::cout << "PASSED" << std::endl;
+}
+
+void benchmarkColorParser() {
+    std::cout << "Running benchmarkColorParser..." << std::endl;
+
+    const std::vector<std::string> inputs = {
+        "red", "#FF0000", "rgba(255, 0, 0, 0.5)", "cornflowerblue", "#3c9", "rgb(12, 34, 56)",
+        "LightSlateGray", "#12345680", "transparent", "notacolor", "hsl(210 50% 40% / 0.75)"
+    };
+    const int rounds = 200000;
+    uint32_t sink = 0;
+    auto t0 = std::chrono::high_resolution_clock::now();
+    for (int round = 0; round < rounds; ++round) {
+        for (const std::string& input : inputs) {
+            sink ^= parseColor(input);
+        }
+    }
+    auto t1 = std::chrono::high_resolution_clock::now();
+
+    // 互不相同的函数格式字符串，超过缓存容量，每次都完整解析
+    std::vector<std::string> uncached;
+    for (int i = 0; i < 1024; ++i) {
+        uncached.push_back("hsla(" + std::to_string(i % 360) + ", " + std::to_string(i % 101) + "%, 50%, 0.5)");
+    }
+    const int uncachedRounds = 200;
+    auto t2 = std::chrono::high_resolution_clock::now();
+    for (int round = 0; round < uncachedRounds; ++round) {
+        for (const std::string& input : uncached) {
+            sink ^= parseColor(input);
+        }
+    }
+    auto t3 = std::chrono::high_resolution_clock::now();
+    (void)sink;
+
+    const double parses = static_cast<double>(rounds) * inputs.size();
+    const double uncachedParses = static_cast<double>(uncachedRounds) * uncached.size();
+    std::cout << "  " << static_cast<size_t>(parses) << " parses: "
+              << std::chrono::duration<double, std::nano>(t1 - t0).count() / parses << " ns/parse, "
+              << static_cast<size_t>(uncachedParses) << " distinct hsla: "
+              << std::chrono::duration<double, std::nano>(t3 - t2).count() / uncachedParses << " ns/parse" << std::endl;
+
     std::cout << "PASSED" << std::endl;
 }
 
@@ -94,6 +327,74 @@ void testPointInPolygon() {
     std::cout << "PASSED" << std::endl;
 }
 
+void testPointsInPolygon() {
+    std::cout << "Running testPointsInPolygon..." << std::endl;
+    auto bit = [](const std::vector<uint64_t>& bits, size_t i) { return ((bits[i >> 6] >> (i & 63)) & 1) != 0; };
+
+    // 1. 与逐点判断一致（含包围盒外、NaN）
+    std::vector<GeoPoint> triangle = {{0, 0}, {2, 0}, {1, 2}};
+    std::vector<GeoPoint> probes = {{1, 1}, {1, 2.1}, {0.5, 0.2}, {-1, 0.5}, {3, 3}, {std::nan(""), 1.0}};
+    std::vector<uint64_t> bits(1, ~uint64_t(0));
+    assert(pointsInPolygon(CoordSpan(triangle), CoordSpan(probes), bits.data()) == 2);
+    for (size_t i = 0; i < probes.size(); ++i) {
+        assert(bit(bits, i) == isPointInPolygon(probes[i].lat, probes[i].lon, triangle));
+    }
+    // 其余位被清零
+    assert((bits[0] >> probes.size()) == 0);
+
+    // 2. 多环：洞内的点不算在内
+    std::vector<GeoPoint> withHole = {{0, 0}, {10, 0}, {10, 10}, {0, 10}, {4, 4}, {6, 4}, {6, 6}, {4, 6}};
+    std::vector<GeoPoint> holeProbes = {{5, 5}, {2, 2}, {8, 5}, {11, 5}};
+    assert(pointsInPolygon(CoordSpan(withHole), std::vector<int>({0, 4, 8}), CoordSpan(holeProbes), bits.data()) == 2);
+    assert(!bit(bits, 0) && bit(bits, 1) && bit(bits, 2) && !bit(bits, 3));
+
+    // 3. 退化的围栏
+    assert(pointsInPolygon(CoordSpan(std::vector<GeoPoint>{{0, 0}, {1, 1}}), CoordSpan(probes), bits.data()) == 0);
+    assert(bits[0] == 0);
+
+    // 4. 配送区：2000 顶点的星形围栏、100,000 个随机点，与逐点判断逐位比较
+    const size_t fenceCount = 2000;
+    std::vector<GeoPoint> fence;
+    uint32_t seed = 2024;
+    auto next = [&seed]() {
+        seed = seed * 1664525u + 1013904223u;
+        return (seed >> 8) / 16777216.0;
+    };
+    for (size_t i = 0; i < fenceCount; ++i) {
+        const double angle = 2.0 * 3.14159265358979323846 * i / fenceCount;
+        const double r = 0.05 * (1.0 + 0.3 * std::sin(angle * 7.0) + 0.05 * next());
+        fence.push_back({39.9 + r * std::sin(angle), 116.4 + r * std::cos(angle)});
+    }
+    const size_t pointCount = 100000;
+    std::vector<double> lats(pointCount), lons(pointCount);
+    for (size_t i = 0; i < pointCount; ++i) {
+        lats[i] = 39.9 + (next() - 0.5) * 0.16;
+        lons[i] = 116.4 + (next() - 0.5) * 0.16;
+    }
+    const CoordSpan points(lats.data(), lons.data(), pointCount);
+    std::vector<uint64_t> fenceBits((pointCount + 63) / 64);
+
+    auto t0 = std::chrono::high_resolution_clock::now();
+    size_t scalarInside = 0;
+    std::vector<uint8_t> expected(pointCount);
+    for (size_t i = 0; i < pointCount; ++i) {
+        expected[i] = isPointInPolygon(lats[i], lons[i], fence) ? 1 : 0;
+        scalarInside += expected[i];
+    }
+    auto t1 = std::chrono::high_resolution_clock::now();
+    const size_t batchInside = pointsInPolygon(CoordSpan(fence), points, fenceBits.data());
+    auto t2 = std::chrono::high_resolution_clock::now();
+
+    assert(batchInside == scalarInside && batchInside > pointCount / 4);
+    for (size_t i = 0; i < pointCount; ++i) {
+        assert(bit(fenceBits, i) == (expected[i] != 0));
+    }
+    std::cout << "100,000 points vs 2000-vertex fence: per-point " << std::chrono::duration<double, std::milli>(t1 - t0).count()
+              << " ms, batch " << std::chrono::duration<double, std::milli>(t2 - t1).count() << " ms (" << batchInside << " inside)" << std::endl;
+
+    std::cout << "PASSED" << std::endl;
+}
+
 void testGeometryEngineExtended() {
     std::cout << "Running testGeometryEngineExtended..." << std::endl;
 
@@ -166,6 +467,84 @@ void testGeometryEngineExtended() {
     assert(parsePolyline("invalid").empty());
     // Test trailing semicolon
     assert(parsePolyline("116.4074,39.9042;").size() == 1);
+    // Test invalid pair is skipped
+    assert(parsePolyline("116.4074,39.9042;abc,def;116.4191,39.9042").size() == 2);
+    // Trailing garbage inside a token is rejected (matches the JS parser), whitespace is allowed
+    assert(parsePolyline("116.1abc,39.9;116.2,39.9xyz;116.3,39.9").size() == 1);
+    assert(parsePolyline(" 116.1 , 39.9 ;116.2,39.9,12").size() == 2);
+
+    // 9.1 parsePolylineRings
+    auto rings = parsePolylineRings("116.1,39.1;116.1,39.1;116.2,39.2|116.15,39.15;116.16,39.16||");
+    assert(rings.ringOffsets.size() == 3); // 2 rings + sentinel
+    assert(rings.ringOffsets[0] == 0);
+    assert(rings.ringOffsets[1] == 2);     // duplicate point removed
+    assert(rings.ringOffsets[2] == 4);
+    assert(rings.points.size() == 4);
+    assert(approxEqual(rings.points[2].lat, 39.15));
+    assert(approxEqual(rings.points[2].lon, 116.15));
+
+    auto rawRings = parsePolylineRings("116.1,39.1;116.1,39.1", false);
+    assert(rawRings.points.size() == 2);
+    // Duplicates across ring boundaries are kept
+    auto boundaryRings = parsePolylineRings("116.1,39.1|116.1,39.1");
+    assert(boundaryRings.points.size() == 2);
+    assert(boundaryRings.ringOffsets.size() == 3);
+
+    auto emptyRings = parsePolylineRings("");
+    assert(emptyRings.points.empty());
+    assert(emptyRings.ringOffsets.size() == 1 && emptyRings.ringOffsets[0] == 0);
+
+    // 9.2 encodePolyline / decodePolyline
+    // Reference vector from the Google encoded polyline spec
+    std::vector<GeoPoint> googleSample = {{38.5, -120.2}, {40.7, -120.95}, {43.252, -126.453}};
+    assert(encodePolyline(googleSample) == "_p~iF~ps|U_ulLnnqC_mqNvxq`@");
+    auto decodedSample = decodePolyline("_p~iF~ps|U_ulLnnqC_mqNvxq`@");
+    assert(decodedSample.size() == 3);
+    assert(approxEqual(decodedSample[2].lat, 43.252));
+    assert(approxEqual(decodedSample[2].lon, -126.453));
+
+    std::vector<GeoPoint> precisePath = {{39.9042123, 116.4074123}, {39.9042133, 116.4074001}, {-33.8688197, 151.2092955}};
+    auto decodedPrecise = decodePolyline(encodePolyline(precisePath, 7), 7);
+    assert(decodedPrecise.size() == precisePath.size());
+    for (size_t i = 0; i < precisePath.size(); ++i) {
+        assert(approxEqual(decodedPrecise[i].lat, precisePath[i].lat, 1e-7));
+        assert(approxEqual(decodedPrecise[i].lon, precisePath[i].lon, 1e-7));
+    }
+
+    assert(encodePolyline(std::vector<GeoPoint>{}).empty());
+    assert(encodePolyline(CoordSpan()).empty());
+    // Non-finite points are skipped instead of hitting llround UB
+    const double inf = std::numeric_limits<double>::infinity();
+    std::vector<GeoPoint> withInvalid = {{38.5, -120.2}, {std::nan(""), 1.0}, {40.7, inf}, {40.7, -120.95}, {43.252, -126.453}};
+    withInvalid.push_back({1e300, 0.0});
+    assert(encodePolyline(withInvalid) == encodePolyline(std::vector<GeoPoint>{{38.5, -120.2}, {40.7, -120.95}, {43.252, -126.453}}));
+    assert(decodePolyline("").empty());
+    // Truncated input keeps the complete points only
+    assert(decodePolyline("_p~iF~ps|U_ulL").size() == 1);
+    // Invalid characters stop decoding
+    assert(decodePolyline("_p~iF~ps|U\x01").size() == 1);
+    // Deltas near 2^62 would overflow the int64 accumulator; decoding stops at the first out-of-range value
+    {
+        std::string hostile = "_p~iF~ps|U";
+        std::string huge;
+        const uint64_t zigzag = (uint64_t(1) << 62) - 2;  // delta = 2^61 - 1
+        for (uint64_t v = zigzag; ; v >>= 5) {
+            if (v < 0x20) { huge.push_back(static_cast<char>(v + 63)); break; }
+            huge.push_back(static_cast<char>((0x20 | (v & 0x1f)) + 63));
+        }
+        for (int i = 0; i < 8; ++i) {
+            hostile += huge;
+            hostile += huge;
+        }
+        auto decodedHostile = decodePolyline(hostile);
+        assert(decodedHostile.size() == 1);
+        assert(approxEqual(decodedHostile[0].lat, 38.5));
+        // Largest encodable coordinate still round-trips
+        const double edge = 4503599627370495.0 / 1e5;
+        auto decodedEdge = decodePolyline(encodePolyline(std::vector<GeoPoint>{{edge, -edge}, {0.0, 0.0}}));
+        assert(decodedEdge.size() == 2);
+        assert(decodedEdge[0].lat == edge && decodedEdge[0].lon == -edge);
+    }
 
     // 10. calculateFitZoomForPoints
     std::vector<GeoPoint> nearby = {
@@ -182,6 +561,38 @@ void testGeometryEngineExtended() {
     assert(nearZoom <= 20.0 && nearZoom >= 3.0);
     assert(farZoom <= 20.0 && farZoom >= 3.0);
 
+    // 11. CoordSpan: 独立经纬度数组 (stride 1) 与 GeoPoint 视图 (stride 2) 结果一致
+    std::vector<GeoPoint> spanPath = {
+        {39.9000, 116.3000}, {39.9100, 116.3200}, {39.9050, 116.3400}, {39.9200, 116.3600}
+    };
+    std::vector<double> spanLats, spanLons;
+    for (const auto& p : spanPath) {
+        spanLats.push_back(p.lat);
+        spanLons.push_back(p.lon);
+    }
+    const CoordSpan soa(spanLats.data(), spanLons.data(), spanLats.size());
+    const CoordSpan aos(spanPath);
+    assert(aos.size() == 4 && aos.stride == 2);
+    assert(soa.latAt(2) == spanPath[2].lat && soa.lonAt(2) == spanPath[2].lon);
+    assert(aos[3].lat == spanPath[3].lat && aos.back().lon == spanPath[3].lon);
+
+    assert(calculatePathLength(soa) == calculatePathLength(spanPath));
+    assert(calculatePathLength(aos) == calculatePathLength(spanPath));
+    assert(calculatePolygonArea(soa) == calculatePolygonArea(spanPath));
+    assert(isPointInPolygon(39.908, 116.33, soa) == isPointInPolygon(39.908, 116.33, spanPath));
+    assert(encodePolyline(soa) == encodePolyline(spanPath));
+    assert(simplifyPolyline(soa, 5.0).size() == simplifyPolyline(spanPath, 5.0).size());
+    const GeoPoint spanCentroid = calculateCentroid(soa);
+    const GeoPoint vecCentroid = calculateCentroid(spanPath);
+    assert(spanCentroid.lat == vecCentroid.lat && spanCentroid.lon == vecCentroid.lon);
+    const NearestPointResult spanNearest = getNearestPointOnPath(soa, {39.912, 116.33});
+    assert(spanNearest.index == getNearestPointOnPath(spanPath, {39.912, 116.33}).index);
+    const PathBounds spanBounds = calculatePathBounds(aos.subspan(1, 2));
+    assert(spanBounds.north == 39.9100 && spanBounds.south == 39.9050);
+    assert(spanBounds.west == 116.3200 && spanBounds.east == 116.3400);
+    assert(findPointInPolygons(39.908, 116.33, std::vector<CoordSpan>{CoordSpan(), soa}) ==
+           (isPointInPolygon(39.908, 116.33, soa) ? 1 : -1));
+
     std::cout << "PASSED" << std::endl;
 }
 
@@ -213,6 +624,2506 @@ void benchmarkParsePolyline() {
     std::cout << "PASSED" << std::endl;
 }
 
+// 逐位二分的 GeoHash 编码（原实现），作为批量编码的对照
+static std::string referenceGeoHash(double lat, double lon, int precision) {
+    static const char BASE32[] = "0123456789bcdefghjkmnpqrstuvwxyz";
+    std::string hash;
+    double minLat = -90.0, maxLat = 90.0;
+    double minLon = -180.0, maxLon = 180.0;
+    int bit = 0;
+    int ch = 0;
+    bool isEven = true;
+    while (static_cast<int>(hash.length()) < precision) {
+        if (isEven) {
+            double mid = (minLon + maxLon) / 2.0;
+            if (lon > mid) { ch |= (1 << (4 - bit)); minLon = mid; } else { maxLon = mid; }
+        } else {
+            double mid = (minLat + maxLat) / 2.0;
+            if (lat > mid) { ch |= (1 << (4 - bit)); minLat = mid; } else { maxLat = mid; }
+        }
+        isEven = !isEven;
+        if (bit < 4) {
+            bit++;
+        } else {
+            hash += BASE32[ch];
+            bit = 0;
+            ch = 0;
+        }
+    }
+    return hash;
+}
+
+void testGeoHash() {
+    std::cout << "Running testGeoHash..." << std::endl;
+
+    // 1. 与逐位二分结果一致（含分界线、边界与越界值）
+    std::vector<GeoPoint> points = {
+        {39.9042, 116.4074}, {0.0, 0.0}, {-90.0, -180.0}, {90.0, 180.0}, {45.0, 90.0},
+        {-33.8688, 151.2093}, {51.5074, -0.1278}, {95.0, 200.0}, {-95.0, -200.0}
+    };
+    uint32_t seed = 7;
+    for (int i = 0; i < 20000; ++i) {
+        seed = seed * 1664525u + 1013904223u;
+        const double a = (seed >> 8) / static_cast<double>(1u << 24);
+        seed = seed * 1664525u + 1013904223u;
+        const double b = (seed >> 8) / static_cast<double>(1u << 24);
+        points.push_back({a * 180.0 - 90.0, b * 360.0 - 180.0});
+    }
+    // 紧贴各级分界线两侧 1 ulp 的值：按比例量化时最容易与二分结果不一致
+    for (int i = 0; i < 4000; ++i) {
+        seed = seed * 1664525u + 1013904223u;
+        const int bits = 1 + static_cast<int>(seed % 30);
+        seed = seed * 1664525u + 1013904223u;
+        const uint32_t k = 1 + (seed >> 2) % ((1u << bits) - 1);
+        const double lat = -90.0 + 180.0 / (1u << bits) * k;
+        const double lon = -180.0 + 360.0 / (1u << bits) * k;
+        points.push_back({lat, lon});
+        points.push_back({std::nextafter(lat, 100.0), std::nextafter(lon, 200.0)});
+        points.push_back({std::nextafter(lat, -100.0), std::nextafter(lon, -200.0)});
+    }
+    assert(encodeGeoHash(45.000000000000007, 135.0, 7) == "ybpbpbp");
+    for (int precision = 1; precision <= 12; ++precision) {
+        std::vector<char> buffer(points.size() * precision);
+        assert(encodeGeoHashes(points, precision, buffer.data()) == precision);
+        for (size_t i = 0; i < points.size(); ++i) {
+            const std::string expected = referenceGeoHash(points[i].lat, points[i].lon, precision);
+            assert(std::string(buffer.data() + i * precision, precision) == expected);
+            assert(encodeGeoHash(points[i].lat, points[i].lon, precision) == expected);
+        }
+    }
+    assert(encodeGeoHash(39.9042, 116.4074, 20).size() == 12);
+    assert(encodeGeoHash(39.9042, 116.4074, 0) == "w");
+
+    // 2. 解码：网格包含原始点，宽度与精度对应
+    PathBounds bounds;
+    assert(decodeGeoHash("wx4g0", bounds));
+    assert(bounds.south <= 39.9042 && 39.9042 <= bounds.north);
+    assert(bounds.west <= 116.4074 && 116.4074 <= bounds.east);
+    assert(approxEqual(bounds.north - bounds.south, 180.0 / 4096.0, 1e-12));
+    assert(approxEqual(bounds.east - bounds.west, 360.0 / 8192.0, 1e-12));
+    assert(approxEqual(bounds.centerLat, (bounds.north + bounds.south) / 2.0, 1e-12));
+    PathBounds upper;
+    assert(decodeGeoHash("WX4G0", upper) && upper.south == bounds.south && upper.west == bounds.west);
+    assert(!decodeGeoHash("", bounds));
+    assert(!decodeGeoHash("wx4ga", bounds));   // 'a' 不在字母表中
+    assert(!decodeGeoHash("wx4g0wx4g0wx4", bounds));
+
+    const int width = 9;
+    std::vector<char> encoded(points.size() * width);
+    encodeGeoHashes(points, width, encoded.data());
+    std::vector<PathBounds> decoded(points.size());
+    assert(decodeGeoHashes(encoded.data(), points.size(), width, decoded.data()) == points.size());
+    for (size_t i = 0; i < points.size(); ++i) {
+        const double lat = std::max(-90.0, std::min(90.0, points[i].lat));
+        const double lon = std::max(-180.0, std::min(180.0, points[i].lon));
+        assert(decoded[i].south <= lat && lat <= decoded[i].north);
+        assert(decoded[i].west <= lon && lon <= decoded[i].east);
+        assert(encodeGeoHash(decoded[i].centerLat, decoded[i].centerLon, width) == std::string(encoded.data() + i * width, width));
+    }
+    encoded[3] = '!';
+    assert(decodeGeoHashes(encoded.data(), points.size(), width, decoded.data()) == points.size() - 1);
+    assert(std::isnan(decoded[0].north));
+
+    // 3. 相邻网格
+    auto neighbors = getGeoHashNeighbors("wx4g0");
+    assert(neighbors.size() == 8);
+    PathBounds north, east, southWest;
+    assert(decodeGeoHash(neighbors[0], north) && decodeGeoHash(neighbors[2], east) && decodeGeoHash(neighbors[5], southWest));
+    decodeGeoHash("wx4g0", bounds);
+    assert(north.south == bounds.north && north.west == bounds.west);
+    assert(east.west == bounds.east && east.south == bounds.south);
+    assert(southWest.north == bounds.south && southWest.east == bounds.west);
+    for (const auto& n : neighbors) {
+        assert(n.size() == 5);
+        assert(getGeoHashNeighbors(n).size() == 8);
+    }
+    // 跨 180° 经线回绕，两极没有相邻网格
+    assert(getGeoHashNeighbor("z", 0, 1) == "b");
+    assert(getGeoHashNeighbor("b", 0, -1) == "z");
+    assert(getGeoHashNeighbor("z", 1, 0).empty());
+    assert(getGeoHashNeighbor("0", -1, 0).empty());
+    assert(getGeoHashNeighbor("wx4g0", 0, 0) == "wx4g0");
+    assert(getGeoHashNeighbor("wx4g0", 2, -3) == getGeoHashNeighbor(getGeoHashNeighbor("wx4g0", 1, -1), 1, -2));
+    assert(getGeoHashNeighbors("??").empty());
+
+    // 4. 矩形覆盖：矩形内任一点的编码都在覆盖结果中，且结果中每个网格都与矩形相交
+    auto checkCover = [](double south, double west, double north, double east, int precision) {
+        const auto cover = coverBoundsWithGeoHashes(south, west, north, east, precision, 100000);
+        assert(!cover.empty());
+        std::vector<std::string> sorted = cover;
+        std::sort(sorted.begin(), sorted.end());
+        assert(std::unique(sorted.begin(), sorted.end()) == sorted.end());
+        const double span = east >= west ? east - west : east + 360.0 - west;
+        for (int i = 0; i <= 40; ++i) {
+            for (int j = 0; j <= 40; ++j) {
+                double lon = west + span * j / 40.0;
+                if (lon > 180.0) lon -= 360.0;
+                const double lat = south + (north - south) * i / 40.0;
+                assert(std::binary_search(sorted.begin(), sorted.end(), encodeGeoHash(lat, lon, precision)));
+            }
+        }
+        for (const auto& hash : cover) {
+            PathBounds cell;
+            assert(decodeGeoHash(hash, cell));
+            assert(cell.north >= south && cell.south <= north);
+        }
+        return cover.size();
+    };
+    checkCover(39.8, 116.2, 40.0, 116.6, 5);
+    checkCover(39.9, 116.40, 39.91, 116.41, 7);
+    const size_t wrapped = checkCover(-10.0, 170.0, 10.0, -170.0, 3);   // 跨 180° 经线
+    assert(wrapped == coverBoundsWithGeoHashes(-10.0, 170.0, 10.0, 190.0, 3).size());
+    assert(coverBoundsWithGeoHashes(-90.0, -180.0, 90.0, 180.0, 1).size() == 32);
+    assert(coverBoundsWithGeoHashes(39.9, 116.4, 39.9, 116.4, 6).size() == 1);
+    assert(coverBoundsWithGeoHashes(39.9, 116.4, 39.9, 116.4, 6)[0] == encodeGeoHash(39.9, 116.4, 6));
+    assert(coverBoundsWithGeoHashes(-90.0, -180.0, 90.0, 180.0, 8, 1000).empty());
+    // 颠倒的矩形为空，不会退化为覆盖整圈经度
+    assert(coverBoundsWithGeoHashes(40.0, 116.2, 39.8, 116.6, 5).empty());
+    assert(coverBoundsWithGeoHashes(90.0, 180.0, -90.0, -180.0, 3).empty());
+    assert(coverBoundsWithGeoHashes(39.8, 200.0, 40.0, 190.0, 3).empty());
+    assert(coverBoundsWithGeoHashes(39.8, -190.0, 40.0, -200.0, 3).empty());
+
+    // 性能：批量编码 vs 逐位二分
+    std::vector<GeoPoint> many(1000000);
+    for (auto& p : many) {
+        seed = seed * 1664525u + 1013904223u;
+        p.lat = (seed >> 8) / static_cast<double>(1u << 24) * 180.0 - 90.0;
+        seed = seed * 1664525u + 1013904223u;
+        p.lon = (seed >> 8) / static_cast<double>(1u << 24) * 360.0 - 180.0;
+    }
+    size_t checksum = 0;
+    auto start = std::chrono::high_resolution_clock::now();
+    for (const auto& p : many) checksum += referenceGeoHash(p.lat, p.lon, 9)[8];
+    auto mid = std::chrono::high_resolution_clock::now();
+    std::vector<char> manyEncoded(many.size() * 9);
+    encodeGeoHashes(many, 9, manyEncoded.data());
+    auto end = std::chrono::high_resolution_clock::now();
+    for (size_t i = 0; i < many.size(); ++i) checksum -= manyEncoded[i * 9 + 8];
+    assert(checksum == 0);
+    std::cout << "1,000,000 geohashes (precision 9): bisection "
+              << std::chrono::duration<double, std::milli>(mid - start).count() << " ms, batch "
+              << std::chrono::duration<double, std::milli>(end - mid).count() << " ms" << std::endl;
+
+    std::cout << "PASSED" << std::endl;
+}
+
+// 位运算部分可在编译期求值
+static_assert(CellId::fromTile(5, 3, 3).tileX() == 5 && CellId::fromTile(5, 3, 3).tileY() == 3, "CellId tile round trip");
+static_assert(CellId::fromTile(5, 3, 3).level() == 3, "CellId level");
+static_assert(CellId::fromTile(5, 3, 3).parent() == CellId::fromTile(2, 1, 2), "CellId parent");
+static_assert(CellId::fromTile(2, 1, 2).child(3) == CellId::fromTile(5, 3, 3), "CellId child");
+static_assert(CellId::fromTile(7, 0, 3).neighbor(1, 0) == CellId::fromTile(0, 0, 3), "CellId neighbor wraps");
+static_assert(!CellId::fromTile(0, 0, 3).neighbor(0, -1).isValid(), "CellId neighbor beyond pole");
+
+void testCellId() {
+    std::cout << "Running testCellId..." << std::endl;
+
+    // 1. 位运算基础
+    for (int shift = 0; shift < 64; ++shift) {
+        assert(CellId::trailingZeros(uint64_t(1) << shift) == shift);
+        assert(CellId::trailingZeros((uint64_t(1) << shift) | (uint64_t(1) << 63)) == shift);
+    }
+    assert(CellId::trailingZeros(0) == 64);
+    uint32_t seed = 99;
+    for (int i = 0; i < 10000; ++i) {
+        seed = seed * 1664525u + 1013904223u;
+        assert(CellId::compactBits(CellId::spreadBits(seed)) == seed);
+        assert((CellId::spreadBits(seed) & 0xAAAAAAAAAAAAAAAAULL) == 0);
+    }
+
+    // 2. 与瓦片坐标一致，层级关系
+    const double lat = 39.9042, lon = 116.4074;
+    const CellId leaf = CellId::fromLatLng(lat, lon);
+    assert(leaf.isValid() && leaf.isLeaf() && leaf.level() == CellId::kMaxLevel);
+    for (int level = 0; level <= 20; ++level) {
+        const CellId cell = CellId::fromLatLng(lat, lon, level);
+        const TileResult tile = latLngToTile(lat, lon, level);
+        assert(cell.level() == level);
+        assert(static_cast<int>(cell.tileX()) == tile.x && static_cast<int>(cell.tileY()) == tile.y);
+        assert(cell == leaf.parent(level));
+        assert(cell.contains(leaf) && cell.intersects(leaf));
+        const PathBounds b = cell.bounds();
+        assert(b.south <= lat && lat <= b.north && b.west <= lon && lon <= b.east);
+        assert(CellId::fromLatLng(b.centerLat, b.centerLon, level) == cell);
+        if (level > 0) {
+            assert(cell.parent() == CellId::fromLatLng(lat, lon, level - 1));
+            assert(!cell.contains(cell.parent()) && cell.parent().contains(cell));
+            // 子网格的 id 连续分布在父网格的区间内
+            const CellId parent = cell.parent();
+            assert(parent.rangeMin() == parent.childBegin().rangeMin());
+            assert(parent.rangeMax() == parent.childEnd().rangeMax());
+            assert(parent.child(1).rangeMin() == parent.child(0).rangeMax() + 2);
+        }
+    }
+    assert(CellId::fromLatLng(90.0, 0.0, 4).tileY() == 0);
+    assert(CellId::fromLatLng(-90.0, 0.0, 4).tileY() == 15);
+    assert(CellId::fromLatLng(0.0, 180.0, 4) == CellId::fromLatLng(0.0, -180.0, 4));
+    assert(!CellId::fromLatLng(NAN, 0.0).isValid());
+    assert(!CellId::fromTile(16, 0, 4).isValid());
+    assert(!CellId(0).isValid() && !CellId(2).isValid());
+    assert(!leaf.child(0).isValid());
+    assert(CellId::fromTile(0, 0, 0).parent(0) == CellId::fromTile(0, 0, 0));
+
+    // 相邻网格与瓦片坐标一致
+    const CellId cell12 = CellId::fromLatLng(lat, lon, 12);
+    const CellId east = cell12.neighbor(1, 0);
+    const CellId south = cell12.neighbor(0, 1);
+    assert(east.tileX() == cell12.tileX() + 1 && east.tileY() == cell12.tileY());
+    assert(south.tileY() == cell12.tileY() + 1 && south.level() == 12);
+    assert(approxEqual(east.bounds().west, cell12.bounds().east, 1e-12));
+    assert(approxEqual(south.bounds().north, cell12.bounds().south, 1e-12));
+
+    // 3. 矩形覆盖：矩形内任一点都落在某个覆盖网格内，网格数不超过上限
+    auto coveredBy = [](const std::vector<CellId>& cover, double pLat, double pLon) {
+        const CellId p = CellId::fromLatLng(pLat, pLon);
+        auto it = std::upper_bound(cover.begin(), cover.end(), p);
+        if (it != cover.end() && it->contains(p)) return true;
+        return it != cover.begin() && std::prev(it)->contains(p);
+    };
+    auto checkBounds = [&](double s, double w, double n, double e, int maxLevel, size_t maxCells) {
+        const auto cover = coverBoundsWithCells(s, w, n, e, maxLevel, maxCells);
+        assert(!cover.empty() && cover.size() <= maxCells);
+        for (size_t i = 1; i < cover.size(); ++i) {
+            assert(cover[i - 1] < cover[i] && !cover[i - 1].intersects(cover[i]));
+        }
+        const double span = e >= w ? e - w : e + 360.0 - w;
+        for (int i = 0; i <= 30; ++i) {
+            for (int j = 0; j <= 30; ++j) {
+                double pLon = w + span * j / 30.0;
+                if (pLon > 180.0) pLon -= 360.0;
+                assert(coveredBy(cover, s + (n - s) * i / 30.0, pLon));
+            }
+        }
+        return cover;
+    };
+    checkBounds(39.8, 116.2, 40.0, 116.6, 16, 16);
+    checkBounds(39.8, 116.2, 40.0, 116.6, 16, 4);
+    checkBounds(-10.0, 170.0, 10.0, -170.0, 12, 32);   // 跨 180° 经线
+    checkBounds(-80.0, -180.0, 80.0, 180.0, 4, 64);
+    const auto tight = checkBounds(39.9, 116.40, 39.91, 116.41, 30, 1000);
+    // 精细覆盖不会远大于矩形
+    double coveredArea = 0.0;
+    for (const auto& c : tight) {
+        const PathBounds b = c.bounds();
+        coveredArea += (b.north - b.south) * (b.east - b.west);
+    }
+    assert(coveredArea < 0.01 * 0.01 * 1.2);
+    // 瓦片本身的覆盖就是它自己
+    const PathBounds tileBounds = cell12.bounds();
+    const double eps = 1e-9;
+    const auto self = coverBoundsWithCells(tileBounds.south + eps, tileBounds.west + eps, tileBounds.north - eps, tileBounds.east - eps, 30, 1);
+    assert(self.size() == 1 && self[0] == cell12);
+
+    // 4. 圆形覆盖
+    auto checkCircle = [&](double cLat, double cLon, double radius, int maxLevel, size_t maxCells) {
+        const auto cover = coverCircleWithCells(cLat, cLon, radius, maxLevel, maxCells);
+        assert(!cover.empty() && cover.size() <= maxCells);
+        for (int i = 0; i < 720; ++i) {
+            const double bearing = i * 0.5 * 3.14159265358979323846 / 180.0;
+            for (double fraction : {0.0, 0.5, 0.999}) {
+                const double d = radius * fraction / 6371000.0;
+                const double lat1 = cLat * 3.14159265358979323846 / 180.0;
+                const double lat2 = std::asin(std::sin(lat1) * std::cos(d) + std::cos(lat1) * std::sin(d) * std::cos(bearing));
+                const double dLon = std::atan2(std::sin(bearing) * std::sin(d) * std::cos(lat1), std::cos(d) - std::sin(lat1) * std::sin(lat2));
+                double pLon = cLon + dLon * 180.0 / 3.14159265358979323846;
+                if (pLon > 180.0) pLon -= 360.0;
+                if (pLon < -180.0) pLon += 360.0;
+                assert(coveredBy(cover, lat2 * 180.0 / 3.14159265358979323846, pLon));
+            }
+        }
+        return cover;
+    };
+    checkCircle(39.9042, 116.4074, 1000.0, 30, 16);
+    checkCircle(39.9042, 116.4074, 1000.0, 30, 200);
+    checkCircle(0.0, 179.999, 5000.0, 20, 32);   // 跨 180° 经线
+    checkCircle(-33.8688, 151.2093, 200000.0, 12, 8);
+    assert(coverCircleWithCells(39.9, 116.4, -1.0, 10, 8).empty());
+
+    // 随机圆心 / 半径（含高纬度与数千公里的大圆）：圆内的点必须被覆盖
+    uint32_t circleSeed = 2024;
+    auto nextUnit = [&]() {
+        circleSeed = circleSeed * 1664525u + 1013904223u;
+        return (circleSeed >> 8) / static_cast<double>(1u << 24);
+    };
+    auto checkCircleContainment = [&](double cLat, double cLon, double radius, int maxLevel, size_t maxCells) {
+        const auto cover = coverCircleWithCells(cLat, cLon, radius, maxLevel, maxCells);
+        const double lat1 = cLat * 3.14159265358979323846 / 180.0;
+        for (int i = 0; i < 400; ++i) {
+            // 圆内随机一点：随机方位角，距离按面积均匀分布
+            const double bearing = nextUnit() * 2.0 * 3.14159265358979323846;
+            const double d = radius * std::sqrt(nextUnit()) / 6371000.0;
+            const double lat2 = std::asin(std::sin(lat1) * std::cos(d) + std::cos(lat1) * std::sin(d) * std::cos(bearing));
+            const double dLon = std::atan2(std::sin(bearing) * std::sin(d) * std::cos(lat1), std::cos(d) - std::sin(lat1) * std::sin(lat2));
+            const double pLat = lat2 * 180.0 / 3.14159265358979323846;
+            const double pLon = std::remainder(cLon + dLon * 180.0 / 3.14159265358979323846, 360.0);
+            // Web Mercator 网格只覆盖 ±85.05°
+            if (std::abs(pLat) > 85.0 || calculateDistance(cLat, cLon, pLat, pLon) > radius) continue;
+            assert(coveredBy(cover, pLat, pLon));
+        }
+    };
+    // 按纬度截断估计最近点会把这个网格误判为不相交
+    const auto farCover = coverCircleWithCells(-56.21859, 144.52908, 2759062.0, 16, 47);
+    assert(calculateDistance(-56.21859, 144.52908, -60.27701, -168.22895) <= 2759062.0);
+    assert(coveredBy(farCover, -60.27701, -168.22895));
+    for (int trial = 0; trial < 300; ++trial) {
+        const double cLat = (nextUnit() * 2.0 - 1.0) * 84.0;
+        const double cLon = nextUnit() * 360.0 - 180.0;
+        const double radius = std::pow(10.0, 2.0 + nextUnit() * 4.6);  // 100 m ~ 4000 km
+        const int maxLevel = 4 + static_cast<int>(nextUnit() * 20.0);
+        const size_t maxCells = 4 + static_cast<size_t>(nextUnit() * 60.0);
+        checkCircleContainment(cLat, cLon, radius, maxLevel, maxCells);
+    }
+
+    // 5. 区间合并：兄弟网格首尾相接
+    const CellId parent = cell12.parent();
+    const auto ranges = cellIdRanges({parent.child(2), parent.child(0), parent.child(1), parent.child(3)});
+    assert(ranges.size() == 1 && ranges[0].min == parent.rangeMin() && ranges[0].max == parent.rangeMax());
+    assert(cellIdRanges({parent.child(0), parent.child(2)}).size() == 2);
+
+    // 性能：编码、排序后按覆盖区间扫描，对比逐点判断
+    const size_t n = 1000000;
+    std::vector<GeoPoint> pts(n);
+    for (auto& p : pts) {
+        seed = seed * 1664525u + 1013904223u;
+        p.lat = 39.5 + (seed >> 8) / static_cast<double>(1u << 24) * 1.0;
+        seed = seed * 1664525u + 1013904223u;
+        p.lon = 116.0 + (seed >> 8) / static_cast<double>(1u << 24) * 1.0;
+    }
+    auto t0 = std::chrono::high_resolution_clock::now();
+    std::vector<uint64_t> ids(n);
+    for (size_t i = 0; i < n; ++i) ids[i] = CellId::fromLatLng(pts[i].lat, pts[i].lon).id();
+    auto t1 = std::chrono::high_resolution_clock::now();
+    uint64_t parentSum = 0;
+    for (size_t i = 0; i < n; ++i) parentSum += CellId(ids[i]).parent(14).neighbor(1, 1).id();
+    auto t2 = std::chrono::high_resolution_clock::now();
+    std::sort(ids.begin(), ids.end());
+    auto t3 = std::chrono::high_resolution_clock::now();
+
+    const auto queryRanges = cellIdRanges(coverCircleWithCells(39.9042, 116.4074, 3000.0, 30, 32));
+    size_t hits = 0;
+    for (const auto& r : queryRanges) {
+        hits += std::upper_bound(ids.begin(), ids.end(), r.max) - std::lower_bound(ids.begin(), ids.end(), r.min);
+    }
+    auto t4 = std::chrono::high_resolution_clock::now();
+    size_t exact = 0;
+    for (const auto& p : pts) {
+        if (calculateDistance(39.9042, 116.4074, p.lat, p.lon) <= 3000.0) ++exact;
+    }
+    auto t5 = std::chrono::high_resolution_clock::now();
+    assert(hits >= exact && hits < exact * 2);
+    assert(parentSum != 0);
+    auto ms = [](std::chrono::high_resolution_clock::time_point a, std::chrono::high_resolution_clock::time_point b) {
+        return std::chrono::duration<double, std::milli>(b - a).count();
+    };
+    std::cout << "1,000,000 CellIds: encode " << ms(t0, t1) << " ms, parent+neighbor " << ms(t1, t2)
+              << " ms, sort " << ms(t2, t3) << " ms" << std::endl;
+    std::cout << "3 km circle: " << queryRanges.size() << " ranges, " << hits << " candidates in "
+              << ms(t3, t4) << " ms vs " << exact << " exact by full scan in " << ms(t4, t5) << " ms" << std::endl;
+
+    std::cout << "PASSED" << std::endl;
+}
+
+void testBatchProjection() {
+    std::cout << "Running testBatchProjection..." << std::endl;
+    const double pi = 3.14159265358979323846;
+    // 原实现：std::pow + asinh(tan)
+    auto referencePixel = [pi](double lat, double lon, double zoom) {
+        const double n = std::pow(2.0, zoom) * 256.0;
+        return PixelResult{(lon + 180.0) / 360.0 * n, (1.0 - std::asinh(std::tan(lat * pi / 180.0)) / pi) / 2.0 * n};
+    };
+
+    std::vector<GeoPoint> points = {{39.9042, 116.4074}, {0.0, 0.0}, {85.0, -179.9}, {-85.0, 179.9}, {-33.8688, 151.2093}};
+    uint32_t seed = 2024;
+    for (int i = 0; i < 5000; ++i) {
+        seed = seed * 1664525u + 1013904223u;
+        const double a = (seed >> 8) / static_cast<double>(1u << 24);
+        seed = seed * 1664525u + 1013904223u;
+        const double b = (seed >> 8) / static_cast<double>(1u << 24);
+        points.push_back({a * 170.0 - 85.0, b * 360.0 - 180.0});
+    }
+    const size_t n = points.size();
+    const CoordSpan span(points);
+
+    // 1. 世界像素坐标与单点接口、原公式一致，逆变换可还原
+    std::vector<double> xs(n), ys(n), lats(n), lons(n);
+    for (double zoom : {0.0, 3.0, 12.0, 15.5, 20.0}) {
+        latLngToPixels(span, zoom, xs.data(), ys.data());
+        pixelsToLatLngs(xs.data(), ys.data(), n, zoom, lats.data(), lons.data());
+        const double tolerance = std::pow(2.0, zoom) * 256.0 * 1e-14;
+        for (size_t i = 0; i < n; ++i) {
+            const PixelResult expected = referencePixel(points[i].lat, points[i].lon, zoom);
+            assert(approxEqual(xs[i], expected.x, tolerance) && approxEqual(ys[i], expected.y, tolerance));
+            if (zoom == std::floor(zoom)) {
+                const PixelResult single = latLngToPixel(points[i].lat, points[i].lon, static_cast<int>(zoom));
+                assert(single.x == xs[i] && single.y == ys[i]);
+                const GeoPoint back = pixelToLatLng(xs[i], ys[i], static_cast<int>(zoom));
+                assert(back.lat == lats[i] && back.lon == lons[i]);
+            }
+            assert(approxEqual(lats[i], points[i].lat, 1e-9) && approxEqual(lons[i], points[i].lon, 1e-9));
+        }
+    }
+    // 极点处结果保持有限
+    assert(std::isfinite(latLngToPixel(90.0, 0.0, 3).y) && std::isfinite(latLngToPixel(-90.0, 0.0, 3).y));
+    // 非法缩放级别不做 int 转换：NaN 传播，过大的级别溢出为 inf
+    latLngToPixels(span, NAN, xs.data(), ys.data());
+    assert(std::isnan(xs[0]) && std::isnan(ys[0]));
+    latLngToPixels(span, 1e300, xs.data(), ys.data());
+    assert(std::isinf(xs[0]) || xs[0] == 0.0);
+    pixelsToLatLngs(xs.data(), ys.data(), 1, INFINITY, lats.data(), lons.data());
+
+    // 2. 瓦片坐标：合法输入与 latLngToTile 一致，越界输入被截断
+    std::vector<int> tx(n), ty(n);
+    for (int zoom : {0, 1, 10, 18}) {
+        latLngToTiles(span, zoom, tx.data(), ty.data());
+        for (size_t i = 0; i < n; ++i) {
+            const TileResult tile = latLngToTile(points[i].lat, points[i].lon, zoom);
+            assert(tx[i] == tile.x && ty[i] == tile.y);
+        }
+    }
+    const std::vector<GeoPoint> outOfRange = {{89.9, 180.0}, {-89.9, -190.0}, {NAN, 0.0}};
+    std::vector<int> ox(3), oy(3);
+    latLngToTiles(CoordSpan(outOfRange), 4, ox.data(), oy.data());
+    assert(ox[0] == 0 && oy[0] == 0);
+    assert(ox[1] == 15 && oy[1] == 15);
+    assert(oy[2] == 0);
+
+    // 3. 屏幕坐标（float）
+    const ScreenViewport viewport = makeScreenViewport(39.9042, 116.4074, 18.5, 1080.0, 1920.0, 50.0);
+    std::vector<GeoPoint> screenPoints = {
+        {39.9042, 116.4074},          // 中心
+        {39.9042, 116.4074 + 0.0005}, // 中心东侧
+        {39.9042, 116.5},             // 视口外
+        {NAN, 116.4}
+    };
+    std::vector<float> sx(screenPoints.size()), sy(screenPoints.size());
+    std::vector<uint8_t> visible(screenPoints.size());
+    assert(projectToScreen(CoordSpan(screenPoints), viewport, sx.data(), sy.data(), visible.data()) == 2);
+    assert(std::abs(sx[0] - 540.0f) < 1e-3f && std::abs(sy[0] - 960.0f) < 1e-3f);
+    const PixelResult centerPx = latLngToPixel(39.9042, 116.4074 + 0.0005, 18);
+    const double scaleFrac = std::pow(2.0, 0.5);
+    assert(std::abs(sx[1] - (centerPx.x * scaleFrac - viewport.originX)) < 1e-2);
+    assert(visible[0] == 1 && visible[1] == 1 && visible[2] == 0 && visible[3] == 0);
+    assert(std::isnan(sx[3]));
+    assert(projectToScreen(CoordSpan(screenPoints), viewport, sx.data(), sy.data(), nullptr) == 2);
+
+    // 跨 180° 经线：取最近的世界副本，坐标连续
+    const ScreenViewport dateLine = makeScreenViewport(0.0, 179.999, 12.0, 800.0, 600.0, 0.0);
+    const std::vector<GeoPoint> acrossLine = {{0.0, 179.999}, {0.0, -179.999}};
+    std::vector<float> lx(2), ly(2);
+    assert(projectToScreen(CoordSpan(acrossLine), dateLine, lx.data(), ly.data(), nullptr) == 2);
+    assert(lx[1] > lx[0] && lx[1] - lx[0] < 10.0f);
+
+    // 性能：逐点原公式 vs 批量
+    std::vector<GeoPoint> many(1000000);
+    for (auto& p : many) {
+        seed = seed * 1664525u + 1013904223u;
+        p.lat = 39.0 + (seed >> 8) / static_cast<double>(1u << 24) * 2.0;
+        seed = seed * 1664525u + 1013904223u;
+        p.lon = 116.0 + (seed >> 8) / static_cast<double>(1u << 24) * 2.0;
+    }
+    std::vector<double> mx(many.size()), my(many.size());
+    auto t0 = std::chrono::high_resolution_clock::now();
+    for (size_t i = 0; i < many.size(); ++i) {
+        const PixelResult px = referencePixel(many[i].lat, many[i].lon, 15.0);
+        mx[i] = px.x;
+        my[i] = px.y;
+    }
+    auto t1 = std::chrono::high_resolution_clock::now();
+    latLngToPixels(CoordSpan(many), 15.0, mx.data(), my.data());
+    auto t2 = std::chrono::high_resolution_clock::now();
+    std::vector<float> fx(many.size()), fy(many.size());
+    const size_t onScreen = projectToScreen(CoordSpan(many), makeScreenViewport(39.9, 116.4, 15.0, 1080.0, 1920.0, 64.0), fx.data(), fy.data(), nullptr);
+    auto t3 = std::chrono::high_resolution_clock::now();
+    auto ms = [](std::chrono::high_resolution_clock::time_point a, std::chrono::high_resolution_clock::time_point b) {
+        return std::chrono::duration<double, std::milli>(b - a).count();
+    };
+    std::cout << "1,000,000 projections: pow+asinh(tan) " << ms(t0, t1) << " ms, batch " << ms(t1, t2)
+              << " ms, screen float " << ms(t2, t3) << " ms (" << onScreen << " visible)" << std::endl;
+
+    std::cout << "PASSED" << std::endl;
+}
+
+void testViewportClipping() {
+    std::cout << "Running testViewportClipping..." << std::endl;
+    const ScreenViewport viewport = makeScreenViewport(39.9, 116.4, 14.0, 800.0, 600.0, 50.0);
+    // 屏幕坐标 -> 经纬度
+    auto at = [&viewport](double sx, double sy) {
+        const double x = sx + viewport.originX;
+        const double y = sy + viewport.originY;
+        double lat = 0.0, lon = 0.0;
+        pixelsToLatLngs(&x, &y, 1, viewport.zoom, &lat, &lon);
+        return GeoPoint{lat, lon};
+    };
+    auto checkScreen = [&viewport](const GeoPoint& p, double sx, double sy) {
+        float x = 0.0f, y = 0.0f;
+        projectToScreen(CoordSpan(&p.lat, &p.lon, 1), viewport, &x, &y, nullptr);
+        assert(std::abs(x - sx) < 1e-3 && std::abs(y - sy) < 1e-3);
+    };
+
+    // 1. 折线：完全在视口内时原样返回
+    const std::vector<GeoPoint> inside = {at(100, 100), at(400, 300), at(700, 100)};
+    auto insideResult = clipPolylineToViewport(CoordSpan(inside), viewport);
+    assert(insideResult.ringOffsets == std::vector<int>({0, 3}));
+    for (size_t i = 0; i < 3; ++i) {
+        assert(insideResult.points[i].lat == inside[i].lat && insideResult.points[i].lon == inside[i].lon);
+    }
+
+    // 2. 穿过视口的线段裁剪到外扩 50 像素的矩形
+    const std::vector<GeoPoint> crossing = {at(-500, 300), at(1300, 300)};
+    auto crossingResult = clipPolylineToViewport(CoordSpan(crossing), viewport);
+    assert(crossingResult.ringOffsets == std::vector<int>({0, 2}));
+    checkScreen(crossingResult.points[0], -50, 300);
+    checkScreen(crossingResult.points[1], 850, 300);
+
+    // 3. 离开视口后再进入，断开为两段
+    const std::vector<GeoPoint> uTurn = {at(100, 100), at(2000, 100), at(2000, 500), at(100, 500)};
+    auto uTurnResult = clipPolylineToViewport(CoordSpan(uTurn), viewport);
+    assert(uTurnResult.ringOffsets == std::vector<int>({0, 2, 4}));
+    checkScreen(uTurnResult.points[1], 850, 100);
+    checkScreen(uTurnResult.points[2], 850, 500);
+    assert(uTurnResult.points[3].lat == uTurn[3].lat && uTurnResult.points[3].lon == uTurn[3].lon);
+
+    // 4. 完全在视口外
+    const std::vector<GeoPoint> outside = {at(-500, -500), at(2000, -500), at(2000, -300)};
+    assert(clipPolylineToViewport(CoordSpan(outside), viewport).ringOffsets == std::vector<int>({0}));
+    assert(clipPolygonToViewport(CoordSpan(outside), viewport).empty());
+
+    // 5. 多边形包含整个视口时得到裁剪矩形
+    const std::vector<GeoPoint> cover = {at(-1000, -1000), at(1800, -1000), at(1800, 1600), at(-1000, 1600)};
+    auto coverResult = clipPolygonToViewport(CoordSpan(cover), viewport);
+    assert(coverResult.size() == 4);
+    for (const auto& p : coverResult) {
+        float x = 0.0f, y = 0.0f;
+        projectToScreen(CoordSpan(&p.lat, &p.lon, 1), viewport, &x, &y, nullptr);
+        assert((std::abs(x + 50) < 1e-3 || std::abs(x - 850) < 1e-3) && (std::abs(y + 50) < 1e-3 || std::abs(y - 650) < 1e-3));
+    }
+
+    // 6. 部分可见的三角形：一个顶点在视口内，另外两条边与右边界相交
+    const std::vector<GeoPoint> triangle = {at(700, 300), at(1500, 100), at(1500, 500)};
+    auto triangleResult = clipPolygonToViewport(CoordSpan(triangle), viewport);
+    assert(triangleResult.size() == 3);
+    // 环的起点可能变化，按顺序轮转到原顶点
+    const auto original = std::find_if(triangleResult.begin(), triangleResult.end(),
+        [&](const GeoPoint& p) { return p.lat == triangle[0].lat && p.lon == triangle[0].lon; });
+    assert(original != triangleResult.end());
+    std::rotate(triangleResult.begin(), original, triangleResult.end());
+    checkScreen(triangleResult[1], 850, 262.5);
+    checkScreen(triangleResult[2], 850, 337.5);
+
+    // 7. 按像素容差抽稀：起伏 0.2 像素的 10000 点直线只剩两个端点，容差为 0 时只去掉重复点
+    std::vector<GeoPoint> wiggle;
+    for (int i = 0; i < 10000; ++i) wiggle.push_back(at(100 + i * 0.06, 300 + ((i & 1) ? 0.2 : -0.2)));
+    assert(clipPolylineToViewport(CoordSpan(wiggle), viewport, 0.5).points.size() == 2);
+    assert(clipPolylineToViewport(CoordSpan(wiggle), viewport, 0.0).points.size() == wiggle.size());
+
+    // 8. 跨 180° 经线的线段保持连续
+    const ScreenViewport dateLine = makeScreenViewport(0.0, 180.0, 14.0, 800.0, 600.0, 0.0);
+    const std::vector<GeoPoint> across = {{0.0, 179.99}, {0.0, -179.99}};
+    auto acrossResult = clipPolylineToViewport(CoordSpan(across), dateLine);
+    assert(acrossResult.ringOffsets == std::vector<int>({0, 2}));
+
+    // 9. 大型行政区边界：半径 50 km、1,000,000 顶点的环，只有视口附近的部分交给 SDK
+    std::vector<GeoPoint> boundary;
+    const size_t boundaryCount = 1000000;
+    boundary.reserve(boundaryCount);
+    for (size_t i = 0; i < boundaryCount; ++i) {
+        const double angle = 2.0 * 3.14159265358979323846 * i / boundaryCount;
+        boundary.push_back(at(400 + 6800 * std::cos(angle) + 3.0 * std::sin(angle * 5000.0), 300 + 6800 * std::sin(angle)));
+    }
+    const ScreenViewport edge = makeScreenViewport(at(400 + 6800, 300).lat, at(400 + 6800, 300).lon, 14.0, 800.0, 600.0, 50.0);
+    auto t0 = std::chrono::high_resolution_clock::now();
+    auto polygonResult = clipPolygonToViewport(CoordSpan(boundary), edge);
+    auto t1 = std::chrono::high_resolution_clock::now();
+    auto polylineResult = clipPolylineToViewport(CoordSpan(boundary), edge);
+    auto t2 = std::chrono::high_resolution_clock::now();
+    assert(polygonResult.size() >= 3 && polygonResult.size() < 2000);
+    // 环的起点在视口中心，作为折线时分为起点、终点两段
+    assert(polylineResult.ringOffsets.size() == 3 && polylineResult.points.size() < 2000);
+    std::cout << "1,000,000-vertex boundary at z14: polygon " << std::chrono::duration<double, std::milli>(t1 - t0).count() << " ms ("
+              << polygonResult.size() << " vertices), polyline " << std::chrono::duration<double, std::milli>(t2 - t1).count() << " ms ("
+              << polylineResult.points.size() << " vertices)" << std::endl;
+
+    std::cout << "PASSED" << std::endl;
+}
+
+static GeoPoint hullTestPoint(double eastMeters, double northMeters) {
+    const double metersPerDegree = 6371000.0 * 3.14159265358979323846 / 180.0;
+    return {39.9 + northMeters / metersPerDegree, 116.4 + eastMeters / (metersPerDegree * std::cos(39.9 * 3.14159265358979323846 / 180.0))};
+}
+
+// 环逆时针、不自交，且每个点在环内或环上
+static void checkHull(const std::vector<GeoPoint>& hull, const std::vector<GeoPoint>& points) {
+    const size_t n = hull.size();
+    assert(n >= 3);
+    double twiceArea = 0.0;
+    for (size_t i = 0; i < n; ++i) {
+        const GeoPoint& a = hull[i];
+        const GeoPoint& b = hull[(i + 1) % n];
+        twiceArea += a.lon * b.lat - b.lon * a.lat;
+    }
+    assert(twiceArea > 0.0);
+
+    auto cross = [](const GeoPoint& o, const GeoPoint& a, const GeoPoint& b) {
+        return (a.lon - o.lon) * (b.lat - o.lat) - (a.lat - o.lat) * (b.lon - o.lon);
+    };
+    for (size_t i = 0; i < n; ++i) {
+        for (size_t j = i + 2; j < n; ++j) {
+            if (i == 0 && j == n - 1) continue;
+            const GeoPoint& a = hull[i];
+            const GeoPoint& b = hull[(i + 1) % n];
+            const GeoPoint& c = hull[j];
+            const GeoPoint& d = hull[(j + 1) % n];
+            const bool crosses = cross(a, b, c) * cross(a, b, d) < 0.0 && cross(c, d, a) * cross(c, d, b) < 0.0;
+            assert(!crosses);
+        }
+    }
+
+    std::vector<GeoPoint> closed = hull;
+    closed.push_back(hull[0]);
+    for (const auto& p : points) {
+        if (isPointInPolygon(p.lat, p.lon, hull)) continue;
+        assert(getNearestPointOnPath(closed, p).distanceMeters < 1e-3);
+    }
+}
+
+void testHulls() {
+    std::cout << "Running testHulls..." << std::endl;
+
+    // 1. 凸包：正方形四角 + 内部点 + 边上的共线点，只保留四角且逆时针
+    std::vector<GeoPoint> square = {
+        hullTestPoint(0, 0), hullTestPoint(50, 0), hullTestPoint(100, 0), hullTestPoint(100, 100),
+        hullTestPoint(30, 40), hullTestPoint(0, 100), hullTestPoint(60, 70), hullTestPoint(0, 50), hullTestPoint(100, 100)
+    };
+    auto convex = computeConvexHull(square);
+    assert(convex.size() == 4);
+    checkHull(convex, square);
+    for (const auto& p : convex) {
+        const bool corner = std::find_if(square.begin(), square.end(), [&p](const GeoPoint& q) {
+            return q.lat == p.lat && q.lon == p.lon;
+        }) != square.end();
+        assert(corner);
+    }
+
+    // 2. 退化输入
+    assert(computeConvexHull(std::vector<GeoPoint>()).empty());
+    assert(computeConvexHull(std::vector<GeoPoint>(3, hullTestPoint(5, 5))).size() == 1);
+    auto segment = computeConvexHull(std::vector<GeoPoint>{hullTestPoint(0, 0), hullTestPoint(20, 20), hullTestPoint(10, 10)});
+    assert(segment.size() == 2);
+    assert(computeConcaveHull(std::vector<GeoPoint>{hullTestPoint(0, 0), hullTestPoint(20, 20), hullTestPoint(10, 10)}, 1.0).size() == 2);
+
+    // 3. 跨 180° 经线的点集，顶点原样输出
+    std::vector<GeoPoint> dateLine = {{10.0, 179.999}, {10.001, 179.999}, {10.0, -179.999}, {10.001, -179.999}, {10.0005, 180.0}};
+    auto dateLineHull = computeConvexHull(dateLine);
+    assert(dateLineHull.size() == 4);
+    for (const auto& p : dateLineHull) assert(std::abs(p.lon) == 179.999);
+
+    // 4. 凹包：U 形点阵（间距 10 m），凸包会把开口填满
+    std::vector<GeoPoint> uShape;
+    for (int x = 0; x <= 30; ++x) {
+        for (int y = 0; y <= 30; ++y) {
+            if (x > 5 && x < 25 && y > 5) continue;
+            uShape.push_back(hullTestPoint(x * 10.0, y * 10.0));
+        }
+    }
+    auto uConvex = computeConvexHull(uShape);
+    auto uConcave = computeConcaveHull(uShape, 15.0);
+    checkHull(uConvex, uShape);
+    checkHull(uConcave, uShape);
+    const double convexArea = calculatePolygonArea(uConvex);
+    const double concaveArea = calculatePolygonArea(uConcave);
+    assert(approxEqual(convexArea, 90000.0, 90.0));
+    // 两条竖臂 50 x 300 + 底部 200 x 50，内侧两个拐角各留下一个对角线（14.1 m）切出的三角形
+    assert(approxEqual(concaveArea, 2 * 50.0 * 300.0 + 200.0 * 50.0 + 2 * 50.0, 5.0));
+    // 阈值足够大或不大于 0 时等价于凸包
+    assert(computeConcaveHull(uShape, 1000.0).size() == uConvex.size());
+    assert(computeConcaveHull(uShape, 0.0).size() == uConvex.size());
+
+    // 5. 随机点：Delaunay 剖分后的凹包仍包含全部点
+    uint32_t seed = 12345;
+    auto next = [&seed]() {
+        seed = seed * 1664525u + 1013904223u;
+        return (seed >> 8) / 16777216.0;
+    };
+    std::vector<GeoPoint> cloud;
+    for (int i = 0; i < 2000; ++i) {
+        const double r = 200.0 * std::sqrt(next());
+        const double angle = 2.0 * 3.14159265358979323846 * next();
+        cloud.push_back(hullTestPoint(r * std::cos(angle) * (1.0 + std::sin(angle * 3.0) * 0.5), r * std::sin(angle)));
+    }
+    auto cloudConvex = computeConvexHull(cloud);
+    auto cloudConcave = computeConcaveHull(cloud, 30.0);
+    checkHull(cloudConvex, cloud);
+    checkHull(cloudConcave, cloud);
+    assert(cloudConcave.size() > cloudConvex.size());
+    assert(calculatePolygonArea(cloudConcave) < calculatePolygonArea(cloudConvex));
+    assert(computeConcaveHull(cloud, 1e6).size() == cloudConvex.size());
+
+    // 6. 直接使用 clusterPoints 的结果批量计算
+    std::vector<ClusterPoint> clusterInput;
+    std::vector<double> lats;
+    std::vector<double> lons;
+    for (int group = 0; group < 3; ++group) {
+        for (int i = 0; i < 20; ++i) {
+            const GeoPoint p = hullTestPoint(group * 5000.0 + (next() - 0.5) * 200.0, (next() - 0.5) * 200.0);
+            clusterInput.push_back({p.lat, p.lon, static_cast<int>(lats.size())});
+            lats.push_back(p.lat);
+            lons.push_back(p.lon);
+        }
+    }
+    const GeoPoint lonely = hullTestPoint(20000.0, 0.0);
+    clusterInput.push_back({lonely.lat, lonely.lon, static_cast<int>(lats.size())});
+    lats.push_back(lonely.lat);
+    lons.push_back(lonely.lon);
+
+    auto clusters = clusterPoints(clusterInput, 500.0);
+    assert(clusters.size() == 4);
+    const CoordSpan span(lats.data(), lons.data(), lats.size());
+    for (double maxEdge : {0.0, 60.0}) {
+        auto hulls = computeClusterHulls(span, clusters, maxEdge);
+        assert(hulls.ringOffsets.size() == clusters.size() + 1);
+        for (size_t c = 0; c < clusters.size(); ++c) {
+            std::vector<GeoPoint> members;
+            for (int index : clusters[c].indices) members.push_back({lats[index], lons[index]});
+            std::vector<GeoPoint> ring(hulls.points.begin() + hulls.ringOffsets[c], hulls.points.begin() + hulls.ringOffsets[c + 1]);
+            if (members.size() == 1) {
+                assert(ring.size() == 1);
+                continue;
+            }
+            checkHull(ring, members);
+            if (maxEdge == 0.0) assert(ring.size() == computeConvexHull(members).size());
+        }
+    }
+
+    // 7. 性能：100,000 个点的凸包 / 凹包，1000 个簇批量计算
+    std::vector<GeoPoint> large;
+    large.reserve(100000);
+    for (int i = 0; i < 100000; ++i) {
+        const double r = 5000.0 * std::sqrt(next());
+        const double angle = 2.0 * 3.14159265358979323846 * next();
+        large.push_back(hullTestPoint(r * std::cos(angle), r * std::sin(angle) * (1.0 + 0.6 * std::cos(angle * 2.0))));
+    }
+    auto t0 = std::chrono::high_resolution_clock::now();
+    auto largeConvex = computeConvexHull(large);
+    auto t1 = std::chrono::high_resolution_clock::now();
+    auto largeConcave = computeConcaveHull(large, 150.0);
+    auto t2 = std::chrono::high_resolution_clock::now();
+    assert(largeConvex.size() >= 3 && largeConcave.size() > largeConvex.size());
+
+    // 每个簇的成员在中心 150 m 以内
+    std::vector<GeoPoint> members;
+    std::vector<ClusterOutput> batch(1000);
+    members.reserve(batch.size() * 100);
+    for (size_t c = 0; c < batch.size(); ++c) {
+        const GeoPoint& center = large[c];
+        batch[c].centerIndex = static_cast<int>(members.size());
+        for (int k = 0; k < 100; ++k) {
+            batch[c].indices.push_back(static_cast<int>(members.size()));
+            members.push_back({center.lat + (next() - 0.5) * 0.0027, center.lon + (next() - 0.5) * 0.0035});
+        }
+    }
+    auto t3 = std::chrono::high_resolution_clock::now();
+    auto batchHulls = computeClusterHulls(CoordSpan(members), batch, 50.0);
+    auto t4 = std::chrono::high_resolution_clock::now();
+    assert(batchHulls.ringOffsets.size() == batch.size() + 1);
+    std::cout << "Hulls of 100,000 points: convex " << std::chrono::duration<double, std::milli>(t1 - t0).count() << " ms ("
+              << largeConvex.size() << " vertices), concave " << std::chrono::duration<double, std::milli>(t2 - t1).count() << " ms ("
+              << largeConcave.size() << " vertices); 1000 clusters x 100 points: "
+              << std::chrono::duration<double, std::milli>(t4 - t3).count() << " ms" << std::endl;
+
+    std::cout << "PASSED" << std::endl;
+}
+
+void testResamplePolyline() {
+    std::cout << "Running testResamplePolyline..." << std::endl;
+
+    // L 形路线：向东 1000 m（每 37 m 一个顶点，含一个重复点），再向北 500 m
+    std::vector<GeoPoint> path;
+    for (double east = 0.0; east < 1000.0; east += 37.0) {
+        path.push_back(hullTestPoint(east, 0.0));
+        if (path.size() == 5) path.push_back(path.back());
+    }
+    path.push_back(hullTestPoint(1000.0, 0.0));
+    path.push_back(hullTestPoint(1000.0, 250.0));
+    path.push_back(hullTestPoint(1000.0, 500.0));
+    const double length = calculatePathLength(path);
+
+    std::vector<GeoPoint> even = resamplePolyline(path, 100.0);
+    assert(even.size() == 16);
+    assert(even.front().lat == path.front().lat && even.back().lon == path.back().lon);
+    double resampledLength = 0.0;
+    for (size_t i = 1; i < even.size(); ++i) {
+        // 沿路线等距，跨过转角的一对点按弦长更短
+        const double d = calculateDistance(even[i - 1].lat, even[i - 1].lon, even[i].lat, even[i].lon);
+        assert(d <= length / 15.0 + 1e-6 && d > 60.0);
+        resampledLength += d;
+    }
+    assert(resampledLength < length);
+
+    // 按个数：0、375、750、1125、1500 m
+    std::vector<GeoPoint> five = resamplePolylineByCount(path, 5);
+    assert(five.size() == 5);
+    const GeoPoint at750 = hullTestPoint(750.0, 0.0);
+    const GeoPoint at1125 = hullTestPoint(1000.0, 125.0);
+    assert(calculateDistance(five[2].lat, five[2].lon, at750.lat, at750.lon) < 0.5);
+    assert(calculateDistance(five[3].lat, five[3].lon, at1125.lat, at1125.lon) < 0.5);
+    assert(resamplePolylineByCount(path, 1).size() == 1 && resamplePolylineByCount(path, 0).empty());
+
+    // 保留转角：转角顶点原样输出，两侧各自均分
+    std::vector<GeoPoint> corners = resamplePolylinePreservingCorners(path, 100.0);
+    assert(corners.size() == 16);
+    const GeoPoint corner = hullTestPoint(1000.0, 0.0);
+    assert(corners[10].lat == corner.lat && corners[10].lon == corner.lon);
+    for (size_t i = 1; i < corners.size(); ++i) {
+        const double d = calculateDistance(corners[i - 1].lat, corners[i - 1].lon, corners[i].lat, corners[i].lon);
+        assert(approxEqual(d, 100.0, 0.5));
+    }
+    // 转角阈值大于 90° 时与普通重采样相同
+    assert(resamplePolylinePreservingCorners(path, 100.0, 120.0).size() == even.size());
+
+    // 边界情况
+    assert(resamplePolyline(std::vector<GeoPoint>(), 10.0).empty());
+    assert(resamplePolyline(path, 0.0).size() == path.size());
+    std::vector<GeoPoint> still = {path[0], path[0], path[0]};
+    assert(resamplePolyline(still, 10.0).size() == 1);
+    assert(resamplePolylineByCount(still, 3).size() == 3);
+
+    // 跨 180° 经线
+    std::vector<GeoPoint> dateline = {{0.0, 179.99}, {0.0, -179.99}};
+    std::vector<GeoPoint> crossed = resamplePolyline(dateline, 100.0);
+    assert(crossed.size() == 23);
+    for (size_t i = 1; i < crossed.size(); ++i) {
+        assert(std::abs(crossed[i].lon) <= 180.0);
+        assert(approxEqual(calculateDistance(crossed[i - 1].lat, crossed[i - 1].lon, crossed[i].lat, crossed[i].lon), 2223.9 / 22.0, 0.5));
+    }
+
+    // 1,000,000 点的路线按 10 m 重采样
+    std::vector<GeoPoint> longPath;
+    longPath.reserve(1000000);
+    for (int i = 0; i < 1000000; ++i) {
+        longPath.push_back(hullTestPoint(i * 3.0, std::sin(i * 0.001) * 500.0));
+    }
+    auto t0 = std::chrono::high_resolution_clock::now();
+    std::vector<GeoPoint> longResampled = resamplePolyline(longPath, 10.0);
+    auto t1 = std::chrono::high_resolution_clock::now();
+    assert(approxEqual(static_cast<double>(longResampled.size()), calculatePathLength(longPath) / 10.0, 2.0));
+    std::cout << "1,000,000-point polyline resampled to " << longResampled.size() << " points: "
+              << std::chrono::duration<double, std::milli>(t1 - t0).count() << " ms" << std::endl;
+
+    std::cout << "PASSED" << std::endl;
+}
+
+void testCoordinateTransform() {
+    std::cout << "Running testCoordinateTransform..." << std::endl;
+    const double pi = 3.14159265358979323846;
+    // 常见的逐点实现（14 次三角函数）
+    auto referenceWgsToGcj = [pi](double lat, double lon) {
+        if (lon < 72.004 || lon > 137.8347 || lat < 0.8293 || lat > 55.8271) return GeoPoint{lat, lon};
+        const double x = lon - 105.0, y = lat - 35.0;
+        double dLat = -100.0 + 2.0 * x + 3.0 * y + 0.2 * y * y + 0.1 * x * y + 0.2 * std::sqrt(std::abs(x));
+        dLat += (20.0 * std::sin(6.0 * x * pi) + 20.0 * std::sin(2.0 * x * pi)) * 2.0 / 3.0;
+        dLat += (20.0 * std::sin(y * pi) + 40.0 * std::sin(y / 3.0 * pi)) * 2.0 / 3.0;
+        dLat += (160.0 * std::sin(y / 12.0 * pi) + 320.0 * std::sin(y * pi / 30.0)) * 2.0 / 3.0;
+        double dLon = 300.0 + x + 2.0 * y + 0.1 * x * x + 0.1 * x * y + 0.1 * std::sqrt(std::abs(x));
+        dLon += (20.0 * std::sin(6.0 * x * pi) + 20.0 * std::sin(2.0 * x * pi)) * 2.0 / 3.0;
+        dLon += (20.0 * std::sin(x * pi) + 40.0 * std::sin(x / 3.0 * pi)) * 2.0 / 3.0;
+        dLon += (150.0 * std::sin(x / 12.0 * pi) + 300.0 * std::sin(x / 30.0 * pi)) * 2.0 / 3.0;
+        const double radLat = lat / 180.0 * pi;
+        double magic = std::sin(radLat);
+        magic = 1.0 - 0.00669342162296594323 * magic * magic;
+        const double sqrtMagic = std::sqrt(magic);
+        dLat = dLat * 180.0 / ((6378245.0 * (1.0 - 0.00669342162296594323)) / (magic * sqrtMagic) * pi);
+        dLon = dLon * 180.0 / (6378245.0 / sqrtMagic * std::cos(radLat) * pi);
+        return GeoPoint{lat + dLat, lon + dLon};
+    };
+
+    // 已知点：北京 / 上海 / 深圳
+    struct Case { double lat, lon, gcjLat, gcjLon, bdLat, bdLon; };
+    const Case cases[] = {
+        {39.9042, 116.4074, 39.90560334316507, 116.41364225378803, 39.91186533561899, 116.42004633029816},
+        {31.2304, 121.4737, 31.22845773757727, 121.47822305927693, 31.234310593689997, 121.484781468503},
+        {22.5431, 114.0579, 22.54038281422246, 114.06301399856547, 22.546041559073544, 114.06956398703267},
+    };
+    for (const Case& c : cases) {
+        GeoPoint gcj = convertCoordinate(c.lat, c.lon, CoordSystem::WGS84, CoordSystem::GCJ02);
+        assert(std::abs(gcj.lat - c.gcjLat) < 1e-11 && std::abs(gcj.lon - c.gcjLon) < 1e-11);
+        GeoPoint bd = convertCoordinate(c.lat, c.lon, CoordSystem::WGS84, CoordSystem::BD09);
+        assert(std::abs(bd.lat - c.bdLat) < 1e-11 && std::abs(bd.lon - c.bdLon) < 1e-11);
+        GeoPoint bdFromGcj = convertCoordinate(c.gcjLat, c.gcjLon, CoordSystem::GCJ02, CoordSystem::BD09);
+        assert(std::abs(bdFromGcj.lat - c.bdLat) < 1e-11 && std::abs(bdFromGcj.lon - c.bdLon) < 1e-11);
+
+        // 逆变换迭代到 1e-9° 以内（单步近似公式的误差在 1e-5° 量级）
+        GeoPoint wgs = convertCoordinate(c.gcjLat, c.gcjLon, CoordSystem::GCJ02, CoordSystem::WGS84);
+        assert(std::abs(wgs.lat - c.lat) < 1e-9 && std::abs(wgs.lon - c.lon) < 1e-9);
+        wgs = convertCoordinate(c.bdLat, c.bdLon, CoordSystem::BD09, CoordSystem::WGS84);
+        assert(std::abs(wgs.lat - c.lat) < 1e-9 && std::abs(wgs.lon - c.lon) < 1e-9);
+        gcj = convertCoordinate(c.bdLat, c.bdLon, CoordSystem::BD09, CoordSystem::GCJ02);
+        assert(std::abs(gcj.lat - c.gcjLat) < 1e-9 && std::abs(gcj.lon - c.gcjLon) < 1e-9);
+    }
+
+    // 境外不加偏，非有限坐标原样保留
+    assert(isOutOfChina(48.8566, 2.3522) && !isOutOfChina(39.9042, 116.4074));
+    GeoPoint paris = convertCoordinate(48.8566, 2.3522, CoordSystem::WGS84, CoordSystem::GCJ02);
+    assert(paris.lat == 48.8566 && paris.lon == 2.3522);
+    paris = convertCoordinate(48.8566, 2.3522, CoordSystem::GCJ02, CoordSystem::WGS84);
+    assert(paris.lat == 48.8566 && paris.lon == 2.3522);
+    const double nan = std::numeric_limits<double>::quiet_NaN();
+    for (CoordSystem to : {CoordSystem::WGS84, CoordSystem::GCJ02, CoordSystem::BD09}) {
+        GeoPoint p = convertCoordinate(nan, 116.0, CoordSystem::BD09, to);
+        assert(std::isnan(p.lat) && p.lon == 116.0);
+    }
+
+    // 批量：与单点结果逐位一致，与逐点参考实现相差在舍入级别
+    std::vector<GeoPoint> points;
+    uint32_t seed = 7;
+    for (int i = 0; i < 20000; ++i) {
+        seed = seed * 1664525u + 1013904223u;
+        const double a = (seed >> 8) / static_cast<double>(1u << 24);
+        seed = seed * 1664525u + 1013904223u;
+        const double b = (seed >> 8) / static_cast<double>(1u << 24);
+        points.push_back({a * 60.0 - 2.0, b * 70.0 + 70.0});  // 覆盖境内外
+    }
+    const CoordSystem systems[] = {CoordSystem::WGS84, CoordSystem::GCJ02, CoordSystem::BD09};
+    for (CoordSystem from : systems) {
+        for (CoordSystem to : systems) {
+            std::vector<GeoPoint> converted = points;
+            convertCoordinates(converted, from, to);
+            std::vector<double> lats(points.size()), lons(points.size());
+            for (size_t i = 0; i < points.size(); ++i) {
+                lats[i] = points[i].lat;
+                lons[i] = points[i].lon;
+            }
+            convertCoordinates(lats.data(), lons.data(), lats.size(), from, to);
+            for (size_t i = 0; i < points.size(); i += 7) {
+                const GeoPoint single = convertCoordinate(points[i].lat, points[i].lon, from, to);
+                assert(converted[i].lat == single.lat && converted[i].lon == single.lon);
+                assert(lats[i] == single.lat && lons[i] == single.lon);
+            }
+        }
+    }
+    double maxError = 0.0;
+    double maxRoundTrip = 0.0;
+    std::vector<GeoPoint> gcjPoints = points;
+    convertCoordinates(gcjPoints, CoordSystem::WGS84, CoordSystem::GCJ02);
+    std::vector<GeoPoint> back = gcjPoints;
+    convertCoordinates(back, CoordSystem::GCJ02, CoordSystem::WGS84);
+    for (size_t i = 0; i < points.size(); ++i) {
+        const GeoPoint expected = referenceWgsToGcj(points[i].lat, points[i].lon);
+        maxError = std::max(maxError, std::max(std::abs(gcjPoints[i].lat - expected.lat), std::abs(gcjPoints[i].lon - expected.lon)));
+        if (!isOutOfChina(gcjPoints[i].lat, gcjPoints[i].lon) && !isOutOfChina(points[i].lat, points[i].lon)) {
+            maxRoundTrip = std::max(maxRoundTrip, std::max(std::abs(back[i].lat - points[i].lat), std::abs(back[i].lon - points[i].lon)));
+        }
+    }
+    assert(maxError < 1e-11);
+    assert(maxRoundTrip < 1e-9);
+
+    // 性能：逐点参考实现 vs 批量原地转换
+    std::vector<GeoPoint> many(1000000);
+    for (auto& p : many) {
+        seed = seed * 1664525u + 1013904223u;
+        p.lat = 22.0 + (seed >> 8) / static_cast<double>(1u << 24) * 18.0;
+        seed = seed * 1664525u + 1013904223u;
+        p.lon = 104.0 + (seed >> 8) / static_cast<double>(1u << 24) * 18.0;
+    }
+    std::vector<GeoPoint> out(many.size());
+    auto t0 = std::chrono::high_resolution_clock::now();
+    for (size_t i = 0; i < many.size(); ++i) {
+        out[i] = referenceWgsToGcj(many[i].lat, many[i].lon);
+    }
+    auto t1 = std::chrono::high_resolution_clock::now();
+    out = many;
+    auto t2 = std::chrono::high_resolution_clock::now();
+    convertCoordinates(out, CoordSystem::WGS84, CoordSystem::GCJ02);
+    auto t3 = std::chrono::high_resolution_clock::now();
+    convertCoordinates(out, CoordSystem::GCJ02, CoordSystem::WGS84);
+    auto t4 = std::chrono::high_resolution_clock::now();
+    auto ms = [](std::chrono::high_resolution_clock::time_point a, std::chrono::high_resolution_clock::time_point b) {
+        return std::chrono::duration<double, std::milli>(b - a).count();
+    };
+    std::cout << "1,000,000 WGS-84 -> GCJ-02: per-point " << ms(t0, t1) << " ms, batch " << ms(t2, t3)
+              << " ms; GCJ-02 -> WGS-84 (iterative) " << ms(t3, t4) << " ms" << std::endl;
+
+    std::cout << "PASSED" << std::endl;
+}
+
+// 校验避让结果：可见标记（含标注）两两不相交，视口内被隐藏的标记一定与某个可见矩形相交
+void testStreamingBounds() {
+    std::cout << "Running testStreamingBounds..." << std::endl;
+    const double pi = 3.14159265358979323846;
+    // 原实现：投影后排序求最大经度空隙
+    auto referenceFitZoom = [pi](const std::vector<GeoPoint>& points, double w, double h, double padding, int minZoom, int maxZoom) {
+        if (points.empty()) return static_cast<double>(minZoom);
+        if (points.size() == 1) return static_cast<double>(maxZoom);
+        std::vector<double> xs;
+        double minY = 1e300, maxY = -1e300;
+        for (const auto& p : points) {
+            double wrapped = std::fmod(p.lon + 180.0, 360.0);
+            if (wrapped < 0.0) wrapped += 360.0;
+            xs.push_back(wrapped / 360.0);
+            const double lat = std::max(-85.05112878, std::min(85.05112878, p.lat));
+            const double y = (1.0 - std::asinh(std::tan(lat * pi / 180.0)) / pi) / 2.0;
+            minY = std::min(minY, y);
+            maxY = std::max(maxY, y);
+        }
+        std::sort(xs.begin(), xs.end());
+        double maxGap = xs.front() + 1.0 - xs.back();
+        for (size_t i = 0; i + 1 < xs.size(); ++i) maxGap = std::max(maxGap, xs[i + 1] - xs[i]);
+        const double spanX = std::max(0.0, 1.0 - maxGap);
+        const double spanY = std::max(0.0, maxY - minY);
+        const double aw = std::max(1.0, w - padding * 2.0);
+        const double ah = std::max(1.0, h - padding * 2.0);
+        const double zx = spanX <= 1e-12 ? maxZoom : std::log2(aw / (256.0 * spanX));
+        const double zy = spanY <= 1e-12 ? maxZoom : std::log2(ah / (256.0 * spanY));
+        return std::max<double>(minZoom, std::min<double>(maxZoom, std::min(zx, zy)));
+    };
+
+    // 1. 跨 180° 经线：取经过经线的短边
+    std::vector<GeoPoint> pacific = {{-17.7, 178.0}, {-18.1, -179.0}, {-16.5, 179.5}, {-17.0, -178.2}};
+    const PathBounds wrapped = calculateWrappedPathBounds(pacific);
+    assert(approxEqual(wrapped.west, 178.0, 1e-9) && approxEqual(wrapped.east, -178.2, 1e-9));
+    assert(wrapped.west > wrapped.east);
+    assert(approxEqual(wrapped.centerLon, 179.9, 1e-9));
+    assert(wrapped.north == -16.5 && wrapped.south == -18.1);
+    const PathBounds plain = calculatePathBounds(pacific);
+    assert(plain.west == -179.0 && plain.east == 179.5);
+
+    // 不跨经线时与 calculatePathBounds 完全一致
+    std::vector<GeoPoint> city = {{39.90, 116.30}, {39.95, 116.45}, {39.85, 116.40}};
+    const PathBounds a = calculateWrappedPathBounds(city);
+    const PathBounds b = calculatePathBounds(city);
+    assert(a.north == b.north && a.south == b.south && a.east == b.east && a.west == b.west);
+    assert(a.centerLat == b.centerLat && a.centerLon == b.centerLon);
+
+    // 空输入 / 无效点
+    const PathBounds empty = calculateWrappedPathBounds(std::vector<GeoPoint>{});
+    const PathBounds legacyEmpty = calculatePathBounds(std::vector<GeoPoint>{});
+    assert(empty.north == legacyEmpty.north && empty.south == legacyEmpty.south);
+    assert(empty.west == legacyEmpty.west && empty.east == legacyEmpty.east);
+    const double nan = std::numeric_limits<double>::quiet_NaN();
+    std::vector<GeoPoint> withNaN = {{nan, 10.0}, {30.0, 120.0}, {31.0, nan}, {32.0, 121.0}};
+    const PathBounds skipped = calculateWrappedPathBounds(withNaN);
+    assert(skipped.south == 30.0 && skipped.north == 32.0 && skipped.west == 120.0 && skipped.east == 121.0);
+
+    // 2. 与排序实现一致（点数不超过桶数时精确）
+    assert(approxEqual(calculateFitZoomForPoints(pacific, 390, 844, 48, 3, 20), referenceFitZoom(pacific, 390, 844, 48, 3, 20), 1e-9));
+    uint32_t seed = 37;
+    auto next = [&seed]() {
+        seed = seed * 1664525u + 1013904223u;
+        return (seed >> 8) / static_cast<double>(1u << 24);
+    };
+    for (int round = 0; round < 200; ++round) {
+        const size_t count = 2 + static_cast<size_t>(next() * 60);
+        const double centerLon = next() * 360.0 - 180.0;
+        const double spread = next() < 0.5 ? next() * 5.0 : next() * 300.0;
+        std::vector<GeoPoint> points;
+        for (size_t i = 0; i < count; ++i) {
+            double lon = centerLon + (next() - 0.5) * spread;
+            if (lon >= 180.0) lon -= 360.0;
+            if (lon < -180.0) lon += 360.0;
+            points.push_back({next() * 120.0 - 60.0, lon});
+        }
+        assert(approxEqual(calculateFitZoomForPoints(points, 390, 844, 48, 0, 20), referenceFitZoom(points, 390, 844, 48, 0, 20), 1e-9));
+    }
+
+    // 3. 分块累加 / 合并与整体计算一致
+    std::vector<GeoPoint> route;
+    for (int i = 0; i < 200000; ++i) {
+        double lon = 170.0 + next() * 25.0;
+        if (lon >= 180.0) lon -= 360.0;
+        route.push_back({50.0 + next() * 10.0, lon});
+    }
+    const CoordSpan routeSpan(route);
+    BoundsAccumulator whole;
+    whole.add(routeSpan);
+    BoundsAccumulator chunked;
+    BoundsAccumulator second;
+    for (size_t offset = 0; offset < route.size(); offset += 4096) {
+        const CoordSpan chunk = routeSpan.subspan(offset, std::min<size_t>(4096, route.size() - offset));
+        (offset < route.size() / 2 ? chunked : second).add(chunk);
+    }
+    chunked.merge(second);
+    assert(chunked.count() == whole.count() && whole.count() == route.size());
+    const PathBounds wb = whole.bounds();
+    const PathBounds cb = chunked.bounds();
+    assert(wb.west == cb.west && wb.east == cb.east && wb.north == cb.north && wb.south == cb.south);
+    assert(wb.west > 169.9 && wb.west < 170.1 && wb.east > -165.1 && wb.east < -164.9);
+    assert(whole.fitZoom(390, 844, 48, 3, 20) == chunked.fitZoom(390, 844, 48, 3, 20));
+    assert(approxEqual(whole.fitZoom(390, 844, 48, 3, 20), referenceFitZoom(route, 390, 844, 48, 3, 20), 1e-9));
+
+    // 点数远多于桶数且布满全部经度时，结果只会略小（跨度偏大）
+    std::vector<GeoPoint> global;
+    for (int i = 0; i < 100000; ++i) {
+        global.push_back({next() * 120.0 - 60.0, next() * 360.0 - 180.0});
+    }
+    const double globalZoom = calculateFitZoomForPoints(global, 2048, 2048, 0, 0, 20);
+    const double globalReference = referenceFitZoom(global, 2048, 2048, 0, 0, 20);
+    assert(globalZoom <= globalReference + 1e-12 && globalReference - globalZoom < 0.002);
+
+    // 4. 基准：排序实现 vs 直方图
+    auto t0 = std::chrono::high_resolution_clock::now();
+    volatile double sink = referenceFitZoom(route, 390, 844, 48, 3, 20);
+    auto t1 = std::chrono::high_resolution_clock::now();
+    sink = calculateFitZoomForPoints(route, 390, 844, 48, 3, 20);
+    auto t2 = std::chrono::high_resolution_clock::now();
+    (void)sink;
+    std::cout << "  fit zoom (" << route.size() << " points): sort "
+              << std::chrono::duration<double, std::milli>(t1 - t0).count() << " ms, histogram "
+              << std::chrono::duration<double, std::milli>(t2 - t1).count() << " ms" << std::endl;
+
+    std::cout << "PASSED" << std::endl;
+}
+
+static void checkCollisionLayout(const std::vector<CollisionItem>& items, const ScreenViewport& viewport, const CollisionUpdate& update) {
+    struct Box { double minX, minY, maxX, maxY; int owner; };
+    auto overlaps = [](const Box& a, const Box& b) {
+        return a.minX < b.maxX && b.minX < a.maxX && a.minY < b.maxY && b.minY < a.maxY;
+    };
+    std::map<int, const CollisionItem*> byId;
+    for (const auto& item : items) byId[item.id] = &item;
+
+    std::vector<Box> boxes;
+    std::map<int, bool> visible;
+    for (const auto& placement : update.visible) {
+        const CollisionItem& item = *byId[placement.id];
+        visible[placement.id] = true;
+        const double minX = placement.screenX - item.anchorX * item.width;
+        const double minY = placement.screenY - item.anchorY * item.height;
+        boxes.push_back({minX - item.padding, minY - item.padding, minX + item.width + item.padding, minY + item.height + item.padding, item.id});
+        if (placement.label != LabelPlacement::None) {
+            const double w = item.labelWidth, h = item.labelHeight, g = item.labelGap;
+            double lx = 0.0, ly = 0.0;
+            switch (placement.label) {
+                case LabelPlacement::Right: lx = minX + item.width + g; ly = minY + item.height / 2 - h / 2; break;
+                case LabelPlacement::Left: lx = minX - g - w; ly = minY + item.height / 2 - h / 2; break;
+                case LabelPlacement::Bottom: lx = minX + item.width / 2 - w / 2; ly = minY + item.height + g; break;
+                default: lx = minX + item.width / 2 - w / 2; ly = minY - g - h; break;
+            }
+            boxes.push_back({lx - item.padding, ly - item.padding, lx + w + item.padding, ly + h + item.padding, item.id});
+        }
+    }
+    for (size_t i = 0; i < boxes.size(); ++i) {
+        for (size_t j = i + 1; j < boxes.size(); ++j) {
+            if (boxes[i].owner == boxes[j].owner) continue;  // 标注与自身标记的外扩区域可以重叠
+            Box a = boxes[i], b = boxes[j];
+            // 屏幕坐标为 float，留出舍入余量
+            a.minX += 1e-3; a.minY += 1e-3; a.maxX -= 1e-3; a.maxY -= 1e-3;
+            assert(!overlaps(a, b));
+        }
+    }
+    std::vector<float> sx(items.size()), sy(items.size());
+    std::vector<GeoPoint> anchors;
+    for (const auto& item : items) anchors.push_back({item.lat, item.lon});
+    projectToScreen(CoordSpan(anchors), viewport, sx.data(), sy.data(), nullptr);
+    for (size_t i = 0; i < items.size(); ++i) {
+        const CollisionItem& item = items[i];
+        if (visible.count(item.id)) continue;
+        const double minX = sx[i] - item.anchorX * item.width - item.padding;
+        const double minY = sy[i] - item.anchorY * item.height - item.padding;
+        const Box box = {minX + 1e-3, minY + 1e-3, minX + item.width + 2 * item.padding - 1e-3, minY + item.height + 2 * item.padding - 1e-3, item.id};
+        const Box view = {-viewport.margin, -viewport.margin, viewport.width + viewport.margin, viewport.height + viewport.margin, -1};
+        if (!overlaps(box, view)) continue;
+        bool blocked = false;
+        for (const auto& b : boxes) blocked = blocked || overlaps(box, b);
+        assert(blocked);
+    }
+}
+
+void testCollisionEngine() {
+    std::cout << "Running testCollisionEngine..." << std::endl;
+    const double zoom = 16.0;
+    const ScreenViewport viewport = makeScreenViewport(39.9042, 116.4074, zoom, 400.0, 400.0, 0.0);
+    // 屏幕像素偏移转经纬度，便于构造用例
+    auto at = [&](double sx, double sy) {
+        return pixelToLatLng(viewport.originX + sx, viewport.originY + sy, static_cast<int>(zoom));
+    };
+    auto makeItem = [&](int id, double sx, double sy, int priority) {
+        const GeoPoint p = at(sx, sy);
+        CollisionItem item;
+        item.id = id;
+        item.lat = p.lat;
+        item.lon = p.lon;
+        item.width = 20.0f;
+        item.height = 20.0f;
+        item.priority = priority;
+        return item;
+    };
+
+    // 1. 重叠时优先级高者显示，优先级相同时 id 小者显示
+    CollisionEngine engine(32.0f);
+    std::vector<CollisionItem> items = {
+        makeItem(1, 100, 100, 1),
+        makeItem(2, 110, 105, 5),
+        makeItem(3, 300, 300, 0),
+        makeItem(4, 305, 300, 0),
+        makeItem(5, 200, 200, 0),
+        makeItem(6, 200, 1000, 9)   // 视口外
+    };
+    engine.setItems(items);
+    CollisionUpdate update = engine.update(viewport);
+    assert(update.fullLayout);
+    assert(update.visible.size() == 3);
+    assert(update.visible[0].id == 2 && update.visible[1].id == 3 && update.visible[2].id == 5);
+    assert(update.shown == std::vector<int>({2, 3, 5}) && update.hidden.empty());
+    assert(std::abs(update.visible[2].screenX - 200.0f) < 1e-3f && std::abs(update.visible[2].screenY - 200.0f) < 1e-3f);
+    checkCollisionLayout(items, viewport, update);
+
+    // 2. 标注：标注同样占用空间；右侧被占用时改放左侧，四个方向都放不下时只显示标记
+    items = {makeItem(1, 200, 200, 5), makeItem(2, 240, 190, 1), makeItem(3, 50, 50, 0)};
+    items[0].labelWidth = 40.0f;
+    items[0].labelHeight = 12.0f;
+    items[2].labelWidth = 30.0f;
+    items[2].labelHeight = 10.0f;
+    engine.setItems(items);
+    update = engine.update(viewport);
+    assert(update.visible.size() == 2 && update.visible[1].id == 3);
+    assert(update.visible[0].label == LabelPlacement::Right);   // 高优先级先放置，标注挡住了 2
+    assert(update.visible[1].label == LabelPlacement::Right);
+    checkCollisionLayout(items, viewport, update);
+    items[0].priority = 0;
+    items[1].priority = 5;
+    engine.setItems(items);
+    update = engine.update(viewport);
+    assert(update.visible.size() == 3 && update.visible[0].label == LabelPlacement::Left);
+    checkCollisionLayout(items, viewport, update);
+    items.push_back(makeItem(4, 160, 190, 9));
+    items.push_back(makeItem(5, 200, 225, 9));
+    items.push_back(makeItem(6, 200, 170, 9));
+    items[4].width = items[5].width = 60.0f;
+    engine.setItems(items);
+    update = engine.update(viewport);
+    bool sawUnlabeled = false;
+    for (const auto& v : update.visible) {
+        if (v.id == 1) sawUnlabeled = v.label == LabelPlacement::None;
+    }
+    assert(sawUnlabeled);
+    checkCollisionLayout(items, viewport, update);
+
+    // 3. 平移：沿用已放置的标记，只放置新进入视口的标记
+    items = {makeItem(1, 405, 200, 1), makeItem(2, 440, 200, 9), makeItem(3, 100, 100, 0), makeItem(4, 200, 200, 0)};
+    items[1].width = 60.0f;   // 与 1 重叠，但初始位于视口外
+    engine.setItems(items);
+    update = engine.update(viewport);
+    assert(update.visible.size() == 3 && update.visible[0].id == 1);
+    ScreenViewport panned = viewport;
+    panned.originX += 100.0;
+    update = engine.update(panned);
+    assert(!update.fullLayout);
+    assert(update.shown.empty() && update.hidden.empty());
+    assert(update.visible.size() == 3 && update.visible[0].id == 1);   // 已显示的低优先级标记保持不动
+    assert(std::abs(update.visible[0].screenX - 305.0f) < 1e-3f);
+    checkCollisionLayout(items, panned, update);
+    // 离开视口的标记被隐藏，之前被遮挡的标记获得空间
+    panned.originX -= 400.0;
+    update = engine.update(panned);
+    assert(!update.fullLayout);
+    assert(update.hidden == std::vector<int>({1, 4}) && update.shown.empty());
+    panned.originX += 400.0;
+    update = engine.update(panned);
+    assert(update.shown == std::vector<int>({2, 4}));   // 重新进入时按优先级放置
+    checkCollisionLayout(items, panned, update);
+    // 缩放或 invalidate 后完整重排
+    engine.invalidate();
+    assert(engine.update(panned).fullLayout);
+    // 只改变 margin 同样完整重排，结果与重新计算一致
+    ScreenViewport widened = panned;
+    widened.margin = 200.0;
+    update = engine.update(widened);
+    assert(update.fullLayout);
+    checkCollisionLayout(items, widened, update);
+    assert(!engine.update(widened).fullLayout);
+    ScreenViewport zoomed = makeScreenViewport(39.9042, 116.4074, 17.0, 400.0, 400.0, 0.0);
+    update = engine.update(zoomed);
+    assert(update.fullLayout);
+    checkCollisionLayout(items, zoomed, update);
+
+    // 4. 跨 180° 经线
+    const ScreenViewport dateLine = makeScreenViewport(0.0, 180.0, 10.0, 400.0, 400.0, 0.0);
+    std::vector<CollisionItem> wrapItems(2);
+    wrapItems[0] = {1, 0.0, 179.9, 16.0f, 16.0f};
+    wrapItems[1] = {2, 0.0, -179.9, 16.0f, 16.0f};
+    engine.setItems(wrapItems);
+    update = engine.update(dateLine);
+    assert(update.visible.size() == 2 && update.visible[0].screenX < 200.0f && update.visible[1].screenX > 200.0f);
+    checkCollisionLayout(wrapItems, dateLine, update);
+
+    // 5. 随机数据：完整重排与连续平移都满足不相交与极大性
+    std::vector<CollisionItem> pois;
+    uint32_t seed = 11;
+    auto rnd = [&seed]() {
+        seed = seed * 1664525u + 1013904223u;
+        return (seed >> 8) / static_cast<double>(1u << 24);
+    };
+    for (int i = 0; i < 50000; ++i) {
+        CollisionItem item;
+        item.id = i;
+        item.lat = 39.80 + rnd() * 0.2;
+        item.lon = 116.30 + rnd() * 0.2;
+        item.width = 24.0f;
+        item.height = 32.0f;
+        item.padding = 2.0f;
+        item.priority = static_cast<int>(rnd() * 10);
+        if (i % 3 == 0) {
+            item.labelWidth = 48.0f;
+            item.labelHeight = 14.0f;
+        }
+        pois.push_back(item);
+    }
+    CollisionEngine poiEngine;
+    poiEngine.setItems(pois);
+    ScreenViewport moving = makeScreenViewport(39.9, 116.4, 15.0, 1080.0, 1920.0, 64.0);
+    auto t0 = std::chrono::high_resolution_clock::now();
+    update = poiEngine.update(moving);
+    auto t1 = std::chrono::high_resolution_clock::now();
+    checkCollisionLayout(pois, moving, update);
+    const size_t initialVisible = update.visible.size();
+    size_t changed = 0;
+    auto t2 = std::chrono::high_resolution_clock::now();
+    for (int frame = 0; frame < 60; ++frame) {
+        moving.originX += 7.0;
+        moving.originY -= 5.0;
+        update = poiEngine.update(moving);
+        assert(!update.fullLayout);
+        changed += update.shown.size() + update.hidden.size();
+    }
+    auto t3 = std::chrono::high_resolution_clock::now();
+    checkCollisionLayout(pois, moving, update);
+    std::cout << "50,000 POIs: full layout " << std::chrono::duration<double, std::milli>(t1 - t0).count()
+              << " ms (" << initialVisible << " visible), pan frame avg "
+              << std::chrono::duration<double, std::milli>(t3 - t2).count() / 60.0 << " ms, "
+              << changed << " show/hide changes over 60 frames" << std::endl;
+
+    std::cout << "PASSED" << std::endl;
+}
+
+// 以 (39.9, 116.4) 为原点、按米偏移构造的坐标
+static GeoPoint clipperTestPoint(double eastMeters, double northMeters) {
+    const double metersPerDegree = 6371000.0 * 3.14159265358979323846 / 180.0;
+    return {39.9 + northMeters / metersPerDegree, 116.4 + eastMeters / (metersPerDegree * std::cos(39.9 * 3.14159265358979323846 / 180.0))};
+}
+
+static std::vector<GeoPoint> clipperTestRect(double minX, double minY, double maxX, double maxY) {
+    return {clipperTestPoint(minX, minY), clipperTestPoint(maxX, minY), clipperTestPoint(maxX, maxY), clipperTestPoint(minX, maxY)};
+}
+
+// 外环面积减去洞面积；同时检查外环逆时针、洞顺时针
+static double clipperResultArea(const std::vector<PolygonRings>& polygons) {
+    auto signedArea = [](const std::vector<GeoPoint>& ring) {
+        double sum = 0.0;
+        for (size_t i = 0, j = ring.size() - 1; i < ring.size(); j = i++) {
+            sum += ring[j].lon * ring[i].lat - ring[i].lon * ring[j].lat;
+        }
+        return sum;
+    };
+    double total = 0.0;
+    for (const auto& polygon : polygons) {
+        assert(!polygon.empty());
+        for (size_t r = 0; r < polygon.size(); ++r) {
+            assert(polygon[r].size() >= 3);
+            assert(r == 0 ? signedArea(polygon[r]) > 0.0 : signedArea(polygon[r]) < 0.0);
+            const double area = calculatePolygonArea(polygon[r]);
+            total += r == 0 ? area : -area;
+        }
+    }
+    return total;
+}
+
+void testPolygonClipper() {
+    std::cout << "Running testPolygonClipper..." << std::endl;
+    const PolygonRings a = {clipperTestRect(0, 0, 1000, 1000)};
+    const PolygonRings b = {clipperTestRect(500, 500, 1500, 1500)};
+    const double areaA = calculatePolygonArea(a[0]);
+    const double areaB = calculatePolygonArea(b[0]);
+
+    // 两个部分重叠的正方形
+    auto unionAB = polygonBoolean(a, b, BooleanOp::Union);
+    auto interAB = polygonBoolean(a, b, BooleanOp::Intersection);
+    auto diffAB = polygonBoolean(a, b, BooleanOp::Difference);
+    auto xorAB = polygonBoolean(a, b, BooleanOp::Xor);
+    assert(unionAB.size() == 1 && unionAB[0].size() == 1 && unionAB[0][0].size() == 8);
+    assert(interAB.size() == 1 && interAB[0][0].size() == 4);
+    assert(diffAB.size() == 1 && diffAB[0][0].size() == 6);
+    assert(xorAB.size() == 2);
+    const double areaI = clipperResultArea(interAB);
+    assert(std::abs(areaI / (areaA * 0.25) - 1.0) < 1e-4);
+    assert(std::abs(clipperResultArea(unionAB) / (areaA + areaB - areaI) - 1.0) < 1e-6);
+    assert(std::abs(clipperResultArea(diffAB) / (areaA - areaI) - 1.0) < 1e-6);
+    assert(std::abs(clipperResultArea(xorAB) / (areaA + areaB - 2.0 * areaI) - 1.0) < 1e-6);
+    assert(polygonBoolean(a, {}, BooleanOp::Intersection).empty());
+    assert(polygonBoolean(b, a, BooleanOp::Difference).size() == 1);
+
+    // 共边：合并后共线点被去掉，只剩 4 个顶点；只接触一个角时保持为两个多边形
+    auto merged = polygonBoolean(a, {clipperTestRect(1000, 0, 2000, 1000)}, BooleanOp::Union);
+    assert(merged.size() == 1 && merged[0].size() == 1 && merged[0][0].size() == 4);
+    assert(std::abs(clipperResultArea(merged) / (2.0 * areaA) - 1.0) < 1e-4);
+    assert(polygonBoolean(a, {clipperTestRect(1000, 1000, 2000, 2000)}, BooleanOp::Union).size() == 2);
+    assert(polygonBoolean(a, {clipperTestRect(1000, 0, 2000, 1000)}, BooleanOp::Intersection).empty());
+
+    // 挖洞：大正方形减去内部小正方形，再与跨过洞的矩形求并
+    auto withHole = polygonBoolean(a, {clipperTestRect(400, 400, 600, 600)}, BooleanOp::Difference);
+    assert(withHole.size() == 1 && withHole[0].size() == 2);
+    assert(std::abs(clipperResultArea(withHole) / (areaA * 0.96) - 1.0) < 1e-4);
+    auto bridged = polygonBoolean(withHole[0], {clipperTestRect(450, -100, 550, 1100)}, BooleanOp::Union);
+    assert(bridged.size() == 1 && bridged[0].size() == 3);
+    // 输入带洞时按奇偶规则，洞的方向无关
+    PolygonRings sameDirection = {clipperTestRect(0, 0, 1000, 1000), clipperTestRect(400, 400, 600, 600)};
+    assert(std::abs(clipperResultArea(polygonBoolean(sameDirection, {}, BooleanOp::Union)) / clipperResultArea(withHole) - 1.0) < 1e-9);
+
+    // 自交的 8 字形规整化为两个三角形
+    PolygonRings bowtie = {{clipperTestPoint(0, 0), clipperTestPoint(1000, 1000), clipperTestPoint(1000, 0), clipperTestPoint(0, 1000)}};
+    auto normalized = bufferPolygon(bowtie, 0.0);
+    assert(normalized.size() == 2 && normalized[0][0].size() == 3 && normalized[1][0].size() == 3);
+    assert(std::abs(clipperResultArea(normalized) / (areaA * 0.5) - 1.0) < 1e-4);
+
+    // 缓冲区：扩张面积为 s² + 4sd + πd²（圆弧内接折线略小），收缩面积为 (s - 2d)²
+    const double side = std::sqrt(areaA);
+    auto grown = bufferPolygon(a, 100.0);
+    assert(grown.size() == 1 && grown[0].size() == 1);
+    const double grownExpected = side * side + 4.0 * side * 100.0 + 3.14159265358979323846 * 100.0 * 100.0;
+    const double grownArea = clipperResultArea(grown);
+    assert(grownArea < grownExpected && grownArea > grownExpected * 0.999);
+    auto shrunk = bufferPolygon(a, -100.0);
+    assert(shrunk.size() == 1 && shrunk[0][0].size() == 4);
+    assert(std::abs(clipperResultArea(shrunk) / ((side - 200.0) * (side - 200.0)) - 1.0) < 1e-3);
+    assert(bufferPolygon(a, -600.0).empty());
+    // 带洞多边形扩张时洞缩小，洞宽度小于 2d 时消失
+    auto holeShrunk = bufferPolygon(withHole[0], 50.0);
+    assert(holeShrunk.size() == 1 && holeShrunk[0].size() == 2);
+    assert(bufferPolygon(withHole[0], 120.0)[0].size() == 1);
+    // 收缩把哑铃形从细颈处断开
+    PolygonRings dumbbell = {clipperTestRect(0, 0, 400, 400)};
+    dumbbell = polygonBoolean(dumbbell, {clipperTestRect(600, 0, 1000, 400)}, BooleanOp::Union)[0];
+    dumbbell.resize(1);
+    PolygonRings neck = {clipperTestRect(0, 0, 400, 400), clipperTestRect(600, 0, 1000, 400), clipperTestRect(350, 150, 650, 250)};
+    auto neckUnion = polygonBoolean({neck[0]}, {neck[1], neck[2]}, BooleanOp::Union, FillRule::NonZero);
+    assert(neckUnion.size() == 1);
+    assert(bufferPolygon(neckUnion[0], -60.0).size() == 2);
+
+    // 带随机起伏的圆形围栏：amplitude 较大时为尖刺很多的星形，交点数量大
+    auto star = [](double cx, double cy, size_t n, double amplitude, uint32_t seed) {
+        std::vector<GeoPoint> ring;
+        for (size_t i = 0; i < n; ++i) {
+            seed = seed * 1664525u + 1013904223u;
+            const double radius = 3000.0 + (seed >> 8) / static_cast<double>(1u << 24) * amplitude;
+            const double angle = 2.0 * 3.14159265358979323846 * i / n;
+            ring.push_back(clipperTestPoint(cx + radius * std::cos(angle), cy + radius * std::sin(angle)));
+        }
+        return ring;
+    };
+    auto checkSum = [](const PolygonRings& a, const PolygonRings& b) {
+        const double sum = clipperResultArea(polygonBoolean(a, b, BooleanOp::Union)) + clipperResultArea(polygonBoolean(a, b, BooleanOp::Intersection));
+        assert(std::abs(sum / (calculatePolygonArea(a[0]) + calculatePolygonArea(b[0])) - 1.0) < 1e-6);
+        const double xorArea = clipperResultArea(polygonBoolean(a, b, BooleanOp::Xor));
+        const double difference = clipperResultArea(polygonBoolean(a, b, BooleanOp::Difference)) + clipperResultArea(polygonBoolean(b, a, BooleanOp::Difference));
+        assert(std::abs(xorArea / difference - 1.0) < 1e-6);
+    };
+    checkSum({star(0, 0, 300, 1500.0, 7)}, {star(2500, 1000, 300, 1500.0, 8)});
+    checkSum({star(0, 0, 1000, 30.0, 9)}, {star(100, 50, 1000, 30.0, 10)});
+
+    // 较大输入：两个 20000 顶点、起伏 2 m 的圆形围栏
+    const PolygonRings starA = {star(0, 0, 20000, 2.0, 1)};
+    const PolygonRings starB = {star(2500, 1000, 20000, 2.0, 2)};
+    const PolygonRings starC = {star(0, 0, 2000, 2.0, 3)};
+    PolygonClipper clipper;
+    auto t0 = std::chrono::high_resolution_clock::now();
+    auto starUnion = clipper.compute(starA, starB, BooleanOp::Union);
+    auto t1 = std::chrono::high_resolution_clock::now();
+    auto starInter = clipper.compute(starA, starB, BooleanOp::Intersection);
+    auto t2 = std::chrono::high_resolution_clock::now();
+    auto starBuffer = clipper.buffer(starC, 50.0);
+    auto t3 = std::chrono::high_resolution_clock::now();
+    const double starAreaA = calculatePolygonArea(starA[0]);
+    const double starAreaB = calculatePolygonArea(starB[0]);
+    const double sum = clipperResultArea(starUnion) + clipperResultArea(starInter);
+    assert(starUnion.size() == 1 && starInter.size() == 1);
+    assert(std::abs(sum / (starAreaA + starAreaB) - 1.0) < 1e-6);
+    assert(clipperResultArea(starBuffer) > calculatePolygonArea(starC[0]));
+    auto ms = [](std::chrono::high_resolution_clock::time_point x, std::chrono::high_resolution_clock::time_point y) {
+        return std::chrono::duration<double, std::milli>(y - x).count();
+    };
+    std::cout << "2 x 20,000 vertices: union " << ms(t0, t1) << " ms, intersection " << ms(t1, t2)
+              << " ms; 2,000 vertices buffer 50 m " << ms(t2, t3) << " ms" << std::endl;
+
+    std::cout << "PASSED" << std::endl;
+}
+
+// 三角形均为逆时针（经度向东、纬度向北）
+static void checkTriangles(const std::vector<GeoPoint>& points, const PolygonTriangulation& result) {
+    assert(result.indices.size() % 3 == 0);
+    for (size_t t = 0; t < result.indices.size(); t += 3) {
+        const GeoPoint& a = points[result.indices[t]];
+        const GeoPoint& b = points[result.indices[t + 1]];
+        const GeoPoint& c = points[result.indices[t + 2]];
+        assert((b.lon - a.lon) * (c.lat - a.lat) - (c.lon - a.lon) * (b.lat - a.lat) >= 0.0);
+    }
+}
+
+static PolylineRings triangulatorTestRings(const std::vector<std::vector<GeoPoint>>& rings) {
+    PolylineRings result;
+    for (const auto& ring : rings) {
+        result.ringOffsets.push_back(static_cast<int>(result.points.size()));
+        result.points.insert(result.points.end(), ring.begin(), ring.end());
+    }
+    result.ringOffsets.push_back(static_cast<int>(result.points.size()));
+    return result;
+}
+
+void testTriangulator() {
+    std::cout << "Running testTriangulator..." << std::endl;
+
+    // 凸多边形与凹多边形：n 个顶点得到 n - 2 个三角形，面积与 calculatePolygonArea 一致
+    const auto square = clipperTestRect(0, 0, 1000, 1000);
+    auto squareResult = triangulatePolygon(square);
+    assert(squareResult.indices.size() == 6);
+    checkTriangles(square, squareResult);
+    assert(std::abs(squareResult.areaSquareMeters / calculatePolygonArea(square) - 1.0) < 1e-12);
+    assert(calculateDistance(squareResult.centroid.lat, squareResult.centroid.lon, clipperTestPoint(500, 500).lat, clipperTestPoint(500, 500).lon) < 0.05);
+
+    std::vector<GeoPoint> comb;
+    for (int i = 0; i < 10; ++i) {
+        comb.push_back(clipperTestPoint(i * 100.0, 0.0));
+        comb.push_back(clipperTestPoint(i * 100.0 + 50.0, 0.0));
+    }
+    comb.push_back(clipperTestPoint(1000.0, 0.0));
+    comb.push_back(clipperTestPoint(1000.0, 500.0));
+    for (int i = 10; i-- > 0;) {
+        comb.push_back(clipperTestPoint(i * 100.0 + 75.0, 500.0));
+        comb.push_back(clipperTestPoint(i * 100.0 + 50.0, 100.0));
+        comb.push_back(clipperTestPoint(i * 100.0 + 25.0, 500.0));
+    }
+    auto combResult = triangulatePolygon(comb);
+    checkTriangles(comb, combResult);
+    assert(std::abs(combResult.areaSquareMeters / calculatePolygonArea(comb) - 1.0) < 1e-9);
+
+    // 首尾重复点被忽略，顺时针输入同样输出逆时针三角形
+    std::vector<GeoPoint> closed(square.rbegin(), square.rend());
+    closed.push_back(closed.front());
+    auto closedResult = triangulatePolygon(closed);
+    assert(closedResult.indices.size() == 6);
+    checkTriangles(closed, closedResult);
+
+    // 带洞：n + 2h - 2 个三角形，面积扣除洞，质心偏离洞的一侧
+    const auto hole = clipperTestRect(100, 100, 400, 400);
+    const auto holed = triangulatorTestRings({square, hole});
+    auto holedResult = triangulatePolygon(holed);
+    assert(holedResult.indices.size() == 8 * 3);
+    checkTriangles(holed.points, holedResult);
+    const double outerArea = calculatePolygonArea(square);
+    const double holeArea = calculatePolygonArea(hole);
+    assert(std::abs(holedResult.areaSquareMeters / (outerArea - holeArea) - 1.0) < 1e-9);
+    const GeoPoint holeCenter = clipperTestPoint(250, 250);
+    const GeoPoint center = clipperTestPoint(500, 500);
+    const double expectedLat = (center.lat * outerArea - holeCenter.lat * holeArea) / (outerArea - holeArea);
+    const double expectedLon = (center.lon * outerArea - holeCenter.lon * holeArea) / (outerArea - holeArea);
+    assert(calculateDistance(holedResult.centroid.lat, holedResult.centroid.lon, expectedLat, expectedLon) < 0.1);
+
+    // 多个洞、洞接触外环
+    auto twoHoles = triangulatorTestRings({square, clipperTestRect(100, 100, 300, 900), clipperTestRect(600, 0, 800, 500)});
+    auto twoHolesResult = triangulatePolygon(twoHoles);
+    checkTriangles(twoHoles.points, twoHolesResult);
+    const double twoHolesArea = outerArea - calculatePolygonArea(clipperTestRect(100, 100, 300, 900)) - calculatePolygonArea(clipperTestRect(600, 0, 800, 500));
+    assert(std::abs(twoHolesResult.areaSquareMeters / twoHolesArea - 1.0) < 1e-9);
+
+    // 布尔运算结果直接剖分
+    auto clipped = polygonBoolean({square}, {clipperTestRect(300, 300, 700, 700)}, BooleanOp::Difference);
+    assert(clipped.size() == 1 && clipped[0].size() == 2);
+    auto clippedResult = triangulatePolygon(triangulatorTestRings(clipped[0]));
+    assert(std::abs(clippedResult.areaSquareMeters / clipperResultArea(clipped) - 1.0) < 1e-9);
+
+    // 退化输入
+    assert(triangulatePolygon(std::vector<GeoPoint>{square[0], square[1]}).indices.empty());
+    assert(triangulatePolygon(std::vector<GeoPoint>{square[0], square[1], square[0]}).indices.empty());
+
+    // 大输入：100,000 顶点的围栏，含 100 个洞（z-order 索引路径）
+    std::vector<std::vector<GeoPoint>> rings(1);
+    uint32_t seed = 11;
+    const size_t outerCount = 100000;
+    for (size_t i = 0; i < outerCount; ++i) {
+        seed = seed * 1664525u + 1013904223u;
+        const double radius = 5000.0 + (seed >> 8) / static_cast<double>(1u << 24) * 0.5;
+        const double angle = 2.0 * 3.14159265358979323846 * i / outerCount;
+        rings[0].push_back(clipperTestPoint(radius * std::cos(angle), radius * std::sin(angle)));
+    }
+    double expectedArea = calculatePolygonArea(rings[0]);
+    for (int row = 0; row < 10; ++row) {
+        for (int column = 0; column < 10; ++column) {
+            const double x = -3000.0 + column * 600.0;
+            const double y = -3000.0 + row * 600.0;
+            rings.push_back(clipperTestRect(x, y, x + 200.0, y + 300.0));
+            expectedArea -= calculatePolygonArea(rings.back());
+        }
+    }
+    const auto large = triangulatorTestRings(rings);
+    PolygonTriangulator triangulator;
+    PolygonTriangulation largeResult;
+    auto t0 = std::chrono::high_resolution_clock::now();
+    const bool ok = triangulator.triangulate(CoordSpan(large.points), large.ringOffsets, largeResult);
+    auto t1 = std::chrono::high_resolution_clock::now();
+    const double legacyArea = calculatePolygonArea(rings[0]);
+    const GeoPoint legacyCentroid = calculateCentroid(rings[0]);
+    auto t2 = std::chrono::high_resolution_clock::now();
+    assert(ok);
+    // 洞排成网格，桥接边与相邻洞的边共线时共线点被去掉，三角形略少于 n + 2h - 2
+    assert(largeResult.indices.size() <= (large.points.size() + 2 * 100 - 2) * 3);
+    assert(largeResult.indices.size() > large.points.size() * 3);
+    checkTriangles(large.points, largeResult);
+    assert(std::abs(largeResult.areaSquareMeters / expectedArea - 1.0) < 1e-9);
+    assert(legacyArea > largeResult.areaSquareMeters && std::abs(legacyCentroid.lat - 39.9) < 1e-3);
+    std::cout << "100,000 vertices + 100 holes: triangulate + area + centroid " << std::chrono::duration<double, std::milli>(t1 - t0).count()
+              << " ms (" << largeResult.indices.size() / 3 << " triangles); outer area + centroid without holes "
+              << std::chrono::duration<double, std::milli>(t2 - t1).count() << " ms" << std::endl;
+
+    std::cout << "PASSED" << std::endl;
+}
+
+void testTrajectoryAnalyzer() {
+    std::cout << "Running testTrajectoryAnalyzer..." << std::endl;
+
+    // 向东 10 m/s 行驶 100 s，停留 300 s（±1 m 抖动），再向北 15 m/s 行驶 60 s；1 Hz 采样
+    std::vector<double> times;
+    std::vector<GeoPoint> track;
+    uint32_t seed = 7;
+    auto next = [&seed]() {
+        seed = seed * 1664525u + 1013904223u;
+        return (seed >> 8) / 16777216.0;
+    };
+    for (int t = 0; t <= 100; ++t) {
+        times.push_back(t);
+        track.push_back(hullTestPoint(10.0 * t, 0.0));
+    }
+    for (int t = 101; t <= 400; ++t) {
+        times.push_back(t);
+        track.push_back(hullTestPoint(1000.0 + (next() - 0.5) * 2.0, (next() - 0.5) * 2.0));
+    }
+    for (int t = 401; t <= 460; ++t) {
+        times.push_back(t);
+        track.push_back(hullTestPoint(1000.0, 15.0 * (t - 400)));
+    }
+    // 跳点：5 km 外、坐标非法、时间倒退
+    times.insert(times.begin() + 50, 49.5);
+    track.insert(track.begin() + 50, hullTestPoint(5000.0, 5000.0));
+    times.insert(times.begin() + 420, 300.5);
+    track.insert(track.begin() + 420, GeoPoint{std::nan(""), 116.4});
+    times.insert(times.begin() + 440, 10.0);
+    track.insert(track.begin() + 440, track[439]);
+
+    std::vector<TrajectorySegment> segments(track.size());
+    TrajectoryAnalyzer analyzer;
+    analyzer.add(times.data(), CoordSpan(track), segments.data());
+    analyzer.finish();
+    const TrajectorySummary summary = analyzer.summary();
+    auto stops = analyzer.takeStops();
+
+    assert(summary.pointCount == track.size());
+    assert(summary.outlierCount == 3 && summary.acceptedCount == track.size() - 3);
+    assert(segments[50].flags == kTrajectoryOutlier && segments[420].flags == kTrajectoryOutlier && segments[440].flags == kTrajectoryOutlier);
+    assert(approxEqual(segments[20].speedMps, 10.0, 0.05) && approxEqual(segments[20].headingDegrees, 90.0, 0.1));
+    assert(approxEqual(segments[450].speedMps, 15.0, 0.05) && segments[450].headingDegrees < 0.1);
+    assert(std::isnan(segments[0].headingDegrees));
+    assert(summary.maxSpeedMps >= 15.0 && summary.maxSpeedMps < 17.0);
+    assert(approxEqual(summary.totalSeconds, 460.0));
+    // 两段行驶 1000 m + 900 m，加上停留期间的抖动
+    assert(summary.totalDistanceMeters > 1900.0 && summary.totalDistanceMeters < 1900.0 + 300 * 3.0);
+    assert(summary.stopCount == 1 && stops.size() == 1);
+    assert(stops[0].startTime >= 99.0 && stops[0].startTime <= 101.0);
+    assert(stops[0].endTime >= 400.0 && stops[0].endTime <= 403.0);
+    assert(calculateDistance(stops[0].lat, stops[0].lon, track[250].lat, track[250].lon) < 5.0);
+    assert(approxEqual(summary.stoppedSeconds, stops[0].endTime - stops[0].startTime));
+    assert(analyzer.takeStops().empty());
+    assert(summary.bounds.north > 39.9 && summary.bounds.west >= 116.4 - 1e-9);
+
+    // 分块输入与一次性输入结果相同
+    TrajectoryAnalyzer chunked;
+    std::vector<TrajectorySegment> chunkedSegments(track.size());
+    for (size_t begin = 0; begin < track.size(); begin += 7) {
+        const size_t n = std::min<size_t>(7, track.size() - begin);
+        chunked.add(times.data() + begin, CoordSpan(track).subspan(begin, n), chunkedSegments.data() + begin);
+    }
+    chunked.finish();
+    const TrajectorySummary chunkedSummary = chunked.summary();
+    assert(chunkedSummary.totalDistanceMeters == summary.totalDistanceMeters);
+    assert(chunkedSummary.movingSeconds == summary.movingSeconds && chunkedSummary.stopCount == summary.stopCount);
+    for (size_t i = 0; i < track.size(); ++i) {
+        assert(chunkedSegments[i].flags == segments[i].flags && chunkedSegments[i].speedMps == segments[i].speedMps);
+    }
+
+    // 连续一致的跳点（如出隧道后重新定位）：前两个剔除，第三个起接受，跳跃距离不计入里程
+    std::vector<double> jumpTimes;
+    std::vector<GeoPoint> jumpTrack;
+    for (int t = 0; t < 20; ++t) {
+        jumpTimes.push_back(t);
+        jumpTrack.push_back(hullTestPoint(10.0 * t + (t >= 10 ? 20000.0 : 0.0), 0.0));
+    }
+    std::vector<TrajectorySegment> jumpSegments(jumpTrack.size());
+    TrajectoryAnalyzer jump;
+    jump.add(jumpTimes.data(), CoordSpan(jumpTrack), jumpSegments.data());
+    assert(jumpSegments[10].flags == kTrajectoryOutlier && jumpSegments[11].flags == kTrajectoryOutlier);
+    assert(jumpSegments[12].flags == kTrajectoryReanchored && jumpSegments[13].flags == 0);
+    assert(jump.summary().outlierCount == 2);
+    assert(approxEqual(jump.summary().totalDistanceMeters, 9 * 10.0 + 7 * 10.0, 0.1));
+
+    // 断档
+    std::vector<double> gapTimes = {0.0, 1000.0};
+    std::vector<GeoPoint> gapTrack = {hullTestPoint(0, 0), hullTestPoint(2000, 0)};
+    TrajectoryAnalyzer gap;
+    gap.add(gapTimes.data(), CoordSpan(gapTrack), segments.data());
+    assert(segments[1].flags == kTrajectoryGap && approxEqual(segments[1].speedMps, 2.0, 0.01));
+
+    // 1,000,000 点的往返扫描轨迹按 4096 分块流式输入
+    const size_t longCount = 1000000;
+    std::vector<double> longTimes(longCount);
+    std::vector<double> longLats(longCount);
+    std::vector<double> longLons(longCount);
+    for (size_t i = 0; i < longCount; ++i) {
+        const size_t row = i / 5000;
+        const size_t column = row % 2 == 0 ? i % 5000 : 4999 - i % 5000;
+        const GeoPoint p = hullTestPoint(column * 8.0, row * 8.0);
+        longTimes[i] = static_cast<double>(i);
+        longLats[i] = p.lat;
+        longLons[i] = p.lon;
+    }
+    TrajectoryAnalyzer streaming;
+    auto t0 = std::chrono::high_resolution_clock::now();
+    for (size_t begin = 0; begin < longCount; begin += 4096) {
+        const size_t n = std::min<size_t>(4096, longCount - begin);
+        streaming.add(longTimes.data() + begin, CoordSpan(longLats.data() + begin, longLons.data() + begin, n));
+    }
+    streaming.finish();
+    auto t1 = std::chrono::high_resolution_clock::now();
+    assert(streaming.summary().acceptedCount == longCount && streaming.summary().outlierCount == 0);
+    assert(approxEqual(streaming.summary().totalDistanceMeters, (longCount - 1) * 8.0, longCount * 8.0 * 1e-3));
+    std::cout << "1,000,000-point track (4096-point chunks): " << std::chrono::duration<double, std::milli>(t1 - t0).count() << " ms, "
+              << streaming.summary().totalDistanceMeters / 1000.0 << " km" << std::endl;
+
+    std::cout << "PASSED" << std::endl;
+}
+
+void testGpsSmoother() {
+    std::cout << "Running testGpsSmoother..." << std::endl;
+
+    uint32_t seed = 11;
+    auto next = [&seed]() {
+        seed = seed * 1664525u + 1013904223u;
+        return (seed >> 8) / 16777216.0;
+    };
+    // 近似正态分布，标准差约 8 m
+    auto noise = [&next]() { return (next() + next() + next() - 1.5) * 16.0; };
+
+    // 向东 15 m/s 行驶 300 s，1 Hz，定位误差约 8 m，其中几个定位点跳到 300 m 外
+    GpsSmootherPool pool(4);
+    const int slot = pool.acquire();
+    assert(slot == 0 && pool.activeCount() == 1);
+    std::vector<int32_t> slots;
+    std::vector<double> times;
+    std::vector<GeoPoint> fixes;
+    std::vector<GeoPoint> truth;
+    for (int t = 0; t < 300; ++t) {
+        const bool spike = t == 100 || t == 180 || t == 181;
+        slots.push_back(slot);
+        times.push_back(t);
+        truth.push_back(hullTestPoint(15.0 * t, 0.0));
+        fixes.push_back(spike ? hullTestPoint(15.0 * t + 200.0, 300.0) : hullTestPoint(15.0 * t + noise(), noise()));
+    }
+    std::vector<SmoothedFix> out(fixes.size());
+    pool.update(slots.data(), times.data(), CoordSpan(fixes), nullptr, out.data());
+
+    assert(out[0].flags == kGpsSmootherReset);
+    assert(out[100].flags == kGpsSmootherRejected && out[180].flags == kGpsSmootherRejected && out[181].flags == kGpsSmootherRejected);
+    double rawError = 0.0;
+    double smoothError = 0.0;
+    for (int t = 30; t < 300; ++t) {
+        if (t == 100 || t == 180 || t == 181) {
+            // 被剔除的点输出预测位置
+            assert(calculateDistance(out[t].lat, out[t].lon, truth[t].lat, truth[t].lon) < 20.0);
+            continue;
+        }
+        assert(out[t].flags == 0);
+        const double raw = calculateDistance(fixes[t].lat, fixes[t].lon, truth[t].lat, truth[t].lon);
+        const double smooth = calculateDistance(out[t].lat, out[t].lon, truth[t].lat, truth[t].lon);
+        rawError += raw * raw;
+        smoothError += smooth * smooth;
+    }
+    assert(smoothError < rawError * 0.5);
+    assert(approxEqual(out[299].speedMps, 15.0, 1.0) && approxEqual(out[299].headingDegrees, 90.0, 5.0));
+
+    double predictedLat = 0.0;
+    double predictedLon = 0.0;
+    assert(pool.predict(slot, 301.0, predictedLat, predictedLon));
+    assert(calculateDistance(predictedLat, predictedLon, truth[299].lat, truth[299].lon) > 20.0);
+    assert(calculateDistance(predictedLat, predictedLon, hullTestPoint(15.0 * 301, 0.0).lat, hullTestPoint(15.0 * 301, 0.0).lon) < 20.0);
+
+    // 连续多个定位点都在新位置（如出隧道）：剔除 maxRejected - 1 个后在新位置重新初始化
+    std::vector<GeoPoint> moved;
+    std::vector<double> movedTimes;
+    for (int t = 300; t < 305; ++t) {
+        movedTimes.push_back(t);
+        moved.push_back(hullTestPoint(15.0 * t + 3000.0, 0.0));
+    }
+    pool.update(slots.data(), movedTimes.data(), CoordSpan(moved), nullptr, out.data());
+    assert(out[0].flags == kGpsSmootherRejected && out[1].flags == kGpsSmootherRejected);
+    assert(out[2].flags == kGpsSmootherReset && out[3].flags == 0);
+    assert(calculateDistance(out[4].lat, out[4].lon, moved[4].lat, moved[4].lon) < 15.0);
+
+    // 长时间未更新后重新初始化；时间倒退与非法坐标被剔除
+    std::vector<double> staleTimes = {1000.0, 999.0, 1001.0};
+    std::vector<GeoPoint> stale = {hullTestPoint(0, 0), hullTestPoint(5, 0), GeoPoint{std::nan(""), 116.4}};
+    pool.update(slots.data(), staleTimes.data(), CoordSpan(stale), nullptr, out.data());
+    assert(out[0].flags == kGpsSmootherReset && out[1].flags == kGpsSmootherRejected && out[2].flags == kGpsSmootherRejected);
+    assert(approxEqual(out[2].lat, stale[0].lat, 1e-9));
+
+    // 精度较差时更依赖预测
+    GpsSmootherPool accuracyPool(2);
+    const int precise = accuracyPool.acquire();
+    const int coarse = accuracyPool.acquire();
+    std::vector<int32_t> pairSlots = {precise, coarse, precise, coarse};
+    std::vector<double> pairTimes = {0.0, 0.0, 1.0, 1.0};
+    std::vector<GeoPoint> pairFixes = {hullTestPoint(0, 0), hullTestPoint(0, 0), hullTestPoint(0, 20), hullTestPoint(0, 20)};
+    std::vector<double> accuracies = {3.0, 3.0, 3.0, 30.0};
+    accuracyPool.update(pairSlots.data(), pairTimes.data(), CoordSpan(pairFixes), accuracies.data(), out.data());
+    assert(out[2].flags == 0 && out[3].flags == 0);
+    assert(out[2].lat > out[3].lat && out[3].lat > pairFixes[0].lat);
+
+    // 槽位管理
+    GpsSmootherPool small(2);
+    assert(small.acquire() == 0 && small.acquire() == 1 && small.acquire() == -1);
+    small.release(0);
+    small.release(0);
+    assert(small.activeCount() == 1 && small.acquire() == 0);
+    std::vector<int32_t> badSlots = {5};
+    small.update(badSlots.data(), times.data(), CoordSpan(fixes).subspan(0, 1), nullptr, out.data());
+    assert(out[0].flags == kGpsSmootherInvalid && std::isnan(out[0].lat));
+    assert(!small.predict(1, 0.0, predictedLat, predictedLon));
+
+    // 10,000 辆车 × 60 帧，每帧一次批量更新
+    const size_t vehicleCount = 10000;
+    GpsSmootherPool fleet(vehicleCount);
+    std::vector<int32_t> fleetSlots(vehicleCount);
+    std::vector<double> fleetTimes(vehicleCount);
+    std::vector<double> fleetLats(vehicleCount);
+    std::vector<double> fleetLons(vehicleCount);
+    std::vector<SmoothedFix> fleetOut(vehicleCount);
+    for (size_t v = 0; v < vehicleCount; ++v) fleetSlots[v] = fleet.acquire();
+    double fleetMs = 0.0;
+    for (int tick = 0; tick < 60; ++tick) {
+        for (size_t v = 0; v < vehicleCount; ++v) {
+            const GeoPoint p = hullTestPoint((v % 100) * 500.0 + 12.0 * tick + noise(), (v / 100) * 500.0 + noise());
+            fleetTimes[v] = tick;
+            fleetLats[v] = p.lat;
+            fleetLons[v] = p.lon;
+        }
+        auto t0 = std::chrono::high_resolution_clock::now();
+        fleet.update(fleetSlots.data(), fleetTimes.data(), CoordSpan(fleetLats.data(), fleetLons.data(), vehicleCount), nullptr, fleetOut.data());
+        auto t1 = std::chrono::high_resolution_clock::now();
+        fleetMs += std::chrono::duration<double, std::milli>(t1 - t0).count();
+    }
+    assert(approxEqual(fleetOut[0].speedMps, 12.0, 3.0) && approxEqual(fleetOut[vehicleCount - 1].headingDegrees, 90.0, 15.0));
+    std::cout << "10,000 vehicles x 60 ticks: " << fleetMs / 60.0 << " ms per tick" << std::endl;
+
+    std::cout << "PASSED" << std::endl;
+}
+
+// 与 PathSegmentIndex 相同的距离公式（查询点处的局部等距投影），逐条线段暴力求最小值
+static double similarityBruteDistance(const std::vector<GeoPoint>& path, const GeoPoint& q) {
+    const double k = 6371000.0 * M_PI / 180.0;
+    const double scale = k * std::cos(q.lat * M_PI / 180.0);
+    double best = std::numeric_limits<double>::infinity();
+    for (size_t i = 0; i + 1 < path.size() || i == 0; ++i) {
+        const GeoPoint& a = path[i];
+        const GeoPoint& b = path[std::min(i + 1, path.size() - 1)];
+        const double ax = (a.lon - q.lon) * scale, ay = (a.lat - q.lat) * k;
+        const double dx = (b.lon - a.lon) * scale, dy = (b.lat - a.lat) * k;
+        const double l2 = dx * dx + dy * dy;
+        const double t = l2 > 0 ? std::max(0.0, std::min(1.0, -(ax * dx + ay * dy) / l2)) : 0.0;
+        best = std::min(best, std::hypot(ax + t * dx, ay + t * dy));
+        if (path.size() == 1) break;
+    }
+    return best;
+}
+
+static double similarityBruteFrechet(const std::vector<GeoPoint>& a, const std::vector<GeoPoint>& b) {
+    std::vector<double> dp(a.size() * b.size());
+    for (size_t i = 0; i < a.size(); ++i) {
+        for (size_t j = 0; j < b.size(); ++j) {
+            const double d = calculateDistance(a[i].lat, a[i].lon, b[j].lat, b[j].lon);
+            double best;
+            if (i == 0 && j == 0) best = 0.0;
+            else if (i == 0) best = dp[j - 1];
+            else if (j == 0) best = dp[(i - 1) * b.size()];
+            else best = std::min({dp[(i - 1) * b.size() + j], dp[(i - 1) * b.size() + j - 1], dp[i * b.size() + j - 1]});
+            dp[i * b.size() + j] = std::max(d, best);
+        }
+    }
+    return dp.back();
+}
+
+void testPathSimilarity() {
+    std::cout << "Running testPathSimilarity..." << std::endl;
+    const double inf = std::numeric_limits<double>::infinity();
+
+    uint32_t seed = 17;
+    auto next = [&seed]() {
+        seed = seed * 1664525u + 1013904223u;
+        return (seed >> 8) / 16777216.0;
+    };
+
+    // 随机游走路线（2000 个顶点，步长 5-50 m）
+    std::vector<GeoPoint> walk;
+    double east = 0.0, north = 0.0, heading = 0.0;
+    for (int i = 0; i < 2000; ++i) {
+        walk.push_back(hullTestPoint(east, north));
+        heading += (next() - 0.5) * 1.2;
+        const double step = 5.0 + next() * 45.0;
+        east += std::sin(heading) * step;
+        north += std::cos(heading) * step;
+    }
+    const PathBounds walkBounds = calculatePathBounds(walk);
+
+    // 网格索引与暴力计算一致（自动网格、很小和很大的网格）
+    for (double cell : {0.0, 5.0, 5000.0}) {
+        PathSegmentIndex index(CoordSpan(walk), cell);
+        assert(index.pointCount() == walk.size());
+        for (int k = 0; k < 300; ++k) {
+            GeoPoint q;
+            if (k % 10 == 0) {
+                q = {walkBounds.north + 0.05 * next(), walkBounds.west - 0.05 * next()};   // 范围外
+            } else {
+                q = {walkBounds.south + (walkBounds.north - walkBounds.south) * next(),
+                     walkBounds.west + (walkBounds.east - walkBounds.west) * next()};
+            }
+            const double expected = similarityBruteDistance(walk, q);
+            assert(approxEqual(index.distanceTo(q.lat, q.lon), expected, 1e-6));
+            assert(index.distanceTo(q.lat, q.lon, expected * 0.99) == inf || expected == 0.0);
+            assert(index.distanceTo(q.lat, q.lon, inf, expected + 100.0) <= expected + 100.0);
+        }
+    }
+
+    // 偏差统计：直线正北 10 m 和 20 m 处的两个点
+    std::vector<GeoPoint> line = {hullTestPoint(0, 0), hullTestPoint(1000, 0)};
+    std::vector<GeoPoint> offsets = {hullTestPoint(300, 10), hullTestPoint(600, 20)};
+    PathSegmentIndex lineIndex{CoordSpan(line)};
+    const PathDeviation deviation = measurePathDeviation(lineIndex, CoordSpan(offsets), 15.0);
+    assert(approxEqual(deviation.averageMeters, 15.0, 0.01) && approxEqual(deviation.maxMeters, 20.0, 0.01));
+    assert(deviation.exceededCount == 1);
+
+    // Hausdorff：平行线相距 30 m；阈值以下提前返回 +∞；与暴力结果一致
+    std::vector<GeoPoint> parallel = {hullTestPoint(0, 30), hullTestPoint(500, 30), hullTestPoint(1000, 30)};
+    assert(approxEqual(hausdorffDistance(CoordSpan(line), CoordSpan(parallel)), 30.0, 0.01));
+    assert(hausdorffDistance(CoordSpan(line), CoordSpan(parallel), 20.0) == inf);
+    std::vector<GeoPoint> shifted;
+    for (size_t i = 0; i < walk.size(); i += 3) {
+        shifted.push_back({walk[i].lat + (next() - 0.5) * 2e-4, walk[i].lon + (next() - 0.5) * 2e-4});
+    }
+    double expectedHausdorff = 0.0;
+    for (const auto& p : shifted) expectedHausdorff = std::max(expectedHausdorff, similarityBruteDistance(walk, p));
+    for (const auto& p : walk) expectedHausdorff = std::max(expectedHausdorff, similarityBruteDistance(shifted, p));
+    assert(approxEqual(hausdorffDistance(CoordSpan(walk), CoordSpan(shifted)), expectedHausdorff, 1e-6));
+    assert(directedHausdorffDistance(PathSegmentIndex(CoordSpan(walk)), CoordSpan(walk)) < 1e-6);
+
+    // Fréchet：与完整动态规划一致；方向相反的同一条线 Hausdorff 为 0 而 Fréchet 很大
+    for (int trial = 0; trial < 20; ++trial) {
+        std::vector<GeoPoint> a, b;
+        const size_t offset = static_cast<size_t>(next() * 1000);
+        for (size_t i = 0; i < 60; ++i) a.push_back(walk[offset + i * 2]);
+        for (size_t i = 0; i < 80; ++i) {
+            const GeoPoint& p = walk[offset + (i * 3) / 2];
+            b.push_back({p.lat + (next() - 0.5) * 4e-4, p.lon + (next() - 0.5) * 4e-4});
+        }
+        const double expected = similarityBruteFrechet(a, b);
+        const double actual = discreteFrechetDistance(CoordSpan(a), CoordSpan(b));
+        assert(approxEqual(actual, expected, expected * 1e-3 + 0.01));
+        assert(approxEqual(discreteFrechetDistance(CoordSpan(a), CoordSpan(b), expected * 1.01), actual, 1e-9));
+        assert(discreteFrechetDistance(CoordSpan(a), CoordSpan(b), expected * 0.99) == inf);
+    }
+    std::vector<GeoPoint> reversed(line.rbegin(), line.rend());
+    assert(hausdorffDistance(CoordSpan(line), CoordSpan(reversed)) < 1e-6);
+    assert(approxEqual(discreteFrechetDistance(CoordSpan(line), CoordSpan(reversed)), 1000.0, 1.0));
+    assert(discreteFrechetDistance(CoordSpan(line), CoordSpan(line)) == 0.0);
+    assert(discreteFrechetDistance(CoordSpan(line), CoordSpan(std::vector<GeoPoint>())) == inf);
+
+    // 长路线：约 200 km、20,000 点的参考路线与 18,000 点、±5 m 偏差的候选路线
+    std::vector<GeoPoint> route;
+    east = north = heading = 0.0;
+    for (int i = 0; i < 20000; ++i) {
+        route.push_back(hullTestPoint(east, north));
+        heading += (next() - 0.5) * 0.2;
+        east += std::sin(heading) * 10.0;
+        north += std::cos(heading) * 10.0;
+    }
+    std::vector<GeoPoint> candidate;
+    for (int i = 0; i < 18000; ++i) {
+        const double t = i * (route.size() - 1) / 17999.0;
+        const size_t k = std::min<size_t>(static_cast<size_t>(t), route.size() - 2);
+        const double f = t - k;
+        candidate.push_back({route[k].lat + (route[k + 1].lat - route[k].lat) * f + (next() - 0.5) * 9e-5,
+                             route[k].lon + (route[k + 1].lon - route[k].lon) * f + (next() - 0.5) * 9e-5});
+    }
+    auto t0 = std::chrono::high_resolution_clock::now();
+    const double longFrechet = discreteFrechetDistance(CoordSpan(route), CoordSpan(candidate));
+    auto t1 = std::chrono::high_resolution_clock::now();
+    const double longHausdorff = hausdorffDistance(CoordSpan(route), CoordSpan(candidate));
+    auto t2 = std::chrono::high_resolution_clock::now();
+    PathSegmentIndex routeIndex{CoordSpan(route)};
+    const PathDeviation routeDeviation = measurePathDeviation(routeIndex, CoordSpan(candidate), 120.0);
+    auto t3 = std::chrono::high_resolution_clock::now();
+    assert(longHausdorff < 10.0 && longFrechet >= longHausdorff && longFrechet < 20.0);
+    assert(routeDeviation.exceededCount == 0 && routeDeviation.maxMeters < 10.0);
+    std::cout << "20,000 x 18,000-point routes: Frechet " << std::chrono::duration<double, std::milli>(t1 - t0).count()
+              << " ms, Hausdorff " << std::chrono::duration<double, std::milli>(t2 - t1).count()
+              << " ms, deviation " << std::chrono::duration<double, std::milli>(t3 - t2).count() << " ms" << std::endl;
+
+    std::cout << "PASSED" << std::endl;
+}
+
+void testHeatmapGrid() {
+    std::cout << "Running testHeatmapGrid..." << std::endl;
+
+    // 参考实现：与旧版 std::map 分桶一致
+    auto referenceGrid = [](const std::vector<HeatmapPoint>& pts, double gridSizeMeters) {
+        double minLat = 90.0, maxLat = -90.0, minLon = 180.0, maxLon = -180.0;
+        for (const auto& p : pts) {
+            minLat = std::min(minLat, p.lat); maxLat = std::max(maxLat, p.lat);
+            minLon = std::min(minLon, p.lon); maxLon = std::max(maxLon, p.lon);
+        }
+        const double latStep = gridSizeMeters / 111320.0;
+        const double lonStep = gridSizeMeters / (111320.0 * std::cos((minLat + maxLat) / 2.0 * M_PI / 180.0));
+        std::map<std::pair<int, int>, double> grid;
+        for (const auto& p : pts) {
+            grid[{static_cast<int>((p.lat - minLat) / latStep), static_cast<int>((p.lon - minLon) / lonStep)}] += p.weight;
+        }
+        std::vector<HeatmapGridCell> cells;
+        for (const auto& e : grid) {
+            cells.push_back({minLat + (e.first.first + 0.5) * latStep, minLon + (e.first.second + 0.5) * lonStep, e.second});
+        }
+        return cells;
+    };
+    auto sameCells = [](const std::vector<HeatmapGridCell>& a, const std::vector<HeatmapGridCell>& b) {
+        if (a.size() != b.size()) return false;
+        for (size_t i = 0; i < a.size(); ++i) {
+            if (!approxEqual(a[i].lat, b[i].lat, 1e-9) || !approxEqual(a[i].lon, b[i].lon, 1e-9) ||
+                !approxEqual(a[i].intensity, b[i].intensity, 1e-6)) {
+                return false;
+            }
+        }
+        return true;
+    };
+
+    // 城市范围内的密集点（稠密数组路径）
+    std::vector<HeatmapPoint> cityPoints;
+    uint32_t seed = 12345;
+    auto nextRandom = [&seed]() {
+        seed = seed * 1664525u + 1013904223u;
+        return (seed >> 8) / static_cast<double>(1u << 24);
+    };
+    for (int i = 0; i < 200000; ++i) {
+        cityPoints.push_back({39.8 + nextRandom() * 0.2, 116.3 + nextRandom() * 0.2, 0.5 + nextRandom()});
+    }
+    const auto cityReference = referenceGrid(cityPoints, 200.0);
+    assert(sameCells(generateHeatmapGrid(cityPoints, 200.0), cityReference));
+    assert(sameCells(generateHeatmapGrid(cityPoints, 200.0, 4), cityReference));
+
+    // 全国范围内的稀疏点 + 小网格（哈希表路径）
+    std::vector<HeatmapPoint> sparsePoints;
+    for (int i = 0; i < 100000; ++i) {
+        sparsePoints.push_back({20.0 + nextRandom() * 25.0, 90.0 + nextRandom() * 40.0, 1.0});
+    }
+    const auto sparseReference = referenceGrid(sparsePoints, 50.0);
+    assert(sameCells(generateHeatmapGrid(sparsePoints, 50.0), sparseReference));
+    assert(sameCells(generateHeatmapGrid(sparsePoints, 50.0, 4), sparseReference));
+    assert(sameCells(generateHeatmapGrid(sparsePoints, 50.0, 0), sparseReference));
+
+    // 零权重点仍会生成单元格；非法网格尺寸返回空
+    const auto zeroWeight = generateHeatmapGrid({{39.9, 116.4, 0.0}}, 100.0);
+    assert(zeroWeight.size() == 1 && zeroWeight[0].intensity == 0.0);
+    assert(generateHeatmapGrid(cityPoints, 0.0).empty());
+    assert(generateHeatmapGrid({}, 100.0).empty());
+
+    // 性能对比（100 万点）
+    std::vector<HeatmapPoint> largePoints;
+    largePoints.reserve(1000000);
+    for (int i = 0; i < 1000000; ++i) {
+        largePoints.push_back({39.0 + nextRandom() * 2.0, 116.0 + nextRandom() * 2.0, 1.0});
+    }
+    auto start = std::chrono::high_resolution_clock::now();
+    const auto mapCells = referenceGrid(largePoints, 100.0);
+    auto mid = std::chrono::high_resolution_clock::now();
+    const auto singleCells = generateHeatmapGrid(largePoints, 100.0);
+    auto mid2 = std::chrono::high_resolution_clock::now();
+    const auto parallelCells = generateHeatmapGrid(largePoints, 100.0, 0);
+    auto end = std::chrono::high_resolution_clock::now();
+    assert(sameCells(singleCells, mapCells));
+    assert(sameCells(parallelCells, mapCells));
+    std::cout << "1M points: std::map " << std::chrono::duration<double, std::milli>(mid - start).count()
+              << " ms, single " << std::chrono::duration<double, std::milli>(mid2 - mid).count()
+              << " ms, parallel " << std::chrono::duration<double, std::milli>(end - mid2).count()
+              << " ms (" << singleCells.size() << " cells)" << std::endl;
+
+    std::cout << "PASSED" << std::endl;
+}
+
+void testHeatmapRasterizer() {
+    std::cout << "Running testHeatmapRasterizer..." << std::endl;
+
+    // 取 zoom 12 下北京附近的一块瓦片，在瓦片中心放一个点
+    const int zoom = 12;
+    const TileResult tile = latLngToTile(39.9042, 116.4074, zoom);
+    const GeoPoint tileOrigin = tileToLatLng(tile.x, tile.y, zoom);
+    const GeoPoint tileCenter = pixelToLatLng(tile.x * 256.0 + 128.0, tile.y * 256.0 + 128.0, zoom);
+    (void)tileOrigin;
+
+    HeatmapRasterOptions options;
+    options.radiusPx = 18.0;
+    const HeatmapRaster gauss = rasterizeHeatmapTile({{tileCenter.lat, tileCenter.lon, 2.0}}, tile.x, tile.y, zoom, options);
+    assert(gauss.width == 256 && gauss.height == 256);
+    double total = 0.0;
+    int peakIndex = 0;
+    for (size_t i = 0; i < gauss.values.size(); ++i) {
+        total += gauss.values[i];
+        if (gauss.values[i] > gauss.values[peakIndex]) peakIndex = static_cast<int>(i);
+    }
+    // 盒式模糊保持总权重，峰值位于中心附近且左右对称
+    assert(approxEqual(total, 2.0, 1e-3));
+    assert(std::abs(peakIndex % 256 - 128) <= 1 && std::abs(peakIndex / 256 - 128) <= 1);
+    assert(gauss.maxValue == gauss.values[peakIndex]);
+    assert(approxEqual(gauss.values[128 * 256 + 108], gauss.values[128 * 256 + 148], 1e-5));
+    assert(gauss.values[0] == 0.0f);
+
+    // Epanechnikov 为紧支撑核，半径外为 0
+    options.kernel = HeatmapKernel::Epanechnikov;
+    const HeatmapRaster epan = rasterizeHeatmapTile({{tileCenter.lat, tileCenter.lon, 1.0}}, tile.x, tile.y, zoom, options);
+    assert(epan.values[128 * 256 + 128 + 20] == 0.0f);
+    assert(epan.values[128 * 256 + 128 + 16] > 0.0f);
+    // 抛物线剖面：中心右侧 9 像素处与中心的比值按 2x2 分摊精确计算为 0.7224（两次盒式模糊的三角核约为 0.5）
+    double epanTotal = 0.0;
+    for (float v : epan.values) epanTotal += v;
+    assert(approxEqual(epanTotal, 1.0, 1e-3));
+    assert(std::abs(epan.values[128 * 256 + 137] / epan.values[128 * 256 + 128] - 0.7224) < 0.005);
+    assert(approxEqual(epan.values[128 * 256 + 137], epan.values[128 * 256 + 118], 1e-6));
+
+    // 瓦片外紧邻边缘的点也会影响本瓦片，保证拼接无缝
+    options.kernel = HeatmapKernel::Gaussian;
+    const GeoPoint outside = pixelToLatLng(tile.x * 256.0 - 3.0, tile.y * 256.0 + 128.0, zoom);
+    const HeatmapRaster edge = rasterizeHeatmapTile({{outside.lat, outside.lon, 1.0}}, tile.x, tile.y, zoom, options);
+    assert(edge.values[128 * 256] > 0.0f);
+    const GeoPoint farAway = pixelToLatLng(tile.x * 256.0 - 200.0, tile.y * 256.0 + 128.0, zoom);
+    assert(rasterizeHeatmapTile({{farAway.lat, farAway.lon, 1.0}}, tile.x, tile.y, zoom, options).maxValue == 0.0f);
+
+    // 量化与着色
+    const std::vector<uint8_t> intensities = quantizeHeatmap(gauss, 0.0f);
+    assert(intensities[peakIndex] == 255);
+    assert(intensities[0] == 0);
+    const std::vector<uint32_t> lut = buildHeatmapGradientLut({"#0000FF", "#00FF00", "#FF0000"}, {});
+    assert(lut.size() == 256);
+    assert(lut[0] == 0);
+    assert(lut[255] == 0xFFFF0000);
+    // 低强度区间透明度淡入：第一个色标位于 0 时在前 20% 内从 0 增加到 255
+    assert(lut[1] == 0x050002FD);
+    for (int i = 2; i <= 51; ++i) assert((lut[i] >> 24) > (lut[i - 1] >> 24));
+    assert((lut[51] >> 24) == 0xFF && (lut[52] >> 24) == 0xFF);
+    assert(lut[128] == 0xFF01FE00 || lut[128] == 0xFF00FF00);
+    const std::vector<uint32_t> pixels = colorizeHeatmap(intensities, lut);
+    assert(pixels[peakIndex] == 0xFFFF0000);
+    assert(pixels[0] == 0);
+
+    const std::vector<uint32_t> stepped = buildHeatmapGradientLut({"blue", "red"}, {0.5, 0.5});
+    // 第一个色标位于 0.5 时在 [0, 0.5] 内淡入
+    assert(stepped[100] == 0xC80000FF && stepped[200] == 0xFFFF0000);
+    assert(buildHeatmapGradientLut({}, {}).empty());
+    assert(buildHeatmapGradientLut({"red"}, {0.1, 0.2}).empty());
+
+    // 性能：10 万点栅格化 256x256 瓦片
+    std::vector<HeatmapPoint> cloud;
+    uint32_t seed = 7;
+    for (int i = 0; i < 100000; ++i) {
+        seed = seed * 1664525u + 1013904223u;
+        const double dx = (seed >> 8) / static_cast<double>(1u << 24);
+        seed = seed * 1664525u + 1013904223u;
+        const double dy = (seed >> 8) / static_cast<double>(1u << 24);
+        const GeoPoint p = pixelToLatLng(tile.x * 256.0 + dx * 320.0 - 32.0, tile.y * 256.0 + dy * 320.0 - 32.0, zoom);
+        cloud.push_back({p.lat, p.lon, 1.0});
+    }
+    auto start = std::chrono::high_resolution_clock::now();
+    const HeatmapRaster cloudRaster = rasterizeHeatmapTile(cloud, tile.x, tile.y, zoom, options);
+    const std::vector<uint32_t> cloudPixels = colorizeHeatmap(quantizeHeatmap(cloudRaster, 0.0f), lut);
+    auto end = std::chrono::high_resolution_clock::now();
+    assert(cloudPixels.size() == 256 * 256);
+    std::cout << "Rasterize + colorize 100,000 points: "
+              << std::chrono::duration<double, std::milli>(end - start).count() << " ms" << std::endl;
+
+    std::cout << "PASSED" << std::endl;
+}
+
+void testHeatmapTileProvider() {
+    std::cout << "Running testHeatmapTileProvider..." << std::endl;
+
+    const int zoom = 12;
+    const TileResult center = latLngToTile(39.9042, 116.4074, zoom);
+    uint32_t seed = 99;
+    auto nextRandom = [&seed]() {
+        seed = seed * 1664525u + 1013904223u;
+        return (seed >> 8) / static_cast<double>(1u << 24);
+    };
+
+    std::vector<HeatmapPoint> points;
+    for (int i = 0; i < 200000; ++i) {
+        points.push_back({39.80 + nextRandom() * 0.2, 116.30 + nextRandom() * 0.2, 0.5 + nextRandom()});
+    }
+
+    HeatmapRasterOptions options;
+    options.radiusPx = 20.0;
+    const std::vector<uint32_t> lut = buildHeatmapGradientLut({"blue", "green", "red"}, {0.0, 0.5, 1.0});
+    assert(buildHeatmapGradientLutArgb({0xFF0000FF, 0xFF00FF00, 0xFFFF0000}, {0.0, 0.5, 1.0}) == lut);
+
+    HeatmapTileProvider provider(64);
+    provider.setStyle(options, lut, 0.5f);
+    provider.setPoints(points);
+
+    // 通过索引收集的点生成的瓦片应与对全量点直接栅格化一致
+    const auto tile = provider.getTile(center.x, center.y, zoom);
+    assert(tile && tile->size() == 256 * 256);
+    const auto direct = colorizeHeatmap(quantizeHeatmap(rasterizeHeatmapTile(points, center.x, center.y, zoom, options), 0.5f), lut);
+    assert(*tile == direct);
+
+    // 缓存命中返回同一份像素
+    assert(provider.getTile(center.x, center.y, zoom) == tile);
+    assert(provider.cachedTileCount() == 1);
+
+    // 在远处追加点：本瓦片输入未变，复用缓存；新点所在瓦片正常生成
+    std::vector<HeatmapPoint> withShanghai = points;
+    withShanghai.push_back({31.2304, 121.4737, 5.0});
+    provider.setPoints(withShanghai);
+    assert(provider.getTile(center.x, center.y, zoom) == tile);
+    const TileResult shanghai = latLngToTile(31.2304, 121.4737, zoom);
+    assert(!provider.getTile(shanghai.x, shanghai.y, zoom)->empty());
+
+    // 在瓦片内追加点：重新生成
+    std::vector<HeatmapPoint> withLocal = withShanghai;
+    const GeoPoint inside = pixelToLatLng(center.x * 256.0 + 40.0, center.y * 256.0 + 40.0, zoom);
+    withLocal.push_back({inside.lat, inside.lon, 50.0});
+    provider.setPoints(withLocal);
+    const auto refreshed = provider.getTile(center.x, center.y, zoom);
+    assert(refreshed != tile && *refreshed != *tile);
+
+    // 空瓦片与非法参数
+    assert(provider.getTile(0, 0, zoom)->empty());
+    assert(provider.getTile(center.x, -1, zoom)->empty());
+    assert(provider.getTile(0, 0, 40)->empty());
+    // x 超出范围时按经度平铺归一化
+    assert(provider.getTile(center.x + (1 << zoom), center.y, zoom) == refreshed);
+
+    // 自动归一化：同一级别的瓦片共用峰值估计，远处的小权重点不影响已有瓦片
+    HeatmapTileProvider autoProvider(64);
+    autoProvider.setStyle(options, lut, 0.0f);
+    autoProvider.setPoints(points);
+    const auto autoTile = autoProvider.getTile(center.x, center.y, zoom);
+    assert(!autoTile->empty());
+    autoProvider.setPoints(withShanghai);
+    assert(autoProvider.getTile(center.x, center.y, zoom) == autoTile);
+
+    // 峰值在容差内变化时沿用原归一化基准，输入未变的瓦片不重绘；超出容差时整级重绘
+    HeatmapTileProvider peakProvider(16);
+    peakProvider.setStyle(options, lut, 0.0f);
+    const GeoPoint hot = pixelToLatLng(center.x * 256.0 + 128.0, center.y * 256.0 + 128.0, zoom);
+    const GeoPoint cold = pixelToLatLng((center.x + 4) * 256.0 + 128.0, center.y * 256.0 + 128.0, zoom);
+    std::vector<HeatmapPoint> peakPoints = {{hot.lat, hot.lon, 10.0}, {cold.lat, cold.lon, 4.0}};
+    peakProvider.setPoints(peakPoints);
+    const auto coldTile = peakProvider.getTile(center.x + 4, center.y, zoom);
+    assert(!coldTile->empty());
+    peakPoints.push_back({hot.lat, hot.lon, 0.5});
+    peakProvider.setPoints(peakPoints);
+    assert(peakProvider.getTile(center.x, center.y, zoom) != nullptr);
+    assert(peakProvider.getTile(center.x + 4, center.y, zoom) == coldTile);
+    peakPoints.push_back({hot.lat, hot.lon, 10.0});
+    peakProvider.setPoints(peakPoints);
+    const auto rescaled = peakProvider.getTile(center.x + 4, center.y, zoom);
+    assert(rescaled != coldTile && *rescaled != *coldTile);
+
+    // LRU 上限
+    HeatmapTileProvider small(4);
+    small.setStyle(options, lut, 0.0f);
+    small.setPoints(points);
+    for (int dx = -3; dx <= 2; ++dx) {
+        small.getTile(center.x + dx, center.y, zoom);
+    }
+    assert(small.cachedTileCount() == 4);
+    small.setStyle(options, lut, 0.0f);
+    assert(small.cachedTileCount() == 4);
+    small.setStyle(options, lut, 1.0f);
+    assert(small.cachedTileCount() == 0);
+
+    // 自定义渐变后传入空 LUT（JS 清除 gradient）：恢复默认色带并使缓存失效
+    HeatmapTileProvider reset(8);
+    reset.setStyle(options, {}, 0.5f);
+    reset.setPoints(points);
+    const auto defaultTile = reset.getTile(center.x, center.y, zoom);
+    const std::vector<uint32_t> customLut = buildHeatmapGradientLut({"#00000000", "#FF00FF"}, {});
+    reset.setStyle(options, customLut, 0.5f);
+    const uint64_t customGeneration = reset.currentStyleGeneration();
+    const auto customTile = reset.getTile(center.x, center.y, zoom);
+    assert(*customTile != *defaultTile);
+    reset.setStyle(options, {}, 0.5f);
+    assert(reset.currentStyleGeneration() == customGeneration + 1);
+    assert(reset.cachedTileCount() == 0);
+    assert(*reset.getTile(center.x, center.y, zoom) == *defaultTile);
+    // 已是默认色带时再次清除不做任何事
+    reset.setStyle(options, {}, 0.5f);
+    assert(reset.currentStyleGeneration() == customGeneration + 1);
+
+    // 跨 180° 经线：西半球边缘的瓦片能看到东经 179.99° 的点
+    HeatmapTileProvider dateline(8);
+    dateline.setStyle(options, lut, 0.0f);
+    dateline.setPoints({{10.0, 179.9995, 1.0}});
+    const TileResult west = latLngToTile(10.0, -179.9995, 10);
+    assert(west.x == 0);
+    assert(!dateline.getTile(0, west.y, 10)->empty());
+
+    // 性能：100 万点，首次平移 5x5 瓦片 vs 再次平移（命中缓存）
+    std::vector<HeatmapPoint> large;
+    large.reserve(1000000);
+    for (int i = 0; i < 1000000; ++i) {
+        large.push_back({39.6 + nextRandom() * 0.6, 116.0 + nextRandom() * 0.8, 1.0});
+    }
+    HeatmapTileProvider panProvider(256);
+    panProvider.setStyle(options, lut, 0.0f);
+    auto start = std::chrono::high_resolution_clock::now();
+    panProvider.setPoints(large);
+    auto indexed = std::chrono::high_resolution_clock::now();
+    for (int dy = -2; dy <= 2; ++dy) {
+        for (int dx = -2; dx <= 2; ++dx) {
+            panProvider.getTile(center.x + dx, center.y + dy, zoom);
+        }
+    }
+    auto rendered = std::chrono::high_resolution_clock::now();
+    for (int dy = -2; dy <= 2; ++dy) {
+        for (int dx = -2; dx <= 2; ++dx) {
+            panProvider.getTile(center.x + dx, center.y + dy, zoom);
+        }
+    }
+    auto cached = std::chrono::high_resolution_clock::now();
+    std::cout << "1M points: index " << std::chrono::duration<double, std::milli>(indexed - start).count()
+              << " ms, 25 tiles " << std::chrono::duration<double, std::milli>(rendered - indexed).count()
+              << " ms, 25 cached tiles " << std::chrono::duration<double, std::milli>(cached - rendered).count()
+              << " ms" << std::endl;
+
+    std::cout << "PASSED" << std::endl;
+}
+
+void testHeatmapAccumulator() {
+    std::cout << "Running testHeatmapAccumulator..." << std::endl;
+
+    // 1. 无衰减：加点 / 删点只产生对应的脏网格
+    HeatmapAccumulator acc(100.0, 39.9);
+    acc.add({{39.9000, 116.4000, 1.0}, {39.9001, 116.4001, 2.0}, {39.9500, 116.4500, 4.0}});
+    HeatmapDelta delta = acc.takeDirty();
+    assert(delta.cells.size() == 2);
+    assert(delta.decayFactor == 1.0);
+    assert(delta.cells[0].row < delta.cells[1].row);
+    assert(approxEqual(delta.cells[0].intensity, 3.0));
+    assert(approxEqual(delta.cells[1].intensity, 4.0));
+    assert(std::abs(delta.cells[0].lat - 39.9) < 0.001 && std::abs(delta.cells[0].lon - 116.4) < 0.001);
+    assert(acc.takeDirty().cells.empty());
+
+    acc.remove({39.9001, 116.4001, 2.0});
+    delta = acc.takeDirty();
+    assert(delta.cells.size() == 1 && approxEqual(delta.cells[0].intensity, 1.0));
+    acc.remove({39.9000, 116.4000, 1.0});
+    delta = acc.takeDirty();
+    assert(delta.cells.size() == 1 && delta.cells[0].intensity == 0.0);
+    assert(acc.cellCount() == 1);
+
+    // 南半球 / 西半球的负下标保持 (row, col) 升序
+    acc.add({{-33.86, -70.65, 1.0}, {-33.86, 151.2, 1.0}});
+    const auto full = acc.snapshot();
+    assert(full.size() == 3);
+    assert(full[0].lat < 0 && full[0].lon < 0 && full[1].lat < 0 && full[1].lon > 0 && full[2].lat > 0);
+
+    // 2. 与 generateHeatmapGrid 对照：相同网格内的总权重一致
+    HeatmapAccumulator sum(250.0, 39.9);
+    std::vector<HeatmapPoint> batch;
+    uint32_t seed = 4242;
+    double totalWeight = 0.0;
+    for (int i = 0; i < 50000; ++i) {
+        seed = seed * 1664525u + 1013904223u;
+        const double a = (seed >> 8) / static_cast<double>(1u << 24);
+        seed = seed * 1664525u + 1013904223u;
+        const double b = (seed >> 8) / static_cast<double>(1u << 24);
+        batch.push_back({39.8 + a * 0.2, 116.3 + b * 0.2, 1.0 + a});
+        totalWeight += 1.0 + a;
+    }
+    sum.add(batch);
+    double accumulated = 0.0;
+    for (const auto& c : sum.snapshot()) accumulated += c.intensity;
+    assert(approxEqual(accumulated, totalWeight, 1e-6));
+
+    // 3. 半衰期衰减：衰减本身不产生脏网格，只通过 decayFactor 体现
+    HeatmapAccumulator decaying(100.0, 39.9, 10.0, 0.1);
+    decaying.add({39.90, 116.40, 8.0}, 0.0);
+    decaying.takeDirty();
+    decaying.advanceTime(10.0);
+    delta = decaying.takeDirty();
+    assert(delta.cells.empty());
+    assert(approxEqual(delta.decayFactor, 0.5));
+    assert(approxEqual(decaying.snapshot()[0].intensity, 4.0));
+
+    // 新点按自身时间计入，删除旧点时使用添加时的时间戳精确抵消
+    decaying.add({39.90, 116.40, 2.0}, 10.0);
+    delta = decaying.takeDirty();
+    assert(delta.cells.size() == 1 && approxEqual(delta.cells[0].intensity, 6.0));
+    decaying.remove({39.90, 116.40, 8.0}, 0.0);
+    delta = decaying.takeDirty();
+    assert(approxEqual(delta.cells[0].intensity, 2.0));
+
+    // 长时间后强度低于阈值的网格被清理并作为移除项返回
+    decaying.advanceTime(100.0);
+    delta = decaying.takeDirty();
+    assert(delta.cells.size() == 1 && delta.cells[0].intensity == 0.0);
+    assert(decaying.cellCount() == 0);
+
+    // 省略时间戳表示当前时间：推进时间后新加的点按完整权重计入
+    decaying.add({39.90, 116.40, 4.0});
+    delta = decaying.takeDirty();
+    assert(delta.cells.size() == 1 && approxEqual(delta.cells[0].intensity, 4.0));
+    decaying.remove({39.90, 116.40, 4.0});
+    assert(decaying.cellCount() == 0);
+
+    // 已被清理的旧点再删除时不影响之后落入同一网格的新点
+    decaying.add({39.90, 116.40, 2.0}, 100.0);
+    decaying.remove({39.90, 116.40, 2.0}, 10.0);
+    delta = decaying.takeDirty();
+    assert(decaying.cellCount() == 1);
+    assert(delta.cells.size() == 1 && approxEqual(delta.cells[0].intensity, 2.0));
+
+    // 时间基准重设后强度保持正确
+    HeatmapAccumulator longRun(100.0, 39.9, 1.0, 0.0);
+    longRun.add({39.90, 116.40, 1.0}, 0.0);
+    for (int t = 1; t <= 50; ++t) {
+        longRun.advanceTime(t);
+        longRun.add({39.95, 116.45, 1.0}, t);
+    }
+    const auto longSnapshot = longRun.snapshot();
+    assert(longSnapshot.size() == 2);
+    assert(approxEqual(longSnapshot[0].intensity, std::pow(0.5, 50.0), 1e-18));
+    assert(approxEqual(longSnapshot[1].intensity, 2.0 - std::pow(0.5, 50.0), 1e-9));
+
+    // 性能：每秒 500 个新点，持续 10 分钟，每秒取一次增量
+    HeatmapAccumulator live(200.0, 39.9, 300.0);
+    size_t dirtyTotal = 0;
+    auto start = std::chrono::high_resolution_clock::now();
+    for (int second = 0; second < 600; ++second) {
+        for (int i = 0; i < 500; ++i) {
+            seed = seed * 1664525u + 1013904223u;
+            const double a = (seed >> 8) / static_cast<double>(1u << 24);
+            seed = seed * 1664525u + 1013904223u;
+            const double b = (seed >> 8) / static_cast<double>(1u << 24);
+            live.add({39.7 + a * 0.4, 116.2 + b * 0.4, 1.0}, second + i / 500.0);
+        }
+        dirtyTotal += live.takeDirty().cells.size();
+    }
+    auto end = std::chrono::high_resolution_clock::now();
+    std::cout << "300,000 live points (600 snapshots): "
+              << std::chrono::duration<double, std::milli>(end - start).count() << " ms, "
+              << live.cellCount() << " cells, avg dirty " << dirtyTotal / 600 << std::endl;
+
+    std::cout << "PASSED" << std::endl;
+}
+
 void testQuadTree() {
     std::cout << "Running testQuadTree..." << std::endl;
 
@@ -266,17 +3177,43 @@ void testClusterEngine() {
     std::cout << "PASSED" << std::endl;
 }
 
-int main() {
+int main(int argc, char** argv) {
+    // 颜色解析基准耗时较长，只在传入 --bench 时运行
+    const bool runBenchmarks = argc > 1 && std::string(argv[1]) == "--bench";
+
     std::cout << "========================================" << std::endl;
     std::cout << "STARTING C++ SHARED CODE TESTS" << std::endl;
     std::cout << "========================================" << std::endl;
 
     try {
         testDistance();
+        testEllipsoidDistance();
         testColorParser();
+        if (runBenchmarks) {
+            benchmarkColorParser();
+        }
         testPointInPolygon();
+        testPointsInPolygon();
         testGeometryEngineExtended();
         benchmarkParsePolyline();
+        testGeoHash();
+        testCellId();
+        testBatchProjection();
+        testViewportClipping();
+        testHulls();
+        testResamplePolyline();
+        testCoordinateTransform();
+        testStreamingBounds();
+        testCollisionEngine();
+        testPolygonClipper();
+        testTriangulator();
+        testTrajectoryAnalyzer();
+        testGpsSmoother();
+        testPathSimilarity();
+        testHeatmapGrid();
+        testHeatmapRasterizer();
+        testHeatmapTileProvider();
+        testHeatmapAccumulator();
         testQuadTree();
         testClusterEngine();
         
@@ -2,7 +2,7 @@
  * 几何模块
  */
 
-import type { LatLng, LatLngPoint } from '../types';
+import type { EarthModel, LatLng, LatLngPoint } from '../types';
 import { ErrorHandler, ErrorLogger } from '../utils/ErrorHandler';
 import { normalizeLatLng, normalizeLatLngList } from '../utils/GeoUtils';
 import { nativeModule } from './nativeModule';
@@ -13,16 +13,18 @@ export const geometryMethods = {
    * 计算两个坐标点之间的距离
    * @param coordinate1 第一个坐标点
    * @param coordinate2 第二个坐标点
+   * @param earthModel 地球模型，默认 'sphere'；'wgs84' 按椭球计算测地线距离
    * @returns 两点之间的距离（单位：米）
    */
-  distanceBetweenCoordinates(coordinate1: LatLngPoint, coordinate2: LatLngPoint): number {
+  distanceBetweenCoordinates(coordinate1: LatLngPoint, coordinate2: LatLngPoint, earthModel: EarthModel = 'sphere'): number {
     if (!nativeModule) {
       throw ErrorHandler.nativeModuleUnavailable();
     }
     try {
       return nativeModule.distanceBetweenCoordinates(
         normalizeLatLng(coordinate1),
-        normalizeLatLng(coordinate2)
+        normalizeLatLng(coordinate2),
+        earthModel
       );
     } catch (error) {
       throw ErrorHandler.wrapNativeError(error, '计算距离');
@@ -115,14 +117,15 @@ export const geometryMethods = {
   /**
    * 计算多边形面积
    * @param polygon 多边形的顶点坐标数组，支持嵌套数组（多边形空洞）
+   * @param earthModel 地球模型，默认 'sphere'
    * @returns 面积（单位：平方米）
    */
-  calculatePolygonArea(polygon: LatLngPoint[] | LatLngPoint[][]): number {
+  calculatePolygonArea(polygon: LatLngPoint[] | LatLngPoint[][], earthModel: EarthModel = 'sphere'): number {
     if (!nativeModule) {
       throw ErrorHandler.nativeModuleUnavailable();
     }
     try {
-      return nativeModule.calculatePolygonArea(normalizeLatLngList(polygon));
+      return nativeModule.calculatePolygonArea(normalizeLatLngList(polygon), earthModel);
     } catch (error) {
       throw ErrorHandler.wrapNativeError(error, '计算多边形面积');
     }
@@ -249,12 +252,13 @@ export const geometryMethods = {
   /**
    * 计算路径总长度
    * @param points 路径点
+   * @param earthModel 地球模型，默认 'sphere'
    * @returns 长度(米)
    */
-  calculatePathLength(points: LatLngPoint[]): number {
+  calculatePathLength(points: LatLngPoint[], earthModel: EarthModel = 'sphere'): number {
     if (!nativeModule) return 0;
     try {
-      return nativeModule.calculatePathLength(normalizeLatLngList(points));
+      return nativeModule.calculatePathLength(normalizeLatLngList(points), earthModel);
     } catch (error) {
       ErrorLogger.warn('calculatePathLength 失败', { pointsCount: points.length, error });
       return 0;
@@ -286,6 +290,124 @@ export const geometryMethods = {
     }
   },
 
+  /**
+   * 解析高德多环 / 多段 Polyline 字符串（行政区边界、AOI 等）
+   * 拆环、解析与相邻去重在原生一次完成，避免大字符串在 JS 中反复 split
+   * @param polylineStr 高德原始 polyline 字符串，`|` 分隔环，`;` 分隔坐标点
+   * @param dedupeAdjacent 是否去除环内相邻重复点，默认 true
+   * @returns 扁平坐标与环偏移，原生模块不可用时返回 null
+   */
+  parsePolylineRings(polylineStr: string, dedupeAdjacent = true): {
+    coordinates: number[];
+    ringOffsets: number[];
+  } | null {
+    if (!nativeModule || typeof nativeModule.parsePolylineRings !== 'function') return null;
+    if (!polylineStr) return { coordinates: [], ringOffsets: [0] };
+    try {
+      return nativeModule.parsePolylineRings(polylineStr, dedupeAdjacent);
+    } catch (error) {
+      ErrorLogger.warn('解析多环 Polyline 失败', { length: polylineStr.length, error });
+      return null;
+    }
+  },
+
+  /**
+   * 将路径编码为紧凑字符串（Encoded Polyline 格式）
+   * 适合缓存路线 / 行政区边界，体积约为 JSON 坐标数组的十分之一
+   * @param points 路径点
+   * @param precision 小数精度位数 (1-9)，默认 5（约 1 米）
+   * @returns 编码字符串
+   */
+  encodePolyline(points: LatLngPoint[], precision = 5): string {
+    if (!nativeModule) {
+      throw ErrorHandler.nativeModuleUnavailable();
+    }
+    try {
+      return nativeModule.encodePolyline(normalizeLatLngList(points), precision);
+    } catch (error) {
+      throw ErrorHandler.wrapNativeError(error, 'Polyline 编码');
+    }
+  },
+
+  /**
+   * 解码 encodePolyline 生成的字符串
+   * @param encoded 编码字符串
+   * @param precision 编码时使用的精度位数，默认 5
+   * @returns 路径点
+   */
+  decodePolyline(encoded: string, precision = 5): LatLng[] {
+    if (!nativeModule || !encoded) return [];
+    try {
+      return nativeModule.decodePolyline(encoded, precision);
+    } catch (error) {
+      ErrorLogger.warn('Polyline 解码失败', { length: encoded.length, error });
+      return [];
+    }
+  },
+
+  /**
+   * 按间距重采样路径：总长按最接近 spacingMeters 的间距均分，首尾点保留
+   * @param points 路径点
+   * @param spacingMeters 目标间距(米)
+   * @param cornerAngleDegrees > 0 时保留航向变化超过该角度的转角顶点，转角之间再均分
+   * @returns 重采样后的路径点
+   */
+  resamplePolyline(points: LatLngPoint[], spacingMeters: number, cornerAngleDegrees = 0): LatLng[] {
+    if (!nativeModule) {
+      throw ErrorHandler.nativeModuleUnavailable();
+    }
+    try {
+      return nativeModule.resamplePolyline(normalizeLatLngList(points), spacingMeters, cornerAngleDegrees);
+    } catch (error) {
+      throw ErrorHandler.wrapNativeError(error, '路径重采样');
+    }
+  },
+
+  /**
+   * 沿路径按距离等距取 count 个点（含首尾）
+   * @param points 路径点
+   * @param count 点数
+   * @returns 重采样后的路径点
+   */
+  resamplePolylineByCount(points: LatLngPoint[], count: number): LatLng[] {
+    if (!nativeModule) {
+      throw ErrorHandler.nativeModuleUnavailable();
+    }
+    try {
+      return nativeModule.resamplePolylineByCount(normalizeLatLngList(points), count);
+    } catch (error) {
+      throw ErrorHandler.wrapNativeError(error, '路径重采样');
+    }
+  },
+
+  /**
+   * 比较候选路线与参考路线（如 Web 规划线）的相似程度
+   * @param reference 参考路线
+   * @param points 候选路线
+   * @param thresholdMeters 统计超限顶点数的距离阈值(米)
+   * @returns 候选路线顶点到参考路线的平均/最大偏差、超限顶点数，以及双向 Hausdorff 与离散 Fréchet 距离；任一路线为空时返回 null
+   */
+  comparePaths(reference: LatLngPoint[], points: LatLngPoint[], thresholdMeters: number): {
+    averageDeviationMeters: number;
+    maxDeviationMeters: number;
+    exceededCount: number;
+    hausdorffMeters: number;
+    frechetMeters: number;
+  } | null {
+    if (!nativeModule) {
+      throw ErrorHandler.nativeModuleUnavailable();
+    }
+    try {
+      return nativeModule.comparePaths(
+        normalizeLatLngList(reference),
+        normalizeLatLngList(points),
+        thresholdMeters
+      );
+    } catch (error) {
+      throw ErrorHandler.wrapNativeError(error, '路线相似度比较');
+    }
+  },
+
   /**
    * 获取路径上指定距离的点
    * @param points 路径点
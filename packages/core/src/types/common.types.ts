@@ -102,6 +102,13 @@ export interface LatLng {
  */
 export type LatLngPoint = LatLng | [number, number] | number[];
 
+/**
+ * 距离 / 面积计算使用的地球模型，每次调用单独指定
+ * - sphere: 半径 6371000 米的球面（Haversine），默认
+ * - wgs84: WGS-84 椭球（测地线距离，椭球面积），长距离更精确
+ */
+export type EarthModel = 'sphere' | 'wgs84';
+
 /**
  * 地图标注点（POI）
  */
@@ -224,7 +231,7 @@ export enum MapType {
 /**
  * 颜色值类型
  * 支持：
- * - 十六进制字符串: '#AARRGGBB' 或 '#RRGGBB'
+ * - 颜色字符串: '#RRGGBB'、'#RRGGBBAA'（透明度在最后）、'rgba(...)'、'hsl(...)' 或颜色名称
  * - 数字格式: 0xAARRGGBB (用于 Android)
  */
 export type ColorValue = string | number;
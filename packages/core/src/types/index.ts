@@ -8,6 +8,7 @@ export type {
   Point,
   LatLng,
   LatLngPoint,
+  EarthModel,
   MapPoi,
   LatLngBounds,
   CameraPosition,
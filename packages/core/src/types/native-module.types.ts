@@ -11,6 +11,7 @@ import type {
   SDKConfig,
   PermissionStatus,
   LatLngPoint,
+  EarthModel,
 } from './common.types';
 import type {
   CoordinateType,
@@ -282,9 +283,10 @@ export interface NativeExpoGaodeMapModule
    * 计算两个坐标点之间的距离
    * @param coordinate1 第一个坐标点
    * @param coordinate2 第二个坐标点
+   * @param earthModel 地球模型，默认 'sphere'
    * @returns 两点之间的距离（单位：米）
    */
-  distanceBetweenCoordinates(coordinate1: LatLngPoint, coordinate2: LatLngPoint): number;
+  distanceBetweenCoordinates(coordinate1: LatLngPoint, coordinate2: LatLngPoint, earthModel?: EarthModel): number;
 
   /**
    * 根据多个坐标点计算可同时可见的推荐缩放级别
@@ -326,9 +328,10 @@ export interface NativeExpoGaodeMapModule
   /**
    * 计算多边形面积
    * @param polygon 多边形的顶点坐标数组，支持嵌套数组（多边形空洞，会自动展平计算）
+   * @param earthModel 地球模型，默认 'sphere'
    * @returns 面积（单位：平方米）
    */
-  calculatePolygonArea(polygon: LatLngPoint[] | LatLngPoint[][]): number;
+  calculatePolygonArea(polygon: LatLngPoint[] | LatLngPoint[][], earthModel?: EarthModel): number;
 
   /**
    * 计算矩形面积
@@ -390,9 +393,10 @@ export interface NativeExpoGaodeMapModule
   /**
    * 计算路径总长度
    * @param points 路径点
+   * @param earthModel 地球模型，默认 'sphere'
    * @returns 长度(米)
    */
-  calculatePathLength(points: LatLngPoint[]): number;
+  calculatePathLength(points: LatLngPoint[], earthModel?: EarthModel): number;
 
   /**
    * 解析高德地图 API 返回的 Polyline 字符串
@@ -402,6 +406,66 @@ export interface NativeExpoGaodeMapModule
    */
   parsePolyline(polylineStr: string | { polyline: string }): LatLng[];
 
+  /**
+   * 解析高德多环 / 多段 Polyline 字符串
+   * 格式: "lng,lat;lng,lat|lng,lat;..."，`|` 分隔环，`;` 分隔坐标点
+   * @param polylineStr 高德原始 polyline 字符串
+   * @param dedupeAdjacent 是否去除环内相邻重复点，默认 true
+   * @returns 扁平坐标 [lat0, lon0, lat1, lon1, ...] 与环偏移（末尾追加总点数）
+   */
+  parsePolylineRings(polylineStr: string, dedupeAdjacent?: boolean): {
+    coordinates: number[];
+    ringOffsets: number[];
+  };
+
+  /**
+   * 将路径编码为紧凑字符串（Encoded Polyline 格式：差分 + zigzag + 变长分组）
+   * @param points 路径点
+   * @param precision 小数精度位数 (1-9)，默认 5（约 1 米）
+   * @returns 编码字符串
+   */
+  encodePolyline(points: LatLngPoint[], precision?: number): string;
+
+  /**
+   * 解码 encodePolyline 生成的字符串
+   * @param encoded 编码字符串
+   * @param precision 编码时使用的精度位数，默认 5
+   * @returns 路径点
+   */
+  decodePolyline(encoded: string, precision?: number): LatLng[];
+
+  /**
+   * 按间距重采样路径：总长按最接近 spacingMeters 的间距均分，首尾点保留
+   * @param points 路径点
+   * @param spacingMeters 目标间距(米)
+   * @param cornerAngleDegrees > 0 时保留航向变化超过该角度的转角顶点
+   * @returns 重采样后的路径点
+   */
+  resamplePolyline(points: LatLngPoint[], spacingMeters: number, cornerAngleDegrees?: number): LatLng[];
+
+  /**
+   * 沿路径按距离等距取 count 个点（含首尾）
+   * @param points 路径点
+   * @param count 点数
+   * @returns 重采样后的路径点
+   */
+  resamplePolylineByCount(points: LatLngPoint[], count: number): LatLng[];
+
+  /**
+   * 比较候选路线与参考路线（如 Web 规划线）的相似程度
+   * @param reference 参考路线
+   * @param points 候选路线
+   * @param thresholdMeters 统计超限顶点数的距离阈值(米)
+   * @returns 候选路线顶点到参考路线的平均/最大偏差、超限顶点数，以及双向 Hausdorff 与离散 Fréchet 距离；任一路线为空时返回 null
+   */
+  comparePaths(reference: LatLngPoint[], points: LatLngPoint[], thresholdMeters: number): {
+    averageDeviationMeters: number;
+    maxDeviationMeters: number;
+    exceededCount: number;
+    hausdorffMeters: number;
+    frechetMeters: number;
+  } | null;
+
   /**
    * 获取路径上指定距离的点
    * @param points 路径点
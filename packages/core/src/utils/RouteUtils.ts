@@ -201,6 +201,43 @@ function parsePolylineRing(polyline: string): LatLng[] {
     .filter((point): point is LatLng => point !== null);
 }
 
+/**
+ * 优先使用原生解析器拆分多环 polyline。
+ *
+ * 原生侧一次完成拆环与坐标解析，返回扁平坐标和环偏移，
+ * 这里只负责还原成 LatLng 数组。原生模块不可用时返回 null，由 JS 解析兜底。
+ *
+ * @param polyline 高德 polyline 字符串。
+ * @returns 解析后的环数组，可能为 null。
+ */
+function parseRingsNative(polyline: string): LatLng[][] | null {
+  let parsed: { coordinates: number[]; ringOffsets: number[] } | null = null;
+  try {
+    parsed = ExpoGaodeMapModule.parsePolylineRings(polyline, false);
+  } catch {
+    return null;
+  }
+  if (!parsed) {
+    return null;
+  }
+
+  const { coordinates, ringOffsets } = parsed;
+  const rings: LatLng[][] = [];
+  for (let ringIndex = 0; ringIndex + 1 < ringOffsets.length; ringIndex += 1) {
+    const start = ringOffsets[ringIndex] ?? 0;
+    const end = ringOffsets[ringIndex + 1] ?? start;
+    const ring: LatLng[] = new Array(end - start);
+    for (let pointIndex = start; pointIndex < end; pointIndex += 1) {
+      ring[pointIndex - start] = {
+        latitude: coordinates[pointIndex * 2] as number,
+        longitude: coordinates[pointIndex * 2 + 1] as number,
+      };
+    }
+    rings.push(ring);
+  }
+  return rings;
+}
+
 /**
  * 解析高德多环 polyline，并计算整体坐标边界。
  *
@@ -213,22 +250,29 @@ function parsePolylineRing(polyline: string): LatLng[] {
 export function parseMultiRingPolyline(polyline: string): MultiRingPolyline {
   // 高德 AOI / 多边形边界常见格式为 ring1|ring2，
   // 这里按“外环/内环”统一拆成二维坐标数组。
-  const rings = polyline
+  const rings = parseRingsNative(polyline) ?? polyline
     .split('|')
     .map((ring) => parsePolylineRing(ring))
     .filter((ring) => ring.length > 0);
 
-  const flattened = rings.flat();
-  const bounds = flattened.length
+  // 行政区边界可能有数十万个点，单次遍历求边界，避免 Math.min(...spread) 爆栈。
+  let south = Infinity;
+  let west = Infinity;
+  let north = -Infinity;
+  let east = -Infinity;
+  for (const ring of rings) {
+    for (const point of ring) {
+      if (point.latitude < south) south = point.latitude;
+      if (point.latitude > north) north = point.latitude;
+      if (point.longitude < west) west = point.longitude;
+      if (point.longitude > east) east = point.longitude;
+    }
+  }
+
+  const bounds = Number.isFinite(south)
     ? {
-        southwest: {
-          latitude: Math.min(...flattened.map((point) => point.latitude)),
-          longitude: Math.min(...flattened.map((point) => point.longitude)),
-        },
-        northeast: {
-          latitude: Math.max(...flattened.map((point) => point.latitude)),
-          longitude: Math.max(...flattened.map((point) => point.longitude)),
-        },
+        southwest: { latitude: south, longitude: west },
+        northeast: { latitude: north, longitude: east },
       }
     : null;
 
@@ -10,6 +10,7 @@ typedef void* jintArray;
 typedef void* jstring;
 typedef double jdouble;
 typedef int jint;
+typedef long long jlong;
 typedef int jsize;
 typedef void* jobjectArray;
 typedef unsigned char jboolean;
@@ -23,12 +24,15 @@ typedef unsigned char jboolean;
 #define JNICALL
 #endif
 
+#include <algorithm>
 #include <vector>
 #include <string>
+#include <string_view>
 
 #include "../../../../shared/cpp/ClusterEngine.hpp"
 #include "../../../../shared/cpp/GeometryEngine.hpp"
 #include "../../../../shared/cpp/ColorParser.hpp"
+#include "../../../../shared/cpp/PathSimilarity.hpp"
 
 extern "C" JNIEXPORT jintArray JNICALL
 Java_expo_modules_gaodemap_map_utils_ClusterNative_clusterPoints(
@@ -376,7 +380,8 @@ Java_expo_modules_gaodemap_map_utils_GeometryUtils_nativeCalculateDistance(
 #endif
 }
 
-extern "C" JNIEXPORT jint JNICALL
+// 返回 0xAARRGGBB（0 ~ 0xFFFFFFFF），解析失败返回 -1，与合法的 transparent (0) 区分
+extern "C" JNIEXPORT jlong JNICALL
 Java_expo_modules_gaodemap_map_utils_ColorParser_nativeParseColor(
     JNIEnv* env,
     jclass,
@@ -384,20 +389,22 @@ Java_expo_modules_gaodemap_map_utils_ColorParser_nativeParseColor(
 ) {
 #if GAODE_HAVE_JNI
     if (!colorString) {
-        return 0; // Black or 0
+        return -1;
     }
     const char* nativeString = env->GetStringUTFChars(colorString, nullptr);
     if (!nativeString) {
-        return 0;
+        return -1;
     }
-    std::string str(nativeString);
+    // 直接解析 JNI 返回的 UTF-8 缓冲区，释放前完成，不再复制到 std::string
+    uint32_t color = 0;
+    const bool ok = gaodemap::tryParseColor(std::string_view(nativeString), color);
     env->ReleaseStringUTFChars(colorString, nativeString);
 
-    return static_cast<jint>(gaodemap::parseColor(str));
+    return ok ? static_cast<jlong>(color) : -1;
 #else
     (void)env;
     (void)colorString;
-    return 0;
+    return -1;
 #endif
 }
 
@@ -902,3 +909,97 @@ Java_expo_modules_gaodemap_map_utils_GeometryUtils_nativeGenerateHeatmapGrid(
     return nullptr;
 #endif
 }
+
+extern "C" JNIEXPORT jdoubleArray JNICALL
+Java_expo_modules_gaodemap_map_utils_GeometryUtils_nativeResamplePolylineByCount(
+    JNIEnv* env,
+    jclass,
+    jdoubleArray latitudes,
+    jdoubleArray longitudes,
+    jint count
+) {
+#if GAODE_HAVE_JNI
+    if (!latitudes || !longitudes || count <= 0) {
+        return nullptr;
+    }
+
+    const jsize countLat = env->GetArrayLength(latitudes);
+    if (countLat != env->GetArrayLength(longitudes)) {
+        return nullptr;
+    }
+
+    jdouble* latValues = env->GetDoubleArrayElements(latitudes, nullptr);
+    jdouble* lonValues = env->GetDoubleArrayElements(longitudes, nullptr);
+
+    const gaodemap::CoordSpan span(latValues, lonValues, static_cast<size_t>(countLat));
+    const auto points = gaodemap::resamplePolylineByCount(span, static_cast<size_t>(count));
+
+    env->ReleaseDoubleArrayElements(latitudes, latValues, JNI_ABORT);
+    env->ReleaseDoubleArrayElements(longitudes, lonValues, JNI_ABORT);
+
+    jdoubleArray result = env->NewDoubleArray(static_cast<jsize>(points.size() * 2));
+    if (result == nullptr) return nullptr;
+    if (points.empty()) return result;
+    env->SetDoubleArrayRegion(result, 0, static_cast<jsize>(points.size() * 2), reinterpret_cast<const jdouble*>(points.data()));
+    return result;
+#else
+    (void)env; (void)latitudes; (void)longitudes; (void)count;
+    return nullptr;
+#endif
+}
+
+extern "C" JNIEXPORT jdoubleArray JNICALL
+Java_expo_modules_gaodemap_map_utils_GeometryUtils_nativeComparePaths(
+    JNIEnv* env,
+    jclass,
+    jdoubleArray referenceLatitudes,
+    jdoubleArray referenceLongitudes,
+    jdoubleArray latitudes,
+    jdoubleArray longitudes,
+    jdouble thresholdMeters
+) {
+#if GAODE_HAVE_JNI
+    if (!referenceLatitudes || !referenceLongitudes || !latitudes || !longitudes) {
+        return nullptr;
+    }
+
+    const jsize referenceCount = env->GetArrayLength(referenceLatitudes);
+    const jsize count = env->GetArrayLength(latitudes);
+    if (referenceCount != env->GetArrayLength(referenceLongitudes) || count != env->GetArrayLength(longitudes)) {
+        return nullptr;
+    }
+
+    jdouble* referenceLatValues = env->GetDoubleArrayElements(referenceLatitudes, nullptr);
+    jdouble* referenceLonValues = env->GetDoubleArrayElements(referenceLongitudes, nullptr);
+    jdouble* latValues = env->GetDoubleArrayElements(latitudes, nullptr);
+    jdouble* lonValues = env->GetDoubleArrayElements(longitudes, nullptr);
+
+    const gaodemap::CoordSpan reference(referenceLatValues, referenceLonValues, static_cast<size_t>(referenceCount));
+    const gaodemap::CoordSpan path(latValues, lonValues, static_cast<size_t>(count));
+    const gaodemap::PathSegmentIndex referenceIndex(reference);
+    const gaodemap::PathDeviation deviation = gaodemap::measurePathDeviation(referenceIndex, path, thresholdMeters);
+    const double reverse = gaodemap::directedHausdorffDistance(gaodemap::PathSegmentIndex(path), reference);
+    const double frechet = gaodemap::discreteFrechetDistance(reference, path);
+
+    env->ReleaseDoubleArrayElements(referenceLatitudes, referenceLatValues, JNI_ABORT);
+    env->ReleaseDoubleArrayElements(referenceLongitudes, referenceLonValues, JNI_ABORT);
+    env->ReleaseDoubleArrayElements(latitudes, latValues, JNI_ABORT);
+    env->ReleaseDoubleArrayElements(longitudes, lonValues, JNI_ABORT);
+
+    // [averageDeviation, maxDeviation, exceededCount, hausdorff, frechet]
+    const jdouble values[5] = {
+        deviation.averageMeters,
+        deviation.maxMeters,
+        static_cast<jdouble>(deviation.exceededCount),
+        std::max(deviation.maxMeters, reverse),
+        frechet
+    };
+    jdoubleArray result = env->NewDoubleArray(5);
+    if (result == nullptr) return nullptr;
+    env->SetDoubleArrayRegion(result, 0, 5, values);
+    return result;
+#else
+    (void)env; (void)referenceLatitudes; (void)referenceLongitudes; (void)latitudes; (void)longitudes; (void)thresholdMeters;
+    return nullptr;
+#endif
+}
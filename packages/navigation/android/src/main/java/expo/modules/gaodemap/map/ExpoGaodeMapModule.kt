@@ -469,6 +469,46 @@ class ExpoGaodeMapModule : Module() {
       })
     }
 
+    /**
+     * 沿路径按距离等距取点
+     * @param points 路径点
+     * @param count 点数（含首尾）
+     * @return 重采样后的路径点
+     */
+    Function("resamplePolylineByCount") { points: List<Any>?, count: Int ->
+      val poly = LatLngParser.parseLatLngList(points)
+      jsValue(GeometryUtils.resamplePolylineByCount(poly, count).map {
+        mapOf(
+          "latitude" to it.latitude,
+          "longitude" to it.longitude
+        )
+      })
+    }
+
+    /**
+     * 比较候选路线与参考路线（如 Web 规划线）的相似程度
+     * @param reference 参考路线
+     * @param points 候选路线
+     * @param thresholdMeters 统计超限顶点数的距离阈值(米)
+     * @return 平均/最大偏差、超限顶点数、Hausdorff 与离散 Fréchet 距离
+     */
+    Function("comparePaths") { reference: List<Any>?, points: List<Any>?, thresholdMeters: Double ->
+      val result = GeometryUtils.comparePaths(
+        LatLngParser.parseLatLngList(reference),
+        LatLngParser.parseLatLngList(points),
+        thresholdMeters
+      )
+      jsValue(result?.let {
+        mapOf(
+          "averageDeviationMeters" to it.averageDeviationMeters,
+          "maxDeviationMeters" to it.maxDeviationMeters,
+          "exceededCount" to it.exceededCount,
+          "hausdorffMeters" to it.hausdorffMeters,
+          "frechetMeters" to it.frechetMeters
+        )
+      })
+    }
+
     /**
      * 获取路径上指定距离的点
      * @param points 路径点
@@ -1,7 +1,6 @@
 package expo.modules.gaodemap.map.overlays
 
 import android.content.Context
-import android.graphics.Color
 import android.os.Looper
 import android.util.Log
 import com.amap.api.maps.AMap
@@ -14,6 +13,7 @@ import com.amap.api.maps.model.TileOverlayOptions
 import com.amap.api.maps.model.WeightedLatLng
 import expo.modules.kotlin.AppContext
 import expo.modules.kotlin.views.ExpoView
+import expo.modules.gaodemap.map.utils.ColorParser
 import expo.modules.gaodemap.map.utils.LatLngParser
 import java.util.concurrent.ExecutorService
 import java.util.concurrent.Executors
@@ -312,7 +312,8 @@ class HeatMapView(context: Context, appContext: AppContext) : ExpoView(context,
   private fun parseColor(value: Any?): Int? {
     return when (value) {
       is Number -> value.toInt()
-      is String -> runCatching { Color.parseColor(value) }.getOrNull()
+      // 与其它覆盖物一致，#RRGGBBAA 的透明度在最后
+      is String -> ColorParser.tryParseColor(value)
       else -> null
     }
   }
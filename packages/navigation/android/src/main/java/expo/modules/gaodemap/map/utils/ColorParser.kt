@@ -1,7 +1,6 @@
 package expo.modules.gaodemap.map.utils
 
 import android.graphics.Color
-import androidx.core.graphics.toColorInt
 
 object ColorParser {
     init {
@@ -12,12 +11,13 @@ object ColorParser {
         }
     }
 
-    private external fun nativeParseColor(colorString: String): Int
+    // 返回 0xAARRGGBB，解析失败返回 -1（与合法的 transparent 即 0 区分）
+    private external fun nativeParseColor(colorString: String): Long
 
     /**
      * 解析颜色值
      * 支持格式:
-     * - 字符串: "#AARRGGBB", "#RRGGBB", "red", "blue" 等
+     * - 字符串: "#RRGGBB", "#RRGGBBAA", "rgba(...)", "hsl(...)", "red", "blue" 等
      * - 数字: Int (ARGB)
      */
     fun parseColor(value: Any?): Int {
@@ -31,52 +31,80 @@ object ColorParser {
     }
     
     private fun parseColorString(color: String): Int {
+        return tryParseColor(color) ?: Color.BLACK
+    }
+
+    /**
+     * 解析颜色字符串，格式同 parseColor
+     * @return 解析失败时返回 null（"transparent" 等合法的全透明颜色返回 0）
+     */
+    fun tryParseColor(color: String): Int? {
         // Try native parser first
         try {
             val nativeColor = nativeParseColor(color)
-            if (nativeColor != 0) {
-                return nativeColor
+            if (nativeColor >= 0) {
+                return nativeColor.toInt()
             }
         } catch (_: Throwable) {
             // Fallback to Kotlin implementation
         }
 
+        val trimmed = color.trim()
         return try {
             when {
-                color.startsWith("#") -> color.toColorInt()
-                color.startsWith("rgba(") -> parseRgbaColor(color)
-                color.startsWith("rgb(") -> parseRgbColor(color)
-                else -> getNamedColor(color)
+                trimmed.startsWith("#") -> parseHexColor(trimmed.substring(1))
+                trimmed.startsWith("rgba(") -> parseRgbaColor(trimmed)
+                trimmed.startsWith("rgb(") -> parseRgbColor(trimmed)
+                else -> getNamedColor(trimmed)
             }
         } catch (_: Exception) {
-            Color.BLACK
+            null
+        }
+    }
+
+    /**
+     * 解析 RGB / RGBA / RRGGBB / RRGGBBAA，与原生解析一致，透明度在最后
+     */
+    private fun parseHexColor(hex: String): Int? {
+        val expanded = when (hex.length) {
+            3, 4 -> hex.map { "$it$it" }.joinToString("")
+            6, 8 -> hex
+            else -> return null
+        }
+        val value = expanded.toLongOrNull(16) ?: return null
+        return if (expanded.length == 8) {
+            val rgb = (value ushr 8).toInt() and 0xFFFFFF
+            val alpha = (value and 0xFF).toInt()
+            (alpha shl 24) or rgb
+        } else {
+            (0xFF shl 24) or value.toInt()
         }
     }
     
-    private fun parseRgbaColor(color: String): Int {
+    private fun parseRgbaColor(color: String): Int? {
         val values = color.substringAfter("rgba(").substringBefore(")").split(",").map { it.trim() }
-        if (values.size != 4) return Color.BLACK
+        if (values.size != 4) return null
         
-        val r = values[0].toIntOrNull() ?: return Color.BLACK
-        val g = values[1].toIntOrNull() ?: return Color.BLACK
-        val b = values[2].toIntOrNull() ?: return Color.BLACK
-        val a = (values[3].toFloatOrNull()?.times(255))?.toInt() ?: return Color.BLACK
+        val r = values[0].toIntOrNull() ?: return null
+        val g = values[1].toIntOrNull() ?: return null
+        val b = values[2].toIntOrNull() ?: return null
+        val a = (values[3].toFloatOrNull()?.times(255))?.toInt() ?: return null
         
         return Color.argb(a, r, g, b)
     }
     
-    private fun parseRgbColor(color: String): Int {
+    private fun parseRgbColor(color: String): Int? {
         val values = color.substringAfter("rgb(").substringBefore(")").split(",").map { it.trim() }
-        if (values.size != 3) return Color.BLACK
+        if (values.size != 3) return null
         
-        val r = values[0].toIntOrNull() ?: return Color.BLACK
-        val g = values[1].toIntOrNull() ?: return Color.BLACK
-        val b = values[2].toIntOrNull() ?: return Color.BLACK
+        val r = values[0].toIntOrNull() ?: return null
+        val g = values[1].toIntOrNull() ?: return null
+        val b = values[2].toIntOrNull() ?: return null
         
         return Color.rgb(r, g, b)
     }
     
-    private fun getNamedColor(name: String): Int {
+    private fun getNamedColor(name: String): Int? {
         return when (name.lowercase()) {
             "red" -> Color.RED
             "blue" -> Color.BLUE
@@ -88,7 +116,7 @@ object ColorParser {
             "cyan" -> Color.CYAN
             "magenta" -> Color.MAGENTA
             "transparent" -> Color.TRANSPARENT
-            else -> Color.BLACK
+            else -> null
         }
     }
 }
\ No newline at end of file
@@ -538,6 +538,71 @@ object GeometryUtils {
         polylineStr: String
     ): DoubleArray?
 
+    private external fun nativeResamplePolylineByCount(
+        latitudes: DoubleArray,
+        longitudes: DoubleArray,
+        count: Int
+    ): DoubleArray?
+
+    /**
+     * 沿路径按距离等距取 count 个点（含首尾）
+     */
+    fun resamplePolylineByCount(points: List<LatLng>, count: Int): List<LatLng> {
+        if (count <= 0 || points.isEmpty()) return emptyList()
+        return try {
+            val latitudes = DoubleArray(points.size) { i -> points[i].latitude }
+            val longitudes = DoubleArray(points.size) { i -> points[i].longitude }
+            val result = nativeResamplePolylineByCount(latitudes, longitudes, count) ?: return points
+            val resampled = ArrayList<LatLng>(result.size / 2)
+            for (i in 0 until result.size - 1 step 2) {
+                resampled.add(LatLng(result[i], result[i + 1]))
+            }
+            resampled
+        } catch (_: Throwable) {
+            points
+        }
+    }
+
+    private external fun nativeComparePaths(
+        referenceLatitudes: DoubleArray,
+        referenceLongitudes: DoubleArray,
+        latitudes: DoubleArray,
+        longitudes: DoubleArray,
+        thresholdMeters: Double
+    ): DoubleArray?
+
+    data class PathComparison(
+        /** 路线各顶点到参考路线的平均距离 */
+        val averageDeviationMeters: Double,
+        /** 路线各顶点到参考路线的最大距离 */
+        val maxDeviationMeters: Double,
+        /** 到参考路线的距离超过阈值的顶点数 */
+        val exceededCount: Int,
+        /** 双向 Hausdorff 距离 */
+        val hausdorffMeters: Double,
+        /** 离散 Fréchet 距离（考虑行进顺序） */
+        val frechetMeters: Double
+    )
+
+    /**
+     * 比较候选路线与参考路线（如 Web 规划线）的相似程度
+     */
+    fun comparePaths(reference: List<LatLng>, path: List<LatLng>, thresholdMeters: Double): PathComparison? {
+        if (reference.isEmpty() || path.isEmpty()) return null
+        return try {
+            val result = nativeComparePaths(
+                DoubleArray(reference.size) { i -> reference[i].latitude },
+                DoubleArray(reference.size) { i -> reference[i].longitude },
+                DoubleArray(path.size) { i -> path[i].latitude },
+                DoubleArray(path.size) { i -> path[i].longitude },
+                thresholdMeters
+            ) ?: return null
+            PathComparison(result[0], result[1], result[2].toInt(), result[3], result[4])
+        } catch (_: Throwable) {
+            null
+        }
+    }
+
     fun latLngToTile(latLng: LatLng, zoom: Int): IntArray? {
         return try {
             nativeLatLngToTile(latLng.latitude, latLng.longitude, zoom)
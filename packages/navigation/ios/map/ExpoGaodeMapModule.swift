@@ -511,6 +511,42 @@ public class ExpoGaodeMapModule: Module {
                 ]
             }
         }
+
+        /**
+         * 沿路径按距离等距取点
+         * @param count 点数（含首尾）
+         */
+        Function("resamplePolylineByCount") { (points: [[String: Double]]?, count: Int) -> [[String: Double]] in
+            let coords = LatLngParser.parseLatLngList(points)
+            let resampled = GeometryUtils.resamplePolylineByCount(coords, count: count)
+            return resampled.map {
+                [
+                    "latitude": $0.latitude,
+                    "longitude": $0.longitude
+                ]
+            }
+        }
+
+        /**
+         * 比较候选路线与参考路线（如 Web 规划线）的相似程度
+         * @param thresholdMeters 统计超限顶点数的距离阈值(米)
+         */
+        Function("comparePaths") { (reference: [[String: Double]]?, points: [[String: Double]]?, thresholdMeters: Double) -> [String: Any]? in
+            let referenceCoords = LatLngParser.parseLatLngList(reference)
+            let coords = LatLngParser.parseLatLngList(points)
+            if referenceCoords.isEmpty || coords.isEmpty {
+                return nil
+            }
+            
+            let result = ClusterNative.comparePaths(
+                referenceLatitudes: referenceCoords.map { NSNumber(value: $0.latitude) },
+                referenceLongitudes: referenceCoords.map { NSNumber(value: $0.longitude) },
+                latitudes: coords.map { NSNumber(value: $0.latitude) },
+                longitudes: coords.map { NSNumber(value: $0.longitude) },
+                thresholdMeters: thresholdMeters
+            )
+            return result.isEmpty ? nil : result as? [String: Any]
+        }
         
         /**
          * 计算路径总长度
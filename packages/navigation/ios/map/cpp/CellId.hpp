@@ -0,0 +1,198 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "GeometryEngine.hpp"
+
+namespace gaodemap {
+
+/**
+ * 64 位整数网格编码（Web Mercator 四叉树 + Morton 序）
+ * 第 level 级网格与 zoom = level 的瓦片一一对应，level 最大为 30（赤道处约 3.7 cm）
+ *
+ * 编码方式与 S2 CellId 相同：瓦片下标按位交错 (Morton) 后左移一位并追加一个标记位，再左移 2 * (30 - level) 位
+ * - 按 id 排序即为 Morton 序，空间相邻的点大多相邻存放
+ * - 一个网格的全部子孙 id 落在连续区间 [rangeMin, rangeMax] 内，可直接在有序数组上二分做范围扫描
+ * - 级别由末尾 0 的个数决定，父 / 子网格只需位运算
+ *
+ * 位运算部分均为 constexpr；经纬度换算与区域覆盖见 CellId.cpp
+ */
+class CellId {
+public:
+    static constexpr int kMaxLevel = 30;
+
+    constexpr CellId() : value(0) {}
+    constexpr explicit CellId(uint64_t id) : value(id) {}
+
+    /**
+     * 由瓦片坐标构造
+     * @return 下标越界或 level 非法时返回无效网格
+     */
+    static constexpr CellId fromTile(uint32_t x, uint32_t y, int level) {
+        if (level < 0 || level > kMaxLevel) return CellId();
+        if (x >= (uint64_t(1) << level) || y >= (uint64_t(1) << level)) return CellId();
+        const uint64_t position = spreadBits(x) | (spreadBits(y) << 1);
+        return CellId(((position << 1) | 1) << (2 * (kMaxLevel - level)));
+    }
+
+    /**
+     * 由经纬度构造（Web Mercator，纬度截断到 ±85.05112878°，经度按 360° 回绕）
+     */
+    static CellId fromLatLng(double lat, double lon, int level = kMaxLevel);
+
+    constexpr uint64_t id() const { return value; }
+
+    constexpr bool isValid() const {
+        return value != 0 && (value >> (2 * kMaxLevel + 1)) == 0 && (trailingZeros(value) & 1) == 0;
+    }
+
+    constexpr int level() const { return kMaxLevel - trailingZeros(value) / 2; }
+    constexpr bool isLeaf() const { return (value & 1) != 0; }
+
+    // 本级别标记位
+    constexpr uint64_t lowestOnBit() const { return value & (~value + 1); }
+
+    constexpr uint32_t tileX() const { return compactBits(value >> (trailingZeros(value) + 1)); }
+    constexpr uint32_t tileY() const { return compactBits(value >> (trailingZeros(value) + 2)); }
+
+    constexpr CellId parent() const {
+        const uint64_t lsb = lowestOnBit() << 2;
+        return CellId((value & (~lsb + 1)) | lsb);
+    }
+
+    /**
+     * 指定级别的祖先网格，level 不小于当前级别时返回自身
+     */
+    constexpr CellId parent(int ancestorLevel) const {
+        if (ancestorLevel >= level()) return *this;
+        if (ancestorLevel < 0) ancestorLevel = 0;
+        const uint64_t lsb = uint64_t(1) << (2 * (kMaxLevel - ancestorLevel));
+        return CellId((value & (~lsb + 1)) | lsb);
+    }
+
+    /**
+     * 子网格，position 为 (y 位 << 1) | x 位，即 0 西北、1 东北、2 西南、3 东南
+     * 叶子网格没有子网格，返回无效网格
+     */
+    constexpr CellId child(int position) const {
+        if (isLeaf()) return CellId();
+        const uint64_t lsb = lowestOnBit();
+        return CellId(value - lsb + (lsb >> 2) + static_cast<uint64_t>(position & 3) * (lsb >> 1));
+    }
+
+    constexpr CellId childBegin() const { return child(0); }
+    constexpr CellId childEnd() const { return child(3); }
+
+    // 子孙叶子网格 id 的闭区间
+    constexpr uint64_t rangeMin() const { return value - (lowestOnBit() - 1); }
+    constexpr uint64_t rangeMax() const { return value + (lowestOnBit() - 1); }
+
+    constexpr bool contains(CellId other) const {
+        return other.value >= rangeMin() && other.value <= rangeMax();
+    }
+
+    constexpr bool intersects(CellId other) const {
+        return other.rangeMin() <= rangeMax() && other.rangeMax() >= rangeMin();
+    }
+
+    /**
+     * 同级相邻网格，经度方向跨 180° 经线回绕，纬度方向越界时返回无效网格
+     * @param dx 向东偏移的网格数
+     * @param dy 向南偏移的网格数（与瓦片 y 方向一致）
+     */
+    constexpr CellId neighbor(int dx, int dy) const {
+        const int lv = level();
+        const int64_t size = int64_t(1) << lv;
+        const int64_t y = static_cast<int64_t>(tileY()) + dy;
+        if (y < 0 || y >= size) return CellId();
+        const int64_t x = (static_cast<int64_t>(tileX()) + dx) & (size - 1);
+        return fromTile(static_cast<uint32_t>(x), static_cast<uint32_t>(y), lv);
+    }
+
+    /**
+     * 网格的经纬度范围，center 为 Mercator 平面上的网格中心
+     */
+    PathBounds bounds() const;
+
+    constexpr bool operator==(CellId other) const { return value == other.value; }
+    constexpr bool operator!=(CellId other) const { return value != other.value; }
+    constexpr bool operator<(CellId other) const { return value < other.value; }
+
+    // 把低 32 位分散到偶数位：abcd -> 0a0b0c0d
+    static constexpr uint64_t spreadBits(uint32_t bits) {
+        uint64_t x = bits;
+        x = (x | (x << 16)) & 0x0000FFFF0000FFFFULL;
+        x = (x | (x << 8)) & 0x00FF00FF00FF00FFULL;
+        x = (x | (x << 4)) & 0x0F0F0F0F0F0F0F0FULL;
+        x = (x | (x << 2)) & 0x3333333333333333ULL;
+        x = (x | (x << 1)) & 0x5555555555555555ULL;
+        return x;
+    }
+
+    // spreadBits 的逆运算：取出偶数位
+    static constexpr uint32_t compactBits(uint64_t bits) {
+        uint64_t x = bits & 0x5555555555555555ULL;
+        x = (x | (x >> 1)) & 0x3333333333333333ULL;
+        x = (x | (x >> 2)) & 0x0F0F0F0F0F0F0F0FULL;
+        x = (x | (x >> 4)) & 0x00FF00FF00FF00FFULL;
+        x = (x | (x >> 8)) & 0x0000FFFF0000FFFFULL;
+        x = (x | (x >> 16)) & 0x00000000FFFFFFFFULL;
+        return static_cast<uint32_t>(x);
+    }
+
+    // 末尾 0 的个数（De Bruijn 乘法，编译期可用），0 返回 64
+    static constexpr int trailingZeros(uint64_t bits) {
+        constexpr uint8_t kTable[64] = {
+            0, 1, 48, 2, 57, 49, 28, 3, 61, 58, 50, 42, 38, 29, 17, 4,
+            62, 55, 59, 36, 53, 51, 43, 22, 45, 39, 33, 30, 24, 18, 12, 5,
+            63, 47, 56, 27, 60, 41, 37, 16, 54, 35, 52, 21, 44, 32, 23, 11,
+            46, 26, 40, 15, 34, 20, 31, 10, 25, 14, 19, 9, 13, 8, 7, 6
+        };
+        return bits == 0 ? 64 : kTable[((bits & (~bits + 1)) * 0x03F79D71B4CB0A89ULL) >> 58];
+    }
+
+private:
+    uint64_t value;
+};
+
+// 覆盖结果对应的叶子 id 闭区间
+struct CellIdRange {
+    uint64_t min;
+    uint64_t max;
+};
+
+/**
+ * 用至多 maxCells 个网格覆盖经纬度矩形
+ * 从第 0 级开始逐级细分与矩形相交的网格，完全落在矩形内或到达 maxLevel 的网格不再细分，
+ * 细分会超出 maxCells 时保留当前网格；结果保证覆盖整个矩形（会略大于矩形）
+ * west > east 时视为跨 180° 经线的矩形
+ * @return 按 id 升序、互不包含的网格
+ */
+std::vector<CellId> coverBoundsWithCells(
+    double south,
+    double west,
+    double north,
+    double east,
+    int maxLevel,
+    size_t maxCells = 16
+);
+
+/**
+ * 用至多 maxCells 个网格覆盖圆形区域，规则同 coverBoundsWithCells
+ * @param radiusMeters 半径（米，球面距离）
+ */
+std::vector<CellId> coverCircleWithCells(
+    double centerLat,
+    double centerLon,
+    double radiusMeters,
+    int maxLevel,
+    size_t maxCells = 16
+);
+
+/**
+ * 把覆盖结果转换为合并后的叶子 id 区间，用于在按 CellId 排序的数据上做范围扫描
+ */
+std::vector<CellIdRange> cellIdRanges(const std::vector<CellId>& cells);
+
+}
@@ -1,8 +1,12 @@
 #pragma once
 
+#include <cstddef>
+#include <cstdint>
 #include <vector>
 #include <string>
 
+#include "ClusterTypes.hpp"
+
 namespace gaodemap {
 
 struct GeoPoint {
@@ -10,10 +14,60 @@ struct GeoPoint {
     double lon;
 };
 
+/**
+ * 坐标只读视图 (Structure of Arrays)，不持有数据
+ * 第 i 个点为 (lat[i * stride], lon[i * stride])：
+ * - 纬度、经度来自两个独立数组（如 JNI 的 double[]）时 stride = 1
+ * - 直接查看 GeoPoint 数组时 stride = 2
+ * 平台层可直接把原生缓冲区传入几何函数，无需先拼装 std::vector<GeoPoint>
+ */
+struct CoordSpan {
+    const double* lat = nullptr;
+    const double* lon = nullptr;
+    size_t count = 0;
+    size_t stride = 1;
+
+    CoordSpan() = default;
+    explicit CoordSpan(const double* latitudes, const double* longitudes, size_t n, size_t elementStride = 1)
+        : lat(latitudes), lon(longitudes), count(n), stride(elementStride) {}
+    explicit CoordSpan(const std::vector<GeoPoint>& points)
+        : lat(points.empty() ? nullptr : &points[0].lat),
+          lon(points.empty() ? nullptr : &points[0].lon),
+          count(points.size()),
+          stride(sizeof(GeoPoint) / sizeof(double)) {}
+
+    size_t size() const { return count; }
+    bool empty() const { return count == 0; }
+    double latAt(size_t i) const { return lat[i * stride]; }
+    double lonAt(size_t i) const { return lon[i * stride]; }
+    GeoPoint operator[](size_t i) const { return {lat[i * stride], lon[i * stride]}; }
+    GeoPoint front() const { return (*this)[0]; }
+    GeoPoint back() const { return (*this)[count - 1]; }
+    CoordSpan subspan(size_t offset, size_t n) const {
+        return CoordSpan(lat + offset * stride, lon + offset * stride, n, stride);
+    }
+};
+
+static_assert(sizeof(GeoPoint) == sizeof(double) * 2, "GeoPoint must be two packed doubles for CoordSpan stride");
+
+/**
+ * 距离 / 面积使用的地球模型，由调用方逐次传入，未传入的重载一律使用 Sphere
+ * - Sphere: 半径 6371000 m 的球面（Haversine），默认
+ * - WGS84: WGS-84 椭球，距离为测地线长度（Vincenty），面积在等面积（authalic）纬度下计算
+ */
+enum class EarthModel : uint8_t {
+    Sphere = 0,
+    WGS84 = 1
+};
+
 double calculateDistance(double lat1, double lon1, double lat2, double lon2);
+double calculateDistance(double lat1, double lon1, double lat2, double lon2, EarthModel model);
 bool isPointInCircle(double pointLat, double pointLon, double centerLat, double centerLon, double radiusMeters);
 bool isPointInPolygon(double pointLat, double pointLon, const std::vector<GeoPoint>& polygon);
+bool isPointInPolygon(double pointLat, double pointLon, const CoordSpan& polygon);
 double calculatePolygonArea(const std::vector<GeoPoint>& polygon);
+double calculatePolygonArea(const CoordSpan& polygon);
+double calculatePolygonArea(const CoordSpan& polygon, EarthModel model);
 double calculateRectangleArea(double swLat, double swLon, double neLat, double neLon);
 
 /**
@@ -23,11 +77,14 @@ double calculateRectangleArea(double swLat, double swLon, double neLat, double n
  * @return 简化后的轨迹点
  */
 std::vector<GeoPoint> simplifyPolyline(const std::vector<GeoPoint>& points, double toleranceMeters);
+std::vector<GeoPoint> simplifyPolyline(const CoordSpan& points, double toleranceMeters);
 
 /**
  * 计算路径总长度（米）
  */
 double calculatePathLength(const std::vector<GeoPoint>& points);
+double calculatePathLength(const CoordSpan& points);
+double calculatePathLength(const CoordSpan& points, EarthModel model);
 
 /**
  * 获取路径上指定距离的点和方向
@@ -39,6 +96,28 @@ double calculatePathLength(const std::vector<GeoPoint>& points);
  * @return 是否成功找到点
  */
 bool getPointAtDistance(const std::vector<GeoPoint>& points, double distanceMeters, double* outLat, double* outLon, double* outAngle);
+bool getPointAtDistance(const CoordSpan& points, double distanceMeters, double* outLat, double* outLon, double* outAngle);
+
+/**
+ * 按间距重采样折线：累积距离只计算一次，单趟遍历线性插值输出
+ * 总长按最接近 spacingMeters 的间距均分，首尾点总是保留；总长为 0 时只返回首点
+ * @param spacingMeters <= 0 时原样返回
+ */
+std::vector<GeoPoint> resamplePolyline(const std::vector<GeoPoint>& points, double spacingMeters);
+std::vector<GeoPoint> resamplePolyline(const CoordSpan& points, double spacingMeters);
+
+/**
+ * 沿折线等距取 count 个点（含首尾）
+ */
+std::vector<GeoPoint> resamplePolylineByCount(const std::vector<GeoPoint>& points, size_t count);
+std::vector<GeoPoint> resamplePolylineByCount(const CoordSpan& points, size_t count);
+
+/**
+ * 保留转角的重采样：航向变化超过 cornerAngleDegrees 的顶点原样保留，相邻转角之间各自按间距均分
+ * 适合生成途经点锚点，避免等距采样把路口切掉
+ */
+std::vector<GeoPoint> resamplePolylinePreservingCorners(const std::vector<GeoPoint>& points, double spacingMeters, double cornerAngleDegrees = 30.0);
+std::vector<GeoPoint> resamplePolylinePreservingCorners(const CoordSpan& points, double spacingMeters, double cornerAngleDegrees = 30.0);
 
 // Result structure for nearest point calculation
 struct NearestPointResult {
@@ -51,6 +130,7 @@ struct NearestPointResult {
 // Find the nearest point on the path to a target point
 // Returns the nearest point on the polyline segments
 NearestPointResult getNearestPointOnPath(const std::vector<GeoPoint>& path, const GeoPoint& target);
+NearestPointResult getNearestPointOnPath(const CoordSpan& path, const GeoPoint& target);
 
 /**
  * 计算多边形的质心
@@ -58,6 +138,16 @@ NearestPointResult getNearestPointOnPath(const std::vector<GeoPoint>& path, cons
  * @return 质心坐标
  */
 GeoPoint calculateCentroid(const std::vector<GeoPoint>& polygon);
+GeoPoint calculateCentroid(const CoordSpan& polygon);
+
+struct PathBounds {
+    double north;
+    double south;
+    double east;
+    double west;
+    double centerLat;
+    double centerLon;
+};
 
 /**
  * GeoHash 编码
@@ -68,6 +158,74 @@ GeoPoint calculateCentroid(const std::vector<GeoPoint>& polygon);
  */
 std::string encodeGeoHash(double lat, double lon, int precision);
 
+/**
+ * 批量 GeoHash 编码，结果按定长连续写入调用方缓冲区（无分隔符与结束符）
+ * 第 i 个点的编码位于 out[i * precision, (i + 1) * precision)
+ * @param points 坐标点
+ * @param precision 精度 (1-12)，超出范围会被截断
+ * @param out 输出缓冲区，至少 points.size() * 截断后的精度 字节
+ * @return 实际使用的精度（即每个编码的宽度）
+ */
+int encodeGeoHashes(const CoordSpan& points, int precision, char* out);
+int encodeGeoHashes(const std::vector<GeoPoint>& points, int precision, char* out);
+
+/**
+ * GeoHash 解码为对应的网格范围
+ * 大小写均可，长度需为 1-12
+ * @param hash GeoHash
+ * @param out 网格范围，center 为网格中心
+ * @return 编码非法时返回 false，out 不变
+ */
+bool decodeGeoHash(const std::string& hash, PathBounds& out);
+bool decodeGeoHash(const char* hash, size_t length, PathBounds& out);
+
+/**
+ * 批量解码定长 GeoHash（encodeGeoHashes 的输出格式）
+ * @param hashes 连续存放的编码
+ * @param count 编码个数
+ * @param width 每个编码的长度 (1-12)
+ * @param out 输出，至少 count 项；非法编码对应项的各字段为 NaN
+ * @return 成功解码的个数
+ */
+size_t decodeGeoHashes(const char* hashes, size_t count, int width, PathBounds* out);
+
+/**
+ * 相邻 GeoHash（同精度）
+ * 经度方向跨 180° 经线时回绕，纬度方向超出南北极时没有相邻网格
+ * @param hash GeoHash
+ * @param latSteps 纬度方向偏移的网格数（向北为正）
+ * @param lonSteps 经度方向偏移的网格数（向东为正）
+ * @return 相邻网格的 GeoHash，不存在或输入非法时返回空字符串
+ */
+std::string getGeoHashNeighbor(const std::string& hash, int latSteps, int lonSteps);
+
+/**
+ * 8 个相邻 GeoHash，顺序为 北、东北、东、东南、南、西南、西、西北
+ * 南北极方向不存在的相邻网格为空字符串；输入非法时返回空数组
+ */
+std::vector<std::string> getGeoHashNeighbors(const std::string& hash);
+
+/**
+ * 用指定精度的 GeoHash 覆盖经纬度矩形
+ * west > east 且两者都在 [-180, 180] 内时视为跨 180° 经线的矩形；
+ * south > north 或超出该范围的 west > east 视为空矩形，返回空数组
+ * @param south 南边界
+ * @param west 西边界
+ * @param north 北边界
+ * @param east 东边界
+ * @param precision 精度 (1-12)
+ * @param maxCells 最多返回的网格数，超出时返回空数组（应改用更低的精度）
+ * @return 与矩形相交的全部 GeoHash，按由南到北、由西到东排列
+ */
+std::vector<std::string> coverBoundsWithGeoHashes(
+    double south,
+    double west,
+    double north,
+    double east,
+    int precision,
+    size_t maxCells = 4096
+);
+
 /**
  * 解析高德地图 API 返回的 Polyline 字符串
  * 格式: "lng,lat;lng,lat;..."
@@ -76,21 +234,90 @@ std::string encodeGeoHash(double lat, double lon, int precision);
  */
 std::vector<GeoPoint> parsePolyline(const std::string& polylineStr);
 
-struct PathBounds {
-    double north;
-    double south;
-    double east;
-    double west;
-    double centerLat;
-    double centerLon;
+struct PolylineRings {
+    std::vector<GeoPoint> points;  // 所有环的坐标，按环顺序连续存放
+    std::vector<int> ringOffsets;  // 每个环在 points 中的起始下标，末尾额外追加 points.size()
 };
 
+/**
+ * 解析高德多环 / 多段 Polyline 字符串（行政区边界、AOI、分步路线等）
+ * 格式: "lng,lat;lng,lat|lng,lat;..."，`|` 分隔环，`;` 分隔坐标点
+ * 一次遍历完成拆环、解析与相邻重复点去除，空环会被丢弃
+ * @param polylineStr 高德原始 polyline 字符串
+ * @param dedupeAdjacent 是否去除环内相邻的重复点
+ * @return 扁平坐标缓冲区与环偏移，环 i 的点为 [ringOffsets[i], ringOffsets[i + 1])
+ */
+PolylineRings parsePolylineRings(const std::string& polylineStr, bool dedupeAdjacent = true);
+
+/**
+ * 将路径编码为紧凑字符串（Google Encoded Polyline 格式：差分 + zigzag + 5 位变长分组）
+ * 适合在本地缓存路线 / 行政区边界，或在 JS 与原生之间传输大体量路径
+ * @param points 路径点
+ * @param precision 小数精度位数 (1-9)，5 约为 1 米，6 约为 0.1 米
+ * @return 编码后的 ASCII 字符串；坐标为 NaN / ±∞ 的点被跳过
+ */
+std::string encodePolyline(const std::vector<GeoPoint>& points, int precision = 5);
+std::string encodePolyline(const CoordSpan& points, int precision = 5);
+
+/**
+ * 解码 encodePolyline 生成的字符串
+ * 遇到非法字符、被截断的数据或超出编码范围的坐标时停止，返回已成功解码的点
+ * @param encoded 编码字符串
+ * @param precision 编码时使用的精度位数
+ * @return 路径点
+ */
+std::vector<GeoPoint> decodePolyline(const std::string& encoded, int precision = 5);
+
 /**
  * 计算路径的边界和中心点
  * @param points 路径点
  * @return 边界信息
  */
 PathBounds calculatePathBounds(const std::vector<GeoPoint>& points);
+PathBounds calculatePathBounds(const CoordSpan& points);
+
+// --- 批量距离 ---
+
+/**
+ * 批量计算逐对距离：out[i] 为 from[i] 到 to[i] 的距离（米）
+ * WGS84 模型下每个点的归化纬度只计算一次，近对跖点 Vincenty 不收敛时改用 Geodesic（Karney）反解
+ * @param out 输出，至少 min(from.size(), to.size()) 项；含非有限坐标的项为 NaN
+ */
+void calculateDistances(const CoordSpan& from, const CoordSpan& to, double* out, EarthModel model);
+
+/**
+ * 批量计算一个点到多个点的距离：out[i] 为 (lat, lon) 到 points[i] 的距离（米）
+ */
+void calculateDistancesFrom(double lat, double lon, const CoordSpan& points, double* out, EarthModel model);
+
+// --- 坐标系转换 ---
+// 高德使用 GCJ-02，GPS 与多数后端为 WGS-84，百度为 BD-09（在 GCJ-02 上再加偏移）
+// 中国境外（粗略矩形判断）GCJ-02 与 WGS-84 相同
+
+enum class CoordSystem : uint8_t {
+    WGS84 = 0,
+    GCJ02 = 1,
+    BD09 = 2
+};
+
+/**
+ * 是否在 GCJ-02 加偏范围之外（与常用实现相同的矩形判断）
+ */
+bool isOutOfChina(double lat, double lon);
+
+/**
+ * 单点坐标系转换
+ * 逆变换（GCJ-02 -> WGS-84、BD-09 -> GCJ-02）没有解析解，以正变换做不动点迭代，残差小于 1e-9°（约 0.1 mm）
+ */
+GeoPoint convertCoordinate(double lat, double lon, CoordSystem from, CoordSystem to);
+
+/**
+ * 批量原地转换坐标系，结果与 convertCoordinate 逐点一致
+ * GCJ-02 偏移中的 14 个三角函数由经度、纬度各一次 sincos 经倍角公式得到，循环内不分支，便于编译器展开
+ * @param lat / lon 坐标缓冲区，按 stride 访问（与 CoordSpan 相同），结果写回；非有限坐标保持原值
+ */
+void convertCoordinates(double* lat, double* lon, size_t count, CoordSystem from, CoordSystem to, size_t stride = 1);
+void convertCoordinates(std::vector<GeoPoint>& points, CoordSystem from, CoordSystem to);
 
 // --- 瓦片与坐标转换 ---
 
@@ -125,6 +352,77 @@ PixelResult latLngToPixel(double lat, double lon, int zoom);
  */
 GeoPoint pixelToLatLng(double x, double y, int zoom);
 
+// --- 批量投影 ---
+// 缩放比例 2^z 查表获得，Mercator y 使用 atanh(sin φ) 形式（一次 sin + log1p），x / y 分两趟处理便于编译器向量化
+
+/**
+ * 批量经纬度转世界像素坐标，结果与 latLngToPixel 一致（256 像素瓦片）
+ * @param points 坐标点
+ * @param zoom 缩放级别，可为小数
+ * @param outX / outY 输出缓冲区，至少 points.size() 项
+ */
+void latLngToPixels(const CoordSpan& points, double zoom, double* outX, double* outY);
+
+/**
+ * 批量世界像素坐标转经纬度，结果与 pixelToLatLng 一致
+ * @param outLat / outLon 输出缓冲区，至少 count 项
+ */
+void pixelsToLatLngs(const double* xs, const double* ys, size_t count, double zoom, double* outLat, double* outLon);
+
+/**
+ * 批量经纬度转瓦片坐标
+ * 合法输入的结果与 latLngToTile 一致；经度按 360° 回绕，纬度超出 Mercator 范围或下标越界时截断到 [0, 2^zoom - 1]
+ * @param outX / outY 输出缓冲区，至少 points.size() 项
+ */
+void latLngToTiles(const CoordSpan& points, int zoom, int* outX, int* outY);
+
+// 屏幕视口（不含旋转与倾斜），坐标以视口左上角为原点
+struct ScreenViewport {
+    double originX;      // 视口左上角的世界像素坐标
+    double originY;
+    double zoom;         // 缩放级别，可为小数
+    double width;        // 视口宽度（像素）
+    double height;       // 视口高度（像素）
+    double margin;       // 可见性判断时四周外扩的像素
+};
+
+/**
+ * 以地图中心构造视口
+ */
+ScreenViewport makeScreenViewport(double centerLat, double centerLon, double zoom, double width, double height, double margin = 0.0);
+
+/**
+ * 批量投影到屏幕坐标（float），用于碰撞检测与标注排布
+ * 先在 double 下减去视口原点再转为 float，高缩放级别下也不会丢失精度；
+ * 经度方向取离视口中心最近的世界副本，跨 180° 经线时坐标连续
+ * @param outX / outY 屏幕坐标，至少 points.size() 项；坐标非法时为 NaN
+ * @param outVisible 可选（可为 nullptr），落在视口（含 margin）内时为 1，否则为 0
+ * @return 可见点的数量
+ */
+size_t projectToScreen(const CoordSpan& points, const ScreenViewport& viewport, float* outX, float* outY, uint8_t* outVisible);
+
+// --- 视口裁剪 ---
+// 覆盖物在相机变化后只把视口附近的部分交给地图 SDK，减少每帧需要三角化 / 描边的顶点
+// 在当前缩放级别的屏幕像素坐标中计算，经度相对上一个点展开，跨 180° 经线时保持连续：
+// 1. 去掉与上一个保留点距离小于 tolerancePx 的点
+// 2. 裁剪到视口四周外扩 margin 像素的矩形
+// 3. 再以 tolerancePx 做 Douglas-Peucker 抽稀，容差按像素计，缩放级别越低抽稀越多
+// 保留下来的原始顶点原样输出，只有与裁剪矩形的交点是新计算的
+
+/**
+ * 折线裁剪（Cohen-Sutherland 逐段裁剪），离开视口处断开
+ * @param tolerancePx 抽稀容差（像素），<= 0 时不抽稀
+ * @return 各段折线，格式同 parsePolylineRings；完全不可见时没有任何段
+ */
+PolylineRings clipPolylineToViewport(const CoordSpan& points, const ScreenViewport& viewport, double tolerancePx = 0.5);
+
+/**
+ * 多边形单个环的裁剪（Sutherland-Hodgman 依次对四条边裁剪），带洞的多边形对每个环分别调用
+ * 结果沿裁剪矩形的边界闭合，环包含整个视口时得到矩形本身；margin 应大于描边宽度，使这些边落在屏幕外
+ * @return 裁剪后的环，不足 3 个点（完全不可见）时为空
+ */
+std::vector<GeoPoint> clipPolygonToViewport(const CoordSpan& ring, const ScreenViewport& viewport, double tolerancePx = 0.5);
+
 /**
  * 根据一组坐标点和视口尺寸计算“可同时看到所有点”的推荐缩放级别。
  * 使用 Web Mercator 投影，在跨经线场景下会自动取更小经度跨度。
@@ -145,6 +443,95 @@ double calculateFitZoomForPoints(
     int minZoom,
     int maxZoom
 );
+double calculateFitZoomForPoints(
+    const CoordSpan& points,
+    double viewportWidthPx,
+    double viewportHeightPx,
+    double paddingPx,
+    int minZoom,
+    int maxZoom
+);
+
+/**
+ * 流式边界累加器，可分块输入坐标，O(n) 计算跨经线的边界与推荐缩放级别
+ * 经度按固定数量的桶记录每桶最小 / 最大值，最大经度空隙只会出现在相邻非空桶之间：
+ * - 点数不超过 kLonBuckets 时与排序求最大空隙的结果一致
+ * - 点数更多且几乎布满全部经度时，空隙误差小于一个桶宽 (360° / kLonBuckets)，得到的跨度只会偏大
+ * 非有限值的点被忽略
+ */
+class BoundsAccumulator {
+public:
+    static constexpr int kLonBuckets = 1024;
+
+    BoundsAccumulator() { reset(); }
+
+    void reset();
+    void add(double lat, double lon);
+    void add(const CoordSpan& points);
+    // 合并另一个累加器（如多线程分块计算后汇总）
+    void merge(const BoundsAccumulator& other);
+
+    // 已累加的有效点数
+    size_t count() const { return validCount; }
+
+    /**
+     * 跨经线感知的边界：取覆盖全部点的最短经度区间
+     * 不跨 180° 经线时与 calculatePathBounds 结果相同；跨经线时 west > east，centerLon 归一化到 [-180, 180)
+     * 没有有效点时返回值与 calculatePathBounds 空输入相同
+     */
+    PathBounds bounds() const;
+
+    /**
+     * 推荐缩放级别，参数与 calculateFitZoomForPoints 相同
+     */
+    double fitZoom(double viewportWidthPx, double viewportHeightPx, double paddingPx, int minZoom, int maxZoom) const;
+
+private:
+    // 最大经度空隙（度），gapStart / gapEnd 为空隙两端的经度（[0, 360) 表示）
+    double largestLonGap(double& gapStart, double& gapEnd) const;
+
+    size_t validCount;
+    double minLat;
+    double maxLat;
+    double minLon;
+    double maxLon;
+    double bucketMin[kLonBuckets];  // 桶内经度 + 180 的最小 / 最大值，空桶为 +inf / -inf
+    double bucketMax[kLonBuckets];
+};
+
+/**
+ * 跨经线感知的路径边界，一次遍历，不排序
+ * 规则见 BoundsAccumulator::bounds
+ */
+PathBounds calculateWrappedPathBounds(const std::vector<GeoPoint>& points);
+PathBounds calculateWrappedPathBounds(const CoordSpan& points);
+
+// --- 凸包 / 凹包 ---
+// 在以点集中心纬度为准的局部等距投影（米）中计算，经度相对第一个点展开，跨 180° 经线的点集也能得到连续的轮廓
+// 输出的顶点都是输入点（原样输出），环逆时针（经度向东、纬度向北），首尾不重复，已去掉重复点与共线点
+
+/**
+ * 凸包（Andrew 单调链，O(n log n)）
+ * @return 凸包顶点；所有点重合时只有 1 个点，共线时为两个端点
+ */
+std::vector<GeoPoint> computeConvexHull(const CoordSpan& points);
+std::vector<GeoPoint> computeConvexHull(const std::vector<GeoPoint>& points);
+
+/**
+ * 凹包（χ-shape）：对点集做 Delaunay 三角剖分，从外向内依次去掉最长的边界边所在的三角形，
+ * 直到边界边都不长于 maxEdgeMeters；去掉三角形会使其第三个顶点已在边界上时跳过，保证结果是简单多边形且包含所有点
+ * @param maxEdgeMeters 边界边的长度上限，<= 0 时等价于凸包；聚合场景取聚合半径左右即可
+ */
+std::vector<GeoPoint> computeConcaveHull(const CoordSpan& points, double maxEdgeMeters);
+std::vector<GeoPoint> computeConcaveHull(const std::vector<GeoPoint>& points, double maxEdgeMeters);
+
+/**
+ * 批量计算聚合簇的外轮廓，直接使用 clusterPoints 的结果，内部缓冲区在各簇之间复用
+ * @param points 参与聚合的坐标，ClusterOutput::indices 为其中的下标（即平台层传入 clusterPoints 的顺序），越界的下标被忽略
+ * @param maxEdgeMeters > 0 时计算凹包，否则为凸包
+ * @return 每个簇一个环，顺序与 clusters 相同，格式同 parsePolylineRings；只有 1 个点或共线的簇，环中只有 1~2 个点
+ */
+PolylineRings computeClusterHulls(const CoordSpan& points, const std::vector<ClusterOutput>& clusters, double maxEdgeMeters = 0.0);
 
 // --- 批量地理围栏与热力图 ---
 
@@ -156,6 +543,19 @@ double calculateFitZoomForPoints(
  * @return 所在的第一个多边形的索引，若不在任何多边形内返回 -1
  */
 int findPointInPolygons(double pointLat, double pointLon, const std::vector<std::vector<GeoPoint>>& polygons);
+int findPointInPolygons(double pointLat, double pointLon, const std::vector<CoordSpan>& polygons);
+
+/**
+ * 批量判断多个点是否在同一个多边形（围栏）内，规则与 isPointInPolygon 相同（奇偶规则）
+ * 围栏只预处理一次：边按经度分带，每个点先做包围盒预筛，再只检查所在分带的边，
+ * 带内的边以 SSE2 / NEON 每次判断两条（其他平台逐条判断）
+ * 与 isPointInPolygon 只在点距边界不超过浮点舍入误差时可能不同
+ * @param ringOffsets 每个环的起始下标，末尾额外追加 polygon.size()；为空时整个 polygon 作为一个环，多个环时洞内的点不算在内
+ * @param outBits 位图，第 i 个点对应 outBits[i / 64] 的第 i % 64 位，至少 (points.size() + 63) / 64 项
+ * @return 在多边形内的点数
+ */
+size_t pointsInPolygon(const CoordSpan& polygon, const CoordSpan& points, uint64_t* outBits);
+size_t pointsInPolygon(const CoordSpan& polygon, const std::vector<int>& ringOffsets, const CoordSpan& points, uint64_t* outBits);
 
 struct HeatmapPoint {
     double lat;
@@ -171,10 +571,12 @@ struct HeatmapGridCell {
 
 /**
  * 生成热力图网格数据
+ * 网格范围较小时使用稠密数组累加，否则使用开放寻址哈希表；多线程模式下每个线程累加私有网格后按顺序合并
  * @param points 原始点集
  * @param gridSizeMeters 网格大小（米）
- * @return 网格中心点及其强度
+ * @param threadCount 线程数，1 为单线程，<= 0 为按 CPU 核数自动选择（点数较少时始终单线程）
+ * @return 网格中心点及其强度，按 (纬度格, 经度格) 升序排列
  */
-std::vector<HeatmapGridCell> generateHeatmapGrid(const std::vector<HeatmapPoint>& points, double gridSizeMeters);
+std::vector<HeatmapGridCell> generateHeatmapGrid(const std::vector<HeatmapPoint>& points, double gridSizeMeters, int threadCount = 1);
 
 } // namespace gaodemap
@@ -0,0 +1,117 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "GeometryEngine.hpp"
+
+namespace gaodemap {
+
+// 平滑结果标记，可按位组合
+enum GpsSmootherFlags : uint8_t {
+    kGpsSmootherRejected = 1,   // 定位点被门限剔除（或时间倒退、坐标非法），输出为预测位置
+    kGpsSmootherReset = 2,      // 滤波器在该定位点重新初始化（首个点、长时间未更新或连续剔除后重新定位）
+    kGpsSmootherInvalid = 4     // 槽位无效或未分配，输出为 NaN
+};
+
+struct GpsSmootherOptions {
+    double accelerationNoise = 2.0;      // 过程噪声：加速度标准差 (m/s²)，越大越跟手、越小越平滑
+    double defaultAccuracyMeters = 10.0; // 未提供精度或精度无效时使用的定位误差 (1σ)
+    double minGateMeters = 25.0;         // 门限下限：新息（定位点与预测位置的距离）不超过该值时总是接受
+    double gateScale = 4.0;              // 新息超过最近新息中值的该倍数时视为跳点
+    int medianWindow = 5;                // 中值窗口（最近接受的新息个数），1 ~ kGpsSmootherMaxWindow
+    int maxRejected = 3;                 // 连续剔除达到该次数时认为是真实位移，在新位置重新初始化
+    double resetAfterSeconds = 60.0;     // 超过该间隔未更新时重新初始化
+};
+
+struct SmoothedFix {
+    double lat;
+    double lon;
+    double speedMps;
+    double headingDegrees;   // 正北为 0、顺时针 [0, 360)；速度过低时沿用上一个航向，从未运动时为 NaN
+    uint8_t flags;           // GpsSmootherFlags
+};
+
+constexpr int kGpsSmootherMaxWindow = 9;
+
+/**
+ * GPS 平滑器对象池：每个槽位是一辆车的匀速模型卡尔曼滤波器，加上基于新息中值的跳点门限
+ *
+ * 每个槽位在以首个定位点为原点的局部平面（米）上滤波，东 / 北两个方向共用同一个协方差矩阵
+ * （定位误差各向同性），车辆离原点较远时自动平移原点；
+ * 全部槽位在构造时一次分配，acquire / release / update 都不分配内存，适合每帧一次批量更新数千辆车
+ * 非线程安全
+ */
+class GpsSmootherPool {
+public:
+    explicit GpsSmootherPool(size_t capacity, const GpsSmootherOptions& options = GpsSmootherOptions());
+
+    /**
+     * 分配一个槽位
+     * @return 槽位号，池已满时返回 -1
+     */
+    int acquire();
+
+    /**
+     * 释放槽位，之后该槽位号可能被重新分配
+     */
+    void release(int slot);
+
+    /**
+     * 清空槽位的滤波状态（保留分配），下一个定位点重新初始化
+     */
+    void resetSlot(int slot);
+
+    size_t capacity() const { return tracks.size(); }
+    size_t activeCount() const { return tracks.size() - freeSlots.size(); }
+
+    /**
+     * 批量输入定位点，同一槽位的多个定位点按数组顺序处理
+     * @param slots 每个定位点所属的槽位
+     * @param timestamps 时间戳（秒）
+     * @param accuracies 可选（可为 nullptr），定位精度（米，1σ）
+     * @param out 每个定位点的平滑结果，至少 points.size() 项
+     */
+    void update(const int32_t* slots, const double* timestamps, const CoordSpan& points,
+                const double* accuracies, SmoothedFix* out);
+
+    /**
+     * 按当前速度外推到指定时间的位置（用于两次定位之间的标记动画）
+     * @return 槽位无效或尚未初始化时返回 false
+     */
+    bool predict(int slot, double time, double& lat, double& lon) const;
+
+private:
+    struct Track {
+        double originLat;
+        double originLon;
+        double metersPerDegreeLon;
+        double time;
+        double x;                // 相对原点的东向 / 北向位置（米）与速度（米/秒）
+        double y;
+        double vx;
+        double vy;
+        double p00;              // 单轴 [位置, 速度] 协方差（两轴相同）
+        double p01;
+        double p11;
+        double heading;
+        float innovations[kGpsSmootherMaxWindow];
+        uint8_t innovationCount;
+        uint8_t innovationCursor;
+        uint8_t rejectedRun;
+        bool active;
+        bool initialized;
+    };
+
+    void initialize(Track& track, double time, double lat, double lon, double accuracy) const;
+    void recenter(Track& track) const;
+    void output(const Track& track, double x, double y, uint8_t flags, SmoothedFix& out) const;
+    double gate(const Track& track, double innovationVariance) const;
+
+    GpsSmootherOptions options;
+    std::vector<Track> tracks;
+    std::vector<int32_t> freeSlots;
+};
+
+}
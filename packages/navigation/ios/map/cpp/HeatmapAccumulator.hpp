@@ -0,0 +1,99 @@
+#pragma once
+
+#include <cstdint>
+#include <limits>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "GeometryEngine.hpp"
+
+namespace gaodemap {
+
+struct HeatmapCellUpdate {
+    int64_t row;        // 纬度方向网格下标
+    int64_t col;        // 经度方向网格下标
+    double lat;         // 网格中心纬度
+    double lon;         // 网格中心经度
+    double intensity;   // 当前强度，<= 0 表示该网格已被移除
+};
+
+struct HeatmapDelta {
+    std::vector<HeatmapCellUpdate> cells;  // 自上次 takeDirty 以来变化的网格，按 (row, col) 升序
+    double decayFactor = 1.0;              // 自上次 takeDirty 以来的整体衰减系数，未列出的网格强度应乘以该值
+};
+
+/**
+ * 增量热力图网格累加器
+ * 网格以经纬度 (0, 0) 为原点固定划分，加点 / 删点只修改对应网格，无需对全部历史数据重新分桶；
+ * 支持按半衰期整体衰减（惰性实现，衰减本身不会产生脏网格），
+ * takeDirty 只返回变化的网格，供图层增量更新
+ * 非线程安全，调用方需自行保证串行访问
+ */
+class HeatmapAccumulator {
+public:
+    /**
+     * @param gridSizeMeters 网格大小（米）
+     * @param referenceLatitude 计算经度步长使用的参考纬度（通常取数据所在区域的中心纬度）
+     * @param halfLifeSeconds 强度半衰期（秒），<= 0 表示不衰减
+     * @param pruneBelow 衰减后强度低于该值的网格会被移除
+     */
+    HeatmapAccumulator(double gridSizeMeters, double referenceLatitude, double halfLifeSeconds = 0.0, double pruneBelow = 1e-3);
+
+    /**
+     * 添加加权点
+     * @param timestampSeconds 点产生的时间，早于当前时间时按已衰减的强度计入；省略（NaN）表示 currentTime()
+     */
+    void add(const HeatmapPoint& point, double timestampSeconds = std::numeric_limits<double>::quiet_NaN());
+    void add(const std::vector<HeatmapPoint>& points, double timestampSeconds = std::numeric_limits<double>::quiet_NaN());
+
+    /**
+     * 移除之前添加的点，参数需与 add 时一致（含时间戳，省略同样表示 currentTime()）
+     * 点所在网格已被衰减清理（之后即使有新点落入同一网格）时忽略，不会扣除新点的权重
+     */
+    void remove(const HeatmapPoint& point, double timestampSeconds = std::numeric_limits<double>::quiet_NaN());
+
+    /**
+     * 推进当前时间，时间不会倒退
+     */
+    void advanceTime(double nowSeconds);
+
+    /**
+     * 取出自上次调用以来变化的网格，并清空脏标记
+     */
+    HeatmapDelta takeDirty();
+
+    /**
+     * 全量网格（当前强度），按 (row, col) 升序，格式与 generateHeatmapGrid 相同
+     */
+    std::vector<HeatmapGridCell> snapshot() const;
+
+    size_t cellCount() const { return cells.size(); }
+    double currentTime() const { return now; }
+
+private:
+    struct Cell {
+        double stored;   // 以 epoch 为基准放大后的权重，当前强度 = stored * exp(-lambda * (now - epoch))
+        int64_t count;   // 落入该网格的点数，归零时移除网格
+        double since;    // 网格本次创建以来最早的点时间，更早的点属于已被清理的网格
+    };
+
+    bool cellKey(const HeatmapPoint& point, uint64_t& key) const;
+    double scaleAt(double timestampSeconds) const;
+    double currentScale() const;
+    void rebase();
+    void prune();
+
+    double latStep;
+    double lonStep;
+    double lambda;
+    double pruneBelow;
+    double now = 0.0;
+    double epoch = 0.0;           // stored 的时间基准
+    double lastTakenTime = 0.0;   // 上次 takeDirty 的时间
+    double lastPrunedTime = 0.0;  // 上次清理衰减网格的时间
+    std::unordered_map<uint64_t, Cell> cells;
+    std::unordered_set<uint64_t> dirty;
+};
+
+}
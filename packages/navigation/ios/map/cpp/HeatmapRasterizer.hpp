@@ -0,0 +1,166 @@
+#pragma once
+
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "GeometryEngine.hpp"
+
+namespace gaodemap {
+
+// 核密度估计使用的核函数
+enum class HeatmapKernel {
+    Gaussian = 0,      // 高斯核，三次盒式模糊近似，radiusPx 对应 3σ
+    Epanechnikov = 1   // Epanechnikov 核 1 - d²/R²（紧支撑），按行前缀和精确卷积，radiusPx 为支撑半径 R
+};
+
+struct HeatmapRasterOptions {
+    int tileSize = 256;                                // 输出栅格边长（像素）
+    double radiusPx = 24.0;                            // 核半径（像素）
+    HeatmapKernel kernel = HeatmapKernel::Gaussian;
+};
+
+struct HeatmapRaster {
+    int width = 0;
+    int height = 0;
+    std::vector<float> values;  // 行优先的密度值，像素 (x, y) 位于 values[y * width + x]
+    float maxValue = 0.0f;
+};
+
+/**
+ * 将加权点栅格化为与瓦片对齐的密度图 (KDE)
+ * 点先按 Web Mercator 投影到瓦片像素坐标并双线性分摊到像素，再与核函数卷积
+ * 瓦片外核半径范围内的点也会参与计算，相邻瓦片拼接处无接缝
+ * 高斯核用三次可分离盒式模糊近似，开销与半径无关，为 O(像素数 × 模糊次数)；
+ * Epanechnikov 核为 O(像素数 × 2R)
+ * @param points 加权点
+ * @param tileX 瓦片 X
+ * @param tileY 瓦片 Y
+ * @param zoom 缩放级别
+ * @param options 栅格尺寸、核半径与核函数
+ * @return 浮点密度栅格，总和约等于落入瓦片的权重
+ */
+HeatmapRaster rasterizeHeatmapTile(
+    const std::vector<HeatmapPoint>& points,
+    int tileX,
+    int tileY,
+    int zoom,
+    const HeatmapRasterOptions& options
+);
+
+/**
+ * 将密度栅格量化为 0-255 的强度
+ * @param raster 密度栅格
+ * @param maxIntensity 映射为 255 的密度值，<= 0 时使用 raster.maxValue
+ * @return 与 raster 同尺寸的 uint8 缓冲区
+ */
+std::vector<uint8_t> quantizeHeatmap(const HeatmapRaster& raster, float maxIntensity);
+
+/**
+ * 根据颜色字符串构建 256 级渐变查找表 (0xAARRGGBB)
+ * 颜色通过 parseColor 解析，相邻色标之间按 ARGB 分量线性插值；下标 0（无密度）固定为透明，
+ * 低强度区间（第一个色标位置之前，位于 0 时为前 20%）内透明度从 0 淡入到色标的透明度
+ * @param colors 颜色字符串，至少 1 个
+ * @param positions 色标位置 (0-1)，为空时均匀分布，数量需与 colors 一致
+ * @return 256 项查找表，参数非法时返回空
+ */
+std::vector<uint32_t> buildHeatmapGradientLut(const std::vector<std::string>& colors, const std::vector<double>& positions);
+
+/**
+ * 同上，颜色直接以 0xAARRGGBB 给出（如 Android 已解析的 Gradient 颜色）
+ */
+std::vector<uint32_t> buildHeatmapGradientLutArgb(const std::vector<uint32_t>& colors, const std::vector<double>& positions);
+
+/**
+ * 通过渐变查找表将强度缓冲区着色为 ARGB 像素，可直接用于创建 Bitmap / CGImage
+ * @param intensities quantizeHeatmap 的输出
+ * @param lut buildHeatmapGradientLut 的输出（256 项）
+ * @return ARGB 像素
+ */
+std::vector<uint32_t> colorizeHeatmap(const std::vector<uint8_t>& intensities, const std::vector<uint32_t>& lut);
+
+/**
+ * 热力图瓦片金字塔生成器
+ * 按 (x, y, z) 按需生成 ARGB 瓦片，并用有界 LRU 缓存已渲染的瓦片：
+ * - 点集按 zoom 16 网格排序建立索引，生成单个瓦片只访问覆盖范围内的点
+ * - 每个缓存瓦片记录其输入点（含核半径外扩区域）的指纹与着色时的归一化基准；setPoints 后再次请求时，
+ *   指纹与基准都未变的瓦片直接复用，只有输入点发生变化的瓦片才会重新栅格化
+ * - 自动归一化的各级峰值在 setPoints 后保留，重新估计的峰值变化不超过 10% 时沿用原值，
+ *   避免少量点更新改变基准而导致整级瓦片重绘
+ * - setStyle 改变样式时会使全部缓存失效
+ * 线程安全：可在地图 SDK 的多个瓦片线程中并发调用 getTile
+ */
+class HeatmapTileProvider {
+public:
+    using TilePixels = std::shared_ptr<const std::vector<uint32_t>>;
+
+    explicit HeatmapTileProvider(size_t maxCachedTiles = 256);
+
+    /**
+     * 替换全部热力点
+     */
+    void setPoints(const std::vector<HeatmapPoint>& points);
+
+    /**
+     * 设置栅格参数与渐变，与当前样式相同时不做任何事
+     * @param options 瓦片尺寸、核半径与核函数
+     * @param lut buildHeatmapGradientLut 的输出（256 项）；为空时恢复默认的蓝 → 绿 → 红色带
+     * @param maxIntensity 映射为渐变末端的密度值，<= 0 时按缩放级别自动估计（同一级别的瓦片共用，颜色无接缝）
+     */
+    void setStyle(const HeatmapRasterOptions& options, const std::vector<uint32_t>& lut, float maxIntensity);
+
+    /**
+     * 获取瓦片像素 (tileSize * tileSize 个 ARGB)
+     * @return 瓦片内没有密度时返回空数组
+     */
+    TilePixels getTile(int x, int y, int z);
+
+    size_t cachedTileCount() const;
+    void clearCache();
+    /** 样式版本，setStyle 实际改变样式时递增 */
+    uint64_t currentStyleGeneration() const;
+
+private:
+    struct CachedTile {
+        TilePixels pixels;
+        uint64_t fingerprint;
+        float normalization;   // 着色时使用的 maxIntensity
+        uint64_t generation;
+        std::list<uint64_t>::iterator lruIt;
+    };
+
+    struct IndexedPoint {
+        uint64_t cell;  // zoom 16 网格单元 (row << 32 | col)
+        HeatmapPoint point;
+    };
+    using PointIndex = std::shared_ptr<const std::vector<IndexedPoint>>;
+
+    // 收集覆盖瓦片（含外扩像素）的点，按索引顺序输出，同时返回输入指纹
+    static uint64_t collectTilePoints(const std::vector<IndexedPoint>& index, int x, int y, int z, double marginTiles, std::vector<HeatmapPoint>& out);
+    // 以核半径为边长分桶，估计指定缩放级别的峰值密度
+    static float estimateMaxIntensity(const std::vector<IndexedPoint>& index, int z, const HeatmapRasterOptions& options);
+    void touch(CachedTile& tile);
+    void insert(uint64_t key, TilePixels pixels, uint64_t fingerprint, float normalization);
+
+    mutable std::mutex mutex;
+    size_t maxCachedTiles;
+    PointIndex index;  // 按 cell 排序，setPoints 时整体替换，getTile 持有快照后在锁外读取
+    uint64_t dataGeneration = 0;
+    uint64_t styleGeneration = 0;
+    HeatmapRasterOptions options;
+    std::vector<uint32_t> lut;
+    float maxIntensity = 0.0f;
+    struct AutoPeak {
+        float value;          // 当前采用的峰值密度
+        uint64_t generation;  // 估计时的数据版本，落后于 dataGeneration 时需重新估计
+    };
+    std::unordered_map<int, AutoPeak> autoMaxIntensity;  // 各缩放级别自动估计的峰值密度
+    std::list<uint64_t> lru;  // 最近使用的在前
+    std::unordered_map<uint64_t, CachedTile> cache;
+};
+
+}
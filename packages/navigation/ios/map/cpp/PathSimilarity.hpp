@@ -0,0 +1,90 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+#include "GeometryEngine.hpp"
+
+namespace gaodemap {
+
+/**
+ * 折线线段的均匀网格索引：按距离由近到远逐圈查找，找到的距离不大于未访问网格的下界时停止
+ *
+ * 同一条参考路线与多条候选路线比较时只需构建一次
+ * 网格在以路线中心纬度为基准的等距投影上划分，距离在查询点处的局部投影中计算，长路线也保持米级精度
+ * 构建后只读，可在多个线程中同时查询
+ */
+class PathSegmentIndex {
+public:
+    /**
+     * @param cellMeters 网格边长（米），<= 0 时按平均线段长度自动选择
+     */
+    explicit PathSegmentIndex(const CoordSpan& path, double cellMeters = 0.0);
+
+    /**
+     * 点到折线的最短距离（米）
+     * @param maxDistanceMeters 超过该距离时停止查找并返回 +∞
+     * @param stopBelowMeters 找到不超过该值的距离即返回（此时不一定是最短距离），只关心是否超过某个值时使用
+     */
+    double distanceTo(double lat, double lon,
+                      double maxDistanceMeters = std::numeric_limits<double>::infinity(),
+                      double stopBelowMeters = 0.0) const;
+
+    size_t pointCount() const { return xs.size(); }
+
+private:
+    double pointToSegment(double qx, double qy, double scale, uint32_t segment) const;
+
+    double refLon;           // 经度相对该值展开，避免跨 180° 经线
+    double cosRef;           // 网格投影的经度缩放（路线范围内的最大值）
+    double cosMin;           // 路线范围内纬度余弦的最小值，用于把网格距离换算为真实距离的下界
+    double cellSize;
+    double minX;
+    double minY;
+    int columns = 0;
+    int rows = 0;
+    std::vector<double> xs;  // 顶点：展开后的经度、纬度（度）
+    std::vector<double> ys;
+    std::vector<uint32_t> cellStart;   // CSR: 网格 -> 线段编号
+    std::vector<uint32_t> cellSegments;
+};
+
+struct PathDeviation {
+    double averageMeters = 0.0;   // 各点到折线距离的平均值
+    double maxMeters = 0.0;       // 最大值（即按顶点计算的有向 Hausdorff 距离）
+    size_t exceededCount = 0;     // 距离超过阈值的点数
+};
+
+/**
+ * 统计一组点到折线的偏差（路线跟随时衡量候选路线偏离参考路线的程度、漏掉的锚点数）
+ */
+PathDeviation measurePathDeviation(const PathSegmentIndex& path, const CoordSpan& points,
+                                   double thresholdMeters = std::numeric_limits<double>::infinity());
+
+/**
+ * 两条折线的 Hausdorff 距离（米）：一条折线的顶点到另一条折线（含线段内部）的最大距离，取两个方向的较大者
+ * 顶点稀疏时可先用 resamplePolyline 加密
+ * @param thresholdMeters 结果超过该值时提前结束并返回 +∞
+ */
+double hausdorffDistance(const CoordSpan& a, const CoordSpan& b,
+                         double thresholdMeters = std::numeric_limits<double>::infinity());
+
+/**
+ * 有向 Hausdorff 距离：from 的顶点到 to 折线的最大距离
+ */
+double directedHausdorffDistance(const PathSegmentIndex& to, const CoordSpan& from,
+                                 double thresholdMeters = std::numeric_limits<double>::infinity());
+
+/**
+ * 两条折线的离散 Fréchet 距离（米），考虑顶点顺序，能区分方向相反或绕圈的路线
+ *
+ * 先用贪心匹配求出上界，再只在距离不超过上界（与阈值中的较小者）的对角带内做动态规划，
+ * 相近路线的计算量接近 O(n + m)
+ * @param thresholdMeters 结果超过该值时提前结束并返回 +∞
+ */
+double discreteFrechetDistance(const CoordSpan& a, const CoordSpan& b,
+                               double thresholdMeters = std::numeric_limits<double>::infinity());
+
+}
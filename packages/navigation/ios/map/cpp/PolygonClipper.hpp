@@ -0,0 +1,167 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "GeometryEngine.hpp"
+
+namespace gaodemap {
+
+/**
+ * 一组环，通常 rings[0] 为外环、其余为洞（与 JS 层 LatLng[][] 的约定一致）
+ * 内外由填充规则决定，多个多边形的环可以直接拼接；环首尾不需要重复
+ */
+using PolygonRings = std::vector<std::vector<GeoPoint>>;
+
+enum class BooleanOp : uint8_t {
+    Union = 0,
+    Intersection = 1,
+    Difference = 2,    // subject - clip
+    Xor = 3
+};
+
+// 判断点是否在一组环内部的规则，环绕数在经度向东、纬度向北的坐标系下计算
+enum class FillRule : uint8_t {
+    EvenOdd = 0,       // 奇偶规则，与环的方向无关，适合用户绘制的输入
+    NonZero = 1,       // 环绕数不为 0
+    Positive = 2       // 环绕数大于 0
+};
+
+// 局部投影下的整数网格坐标
+struct ClipperPoint {
+    int64_t x;
+    int64_t y;
+};
+
+/**
+ * 多边形布尔运算与缓冲区（地理围栏编辑）
+ *
+ * 在以输入中心为原点的局部等距圆柱投影（米）中计算，坐标量化到整数网格
+ * （1 mm，范围超过约 268 km 时按比例放大），方向判断全部为整数精确运算：
+ * 1. 用均匀网格筛选候选边对，求出所有交点、T 形接点和共线重叠并在该处拆分边，重复到没有新的交点
+ * 2. 合并重复边，追踪平面图的面，从每个连通分量的外侧面（环绕数用一条水平射线求出）出发
+ *    逐面累加边的环绕数；由边两侧的环绕数和填充规则判断是否属于结果，保留两侧不同的边并定向为结果内部在左
+ * 3. 在每个顶点选取相对入边顺时针方向的第一条出边拼成环，逆时针环为外环，顺时针环归入包含它的最小外环
+ *
+ * 输出的每个多边形为 {外环（逆时针）, 洞（顺时针）...}，环首尾不重复，已去掉共线点
+ * 距离在投影中心纬度处准确，南北跨度 Δφ 处的比例误差约为 tan(φ0)·Δφ（φ0 = 40°、偏离 0.25° 时约 0.4%）
+ *
+ * 内部缓冲区在多次调用间复用，适合编辑时连续计算；非线程安全
+ */
+class PolygonClipper {
+public:
+    /**
+     * 布尔运算，subject 与 clip 使用同一填充规则
+     */
+    std::vector<PolygonRings> compute(const PolygonRings& subject, const PolygonRings& clip, BooleanOp op, FillRule fillRule = FillRule::EvenOdd);
+
+    /**
+     * 缓冲区：meters > 0 向外扩张，< 0 向内收缩（洞相应变化），= 0 时只做规整化（去自交、统一方向）
+     * 输入按奇偶规则解释；扩张时的凸角、收缩时的凹角以圆弧连接
+     * @param arcToleranceMeters 圆弧折线化的最大偏差，<= 0 时取 |meters| 的 0.5%（不小于 1 cm）
+     */
+    std::vector<PolygonRings> buffer(const PolygonRings& polygon, double meters, double arcToleranceMeters = 0.0);
+
+private:
+    struct Edge {
+        ClipperPoint a;
+        ClipperPoint b;
+        uint8_t operand;         // 0 = subject，1 = clip
+    };
+
+    struct Box {
+        int64_t minX;
+        int64_t minY;
+        int64_t maxX;
+        int64_t maxY;
+    };
+
+    // 去重后的边，u -> v 为规范方向（非水平边 u 在下方，水平边 u 在左侧）
+    struct UniqueEdge {
+        ClipperPoint u;
+        ClipperPoint v;
+        int32_t wind[2];         // 各操作数中沿 u -> v 的边数减去反向边数
+    };
+
+    // 去重边的一个方向，id = 2 * 去重边下标 + (是否与规范方向相反)
+    struct HalfEdge {
+        ClipperPoint a;
+        ClipperPoint b;
+        uint32_t id;
+    };
+
+    struct Split {
+        uint32_t edge;
+        ClipperPoint point;
+    };
+
+    void setupFrame(const PolygonRings& first, const PolygonRings* second, double marginMeters);
+    ClipperPoint project(const GeoPoint& point) const;
+    GeoPoint unproject(const ClipperPoint& point) const;
+    void addRings(const PolygonRings& rings, uint8_t operand);
+    void addRing(const std::vector<ClipperPoint>& ring, uint8_t operand);
+    void intersect(uint32_t first, uint32_t second);
+    bool splitIntersections();
+    void buildUniqueEdges();
+    void buildBandIndex();
+    size_t bandOf(int64_t y) const;
+    void windingAt(const ClipperPoint& p, int32_t wind[2]) const;
+    void buildFaces();
+    uint32_t nextHalfEdge(uint32_t k) const;
+    void propagateWinding();
+    void overlay(BooleanOp op, FillRule subjectFill, FillRule clipFill);
+    uint32_t nextEdge(uint32_t edge) const;
+    void assembleRings();
+    std::vector<PolygonRings> output() const;
+
+    double originLat = 0.0;
+    double originLon = 0.0;
+    double unitsPerDegreeLat = 1.0;
+    double unitsPerDegreeLon = 1.0;
+    double metersPerUnit = 1e-3;
+
+    std::vector<Edge> edges;
+    std::vector<Edge> scratch;
+    std::vector<uint8_t> fresh;          // 上一轮新产生的边
+    std::vector<uint8_t> freshScratch;
+    std::vector<Box> boxes;
+    // 求交用的均匀网格，CSR 布局
+    std::vector<uint32_t> cellOffsets;
+    std::vector<uint32_t> cellItems;
+    std::vector<uint32_t> cursor;
+    std::vector<Split> splits;
+    std::vector<UniqueEdge> unique;
+
+    // 按 y 分带的非水平边索引，CSR 布局
+    std::vector<uint32_t> bandOffsets;
+    std::vector<uint32_t> bandEdges;
+    int64_t bandMinY = 0;
+    int64_t bandHeight = 1;
+
+    // 去重边构成的平面图：半边按起点、极角排序，面为半边左侧的区域
+    std::vector<HalfEdge> halfEdges;
+    std::vector<uint32_t> halfPosition;  // id -> 排序后的下标
+    std::vector<uint32_t> vertexFirst;   // 同一起点的半边范围
+    std::vector<uint32_t> vertexLast;
+    std::vector<uint32_t> faceOf;
+    std::vector<uint32_t> faceStart;
+    std::vector<double> faceArea;        // 二倍有向面积，每个连通分量的外侧面为负
+    std::vector<int32_t> faceWind;       // 每个面两个操作数的环绕数
+
+    std::vector<Edge> resultEdges;
+    std::vector<uint8_t> usedEdges;
+    std::vector<std::vector<ClipperPoint>> rings;
+    std::vector<int32_t> ringParent;   // 洞所属外环的下标，外环为 -1，找不到外环的洞为 -2
+};
+
+/**
+ * 一次性布尔运算，等价于 PolygonClipper().compute(...)
+ */
+std::vector<PolygonRings> polygonBoolean(const PolygonRings& subject, const PolygonRings& clip, BooleanOp op, FillRule fillRule = FillRule::EvenOdd);
+
+/**
+ * 一次性缓冲区，等价于 PolygonClipper().buffer(...)
+ */
+std::vector<PolygonRings> bufferPolygon(const PolygonRings& polygon, double meters, double arcToleranceMeters = 0.0);
+
+}
@@ -0,0 +1,192 @@
+#include "TrajectoryAnalyzer.hpp"
+
+#include <cmath>
+#include <limits>
+
+namespace gaodemap {
+
+// 位移小于该值时航向不可靠，沿用上一个航向
+static constexpr double kTrajectoryMinHeadingMeters = 1.0;
+static constexpr double kTrajectoryMetersPerDegree = 6371000.0 * 0.017453292519943295;
+
+static inline double trajectory_toRadians(double degrees) {
+    return degrees * 0.017453292519943295;
+}
+
+static inline double trajectory_wrapLon(double dLon) {
+    return dLon > 180.0 ? dLon - 360.0 : (dLon < -180.0 ? dLon + 360.0 : dLon);
+}
+
+static double trajectory_bearing(double lat1, double lon1, double lat2, double lon2) {
+    const double phi1 = trajectory_toRadians(lat1);
+    const double phi2 = trajectory_toRadians(lat2);
+    const double dLambda = trajectory_toRadians(lon2 - lon1);
+    const double y = std::sin(dLambda) * std::cos(phi2);
+    const double x = std::cos(phi1) * std::sin(phi2) - std::sin(phi1) * std::cos(phi2) * std::cos(dLambda);
+    const double degrees = std::atan2(y, x) * 57.29577951308232;
+    return degrees < 0.0 ? degrees + 360.0 : degrees;
+}
+
+TrajectoryAnalyzer::TrajectoryAnalyzer(const TrajectoryOptions& options)
+    : options(options), heading(std::numeric_limits<double>::quiet_NaN()) {}
+
+void TrajectoryAnalyzer::reset() {
+    stats = TrajectorySummary();
+    boundsAccumulator.reset();
+    movingDistance = 0.0;
+    hasLast = false;
+    heading = std::numeric_limits<double>::quiet_NaN();
+    hasRejected = false;
+    rejectedRun = 0;
+    hasCandidate = false;
+    stops.clear();
+}
+
+void TrajectoryAnalyzer::add(const double* timestamps, const CoordSpan& points, TrajectorySegment* outSegments) {
+    for (size_t i = 0; i < points.size(); ++i) {
+        const size_t index = stats.pointCount++;
+        const double time = timestamps[i];
+        const double lat = points.latAt(i);
+        const double lon = points.lonAt(i);
+        TrajectorySegment segment{0.0, 0.0, 0.0, heading, 0};
+
+        if (!std::isfinite(time) || !std::isfinite(lat) || !std::isfinite(lon) || std::abs(lat) > 90.0) {
+            segment.flags = kTrajectoryOutlier;
+            ++stats.outlierCount;
+            if (outSegments) outSegments[i] = segment;
+            continue;
+        }
+
+        if (!hasLast) {
+            firstTime = time;
+            accept(time, lat, lon, index);
+            if (outSegments) outSegments[i] = segment;
+            continue;
+        }
+
+        const double dt = time - lastTime;
+        const double distance = calculateDistance(lastLat, lastLon, lat, lon);
+        const double speed = dt > 0.0 ? distance / dt : (distance == 0.0 ? 0.0 : std::numeric_limits<double>::infinity());
+
+        if (dt < 0.0 || speed > options.maxSpeedMps) {
+            // 与上一个跳点一致（速度合理）时累加连续次数，达到阈值后认为是真实位移
+            bool consistent = false;
+            if (hasRejected && time > rejectedTime) {
+                consistent = calculateDistance(rejectedLat, rejectedLon, lat, lon) / (time - rejectedTime) <= options.maxSpeedMps;
+            }
+            rejectedRun = consistent ? rejectedRun + 1 : 1;
+            if (dt > 0.0 && rejectedRun >= options.reanchorAfter) {
+                closeStop();
+                hasCandidate = false;
+                segment.seconds = dt;
+                segment.flags = kTrajectoryReanchored;
+                if (dt > options.maxGapSeconds) segment.flags |= kTrajectoryGap;
+                accept(time, lat, lon, index);
+                if (outSegments) outSegments[i] = segment;
+                continue;
+            }
+            hasRejected = true;
+            rejectedTime = time;
+            rejectedLat = lat;
+            rejectedLon = lon;
+            segment.flags = kTrajectoryOutlier;
+            ++stats.outlierCount;
+            if (outSegments) outSegments[i] = segment;
+            continue;
+        }
+
+        if (distance >= kTrajectoryMinHeadingMeters) {
+            heading = trajectory_bearing(lastLat, lastLon, lat, lon);
+        }
+        segment.distanceMeters = distance;
+        segment.seconds = dt;
+        segment.speedMps = speed;
+        segment.headingDegrees = heading;
+        if (dt > options.maxGapSeconds) segment.flags |= kTrajectoryGap;
+        if (speed < options.stopSpeedMps) {
+            segment.flags |= kTrajectoryStationary;
+        } else {
+            stats.movingSeconds += dt;
+            movingDistance += distance;
+        }
+        stats.totalDistanceMeters += distance;
+        if (speed > stats.maxSpeedMps) stats.maxSpeedMps = speed;
+
+        accept(time, lat, lon, index);
+        if (outSegments) outSegments[i] = segment;
+    }
+}
+
+void TrajectoryAnalyzer::accept(double time, double lat, double lon, size_t index) {
+    hasLast = true;
+    lastTime = time;
+    lastLat = lat;
+    lastLon = lon;
+    hasRejected = false;
+    rejectedRun = 0;
+    ++stats.acceptedCount;
+    stats.totalSeconds = time - firstTime;
+    boundsAccumulator.add(lat, lon);
+    updateStop(time, lat, lon, index);
+}
+
+void TrajectoryAnalyzer::updateStop(double time, double lat, double lon, size_t index) {
+    // 停留半径通常只有几十米，用圆心处的等距投影判断即可
+    if (hasCandidate) {
+        const double dLon = trajectory_wrapLon(lon - candidate.anchorLon);
+        const double dx = dLon * candidate.metersPerDegreeLon;
+        const double dy = (lat - candidate.anchorLat) * kTrajectoryMetersPerDegree;
+        if (dx * dx + dy * dy <= options.stopRadiusMeters * options.stopRadiusMeters) {
+            candidate.endTime = time;
+            candidate.sumLat += lat;
+            candidate.sumLonOffset += dLon;
+            candidate.lastIndex = index;
+            ++candidate.count;
+            return;
+        }
+    }
+
+    closeStop();
+    hasCandidate = true;
+    candidate = {lat, lon, kTrajectoryMetersPerDegree * std::cos(trajectory_toRadians(lat)), time, time, lat, 0.0, index, index, 1};
+}
+
+void TrajectoryAnalyzer::closeStop() {
+    if (!hasCandidate) return;
+    const double duration = candidate.endTime - candidate.startTime;
+    if (duration < options.minStopSeconds) return;
+
+    const double count = static_cast<double>(candidate.count);
+    TrajectoryStop stop;
+    stop.lat = candidate.sumLat / count;
+    stop.lon = std::remainder(candidate.anchorLon + candidate.sumLonOffset / count, 360.0);
+    stop.startTime = candidate.startTime;
+    stop.endTime = candidate.endTime;
+    stop.firstIndex = candidate.firstIndex;
+    stop.lastIndex = candidate.lastIndex;
+    stop.pointCount = candidate.count;
+    stops.push_back(stop);
+    ++stats.stopCount;
+    stats.stoppedSeconds += duration;
+}
+
+void TrajectoryAnalyzer::finish() {
+    closeStop();
+    hasCandidate = false;
+}
+
+std::vector<TrajectoryStop> TrajectoryAnalyzer::takeStops() {
+    std::vector<TrajectoryStop> result;
+    result.swap(stops);
+    return result;
+}
+
+TrajectorySummary TrajectoryAnalyzer::summary() const {
+    TrajectorySummary result = stats;
+    result.averageSpeedMps = result.totalSeconds > 0.0 ? result.totalDistanceMeters / result.totalSeconds : 0.0;
+    result.movingAverageSpeedMps = result.movingSeconds > 0.0 ? movingDistance / result.movingSeconds : 0.0;
+    result.bounds = boundsAccumulator.bounds();
+    return result;
+}
+
+}
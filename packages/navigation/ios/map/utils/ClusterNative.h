@@ -40,6 +40,25 @@ NS_ASSUME_NONNULL_BEGIN
 + (double)calculatePathLengthWithLatitudes:(NSArray<NSNumber *> *)latitudes
                                 longitudes:(NSArray<NSNumber *> *)longitudes NS_SWIFT_NAME(calculatePathLength(latitudes:longitudes:));
 
+/**
+ * 沿路径按距离等距取 count 个点（含首尾）
+ * @return 扁平化的坐标数组 [lat1, lon1, lat2, lon2, ...]
+ */
++ (NSArray<NSNumber *> *)resamplePolylineByCountWithLatitudes:(NSArray<NSNumber *> *)latitudes
+                                                   longitudes:(NSArray<NSNumber *> *)longitudes
+                                                        count:(int)count NS_SWIFT_NAME(resamplePolylineByCount(latitudes:longitudes:count:));
+
+/**
+ * 比较候选路线与参考路线（如 Web 规划线）的相似程度
+ * @return @{ @"averageDeviationMeters", @"maxDeviationMeters", @"exceededCount"（距离超过阈值的顶点数）,
+ *            @"hausdorffMeters", @"frechetMeters" }
+ */
++ (NSDictionary *)comparePathsWithReferenceLatitudes:(NSArray<NSNumber *> *)referenceLatitudes
+                                 referenceLongitudes:(NSArray<NSNumber *> *)referenceLongitudes
+                                           latitudes:(NSArray<NSNumber *> *)latitudes
+                                          longitudes:(NSArray<NSNumber *> *)longitudes
+                                     thresholdMeters:(double)thresholdMeters NS_SWIFT_NAME(comparePaths(referenceLatitudes:referenceLongitudes:latitudes:longitudes:thresholdMeters:));
+
 + (NSDictionary * _Nullable)getPointAtDistanceWithLatitudes:(NSArray<NSNumber *> *)latitudes
                                                longitudes:(NSArray<NSNumber *> *)longitudes
                                            distanceMeters:(double)distanceMeters NS_SWIFT_NAME(getPointAtDistance(latitudes:longitudes:distanceMeters:));
@@ -67,7 +86,11 @@ NS_ASSUME_NONNULL_BEGIN
                                lon:(double)lon
                          precision:(int)precision NS_SWIFT_NAME(encodeGeoHash(lat:lon:precision:));
 
-+ (uint32_t)parseColorWithString:(NSString *)colorString NS_SWIFT_NAME(parseColor(colorString:));
+/**
+ * 解析颜色字符串
+ * @return ARGB 颜色 (0xAARRGGBB)，解析失败返回 -1（与合法的 transparent 即 0 区分）
+ */
++ (int64_t)parseColorWithString:(NSString *)colorString NS_SWIFT_NAME(parseColor(colorString:));
 
 + (CLLocationCoordinate2D)coordinateForMapPointWithX:(double)x y:(double)y NS_SWIFT_NAME(coordinateForMapPoint(x:y:));
 
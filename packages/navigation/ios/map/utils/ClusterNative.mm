@@ -7,12 +7,15 @@
 #define HAS_MAMAPKIT 0
 #endif
 
+#include <algorithm>
 #include <vector>
 #include <string>
+#include <string_view>
 
 #include "../cpp/ClusterEngine.hpp"
 #include "../cpp/GeometryEngine.hpp"
 #include "../cpp/ColorParser.hpp"
+#include "../cpp/PathSimilarity.hpp"
 
 @implementation ClusterNative
 
@@ -146,6 +149,63 @@
     return gaodemap::calculatePathLength(points);
 }
 
++ (NSArray<NSNumber *> *)resamplePolylineByCountWithLatitudes:(NSArray<NSNumber *> *)latitudes
+                                                   longitudes:(NSArray<NSNumber *> *)longitudes
+                                                        count:(int)count {
+    if (count <= 0 || latitudes.count == 0 || latitudes.count != longitudes.count) {
+        return @[];
+    }
+
+    std::vector<gaodemap::GeoPoint> input;
+    input.reserve(latitudes.count);
+    for (NSUInteger i = 0; i < latitudes.count; i++) {
+        input.push_back({latitudes[i].doubleValue, longitudes[i].doubleValue});
+    }
+
+    const auto points = gaodemap::resamplePolylineByCount(input, static_cast<size_t>(count));
+
+    NSMutableArray<NSNumber *> *result = [NSMutableArray arrayWithCapacity:points.size() * 2];
+    for (const auto &p : points) {
+        [result addObject:@(p.lat)];
+        [result addObject:@(p.lon)];
+    }
+    return result;
+}
+
++ (NSDictionary *)comparePathsWithReferenceLatitudes:(NSArray<NSNumber *> *)referenceLatitudes
+                                 referenceLongitudes:(NSArray<NSNumber *> *)referenceLongitudes
+                                           latitudes:(NSArray<NSNumber *> *)latitudes
+                                          longitudes:(NSArray<NSNumber *> *)longitudes
+                                     thresholdMeters:(double)thresholdMeters {
+    if (referenceLatitudes.count == 0 || referenceLatitudes.count != referenceLongitudes.count ||
+        latitudes.count == 0 || latitudes.count != longitudes.count) {
+        return @{};
+    }
+
+    std::vector<gaodemap::GeoPoint> reference;
+    reference.reserve(referenceLatitudes.count);
+    for (NSUInteger i = 0; i < referenceLatitudes.count; i++) {
+        reference.push_back({referenceLatitudes[i].doubleValue, referenceLongitudes[i].doubleValue});
+    }
+    std::vector<gaodemap::GeoPoint> path;
+    path.reserve(latitudes.count);
+    for (NSUInteger i = 0; i < latitudes.count; i++) {
+        path.push_back({latitudes[i].doubleValue, longitudes[i].doubleValue});
+    }
+
+    const gaodemap::PathSegmentIndex referenceIndex{gaodemap::CoordSpan(reference)};
+    const gaodemap::PathDeviation deviation = gaodemap::measurePathDeviation(referenceIndex, gaodemap::CoordSpan(path), thresholdMeters);
+    const double reverse = gaodemap::directedHausdorffDistance(gaodemap::PathSegmentIndex(gaodemap::CoordSpan(path)), gaodemap::CoordSpan(reference));
+
+    return @{
+        @"averageDeviationMeters": @(deviation.averageMeters),
+        @"maxDeviationMeters": @(deviation.maxMeters),
+        @"exceededCount": @(deviation.exceededCount),
+        @"hausdorffMeters": @(std::max(deviation.maxMeters, reverse)),
+        @"frechetMeters": @(gaodemap::discreteFrechetDistance(gaodemap::CoordSpan(reference), gaodemap::CoordSpan(path)))
+    };
+}
+
 + (NSDictionary * _Nullable)getPointAtDistanceWithLatitudes:(NSArray<NSNumber *> *)latitudes
                                                longitudes:(NSArray<NSNumber *> *)longitudes
                                            distanceMeters:(double)distanceMeters {
@@ -276,10 +336,13 @@
     return [NSString stringWithUTF8String:geoHash.c_str()];
 }
 
-+ (uint32_t)parseColorWithString:(NSString *)colorString {
-    if (!colorString) return 0;
-    std::string colorStr = [colorString UTF8String];
-    return gaodemap::parseColor(colorStr);
++ (int64_t)parseColorWithString:(NSString *)colorString {
+    if (!colorString) return -1;
+    // UTF8String 指向的缓冲区在当前自动释放池内有效，直接解析，不复制到 std::string
+    const char *utf8 = [colorString UTF8String];
+    if (!utf8) return -1;
+    uint32_t color = 0;
+    return gaodemap::tryParseColor(std::string_view(utf8), color) ? static_cast<int64_t>(color) : -1;
 }
 
 + (CLLocationCoordinate2D)coordinateForMapPointWithX:(double)x y:(double)y {
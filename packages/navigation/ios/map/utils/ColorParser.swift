@@ -6,7 +6,7 @@ class ColorParser {
      * 将颜色值转换为 UIColor
      * 支持格式：
      * - 数字：0xFF0000
-     * - 十六进制字符串："#FF0000" 或 "FF0000"
+     * - 十六进制字符串："#FF0000" 或 "FF0000"，8 位为 "#RRGGBBAA"（透明度在最后）
      * - 颜色名称："red", "blue", "green" 等
      */
     static func parseColor(_ colorValue: Any?) -> UIColor? {
@@ -27,9 +27,9 @@ class ColorParser {
      * 解析字符串颜色值
      */
     private static func parseColorString(_ colorString: String) -> UIColor? {
-        // Try native parser first
+        // Try native parser first，返回 -1 才是解析失败，0 是合法的 transparent
         let nativeColor = ClusterNative.parseColor(colorString: colorString)
-        if nativeColor != 0 {
+        if nativeColor >= 0 {
             // ARGB -> UIColor
             let a = CGFloat((nativeColor >> 24) & 0xFF) / 255.0
             let r = CGFloat((nativeColor >> 16) & 0xFF) / 255.0
@@ -127,17 +127,17 @@ class ColorParser {
             hex = r + g + b + a
         }
         
-        // 处理 #AARRGGBB 或 #RRGGBBAA 格式
+        // 处理 #RRGGBBAA 格式（与原生解析一致，透明度在最后）
         if hex.count == 8 {
             let scanner = Scanner(string: hex)
             var hexNumber: UInt64 = 0
             
             if scanner.scanHexInt64(&hexNumber) {
-                let alphaARGB = CGFloat((hexNumber & 0xff000000) >> 24) / 255
-                let redARGB = CGFloat((hexNumber & 0x00ff0000) >> 16) / 255
-                let greenARGB = CGFloat((hexNumber & 0x0000ff00) >> 8) / 255
-                let blueARGB = CGFloat(hexNumber & 0x000000ff) / 255
-                return UIColor(red: redARGB, green: greenARGB, blue: blueARGB, alpha: alphaARGB)
+                let red = CGFloat((hexNumber & 0xff000000) >> 24) / 255
+                let green = CGFloat((hexNumber & 0x00ff0000) >> 16) / 255
+                let blue = CGFloat((hexNumber & 0x0000ff00) >> 8) / 255
+                let alphaRGBA = CGFloat(hexNumber & 0x000000ff) / 255
+                return UIColor(red: red, green: green, blue: blue, alpha: alphaRGBA)
             }
         }
         
@@ -11,3 +11,13 @@
 #include "../cpp/GeometryEngine.cpp"
 #include "../cpp/ColorParser.cpp"
 #include "../cpp/QuadTree.cpp"
+#include "../cpp/HeatmapRasterizer.cpp"
+#include "../cpp/HeatmapAccumulator.cpp"
+#include "../cpp/CellId.cpp"
+#include "../cpp/CollisionEngine.cpp"
+#include "../cpp/Geodesic.cpp"
+#include "../cpp/PolygonClipper.cpp"
+#include "../cpp/Triangulator.cpp"
+#include "../cpp/TrajectoryAnalyzer.cpp"
+#include "../cpp/GpsSmoother.cpp"
+#include "../cpp/PathSimilarity.cpp"
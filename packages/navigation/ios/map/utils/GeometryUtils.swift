@@ -31,4 +31,25 @@ public enum GeometryUtils {
         }
         return simplified
     }
+    
+    /**
+     * 沿路径按距离等距取 count 个点（含首尾）
+     */
+    public static func resamplePolylineByCount(_ points: [CLLocationCoordinate2D], count: Int) -> [CLLocationCoordinate2D] {
+        if points.isEmpty || count <= 0 {
+            return []
+        }
+        
+        let lats = points.map { NSNumber(value: $0.latitude) }
+        let lons = points.map { NSNumber(value: $0.longitude) }
+        
+        let result = ClusterNative.resamplePolylineByCount(latitudes: lats, longitudes: lons, count: Int32(clamping: count))
+        
+        var resampled: [CLLocationCoordinate2D] = []
+        resampled.reserveCapacity(result.count / 2)
+        for i in stride(from: 0, to: result.count - 1, by: 2) {
+            resampled.append(CLLocationCoordinate2D(latitude: result[i].doubleValue, longitude: result[i + 1].doubleValue))
+        }
+        return resampled
+    }
 }
@@ -20,6 +20,9 @@ const createCoreModuleMock = () => ({
   }),
   calculatePathLength: jest.fn(() => 300),
   simplifyPolyline: jest.fn((points) => points),
+  parsePolyline: jest.fn(() => []),
+  resamplePolylineByCount: jest.fn(() => []),
+  comparePaths: jest.fn(() => null),
   getNearestPointOnPath: jest.fn(() => ({ distanceMeters: 0 })),
   addListener: jest.fn(() => ({ remove: jest.fn() })),
 });
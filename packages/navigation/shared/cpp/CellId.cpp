@@ -0,0 +1,241 @@
+#include "CellId.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace gaodemap {
+
+static constexpr double kCellIdPi = 3.14159265358979323846;
+static constexpr double kCellIdMaxLatitude = 85.05112878;
+static constexpr double kCellIdEarthRadiusMeters = 6371000.0;
+static constexpr double kCellIdLeafCount = static_cast<double>(uint64_t(1) << CellId::kMaxLevel);
+
+static inline double cellId_mercatorY01(double lat) {
+    const double clamped = std::max(-kCellIdMaxLatitude, std::min(kCellIdMaxLatitude, lat));
+    // asinh(tan φ) = atanh(sin φ)，与 GeometryEngine 的投影保持一致
+    const double s = std::sin(clamped * kCellIdPi / 180.0);
+    return 0.5 - std::log1p(2.0 * s / (1.0 - s)) / (4.0 * kCellIdPi);
+}
+
+static inline double cellId_latitudeAtY01(double y01) {
+    return std::atan(std::sinh(kCellIdPi * (1.0 - 2.0 * y01))) * 180.0 / kCellIdPi;
+}
+
+static inline uint32_t cellId_leafIndex(double unit) {
+    const double scaled = std::floor(unit * kCellIdLeafCount);
+    if (!(scaled > 0.0)) return 0;  // 同时处理 NaN
+    if (scaled >= kCellIdLeafCount) return static_cast<uint32_t>(kCellIdLeafCount - 1.0);
+    return static_cast<uint32_t>(scaled);
+}
+
+CellId CellId::fromLatLng(double lat, double lon, int level) {
+    if (!std::isfinite(lat) || !std::isfinite(lon)) return CellId();
+    double x01 = std::fmod(lon + 180.0, 360.0) / 360.0;
+    if (x01 < 0.0) x01 += 1.0;
+    const CellId leaf = fromTile(cellId_leafIndex(x01), cellId_leafIndex(cellId_mercatorY01(lat)), kMaxLevel);
+    return leaf.parent(std::max(0, std::min(kMaxLevel, level)));
+}
+
+PathBounds CellId::bounds() const {
+    const double size = std::ldexp(1.0, -level());
+    const double x0 = tileX() * size;
+    const double y0 = tileY() * size;
+
+    PathBounds result;
+    result.west = x0 * 360.0 - 180.0;
+    result.east = (x0 + size) * 360.0 - 180.0;
+    result.north = cellId_latitudeAtY01(y0);
+    result.south = cellId_latitudeAtY01(y0 + size);
+    result.centerLat = cellId_latitudeAtY01(y0 + size * 0.5);
+    result.centerLon = (x0 + size * 0.5) * 360.0 - 180.0;
+    return result;
+}
+
+// 区域与网格的关系
+enum class CellIdRelation {
+    Disjoint,
+    Intersects,
+    Contains  // 网格完全落在区域内
+};
+
+// 逐级细分覆盖，relate 判断区域与网格的关系（允许把不相交误判为相交，但不能反过来）
+template <typename Relate>
+static std::vector<CellId> cellId_cover(int maxLevel, size_t maxCells, Relate relate) {
+    maxLevel = std::max(0, std::min(CellId::kMaxLevel, maxLevel));
+    maxCells = std::max<size_t>(1, maxCells);
+
+    std::vector<CellId> result;
+    std::vector<CellId> frontier;
+    const CellId root = CellId::fromTile(0, 0, 0);
+    if (relate(root) == CellIdRelation::Disjoint) {
+        return result;
+    }
+    frontier.push_back(root);
+
+    std::vector<CellId> next;
+    CellId children[4];
+    while (!frontier.empty()) {
+        next.clear();
+        for (size_t i = 0; i < frontier.size(); ++i) {
+            const CellId cell = frontier[i];
+            if (cell.level() >= maxLevel || relate(cell) == CellIdRelation::Contains) {
+                result.push_back(cell);
+                continue;
+            }
+            int childCount = 0;
+            for (int k = 0; k < 4; ++k) {
+                const CellId child = cell.child(k);
+                if (relate(child) != CellIdRelation::Disjoint) {
+                    children[childCount++] = child;
+                }
+            }
+            // 本网格之后尚未处理的网格也要计入预算
+            const size_t pending = result.size() + next.size() + (frontier.size() - i - 1);
+            if (pending + static_cast<size_t>(childCount) > maxCells) {
+                result.push_back(cell);
+            } else {
+                next.insert(next.end(), children, children + childCount);
+            }
+        }
+        frontier.swap(next);
+    }
+
+    std::sort(result.begin(), result.end());
+    return result;
+}
+
+std::vector<CellId> coverBoundsWithCells(
+    double south,
+    double west,
+    double north,
+    double east,
+    int maxLevel,
+    size_t maxCells
+) {
+    if (!std::isfinite(south) || !std::isfinite(west) || !std::isfinite(north) || !std::isfinite(east)) {
+        return {};
+    }
+    if (south > north) std::swap(south, north);
+    const double minY = cellId_mercatorY01(north);
+    const double maxY = cellId_mercatorY01(south);
+
+    // Mercator x 区间：跨度 >= 360° 时为整圈，west > east 时跨 180° 经线拆成两段
+    double ranges[2][2];
+    int rangeCount = 0;
+    if (east - west >= 360.0) {
+        ranges[rangeCount][0] = 0.0;
+        ranges[rangeCount][1] = 1.0;
+        ++rangeCount;
+    } else {
+        // 西边界归一化到 [-180, 180)，东边界归一化到 (-180, 180]
+        const double minX = (west - 360.0 * std::floor((west + 180.0) / 360.0) + 180.0) / 360.0;
+        const double maxX = (east - 360.0 * std::ceil((east - 180.0) / 360.0) + 180.0) / 360.0;
+        if (minX <= maxX) {
+            ranges[rangeCount][0] = minX;
+            ranges[rangeCount][1] = maxX;
+            ++rangeCount;
+        } else {
+            ranges[rangeCount][0] = minX;
+            ranges[rangeCount][1] = 1.0;
+            ++rangeCount;
+            ranges[rangeCount][0] = 0.0;
+            ranges[rangeCount][1] = maxX;
+            ++rangeCount;
+        }
+    }
+
+    // 网格为半开区间 [x0, x0 + size)，与 fromLatLng 的取整方式一致
+    auto relate = [&](CellId cell) {
+        const double size = std::ldexp(1.0, -cell.level());
+        const double x0 = cell.tileX() * size;
+        const double y0 = cell.tileY() * size;
+        if (!(y0 <= maxY && minY < y0 + size)) return CellIdRelation::Disjoint;
+        const bool yInside = minY <= y0 && y0 + size <= maxY;
+        for (int r = 0; r < rangeCount; ++r) {
+            if (x0 <= ranges[r][1] && ranges[r][0] < x0 + size) {
+                const bool xInside = ranges[r][0] <= x0 && x0 + size <= ranges[r][1];
+                return (xInside && yInside) ? CellIdRelation::Contains : CellIdRelation::Intersects;
+            }
+        }
+        return CellIdRelation::Disjoint;
+    };
+    return cellId_cover(maxLevel, maxCells, relate);
+}
+
+// 点到经纬度矩形（不跨 180° 经线）的球面距离（米）
+// 圆心经度在矩形经度范围内时，最近点在同一条经线上，纬度截断即可；
+// 否则最近点在东西两条经线边上（纬线边上的距离随经差单调增大，最小值落在角点）。
+// 经线边上纬度 φ 处与点的夹角余弦为 cos(φ - φ*)，φ* = atan2(sinφ₀, cosφ₀·cosΔλ)，
+// 区间上的最近点只可能是 φ*（落在区间内时）或两个端点
+static double cellId_distanceToBounds(double lat, double lon, const PathBounds& b) {
+    if (lon >= b.west && lon <= b.east) {
+        return calculateDistance(lat, lon, std::max(b.south, std::min(b.north, lat)), lon);
+    }
+    const double phi = lat * kCellIdPi / 180.0;
+    auto toMeridian = [&](double edgeLon) {
+        const double dLon = (edgeLon - lon) * kCellIdPi / 180.0;
+        const double extremal = std::atan2(std::sin(phi), std::cos(phi) * std::cos(dLon)) * 180.0 / kCellIdPi;
+        const double nearest = std::max(b.south, std::min(b.north, extremal));
+        return std::min({
+            calculateDistance(lat, lon, nearest, edgeLon),
+            calculateDistance(lat, lon, b.south, edgeLon),
+            calculateDistance(lat, lon, b.north, edgeLon)
+        });
+    };
+    return std::min(toMeridian(b.west), toMeridian(b.east));
+}
+
+std::vector<CellId> coverCircleWithCells(
+    double centerLat,
+    double centerLon,
+    double radiusMeters,
+    int maxLevel,
+    size_t maxCells
+) {
+    if (!std::isfinite(centerLat) || !std::isfinite(centerLon) || !std::isfinite(radiusMeters) || radiusMeters < 0.0) {
+        return {};
+    }
+    const double lon = centerLon - 360.0 * std::floor((centerLon + 180.0) / 360.0);
+
+    auto relate = [&](CellId cell) {
+        const PathBounds b = cell.bounds();
+        // 圆心到经纬度矩形的球面距离，0.01 米容差只用于吸收浮点误差
+        if (cellId_distanceToBounds(centerLat, lon, b) > radiusMeters + 0.01) {
+            return CellIdRelation::Disjoint;
+        }
+        const bool inside =
+            calculateDistance(centerLat, lon, b.north, b.west) <= radiusMeters &&
+            calculateDistance(centerLat, lon, b.north, b.east) <= radiusMeters &&
+            calculateDistance(centerLat, lon, b.south, b.west) <= radiusMeters &&
+            calculateDistance(centerLat, lon, b.south, b.east) <= radiusMeters;
+        return inside ? CellIdRelation::Contains : CellIdRelation::Intersects;
+    };
+    return cellId_cover(maxLevel, maxCells, relate);
+}
+
+std::vector<CellIdRange> cellIdRanges(const std::vector<CellId>& cells) {
+    std::vector<CellIdRange> ranges;
+    ranges.reserve(cells.size());
+    for (const CellId& cell : cells) {
+        if (cell.isValid()) {
+            ranges.push_back({cell.rangeMin(), cell.rangeMax()});
+        }
+    }
+    std::sort(ranges.begin(), ranges.end(), [](const CellIdRange& a, const CellIdRange& b) {
+        return a.min < b.min;
+    });
+
+    // 合并重叠或首尾相接的区间（相邻叶子 id 相差 2）
+    size_t merged = 0;
+    for (size_t i = 0; i < ranges.size(); ++i) {
+        if (merged > 0 && ranges[i].min <= ranges[merged - 1].max + 2) {
+            ranges[merged - 1].max = std::max(ranges[merged - 1].max, ranges[i].max);
+        } else {
+            ranges[merged++] = ranges[i];
+        }
+    }
+    ranges.resize(merged);
+    return ranges;
+}
+
+}
@@ -0,0 +1,364 @@
+#include "CollisionEngine.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <iterator>
+
+namespace gaodemap {
+
+static constexpr double kCollisionZoomEpsilon = 1e-9;
+
+static inline uint64_t collision_cellKey(int64_t cx, int64_t cy) {
+    // 不同网格偶尔映射到同一键只会多出候选矩形，最终以矩形相交判断为准
+    return (static_cast<uint64_t>(cx) * 0x9E3779B97F4A7C15ULL) ^ static_cast<uint64_t>(cy);
+}
+
+static inline bool collision_overlaps(double aMinX, double aMinY, double aMaxX, double aMaxY,
+                                      double bMinX, double bMinY, double bMaxX, double bMaxY) {
+    // 仅接触边界不算碰撞
+    return aMinX < bMaxX && bMinX < aMaxX && aMinY < bMaxY && bMinY < aMaxY;
+}
+
+CollisionEngine::CollisionEngine(float cellSize)
+    : cellSize((std::isfinite(cellSize) && cellSize >= 1.0f) ? cellSize : 64.0f) {}
+
+void CollisionEngine::setItems(const std::vector<CollisionItem>& items) {
+    entries.clear();
+    entries.reserve(items.size());
+    anchors.clear();
+    anchors.reserve(items.size());
+
+    std::vector<double> xs(items.size());
+    std::vector<double> ys(items.size());
+    std::vector<GeoPoint> points;
+    points.reserve(items.size());
+    for (const auto& item : items) {
+        points.push_back({item.lat, item.lon});
+    }
+    // zoom 0 的世界像素 / 256 即归一化世界坐标，缩放后只需乘以世界尺寸
+    latLngToPixels(CoordSpan(points), 0.0, xs.data(), ys.data());
+
+    auto sanitizeSize = [](float value) {
+        return (std::isfinite(value) && value > 0.0f) ? value : 0.0f;
+    };
+    for (size_t i = 0; i < items.size(); ++i) {
+        Entry entry;
+        entry.item = items[i];
+        CollisionItem& item = entry.item;
+        item.width = sanitizeSize(item.width);
+        item.height = sanitizeSize(item.height);
+        item.padding = sanitizeSize(item.padding);
+        item.labelWidth = sanitizeSize(item.labelWidth);
+        item.labelHeight = sanitizeSize(item.labelHeight);
+        item.labelGap = sanitizeSize(item.labelGap);
+        if (!std::isfinite(item.anchorX)) item.anchorX = 0.5f;
+        if (!std::isfinite(item.anchorY)) item.anchorY = 1.0f;
+        entry.x = 0.0;
+        entry.y = 0.0;
+        entry.placedX = 0.0;
+        entry.markerBox = {0.0, 0.0, 0.0, 0.0};
+        entry.labelBox = {0.0, 0.0, 0.0, 0.0};
+        entry.label = LabelPlacement::None;
+        entries.push_back(entry);
+
+        const Rect offsets = markerRect(entry, 0.0, 0.0);
+        anchors.push_back({
+            xs[i] / 256.0,
+            ys[i] / 256.0,
+            static_cast<float>(offsets.minX),
+            static_cast<float>(offsets.minY),
+            static_cast<float>(offsets.maxX),
+            static_cast<float>(offsets.maxY),
+            0
+        });
+    }
+    grid.clear();
+    layoutValid = false;
+}
+
+CollisionEngine::Rect CollisionEngine::markerRect(const Entry& entry, double x, double y) const {
+    const CollisionItem& item = entry.item;
+    const double minX = x - item.anchorX * item.width - item.padding;
+    const double minY = y - item.anchorY * item.height - item.padding;
+    return {minX, minY, minX + item.width + 2.0 * item.padding, minY + item.height + 2.0 * item.padding};
+}
+
+CollisionEngine::Rect CollisionEngine::labelRect(const Entry& entry, const Rect& marker, LabelPlacement placement) const {
+    const CollisionItem& item = entry.item;
+    // 以不含 padding 的标记矩形为基准摆放标注
+    const double left = marker.minX + item.padding;
+    const double top = marker.minY + item.padding;
+    const double right = marker.maxX - item.padding;
+    const double bottom = marker.maxY - item.padding;
+    const double centerX = (left + right) * 0.5;
+    const double centerY = (top + bottom) * 0.5;
+    const double w = item.labelWidth;
+    const double h = item.labelHeight;
+    const double gap = item.labelGap;
+
+    double minX = 0.0;
+    double minY = 0.0;
+    switch (placement) {
+        case LabelPlacement::Right:
+            minX = right + gap;
+            minY = centerY - h * 0.5;
+            break;
+        case LabelPlacement::Left:
+            minX = left - gap - w;
+            minY = centerY - h * 0.5;
+            break;
+        case LabelPlacement::Bottom:
+            minX = centerX - w * 0.5;
+            minY = bottom + gap;
+            break;
+        case LabelPlacement::Top:
+        default:
+            minX = centerX - w * 0.5;
+            minY = top - gap - h;
+            break;
+    }
+    return {minX - item.padding, minY - item.padding, minX + w + item.padding, minY + h + item.padding};
+}
+
+bool CollisionEngine::collides(const Rect& rect) const {
+    const int64_t cx0 = static_cast<int64_t>(std::floor(rect.minX / cellSize));
+    const int64_t cx1 = static_cast<int64_t>(std::floor(rect.maxX / cellSize));
+    const int64_t cy0 = static_cast<int64_t>(std::floor(rect.minY / cellSize));
+    const int64_t cy1 = static_cast<int64_t>(std::floor(rect.maxY / cellSize));
+    for (int64_t cy = cy0; cy <= cy1; ++cy) {
+        for (int64_t cx = cx0; cx <= cx1; ++cx) {
+            auto found = grid.find(collision_cellKey(cx, cy));
+            if (found == grid.end()) continue;
+            for (uint32_t box : found->second) {
+                const Entry& other = entries[box >> 1];
+                const Rect& r = (box & 1) ? other.labelBox : other.markerBox;
+                if (collision_overlaps(rect.minX, rect.minY, rect.maxX, rect.maxY, r.minX, r.minY, r.maxX, r.maxY)) {
+                    return true;
+                }
+            }
+        }
+    }
+    return false;
+}
+
+void CollisionEngine::insertBox(uint32_t box, const Rect& rect) {
+    const int64_t cx0 = static_cast<int64_t>(std::floor(rect.minX / cellSize));
+    const int64_t cx1 = static_cast<int64_t>(std::floor(rect.maxX / cellSize));
+    const int64_t cy0 = static_cast<int64_t>(std::floor(rect.minY / cellSize));
+    const int64_t cy1 = static_cast<int64_t>(std::floor(rect.maxY / cellSize));
+    for (int64_t cy = cy0; cy <= cy1; ++cy) {
+        for (int64_t cx = cx0; cx <= cx1; ++cx) {
+            grid[collision_cellKey(cx, cy)].push_back(box);
+        }
+    }
+}
+
+void CollisionEngine::removeBox(uint32_t box, const Rect& rect) {
+    const int64_t cx0 = static_cast<int64_t>(std::floor(rect.minX / cellSize));
+    const int64_t cx1 = static_cast<int64_t>(std::floor(rect.maxX / cellSize));
+    const int64_t cy0 = static_cast<int64_t>(std::floor(rect.minY / cellSize));
+    const int64_t cy1 = static_cast<int64_t>(std::floor(rect.maxY / cellSize));
+    for (int64_t cy = cy0; cy <= cy1; ++cy) {
+        for (int64_t cx = cx0; cx <= cx1; ++cx) {
+            auto found = grid.find(collision_cellKey(cx, cy));
+            if (found == grid.end()) continue;
+            auto& boxes = found->second;
+            auto it = std::find(boxes.begin(), boxes.end(), box);
+            if (it != boxes.end()) {
+                *it = boxes.back();
+                boxes.pop_back();
+            }
+            if (boxes.empty()) {
+                grid.erase(found);
+            }
+        }
+    }
+}
+
+bool CollisionEngine::tryPlace(uint32_t index) {
+    Entry& entry = entries[index];
+    const Rect marker = markerRect(entry, entry.x, entry.y);
+    if (collides(marker)) {
+        return false;
+    }
+
+    // 标注依次尝试右、左、下、上，都放不下时只显示标记
+    LabelPlacement label = LabelPlacement::None;
+    Rect labelBox = {0.0, 0.0, 0.0, 0.0};
+    if (entry.item.labelWidth > 0.0f && entry.item.labelHeight > 0.0f) {
+        static const LabelPlacement kCandidates[] = {
+            LabelPlacement::Right, LabelPlacement::Left, LabelPlacement::Bottom, LabelPlacement::Top
+        };
+        for (LabelPlacement candidate : kCandidates) {
+            const Rect rect = labelRect(entry, marker, candidate);
+            if (!collides(rect)) {
+                label = candidate;
+                labelBox = rect;
+                break;
+            }
+        }
+    }
+
+    entry.markerBox = marker;
+    entry.labelBox = labelBox;
+    entry.label = label;
+    entry.placedX = entry.x;
+    anchors[index].flags |= kPlaced;
+    insertBox(index * 2, marker);
+    if (label != LabelPlacement::None) {
+        insertBox(index * 2 + 1, labelBox);
+    }
+    return true;
+}
+
+void CollisionEngine::unplace(uint32_t index) {
+    if (!(anchors[index].flags & kPlaced)) return;
+    Entry& entry = entries[index];
+    removeBox(index * 2, entry.markerBox);
+    if (entry.label != LabelPlacement::None) {
+        removeBox(index * 2 + 1, entry.labelBox);
+    }
+    entry.label = LabelPlacement::None;
+    anchors[index].flags &= static_cast<uint8_t>(~kPlaced);
+}
+
+void CollisionEngine::clearLayout() {
+    grid.clear();
+    for (auto& entry : entries) {
+        entry.label = LabelPlacement::None;
+    }
+    for (auto& anchor : anchors) {
+        anchor.flags = 0;
+    }
+}
+
+CollisionUpdate CollisionEngine::update(const ScreenViewport& viewport) {
+    CollisionUpdate result;
+    const bool relayout = !layoutValid ||
+        std::abs(viewport.zoom - layoutZoom) > kCollisionZoomEpsilon ||
+        viewport.width != layoutWidth ||
+        viewport.height != layoutHeight ||
+        viewport.margin != layoutMargin;
+    if (relayout) {
+        clearLayout();
+        layoutValid = true;
+        layoutZoom = viewport.zoom;
+        layoutWidth = viewport.width;
+        layoutHeight = viewport.height;
+        layoutMargin = viewport.margin;
+        worldSize = std::exp2(viewport.zoom) * 256.0;
+    }
+    result.fullLayout = relayout;
+
+    const double viewMinX = viewport.originX - viewport.margin;
+    const double viewMinY = viewport.originY - viewport.margin;
+    const double viewMaxX = viewport.originX + viewport.width + viewport.margin;
+    const double viewMaxY = viewport.originY + viewport.height + viewport.margin;
+    // 视口中心归一化到 [0, worldSize) 后，每个标记只需比较一次即可选出最近的世界副本
+    const double centerX = viewport.originX + viewport.width * 0.5;
+    const double wrappedCenterX = centerX - worldSize * std::floor(centerX / worldSize);
+    const double copyOffset = centerX - wrappedCenterX;
+    const double halfWorld = worldSize * 0.5;
+
+    // 1. 投影（只需乘法），移除离开视口或切换了世界副本的标记，收集待放置的标记
+    // 上次已在视口内但被遮挡的标记，只有与本次移除的标记（腾出的空间）相交时才需要重试
+    candidates.clear();
+    blocked.clear();
+    releasedRects.clear();
+    for (uint32_t i = 0; i < anchors.size(); ++i) {
+        Anchor& anchor = anchors[i];
+        double x = anchor.worldX * worldSize;
+        const double y = anchor.worldY * worldSize;
+        if (!std::isfinite(x) || !std::isfinite(y)) continue;
+        const double d = x - wrappedCenterX;
+        if (d > halfWorld) {
+            x -= worldSize;
+        } else if (d < -halfWorld) {
+            x += worldSize;
+        }
+        x += copyOffset;
+
+        const bool inView = collision_overlaps(x + anchor.minDX, y + anchor.minDY, x + anchor.maxDX, y + anchor.maxDY,
+                                               viewMinX, viewMinY, viewMaxX, viewMaxY);
+        const uint8_t flags = anchor.flags;
+        if (!inView && flags == 0) continue;  // 绝大多数视口外的标记到此为止
+
+        Entry& entry = entries[i];
+        const bool wasInView = (flags & kInView) != 0;
+        const bool sameCopy = entry.x == x;
+        entry.x = x;
+        entry.y = y;
+        anchor.flags = inView ? (flags | kInView) : (flags & static_cast<uint8_t>(~kInView));
+        if (flags & kPlaced) {
+            if (inView && entry.placedX == x) {
+                continue;  // 平移时保留已放置的标记
+            }
+            // 记录腾出的区域（标记与标注的外包矩形）
+            Rect freed = entry.markerBox;
+            if (entry.label != LabelPlacement::None) {
+                freed.minX = std::min(freed.minX, entry.labelBox.minX);
+                freed.minY = std::min(freed.minY, entry.labelBox.minY);
+                freed.maxX = std::max(freed.maxX, entry.labelBox.maxX);
+                freed.maxY = std::max(freed.maxY, entry.labelBox.maxY);
+            }
+            releasedRects.push_back(freed);
+            unplace(i);
+        }
+        if (inView) {
+            (wasInView && sameCopy ? blocked : candidates).push_back(i);
+        }
+    }
+    if (!releasedRects.empty()) {
+        for (uint32_t index : blocked) {
+            const Entry& entry = entries[index];
+            // 被遮挡的是标记本身，只有标记矩形所在区域腾出空间时才可能放下
+            const Rect rect = markerRect(entry, entry.x, entry.y);
+            for (const Rect& freed : releasedRects) {
+                if (collision_overlaps(rect.minX, rect.minY, rect.maxX, rect.maxY, freed.minX, freed.minY, freed.maxX, freed.maxY)) {
+                    candidates.push_back(index);
+                    break;
+                }
+            }
+        }
+    }
+
+    // 2. 按优先级（相同时按 id）贪心放置
+    std::sort(candidates.begin(), candidates.end(), [this](uint32_t a, uint32_t b) {
+        const CollisionItem& ia = entries[a].item;
+        const CollisionItem& ib = entries[b].item;
+        if (ia.priority != ib.priority) return ia.priority > ib.priority;
+        return ia.id < ib.id;
+    });
+    for (uint32_t index : candidates) {
+        tryPlace(index);
+    }
+
+    // 3. 输出可见标记，并与上次结果比较得到 shown / hidden
+    for (size_t i = 0; i < entries.size(); ++i) {
+        if (!(anchors[i].flags & kPlaced)) continue;
+        const Entry& entry = entries[i];
+        result.visible.push_back({
+            entry.item.id,
+            static_cast<float>(entry.x - viewport.originX),
+            static_cast<float>(entry.y - viewport.originY),
+            entry.label
+        });
+    }
+    std::sort(result.visible.begin(), result.visible.end(), [](const CollisionPlacement& a, const CollisionPlacement& b) {
+        return a.id < b.id;
+    });
+
+    std::vector<int> visibleIds;
+    visibleIds.reserve(result.visible.size());
+    for (const auto& placement : result.visible) {
+        visibleIds.push_back(placement.id);
+    }
+    std::set_difference(visibleIds.begin(), visibleIds.end(), lastVisibleIds.begin(), lastVisibleIds.end(),
+                        std::back_inserter(result.shown));
+    std::set_difference(lastVisibleIds.begin(), lastVisibleIds.end(), visibleIds.begin(), visibleIds.end(),
+                        std::back_inserter(result.hidden));
+    lastVisibleIds.swap(visibleIds);
+    return result;
+}
+
+}
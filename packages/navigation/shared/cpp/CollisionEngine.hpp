@@ -0,0 +1,147 @@
+#pragma once
+
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+#include "GeometryEngine.hpp"
+
+namespace gaodemap {
+
+// 标注相对标记的位置
+enum class LabelPlacement : uint8_t {
+    None = 0,    // 未显示标注
+    Right = 1,
+    Left = 2,
+    Bottom = 3,
+    Top = 4
+};
+
+struct CollisionItem {
+    int id;                  // 调用方标识（如标记下标）
+    double lat;              // 锚点纬度
+    double lon;              // 锚点经度
+    float width;             // 标记宽度（像素）
+    float height;            // 标记高度（像素）
+    float anchorX = 0.5f;    // 锚点在标记内的相对位置，默认底部中心
+    float anchorY = 1.0f;
+    float padding = 0.0f;    // 碰撞检测时四周外扩的像素
+    int priority = 0;        // 越大越优先显示
+    float labelWidth = 0.0f;   // 标注尺寸，<= 0 表示没有标注
+    float labelHeight = 0.0f;
+    float labelGap = 2.0f;     // 标注与标记的间距（像素）
+};
+
+struct CollisionPlacement {
+    int id;
+    float screenX;           // 锚点的屏幕坐标（相对视口左上角）
+    float screenY;
+    LabelPlacement label;    // 标注位置，None 表示标注因碰撞被隐藏
+};
+
+struct CollisionUpdate {
+    std::vector<int> shown;                     // 本次新显示的标记 id
+    std::vector<int> hidden;                    // 本次隐藏的标记 id
+    std::vector<CollisionPlacement> visible;    // 当前全部可见标记，按 id 升序
+    bool fullLayout = false;                    // 是否进行了完整重排
+};
+
+/**
+ * 屏幕空间标记避让引擎
+ * 按优先级贪心放置视口内的标记（及其标注），与已放置的矩形相交的标记被隐藏；
+ * 矩形存放在以世界像素为坐标的均匀网格中，单次碰撞查询只检查所覆盖网格内的矩形
+ *
+ * 增量更新：缩放级别不变时（平移），已放置的标记相对位置不变，继续保留并沿用网格索引，
+ * 只移除离开视口的标记，再按优先级尝试放置新进入视口或之前被遮挡的标记，避免平移时标记闪烁；
+ * 缩放级别、视口尺寸或标记集合变化时完整重排
+ *
+ * 与 ClusterEngine 互补：用于不能合并点的 POI 图层
+ * 非线程安全，调用方需自行保证串行访问
+ */
+class CollisionEngine {
+public:
+    /**
+     * @param cellSize 网格边长（像素），取常见标记尺寸的 1-2 倍较合适
+     */
+    explicit CollisionEngine(float cellSize = 64.0f);
+
+    /**
+     * 替换全部标记，下次 update 时完整重排
+     */
+    void setItems(const std::vector<CollisionItem>& items);
+
+    /**
+     * 按视口计算可见标记
+     * @param viewport 视口（makeScreenViewport 构造），margin 为视口外仍参与放置的像素范围
+     * 缩放级别、视口尺寸或 margin 变化时完整重排，仅平移时增量更新
+     */
+    CollisionUpdate update(const ScreenViewport& viewport);
+
+    /**
+     * 下次 update 时强制完整重排
+     */
+    void invalidate() { layoutValid = false; }
+
+    size_t itemCount() const { return entries.size(); }
+
+private:
+    struct Rect {
+        double minX;
+        double minY;
+        double maxX;
+        double maxY;
+    };
+
+    // 每次 update 都要遍历的数据单独紧凑存放，视口外的标记不会访问 Entry
+    struct Anchor {
+        double worldX;           // 归一化世界坐标 (0-1)
+        double worldY;
+        float minDX;             // 标记矩形（含 padding）相对锚点的偏移
+        float minDY;
+        float maxDX;
+        float maxDY;
+        uint8_t flags;           // kPlaced | kInView
+    };
+
+    struct Entry {
+        CollisionItem item;
+        double x;                // 最近一次在视口内时锚点的世界像素坐标（已选定离视口最近的世界副本）
+        double y;
+        double placedX;          // 放置时锚点的世界像素 x，世界副本变化时需重新放置
+        Rect markerBox;
+        Rect labelBox;
+        LabelPlacement label;
+    };
+
+    static constexpr uint8_t kPlaced = 1;
+    static constexpr uint8_t kInView = 2;  // 上次 update 时在视口内
+
+    // 当前缩放级别下标记 / 标注的世界像素矩形（含 padding）
+    Rect markerRect(const Entry& entry, double x, double y) const;
+    Rect labelRect(const Entry& entry, const Rect& marker, LabelPlacement placement) const;
+    bool collides(const Rect& rect) const;
+    void insertBox(uint32_t box, const Rect& rect);
+    void removeBox(uint32_t box, const Rect& rect);
+    bool tryPlace(uint32_t index);
+    void unplace(uint32_t index);
+    void clearLayout();
+
+    float cellSize;
+    std::vector<Anchor> anchors;
+    std::vector<Entry> entries;
+    // 网格键 -> 矩形编号（标记下标 * 2 + 是否为标注）
+    std::unordered_map<uint64_t, std::vector<uint32_t>> grid;
+    std::vector<uint32_t> candidates;
+    std::vector<uint32_t> blocked;
+    std::vector<Rect> releasedRects;
+    std::vector<int> lastVisibleIds;  // 上次 update 的可见 id（升序），用于计算 shown / hidden
+
+    bool layoutValid = false;
+    double layoutZoom = 0.0;
+    double layoutWidth = 0.0;
+    double layoutHeight = 0.0;
+    double layoutMargin = 0.0;
+    double worldSize = 256.0;
+};
+
+}
@@ -1,154 +1,555 @@
 #include "ColorParser.hpp"
+
 #include <algorithm>
-#include <cctype>
-#include <sstream>
-#include <vector>
-#include <map>
 #include <cmath>
+#include <cstddef>
+#include <cstring>
 
 namespace gaodemap {
 
-static uint32_t argb(uint8_t a, uint8_t r, uint8_t g, uint8_t b) {
-    return (static_cast<uint32_t>(a) << 24) |
-           (static_cast<uint32_t>(r) << 16) |
-           (static_cast<uint32_t>(g) << 8) |
-           static_cast<uint32_t>(b);
-}
-
-static uint32_t parseHex(const std::string& hexStr) {
-    std::string cleanHex = hexStr;
-    if (cleanHex.empty()) return 0;
-    if (cleanHex[0] == '#') {
-        cleanHex = cleanHex.substr(1);
-    }
-
-    uint32_t val = 0;
-    try {
-        val = static_cast<uint32_t>(std::stoul(cleanHex, nullptr, 16));
-    } catch (...) {
-        return 0;
-    }
-
-    if (cleanHex.length() == 6) {
-        // RRGGBB -> 0xFFRRGGBB
-        return 0xFF000000 | val;
-    } else if (cleanHex.length() == 8) {
-        // AARRGGBB -> AARRGGBB (Android style)
-        // Wait, web usually uses #RRGGBBAA.
-        // Android Color.parseColor("#RRGGBB") or "#AARRGGBB".
-        // Let's assume Android style #AARRGGBB for consistency with existing Kotlin code.
-        return val;
-    } else if (cleanHex.length() == 3) {
-        // RGB -> RRGGBB
-        uint32_t r = (val >> 8) & 0xF;
-        uint32_t g = (val >> 4) & 0xF;
-        uint32_t b = val & 0xF;
-        return 0xFF000000 | (r << 20) | (r << 16) | (g << 12) | (g << 8) | (b << 4) | b;
-    } else if (cleanHex.length() == 4) {
-        // ARGB -> AARRGGBB
-        uint32_t a = (val >> 12) & 0xF;
-        uint32_t r = (val >> 8) & 0xF;
-        uint32_t g = (val >> 4) & 0xF;
-        uint32_t b = val & 0xF;
-        return (a << 28) | (a << 24) | (r << 20) | (r << 16) | (g << 12) | (g << 8) | (b << 4) | b;
-    }
-    
-    return 0;
-}
-
-static uint32_t parseRgba(const std::string& str) {
-    // rgba(r, g, b, a) or rgb(r, g, b)
-    bool hasAlpha = str.find("rgba") == 0;
-    size_t start = str.find('(');
-    size_t end = str.find(')');
-    if (start == std::string::npos || end == std::string::npos) return 0;
-
-    std::string content = str.substr(start + 1, end - start - 1);
-    std::stringstream ss(content);
-    std::string segment;
-    std::vector<std::string> parts;
-    
-    while (std::getline(ss, segment, ',')) {
-        parts.push_back(segment);
-    }
-
-    if (parts.size() < 3) return 0;
-
-    try {
-        int r = std::stoi(parts[0]);
-        int g = std::stoi(parts[1]);
-        int b = std::stoi(parts[2]);
-        int a = 255;
-
-        if (hasAlpha && parts.size() >= 4) {
-            float alphaFloat = std::stof(parts[3]);
-            a = static_cast<int>(alphaFloat * 255.0f);
-        }
+struct color_NamedColor {
+    std::string_view name;
+    uint32_t argb;
+};
 
-        return argb(
-            static_cast<uint8_t>(std::max(0, std::min(255, a))),
-            static_cast<uint8_t>(std::max(0, std::min(255, r))),
-            static_cast<uint8_t>(std::max(0, std::min(255, g))),
-            static_cast<uint8_t>(std::max(0, std::min(255, b)))
-        );
-    } catch (...) {
-        return 0;
-    }
-}
-
-static const std::map<std::string, uint32_t> NAMED_COLORS = {
-    {"red", 0xFFFF0000},
-    {"blue", 0xFF0000FF},
-    {"green", 0xFF00FF00},
-    {"yellow", 0xFFFFFF00},
-    {"black", 0xFF000000},
-    {"white", 0xFFFFFFFF},
-    {"gray", 0xFF888888},
-    {"grey", 0xFF888888},
-    {"cyan", 0xFF00FFFF},
-    {"magenta", 0xFFFF00FF},
+// CSS Color 4 命名颜色；green / gray / grey 沿用 Android Color.parseColor 的取值，与旧版本保持一致
+static constexpr color_NamedColor kColorNames[] = {
+    {"aliceblue", 0xFFF0F8FF}, {"antiquewhite", 0xFFFAEBD7}, {"aqua", 0xFF00FFFF}, {"aquamarine", 0xFF7FFFD4},
+    {"azure", 0xFFF0FFFF}, {"beige", 0xFFF5F5DC}, {"bisque", 0xFFFFE4C4}, {"black", 0xFF000000},
+    {"blanchedalmond", 0xFFFFEBCD}, {"blue", 0xFF0000FF}, {"blueviolet", 0xFF8A2BE2}, {"brown", 0xFFA52A2A},
+    {"burlywood", 0xFFDEB887}, {"cadetblue", 0xFF5F9EA0}, {"chartreuse", 0xFF7FFF00},
+    {"chocolate", 0xFFD2691E}, {"coral", 0xFFFF7F50}, {"cornflowerblue", 0xFF6495ED}, {"cornsilk", 0xFFFFF8DC},
+    {"crimson", 0xFFDC143C}, {"cyan", 0xFF00FFFF}, {"darkblue", 0xFF00008B}, {"darkcyan", 0xFF008B8B},
+    {"darkgoldenrod", 0xFFB8860B}, {"darkgray", 0xFFA9A9A9}, {"darkgreen", 0xFF006400},
+    {"darkgrey", 0xFFA9A9A9}, {"darkkhaki", 0xFFBDB76B}, {"darkmagenta", 0xFF8B008B},
+    {"darkolivegreen", 0xFF556B2F}, {"darkorange", 0xFFFF8C00}, {"darkorchid", 0xFF9932CC},
+    {"darkred", 0xFF8B0000}, {"darksalmon", 0xFFE9967A}, {"darkseagreen", 0xFF8FBC8F},
+    {"darkslateblue", 0xFF483D8B}, {"darkslategray", 0xFF2F4F4F}, {"darkslategrey", 0xFF2F4F4F},
+    {"darkturquoise", 0xFF00CED1}, {"darkviolet", 0xFF9400D3}, {"deeppink", 0xFFFF1493},
+    {"deepskyblue", 0xFF00BFFF}, {"dimgray", 0xFF696969}, {"dimgrey", 0xFF696969}, {"dodgerblue", 0xFF1E90FF},
+    {"firebrick", 0xFFB22222}, {"floralwhite", 0xFFFFFAF0}, {"forestgreen", 0xFF228B22},
+    {"fuchsia", 0xFFFF00FF}, {"gainsboro", 0xFFDCDCDC}, {"ghostwhite", 0xFFF8F8FF}, {"gold", 0xFFFFD700},
+    {"goldenrod", 0xFFDAA520}, {"gray", 0xFF888888}, {"green", 0xFF00FF00}, {"greenyellow", 0xFFADFF2F},
+    {"grey", 0xFF888888}, {"honeydew", 0xFFF0FFF0}, {"hotpink", 0xFFFF69B4}, {"indianred", 0xFFCD5C5C},
+    {"indigo", 0xFF4B0082}, {"ivory", 0xFFFFFFF0}, {"khaki", 0xFFF0E68C}, {"lavender", 0xFFE6E6FA},
+    {"lavenderblush", 0xFFFFF0F5}, {"lawngreen", 0xFF7CFC00}, {"lemonchiffon", 0xFFFFFACD},
+    {"lightblue", 0xFFADD8E6}, {"lightcoral", 0xFFF08080}, {"lightcyan", 0xFFE0FFFF},
+    {"lightgoldenrodyellow", 0xFFFAFAD2}, {"lightgray", 0xFFD3D3D3}, {"lightgreen", 0xFF90EE90},
+    {"lightgrey", 0xFFD3D3D3}, {"lightpink", 0xFFFFB6C1}, {"lightsalmon", 0xFFFFA07A},
+    {"lightseagreen", 0xFF20B2AA}, {"lightskyblue", 0xFF87CEFA}, {"lightslategray", 0xFF778899},
+    {"lightslategrey", 0xFF778899}, {"lightsteelblue", 0xFFB0C4DE}, {"lightyellow", 0xFFFFFFE0},
+    {"lime", 0xFF00FF00}, {"limegreen", 0xFF32CD32}, {"linen", 0xFFFAF0E6}, {"magenta", 0xFFFF00FF},
+    {"maroon", 0xFF800000}, {"mediumaquamarine", 0xFF66CDAA}, {"mediumblue", 0xFF0000CD},
+    {"mediumorchid", 0xFFBA55D3}, {"mediumpurple", 0xFF9370DB}, {"mediumseagreen", 0xFF3CB371},
+    {"mediumslateblue", 0xFF7B68EE}, {"mediumspringgreen", 0xFF00FA9A}, {"mediumturquoise", 0xFF48D1CC},
+    {"mediumvioletred", 0xFFC71585}, {"midnightblue", 0xFF191970}, {"mintcream", 0xFFF5FFFA},
+    {"mistyrose", 0xFFFFE4E1}, {"moccasin", 0xFFFFE4B5}, {"navajowhite", 0xFFFFDEAD}, {"navy", 0xFF000080},
+    {"oldlace", 0xFFFDF5E6}, {"olive", 0xFF808000}, {"olivedrab", 0xFF6B8E23}, {"orange", 0xFFFFA500},
+    {"orangered", 0xFFFF4500}, {"orchid", 0xFFDA70D6}, {"palegoldenrod", 0xFFEEE8AA},
+    {"palegreen", 0xFF98FB98}, {"paleturquoise", 0xFFAFEEEE}, {"palevioletred", 0xFFDB7093},
+    {"papayawhip", 0xFFFFEFD5}, {"peachpuff", 0xFFFFDAB9}, {"peru", 0xFFCD853F}, {"pink", 0xFFFFC0CB},
+    {"plum", 0xFFDDA0DD}, {"powderblue", 0xFFB0E0E6}, {"purple", 0xFF800080}, {"rebeccapurple", 0xFF663399},
+    {"red", 0xFFFF0000}, {"rosybrown", 0xFFBC8F8F}, {"royalblue", 0xFF4169E1}, {"saddlebrown", 0xFF8B4513},
+    {"salmon", 0xFFFA8072}, {"sandybrown", 0xFFF4A460}, {"seagreen", 0xFF2E8B57}, {"seashell", 0xFFFFF5EE},
+    {"sienna", 0xFFA0522D}, {"silver", 0xFFC0C0C0}, {"skyblue", 0xFF87CEEB}, {"slateblue", 0xFF6A5ACD},
+    {"slategray", 0xFF708090}, {"slategrey", 0xFF708090}, {"snow", 0xFFFFFAFA}, {"springgreen", 0xFF00FF7F},
+    {"steelblue", 0xFF4682B4}, {"tan", 0xFFD2B48C}, {"teal", 0xFF008080}, {"thistle", 0xFFD8BFD8},
+    {"tomato", 0xFFFF6347}, {"turquoise", 0xFF40E0D0}, {"violet", 0xFFEE82EE}, {"wheat", 0xFFF5DEB3},
+    {"white", 0xFFFFFFFF}, {"whitesmoke", 0xFFF5F5F5}, {"yellow", 0xFFFFFF00}, {"yellowgreen", 0xFF9ACD32},
     {"transparent", 0x00000000}
 };
 
-static bool isSpace(unsigned char ch) {
-    return std::isspace(ch) != 0;
+static constexpr size_t kColorNameCount = sizeof(kColorNames) / sizeof(kColorNames[0]);
+static constexpr size_t kColorHashSlots = 256;     // 2 的幂
+static constexpr size_t kColorHashBuckets = 64;
+static constexpr size_t kColorMaxBucketSize = 8;
+static constexpr uint64_t kColorHashBasis = 0xcbf29ce484222325ull;
+static constexpr uint64_t kColorHashPrime = 0x100000001b3ull;
+
+// FNV-1a，字母按小写参与计算
+static constexpr uint64_t color_hashName(std::string_view name) {
+    uint64_t hash = kColorHashBasis;
+    for (char ch : name) {
+        hash = (hash ^ static_cast<uint8_t>(ch | 0x20)) * kColorHashPrime;
+    }
+    return hash;
 }
 
-static char toLower(unsigned char ch) {
-    return static_cast<char>(std::tolower(ch));
+static constexpr size_t color_hashSlot(uint64_t hash, uint64_t displacement) {
+    return static_cast<size_t>(((hash >> 20) + displacement * ((hash >> 40) | 1)) & (kColorHashSlots - 1));
 }
 
-static bool isHexDigit(unsigned char ch) {
-    return std::isxdigit(ch) != 0;
+/**
+ * 命名颜色的完美哈希（hash and displace）：名字先按哈希分桶，每个桶选一个位移，
+ * 使桶内所有名字落到互不冲突的空槽位。查找只需一次哈希、一次查表和一次字符串比较
+ */
+struct color_PerfectHash {
+    uint16_t displacement[kColorHashBuckets];
+    uint8_t slots[kColorHashSlots];     // kColorNames 下标 + 1，0 表示空槽
+    size_t maxNameLength;
+    bool valid;
+};
+
+static constexpr color_PerfectHash color_buildPerfectHash() {
+    color_PerfectHash table{};
+    uint64_t hashes[kColorNameCount] = {};
+    uint16_t bucketStart[kColorHashBuckets + 1] = {};
+    uint16_t bucketFill[kColorHashBuckets] = {};
+    uint8_t members[kColorNameCount] = {};
+
+    for (size_t i = 0; i < kColorNameCount; ++i) {
+        hashes[i] = color_hashName(kColorNames[i].name);
+        ++bucketStart[hashes[i] % kColorHashBuckets + 1];
+        table.maxNameLength = std::max(table.maxNameLength, kColorNames[i].name.size());
+    }
+    for (size_t b = 0; b < kColorHashBuckets; ++b) {
+        if (bucketStart[b + 1] > kColorMaxBucketSize) return table;
+        bucketStart[b + 1] += bucketStart[b];
+    }
+    for (size_t i = 0; i < kColorNameCount; ++i) {
+        const size_t b = hashes[i] % kColorHashBuckets;
+        members[bucketStart[b] + bucketFill[b]++] = static_cast<uint8_t>(i);
+    }
+
+    // 大桶先放，空槽多时容易找到位移
+    for (size_t size = kColorMaxBucketSize; size > 0; --size) {
+        for (size_t b = 0; b < kColorHashBuckets; ++b) {
+            if (static_cast<size_t>(bucketStart[b + 1] - bucketStart[b]) != size) continue;
+            bool placed = false;
+            for (uint32_t d = 0; d <= 0xFFFF && !placed; ++d) {
+                size_t used[kColorMaxBucketSize] = {};
+                placed = true;
+                for (size_t k = 0; k < size && placed; ++k) {
+                    used[k] = color_hashSlot(hashes[members[bucketStart[b] + k]], d);
+                    if (table.slots[used[k]] != 0) placed = false;
+                    for (size_t j = 0; j < k; ++j) {
+                        if (used[j] == used[k]) placed = false;
+                    }
+                }
+                if (placed) {
+                    table.displacement[b] = static_cast<uint16_t>(d);
+                    for (size_t k = 0; k < size; ++k) {
+                        table.slots[used[k]] = static_cast<uint8_t>(members[bucketStart[b] + k] + 1);
+                    }
+                }
+            }
+            if (!placed) return table;
+        }
+    }
+    table.valid = true;
+    return table;
 }
 
-uint32_t parseColor(const std::string& colorString) {
-    std::string str = colorString;
-    // Remove whitespace
-    str.erase(std::remove_if(str.begin(), str.end(), [](unsigned char ch) {
-        return isSpace(ch);
-    }), str.end());
-    // Lowercase for named colors check
-    std::string lowerStr = str;
-    std::transform(lowerStr.begin(), lowerStr.end(), lowerStr.begin(), [](unsigned char ch) {
-        return toLower(ch);
-    });
+static constexpr color_PerfectHash kColorHash = color_buildPerfectHash();
+static_assert(kColorHash.valid, "named color perfect hash failed, enlarge kColorHashSlots");
 
-    if (NAMED_COLORS.count(lowerStr)) {
-        return NAMED_COLORS.at(lowerStr);
+static bool color_lookupName(std::string_view name, uint32_t& out) {
+    if (name.size() > kColorHash.maxNameLength) return false;
+    uint64_t hash = kColorHashBasis;
+    for (char ch : name) {
+        const char lower = static_cast<char>(ch | 0x20);
+        if (lower < 'a' || lower > 'z') return false;
+        hash = (hash ^ static_cast<uint8_t>(lower)) * kColorHashPrime;
     }
+    const size_t slot = color_hashSlot(hash, kColorHash.displacement[hash % kColorHashBuckets]);
+    const uint8_t entry = kColorHash.slots[slot];
+    if (entry == 0) return false;
+    const color_NamedColor& color = kColorNames[entry - 1];
+    if (color.name.size() != name.size()) return false;
+    for (size_t i = 0; i < name.size(); ++i) {
+        if (static_cast<char>(name[i] | 0x20) != color.name[i]) return false;
+    }
+    out = color.argb;
+    return true;
+}
+
+// 十六进制字符 -> 数值，非法字符为 0xFF
+struct color_HexTable {
+    uint8_t digit[256];
+};
 
-    if (lowerStr.find("rgb") == 0) {
-        return parseRgba(str); // pass original str with potential spaces if needed, but we removed them
+static constexpr color_HexTable color_buildHexTable() {
+    color_HexTable table{};
+    for (int i = 0; i < 256; ++i) table.digit[i] = 0xFF;
+    for (int i = 0; i < 10; ++i) table.digit['0' + i] = static_cast<uint8_t>(i);
+    for (int i = 0; i < 6; ++i) {
+        table.digit['a' + i] = static_cast<uint8_t>(10 + i);
+        table.digit['A' + i] = static_cast<uint8_t>(10 + i);
     }
+    return table;
+}
+
+static constexpr color_HexTable kColorHexDigits = color_buildHexTable();
+
+// 十六进制（CSS 顺序）：3 位 RGB、4 位 RGBA、6 位 RRGGBB、8 位 RRGGBBAA
+static bool color_parseHex(std::string_view hex, uint32_t& out) {
+    const size_t length = hex.size();
+    if (length != 3 && length != 4 && length != 6 && length != 8) return false;
 
-    if (lowerStr.find("#") == 0 || std::all_of(lowerStr.begin(), lowerStr.end(), [](unsigned char ch) {
-        return isHexDigit(ch);
-    })) {
-        return parseHex(str);
+    // 逐位查表累加，非法字符只记录标记，循环内没有分支
+    uint32_t value = 0;
+    uint32_t invalid = 0;
+    for (char ch : hex) {
+        const uint32_t digit = kColorHexDigits.digit[static_cast<uint8_t>(ch)];
+        invalid |= digit;
+        value = (value << 4) | (digit & 0xF);
+    }
+    if (invalid & 0xF0) return false;
+
+    // 先统一成 0xRRGGBBAA
+    if (length <= 4) {
+        if (length == 3) value = (value << 4) | 0xF;
+        // 0xRGBA -> 0x0R0G0B0A -> 0xRRGGBBAA
+        value = ((value & 0xF000) << 12) | ((value & 0x0F00) << 8) | ((value & 0x00F0) << 4) | (value & 0x000F);
+        value *= 0x11;
+    } else if (length == 6) {
+        value = (value << 8) | 0xFF;
+    }
+    out = (value >> 8) | (value << 24);
+    return true;
+}
+
+static inline bool color_isSpace(char ch) {
+    return ch == ' ' || (ch >= '\t' && ch <= '\r');
+}
+
+static inline bool color_isLetter(char ch) {
+    const char lower = static_cast<char>(ch | 0x20);
+    return lower >= 'a' && lower <= 'z';
+}
+
+static bool color_equalsIgnoreCase(std::string_view str, std::string_view lower) {
+    if (str.size() != lower.size()) return false;
+    for (size_t i = 0; i < lower.size(); ++i) {
+        if (static_cast<char>(str[i] | 0x20) != lower[i]) return false;
+    }
+    return true;
+}
+
+enum class color_Unit : uint8_t {
+    None,       // none 关键字，按 0 处理
+    Number,
+    Percent,
+    Degree,
+    Radian,
+    Gradian,
+    Turn
+};
+
+struct color_Component {
+    double value = 0.0;
+    color_Unit unit = color_Unit::Number;
+};
+
+// 函数格式参数的扫描器，只读取输入、不分配、不抛异常
+struct color_Scanner {
+    const char* p;
+    const char* end;
+
+    void skipSpaces() {
+        while (p < end && color_isSpace(*p)) ++p;
+    }
+
+    bool consume(char expected) {
+        skipSpaces();
+        if (p < end && *p == expected) {
+            ++p;
+            return true;
+        }
+        return false;
+    }
+
+    bool atEnd() {
+        skipSpaces();
+        return p == end;
+    }
+
+    // 十进制数：可带符号、小数与指数
+    bool number(double& value) {
+        skipSpaces();
+        const char* cursor = p;
+        bool negative = false;
+        if (cursor < end && (*cursor == '+' || *cursor == '-')) {
+            negative = *cursor == '-';
+            ++cursor;
+        }
+        double result = 0.0;
+        bool hasDigits = false;
+        while (cursor < end && *cursor >= '0' && *cursor <= '9') {
+            result = result * 10.0 + (*cursor - '0');
+            hasDigits = true;
+            ++cursor;
+        }
+        if (cursor < end && *cursor == '.') {
+            ++cursor;
+            double scale = 0.1;
+            while (cursor < end && *cursor >= '0' && *cursor <= '9') {
+                result += (*cursor - '0') * scale;
+                scale *= 0.1;
+                hasDigits = true;
+                ++cursor;
+            }
+        }
+        if (!hasDigits) return false;
+        if (cursor < end && (*cursor == 'e' || *cursor == 'E')) {
+            const char* exponentStart = cursor + 1;
+            bool exponentNegative = false;
+            if (exponentStart < end && (*exponentStart == '+' || *exponentStart == '-')) {
+                exponentNegative = *exponentStart == '-';
+                ++exponentStart;
+            }
+            if (exponentStart < end && *exponentStart >= '0' && *exponentStart <= '9') {
+                int exponent = 0;
+                cursor = exponentStart;
+                while (cursor < end && *cursor >= '0' && *cursor <= '9') {
+                    exponent = std::min(exponent * 10 + (*cursor - '0'), 400);
+                    ++cursor;
+                }
+                for (; exponent > 0; --exponent) result = exponentNegative ? result * 0.1 : result * 10.0;
+            }
+        }
+        value = negative ? -result : result;
+        p = cursor;
+        return true;
+    }
+
+    // 一个分量：数值（可带 % 或角度单位）或 none
+    bool component(color_Component& out) {
+        skipSpaces();
+        if (p < end && color_isLetter(*p)) {
+            const char* start = p;
+            while (p < end && color_isLetter(*p)) ++p;
+            if (!color_equalsIgnoreCase(std::string_view(start, p - start), "none")) return false;
+            out.value = 0.0;
+            out.unit = color_Unit::None;
+            return true;
+        }
+        if (!number(out.value)) return false;
+        out.unit = color_Unit::Number;
+        if (p < end && *p == '%') {
+            ++p;
+            out.unit = color_Unit::Percent;
+        } else if (p < end && color_isLetter(*p)) {
+            const char* start = p;
+            while (p < end && color_isLetter(*p)) ++p;
+            const std::string_view unit(start, p - start);
+            if (color_equalsIgnoreCase(unit, "deg")) out.unit = color_Unit::Degree;
+            else if (color_equalsIgnoreCase(unit, "rad")) out.unit = color_Unit::Radian;
+            else if (color_equalsIgnoreCase(unit, "grad")) out.unit = color_Unit::Gradian;
+            else if (color_equalsIgnoreCase(unit, "turn")) out.unit = color_Unit::Turn;
+            else return false;
+        }
+        return true;
     }
+};
+
+/**
+ * 读取函数参数：逗号分隔的旧语法（第 4 个分量为透明度），
+ * 或 CSS Color 4 的空格分隔语法（透明度在 / 之后）
+ */
+static bool color_parseArguments(color_Scanner& scanner, color_Component (&components)[4], bool& hasAlpha) {
+    if (!scanner.consume('(')) return false;
+    if (!scanner.component(components[0])) return false;
+    const bool legacy = scanner.consume(',');
+    if (!scanner.component(components[1])) return false;
+    if (legacy && !scanner.consume(',')) return false;
+    if (!scanner.component(components[2])) return false;
+    hasAlpha = scanner.consume(legacy ? ',' : '/');
+    if (hasAlpha && !scanner.component(components[3])) return false;
+    return scanner.consume(')') && scanner.atEnd();
+}
+
+static inline double color_clamp01(double value) {
+    // NaN 落到 0
+    return std::min(1.0, std::max(0.0, value));
+}
+
+// 0 ~ 1 的分量 -> 0 ~ 255，按 CSS 规定四舍五入
+static inline uint32_t color_byte(double unit) {
+    return static_cast<uint32_t>(color_clamp01(unit) * 255.0 + 0.5);
+}
+
+// rgb 分量：数值为 0 ~ 255，百分比为 0% ~ 100%
+static bool color_rgbChannel(const color_Component& component, double& out) {
+    switch (component.unit) {
+        case color_Unit::None: out = 0.0; return true;
+        case color_Unit::Number: out = component.value / 255.0; return true;
+        case color_Unit::Percent: out = component.value / 100.0; return true;
+        default: return false;
+    }
+}
+
+// 透明度：数值为 0 ~ 1，百分比为 0% ~ 100%
+static bool color_alpha(const color_Component& component, double& out) {
+    switch (component.unit) {
+        case color_Unit::None: out = 0.0; return true;
+        case color_Unit::Number: out = component.value; return true;
+        case color_Unit::Percent: out = component.value / 100.0; return true;
+        default: return false;
+    }
+}
+
+// 色相（度）：无单位数值按度处理
+static bool color_hue(const color_Component& component, double& out) {
+    switch (component.unit) {
+        case color_Unit::None: out = 0.0; return true;
+        case color_Unit::Number:
+        case color_Unit::Degree: out = component.value; return true;
+        case color_Unit::Radian: out = component.value * 57.29577951308232; return true;
+        case color_Unit::Gradian: out = component.value * 0.9; return true;
+        case color_Unit::Turn: out = component.value * 360.0; return true;
+        default: return false;
+    }
+}
+
+// 饱和度、亮度、白度、黑度：百分比，新语法也允许 0 ~ 100 的数值
+static bool color_percentage(const color_Component& component, double& out) {
+    switch (component.unit) {
+        case color_Unit::None: out = 0.0; return true;
+        case color_Unit::Number:
+        case color_Unit::Percent: out = color_clamp01(component.value / 100.0); return true;
+        default: return false;
+    }
+}
+
+// CSS Color 4 的 hsl -> sRGB 换算，结果为 0 ~ 1
+static void color_hslToRgb(double hue, double saturation, double lightness, double (&rgb)[3]) {
+    hue = std::fmod(hue, 360.0);
+    if (hue < 0.0) hue += 360.0;
+    const double a = saturation * std::min(lightness, 1.0 - lightness);
+    const double offsets[3] = {0.0, 8.0, 4.0};
+    for (int i = 0; i < 3; ++i) {
+        const double k = std::fmod(offsets[i] + hue / 30.0, 12.0);
+        rgb[i] = lightness - a * std::max(-1.0, std::min(std::min(k - 3.0, 9.0 - k), 1.0));
+    }
+}
+
+enum class color_Function : uint8_t {
+    Unknown,
+    Rgb,
+    Hsl,
+    Hwb
+};
+
+// rgba / hsla 是 rgb / hsl 的别名，两者都可带透明度
+static color_Function color_functionNamed(std::string_view name) {
+    if (color_equalsIgnoreCase(name, "rgb") || color_equalsIgnoreCase(name, "rgba")) return color_Function::Rgb;
+    if (color_equalsIgnoreCase(name, "hsl") || color_equalsIgnoreCase(name, "hsla")) return color_Function::Hsl;
+    if (color_equalsIgnoreCase(name, "hwb")) return color_Function::Hwb;
+    return color_Function::Unknown;
+}
+
+static bool color_parseFunction(color_Function function, color_Scanner scanner, uint32_t& out) {
+    color_Component components[4];
+    bool hasAlpha = false;
+    if (!color_parseArguments(scanner, components, hasAlpha)) return false;
+
+    double alpha = 1.0;
+    if (hasAlpha && !color_alpha(components[3], alpha)) return false;
+
+    double rgb[3];
+    if (function == color_Function::Rgb) {
+        for (int i = 0; i < 3; ++i) {
+            if (!color_rgbChannel(components[i], rgb[i])) return false;
+        }
+    } else {
+        double hue = 0.0;
+        double first = 0.0;
+        double second = 0.0;
+        if (!color_hue(components[0], hue) ||
+            !color_percentage(components[1], first) ||
+            !color_percentage(components[2], second)) {
+            return false;
+        }
+        if (function == color_Function::Hsl) {
+            color_hslToRgb(hue, first, second, rgb);
+        } else if (first + second >= 1.0) {
+            // hwb 白度与黑度之和超过 100% 时为灰色
+            const double gray = first / (first + second);
+            rgb[0] = rgb[1] = rgb[2] = gray;
+        } else {
+            color_hslToRgb(hue, 1.0, 0.5, rgb);
+            for (double& channel : rgb) channel = channel * (1.0 - first - second) + first;
+        }
+    }
+
+    out = (color_byte(alpha) << 24) | (color_byte(rgb[0]) << 16) | (color_byte(rgb[1]) << 8) | color_byte(rgb[2]);
+    return true;
+}
+
+/**
+ * 函数格式的解析缓存：同一组样式颜色会在成千上万个标记上反复解析
+ *
+ * 每个线程一份直接映射表，无锁、不分配；键为原始字符串（区分大小写与空白），
+ * 超过 kColorCacheKeyLength 的字符串不缓存。命名颜色与十六进制的解析本身只是一次查表，不经过缓存
+ */
+static constexpr size_t kColorCacheSize = 64;          // 2 的幂
+static constexpr size_t kColorCacheKeyLength = 32;
+
+struct color_CacheEntry {
+    uint64_t hash;
+    uint32_t color;
+    uint8_t length;     // 0 表示空
+    bool valid;
+    char key[kColorCacheKeyLength];
+};
+
+static thread_local color_CacheEntry color_cache[kColorCacheSize];
+
+static bool color_parseFunctionCached(color_Function function, std::string_view str, size_t nameLength,
+                                      uint32_t& out) {
+    const color_Scanner scanner{str.data() + nameLength, str.data() + str.size()};
+    if (str.size() > kColorCacheKeyLength) {
+        return color_parseFunction(function, scanner, out);
+    }
+
+    uint64_t hash = kColorHashBasis;
+    for (char ch : str) hash = (hash ^ static_cast<uint8_t>(ch)) * kColorHashPrime;
+    color_CacheEntry& entry = color_cache[(hash ^ (hash >> 32)) & (kColorCacheSize - 1)];
+    if (entry.hash == hash && entry.length == str.size() && std::memcmp(entry.key, str.data(), str.size()) == 0) {
+        if (entry.valid) out = entry.color;
+        return entry.valid;
+    }
+
+    uint32_t color = 0;
+    const bool valid = color_parseFunction(function, scanner, color);
+    entry.hash = hash;
+    entry.color = color;
+    entry.length = static_cast<uint8_t>(str.size());
+    entry.valid = valid;
+    std::memcpy(entry.key, str.data(), str.size());
+    if (valid) out = color;
+    return valid;
+}
+
+bool tryParseColor(std::string_view colorString, uint32_t& out) {
+    size_t begin = 0;
+    size_t end = colorString.size();
+    while (begin < end && color_isSpace(colorString[begin])) ++begin;
+    while (end > begin && color_isSpace(colorString[end - 1])) --end;
+    const std::string_view str = colorString.substr(begin, end - begin);
+    if (str.empty()) return false;
+
+    if (str[0] == '#') {
+        return color_parseHex(str.substr(1), out);
+    }
+
+    size_t nameLength = 0;
+    while (nameLength < str.size() && color_isLetter(str[nameLength])) ++nameLength;
+    const color_Function function = color_functionNamed(str.substr(0, nameLength));
+    if (function != color_Function::Unknown) {
+        return color_parseFunctionCached(function, str, nameLength, out);
+    }
+    if (nameLength == str.size() && color_lookupName(str, out)) {
+        return true;
+    }
+    // 省略 # 的十六进制
+    return color_parseHex(str, out);
+}
 
-    return 0; // Default black -> Default failure (0)
+uint32_t parseColor(std::string_view colorString) {
+    uint32_t color = 0;
+    return tryParseColor(colorString, color) ? color : 0;
 }
 
 }
@@ -1,14 +1,26 @@
 #pragma once
 
-#include <string>
 #include <cstdint>
+#include <string_view>
 
 namespace gaodemap {
 
-// Returns color as ARGB integer (0xAARRGGBB)
-// Returns 0 (transparent/black) if parsing fails, but 0 is also valid (transparent).
-// Maybe return a bool success? Or default to Black (0xFF000000) or Transparent (0x00000000).
-// Android defaults to Black in existing code.
-uint32_t parseColor(const std::string& colorString);
+/**
+ * 解析颜色字符串，结果为 ARGB 整数 (0xAARRGGBB)
+ *
+ * 支持 CSS Color 4 的 sRGB 格式：
+ * - 十六进制 #RGB / #RGBA / #RRGGBB / #RRGGBBAA（透明度在最后，可省略 #）
+ * - rgb() / rgba() / hsl() / hsla() / hwb()：逗号或空格分隔，百分比分量、角度单位、/ 透明度与 none
+ * - CSS 命名颜色（不区分大小写）
+ * 不分配内存、不抛异常，函数格式的结果按线程缓存，可在渲染线程中逐帧调用
+ * @return 解析失败时返回 0（与 transparent 相同，需要区分时使用 tryParseColor）
+ */
+uint32_t parseColor(std::string_view colorString);
+
+/**
+ * 同 parseColor，但通过返回值区分解析失败
+ * @return 解析成功时写入 out 并返回 true，失败时 out 不变
+ */
+bool tryParseColor(std::string_view colorString, uint32_t& out);
 
 }
@@ -0,0 +1,605 @@
+#include "Geodesic.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace gaodemap {
+
+static constexpr double kGeodesicPi = 3.14159265358979323846;
+static constexpr int kGeodesicMaxit1 = 20;
+static constexpr int kGeodesicMaxit2 = kGeodesicMaxit1 + std::numeric_limits<double>::digits + 10;
+static constexpr double kGeodesicTol0 = std::numeric_limits<double>::epsilon();
+static constexpr double kGeodesicTol1 = 200.0 * kGeodesicTol0;
+static constexpr double kGeodesicTolb = kGeodesicTol0;
+static const double kGeodesicTiny = std::sqrt(std::numeric_limits<double>::min());
+static const double kGeodesicTol2 = std::sqrt(kGeodesicTol0);
+static const double kGeodesicXthresh = 1000.0 * kGeodesicTol2;
+
+static inline double geodesic_sq(double x) {
+    return x * x;
+}
+
+// Horner 求值，p[0] 为最高次系数，N < 0 时为 0
+static inline double geodesic_polyval(int N, const double* p, double x) {
+    double y = N < 0 ? 0.0 : *p;
+    while (--N >= 0) {
+        y = y * x + *++p;
+    }
+    return y;
+}
+
+static inline void geodesic_norm(double& x, double& y) {
+    const double r = std::hypot(x, y);
+    x /= r;
+    y /= r;
+}
+
+// 无误差求和：u + v = s + t
+static inline double geodesic_sum(double u, double v, double& t) {
+    volatile double s = u + v;
+    volatile double up = s - v;
+    volatile double vpp = s - up;
+    up -= u;
+    vpp -= v;
+    t = s != 0.0 ? 0.0 - (up + vpp) : s;
+    return s;
+}
+
+// 把很小的角度截断为 0，避免处理近奇异情况
+static inline double geodesic_angRound(double x) {
+    static constexpr double z = 1.0 / 16.0;
+    volatile double y = std::abs(x);
+    if (y < z) y = z - (z - y);
+    return std::copysign(y, x);
+}
+
+// y - x，精确归约到 [-180, 180]，e 为舍入误差
+static inline double geodesic_angDiff(double x, double y, double& e) {
+    double t;
+    double d = geodesic_sum(std::remainder(-x, 360.0), std::remainder(y, 360.0), t);
+    d = geodesic_sum(std::remainder(d, 360.0), t, e);
+    if (d == 0.0 || std::abs(d) == 180.0) {
+        d = std::copysign(d, e == 0.0 ? y - x : -e);
+    }
+    return d;
+}
+
+// 以度为单位的 sin / cos，先归约到 [-45°, 45°] 保证 90° 的整数倍精确
+static inline void geodesic_sincosd(double x, double& sinx, double& cosx) {
+    double r = std::isfinite(x) ? std::fmod(x, 360.0) : std::numeric_limits<double>::quiet_NaN();
+    const int q = std::isnan(r) ? 0 : static_cast<int>(std::round(r / 90.0));
+    r -= 90.0 * q;
+    r *= kGeodesicPi / 180.0;
+    const double s = std::sin(r);
+    const double c = std::cos(r);
+    switch (static_cast<unsigned>(q) & 3u) {
+        case 0u: sinx = s; cosx = c; break;
+        case 1u: sinx = c; cosx = -s; break;
+        case 2u: sinx = -s; cosx = -c; break;
+        default: sinx = -c; cosx = s; break;
+    }
+    cosx += 0.0;
+    if (sinx == 0.0) sinx = std::copysign(sinx, x);
+}
+
+// sin / cos (x + t)，x 在 [-180, 180] 内，t 为小的修正量
+static inline void geodesic_sincosde(double x, double t, double& sinx, double& cosx) {
+    const int q = std::isfinite(x) ? static_cast<int>(std::round(x / 90.0)) : 0;
+    const double r = geodesic_angRound(x - 90.0 * q + t) * (kGeodesicPi / 180.0);
+    const double s = std::sin(r);
+    const double c = std::cos(r);
+    switch (static_cast<unsigned>(q) & 3u) {
+        case 0u: sinx = s; cosx = c; break;
+        case 1u: sinx = c; cosx = -s; break;
+        case 2u: sinx = -s; cosx = -c; break;
+        default: sinx = -c; cosx = s; break;
+    }
+    cosx += 0.0;
+    if (sinx == 0.0) sinx = std::copysign(sinx, x);
+}
+
+// Clenshaw 求和：sum(c[i] * sin(2 i x), i = 1..n-1)，c[0] 不使用
+static double geodesic_sinSeries(double sinx, double cosx, const double c[], int n) {
+    int k = n;
+    n -= 1;
+    const double ar = 2.0 * (cosx - sinx) * (cosx + sinx);
+    double y0 = 0.0;
+    double y1 = 0.0;
+    if (n & 1) {
+        y0 = c[--k];
+    }
+    n /= 2;
+    while (n--) {
+        y1 = ar * y0 - y1 + c[--k];
+        y0 = ar * y1 - y0 + c[--k];
+    }
+    return 2.0 * sinx * cosx * y0;
+}
+
+// k^4 + 2 k^3 - (x^2 + y^2 - 1) k^2 - 2 y^2 k - y^2 = 0 的正根
+static double geodesic_astroid(double x, double y) {
+    const double p = geodesic_sq(x);
+    const double q = geodesic_sq(y);
+    const double r = (p + q - 1.0) / 6.0;
+    if (q == 0.0 && r <= 0.0) {
+        return 0.0;
+    }
+    const double S = p * q / 4.0;
+    const double r2 = geodesic_sq(r);
+    const double r3 = r * r2;
+    const double disc = S * (S + 2.0 * r3);
+    double u = r;
+    if (disc >= 0.0) {
+        double T3 = S + r3;
+        T3 += T3 < 0.0 ? -std::sqrt(disc) : std::sqrt(disc);
+        const double T = std::cbrt(T3);
+        u += T + (T != 0.0 ? r2 / T : 0.0);
+    } else {
+        const double ang = std::atan2(std::sqrt(-disc), -(S + r3));
+        u += 2.0 * r * std::cos(ang / 3.0);
+    }
+    const double v = std::sqrt(geodesic_sq(u) + q);
+    const double uv = u < 0.0 ? q / (v - u) : u + v;
+    const double w = (uv - q) / (2.0 * v);
+    return uv / (std::sqrt(uv + geodesic_sq(w)) + w);
+}
+
+// 以下级数系数取 6 阶展开
+
+static double geodesic_A1m1f(double eps) {
+    static constexpr double coeff[] = {1, 4, 64, 0, 256};
+    const double t = geodesic_polyval(3, coeff, geodesic_sq(eps)) / coeff[4];
+    return (t + eps) / (1.0 - eps);
+}
+
+static void geodesic_C1f(double eps, double c[]) {
+    static constexpr double coeff[] = {
+        -1, 6, -16, 32,
+        -9, 64, -128, 2048,
+        9, -16, 768,
+        3, -5, 512,
+        -7, 1280,
+        -7, 2048,
+    };
+    const double eps2 = geodesic_sq(eps);
+    double d = eps;
+    int o = 0;
+    for (int l = 1; l <= 6; ++l) {
+        const int m = (6 - l) / 2;
+        c[l] = d * geodesic_polyval(m, coeff + o, eps2) / coeff[o + m + 1];
+        o += m + 2;
+        d *= eps;
+    }
+}
+
+static double geodesic_A2m1f(double eps) {
+    static constexpr double coeff[] = {-11, -28, -192, 0, 256};
+    const double t = geodesic_polyval(3, coeff, geodesic_sq(eps)) / coeff[4];
+    return (t - eps) / (1.0 + eps);
+}
+
+static void geodesic_C2f(double eps, double c[]) {
+    static constexpr double coeff[] = {
+        1, 2, 16, 32,
+        35, 64, 384, 2048,
+        15, 80, 768,
+        7, 35, 512,
+        63, 1280,
+        77, 2048,
+    };
+    const double eps2 = geodesic_sq(eps);
+    double d = eps;
+    int o = 0;
+    for (int l = 1; l <= 6; ++l) {
+        const int m = (6 - l) / 2;
+        c[l] = d * geodesic_polyval(m, coeff + o, eps2) / coeff[o + m + 1];
+        o += m + 2;
+        d *= eps;
+    }
+}
+
+Geodesic::Geodesic(double equatorialRadius, double flattening)
+    : a(equatorialRadius),
+      f(flattening),
+      f1(1.0 - flattening),
+      ep2(flattening * (2.0 - flattening) / geodesic_sq(1.0 - flattening)),
+      n(flattening / (2.0 - flattening)),
+      b(equatorialRadius * (1.0 - flattening)) {
+    etol2 = 0.1 * kGeodesicTol2 / std::sqrt(std::max(0.001, std::abs(f)) * std::min(1.0, 1.0 - f / 2.0) / 2.0);
+
+    static constexpr double A3coeff[] = {
+        -3, 128,
+        -2, -3, 64,
+        -1, -3, -1, 16,
+        3, -1, -2, 8,
+        1, -1, 2,
+        1, 1,
+    };
+    int o = 0;
+    int k = 0;
+    for (int j = kOrder - 1; j >= 0; --j) {
+        const int m = std::min(kOrder - j - 1, j);
+        A3x[k++] = geodesic_polyval(m, A3coeff + o, n) / A3coeff[o + m + 1];
+        o += m + 2;
+    }
+
+    static constexpr double C3coeff[] = {
+        3, 128,
+        2, 5, 128,
+        -1, 3, 3, 64,
+        -1, 0, 1, 8,
+        -1, 1, 4,
+        5, 256,
+        1, 3, 128,
+        -3, -2, 3, 64,
+        1, -3, 2, 32,
+        7, 512,
+        -10, 9, 384,
+        5, -9, 5, 192,
+        7, 512,
+        -14, 7, 512,
+        21, 2560,
+    };
+    o = 0;
+    k = 0;
+    for (int l = 1; l < kOrder; ++l) {
+        for (int j = kOrder - 1; j >= l; --j) {
+            const int m = std::min(kOrder - j - 1, j);
+            C3x[k++] = geodesic_polyval(m, C3coeff + o, n) / C3coeff[o + m + 1];
+            o += m + 2;
+        }
+    }
+}
+
+const Geodesic& Geodesic::WGS84() {
+    static const Geodesic geodesic(6378137.0, 1.0 / 298.257223563);
+    return geodesic;
+}
+
+double Geodesic::A3f(double eps) const {
+    return geodesic_polyval(kOrder - 1, A3x, eps);
+}
+
+void Geodesic::C3f(double eps, double c[]) const {
+    double mult = 1.0;
+    int o = 0;
+    for (int l = 1; l < kOrder; ++l) {
+        const int m = kOrder - l - 1;
+        mult *= eps;
+        c[l] = mult * geodesic_polyval(m, C3x + o, eps);
+        o += m + 1;
+    }
+}
+
+// s12b = 距离 / b，m12b = 约化长度 / b
+void Geodesic::lengths(
+    double eps, double sig12,
+    double ssig1, double csig1, double dn1,
+    double ssig2, double csig2, double dn2,
+    bool wantDistance, bool wantReducedLength,
+    double& s12b, double& m12b,
+    double C1a[], double C2a[]
+) const {
+    double A1 = geodesic_A1m1f(eps);
+    geodesic_C1f(eps, C1a);
+    double A2 = 0.0;
+    double m0x = 0.0;
+    if (wantReducedLength) {
+        A2 = geodesic_A2m1f(eps);
+        geodesic_C2f(eps, C2a);
+        m0x = A1 - A2;
+        A2 = 1.0 + A2;
+    }
+    A1 = 1.0 + A1;
+
+    double J12 = 0.0;
+    if (wantDistance) {
+        const double B1 = geodesic_sinSeries(ssig2, csig2, C1a, 7) - geodesic_sinSeries(ssig1, csig1, C1a, 7);
+        s12b = A1 * (sig12 + B1);
+        if (wantReducedLength) {
+            const double B2 = geodesic_sinSeries(ssig2, csig2, C2a, 7) - geodesic_sinSeries(ssig1, csig1, C2a, 7);
+            J12 = m0x * sig12 + (A1 * B1 - A2 * B2);
+        }
+    } else if (wantReducedLength) {
+        for (int l = 1; l <= kOrder; ++l) {
+            C2a[l] = A1 * C1a[l] - A2 * C2a[l];
+        }
+        J12 = m0x * sig12 + (geodesic_sinSeries(ssig2, csig2, C2a, 7) - geodesic_sinSeries(ssig1, csig1, C2a, 7));
+    }
+    if (wantReducedLength) {
+        m12b = dn2 * (csig1 * ssig2) - dn1 * (ssig1 * csig2) - csig1 * csig2 * J12;
+    }
+}
+
+// 牛顿迭代的初值；短线段直接求解并返回 sig12（否则返回 -1）
+double Geodesic::inverseStart(
+    double sbet1, double cbet1, double dn1,
+    double sbet2, double cbet2, double dn2,
+    double lam12, double slam12, double clam12,
+    double& salp1, double& calp1, double& dnm
+) const {
+    (void)dn1;
+    (void)dn2;
+    double sig12 = -1.0;
+    const double sbet12 = sbet2 * cbet1 - cbet2 * sbet1;
+    const double cbet12 = cbet2 * cbet1 + sbet2 * sbet1;
+    volatile double sbet12a = sbet2 * cbet1;
+    sbet12a += cbet2 * sbet1;
+
+    const bool shortline = cbet12 >= 0.0 && sbet12 < 0.5 && cbet2 * lam12 < 0.5;
+    double somg12;
+    double comg12;
+    if (shortline) {
+        double sbetm2 = geodesic_sq(sbet1 + sbet2);
+        sbetm2 /= sbetm2 + geodesic_sq(cbet1 + cbet2);
+        dnm = std::sqrt(1.0 + ep2 * sbetm2);
+        const double omg12 = lam12 / (f1 * dnm);
+        somg12 = std::sin(omg12);
+        comg12 = std::cos(omg12);
+    } else {
+        somg12 = slam12;
+        comg12 = clam12;
+    }
+
+    salp1 = cbet2 * somg12;
+    calp1 = comg12 >= 0.0
+        ? sbet12 + cbet2 * sbet1 * geodesic_sq(somg12) / (1.0 + comg12)
+        : sbet12a - cbet2 * sbet1 * geodesic_sq(somg12) / (1.0 - comg12);
+
+    const double ssig12 = std::hypot(salp1, calp1);
+    const double csig12 = sbet1 * sbet2 + cbet1 * cbet2 * comg12;
+
+    if (shortline && ssig12 < etol2) {
+        sig12 = std::atan2(ssig12, csig12);
+    } else if (std::abs(n) >= 0.1 || csig12 >= 0.0 || ssig12 >= 6.0 * std::abs(n) * kGeodesicPi * geodesic_sq(cbet1)) {
+        // 零阶球面近似已足够
+    } else {
+        // 近对跖点：在以对跖点为原点的坐标系中解 astroid 方程（此处只处理 f >= 0 的扁椭球）
+        const double lam12x = std::atan2(-slam12, -clam12);
+        const double k2 = geodesic_sq(sbet1) * ep2;
+        const double eps = k2 / (2.0 * (1.0 + std::sqrt(1.0 + k2)) + k2);
+        const double lamscale = f * cbet1 * A3f(eps) * kGeodesicPi;
+        const double betscale = lamscale * cbet1;
+        const double x = lam12x / lamscale;
+        const double y = sbet12a / betscale;
+
+        if (y > -kGeodesicTol1 && x > -1.0 - kGeodesicXthresh) {
+            salp1 = std::min(1.0, -x);
+            calp1 = -std::sqrt(1.0 - geodesic_sq(salp1));
+        } else {
+            const double k = geodesic_astroid(x, y);
+            const double omg12a = lamscale * (-x * k / (1.0 + k));
+            somg12 = std::sin(omg12a);
+            comg12 = -std::cos(omg12a);
+            salp1 = cbet2 * somg12;
+            calp1 = sbet12a - cbet2 * sbet1 * geodesic_sq(somg12) / (1.0 - comg12);
+        }
+    }
+    if (!(salp1 <= 0.0)) {
+        geodesic_norm(salp1, calp1);
+    } else {
+        salp1 = 1.0;
+        calp1 = 0.0;
+    }
+    return sig12;
+}
+
+// 给定起点方位角时终点经度与目标经度之差，dlam12 为其对方位角的导数
+double Geodesic::lambda12(
+    double sbet1, double cbet1, double dn1,
+    double sbet2, double cbet2, double dn2,
+    double salp1, double calp1, double slam120, double clam120,
+    bool diffp,
+    double& sig12, double& ssig1, double& csig1, double& ssig2, double& csig2,
+    double& eps, double& dlam12,
+    double C1a[], double C2a[], double C3a[]
+) const {
+    if (sbet1 == 0.0 && calp1 == 0.0) {
+        calp1 = -kGeodesicTiny;  // 打破赤道线的退化
+    }
+
+    const double salp0 = salp1 * cbet1;
+    const double calp0 = std::hypot(calp1, salp1 * sbet1);
+
+    ssig1 = sbet1;
+    const double somg1 = salp0 * sbet1;
+    csig1 = calp1 * cbet1;
+    const double comg1 = csig1;
+    geodesic_norm(ssig1, csig1);
+
+    const double salp2 = cbet2 != cbet1 ? salp0 / cbet2 : salp1;
+    (void)salp2;
+    const double calp2 = (cbet2 != cbet1 || std::abs(sbet2) != -sbet1)
+        ? std::sqrt(geodesic_sq(calp1 * cbet1) +
+                    (cbet1 < -sbet1 ? (cbet2 - cbet1) * (cbet1 + cbet2) : (sbet1 - sbet2) * (sbet1 + sbet2))) / cbet2
+        : std::abs(calp1);
+
+    ssig2 = sbet2;
+    const double somg2 = salp0 * sbet2;
+    csig2 = calp2 * cbet2;
+    const double comg2 = csig2;
+    geodesic_norm(ssig2, csig2);
+
+    sig12 = std::atan2(std::max(0.0, csig1 * ssig2 - ssig1 * csig2) + 0.0, csig1 * csig2 + ssig1 * ssig2);
+
+    const double somg12 = std::max(0.0, comg1 * somg2 - somg1 * comg2) + 0.0;
+    const double comg12 = comg1 * comg2 + somg1 * somg2;
+    const double eta = std::atan2(somg12 * clam120 - comg12 * slam120, comg12 * clam120 + somg12 * slam120);
+
+    const double k2 = geodesic_sq(calp0) * ep2;
+    eps = k2 / (2.0 * (1.0 + std::sqrt(1.0 + k2)) + k2);
+    C3f(eps, C3a);
+    const double B312 = geodesic_sinSeries(ssig2, csig2, C3a, kOrder) - geodesic_sinSeries(ssig1, csig1, C3a, kOrder);
+    const double domg12 = -f * A3f(eps) * salp0 * (sig12 + B312);
+    const double lam12 = eta + domg12;
+
+    if (diffp) {
+        if (calp2 == 0.0) {
+            dlam12 = -2.0 * f1 * dn1 / sbet1;
+        } else {
+            double unusedDistance = 0.0;
+            lengths(eps, sig12, ssig1, csig1, dn1, ssig2, csig2, dn2, false, true, unusedDistance, dlam12, C1a, C2a);
+            dlam12 *= f1 / (calp2 * cbet2);
+        }
+    } else {
+        dlam12 = std::numeric_limits<double>::quiet_NaN();
+    }
+    return lam12;
+}
+
+double Geodesic::distance(double lat1, double lon1, double lat2, double lon2) const {
+    if (!std::isfinite(lat1) || !std::isfinite(lon1) || !std::isfinite(lat2) || !std::isfinite(lon2) ||
+        std::abs(lat1) > 90.0 || std::abs(lat2) > 90.0) {
+        return std::numeric_limits<double>::quiet_NaN();
+    }
+
+    // 变换到 0 <= lon12 <= 180、lat1 <= 0、|lat2| <= |lat1| 的标准形式，距离不受影响
+    double lon12s;
+    double lon12 = geodesic_angDiff(lon1, lon2, lon12s);
+    const double lonsign = std::copysign(1.0, lon12);
+    lon12 *= lonsign;
+    lon12s *= lonsign;
+    const double lam12 = lon12 * (kGeodesicPi / 180.0);
+    double slam12;
+    double clam12;
+    geodesic_sincosde(lon12, lon12s, slam12, clam12);
+    lon12s = (180.0 - lon12) - lon12s;
+
+    lat1 = geodesic_angRound(lat1);
+    lat2 = geodesic_angRound(lat2);
+    if (std::abs(lat1) < std::abs(lat2)) {
+        std::swap(lat1, lat2);
+    }
+    const double latsign = std::copysign(1.0, -lat1);
+    lat1 *= latsign;
+    lat2 *= latsign;
+
+    double sbet1;
+    double cbet1;
+    geodesic_sincosd(lat1, sbet1, cbet1);
+    sbet1 *= f1;
+    geodesic_norm(sbet1, cbet1);
+    cbet1 = std::max(kGeodesicTiny, cbet1);
+
+    double sbet2;
+    double cbet2;
+    geodesic_sincosd(lat2, sbet2, cbet2);
+    sbet2 *= f1;
+    geodesic_norm(sbet2, cbet2);
+    cbet2 = std::max(kGeodesicTiny, cbet2);
+
+    if (cbet1 < -sbet1) {
+        if (cbet2 == cbet1) sbet2 = std::copysign(sbet1, sbet2);
+    } else {
+        if (std::abs(sbet2) == -sbet1) cbet2 = cbet1;
+    }
+
+    const double dn1 = std::sqrt(1.0 + ep2 * geodesic_sq(sbet1));
+    const double dn2 = std::sqrt(1.0 + ep2 * geodesic_sq(sbet2));
+
+    double C1a[kOrder + 1];
+    double C2a[kOrder + 1];
+    double C3a[kOrder];
+
+    double s12x = 0.0;
+    double m12x = 0.0;
+    bool meridian = lat1 == -90.0 || slam12 == 0.0;
+
+    if (meridian) {
+        // 两点在同一条完整经线上，测地线可能就是经线
+        const double calp1 = clam12;
+        const double ssig1 = sbet1;
+        const double csig1 = calp1 * cbet1;
+        const double ssig2 = sbet2;
+        const double csig2 = cbet2;
+        double sig12 = std::atan2(std::max(0.0, csig1 * ssig2 - ssig1 * csig2) + 0.0, csig1 * csig2 + ssig1 * ssig2);
+        lengths(n, sig12, ssig1, csig1, dn1, ssig2, csig2, dn2, true, true, s12x, m12x, C1a, C2a);
+        if (sig12 < kGeodesicTol2 || m12x >= 0.0) {
+            if (sig12 < 3.0 * kGeodesicTiny || (sig12 < kGeodesicTol0 && (s12x < 0.0 || m12x < 0.0))) {
+                s12x = 0.0;
+            }
+            s12x *= b;
+        } else {
+            meridian = false;
+        }
+    }
+
+    if (!meridian && sbet1 == 0.0 && (f <= 0.0 || lon12s >= f * 180.0)) {
+        // 沿赤道
+        s12x = a * lam12;
+    } else if (!meridian) {
+        double salp1 = 0.0;
+        double calp1 = 0.0;
+        double dnm = 0.0;
+        double sig12 = inverseStart(sbet1, cbet1, dn1, sbet2, cbet2, dn2, lam12, slam12, clam12, salp1, calp1, dnm);
+
+        if (sig12 >= 0.0) {
+            s12x = sig12 * b * dnm;
+        } else {
+            // 带区间保护的牛顿迭代：导数非正或越出 (0, π) 时取区间中点
+            double ssig1 = 0.0;
+            double csig1 = 0.0;
+            double ssig2 = 0.0;
+            double csig2 = 0.0;
+            double eps = 0.0;
+            int numit = 0;
+            bool tripn = false;
+            bool tripb = false;
+            double salp1a = kGeodesicTiny;
+            double calp1a = 1.0;
+            double salp1b = kGeodesicTiny;
+            double calp1b = -1.0;
+
+            while (true) {
+                double dv = 0.0;
+                const double v = lambda12(
+                    sbet1, cbet1, dn1, sbet2, cbet2, dn2, salp1, calp1, slam12, clam12,
+                    numit < kGeodesicMaxit1,
+                    sig12, ssig1, csig1, ssig2, csig2, eps, dv, C1a, C2a, C3a
+                );
+                if (tripb || !(std::abs(v) >= (tripn ? 8.0 : 1.0) * kGeodesicTol0) || numit == kGeodesicMaxit2) {
+                    break;
+                }
+                if (v > 0.0 && (numit > kGeodesicMaxit1 || calp1 / salp1 > calp1b / salp1b)) {
+                    salp1b = salp1;
+                    calp1b = calp1;
+                } else if (v < 0.0 && (numit > kGeodesicMaxit1 || calp1 / salp1 < calp1a / salp1a)) {
+                    salp1a = salp1;
+                    calp1a = calp1;
+                }
+
+                ++numit;
+                if (numit < kGeodesicMaxit1 && dv > 0.0) {
+                    const double dalp1 = -v / dv;
+                    if (std::abs(dalp1) < kGeodesicPi) {
+                        const double sdalp1 = std::sin(dalp1);
+                        const double cdalp1 = std::cos(dalp1);
+                        const double nsalp1 = salp1 * cdalp1 + calp1 * sdalp1;
+                        if (nsalp1 > 0.0) {
+                            calp1 = calp1 * cdalp1 - salp1 * sdalp1;
+                            salp1 = nsalp1;
+                            geodesic_norm(salp1, calp1);
+                            tripn = std::abs(v) <= 16.0 * kGeodesicTol0;
+                            continue;
+                        }
+                    }
+                }
+                salp1 = (salp1a + salp1b) / 2.0;
+                calp1 = (calp1a + calp1b) / 2.0;
+                geodesic_norm(salp1, calp1);
+                tripn = false;
+                tripb = std::abs(salp1a - salp1) + (calp1a - calp1) < kGeodesicTolb ||
+                        std::abs(salp1 - salp1b) + (calp1 - calp1b) < kGeodesicTolb;
+            }
+
+            double unusedReducedLength = 0.0;
+            lengths(eps, sig12, ssig1, csig1, dn1, ssig2, csig2, dn2, true, false, s12x, unusedReducedLength, C1a, C2a);
+            s12x *= b;
+        }
+    }
+
+    return 0.0 + s12x;
+}
+
+}
@@ -0,0 +1,70 @@
+#pragma once
+
+namespace gaodemap {
+
+/**
+ * 椭球面测地线反解（Karney 2013, "Algorithms for geodesics"）
+ * 由 GeographicLib (MIT/X11, Copyright (c) Charles Karney) 的 Geodesic::Inverse 移植，只保留距离输出
+ *
+ * 以方位角为未知量做带区间保护的牛顿迭代，对跖点附近用 astroid 方程给出初值，
+ * 任意点对都收敛，误差在纳米量级；单次计算比 Vincenty 慢，
+ * GeometryEngine 在 WGS84 模型下优先使用 Vincenty，仅在其不收敛（近对跖点）时调用这里
+ */
+class Geodesic {
+public:
+    /**
+     * @param equatorialRadius 长半轴（米）
+     * @param flattening 扁率
+     */
+    Geodesic(double equatorialRadius, double flattening);
+
+    // WGS-84 椭球，首次调用时初始化
+    static const Geodesic& WGS84();
+
+    /**
+     * 两点间测地线长度（米），纬度超出 [-90, 90] 或输入非有限值时返回 NaN
+     */
+    double distance(double lat1, double lon1, double lat2, double lon2) const;
+
+private:
+    static constexpr int kOrder = 6;
+    static constexpr int kC3Size = kOrder * (kOrder - 1) / 2;
+
+    double A3f(double eps) const;
+    void C3f(double eps, double c[]) const;
+    void lengths(
+        double eps, double sig12,
+        double ssig1, double csig1, double dn1,
+        double ssig2, double csig2, double dn2,
+        bool wantDistance, bool wantReducedLength,
+        double& s12b, double& m12b,
+        double C1a[], double C2a[]
+    ) const;
+    double inverseStart(
+        double sbet1, double cbet1, double dn1,
+        double sbet2, double cbet2, double dn2,
+        double lam12, double slam12, double clam12,
+        double& salp1, double& calp1, double& dnm
+    ) const;
+    double lambda12(
+        double sbet1, double cbet1, double dn1,
+        double sbet2, double cbet2, double dn2,
+        double salp1, double calp1, double slam120, double clam120,
+        bool diffp,
+        double& sig12, double& ssig1, double& csig1, double& ssig2, double& csig2,
+        double& eps, double& dlam12,
+        double C1a[], double C2a[], double C3a[]
+    ) const;
+
+    double a;
+    double f;
+    double f1;
+    double ep2;
+    double n;
+    double b;
+    double etol2;
+    double A3x[kOrder];
+    double C3x[kC3Size];
+};
+
+}
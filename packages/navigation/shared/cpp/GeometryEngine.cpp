@@ -1,9 +1,25 @@
 #include "GeometryEngine.hpp"
+#include "Geodesic.hpp"
 
+#include <cctype>
 #include <cmath>
-#include <map>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
 #include <algorithm>
 #include <limits>
+#include <system_error>
+#include <thread>
+#include <utility>
+
+#if defined(__BMI2__)
+#include <immintrin.h>
+#endif
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+#include <arm_neon.h>
+#endif
 
 namespace gaodemap {
 
@@ -27,6 +43,51 @@ static inline double clampMercatorLatitude(double lat) {
     return lat;
 }
 
+// 2^z 查找表，覆盖常用缩放级别，避免每个点调用 std::pow
+struct geo_ZoomScaleTable {
+    static constexpr int kSize = 32;
+    double values[kSize];
+
+    constexpr geo_ZoomScaleTable() : values() {
+        for (int z = 0; z < kSize; ++z) {
+            values[z] = static_cast<double>(uint64_t(1) << z);
+        }
+    }
+};
+
+static constexpr geo_ZoomScaleTable kZoomScales{};
+
+static inline double geo_zoomScale(int zoom) {
+    return (zoom >= 0 && zoom < geo_ZoomScaleTable::kSize) ? kZoomScales.values[zoom] : std::ldexp(1.0, zoom);
+}
+
+// 小数缩放级别：整数部分查表，小数部分用 exp2
+// NaN / 无穷或超出 int 范围的级别不能转换为 int，直接交给 exp2（NaN 原样传播，溢出为 inf / 0）
+static inline double geo_zoomScale(double zoom) {
+    if (!(std::abs(zoom) < 4096.0)) {
+        return std::exp2(zoom);
+    }
+    const double whole = std::floor(zoom);
+    const double scale = geo_zoomScale(static_cast<int>(whole));
+    return whole == zoom ? scale : scale * std::exp2(zoom - whole);
+}
+
+// 不截断的 Mercator y (0 为北，1 为南)
+// asinh(tan φ) = atanh(sin φ) = 0.5 * log1p(2s / (1 - s))，比 tan + asinh 少一次超越函数
+static inline double geo_mercatorY01Unclamped(double lat) {
+    const double s = std::sin(geo_toRadians(lat));
+    if (!(std::abs(s) < 1.0)) {
+        // ±90° 处沿用 tan + asinh，结果有限
+        return (1.0 - std::asinh(std::tan(geo_toRadians(lat))) / kPi) * 0.5;
+    }
+    return 0.5 - std::log1p(2.0 * s / (1.0 - s)) / (4.0 * kPi);
+}
+
+// Mercator y 的逆变换
+static inline double geo_latitudeAtMercatorY01(double y01) {
+    return geo_toDegrees(std::atan(std::sinh(kPi * (1.0 - 2.0 * y01))));
+}
+
 static inline double mercatorX01(double lon) {
     double wrapped = std::fmod(lon + 180.0, 360.0);
     if (wrapped < 0.0) {
@@ -36,39 +97,161 @@ static inline double mercatorX01(double lon) {
 }
 
 static inline double mercatorY01(double lat) {
-    const double clampedLat = clampMercatorLatitude(lat);
-    const double latRad = geo_toRadians(clampedLat);
-    const double y = (1.0 - std::asinh(std::tan(latRad)) / kPi) * 0.5;
+    const double y = geo_mercatorY01Unclamped(clampMercatorLatitude(lat));
     if (y < 0.0) return 0.0;
     if (y > 1.0) return 1.0;
     return y;
 }
 
-static double wrappedSpan01(std::vector<double>& xs) {
-    if (xs.size() <= 1) {
-        return 0.0;
+// --- 地球模型 ---
+
+// 椭球常量，只在首次使用时计算一次
+struct geo_Ellipsoid {
+    double a;               // 长半轴
+    double f;               // 扁率
+    double b;               // 短半轴
+    double oneMinusF;
+    double e2;              // 第一偏心率平方
+    double e;
+    double ep2;             // 第二偏心率平方 (a² - b²) / b²
+    double qp;              // 极点处的 q，sinβ = q(φ) / qp
+    double authalicRadius;  // 等面积球半径
+
+    geo_Ellipsoid(double semiMajor, double flattening)
+        : a(semiMajor),
+          f(flattening),
+          b(semiMajor * (1.0 - flattening)),
+          oneMinusF(1.0 - flattening),
+          e2(flattening * (2.0 - flattening)),
+          e(std::sqrt(flattening * (2.0 - flattening))),
+          ep2(e2 / (1.0 - e2)) {
+        qp = q(1.0);
+        authalicRadius = a * std::sqrt(qp * 0.5);
     }
 
-    std::sort(xs.begin(), xs.end());
-    double maxGap = 0.0;
+    // 等面积纬度的辅助量 q(φ)，参数为 sinφ
+    double q(double sinPhi) const {
+        return (1.0 - e2) * (sinPhi / (1.0 - e2 * sinPhi * sinPhi) + std::atanh(e * sinPhi) / e);
+    }
+};
+
+static const geo_Ellipsoid& geo_wgs84() {
+    static const geo_Ellipsoid ellipsoid(6378137.0, 1.0 / 298.257223563);
+    return ellipsoid;
+}
+
+// 归化纬度 U 的正弦 / 余弦：tanU = (1 - f) tanφ，在两极处同样稳定
+struct geo_ReducedLatitude {
+    double sinU;
+    double cosU;
+};
 
-    for (size_t i = 0; i + 1 < xs.size(); ++i) {
-        const double gap = xs[i + 1] - xs[i];
-        if (gap > maxGap) {
-            maxGap = gap;
+static inline geo_ReducedLatitude geo_reducedLatitude(const geo_Ellipsoid& ellipsoid, double lat) {
+    const double phi = geo_toRadians(lat);
+    const double y = ellipsoid.oneMinusF * std::sin(phi);
+    const double x = std::cos(phi);
+    const double inv = 1.0 / std::sqrt(x * x + y * y);
+    return {y * inv, x * inv};
+}
+
+/**
+ * Vincenty 反解：椭球面测地线长度
+ * 归化纬度由调用方预先计算（一对多时起点只算一次），dLon 为归约到 [-π, π] 的经度差（弧度）
+ * 近对跖点迭代不收敛时改用 Geodesic（Karney 算法）
+ */
+static double geo_vincentyMeters(
+    const geo_Ellipsoid& ellipsoid,
+    const geo_ReducedLatitude& p1,
+    const geo_ReducedLatitude& p2,
+    double lat1,
+    double lat2,
+    double dLon
+) {
+    static constexpr int kMaxIterations = 100;
+    static constexpr double kTolerance = 1e-12;  // 约 0.006 mm
+
+    const double L = dLon;
+    const double sinU1sinU2 = p1.sinU * p2.sinU;
+    const double cosU1cosU2 = p1.cosU * p2.cosU;
+    const double cosU1sinU2 = p1.cosU * p2.sinU;
+    const double sinU1cosU2 = p1.sinU * p2.cosU;
+    const double f = ellipsoid.f;
+
+    double lambda = L;
+    for (int iteration = 0; iteration < kMaxIterations; ++iteration) {
+        const double sinLambda = std::sin(lambda);
+        const double cosLambda = std::cos(lambda);
+        const double t1 = p2.cosU * sinLambda;
+        const double t2 = cosU1sinU2 - sinU1cosU2 * cosLambda;
+        const double sinSigma = std::sqrt(t1 * t1 + t2 * t2);
+        const double cosSigma = sinU1sinU2 + cosU1cosU2 * cosLambda;
+        if (sinSigma == 0.0) {
+            if (cosSigma > 0.0) return 0.0;  // 重合点
+            break;                           // 对跖点
+        }
+        const double sigma = std::atan2(sinSigma, cosSigma);
+        const double sinAlpha = cosU1cosU2 * sinLambda / sinSigma;
+        const double cosSqAlpha = 1.0 - sinAlpha * sinAlpha;
+        // 沿赤道时 cos²α = 0
+        const double cos2SigmaM = cosSqAlpha != 0.0 ? cosSigma - 2.0 * sinU1sinU2 / cosSqAlpha : 0.0;
+        const double C = f / 16.0 * cosSqAlpha * (4.0 + f * (4.0 - 3.0 * cosSqAlpha));
+        const double previous = lambda;
+        lambda = L + (1.0 - C) * f * sinAlpha *
+            (sigma + C * sinSigma * (cos2SigmaM + C * cosSigma * (-1.0 + 2.0 * cos2SigmaM * cos2SigmaM)));
+
+        if (std::abs(lambda - previous) <= kTolerance) {
+            const double uSq = cosSqAlpha * ellipsoid.ep2;
+            const double A = 1.0 + uSq / 16384.0 * (4096.0 + uSq * (-768.0 + uSq * (320.0 - 175.0 * uSq)));
+            const double B = uSq / 1024.0 * (256.0 + uSq * (-128.0 + uSq * (74.0 - 47.0 * uSq)));
+            const double c2 = cos2SigmaM * cos2SigmaM;
+            const double deltaSigma = B * sinSigma * (cos2SigmaM + B / 4.0 *
+                (cosSigma * (-1.0 + 2.0 * c2) - B / 6.0 * cos2SigmaM * (-3.0 + 4.0 * sinSigma * sinSigma) * (-3.0 + 4.0 * c2)));
+            return ellipsoid.b * A * (sigma - deltaSigma);
         }
+        if (std::abs(lambda) > kPi) break;  // 近对跖点，迭代发散
     }
+    return Geodesic::WGS84().distance(lat1, 0.0, lat2, geo_toDegrees(L));
+}
 
-    const double endGap = xs.front() + 1.0 - xs.back();
-    if (endGap > maxGap) {
-        maxGap = endGap;
+// 短线段：在中点纬度处用子午圈 / 卯酉圈曲率半径做切平面近似
+// 误差随长度三次方增长，1 km 时约 0.03 mm（低于 Vincenty 自身的截断误差），比 Haversine 还少一次三角函数
+static constexpr double kShortLineRadians = 1.5e-4;  // 约 1 km
+
+static inline bool geo_shortLineMeters(const geo_Ellipsoid& ellipsoid, double lat1, double lat2, double dLon, double& meters) {
+    const double dPhi = geo_toRadians(lat2 - lat1);
+    if (std::abs(dPhi) >= kShortLineRadians || std::abs(dLon) >= 0.01) return false;
+    const double phiM = geo_toRadians(lat1) + dPhi * 0.5;
+    const double cosM = std::cos(phiM);
+    if (std::abs(dLon * cosM) >= kShortLineRadians) return false;
+    const double sinM = std::sin(phiM);
+    const double w = 1.0 - ellipsoid.e2 * sinM * sinM;
+    const double primeVertical = ellipsoid.a / std::sqrt(w);
+    const double meridional = primeVertical * (1.0 - ellipsoid.e2) / w;
+    meters = std::hypot(primeVertical * cosM * dLon, meridional * dPhi);
+    return true;
+}
+
+// WGS84 模型下的距离，dLon 为经度差（弧度）
+static inline double geo_ellipsoidMeters(const geo_Ellipsoid& ellipsoid, double lat1, double lat2, double dLon) {
+    double meters;
+    if (geo_shortLineMeters(ellipsoid, lat1, lat2, dLon, meters)) {
+        return meters;
     }
+    return geo_vincentyMeters(
+        ellipsoid,
+        geo_reducedLatitude(ellipsoid, lat1),
+        geo_reducedLatitude(ellipsoid, lat2),
+        lat1,
+        lat2,
+        dLon
+    );
+}
 
-    const double span = 1.0 - maxGap;
-    return span < 0.0 ? 0.0 : span;
+static inline bool geo_isFinitePair(double lat, double lon) {
+    return std::isfinite(lat) && std::isfinite(lon);
 }
 
-double calculateDistance(double lat1, double lon1, double lat2, double lon2) {
+static double geo_haversineMeters(double lat1, double lon1, double lat2, double lon2) {
     const double radLat1 = geo_toRadians(lat1);
     const double radLat2 = geo_toRadians(lat2);
     const double dLat = radLat2 - radLat1;
@@ -82,6 +265,71 @@ double calculateDistance(double lat1, double lon1, double lat2, double lon2) {
     return kEarthRadiusMeters * c;
 }
 
+double calculateDistance(double lat1, double lon1, double lat2, double lon2, EarthModel model) {
+    if (model == EarthModel::Sphere) {
+        return geo_haversineMeters(lat1, lon1, lat2, lon2);
+    }
+    if (!geo_isFinitePair(lat1, lon1) || !geo_isFinitePair(lat2, lon2)) {
+        return std::numeric_limits<double>::quiet_NaN();
+    }
+    return geo_ellipsoidMeters(geo_wgs84(), lat1, lat2, geo_toRadians(std::remainder(lon2 - lon1, 360.0)));
+}
+
+double calculateDistance(double lat1, double lon1, double lat2, double lon2) {
+    return calculateDistance(lat1, lon1, lat2, lon2, EarthModel::Sphere);
+}
+
+void calculateDistances(const CoordSpan& from, const CoordSpan& to, double* out, EarthModel model) {
+    const size_t n = std::min(from.size(), to.size());
+    if (model == EarthModel::Sphere) {
+        for (size_t i = 0; i < n; ++i) {
+            out[i] = geo_haversineMeters(from.latAt(i), from.lonAt(i), to.latAt(i), to.lonAt(i));
+        }
+        return;
+    }
+    const geo_Ellipsoid& ellipsoid = geo_wgs84();
+    for (size_t i = 0; i < n; ++i) {
+        const double lat1 = from.latAt(i);
+        const double lon1 = from.lonAt(i);
+        const double lat2 = to.latAt(i);
+        const double lon2 = to.lonAt(i);
+        if (!geo_isFinitePair(lat1, lon1) || !geo_isFinitePair(lat2, lon2)) {
+            out[i] = std::numeric_limits<double>::quiet_NaN();
+            continue;
+        }
+        out[i] = geo_ellipsoidMeters(ellipsoid, lat1, lat2, geo_toRadians(std::remainder(lon2 - lon1, 360.0)));
+    }
+}
+
+void calculateDistancesFrom(double lat, double lon, const CoordSpan& points, double* out, EarthModel model) {
+    const size_t n = points.size();
+    if (model == EarthModel::Sphere) {
+        for (size_t i = 0; i < n; ++i) {
+            out[i] = geo_haversineMeters(lat, lon, points.latAt(i), points.lonAt(i));
+        }
+        return;
+    }
+    if (!geo_isFinitePair(lat, lon)) {
+        std::fill(out, out + n, std::numeric_limits<double>::quiet_NaN());
+        return;
+    }
+    const geo_Ellipsoid& ellipsoid = geo_wgs84();
+    const geo_ReducedLatitude origin = geo_reducedLatitude(ellipsoid, lat);
+    for (size_t i = 0; i < n; ++i) {
+        const double lat2 = points.latAt(i);
+        const double lon2 = points.lonAt(i);
+        if (!geo_isFinitePair(lat2, lon2)) {
+            out[i] = std::numeric_limits<double>::quiet_NaN();
+            continue;
+        }
+        const double dLon = geo_toRadians(std::remainder(lon2 - lon, 360.0));
+        double meters;
+        out[i] = geo_shortLineMeters(ellipsoid, lat, lat2, dLon, meters)
+            ? meters
+            : geo_vincentyMeters(ellipsoid, origin, geo_reducedLatitude(ellipsoid, lat2), lat, lat2, dLon);
+    }
+}
+
 static double haversineMeters(double lat1, double lon1, double lat2, double lon2) {
     return calculateDistance(lat1, lon1, lat2, lon2);
 }
@@ -110,6 +358,10 @@ bool isPointInCircle(double pointLat, double pointLon, double centerLat, double
 }
 
 bool isPointInPolygon(double pointLat, double pointLon, const std::vector<GeoPoint>& polygon) {
+    return isPointInPolygon(pointLat, pointLon, CoordSpan(polygon));
+}
+
+bool isPointInPolygon(double pointLat, double pointLon, const CoordSpan& polygon) {
     const size_t n = polygon.size();
     if (n < 3) {
         return false;
@@ -118,10 +370,10 @@ bool isPointInPolygon(double pointLat, double pointLon, const std::vector<GeoPoi
     bool inside = false;
     size_t j = n - 1;
     for (size_t i = 0; i < n; ++i) {
-        const double xi = polygon[i].lat;
-        const double yi = polygon[i].lon;
-        const double xj = polygon[j].lat;
-        const double yj = polygon[j].lon;
+        const double xi = polygon.latAt(i);
+        const double yi = polygon.lonAt(i);
+        const double xj = polygon.latAt(j);
+        const double yj = polygon.lonAt(j);
 
         const double intersect = ((yi > pointLon) != (yj > pointLon)) &&
             (pointLat < (xj - xi) * (pointLon - yi) / (yj - yi) + xi);
@@ -135,15 +387,40 @@ bool isPointInPolygon(double pointLat, double pointLon, const std::vector<GeoPoi
 }
 
 double calculatePolygonArea(const std::vector<GeoPoint>& polygon) {
+    return calculatePolygonArea(CoordSpan(polygon));
+}
+
+double calculatePolygonArea(const CoordSpan& polygon) {
+    return calculatePolygonArea(polygon, EarthModel::Sphere);
+}
+
+double calculatePolygonArea(const CoordSpan& polygon, EarthModel model) {
     const size_t n = polygon.size();
     if (n < 3) {
         return 0.0;
     }
 
+    if (model == EarthModel::WGS84) {
+        // 椭球面积元在等面积纬度 β 下与球面相同：把 sinφ 换成 sinβ = q(φ) / qp，半径换成等面积球半径
+        const geo_Ellipsoid& ellipsoid = geo_wgs84();
+        const double invQp = 1.0 / ellipsoid.qp;
+        double total = 0.0;
+        double sinBeta1 = ellipsoid.q(std::sin(geo_toRadians(polygon.latAt(n - 1)))) * invQp;
+        double lon1 = geo_toRadians(polygon.lonAt(n - 1));
+        for (size_t i = 0; i < n; ++i) {
+            const double sinBeta2 = ellipsoid.q(std::sin(geo_toRadians(polygon.latAt(i)))) * invQp;
+            const double lon2 = geo_toRadians(polygon.lonAt(i));
+            total += (lon2 - lon1) * (2.0 + sinBeta1 + sinBeta2);
+            sinBeta1 = sinBeta2;
+            lon1 = lon2;
+        }
+        return std::abs(total) * (ellipsoid.authalicRadius * ellipsoid.authalicRadius) * 0.5;
+    }
+
     double total = 0.0;
     for (size_t i = 0; i < n; ++i) {
-        const GeoPoint& p1 = polygon[i];
-        const GeoPoint& p2 = polygon[(i + 1) % n];
+        const GeoPoint p1 = polygon[i];
+        const GeoPoint p2 = polygon[(i + 1) % n];
 
         const double lat1 = geo_toRadians(p1.lat);
         const double lat2 = geo_toRadians(p2.lat);
@@ -222,6 +499,18 @@ std::vector<GeoPoint> simplifyPolyline(const std::vector<GeoPoint>& points, doub
     if (points.size() <= 2) {
         return points;
     }
+    return simplifyPolyline(CoordSpan(points), toleranceMeters);
+}
+
+std::vector<GeoPoint> simplifyPolyline(const CoordSpan& points, double toleranceMeters) {
+    if (points.size() <= 2) {
+        std::vector<GeoPoint> copy;
+        copy.reserve(points.size());
+        for (size_t i = 0; i < points.size(); ++i) {
+            copy.push_back(points[i]);
+        }
+        return copy;
+    }
 
     // 1. 投影到平面坐标 (Equirectangular Projection approximation)
     // 以第一个点为原点
@@ -260,16 +549,36 @@ std::vector<GeoPoint> simplifyPolyline(const std::vector<GeoPoint>& points, doub
 }
 
 double calculatePathLength(const std::vector<GeoPoint>& points) {
+    return calculatePathLength(CoordSpan(points));
+}
+
+double calculatePathLength(const CoordSpan& points) {
+    return calculatePathLength(points, EarthModel::Sphere);
+}
+
+double calculatePathLength(const CoordSpan& points, EarthModel model) {
     if (points.size() < 2) return 0.0;
     
     double total = 0.0;
+    if (model == EarthModel::WGS84) {
+        const geo_Ellipsoid& ellipsoid = geo_wgs84();
+        for (size_t i = 0; i < points.size() - 1; ++i) {
+            const double dLon = geo_toRadians(std::remainder(points.lonAt(i + 1) - points.lonAt(i), 360.0));
+            total += geo_ellipsoidMeters(ellipsoid, points.latAt(i), points.latAt(i + 1), dLon);
+        }
+        return total;
+    }
     for (size_t i = 0; i < points.size() - 1; ++i) {
-        total += calculateDistance(points[i].lat, points[i].lon, points[i+1].lat, points[i+1].lon);
+        total += geo_haversineMeters(points.latAt(i), points.lonAt(i), points.latAt(i + 1), points.lonAt(i + 1));
     }
     return total;
 }
 
 bool getPointAtDistance(const std::vector<GeoPoint>& points, double distanceMeters, double* outLat, double* outLon, double* outAngle) {
+    return getPointAtDistance(CoordSpan(points), distanceMeters, outLat, outLon, outAngle);
+}
+
+bool getPointAtDistance(const CoordSpan& points, double distanceMeters, double* outLat, double* outLon, double* outAngle) {
     if (points.size() < 2 || distanceMeters < 0) return false;
     
     if (distanceMeters == 0) {
@@ -297,14 +606,131 @@ bool getPointAtDistance(const std::vector<GeoPoint>& points, double distanceMete
     }
     
     // 如果超出总长度，返回最后一个点
-    const GeoPoint& last = points.back();
-    const GeoPoint& prev = points[points.size() - 2];
+    const GeoPoint last = points.back();
+    const GeoPoint prev = points[points.size() - 2];
     *outLat = last.lat;
     *outLon = last.lon;
     *outAngle = calculateBearing(prev.lat, prev.lon, last.lat, last.lon);
     return true;
 }
 
+// 重采样：累积距离表，cumulative[i] 为起点到第 i 个顶点的路径长度
+static void geo_cumulativeDistances(const CoordSpan& points, std::vector<double>& cumulative) {
+    cumulative.resize(points.size());
+    cumulative[0] = 0.0;
+    for (size_t i = 1; i < points.size(); ++i) {
+        cumulative[i] = cumulative[i - 1] + calculateDistance(points.latAt(i - 1), points.lonAt(i - 1), points.latAt(i), points.lonAt(i));
+    }
+}
+
+// 在顶点 [first, last] 之间按 intervals 等分插值，输出不含 first、含 last 的 intervals 个点
+static void geo_resampleRange(const CoordSpan& points, const std::vector<double>& cumulative,
+                              size_t first, size_t last, size_t intervals, std::vector<GeoPoint>& out) {
+    const double start = cumulative[first];
+    const double step = (cumulative[last] - start) / static_cast<double>(intervals);
+    size_t segment = first;
+    for (size_t k = 1; k < intervals; ++k) {
+        const double target = start + step * static_cast<double>(k);
+        while (segment + 1 < last && cumulative[segment + 1] < target) ++segment;
+        const double length = cumulative[segment + 1] - cumulative[segment];
+        const double fraction = length > 0.0 ? (target - cumulative[segment]) / length : 0.0;
+        const double lat0 = points.latAt(segment);
+        const double lon0 = points.lonAt(segment);
+        double dLon = points.lonAt(segment + 1) - lon0;
+        if (dLon > 180.0) dLon -= 360.0;
+        else if (dLon < -180.0) dLon += 360.0;
+        double lon = lon0 + dLon * fraction;
+        if (lon > 180.0) lon -= 360.0;
+        else if (lon < -180.0) lon += 360.0;
+        out.push_back({lat0 + (points.latAt(segment + 1) - lat0) * fraction, lon});
+    }
+    if (intervals > 0) out.push_back(points[last]);
+}
+
+static size_t geo_intervalsForSpacing(double length, double spacingMeters) {
+    if (!(length > 0.0)) return 0;
+    return static_cast<size_t>(std::max(1.0, std::round(length / spacingMeters)));
+}
+
+std::vector<GeoPoint> resamplePolyline(const std::vector<GeoPoint>& points, double spacingMeters) {
+    return resamplePolyline(CoordSpan(points), spacingMeters);
+}
+
+std::vector<GeoPoint> resamplePolyline(const CoordSpan& points, double spacingMeters) {
+    std::vector<GeoPoint> result;
+    if (points.empty()) return result;
+    if (!(spacingMeters > 0.0) || !std::isfinite(spacingMeters) || points.size() == 1) {
+        result.reserve(points.size());
+        for (size_t i = 0; i < points.size(); ++i) result.push_back(points[i]);
+        return result;
+    }
+
+    std::vector<double> cumulative;
+    geo_cumulativeDistances(points, cumulative);
+    const size_t intervals = geo_intervalsForSpacing(cumulative.back(), spacingMeters);
+    result.reserve(intervals + 1);
+    result.push_back(points[0]);
+    geo_resampleRange(points, cumulative, 0, points.size() - 1, intervals, result);
+    return result;
+}
+
+std::vector<GeoPoint> resamplePolylineByCount(const std::vector<GeoPoint>& points, size_t count) {
+    return resamplePolylineByCount(CoordSpan(points), count);
+}
+
+std::vector<GeoPoint> resamplePolylineByCount(const CoordSpan& points, size_t count) {
+    std::vector<GeoPoint> result;
+    if (points.empty() || count == 0) return result;
+    result.reserve(count);
+    result.push_back(points[0]);
+    if (count == 1) return result;
+    if (points.size() == 1) {
+        result.resize(count, points[0]);
+        return result;
+    }
+
+    std::vector<double> cumulative;
+    geo_cumulativeDistances(points, cumulative);
+    geo_resampleRange(points, cumulative, 0, points.size() - 1, count - 1, result);
+    return result;
+}
+
+std::vector<GeoPoint> resamplePolylinePreservingCorners(const std::vector<GeoPoint>& points, double spacingMeters, double cornerAngleDegrees) {
+    return resamplePolylinePreservingCorners(CoordSpan(points), spacingMeters, cornerAngleDegrees);
+}
+
+std::vector<GeoPoint> resamplePolylinePreservingCorners(const CoordSpan& points, double spacingMeters, double cornerAngleDegrees) {
+    if (!(spacingMeters > 0.0) || !std::isfinite(spacingMeters) || points.size() < 3) {
+        return resamplePolyline(points, spacingMeters);
+    }
+
+    std::vector<double> cumulative;
+    geo_cumulativeDistances(points, cumulative);
+    std::vector<GeoPoint> result;
+    result.reserve(geo_intervalsForSpacing(cumulative.back(), spacingMeters) + 2);
+    result.push_back(points[0]);
+
+    // 航向取自上一条非零长度的线段，重复点不会被误判为转角
+    size_t rangeStart = 0;
+    double previousBearing = std::numeric_limits<double>::quiet_NaN();
+    for (size_t i = 0; i + 1 < points.size(); ++i) {
+        if (cumulative[i + 1] == cumulative[i]) continue;
+        const double bearing = calculateBearing(points.latAt(i), points.lonAt(i), points.latAt(i + 1), points.lonAt(i + 1));
+        if (!std::isnan(previousBearing) && i > rangeStart) {
+            double turn = std::abs(bearing - previousBearing);
+            if (turn > 180.0) turn = 360.0 - turn;
+            if (turn > cornerAngleDegrees) {
+                geo_resampleRange(points, cumulative, rangeStart, i, geo_intervalsForSpacing(cumulative[i] - cumulative[rangeStart], spacingMeters), result);
+                rangeStart = i;
+            }
+        }
+        previousBearing = bearing;
+    }
+    const size_t last = points.size() - 1;
+    geo_resampleRange(points, cumulative, rangeStart, last, geo_intervalsForSpacing(cumulative[last] - cumulative[rangeStart], spacingMeters), result);
+    return result;
+}
+
 // Helper: Square of Euclidean distance
 static double distSq(double x1, double y1, double x2, double y2) {
     double dx = x1 - x2;
@@ -313,6 +739,10 @@ static double distSq(double x1, double y1, double x2, double y2) {
 }
 
 NearestPointResult getNearestPointOnPath(const std::vector<GeoPoint>& path, const GeoPoint& target) {
+    return getNearestPointOnPath(CoordSpan(path), target);
+}
+
+NearestPointResult getNearestPointOnPath(const CoordSpan& path, const GeoPoint& target) {
     NearestPointResult result = {0.0, 0.0, 0, std::numeric_limits<double>::max()};
     
     if (path.empty()) {
@@ -330,10 +760,10 @@ NearestPointResult getNearestPointOnPath(const std::vector<GeoPoint>& path, cons
     double minDistance = std::numeric_limits<double>::max();
     
     for (size_t i = 0; i < path.size() - 1; ++i) {
-        double ax = path[i].lat;
-        double ay = path[i].lon;
-        double bx = path[i+1].lat;
-        double by = path[i+1].lon;
+        double ax = path.latAt(i);
+        double ay = path.lonAt(i);
+        double bx = path.latAt(i + 1);
+        double by = path.lonAt(i + 1);
         
         // Project target (px, py) onto segment AB
         // Note: This treats lat/lon as cartesian for projection, which is an approximation
@@ -369,6 +799,10 @@ NearestPointResult getNearestPointOnPath(const std::vector<GeoPoint>& path, cons
 }
 
 GeoPoint calculateCentroid(const std::vector<GeoPoint>& polygon) {
+    return calculateCentroid(CoordSpan(polygon));
+}
+
+GeoPoint calculateCentroid(const CoordSpan& polygon) {
     if (polygon.empty()) {
         return {0.0, 0.0};
     }
@@ -383,14 +817,14 @@ GeoPoint calculateCentroid(const std::vector<GeoPoint>& polygon) {
     
     size_t n = polygon.size();
     // 确保多边形闭合
-    bool closed = (polygon[0].lat == polygon[n-1].lat && polygon[0].lon == polygon[n-1].lon);
+    bool closed = (polygon.latAt(0) == polygon.latAt(n - 1) && polygon.lonAt(0) == polygon.lonAt(n - 1));
     size_t limit = closed ? n - 1 : n;
     
     for (size_t i = 0; i < limit; ++i) {
-        double x0 = polygon[i].lat;
-        double y0 = polygon[i].lon;
-        double x1 = polygon[(i + 1) % n].lat;
-        double y1 = polygon[(i + 1) % n].lon;
+        double x0 = polygon.latAt(i);
+        double y0 = polygon.lonAt(i);
+        double x1 = polygon.latAt((i + 1) % n);
+        double y1 = polygon.lonAt((i + 1) % n);
         
         double a = x0 * y1 - x1 * y0;
         signedArea += a;
@@ -402,9 +836,9 @@ GeoPoint calculateCentroid(const std::vector<GeoPoint>& polygon) {
         // 退化为计算所有点的平均值
         double sumLat = 0.0;
         double sumLon = 0.0;
-        for(const auto& p : polygon) {
-            sumLat += p.lat;
-            sumLon += p.lon;
+        for (size_t i = 0; i < n; ++i) {
+            sumLat += polygon.latAt(i);
+            sumLon += polygon.lonAt(i);
         }
         return {sumLat / n, sumLon / n};
     }
@@ -416,215 +850,1755 @@ GeoPoint calculateCentroid(const std::vector<GeoPoint>& polygon) {
     return {cx, cy};
 }
 
-std::string encodeGeoHash(double lat, double lon, int precision) {
-    if (precision < 1) precision = 1;
-    if (precision > 12) precision = 12;
-    
-    static const char BASE32[] = "0123456789bcdefghjkmnpqrstuvwxyz";
-    std::string hash = "";
-    
-    double minLat = -90.0, maxLat = 90.0;
-    double minLon = -180.0, maxLon = 180.0;
-    
-    int bit = 0;
-    int ch = 0;
-    bool isEven = true;
-    
-    while (hash.length() < precision) {
-        if (isEven) {
-            double mid = (minLon + maxLon) / 2.0;
-            if (lon > mid) {
-                ch |= (1 << (4 - bit));
-                minLon = mid;
-            } else {
-                maxLon = mid;
-            }
-        } else {
-            double mid = (minLat + maxLat) / 2.0;
-            if (lat > mid) {
-                ch |= (1 << (4 - bit));
-                minLat = mid;
-            } else {
-                maxLat = mid;
-            }
-        }
-        
-        isEven = !isEven;
-        
-        if (bit < 4) {
-            bit++;
-        } else {
-            hash += BASE32[ch];
-            bit = 0;
-            ch = 0;
-        }
-    }
-    
-    return hash;
+// --- 坐标系转换 ---
+
+static constexpr double kGcjSemiMajorAxis = 6378245.0;  // Krasovsky 1940 椭球
+static constexpr double kGcjEccentricitySq = 0.00669342162296594323;
+static constexpr double kBdXPi = kPi * 3000.0 / 180.0;
+static constexpr double kCos35 = 0.81915204428899178969;
+static constexpr double kSin35 = 0.57357643635104609611;
+static constexpr double kInverseToleranceDegrees = 1e-8;  // 最后一次修正量的上限，修正后残差再缩小约三个数量级
+static constexpr int kInverseMaxIterations = 8;
+
+// 单位复数 (cos θ, sin θ)，由一次 sincos 经乘法递推出倍角
+struct geo_Rotation {
+    double c;
+    double s;
+};
+
+static inline geo_Rotation geo_rotate(const geo_Rotation& a, const geo_Rotation& b) {
+    return {a.c * b.c - a.s * b.s, a.s * b.c + a.c * b.s};
 }
 
-std::vector<GeoPoint> parsePolyline(const std::string& polylineStr) {
-    std::vector<GeoPoint> points;
-    if (polylineStr.empty()) {
-        return points;
-    }
+// 3θ
+static inline geo_Rotation geo_triple(const geo_Rotation& a) {
+    return {a.c * (4.0 * a.c * a.c - 3.0), a.s * (3.0 - 4.0 * a.s * a.s)};
+}
 
-    size_t start = 0;
-    size_t end = polylineStr.find(';');
-    
-    while (true) {
-        std::string segment = polylineStr.substr(start, end - start);
-        if (!segment.empty()) {
-            size_t comma = segment.find(',');
-            if (comma != std::string::npos) {
-                try {
-                    double lon = std::stod(segment.substr(0, comma));
-                    double lat = std::stod(segment.substr(comma + 1));
-                    points.push_back({lat, lon});
-                } catch (...) {
-                    // 忽略无效的坐标对
-                }
-            }
-        }
-        
-        if (end == std::string::npos) {
-            break;
-        }
-        
-        start = end + 1;
-        end = polylineStr.find(';', start);
-    }
-    
-    return points;
+static inline bool geo_inChina(double lat, double lon) {
+    return lon >= 72.004 && lon <= 137.8347 && lat >= 0.8293 && lat <= 55.8271;
 }
 
-PathBounds calculatePathBounds(const std::vector<GeoPoint>& points) {
-    PathBounds bounds = { -90.0, 90.0, -180.0, 180.0, 0.0, 0.0 };
-    
-    if (points.empty()) {
-        return bounds;
-    }
-    
-    double minLat = 90.0;
-    double maxLat = -90.0;
-    double minLon = 180.0;
-    double maxLon = -180.0;
-    
-    for (const auto& p : points) {
-        if (p.lat < minLat) minLat = p.lat;
-        if (p.lat > maxLat) maxLat = p.lat;
-        if (p.lon < minLon) minLon = p.lon;
-        if (p.lon > maxLon) maxLon = p.lon;
+// WGS-84 -> GCJ-02 的偏移（度），多项式与公开实现相同
+// 三角函数改由两个基角递推：u = πx/60 得到 πx/30、πx/12、πx/3、πx、2πx、6πx，
+// w = πy/180 得到 πy/30、πy/12、πy/3、πy，纬度 φ = w + 35°
+static inline void geo_gcjOffset(double lat, double lon, double& dLat, double& dLon) {
+    const double x = lon - 105.0;
+    const double y = lat - 35.0;
+
+    const double u = x * (kPi / 60.0);
+    const geo_Rotation u1{std::cos(u), std::sin(u)};
+    const geo_Rotation u2 = geo_rotate(u1, u1);
+    const geo_Rotation u4 = geo_rotate(u2, u2);
+    const geo_Rotation u5 = geo_rotate(u4, u1);
+    const geo_Rotation u10 = geo_rotate(u5, u5);
+    const geo_Rotation u20 = geo_rotate(u10, u10);
+    const geo_Rotation u60 = geo_triple(u20);
+    const double sin2PiX = 2.0 * u60.s * u60.c;
+    const double sin6PiX = sin2PiX * (3.0 - 4.0 * sin2PiX * sin2PiX);
+
+    const double w = y * kDegreesToRadians;
+    const geo_Rotation w1{std::cos(w), std::sin(w)};
+    const geo_Rotation w3 = geo_triple(w1);
+    const geo_Rotation w6 = geo_rotate(w3, w3);
+    const geo_Rotation w12 = geo_rotate(w6, w6);
+    const geo_Rotation w15 = geo_rotate(w12, w3);
+    const geo_Rotation w30 = geo_rotate(w15, w15);
+    const geo_Rotation w60 = geo_rotate(w30, w30);
+    const double sinPiY = w60.s * (3.0 - 4.0 * w60.s * w60.s);
+    const geo_Rotation phi = geo_rotate(w1, {kCos35, kSin35});
+
+    const double sqrtAbsX = std::sqrt(std::abs(x));
+    const double shared = (20.0 * sin6PiX + 20.0 * sin2PiX) * 2.0 / 3.0;
+    const double latTerm = -100.0 + 2.0 * x + 3.0 * y + 0.2 * y * y + 0.1 * x * y + 0.2 * sqrtAbsX + shared
+        + (20.0 * sinPiY + 40.0 * w60.s) * 2.0 / 3.0
+        + (160.0 * w15.s + 320.0 * w6.s) * 2.0 / 3.0;
+    const double lonTerm = 300.0 + x + 2.0 * y + 0.1 * x * x + 0.1 * x * y + 0.1 * sqrtAbsX + shared
+        + (20.0 * u60.s + 40.0 * u20.s) * 2.0 / 3.0
+        + (150.0 * u5.s + 300.0 * u2.s) * 2.0 / 3.0;
+
+    const double magic = 1.0 - kGcjEccentricitySq * phi.s * phi.s;
+    const double sqrtMagic = std::sqrt(magic);
+    dLat = latTerm * (magic * sqrtMagic) / (kGcjSemiMajorAxis * (1.0 - kGcjEccentricitySq)) * kRadiansToDegrees;
+    dLon = lonTerm * sqrtMagic / (kGcjSemiMajorAxis * phi.c) * kRadiansToDegrees;
+}
+
+// 境外（含非有限坐标）保持原值，用选择代替分支
+static inline void geo_wgs84ToGcj02(double& lat, double& lon) {
+    double dLat, dLon;
+    geo_gcjOffset(lat, lon, dLat, dLon);
+    const bool shift = geo_inChina(lat, lon);
+    lat = shift ? lat + dLat : lat;
+    lon = shift ? lon + dLon : lon;
+}
+
+// 不动点迭代 w ← w - (f(w) - g)，偏移对坐标的导数约 1e-3，每次迭代误差缩小约三个数量级
+static void geo_gcj02ToWgs84(double& lat, double& lon) {
+    if (!geo_inChina(lat, lon)) return;
+    const double targetLat = lat;
+    const double targetLon = lon;
+    for (int i = 0; i < kInverseMaxIterations; ++i) {
+        double dLat, dLon;
+        geo_gcjOffset(lat, lon, dLat, dLon);
+        const double errLat = lat + dLat - targetLat;
+        const double errLon = lon + dLon - targetLon;
+        lat -= errLat;
+        lon -= errLon;
+        if (std::abs(errLat) < kInverseToleranceDegrees && std::abs(errLon) < kInverseToleranceDegrees) break;
     }
-    
-    bounds.north = maxLat;
-    bounds.south = minLat;
-    bounds.east = maxLon;
-    bounds.west = minLon;
-    bounds.centerLat = (maxLat + minLat) / 2.0;
-    bounds.centerLon = (maxLon + minLon) / 2.0;
-    
-    return bounds;
 }
 
-// --- 瓦片与坐标转换 ---
+static inline void geo_gcj02ToBd09(double& lat, double& lon) {
+    const double z = std::sqrt(lon * lon + lat * lat) + 0.00002 * std::sin(lat * kBdXPi);
+    const double theta = std::atan2(lat, lon) + 0.000003 * std::cos(lon * kBdXPi);
+    lon = z * std::cos(theta) + 0.0065;
+    lat = z * std::sin(theta) + 0.006;
+}
 
-TileResult latLngToTile(double lat, double lon, int zoom) {
-    double n = std::pow(2.0, zoom);
-    int x = static_cast<int>((lon + 180.0) / 360.0 * n);
-    double latRad = geo_toRadians(lat);
-    int y = static_cast<int>((1.0 - std::asinh(std::tan(latRad)) / kPi) / 2.0 * n);
-    return {x, y, zoom};
+// 常用的近似逆公式误差约 1e-6°，以它为初值再做不动点迭代
+static void geo_bd09ToGcj02(double& lat, double& lon) {
+    const double targetLat = lat;
+    const double targetLon = lon;
+    const double x = lon - 0.0065;
+    const double y = lat - 0.006;
+    const double z = std::sqrt(x * x + y * y) - 0.00002 * std::sin(y * kBdXPi);
+    const double theta = std::atan2(y, x) - 0.000003 * std::cos(x * kBdXPi);
+    lon = z * std::cos(theta);
+    lat = z * std::sin(theta);
+    for (int i = 0; i < kInverseMaxIterations; ++i) {
+        double bdLat = lat;
+        double bdLon = lon;
+        geo_gcj02ToBd09(bdLat, bdLon);
+        const double errLat = bdLat - targetLat;
+        const double errLon = bdLon - targetLon;
+        lat -= errLat;
+        lon -= errLon;
+        if (std::abs(errLat) < kInverseToleranceDegrees && std::abs(errLon) < kInverseToleranceDegrees) break;
+    }
 }
 
-GeoPoint tileToLatLng(int x, int y, int zoom) {
-    double n = std::pow(2.0, zoom);
-    double lon = static_cast<double>(x) / n * 360.0 - 180.0;
-    double latRad = std::atan(std::sinh(kPi * (1.0 - 2.0 * static_cast<double>(y) / n)));
-    double lat = latRad * kRadiansToDegrees;
-    return {lat, lon};
+// 以 GCJ-02 为中转
+static inline void geo_convertCoordinate(double& lat, double& lon, CoordSystem from, CoordSystem to) {
+    if (from == to || !geo_isFinitePair(lat, lon)) return;
+    if (from == CoordSystem::WGS84) {
+        geo_wgs84ToGcj02(lat, lon);
+    } else if (from == CoordSystem::BD09) {
+        geo_bd09ToGcj02(lat, lon);
+    }
+    if (to == CoordSystem::WGS84) {
+        geo_gcj02ToWgs84(lat, lon);
+    } else if (to == CoordSystem::BD09) {
+        geo_gcj02ToBd09(lat, lon);
+    }
 }
 
-PixelResult latLngToPixel(double lat, double lon, int zoom) {
-    double n = std::pow(2.0, zoom) * 256.0; // 假设瓦片大小为 256x256
-    double x = (lon + 180.0) / 360.0 * n;
-    double latRad = geo_toRadians(lat);
-    double y = (1.0 - std::asinh(std::tan(latRad)) / kPi) / 2.0 * n;
-    return {x, y};
+bool isOutOfChina(double lat, double lon) {
+    return !geo_inChina(lat, lon);
 }
 
-GeoPoint pixelToLatLng(double x, double y, int zoom) {
-    double n = std::pow(2.0, zoom) * 256.0;
-    double lon = x / n * 360.0 - 180.0;
-    double latRad = std::atan(std::sinh(kPi * (1.0 - 2.0 * y / n)));
-    double lat = latRad * kRadiansToDegrees;
+GeoPoint convertCoordinate(double lat, double lon, CoordSystem from, CoordSystem to) {
+    geo_convertCoordinate(lat, lon, from, to);
     return {lat, lon};
 }
 
-double calculateFitZoomForPoints(
-    const std::vector<GeoPoint>& points,
-    double viewportWidthPx,
-    double viewportHeightPx,
-    double paddingPx,
-    int minZoom,
-    int maxZoom
-) {
-    if (minZoom > maxZoom) {
-        std::swap(minZoom, maxZoom);
-    }
-    if (points.empty()) {
-        return static_cast<double>(minZoom);
+void convertCoordinates(double* lat, double* lon, size_t count, CoordSystem from, CoordSystem to, size_t stride) {
+    if (count == 0 || lat == nullptr || lon == nullptr || from == to) return;
+    if (from == CoordSystem::WGS84 && to == CoordSystem::GCJ02) {
+        // 最常见的路径（GPS -> 高德）：无迭代、无分支
+        for (size_t i = 0; i < count; ++i) {
+            geo_wgs84ToGcj02(lat[i * stride], lon[i * stride]);
+        }
+        return;
     }
-    if (points.size() == 1) {
-        return static_cast<double>(maxZoom);
+    for (size_t i = 0; i < count; ++i) {
+        geo_convertCoordinate(lat[i * stride], lon[i * stride], from, to);
     }
+}
 
-    const double safeViewportWidth = viewportWidthPx > 1.0 ? viewportWidthPx : 390.0;
-    const double safeViewportHeight = viewportHeightPx > 1.0 ? viewportHeightPx : 844.0;
-    const double safePadding = std::max(0.0, paddingPx);
-    const double availableWidth = std::max(1.0, safeViewportWidth - safePadding * 2.0);
-    const double availableHeight = std::max(1.0, safeViewportHeight - safePadding * 2.0);
+void convertCoordinates(std::vector<GeoPoint>& points, CoordSystem from, CoordSystem to) {
+    if (points.empty()) return;
+    convertCoordinates(&points[0].lat, &points[0].lon, points.size(), from, to, sizeof(GeoPoint) / sizeof(double));
+}
 
-    std::vector<double> projectedXs;
-    projectedXs.reserve(points.size());
+// --- GeoHash ---
+// 精度 p 对应 5p 个比特，经度、纬度比特交错排列（最高位为经度），经度占 ceil(5p/2) 位，纬度占 floor(5p/2) 位
+// 编码在整数域完成：先把经纬度量化为网格下标，再用位运算交错，避免逐位二分
 
-    double minY = std::numeric_limits<double>::max();
-    double maxY = -std::numeric_limits<double>::max();
+static constexpr int kGeoHashMaxPrecision = 12;
+static constexpr char kGeoHashBase32[] = "0123456789bcdefghjkmnpqrstuvwxyz";
 
-    for (const auto& p : points) {
-        projectedXs.push_back(mercatorX01(p.lon));
-        const double y = mercatorY01(p.lat);
-        if (y < minY) minY = y;
-        if (y > maxY) maxY = y;
+struct geo_GeoHashDecodeTable {
+    int8_t values[256];
+
+    constexpr geo_GeoHashDecodeTable() : values() {
+        for (int i = 0; i < 256; ++i) values[i] = -1;
+        for (int i = 0; i < 32; ++i) {
+            const char c = kGeoHashBase32[i];
+            values[static_cast<unsigned char>(c)] = static_cast<int8_t>(i);
+            if (c >= 'a' && c <= 'z') {
+                values[static_cast<unsigned char>(c - 'a' + 'A')] = static_cast<int8_t>(i);
+            }
+        }
     }
+};
 
-    const double spanX = wrappedSpan01(projectedXs);
-    const double spanY = std::max(0.0, maxY - minY);
-    static constexpr double kTileSize = 256.0;
-    static constexpr double kSpanEpsilon = 1e-12;
+static constexpr geo_GeoHashDecodeTable kGeoHashDecodeTable{};
 
-    const double zoomX = spanX <= kSpanEpsilon
-        ? static_cast<double>(maxZoom)
-        : std::log2(availableWidth / (kTileSize * spanX));
-    const double zoomY = spanY <= kSpanEpsilon
-        ? static_cast<double>(maxZoom)
-        : std::log2(availableHeight / (kTileSize * spanY));
+static inline int geo_clampGeoHashPrecision(int precision) {
+    return std::max(1, std::min(kGeoHashMaxPrecision, precision));
+}
 
-    double fitZoom = std::min(zoomX, zoomY);
-    if (!std::isfinite(fitZoom)) {
-        fitZoom = static_cast<double>(minZoom);
-    }
+// 把低 32 位分散到偶数位：abcd -> 0a0b0c0d
+static inline uint64_t geo_spreadBits(uint32_t value) {
+#if defined(__BMI2__)
+    return _pdep_u64(value, 0x5555555555555555ULL);
+#else
+    uint64_t x = value;
+    x = (x | (x << 16)) & 0x0000FFFF0000FFFFULL;
+    x = (x | (x << 8)) & 0x00FF00FF00FF00FFULL;
+    x = (x | (x << 4)) & 0x0F0F0F0F0F0F0F0FULL;
+    x = (x | (x << 2)) & 0x3333333333333333ULL;
+    x = (x | (x << 1)) & 0x5555555555555555ULL;
+    return x;
+#endif
+}
 
-    if (fitZoom < static_cast<double>(minZoom)) {
-        fitZoom = static_cast<double>(minZoom);
-    } else if (fitZoom > static_cast<double>(maxZoom)) {
-        fitZoom = static_cast<double>(maxZoom);
-    }
+// geo_spreadBits 的逆运算：取出偶数位
+static inline uint32_t geo_compactBits(uint64_t value) {
+#if defined(__BMI2__)
+    return static_cast<uint32_t>(_pext_u64(value, 0x5555555555555555ULL));
+#else
+    uint64_t x = value & 0x5555555555555555ULL;
+    x = (x | (x >> 1)) & 0x3333333333333333ULL;
+    x = (x | (x >> 2)) & 0x0F0F0F0F0F0F0F0FULL;
+    x = (x | (x >> 4)) & 0x00FF00FF00FF00FFULL;
+    x = (x | (x >> 8)) & 0x0000FFFF0000FFFFULL;
+    x = (x | (x >> 16)) & 0x00000000FFFFFFFFULL;
+    return static_cast<uint32_t>(x);
+#endif
+}
 
-    return fitZoom;
+// 量化为 [0, 2^bits) 的网格下标
+// 与逐位二分的约定一致：恰好落在分界线上的值归入较小的一侧，超出范围的值截断到首尾网格
+// (value - min) / span 的舍入会让紧贴分界线的值落错网格，因此再与精确的分界线 min + k * span / 2^bits
+// 比较修正（span 为 180/360，分界线在 double 中可精确表示，与二分时的中点相同）
+static inline uint32_t geo_quantizeGeoHash(double value, double min, double span, int bits) {
+    const uint32_t maxIndex = static_cast<uint32_t>((uint64_t(1) << bits) - 1);
+    const double cells = static_cast<double>(uint64_t(1) << bits);
+    const double cellSize = span / cells;
+    const double scaled = (value - min) / span * cells;
+    if (!(scaled > 0.0)) return 0;  // 同时处理 NaN
+    uint32_t index = scaled >= cells ? maxIndex : static_cast<uint32_t>(std::ceil(scaled) - 1.0);
+    while (index > 0 && !(value > min + cellSize * index)) --index;
+    while (index < maxIndex && value > min + cellSize * (index + 1)) ++index;
+    return index;
 }
 
-// --- 批量地理围栏与热力图 ---
+static inline uint64_t geo_interleaveGeoHash(uint32_t latIndex, uint32_t lonIndex, int totalBits) {
+    // 总位数为奇数时经度多一位，最高位落在偶数位上
+    return (totalBits & 1)
+        ? geo_spreadBits(lonIndex) | (geo_spreadBits(latIndex) << 1)
+        : (geo_spreadBits(lonIndex) << 1) | geo_spreadBits(latIndex);
+}
+
+static inline void geo_writeGeoHash(uint32_t latIndex, uint32_t lonIndex, int precision, char* out) {
+    const uint64_t bits = geo_interleaveGeoHash(latIndex, lonIndex, precision * 5);
+    for (int i = 0; i < precision; ++i) {
+        out[i] = kGeoHashBase32[(bits >> (5 * (precision - 1 - i))) & 31];
+    }
+}
+
+static inline void geo_encodeGeoHash(double lat, double lon, int precision, char* out) {
+    const int totalBits = precision * 5;
+    const int latBits = totalBits / 2;
+    const int lonBits = totalBits - latBits;
+    geo_writeGeoHash(
+        geo_quantizeGeoHash(lat, -90.0, 180.0, latBits),
+        geo_quantizeGeoHash(lon, -180.0, 360.0, lonBits),
+        precision,
+        out
+    );
+}
+
+// 解析 GeoHash 为网格下标，非法字符或长度返回 false
+static bool geo_parseGeoHash(const char* hash, size_t length, uint32_t& latIndex, uint32_t& lonIndex) {
+    if (hash == nullptr || length == 0 || length > static_cast<size_t>(kGeoHashMaxPrecision)) {
+        return false;
+    }
+    uint64_t bits = 0;
+    for (size_t i = 0; i < length; ++i) {
+        const int v = kGeoHashDecodeTable.values[static_cast<unsigned char>(hash[i])];
+        if (v < 0) return false;
+        bits = (bits << 5) | static_cast<uint64_t>(v);
+    }
+    if (length & 1) {
+        lonIndex = geo_compactBits(bits);
+        latIndex = geo_compactBits(bits >> 1);
+    } else {
+        lonIndex = geo_compactBits(bits >> 1);
+        latIndex = geo_compactBits(bits);
+    }
+    return true;
+}
+
+static inline PathBounds geo_geoHashBounds(uint32_t latIndex, uint32_t lonIndex, int precision) {
+    const int totalBits = precision * 5;
+    const int latBits = totalBits / 2;
+    const int lonBits = totalBits - latBits;
+    const double latStep = std::ldexp(180.0, -latBits);
+    const double lonStep = std::ldexp(360.0, -lonBits);
+
+    PathBounds bounds;
+    bounds.south = -90.0 + latIndex * latStep;
+    bounds.north = bounds.south + latStep;
+    bounds.west = -180.0 + lonIndex * lonStep;
+    bounds.east = bounds.west + lonStep;
+    bounds.centerLat = bounds.south + latStep * 0.5;
+    bounds.centerLon = bounds.west + lonStep * 0.5;
+    return bounds;
+}
+
+std::string encodeGeoHash(double lat, double lon, int precision) {
+    precision = geo_clampGeoHashPrecision(precision);
+    std::string hash(static_cast<size_t>(precision), '0');
+    geo_encodeGeoHash(lat, lon, precision, &hash[0]);
+    return hash;
+}
+
+int encodeGeoHashes(const CoordSpan& points, int precision, char* out) {
+    precision = geo_clampGeoHashPrecision(precision);
+    if (out == nullptr) return precision;
+    for (size_t i = 0; i < points.size(); ++i) {
+        geo_encodeGeoHash(points.latAt(i), points.lonAt(i), precision, out + i * precision);
+    }
+    return precision;
+}
+
+int encodeGeoHashes(const std::vector<GeoPoint>& points, int precision, char* out) {
+    return encodeGeoHashes(CoordSpan(points), precision, out);
+}
+
+bool decodeGeoHash(const char* hash, size_t length, PathBounds& out) {
+    uint32_t latIndex = 0;
+    uint32_t lonIndex = 0;
+    if (!geo_parseGeoHash(hash, length, latIndex, lonIndex)) {
+        return false;
+    }
+    out = geo_geoHashBounds(latIndex, lonIndex, static_cast<int>(length));
+    return true;
+}
+
+bool decodeGeoHash(const std::string& hash, PathBounds& out) {
+    return decodeGeoHash(hash.data(), hash.size(), out);
+}
+
+size_t decodeGeoHashes(const char* hashes, size_t count, int width, PathBounds* out) {
+    if (hashes == nullptr || out == nullptr) return 0;
+    const double nan = std::numeric_limits<double>::quiet_NaN();
+    const PathBounds invalid = {nan, nan, nan, nan, nan, nan};
+    size_t decoded = 0;
+    for (size_t i = 0; i < count; ++i) {
+        if (width >= 1 && decodeGeoHash(hashes + i * width, static_cast<size_t>(width), out[i])) {
+            ++decoded;
+        } else {
+            out[i] = invalid;
+        }
+    }
+    return decoded;
+}
+
+std::string getGeoHashNeighbor(const std::string& hash, int latSteps, int lonSteps) {
+    uint32_t latIndex = 0;
+    uint32_t lonIndex = 0;
+    if (!geo_parseGeoHash(hash.data(), hash.size(), latIndex, lonIndex)) {
+        return std::string();
+    }
+    const int precision = static_cast<int>(hash.size());
+    const int totalBits = precision * 5;
+    const int latBits = totalBits / 2;
+    const int lonBits = totalBits - latBits;
+
+    const int64_t lat = static_cast<int64_t>(latIndex) + latSteps;
+    if (lat < 0 || lat >= (int64_t(1) << latBits)) {
+        return std::string();
+    }
+    // 经度下标按 2^lonBits 取模回绕
+    const uint64_t lonMask = (uint64_t(1) << lonBits) - 1;
+    const uint64_t lon = static_cast<uint64_t>(static_cast<int64_t>(lonIndex) + lonSteps) & lonMask;
+
+    std::string neighbor(hash.size(), '0');
+    geo_writeGeoHash(static_cast<uint32_t>(lat), static_cast<uint32_t>(lon), precision, &neighbor[0]);
+    return neighbor;
+}
+
+std::vector<std::string> getGeoHashNeighbors(const std::string& hash) {
+    static const int kOffsets[8][2] = {
+        {1, 0}, {1, 1}, {0, 1}, {-1, 1}, {-1, 0}, {-1, -1}, {0, -1}, {1, -1}
+    };
+    uint32_t latIndex = 0;
+    uint32_t lonIndex = 0;
+    if (!geo_parseGeoHash(hash.data(), hash.size(), latIndex, lonIndex)) {
+        return {};
+    }
+    std::vector<std::string> neighbors;
+    neighbors.reserve(8);
+    for (const auto& offset : kOffsets) {
+        neighbors.push_back(getGeoHashNeighbor(hash, offset[0], offset[1]));
+    }
+    return neighbors;
+}
+
+std::vector<std::string> coverBoundsWithGeoHashes(
+    double south,
+    double west,
+    double north,
+    double east,
+    int precision,
+    size_t maxCells
+) {
+    if (!std::isfinite(south) || !std::isfinite(west) || !std::isfinite(north) || !std::isfinite(east)) {
+        return {};
+    }
+    precision = geo_clampGeoHashPrecision(precision);
+    const int totalBits = precision * 5;
+    const int latBits = totalBits / 2;
+    const int lonBits = totalBits - latBits;
+    const uint64_t lonCells = uint64_t(1) << lonBits;
+
+    // 南北颠倒是空矩形，不是跨经线的矩形
+    if (south > north) {
+        return {};
+    }
+    // west > east 只有两者都在 [-180, 180] 内时才表示跨 180° 经线，否则同样视为空矩形
+    if (west > east && (west > 180.0 || east < -180.0)) {
+        return {};
+    }
+    const uint32_t latBegin = geo_quantizeGeoHash(south, -90.0, 180.0, latBits);
+    const uint32_t latEnd = geo_quantizeGeoHash(north, -90.0, 180.0, latBits);
+
+    // 经度区间：跨度 >= 360° 时覆盖整圈，west > east 时跨 180° 经线分为两段
+    uint64_t lonBegin = 0;
+    uint64_t lonCount = lonCells;
+    if (east - west < 360.0) {
+        // 西边界归一化到 [-180, 180)，东边界归一化到 (-180, 180]
+        const double wrappedWest = west - 360.0 * std::floor((west + 180.0) / 360.0);
+        const double wrappedEast = east - 360.0 * std::ceil((east - 180.0) / 360.0);
+        lonBegin = geo_quantizeGeoHash(wrappedWest, -180.0, 360.0, lonBits);
+        const uint64_t lonLast = geo_quantizeGeoHash(wrappedEast, -180.0, 360.0, lonBits);
+        lonCount = (lonLast >= lonBegin ? lonLast - lonBegin : lonLast + lonCells - lonBegin) + 1;
+    }
+
+    const uint64_t latCount = static_cast<uint64_t>(latEnd - latBegin) + 1;
+    if (latCount > maxCells || lonCount > maxCells / latCount) {
+        return {};
+    }
+
+    std::vector<std::string> hashes;
+    hashes.reserve(static_cast<size_t>(latCount * lonCount));
+    std::string hash(static_cast<size_t>(precision), '0');
+    for (uint32_t lat = latBegin; lat <= latEnd; ++lat) {
+        for (uint64_t i = 0; i < lonCount; ++i) {
+            const uint64_t lon = (lonBegin + i) & (lonCells - 1);
+            geo_writeGeoHash(lat, static_cast<uint32_t>(lon), precision, &hash[0]);
+            hashes.push_back(hash);
+        }
+    }
+    return hashes;
+}
+
+// strtod 读完数值后，记号内只能剩下空白（与 JS 端 Number(token.trim()) 一致，"116.1abc" 视为非法）
+static bool geo_consumedToken(const char* parsedEnd, const char* tokenEnd) {
+    while (parsedEnd < tokenEnd && std::isspace(static_cast<unsigned char>(*parsedEnd))) {
+        ++parsedEnd;
+    }
+    return parsedEnd == tokenEnd;
+}
+
+// 解析 [begin, end) 内单个 "lng,lat" 坐标对，不产生临时字符串
+// 输入来自 std::string，保证以 '\0' 结尾，strtod 不会越过缓冲区
+static bool geo_parseCoordinatePair(const char* begin, const char* end, GeoPoint& out) {
+    const char* comma = static_cast<const char*>(std::memchr(begin, ',', static_cast<size_t>(end - begin)));
+    if (comma == nullptr) {
+        return false;
+    }
+
+    char* parsedEnd = nullptr;
+    const double lon = std::strtod(begin, &parsedEnd);
+    if (parsedEnd == begin || parsedEnd > comma || !geo_consumedToken(parsedEnd, comma)) {
+        return false;
+    }
+
+    // 纬度之后的多余字段忽略（JS 端只取前两个字段）
+    const char* latEnd = static_cast<const char*>(std::memchr(comma + 1, ',', static_cast<size_t>(end - comma - 1)));
+    if (latEnd == nullptr) {
+        latEnd = end;
+    }
+    const double lat = std::strtod(comma + 1, &parsedEnd);
+    if (parsedEnd == comma + 1 || parsedEnd > latEnd || !geo_consumedToken(parsedEnd, latEnd)) {
+        return false;
+    }
+
+    if (!std::isfinite(lat) || !std::isfinite(lon)) {
+        return false;
+    }
+
+    out.lat = lat;
+    out.lon = lon;
+    return true;
+}
+
+// 解析 [begin, end) 内以 ';' 分隔的坐标点并追加到 points
+static void geo_parseCoordinateRun(const char* begin, const char* end, bool dedupeAdjacent, size_t ringStart, std::vector<GeoPoint>& points) {
+    const char* cursor = begin;
+    while (cursor < end) {
+        const char* separator = static_cast<const char*>(std::memchr(cursor, ';', static_cast<size_t>(end - cursor)));
+        const char* segmentEnd = separator ? separator : end;
+
+        GeoPoint point;
+        if (segmentEnd > cursor && geo_parseCoordinatePair(cursor, segmentEnd, point)) {
+            const bool duplicate = dedupeAdjacent &&
+                points.size() > ringStart &&
+                points.back().lat == point.lat &&
+                points.back().lon == point.lon;
+            if (!duplicate) {
+                points.push_back(point);
+            }
+        }
+
+        if (separator == nullptr) {
+            break;
+        }
+        cursor = separator + 1;
+    }
+}
+
+std::vector<GeoPoint> parsePolyline(const std::string& polylineStr) {
+    std::vector<GeoPoint> points;
+    if (polylineStr.empty()) {
+        return points;
+    }
+
+    // 每个坐标对至少 "x,y;" 四个字符，按 1/16 预估可避免多数扩容
+    points.reserve(polylineStr.size() / 16 + 1);
+    const char* data = polylineStr.c_str();
+    geo_parseCoordinateRun(data, data + polylineStr.size(), false, 0, points);
+    return points;
+}
+
+PolylineRings parsePolylineRings(const std::string& polylineStr, bool dedupeAdjacent) {
+    PolylineRings result;
+    if (polylineStr.empty()) {
+        result.ringOffsets.push_back(0);
+        return result;
+    }
+
+    result.points.reserve(polylineStr.size() / 16 + 1);
+    const char* data = polylineStr.c_str();
+    const char* end = data + polylineStr.size();
+    const char* cursor = data;
+
+    while (cursor <= end) {
+        const char* separator = static_cast<const char*>(std::memchr(cursor, '|', static_cast<size_t>(end - cursor)));
+        const char* ringEnd = separator ? separator : end;
+
+        const size_t ringStart = result.points.size();
+        geo_parseCoordinateRun(cursor, ringEnd, dedupeAdjacent, ringStart, result.points);
+        if (result.points.size() > ringStart) {
+            result.ringOffsets.push_back(static_cast<int>(ringStart));
+        }
+
+        if (separator == nullptr) {
+            break;
+        }
+        cursor = separator + 1;
+    }
+
+    result.ringOffsets.push_back(static_cast<int>(result.points.size()));
+    return result;
+}
+
+static inline int geo_clampPolylinePrecision(int precision) {
+    if (precision < 1) return 1;
+    if (precision > 9) return 9;
+    return precision;
+}
+
+static inline double geo_polylineScale(int precision) {
+    static constexpr double kScales[] = {1.0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9};
+    return kScales[geo_clampPolylinePrecision(precision)];
+}
+
+// zigzag 后按 5 位一组写出，除最后一组外均置续位 0x20，再偏移 63 落到可打印字符
+// 编码前的坐标（乘以精度系数后）上限，差分后仍远小于 int64 范围
+static constexpr double kGeoMaxEncodedValue = 4503599627370496.0;  // 2^52
+
+static void geo_appendEncodedValue(int64_t value, std::string& out) {
+    uint64_t zigzag = (static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63);
+    while (zigzag >= 0x20) {
+        out.push_back(static_cast<char>((0x20 | (zigzag & 0x1f)) + 63));
+        zigzag >>= 5;
+    }
+    out.push_back(static_cast<char>(zigzag + 63));
+}
+
+// 解码端的坐标累加：合法数据的差分绝对值 < 2^53、坐标绝对值 < 2^52，超出即视为非法数据，
+// 先检查差分再相加，保证 int64 累加不会溢出
+static bool geo_accumulateDecodedValue(int64_t& value, int64_t delta) {
+    constexpr int64_t kMaxValue = int64_t(1) << 52;
+    if (delta <= -2 * kMaxValue || delta >= 2 * kMaxValue) {
+        return false;
+    }
+    const int64_t next = value + delta;
+    if (next <= -kMaxValue || next >= kMaxValue) {
+        return false;
+    }
+    value = next;
+    return true;
+}
+
+static bool geo_readEncodedValue(const char*& cursor, const char* end, int64_t& out) {
+    uint64_t result = 0;
+    int shift = 0;
+    while (cursor < end) {
+        const int chunk = static_cast<unsigned char>(*cursor++) - 63;
+        if (chunk < 0 || chunk > 0x3f) {
+            return false;
+        }
+        result |= static_cast<uint64_t>(chunk & 0x1f) << shift;
+        if (chunk < 0x20) {
+            out = static_cast<int64_t>(result >> 1) ^ -static_cast<int64_t>(result & 1);
+            return true;
+        }
+        shift += 5;
+        if (shift > 60) {
+            return false;
+        }
+    }
+    return false;
+}
+
+std::string encodePolyline(const std::vector<GeoPoint>& points, int precision) {
+    return encodePolyline(CoordSpan(points), precision);
+}
+
+std::string encodePolyline(const CoordSpan& points, int precision) {
+    std::string encoded;
+    if (points.empty()) {
+        return encoded;
+    }
+
+    const double scale = geo_polylineScale(precision);
+    // 相邻点差分后通常只需 1~4 个字符
+    encoded.reserve(points.size() * 8);
+
+    int64_t prevLat = 0;
+    int64_t prevLon = 0;
+    for (size_t i = 0; i < points.size(); ++i) {
+        const double scaledLat = points.latAt(i) * scale;
+        const double scaledLon = points.lonAt(i) * scale;
+        // NaN / ±∞ 或超出 int64 范围的坐标对 llround 是未定义行为，跳过该点（解码端同样只输出有效点）
+        if (!(std::abs(scaledLat) < kGeoMaxEncodedValue) || !(std::abs(scaledLon) < kGeoMaxEncodedValue)) {
+            continue;
+        }
+        const int64_t lat = std::llround(scaledLat);
+        const int64_t lon = std::llround(scaledLon);
+        geo_appendEncodedValue(lat - prevLat, encoded);
+        geo_appendEncodedValue(lon - prevLon, encoded);
+        prevLat = lat;
+        prevLon = lon;
+    }
+
+    return encoded;
+}
+
+std::vector<GeoPoint> decodePolyline(const std::string& encoded, int precision) {
+    std::vector<GeoPoint> points;
+    if (encoded.empty()) {
+        return points;
+    }
+
+    const double scale = geo_polylineScale(precision);
+    points.reserve(encoded.size() / 4 + 1);
+
+    const char* cursor = encoded.data();
+    const char* end = cursor + encoded.size();
+    int64_t lat = 0;
+    int64_t lon = 0;
+    while (cursor < end) {
+        int64_t dLat = 0;
+        int64_t dLon = 0;
+        if (!geo_readEncodedValue(cursor, end, dLat) || !geo_readEncodedValue(cursor, end, dLon)) {
+            break;
+        }
+        if (!geo_accumulateDecodedValue(lat, dLat) || !geo_accumulateDecodedValue(lon, dLon)) {
+            break;
+        }
+        points.push_back({static_cast<double>(lat) / scale, static_cast<double>(lon) / scale});
+    }
+
+    return points;
+}
+
+PathBounds calculatePathBounds(const std::vector<GeoPoint>& points) {
+    return calculatePathBounds(CoordSpan(points));
+}
+
+PathBounds calculatePathBounds(const CoordSpan& points) {
+    PathBounds bounds = { -90.0, 90.0, -180.0, 180.0, 0.0, 0.0 };
+    
+    if (points.empty()) {
+        return bounds;
+    }
+    
+    double minLat = 90.0;
+    double maxLat = -90.0;
+    double minLon = 180.0;
+    double maxLon = -180.0;
+    
+    for (size_t i = 0; i < points.size(); ++i) {
+        const double lat = points.latAt(i);
+        const double lon = points.lonAt(i);
+        if (lat < minLat) minLat = lat;
+        if (lat > maxLat) maxLat = lat;
+        if (lon < minLon) minLon = lon;
+        if (lon > maxLon) maxLon = lon;
+    }
+    
+    bounds.north = maxLat;
+    bounds.south = minLat;
+    bounds.east = maxLon;
+    bounds.west = minLon;
+    bounds.centerLat = (maxLat + minLat) / 2.0;
+    bounds.centerLon = (maxLon + minLon) / 2.0;
+    
+    return bounds;
+}
+
+// --- 瓦片与坐标转换 ---
+
+TileResult latLngToTile(double lat, double lon, int zoom) {
+    double n = geo_zoomScale(zoom);
+    int x = static_cast<int>((lon + 180.0) / 360.0 * n);
+    int y = static_cast<int>(geo_mercatorY01Unclamped(lat) * n);
+    return {x, y, zoom};
+}
+
+GeoPoint tileToLatLng(int x, int y, int zoom) {
+    double n = geo_zoomScale(zoom);
+    double lon = static_cast<double>(x) / n * 360.0 - 180.0;
+    double lat = geo_latitudeAtMercatorY01(static_cast<double>(y) / n);
+    return {lat, lon};
+}
+
+PixelResult latLngToPixel(double lat, double lon, int zoom) {
+    double n = geo_zoomScale(zoom) * 256.0; // 假设瓦片大小为 256x256
+    double x = (lon + 180.0) / 360.0 * n;
+    double y = geo_mercatorY01Unclamped(lat) * n;
+    return {x, y};
+}
+
+GeoPoint pixelToLatLng(double x, double y, int zoom) {
+    double n = geo_zoomScale(zoom) * 256.0;
+    double lon = x / n * 360.0 - 180.0;
+    double lat = geo_latitudeAtMercatorY01(y / n);
+    return {lat, lon};
+}
+
+void latLngToPixels(const CoordSpan& points, double zoom, double* outX, double* outY) {
+    const size_t n = points.size();
+    if (n == 0 || outX == nullptr || outY == nullptr) return;
+    const double worldSize = geo_zoomScale(zoom) * 256.0;
+
+    // x 只有算术运算，单独一趟便于向量化；运算顺序与 latLngToPixel 相同，结果逐位一致
+    for (size_t i = 0; i < n; ++i) {
+        outX[i] = (points.lonAt(i) + 180.0) / 360.0 * worldSize;
+    }
+    for (size_t i = 0; i < n; ++i) {
+        outY[i] = geo_mercatorY01Unclamped(points.latAt(i)) * worldSize;
+    }
+}
+
+void pixelsToLatLngs(const double* xs, const double* ys, size_t count, double zoom, double* outLat, double* outLon) {
+    if (count == 0 || xs == nullptr || ys == nullptr || outLat == nullptr || outLon == nullptr) return;
+    const double worldSize = geo_zoomScale(zoom) * 256.0;
+
+    for (size_t i = 0; i < count; ++i) {
+        outLon[i] = xs[i] / worldSize * 360.0 - 180.0;
+    }
+    for (size_t i = 0; i < count; ++i) {
+        outLat[i] = geo_latitudeAtMercatorY01(ys[i] / worldSize);
+    }
+}
+
+void latLngToTiles(const CoordSpan& points, int zoom, int* outX, int* outY) {
+    const size_t n = points.size();
+    if (n == 0 || outX == nullptr || outY == nullptr) return;
+    zoom = std::max(0, std::min(30, zoom));
+    const double tiles = geo_zoomScale(zoom);
+    const int maxIndex = static_cast<int>(tiles) - 1;
+
+    for (size_t i = 0; i < n; ++i) {
+        const double x = std::floor(mercatorX01(points.lonAt(i)) * tiles);
+        outX[i] = x > maxIndex ? maxIndex : static_cast<int>(x);
+    }
+    for (size_t i = 0; i < n; ++i) {
+        const double y = std::floor(geo_mercatorY01Unclamped(clampMercatorLatitude(points.latAt(i))) * tiles);
+        outY[i] = !(y > 0.0) ? 0 : (y > maxIndex ? maxIndex : static_cast<int>(y));
+    }
+}
+
+ScreenViewport makeScreenViewport(double centerLat, double centerLon, double zoom, double width, double height, double margin) {
+    const double worldSize = geo_zoomScale(zoom) * 256.0;
+    ScreenViewport viewport;
+    viewport.originX = (centerLon + 180.0) / 360.0 * worldSize - width * 0.5;
+    viewport.originY = geo_mercatorY01Unclamped(clampMercatorLatitude(centerLat)) * worldSize - height * 0.5;
+    viewport.zoom = zoom;
+    viewport.width = width;
+    viewport.height = height;
+    viewport.margin = margin;
+    return viewport;
+}
+
+size_t projectToScreen(const CoordSpan& points, const ScreenViewport& viewport, float* outX, float* outY, uint8_t* outVisible) {
+    const size_t n = points.size();
+    if (n == 0 || outX == nullptr || outY == nullptr) return 0;
+    const double worldSize = geo_zoomScale(viewport.zoom) * 256.0;
+    // 视口中心相对于原点的偏移，用于选择最近的世界副本
+    const double halfWidth = viewport.width * 0.5;
+    const double minVisibleX = -viewport.margin;
+    const double maxVisibleX = viewport.width + viewport.margin;
+    const double minVisibleY = -viewport.margin;
+    const double maxVisibleY = viewport.height + viewport.margin;
+
+    size_t visible = 0;
+    for (size_t i = 0; i < n; ++i) {
+        const double lat = points.latAt(i);
+        const double lon = points.lonAt(i);
+        if (!std::isfinite(lat) || !std::isfinite(lon)) {
+            outX[i] = std::numeric_limits<float>::quiet_NaN();
+            outY[i] = std::numeric_limits<float>::quiet_NaN();
+            if (outVisible != nullptr) outVisible[i] = 0;
+            continue;
+        }
+        double dx = (lon + 180.0) / 360.0 * worldSize - viewport.originX;
+        dx -= worldSize * std::round((dx - halfWidth) / worldSize);
+        const double dy = geo_mercatorY01Unclamped(clampMercatorLatitude(lat)) * worldSize - viewport.originY;
+        outX[i] = static_cast<float>(dx);
+        outY[i] = static_cast<float>(dy);
+        const bool inside = dx >= minVisibleX && dx <= maxVisibleX && dy >= minVisibleY && dy <= maxVisibleY;
+        if (outVisible != nullptr) outVisible[i] = inside ? 1 : 0;
+        visible += inside ? 1 : 0;
+    }
+    return visible;
+}
+
+// --- 视口裁剪 ---
+
+struct geo_ClipRect {
+    double minX;
+    double minY;
+    double maxX;
+    double maxY;
+};
+
+static constexpr size_t kClipNewPoint = std::numeric_limits<size_t>::max();
+
+// 投影到屏幕像素坐标并去掉过近的点；第一个点取离视口中心最近的世界副本，之后相对上一个点展开经度
+static void geo_projectForClip(const CoordSpan& points, const ScreenViewport& viewport, double tolerancePx, bool keepLast, std::vector<Point2D>& out) {
+    const double worldSize = geo_zoomScale(viewport.zoom) * 256.0;
+    const double sqTolerance = tolerancePx > 0.0 ? tolerancePx * tolerancePx : 0.0;
+    out.clear();
+    out.reserve(points.size());
+    double previousLon = 0.0;
+    double previousX = 0.0;
+    size_t lastValid = kClipNewPoint;
+    for (size_t i = 0; i < points.size(); ++i) {
+        const double lat = points.latAt(i);
+        const double lon = points.lonAt(i);
+        if (!geo_isFinitePair(lat, lon)) continue;
+        double x;
+        if (lastValid == kClipNewPoint) {
+            x = (lon + 180.0) / 360.0 * worldSize - viewport.originX;
+            x -= worldSize * std::round((x - viewport.width * 0.5) / worldSize);
+        } else {
+            x = previousX + std::remainder(lon - previousLon, 360.0) / 360.0 * worldSize;
+        }
+        previousLon = lon;
+        previousX = x;
+        lastValid = i;
+        const double y = geo_mercatorY01Unclamped(clampMercatorLatitude(lat)) * worldSize - viewport.originY;
+        if (!out.empty()) {
+            const double dx = x - out.back().x;
+            const double dy = y - out.back().y;
+            const double sqDistance = dx * dx + dy * dy;
+            if (sqDistance == 0.0 || sqDistance < sqTolerance) continue;
+        }
+        out.push_back({x, y, i});
+    }
+    // 折线的终点总是保留
+    if (keepLast && lastValid != kClipNewPoint && !out.empty() && out.back().index != lastValid) {
+        const double y = geo_mercatorY01Unclamped(clampMercatorLatitude(points.latAt(lastValid))) * worldSize - viewport.originY;
+        if (out.size() > 1) out.pop_back();
+        out.push_back({previousX, y, lastValid});
+    }
+}
+
+static inline int geo_outCode(const geo_ClipRect& rect, double x, double y) {
+    return (x < rect.minX ? 1 : 0) | (x > rect.maxX ? 2 : 0) | (y < rect.minY ? 4 : 0) | (y > rect.maxY ? 8 : 0);
+}
+
+// Cohen-Sutherland：把线段 a-b 裁剪到矩形内，端点被移动时 index 置为 kClipNewPoint
+static bool geo_clipSegment(const geo_ClipRect& rect, Point2D& a, Point2D& b) {
+    int codeA = geo_outCode(rect, a.x, a.y);
+    int codeB = geo_outCode(rect, b.x, b.y);
+    while (true) {
+        if ((codeA | codeB) == 0) return true;
+        if ((codeA & codeB) != 0) return false;
+        const int code = codeA != 0 ? codeA : codeB;
+        double x;
+        double y;
+        if (code & 8) {
+            x = a.x + (b.x - a.x) * (rect.maxY - a.y) / (b.y - a.y);
+            y = rect.maxY;
+        } else if (code & 4) {
+            x = a.x + (b.x - a.x) * (rect.minY - a.y) / (b.y - a.y);
+            y = rect.minY;
+        } else if (code & 2) {
+            y = a.y + (b.y - a.y) * (rect.maxX - a.x) / (b.x - a.x);
+            x = rect.maxX;
+        } else {
+            y = a.y + (b.y - a.y) * (rect.minX - a.x) / (b.x - a.x);
+            x = rect.minX;
+        }
+        if (code == codeA) {
+            a = {x, y, kClipNewPoint};
+            codeA = geo_outCode(rect, x, y);
+        } else {
+            b = {x, y, kClipNewPoint};
+            codeB = geo_outCode(rect, x, y);
+        }
+    }
+}
+
+// Sutherland-Hodgman 的一步：保留 side(p) >= 0 的部分，side 为到裁剪边的有向距离
+template <typename Side>
+static void geo_clipRingByEdge(const std::vector<Point2D>& input, std::vector<Point2D>& output, Side side) {
+    output.clear();
+    const size_t n = input.size();
+    if (n == 0) return;
+    const Point2D* previous = &input[n - 1];
+    double previousSide = side(*previous);
+    for (size_t i = 0; i < n; ++i) {
+        const Point2D& current = input[i];
+        const double currentSide = side(current);
+        if ((currentSide >= 0.0) != (previousSide >= 0.0)) {
+            const double t = previousSide / (previousSide - currentSide);
+            output.push_back({previous->x + (current.x - previous->x) * t, previous->y + (current.y - previous->y) * t, kClipNewPoint});
+        }
+        if (currentSide >= 0.0) output.push_back(current);
+        previous = &current;
+        previousSide = currentSide;
+    }
+}
+
+// 按像素容差抽稀并转换回经纬度；新计算的点由屏幕坐标反投影
+static void geo_emitClipped(const CoordSpan& points, const ScreenViewport& viewport, const std::vector<Point2D>& piece, double tolerancePx,
+                            std::vector<size_t>& kept, std::vector<GeoPoint>& out) {
+    kept.clear();
+    kept.push_back(0);
+    if (tolerancePx > 0.0 && piece.size() > 2) {
+        simplifyDPStep(piece, 0, piece.size() - 1, tolerancePx * tolerancePx, kept);
+    } else {
+        for (size_t i = 1; i + 1 < piece.size(); ++i) kept.push_back(i);
+    }
+    if (piece.size() > 1) kept.push_back(piece.size() - 1);
+
+    const double worldSize = geo_zoomScale(viewport.zoom) * 256.0;
+    for (size_t k : kept) {
+        const Point2D& p = piece[k];
+        if (p.index != kClipNewPoint) {
+            out.push_back(points[p.index]);
+            continue;
+        }
+        double lon = (p.x + viewport.originX) / worldSize * 360.0 - 180.0;
+        lon = std::remainder(lon, 360.0);
+        out.push_back({geo_latitudeAtMercatorY01((p.y + viewport.originY) / worldSize), lon});
+    }
+}
+
+PolylineRings clipPolylineToViewport(const CoordSpan& points, const ScreenViewport& viewport, double tolerancePx) {
+    PolylineRings result;
+    result.ringOffsets.push_back(0);
+    std::vector<Point2D> projected;
+    geo_projectForClip(points, viewport, tolerancePx, true, projected);
+    if (projected.size() < 2) return result;
+
+    const geo_ClipRect rect{-viewport.margin, -viewport.margin, viewport.width + viewport.margin, viewport.height + viewport.margin};
+    std::vector<Point2D> piece;
+    std::vector<size_t> kept;
+    auto flush = [&]() {
+        if (piece.size() >= 2) {
+            geo_emitClipped(points, viewport, piece, tolerancePx, kept, result.points);
+            result.ringOffsets.push_back(static_cast<int>(result.points.size()));
+        }
+        piece.clear();
+    };
+    for (size_t i = 1; i < projected.size(); ++i) {
+        Point2D a = projected[i - 1];
+        Point2D b = projected[i];
+        if (!geo_clipSegment(rect, a, b)) {
+            flush();
+            continue;
+        }
+        // 起点被裁剪说明从视口外进入，开始新的一段
+        if (a.index == kClipNewPoint) flush();
+        if (piece.empty()) piece.push_back(a);
+        piece.push_back(b);
+        if (b.index == kClipNewPoint) flush();
+    }
+    flush();
+    return result;
+}
+
+std::vector<GeoPoint> clipPolygonToViewport(const CoordSpan& ring, const ScreenViewport& viewport, double tolerancePx) {
+    std::vector<GeoPoint> result;
+    std::vector<Point2D> current;
+    geo_projectForClip(ring, viewport, tolerancePx, false, current);
+    // 去掉与首点重合的闭合点
+    if (current.size() > 1 && current.front().x == current.back().x && current.front().y == current.back().y) current.pop_back();
+    if (current.size() < 3) return result;
+
+    const double minX = -viewport.margin;
+    const double minY = -viewport.margin;
+    const double maxX = viewport.width + viewport.margin;
+    const double maxY = viewport.height + viewport.margin;
+    std::vector<Point2D> next;
+    next.reserve(current.size() + 8);
+    geo_clipRingByEdge(current, next, [minX](const Point2D& p) { return p.x - minX; });
+    geo_clipRingByEdge(next, current, [maxX](const Point2D& p) { return maxX - p.x; });
+    geo_clipRingByEdge(current, next, [minY](const Point2D& p) { return p.y - minY; });
+    geo_clipRingByEdge(next, current, [maxY](const Point2D& p) { return maxY - p.y; });
+    if (current.size() < 3) return result;
+
+    std::vector<size_t> kept;
+    geo_emitClipped(ring, viewport, current, tolerancePx, kept, result);
+    if (result.size() < 3) result.clear();
+    return result;
+}
+
+double calculateFitZoomForPoints(
+    const std::vector<GeoPoint>& points,
+    double viewportWidthPx,
+    double viewportHeightPx,
+    double paddingPx,
+    int minZoom,
+    int maxZoom
+) {
+    return calculateFitZoomForPoints(CoordSpan(points), viewportWidthPx, viewportHeightPx, paddingPx, minZoom, maxZoom);
+}
+
+double calculateFitZoomForPoints(
+    const CoordSpan& points,
+    double viewportWidthPx,
+    double viewportHeightPx,
+    double paddingPx,
+    int minZoom,
+    int maxZoom
+) {
+    // 经度直方图求最大空隙，O(n) 且不分配内存
+    BoundsAccumulator accumulator;
+    accumulator.add(points);
+    return accumulator.fitZoom(viewportWidthPx, viewportHeightPx, paddingPx, minZoom, maxZoom);
+}
+
+// --- 流式边界 ---
+
+static constexpr double kLonBucketScale = BoundsAccumulator::kLonBuckets / 360.0;
+
+void BoundsAccumulator::reset() {
+    validCount = 0;
+    minLat = 90.0;
+    maxLat = -90.0;
+    minLon = 180.0;
+    maxLon = -180.0;
+    std::fill(bucketMin, bucketMin + kLonBuckets, std::numeric_limits<double>::infinity());
+    std::fill(bucketMax, bucketMax + kLonBuckets, -std::numeric_limits<double>::infinity());
+}
+
+void BoundsAccumulator::add(double lat, double lon) {
+    if (!std::isfinite(lat) || !std::isfinite(lon)) return;
+    ++validCount;
+    if (lat < minLat) minLat = lat;
+    if (lat > maxLat) maxLat = lat;
+    if (lon < minLon) minLon = lon;
+    if (lon > maxLon) maxLon = lon;
+
+    // 与 mercatorX01 相同的回绕方式，常见的 [-180, 180) 输入跳过 fmod
+    double wrapped = lon + 180.0;
+    if (!(wrapped >= 0.0 && wrapped < 360.0)) {
+        wrapped = std::fmod(wrapped, 360.0);
+        if (wrapped < 0.0) wrapped += 360.0;
+    }
+    int bucket = static_cast<int>(wrapped * kLonBucketScale);
+    if (bucket >= kLonBuckets) bucket = kLonBuckets - 1;
+    if (wrapped < bucketMin[bucket]) bucketMin[bucket] = wrapped;
+    if (wrapped > bucketMax[bucket]) bucketMax[bucket] = wrapped;
+}
+
+void BoundsAccumulator::add(const CoordSpan& points) {
+    for (size_t i = 0; i < points.size(); ++i) {
+        add(points.latAt(i), points.lonAt(i));
+    }
+}
+
+void BoundsAccumulator::merge(const BoundsAccumulator& other) {
+    if (other.validCount == 0) return;
+    validCount += other.validCount;
+    minLat = std::min(minLat, other.minLat);
+    maxLat = std::max(maxLat, other.maxLat);
+    minLon = std::min(minLon, other.minLon);
+    maxLon = std::max(maxLon, other.maxLon);
+    for (int i = 0; i < kLonBuckets; ++i) {
+        bucketMin[i] = std::min(bucketMin[i], other.bucketMin[i]);
+        bucketMax[i] = std::max(bucketMax[i], other.bucketMax[i]);
+    }
+}
+
+double BoundsAccumulator::largestLonGap(double& gapStart, double& gapEnd) const {
+    double first = 0.0;
+    double previous = 0.0;
+    bool any = false;
+    double maxGap = 0.0;
+    gapStart = 0.0;
+    gapEnd = 0.0;
+    for (int i = 0; i < kLonBuckets; ++i) {
+        if (bucketMax[i] < bucketMin[i]) continue;  // 空桶
+        if (!any) {
+            first = bucketMin[i];
+            any = true;
+        } else if (bucketMin[i] - previous > maxGap) {
+            maxGap = bucketMin[i] - previous;
+            gapStart = previous;
+            gapEnd = bucketMin[i];
+        }
+        previous = bucketMax[i];
+    }
+    if (!any) return 360.0;
+
+    const double endGap = first + 360.0 - previous;
+    if (endGap > maxGap) {
+        maxGap = endGap;
+        gapStart = previous;
+        gapEnd = first;
+    }
+    return maxGap;
+}
+
+PathBounds BoundsAccumulator::bounds() const {
+    PathBounds result = { -90.0, 90.0, -180.0, 180.0, 0.0, 0.0 };
+    if (validCount == 0) {
+        return result;
+    }
+
+    result.north = maxLat;
+    result.south = minLat;
+    result.centerLat = (maxLat + minLat) / 2.0;
+
+    double gapStart = 0.0;
+    double gapEnd = 0.0;
+    const double wrappedSpan = 360.0 - largestLonGap(gapStart, gapEnd);
+    if (maxLon - minLon <= wrappedSpan) {
+        // 不跨经线更短（或一样长）时沿用原始经度，与 calculatePathBounds 一致
+        result.east = maxLon;
+        result.west = minLon;
+        result.centerLon = (maxLon + minLon) / 2.0;
+        return result;
+    }
+
+    result.west = gapEnd - 180.0;
+    result.east = gapStart - 180.0;
+    double center = gapEnd + wrappedSpan / 2.0;
+    if (center >= 360.0) center -= 360.0;
+    result.centerLon = center - 180.0;
+    return result;
+}
+
+double BoundsAccumulator::fitZoom(
+    double viewportWidthPx,
+    double viewportHeightPx,
+    double paddingPx,
+    int minZoom,
+    int maxZoom
+) const {
+    if (minZoom > maxZoom) {
+        std::swap(minZoom, maxZoom);
+    }
+    if (validCount == 0) {
+        return static_cast<double>(minZoom);
+    }
+    if (validCount == 1) {
+        return static_cast<double>(maxZoom);
+    }
+
+    const double safeViewportWidth = viewportWidthPx > 1.0 ? viewportWidthPx : 390.0;
+    const double safeViewportHeight = viewportHeightPx > 1.0 ? viewportHeightPx : 844.0;
+    const double safePadding = std::max(0.0, paddingPx);
+    const double availableWidth = std::max(1.0, safeViewportWidth - safePadding * 2.0);
+    const double availableHeight = std::max(1.0, safeViewportHeight - safePadding * 2.0);
+
+    double gapStart = 0.0;
+    double gapEnd = 0.0;
+    const double spanX = std::max(0.0, 1.0 - largestLonGap(gapStart, gapEnd) / 360.0);
+    // mercatorY01 随纬度单调递减，纬度极值即 y 的极值
+    const double spanY = std::max(0.0, mercatorY01(minLat) - mercatorY01(maxLat));
+    static constexpr double kTileSize = 256.0;
+    static constexpr double kSpanEpsilon = 1e-12;
+
+    const double zoomX = spanX <= kSpanEpsilon
+        ? static_cast<double>(maxZoom)
+        : std::log2(availableWidth / (kTileSize * spanX));
+    const double zoomY = spanY <= kSpanEpsilon
+        ? static_cast<double>(maxZoom)
+        : std::log2(availableHeight / (kTileSize * spanY));
+
+    double fitZoom = std::min(zoomX, zoomY);
+    if (!std::isfinite(fitZoom)) {
+        fitZoom = static_cast<double>(minZoom);
+    }
+
+    if (fitZoom < static_cast<double>(minZoom)) {
+        fitZoom = static_cast<double>(minZoom);
+    } else if (fitZoom > static_cast<double>(maxZoom)) {
+        fitZoom = static_cast<double>(maxZoom);
+    }
+
+    return fitZoom;
+}
+
+PathBounds calculateWrappedPathBounds(const std::vector<GeoPoint>& points) {
+    return calculateWrappedPathBounds(CoordSpan(points));
+}
+
+PathBounds calculateWrappedPathBounds(const CoordSpan& points) {
+    BoundsAccumulator accumulator;
+    accumulator.add(points);
+    return accumulator.bounds();
+}
+
+// --- 凸包 / 凹包 ---
+
+static constexpr uint32_t kHullNone = std::numeric_limits<uint32_t>::max();
+
+// 叉积，偏离量在经纬度舍入误差（相对 1e-9，即千米尺度上的微米级）以内时视为共线
+static inline double geo_hullCross(const Point2D& o, const Point2D& a, const Point2D& b) {
+    const double left = (a.x - o.x) * (b.y - o.y);
+    const double right = (a.y - o.y) * (b.x - o.x);
+    const double cross = left - right;
+    return std::abs(cross) <= 1e-9 * (std::abs(left) + std::abs(right)) ? 0.0 : cross;
+}
+
+// 与 delaunator 相同的约定：a、b、c 在 y 向上的坐标系中逆时针时为负
+static inline double geo_hullOrient(const Point2D& a, const Point2D& b, const Point2D& c) {
+    return (a.y - c.y) * (b.x - c.x) - (a.x - c.x) * (b.y - c.y);
+}
+
+static inline bool geo_hullInCircle(const Point2D& a, const Point2D& b, const Point2D& c, const Point2D& p) {
+    const double dx = a.x - p.x;
+    const double dy = a.y - p.y;
+    const double ex = b.x - p.x;
+    const double ey = b.y - p.y;
+    const double fx = c.x - p.x;
+    const double fy = c.y - p.y;
+    const double ap = dx * dx + dy * dy;
+    const double bp = ex * ex + ey * ey;
+    const double cp = fx * fx + fy * fy;
+    return dx * (ey * cp - bp * fy) - dy * (ex * cp - bp * fx) + ap * (ex * fy - ey * fx) < 0.0;
+}
+
+static inline double geo_hullSqDist(const Point2D& a, const Point2D& b) {
+    const double dx = a.x - b.x;
+    const double dy = a.y - b.y;
+    return dx * dx + dy * dy;
+}
+
+// 外接圆半径的平方，三点共线时为 inf
+static inline double geo_hullCircumradius(const Point2D& a, const Point2D& b, const Point2D& c) {
+    const double dx = b.x - a.x;
+    const double dy = b.y - a.y;
+    const double ex = c.x - a.x;
+    const double ey = c.y - a.y;
+    const double bl = dx * dx + dy * dy;
+    const double cl = ex * ex + ey * ey;
+    const double det = dx * ey - dy * ex;
+    if (det == 0.0) return std::numeric_limits<double>::infinity();
+    const double d = 0.5 / det;
+    const double x = (ey * bl - dy * cl) * d;
+    const double y = (dx * cl - ex * bl) * d;
+    return x * x + y * y;
+}
+
+// 单调递增的伪极角，取值 [0, 1)
+static inline double geo_hullPseudoAngle(double dx, double dy) {
+    const double sum = std::abs(dx) + std::abs(dy);
+    if (sum == 0.0) return 0.0;
+    const double p = dx / sum;
+    return (dy > 0.0 ? 3.0 - p : 1.0 + p) * 0.25;
+}
+
+/**
+ * 凸包 / 凹包的工作区，批量计算时在各簇之间复用
+ * Delaunay 剖分为 delaunator 的扫描凸包算法：点按到种子三角形外接圆心的距离排序后依次插入，
+ * 用极角哈希找到可见的凸包边，新三角形通过翻边满足空圆性质。三角形在 y 向上的坐标系中为顺时针
+ */
+struct geo_HullWorkspace {
+    std::vector<Point2D> points;        // 局部投影（米），index 为输入下标；按 (x, y) 排序并去重
+    std::vector<uint32_t> hull;         // points 的下标，逆时针
+
+    std::vector<uint32_t> ids;
+    std::vector<double> dists;
+    std::vector<uint32_t> triangles;
+    std::vector<uint32_t> halfedges;    // 相邻三角形中的对边，凸包边为 kHullNone
+    size_t trianglesLen = 0;
+    std::vector<uint32_t> hullPrev;
+    std::vector<uint32_t> hullNext;
+    std::vector<uint32_t> hullTri;
+    std::vector<uint32_t> hullHash;
+    std::vector<uint32_t> edgeStack;
+    uint32_t hullStart = 0;
+    double centerX = 0.0;
+    double centerY = 0.0;
+
+    std::vector<uint8_t> removed;       // 每个三角形
+    std::vector<uint8_t> onBoundary;    // 每个点
+    std::vector<std::pair<double, uint32_t>> heap;
+    std::vector<uint32_t> nextVertex;
+    std::vector<uint32_t> ring;
+
+    void project(const CoordSpan& source, const int* indices, size_t count);
+    void convexHull();
+    bool triangulate();
+    void chiShape(double maxEdgeMeters);
+    void emit(const CoordSpan& source, std::vector<GeoPoint>& out) const;
+
+private:
+    size_t hashKey(const Point2D& p) const {
+        const size_t size = hullHash.size();
+        return static_cast<size_t>(std::floor(geo_hullPseudoAngle(p.x - centerX, p.y - centerY) * static_cast<double>(size))) % size;
+    }
+    void link(uint32_t a, uint32_t b) {
+        halfedges[a] = b;
+        if (b != kHullNone) halfedges[b] = a;
+    }
+    uint32_t addTriangle(uint32_t i0, uint32_t i1, uint32_t i2, uint32_t a, uint32_t b, uint32_t c);
+    uint32_t legalize(uint32_t a);
+};
+
+// indices 为 nullptr 时使用 source 的全部点
+void geo_HullWorkspace::project(const CoordSpan& source, const int* indices, size_t count) {
+    points.clear();
+    double lat0 = 0.0;
+    double lon0 = 0.0;
+    double minLat = 90.0;
+    double maxLat = -90.0;
+    for (size_t k = 0; k < count; ++k) {
+        const size_t i = indices ? static_cast<size_t>(indices[k]) : k;
+        if (indices && (indices[k] < 0 || i >= source.size())) continue;
+        const double lat = source.latAt(i);
+        const double lon = source.lonAt(i);
+        if (!geo_isFinitePair(lat, lon)) continue;
+        if (points.empty()) {
+            lat0 = lat;
+            lon0 = lon;
+        }
+        // 先暂存纬度与相对第一个点展开后的经度差
+        points.push_back({std::remainder(lon - lon0, 360.0), lat - lat0, i});
+        minLat = std::min(minLat, lat);
+        maxLat = std::max(maxLat, lat);
+    }
+    if (points.empty()) return;
+
+    const double metersPerDegree = kEarthRadiusMeters * kDegreesToRadians;
+    const double metersPerDegreeLon = metersPerDegree * std::cos(geo_toRadians((minLat + maxLat) * 0.5));
+    for (auto& p : points) {
+        p.x *= metersPerDegreeLon;
+        p.y *= metersPerDegree;
+    }
+
+    std::sort(points.begin(), points.end(), [](const Point2D& a, const Point2D& b) {
+        return a.x < b.x || (a.x == b.x && a.y < b.y);
+    });
+    points.erase(std::unique(points.begin(), points.end(), [](const Point2D& a, const Point2D& b) {
+        return a.x == b.x && a.y == b.y;
+    }), points.end());
+}
+
+void geo_HullWorkspace::convexHull() {
+    const size_t n = points.size();
+    hull.clear();
+    if (n <= 2) {
+        for (size_t i = 0; i < n; ++i) hull.push_back(static_cast<uint32_t>(i));
+        return;
+    }
+
+    hull.resize(2 * n);
+    size_t k = 0;
+    for (size_t i = 0; i < n; ++i) {
+        while (k >= 2 && geo_hullCross(points[hull[k - 2]], points[hull[k - 1]], points[i]) <= 0.0) --k;
+        hull[k++] = static_cast<uint32_t>(i);
+    }
+    for (size_t i = n - 1, lower = k + 1; i-- > 0;) {
+        while (k >= lower && geo_hullCross(points[hull[k - 2]], points[hull[k - 1]], points[i]) <= 0.0) --k;
+        hull[k++] = static_cast<uint32_t>(i);
+    }
+    hull.resize(k - 1);
+}
+
+uint32_t geo_HullWorkspace::addTriangle(uint32_t i0, uint32_t i1, uint32_t i2, uint32_t a, uint32_t b, uint32_t c) {
+    const uint32_t t = static_cast<uint32_t>(trianglesLen);
+    triangles[t] = i0;
+    triangles[t + 1] = i1;
+    triangles[t + 2] = i2;
+    link(t, a);
+    link(t + 1, b);
+    link(t + 2, c);
+    trianglesLen += 3;
+    return t;
+}
+
+// 从半边 a 开始翻转不满足空圆性质的边，返回新三角形中与 a 同一三角形的上一条边
+uint32_t geo_HullWorkspace::legalize(uint32_t a) {
+    edgeStack.clear();
+    uint32_t ar = 0;
+    while (true) {
+        const uint32_t b = halfedges[a];
+        const uint32_t a0 = a - a % 3;
+        ar = a0 + (a + 2) % 3;
+
+        if (b == kHullNone) {
+            if (edgeStack.empty()) break;
+            a = edgeStack.back();
+            edgeStack.pop_back();
+            continue;
+        }
+
+        const uint32_t b0 = b - b % 3;
+        const uint32_t al = a0 + (a + 1) % 3;
+        const uint32_t bl = b0 + (b + 2) % 3;
+        const uint32_t p0 = triangles[ar];
+        const uint32_t pr = triangles[a];
+        const uint32_t pl = triangles[al];
+        const uint32_t p1 = triangles[bl];
+
+        if (geo_hullInCircle(points[p0], points[pr], points[pl], points[p1])) {
+            triangles[a] = p1;
+            triangles[b] = p0;
+
+            const uint32_t hbl = halfedges[bl];
+            // 翻转的边在凸包另一侧（少见），修正凸包对三角形的引用
+            if (hbl == kHullNone) {
+                uint32_t e = hullStart;
+                do {
+                    if (hullTri[e] == bl) {
+                        hullTri[e] = a;
+                        break;
+                    }
+                    e = hullPrev[e];
+                } while (e != hullStart);
+            }
+            link(a, hbl);
+            link(b, halfedges[ar]);
+            link(ar, bl);
+            edgeStack.push_back(b0 + (b + 1) % 3);
+        } else {
+            if (edgeStack.empty()) break;
+            a = edgeStack.back();
+            edgeStack.pop_back();
+        }
+    }
+    return ar;
+}
+
+bool geo_HullWorkspace::triangulate() {
+    const uint32_t n = static_cast<uint32_t>(points.size());
+    trianglesLen = 0;
+    if (n < 3) return false;
+
+    double minX = points[0].x, maxX = points[0].x;
+    double minY = points[0].y, maxY = points[0].y;
+    for (const auto& p : points) {
+        minX = std::min(minX, p.x);
+        maxX = std::max(maxX, p.x);
+        minY = std::min(minY, p.y);
+        maxY = std::max(maxY, p.y);
+    }
+    const Point2D mid{(minX + maxX) * 0.5, (minY + maxY) * 0.5, 0};
+
+    // 种子三角形：离包围盒中心最近的点、离它最近的点、与两者外接圆最小的点
+    uint32_t i0 = 0;
+    uint32_t i1 = kHullNone;
+    uint32_t i2 = kHullNone;
+    double minDist = std::numeric_limits<double>::infinity();
+    for (uint32_t i = 0; i < n; ++i) {
+        const double d = geo_hullSqDist(mid, points[i]);
+        if (d < minDist) {
+            i0 = i;
+            minDist = d;
+        }
+    }
+    minDist = std::numeric_limits<double>::infinity();
+    for (uint32_t i = 0; i < n; ++i) {
+        if (i == i0) continue;
+        const double d = geo_hullSqDist(points[i0], points[i]);
+        if (d < minDist && d > 0.0) {
+            i1 = i;
+            minDist = d;
+        }
+    }
+    if (i1 == kHullNone) return false;
+    double minRadius = std::numeric_limits<double>::infinity();
+    for (uint32_t i = 0; i < n; ++i) {
+        if (i == i0 || i == i1) continue;
+        const double r = geo_hullCircumradius(points[i0], points[i1], points[i]);
+        if (r < minRadius) {
+            i2 = i;
+            minRadius = r;
+        }
+    }
+    // 全部共线
+    if (i2 == kHullNone || !std::isfinite(minRadius)) return false;
+
+    if (geo_hullOrient(points[i0], points[i1], points[i2]) < 0.0) std::swap(i1, i2);
+
+    {
+        const Point2D& a = points[i0];
+        const double dx = points[i1].x - a.x;
+        const double dy = points[i1].y - a.y;
+        const double ex = points[i2].x - a.x;
+        const double ey = points[i2].y - a.y;
+        const double bl = dx * dx + dy * dy;
+        const double cl = ex * ex + ey * ey;
+        const double d = 0.5 / (dx * ey - dy * ex);
+        centerX = a.x + (ey * bl - dy * cl) * d;
+        centerY = a.y + (dx * cl - ex * bl) * d;
+    }
+
+    ids.resize(n);
+    dists.resize(n);
+    const Point2D center{centerX, centerY, 0};
+    for (uint32_t i = 0; i < n; ++i) {
+        ids[i] = i;
+        dists[i] = geo_hullSqDist(points[i], center);
+    }
+    std::sort(ids.begin(), ids.end(), [this](uint32_t a, uint32_t b) { return dists[a] < dists[b]; });
+
+    const size_t maxTriangles = 2 * static_cast<size_t>(n) - 5;
+    triangles.assign(maxTriangles * 3, 0);
+    halfedges.assign(maxTriangles * 3, kHullNone);
+    hullPrev.assign(n, 0);
+    hullNext.assign(n, 0);
+    hullTri.assign(n, 0);
+    hullHash.assign(static_cast<size_t>(std::ceil(std::sqrt(static_cast<double>(n)))), kHullNone);
+
+    hullStart = i0;
+    hullNext[i0] = hullPrev[i2] = i1;
+    hullNext[i1] = hullPrev[i0] = i2;
+    hullNext[i2] = hullPrev[i1] = i0;
+    hullTri[i0] = 0;
+    hullTri[i1] = 1;
+    hullTri[i2] = 2;
+    hullHash[hashKey(points[i0])] = i0;
+    hullHash[hashKey(points[i1])] = i1;
+    hullHash[hashKey(points[i2])] = i2;
+    addTriangle(i0, i1, i2, kHullNone, kHullNone, kHullNone);
+
+    for (uint32_t k = 0; k < n; ++k) {
+        const uint32_t i = ids[k];
+        if (i == i0 || i == i1 || i == i2) continue;
+        const Point2D& p = points[i];
+
+        // 用极角哈希找到凸包上的起点，再找到第一条可见边
+        uint32_t start = 0;
+        const size_t key = hashKey(p);
+        for (size_t j = 0; j < hullHash.size(); ++j) {
+            start = hullHash[(key + j) % hullHash.size()];
+            if (start != kHullNone && start != hullNext[start]) break;
+        }
+        start = hullPrev[start];
+        uint32_t e = start;
+        uint32_t q = hullNext[e];
+        bool visible = true;
+        while (geo_hullOrient(p, points[e], points[q]) >= 0.0) {
+            e = q;
+            if (e == start) {
+                visible = false;
+                break;
+            }
+            q = hullNext[e];
+        }
+        // 与已有点几乎重合
+        if (!visible) continue;
+
+        uint32_t t = addTriangle(e, i, hullNext[e], kHullNone, kHullNone, hullTri[e]);
+        hullTri[i] = legalize(t + 2);
+        hullTri[e] = t;
+
+        // 向前沿凸包补三角形
+        uint32_t next = hullNext[e];
+        q = hullNext[next];
+        while (geo_hullOrient(p, points[next], points[q]) < 0.0) {
+            t = addTriangle(next, i, q, hullTri[i], kHullNone, hullTri[next]);
+            hullTri[i] = legalize(t + 2);
+            hullNext[next] = next;  // 标记为已移出凸包
+            next = q;
+            q = hullNext[next];
+        }
+
+        // 起点本身可见时向后补三角形
+        if (e == start) {
+            q = hullPrev[e];
+            while (geo_hullOrient(p, points[q], points[e]) < 0.0) {
+                t = addTriangle(q, i, e, kHullNone, hullTri[e], hullTri[q]);
+                legalize(t + 2);
+                hullTri[q] = t;
+                hullNext[e] = e;
+                e = q;
+                q = hullPrev[e];
+            }
+        }
+
+        hullStart = hullPrev[i] = e;
+        hullNext[e] = hullPrev[next] = i;
+        hullNext[i] = next;
+        hullHash[hashKey(p)] = i;
+        hullHash[hashKey(points[e])] = e;
+    }
+    return true;
+}
+
+// χ-shape：最长的边界边优先，去掉其所在三角形，第三个顶点已在边界上时跳过（否则边界会自接触）
+void geo_HullWorkspace::chiShape(double maxEdgeMeters) {
+    const size_t triangleCount = trianglesLen / 3;
+    removed.assign(triangleCount, 0);
+    onBoundary.assign(points.size(), 0);
+    heap.clear();
+    for (uint32_t e = 0; e < trianglesLen; ++e) {
+        if (halfedges[e] != kHullNone) continue;
+        const uint32_t next = e - e % 3 + (e + 1) % 3;
+        onBoundary[triangles[e]] = 1;
+        heap.push_back({geo_hullSqDist(points[triangles[e]], points[triangles[next]]), e});
+    }
+    std::make_heap(heap.begin(), heap.end());
+
+    const double maxSq = maxEdgeMeters * maxEdgeMeters;
+    while (!heap.empty() && heap.front().first > maxSq) {
+        std::pop_heap(heap.begin(), heap.end());
+        const uint32_t e = heap.back().second;
+        heap.pop_back();
+
+        const uint32_t t0 = e - e % 3;
+        if (removed[t0 / 3]) continue;
+        const uint32_t e1 = t0 + (e + 1) % 3;
+        const uint32_t e2 = t0 + (e + 2) % 3;
+        const uint32_t c = triangles[e2];
+        if (onBoundary[c]) continue;
+
+        removed[t0 / 3] = 1;
+        onBoundary[c] = 1;
+        // c 原本不在边界上，另外两条边必有相邻三角形，它们成为新的边界边
+        const uint32_t sides[2] = {e1, e2};
+        for (uint32_t f : sides) {
+            const uint32_t twin = halfedges[f];
+            const uint32_t twinNext = twin - twin % 3 + (twin + 1) % 3;
+            heap.push_back({geo_hullSqDist(points[triangles[twin]], points[triangles[twinNext]]), twin});
+            std::push_heap(heap.begin(), heap.end());
+        }
+    }
+
+    // 沿剩余三角形的边界走一圈，每个边界点恰好有一条出边
+    nextVertex.assign(points.size(), kHullNone);
+    uint32_t start = kHullNone;
+    for (uint32_t e = 0; e < trianglesLen; ++e) {
+        if (removed[e / 3]) continue;
+        const uint32_t twin = halfedges[e];
+        if (twin != kHullNone && !removed[twin / 3]) continue;
+        const uint32_t next = e - e % 3 + (e + 1) % 3;
+        nextVertex[triangles[e]] = triangles[next];
+        start = triangles[e];
+    }
+
+    ring.clear();
+    uint32_t v = start;
+    do {
+        ring.push_back(v);
+        v = nextVertex[v];
+    } while (v != start && v != kHullNone && ring.size() <= points.size());
+
+    // 三角形为顺时针，边界也是顺时针；反向并去掉共线点
+    hull.clear();
+    for (size_t k = ring.size(); k-- > 0;) {
+        const uint32_t cur = ring[k];
+        while (hull.size() >= 2 && geo_hullCross(points[hull[hull.size() - 2]], points[hull.back()], points[cur]) == 0.0) hull.pop_back();
+        hull.push_back(cur);
+    }
+    while (hull.size() >= 3 && geo_hullCross(points[hull[hull.size() - 2]], points[hull.back()], points[hull[0]]) == 0.0) hull.pop_back();
+    while (hull.size() >= 3 && geo_hullCross(points[hull.back()], points[hull[0]], points[hull[1]]) == 0.0) hull.erase(hull.begin());
+}
+
+void geo_HullWorkspace::emit(const CoordSpan& source, std::vector<GeoPoint>& out) const {
+    for (uint32_t k : hull) {
+        out.push_back(source[points[k].index]);
+    }
+}
+
+static void geo_computeHull(geo_HullWorkspace& ws, const CoordSpan& source, const int* indices, size_t count, double maxEdgeMeters) {
+    ws.project(source, indices, count);
+    if (maxEdgeMeters > 0.0 && ws.triangulate()) {
+        ws.chiShape(maxEdgeMeters);
+    } else {
+        ws.convexHull();
+    }
+}
+
+std::vector<GeoPoint> computeConvexHull(const CoordSpan& points) {
+    geo_HullWorkspace ws;
+    geo_computeHull(ws, points, nullptr, points.size(), 0.0);
+    std::vector<GeoPoint> result;
+    result.reserve(ws.hull.size());
+    ws.emit(points, result);
+    return result;
+}
+
+std::vector<GeoPoint> computeConvexHull(const std::vector<GeoPoint>& points) {
+    return computeConvexHull(CoordSpan(points));
+}
+
+std::vector<GeoPoint> computeConcaveHull(const CoordSpan& points, double maxEdgeMeters) {
+    geo_HullWorkspace ws;
+    geo_computeHull(ws, points, nullptr, points.size(), maxEdgeMeters);
+    std::vector<GeoPoint> result;
+    result.reserve(ws.hull.size());
+    ws.emit(points, result);
+    return result;
+}
+
+std::vector<GeoPoint> computeConcaveHull(const std::vector<GeoPoint>& points, double maxEdgeMeters) {
+    return computeConcaveHull(CoordSpan(points), maxEdgeMeters);
+}
+
+PolylineRings computeClusterHulls(const CoordSpan& points, const std::vector<ClusterOutput>& clusters, double maxEdgeMeters) {
+    PolylineRings result;
+    result.ringOffsets.reserve(clusters.size() + 1);
+    result.ringOffsets.push_back(0);
+    geo_HullWorkspace ws;
+    for (const auto& cluster : clusters) {
+        geo_computeHull(ws, points, cluster.indices.data(), cluster.indices.size(), maxEdgeMeters);
+        ws.emit(points, result.points);
+        result.ringOffsets.push_back(static_cast<int>(result.points.size()));
+    }
+    return result;
+}
+
+// --- 批量地理围栏与热力图 ---
 
 int findPointInPolygons(double pointLat, double pointLon, const std::vector<std::vector<GeoPoint>>& polygons) {
     for (size_t i = 0; i < polygons.size(); ++i) {
@@ -635,7 +2609,349 @@ int findPointInPolygons(double pointLat, double pointLon, const std::vector<std:
     return -1;
 }
 
-std::vector<HeatmapGridCell> generateHeatmapGrid(const std::vector<HeatmapPoint>& points, double gridSizeMeters) {
+int findPointInPolygons(double pointLat, double pointLon, const std::vector<CoordSpan>& polygons) {
+    for (size_t i = 0; i < polygons.size(); ++i) {
+        if (isPointInPolygon(pointLat, pointLon, polygons[i])) {
+            return static_cast<int>(i);
+        }
+    }
+    return -1;
+}
+
+// 批量围栏判断的 SIMD 宽度，每个分带的边数补齐到它的整数倍
+static constexpr size_t kFenceLanes = 2;
+static constexpr size_t kFenceMaxBands = 4096;
+
+/**
+ * 围栏的边按经度分带（CSR），每带内的边以 SoA 连续存放，供 SIMD 一次判断多条边
+ * 横坐标为纬度、纵坐标为经度，与 isPointInPolygon 相同；每条边已定向为 y0 < y1，水平边不参与
+ */
+struct geo_FenceIndex {
+    double minX = 0.0;
+    double maxX = 0.0;
+    double minY = 0.0;
+    double maxY = 0.0;
+    double invBandHeight = 0.0;
+    size_t bandCount = 0;
+    std::vector<uint32_t> bandOffsets;
+    std::vector<double> x0;
+    std::vector<double> y0;
+    std::vector<double> y1;
+    std::vector<double> dx;
+    std::vector<double> dy;
+
+    bool build(const CoordSpan& polygon, const std::vector<int>& ringOffsets);
+
+    size_t bandOf(double y) const {
+        const double band = (y - minY) * invBandHeight;
+        return band <= 0.0 ? 0 : std::min(bandCount - 1, static_cast<size_t>(band));
+    }
+};
+
+bool geo_FenceIndex::build(const CoordSpan& polygon, const std::vector<int>& ringOffsets) {
+    struct Edge {
+        double x0, y0, y1, dx, dy;
+    };
+    std::vector<Edge> edges;
+    edges.reserve(polygon.size());
+    minX = minY = std::numeric_limits<double>::infinity();
+    maxX = maxY = -std::numeric_limits<double>::infinity();
+
+    const size_t ringCount = ringOffsets.empty() ? 1 : ringOffsets.size() - 1;
+    for (size_t r = 0; r < ringCount; ++r) {
+        const size_t begin = ringOffsets.empty() ? 0 : static_cast<size_t>(std::max(ringOffsets[r], 0));
+        const size_t end = ringOffsets.empty() ? polygon.size() : std::min(static_cast<size_t>(std::max(ringOffsets[r + 1], 0)), polygon.size());
+        if (end < begin + 3) continue;
+        for (size_t i = begin, j = end - 1; i < end; j = i++) {
+            double ax = polygon.latAt(j), ay = polygon.lonAt(j);
+            double bx = polygon.latAt(i), by = polygon.lonAt(i);
+            if (!geo_isFinitePair(ax, ay) || !geo_isFinitePair(bx, by)) continue;
+            minX = std::min(minX, bx);
+            maxX = std::max(maxX, bx);
+            minY = std::min(minY, by);
+            maxY = std::max(maxY, by);
+            if (ay == by) continue;
+            if (ay > by) {
+                std::swap(ax, bx);
+                std::swap(ay, by);
+            }
+            edges.push_back({ax, ay, by, bx - ax, by - ay});
+        }
+    }
+    if (edges.empty()) return false;
+
+    // 平均每带约 2 条边，跨多带的长边在每带各存一份
+    bandCount = std::min(std::max<size_t>(edges.size() / 2, 1), kFenceMaxBands);
+    const double span = maxY - minY;
+    invBandHeight = span > 0.0 ? static_cast<double>(bandCount) / span : 0.0;
+    if (invBandHeight == 0.0 || !std::isfinite(invBandHeight)) {
+        bandCount = 1;
+        invBandHeight = 0.0;
+    }
+
+    bandOffsets.assign(bandCount + 1, 0);
+    for (const auto& e : edges) {
+        for (size_t b = bandOf(e.y0), last = bandOf(e.y1); b <= last; ++b) ++bandOffsets[b + 1];
+    }
+    for (size_t b = 0; b < bandCount; ++b) {
+        const uint32_t padded = (bandOffsets[b + 1] + kFenceLanes - 1) / kFenceLanes * kFenceLanes;
+        bandOffsets[b + 1] = bandOffsets[b] + padded;
+    }
+
+    // 补齐用的边永远不相交：y0 = +inf 使跨越判断为假
+    const size_t total = bandOffsets[bandCount];
+    x0.assign(total, 0.0);
+    y0.assign(total, std::numeric_limits<double>::infinity());
+    y1.assign(total, -std::numeric_limits<double>::infinity());
+    dx.assign(total, 0.0);
+    dy.assign(total, 0.0);
+    std::vector<uint32_t> cursor(bandOffsets.begin(), bandOffsets.end() - 1);
+    for (const auto& e : edges) {
+        for (size_t b = bandOf(e.y0), last = bandOf(e.y1); b <= last; ++b) {
+            const uint32_t k = cursor[b]++;
+            x0[k] = e.x0;
+            y0[k] = e.y0;
+            y1[k] = e.y1;
+            dx[k] = e.dx;
+            dy[k] = e.dy;
+        }
+    }
+    return true;
+}
+
+// 射线法奇偶判断：边跨过 py（y0 <= py < y1）且交点在 px 一侧时计数；交点比较改写为乘法，避免逐边除法
+static inline bool geo_fenceContains(const geo_FenceIndex& fence, size_t begin, size_t end, double px, double py) {
+#if defined(__SSE2__)
+    const __m128d vpx = _mm_set1_pd(px);
+    const __m128d vpy = _mm_set1_pd(py);
+    __m128d parity = _mm_setzero_pd();
+    for (size_t k = begin; k < end; k += kFenceLanes) {
+        const __m128d y0 = _mm_loadu_pd(&fence.y0[k]);
+        const __m128d straddle = _mm_and_pd(_mm_cmple_pd(y0, vpy), _mm_cmplt_pd(vpy, _mm_loadu_pd(&fence.y1[k])));
+        const __m128d lhs = _mm_mul_pd(_mm_sub_pd(vpx, _mm_loadu_pd(&fence.x0[k])), _mm_loadu_pd(&fence.dy[k]));
+        const __m128d rhs = _mm_mul_pd(_mm_loadu_pd(&fence.dx[k]), _mm_sub_pd(vpy, y0));
+        parity = _mm_xor_pd(parity, _mm_and_pd(straddle, _mm_cmplt_pd(lhs, rhs)));
+    }
+    const int mask = _mm_movemask_pd(parity);
+    return ((mask ^ (mask >> 1)) & 1) != 0;
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+    const float64x2_t vpx = vdupq_n_f64(px);
+    const float64x2_t vpy = vdupq_n_f64(py);
+    uint64x2_t parity = vdupq_n_u64(0);
+    for (size_t k = begin; k < end; k += kFenceLanes) {
+        const float64x2_t y0 = vld1q_f64(&fence.y0[k]);
+        const uint64x2_t straddle = vandq_u64(vcleq_f64(y0, vpy), vcltq_f64(vpy, vld1q_f64(&fence.y1[k])));
+        const float64x2_t lhs = vmulq_f64(vsubq_f64(vpx, vld1q_f64(&fence.x0[k])), vld1q_f64(&fence.dy[k]));
+        const float64x2_t rhs = vmulq_f64(vld1q_f64(&fence.dx[k]), vsubq_f64(vpy, y0));
+        parity = veorq_u64(parity, vandq_u64(straddle, vcltq_f64(lhs, rhs)));
+    }
+    return ((vgetq_lane_u64(parity, 0) ^ vgetq_lane_u64(parity, 1)) & 1) != 0;
+#else
+    bool inside = false;
+    for (size_t k = begin; k < end; ++k) {
+        const bool straddle = fence.y0[k] <= py && py < fence.y1[k];
+        if (straddle && (px - fence.x0[k]) * fence.dy[k] < fence.dx[k] * (py - fence.y0[k])) inside = !inside;
+    }
+    return inside;
+#endif
+}
+
+size_t pointsInPolygon(const CoordSpan& polygon, const std::vector<int>& ringOffsets, const CoordSpan& points, uint64_t* outBits) {
+    const size_t count = points.size();
+    std::fill(outBits, outBits + (count + 63) / 64, uint64_t(0));
+
+    geo_FenceIndex fence;
+    if (!fence.build(polygon, ringOffsets)) return 0;
+
+    size_t insideCount = 0;
+    for (size_t i = 0; i < count; ++i) {
+        const double px = points.latAt(i);
+        const double py = points.lonAt(i);
+        // 包围盒预筛，NaN 也在这里被排除
+        if (!(px >= fence.minX && px <= fence.maxX && py >= fence.minY && py < fence.maxY)) continue;
+        const size_t band = fence.bandOf(py);
+        if (geo_fenceContains(fence, fence.bandOffsets[band], fence.bandOffsets[band + 1], px, py)) {
+            outBits[i >> 6] |= uint64_t(1) << (i & 63);
+            ++insideCount;
+        }
+    }
+    return insideCount;
+}
+
+size_t pointsInPolygon(const CoordSpan& polygon, const CoordSpan& points, uint64_t* outBits) {
+    return pointsInPolygon(polygon, std::vector<int>(), points, outBits);
+}
+
+// 稠密网格上限：不超过该单元数（且不远大于点数）时用二维数组累加，否则改用哈希表
+static constexpr size_t kHeatmapDenseMaxCells = size_t(1) << 20;
+// 每个线程至少处理的点数，点数较少时多线程的启动与合并开销得不偿失
+static constexpr size_t kHeatmapMinPointsPerThread = 32768;
+
+struct geo_HeatmapGridSpec {
+    double minLat;
+    double minLon;
+    double latStep;
+    double lonStep;
+    size_t rows;
+    size_t cols;
+};
+
+static inline bool geo_heatmapCellIndex(const geo_HeatmapGridSpec& spec, const HeatmapPoint& p, size_t& row, size_t& col) {
+    if (!std::isfinite(p.lat) || !std::isfinite(p.lon) || !std::isfinite(p.weight)) {
+        return false;
+    }
+    row = std::min(static_cast<size_t>((p.lat - spec.minLat) / spec.latStep), spec.rows - 1);
+    col = std::min(static_cast<size_t>((p.lon - spec.minLon) / spec.lonStep), spec.cols - 1);
+    return true;
+}
+
+// 稠密累加器：按行优先存放，遍历顺序即 (latIdx, lonIdx) 升序
+struct geo_HeatmapDenseGrid {
+    std::vector<double> sums;
+    std::vector<uint8_t> touched;
+
+    explicit geo_HeatmapDenseGrid(size_t cellCount) : sums(cellCount, 0.0), touched(cellCount, 0) {}
+
+    void accumulate(const geo_HeatmapGridSpec& spec, const HeatmapPoint* begin, const HeatmapPoint* end) {
+        size_t row = 0, col = 0;
+        for (const HeatmapPoint* p = begin; p != end; ++p) {
+            if (!geo_heatmapCellIndex(spec, *p, row, col)) continue;
+            const size_t index = row * spec.cols + col;
+            sums[index] += p->weight;
+            touched[index] = 1;
+        }
+    }
+
+    void merge(const geo_HeatmapDenseGrid& other) {
+        for (size_t i = 0; i < sums.size(); ++i) {
+            if (!other.touched[i]) continue;
+            sums[i] += other.sums[i];
+            touched[i] = 1;
+        }
+    }
+};
+
+// 开放寻址哈希累加器（线性探测，容量为 2 的幂，负载不超过 1/2）
+// 键为 (row << 32) | col，按键排序即 (latIdx, lonIdx) 升序
+struct geo_HeatmapHashGrid {
+    static constexpr uint64_t kEmptyKey = std::numeric_limits<uint64_t>::max();
+
+    std::vector<uint64_t> keys;
+    std::vector<double> sums;
+    size_t used = 0;
+
+    explicit geo_HeatmapHashGrid(size_t expectedCells) {
+        size_t capacity = 64;
+        while (capacity < expectedCells * 2) capacity <<= 1;
+        keys.assign(capacity, kEmptyKey);
+        sums.assign(capacity, 0.0);
+    }
+
+    static inline size_t hashKey(uint64_t key) {
+        key ^= key >> 33;
+        key *= 0xff51afd7ed558ccdULL;
+        key ^= key >> 33;
+        return static_cast<size_t>(key);
+    }
+
+    void add(uint64_t key, double weight) {
+        if ((used + 1) * 2 > keys.size()) {
+            grow();
+        }
+        const size_t mask = keys.size() - 1;
+        size_t slot = hashKey(key) & mask;
+        while (keys[slot] != kEmptyKey && keys[slot] != key) {
+            slot = (slot + 1) & mask;
+        }
+        if (keys[slot] == kEmptyKey) {
+            keys[slot] = key;
+            ++used;
+        }
+        sums[slot] += weight;
+    }
+
+    void grow() {
+        std::vector<uint64_t> oldKeys;
+        std::vector<double> oldSums;
+        oldKeys.swap(keys);
+        oldSums.swap(sums);
+        keys.assign(oldKeys.size() * 2, kEmptyKey);
+        sums.assign(oldKeys.size() * 2, 0.0);
+        used = 0;
+        for (size_t i = 0; i < oldKeys.size(); ++i) {
+            if (oldKeys[i] != kEmptyKey) add(oldKeys[i], oldSums[i]);
+        }
+    }
+
+    void accumulate(const geo_HeatmapGridSpec& spec, const HeatmapPoint* begin, const HeatmapPoint* end) {
+        size_t row = 0, col = 0;
+        for (const HeatmapPoint* p = begin; p != end; ++p) {
+            if (!geo_heatmapCellIndex(spec, *p, row, col)) continue;
+            add((static_cast<uint64_t>(row) << 32) | static_cast<uint64_t>(col), p->weight);
+        }
+    }
+
+    void merge(const geo_HeatmapHashGrid& other) {
+        for (size_t i = 0; i < other.keys.size(); ++i) {
+            if (other.keys[i] != kEmptyKey) add(other.keys[i], other.sums[i]);
+        }
+    }
+};
+
+// 按点的顺序切成连续块，每个线程写私有网格，最后按块顺序合并，结果与线程调度无关
+template <typename Grid, typename MakeGrid>
+static Grid geo_accumulateHeatmap(
+    const geo_HeatmapGridSpec& spec,
+    const std::vector<HeatmapPoint>& points,
+    size_t threads,
+    MakeGrid makeGrid
+) {
+    const HeatmapPoint* data = points.data();
+    Grid result = makeGrid();
+    if (threads <= 1) {
+        result.accumulate(spec, data, data + points.size());
+        return result;
+    }
+
+    const size_t chunk = (points.size() + threads - 1) / threads;
+    std::vector<Grid> partials;
+    partials.reserve(threads - 1);
+    for (size_t t = 1; t < threads; ++t) {
+        partials.push_back(makeGrid());
+    }
+
+    std::vector<std::thread> workers;
+    workers.reserve(threads - 1);
+    size_t t = 1;
+    for (; t < threads; ++t) {
+        const size_t from = std::min(points.size(), t * chunk);
+        const size_t to = std::min(points.size(), from + chunk);
+        Grid* partial = &partials[t - 1];
+        try {
+            workers.emplace_back([partial, &spec, data, from, to]() {
+                partial->accumulate(spec, data + from, data + to);
+            });
+        } catch (const std::system_error&) {
+            // 无法创建线程（线程数受限等）时不能让异常穿过 JNI 边界，剩余的块在当前线程中计算
+            break;
+        }
+    }
+    for (; t < threads; ++t) {
+        const size_t from = std::min(points.size(), t * chunk);
+        const size_t to = std::min(points.size(), from + chunk);
+        partials[t - 1].accumulate(spec, data + from, data + to);
+    }
+    result.accumulate(spec, data, data + std::min(points.size(), chunk));
+    for (auto& worker : workers) {
+        worker.join();
+    }
+    for (const auto& partial : partials) {
+        result.merge(partial);
+    }
+    return result;
+}
+
+std::vector<HeatmapGridCell> generateHeatmapGrid(const std::vector<HeatmapPoint>& points, double gridSizeMeters, int threadCount) {
     if (points.empty()) return {};
 
     // 1. 计算范围
@@ -646,6 +2962,7 @@ std::vector<HeatmapGridCell> generateHeatmapGrid(const std::vector<HeatmapPoint>
         if (p.lon < minLon) minLon = p.lon;
         if (p.lon > maxLon) maxLon = p.lon;
     }
+    if (minLat > maxLat || minLon > maxLon) return {};
 
     // 2. 将米转换为大概的经纬度步长
     // (这是一个近似值，但在热力图分桶中通常足够)
@@ -655,31 +2972,72 @@ std::vector<HeatmapGridCell> generateHeatmapGrid(const std::vector<HeatmapPoint>
     double latStep = gridSizeMeters / latDegreeDist;
     double lonStep = gridSizeMeters / lonDegreeDist;
 
-    if (latStep <= 0 || lonStep <= 0) return {};
+    if (!(latStep > 0) || !(lonStep > 0)) return {};
 
-    // 3. 将点分配到网格中
-    std::map<std::pair<int, int>, double> grid;
-    for (const auto& p : points) {
-        int latIdx = static_cast<int>((p.lat - minLat) / latStep);
-        int lonIdx = static_cast<int>((p.lon - minLon) / lonStep);
-        grid[{latIdx, lonIdx}] += p.weight;
+    const double rowSpan = std::floor((maxLat - minLat) / latStep) + 1.0;
+    const double colSpan = std::floor((maxLon - minLon) / lonStep) + 1.0;
+    // 行列下标需能放入 32 位哈希键
+    if (rowSpan > static_cast<double>(std::numeric_limits<int32_t>::max()) ||
+        colSpan > static_cast<double>(std::numeric_limits<int32_t>::max())) {
+        return {};
     }
 
-    // 4. 创建结果单元格
+    geo_HeatmapGridSpec spec;
+    spec.minLat = minLat;
+    spec.minLon = minLon;
+    spec.latStep = latStep;
+    spec.lonStep = lonStep;
+    spec.rows = static_cast<size_t>(rowSpan);
+    spec.cols = static_cast<size_t>(colSpan);
+
+    // 3. 将点分配到网格中（可选多线程）
+    size_t threads = threadCount > 0
+        ? static_cast<size_t>(threadCount)
+        : static_cast<size_t>(std::max(1u, std::thread::hardware_concurrency()));
+    threads = std::max<size_t>(1, std::min(threads, points.size() / kHeatmapMinPointsPerThread));
+
+    const double cellSpan = rowSpan * colSpan;
+    const bool useDense = cellSpan <= static_cast<double>(kHeatmapDenseMaxCells) &&
+                          cellSpan <= static_cast<double>(points.size()) * 4.0 + 4096.0;
+
+    // 4. 创建结果单元格，按 (latIdx, lonIdx) 升序输出
     std::vector<HeatmapGridCell> cells;
-    cells.reserve(grid.size());
-    for (const auto& entry : grid) {
-        int latIdx = entry.first.first;
-        int lonIdx = entry.first.second;
-        double intensity = entry.second;
-        
+    auto emit = [&cells, &spec](size_t row, size_t col, double intensity) {
         cells.push_back({
-            minLat + (latIdx + 0.5) * latStep,
-            minLon + (lonIdx + 0.5) * lonStep,
+            spec.minLat + (row + 0.5) * spec.latStep,
+            spec.minLon + (col + 0.5) * spec.lonStep,
             intensity
         });
+    };
+
+    if (useDense) {
+        const size_t cellCount = spec.rows * spec.cols;
+        const geo_HeatmapDenseGrid grid = geo_accumulateHeatmap<geo_HeatmapDenseGrid>(
+            spec, points, threads, [cellCount]() { return geo_HeatmapDenseGrid(cellCount); });
+        for (size_t i = 0; i < cellCount; ++i) {
+            if (grid.touched[i]) emit(i / spec.cols, i % spec.cols, grid.sums[i]);
+        }
+        return cells;
     }
 
+    const size_t expectedCells = std::min(points.size() / threads + 1, size_t(1) << 16);
+    const geo_HeatmapHashGrid grid = geo_accumulateHeatmap<geo_HeatmapHashGrid>(
+        spec, points, threads, [expectedCells]() { return geo_HeatmapHashGrid(expectedCells); });
+
+    std::vector<size_t> order;
+    order.reserve(grid.used);
+    for (size_t i = 0; i < grid.keys.size(); ++i) {
+        if (grid.keys[i] != geo_HeatmapHashGrid::kEmptyKey) order.push_back(i);
+    }
+    std::sort(order.begin(), order.end(), [&grid](size_t a, size_t b) {
+        return grid.keys[a] < grid.keys[b];
+    });
+
+    cells.reserve(order.size());
+    for (size_t slot : order) {
+        const uint64_t key = grid.keys[slot];
+        emit(static_cast<size_t>(key >> 32), static_cast<size_t>(key & 0xffffffffULL), grid.sums[slot]);
+    }
     return cells;
 }
 
@@ -0,0 +1,208 @@
+#include "GpsSmoother.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace gaodemap {
+
+static constexpr double kSmootherMetersPerDegree = 6371000.0 * 0.017453292519943295;
+// 初始速度未知，取较大的标准差，让前几个定位点迅速确定速度
+static constexpr double kSmootherInitialSpeedSigma = 30.0;
+// 速度低于该值时航向不可靠，沿用上一个航向
+static constexpr double kSmootherMinHeadingSpeed = 1.0;
+// 离原点超过该距离时平移原点，保持局部平面近似的精度
+static constexpr double kSmootherRecenterMeters = 5000.0;
+
+static inline double smoother_wrapLon(double lon) {
+    return lon > 180.0 ? lon - 360.0 : (lon < -180.0 ? lon + 360.0 : lon);
+}
+
+GpsSmootherPool::GpsSmootherPool(size_t capacity, const GpsSmootherOptions& options)
+    : options(options), tracks(capacity) {
+    this->options.medianWindow = std::max(1, std::min(this->options.medianWindow, kGpsSmootherMaxWindow));
+    this->options.maxRejected = std::max(1, this->options.maxRejected);
+    freeSlots.reserve(capacity);
+    // 倒序压栈，先分配小的槽位号
+    for (size_t i = capacity; i > 0; --i) {
+        freeSlots.push_back(static_cast<int32_t>(i - 1));
+    }
+}
+
+int GpsSmootherPool::acquire() {
+    if (freeSlots.empty()) return -1;
+    const int32_t slot = freeSlots.back();
+    freeSlots.pop_back();
+    tracks[slot].active = true;
+    tracks[slot].initialized = false;
+    return slot;
+}
+
+void GpsSmootherPool::release(int slot) {
+    if (slot < 0 || static_cast<size_t>(slot) >= tracks.size() || !tracks[slot].active) return;
+    tracks[slot].active = false;
+    tracks[slot].initialized = false;
+    freeSlots.push_back(slot);
+}
+
+void GpsSmootherPool::resetSlot(int slot) {
+    if (slot < 0 || static_cast<size_t>(slot) >= tracks.size()) return;
+    tracks[slot].initialized = false;
+}
+
+void GpsSmootherPool::initialize(Track& track, double time, double lat, double lon, double accuracy) const {
+    track.originLat = lat;
+    track.originLon = lon;
+    track.metersPerDegreeLon = kSmootherMetersPerDegree * std::cos(lat * 0.017453292519943295);
+    track.time = time;
+    track.x = 0.0;
+    track.y = 0.0;
+    track.vx = 0.0;
+    track.vy = 0.0;
+    track.p00 = accuracy * accuracy;
+    track.p01 = 0.0;
+    track.p11 = kSmootherInitialSpeedSigma * kSmootherInitialSpeedSigma;
+    track.heading = std::numeric_limits<double>::quiet_NaN();
+    track.innovationCount = 0;
+    track.innovationCursor = 0;
+    track.rejectedRun = 0;
+    track.initialized = true;
+}
+
+void GpsSmootherPool::recenter(Track& track) const {
+    if (std::abs(track.x) <= kSmootherRecenterMeters && std::abs(track.y) <= kSmootherRecenterMeters) return;
+    track.originLat += track.y / kSmootherMetersPerDegree;
+    track.originLon = smoother_wrapLon(track.originLon + track.x / track.metersPerDegreeLon);
+    track.metersPerDegreeLon = kSmootherMetersPerDegree * std::cos(track.originLat * 0.017453292519943295);
+    track.x = 0.0;
+    track.y = 0.0;
+}
+
+void GpsSmootherPool::output(const Track& track, double x, double y, uint8_t flags, SmoothedFix& out) const {
+    out.lat = track.originLat + y / kSmootherMetersPerDegree;
+    out.lon = smoother_wrapLon(track.originLon + x / track.metersPerDegreeLon);
+    out.speedMps = std::sqrt(track.vx * track.vx + track.vy * track.vy);
+    out.headingDegrees = track.heading;
+    out.flags = flags;
+}
+
+double GpsSmootherPool::gate(const Track& track, double innovationVariance) const {
+    // 新息协方差的 3σ 覆盖滤波器自身的不确定度（刚初始化、长时间间隔），
+    // 新息中值的倍数覆盖实际噪声比假设大的情况（城市峡谷多路径）
+    double threshold = std::max(options.minGateMeters, 3.0 * std::sqrt(innovationVariance));
+    const int count = track.innovationCount;
+    if (count > 0) {
+        float window[kGpsSmootherMaxWindow];
+        std::copy(track.innovations, track.innovations + count, window);
+        std::nth_element(window, window + count / 2, window + count);
+        threshold = std::max(threshold, options.gateScale * window[count / 2]);
+    }
+    return threshold;
+}
+
+void GpsSmootherPool::update(const int32_t* slots, const double* timestamps, const CoordSpan& points,
+                             const double* accuracies, SmoothedFix* out) {
+    const double nan = std::numeric_limits<double>::quiet_NaN();
+    const double q = options.accelerationNoise * options.accelerationNoise;
+
+    for (size_t i = 0; i < points.size(); ++i) {
+        const int32_t slot = slots[i];
+        if (slot < 0 || static_cast<size_t>(slot) >= tracks.size() || !tracks[slot].active) {
+            out[i] = {nan, nan, 0.0, nan, kGpsSmootherInvalid};
+            continue;
+        }
+
+        Track& track = tracks[slot];
+        const double time = timestamps[i];
+        const double lat = points.latAt(i);
+        const double lon = points.lonAt(i);
+        double accuracy = accuracies ? accuracies[i] : options.defaultAccuracyMeters;
+        if (!(accuracy > 0.0) || !std::isfinite(accuracy)) accuracy = options.defaultAccuracyMeters;
+
+        if (!std::isfinite(time) || !std::isfinite(lat) || !std::isfinite(lon) || std::abs(lat) > 90.0) {
+            if (track.initialized) {
+                output(track, track.x, track.y, kGpsSmootherRejected, out[i]);
+            } else {
+                out[i] = {nan, nan, 0.0, nan, kGpsSmootherRejected};
+            }
+            continue;
+        }
+
+        if (!track.initialized || time - track.time > options.resetAfterSeconds) {
+            initialize(track, time, lat, lon, accuracy);
+            output(track, 0.0, 0.0, kGpsSmootherReset, out[i]);
+            continue;
+        }
+
+        const double dt = time - track.time;
+        if (dt < 0.0) {
+            output(track, track.x, track.y, kGpsSmootherRejected, out[i]);
+            continue;
+        }
+
+        // 预测：匀速模型，过程噪声为白噪声加速度
+        const double dt2 = dt * dt;
+        const double px = track.x + track.vx * dt;
+        const double py = track.y + track.vy * dt;
+        const double p00 = track.p00 + 2.0 * dt * track.p01 + dt2 * track.p11 + q * dt2 * dt2 * 0.25;
+        const double p01 = track.p01 + dt * track.p11 + q * dt2 * dt * 0.5;
+        const double p11 = track.p11 + q * dt2;
+
+        const double zx = smoother_wrapLon(lon - track.originLon) * track.metersPerDegreeLon;
+        const double zy = (lat - track.originLat) * kSmootherMetersPerDegree;
+        const double ix = zx - px;
+        const double iy = zy - py;
+        const double r = accuracy * accuracy;
+        const double s = p00 + r;
+        const double innovation = std::sqrt(ix * ix + iy * iy);
+
+        if (innovation > gate(track, s)) {
+            if (++track.rejectedRun >= options.maxRejected) {
+                // 连续多个定位点都远离预测位置，认为车辆确实到了新位置（如出隧道、重新定位）
+                initialize(track, time, lat, lon, accuracy);
+                output(track, 0.0, 0.0, kGpsSmootherReset, out[i]);
+            } else {
+                output(track, px, py, kGpsSmootherRejected, out[i]);
+            }
+            continue;
+        }
+
+        // 更新：两轴共用增益与协方差
+        const double k0 = p00 / s;
+        const double k1 = p01 / s;
+        track.x = px + k0 * ix;
+        track.y = py + k0 * iy;
+        track.vx += k1 * ix;
+        track.vy += k1 * iy;
+        track.p00 = (1.0 - k0) * p00;
+        track.p01 = (1.0 - k0) * p01;
+        track.p11 = p11 - k1 * p01;
+        track.time = time;
+        track.rejectedRun = 0;
+
+        track.innovations[track.innovationCursor] = static_cast<float>(innovation);
+        track.innovationCursor = static_cast<uint8_t>((track.innovationCursor + 1) % options.medianWindow);
+        if (track.innovationCount < options.medianWindow) ++track.innovationCount;
+
+        const double speed2 = track.vx * track.vx + track.vy * track.vy;
+        if (speed2 >= kSmootherMinHeadingSpeed * kSmootherMinHeadingSpeed) {
+            const double degrees = std::atan2(track.vx, track.vy) * 57.29577951308232;
+            track.heading = degrees < 0.0 ? degrees + 360.0 : degrees;
+        }
+
+        recenter(track);
+        output(track, track.x, track.y, 0, out[i]);
+    }
+}
+
+bool GpsSmootherPool::predict(int slot, double time, double& lat, double& lon) const {
+    if (slot < 0 || static_cast<size_t>(slot) >= tracks.size()) return false;
+    const Track& track = tracks[slot];
+    if (!track.active || !track.initialized) return false;
+    const double dt = std::max(0.0, time - track.time);
+    lat = track.originLat + (track.y + track.vy * dt) / kSmootherMetersPerDegree;
+    lon = smoother_wrapLon(track.originLon + (track.x + track.vx * dt) / track.metersPerDegreeLon);
+    return true;
+}
+
+}
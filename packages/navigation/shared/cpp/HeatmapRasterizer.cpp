@@ -0,0 +1,680 @@
+#include "HeatmapRasterizer.hpp"
+#include "ColorParser.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace gaodemap {
+
+// 用 n 次盒式模糊逼近标准差为 sigma 的高斯核，返回每次模糊的半径
+// 参考: W. Jarosz, "Fast Image Convolutions"; P. Kovesi, "Fast Almost-Gaussian Filtering"
+static std::vector<int> heatmap_boxRadiiForGauss(double sigma, int n) {
+    const double wIdeal = std::sqrt(12.0 * sigma * sigma / n + 1.0);
+    int wl = static_cast<int>(std::floor(wIdeal));
+    if (wl % 2 == 0) wl--;
+    if (wl < 1) wl = 1;
+    const int wu = wl + 2;
+    const double mIdeal = (12.0 * sigma * sigma - n * wl * wl - 4.0 * n * wl - 3.0 * n) / (-4.0 * wl - 4.0);
+    const int m = static_cast<int>(std::lround(mIdeal));
+
+    std::vector<int> radii;
+    radii.reserve(n);
+    for (int i = 0; i < n; ++i) {
+        radii.push_back(((i < m ? wl : wu) - 1) / 2);
+    }
+    return radii;
+}
+
+static std::vector<int> heatmap_gaussianBoxRadii(const HeatmapRasterOptions& options) {
+    return heatmap_boxRadiiForGauss(std::max(0.0, options.radiusPx) / 3.0, 3);
+}
+
+static int heatmap_epanechnikovRadius(const HeatmapRasterOptions& options) {
+    return static_cast<int>(std::lround(std::max(0.0, options.radiusPx)));
+}
+
+// 核在每一侧影响的像素数，栅格化时四周按此扩展
+static int heatmap_kernelMargin(const HeatmapRasterOptions& options) {
+    if (options.kernel == HeatmapKernel::Epanechnikov) {
+        return heatmap_epanechnikovRadius(options) + 1;
+    }
+    int margin = 1;
+    for (int r : heatmap_gaussianBoxRadii(options)) margin += r;
+    return margin;
+}
+
+// 水平盒式模糊：滑动窗口求和，窗口外视为 0
+static void heatmap_boxBlurH(const float* src, float* dst, int width, int height, int r) {
+    const float scale = 1.0f / static_cast<float>(2 * r + 1);
+    for (int y = 0; y < height; ++y) {
+        const float* row = src + static_cast<size_t>(y) * width;
+        float* out = dst + static_cast<size_t>(y) * width;
+        double acc = 0.0;
+        for (int x = 0; x <= r && x < width; ++x) acc += row[x];
+        for (int x = 0; x < width; ++x) {
+            out[x] = static_cast<float>(acc) * scale;
+            const int add = x + r + 1;
+            const int remove = x - r;
+            if (add < width) acc += row[add];
+            if (remove >= 0) acc -= row[remove];
+        }
+    }
+}
+
+// 垂直盒式模糊：逐行推进整行累加器，保持按行顺序访问内存
+static void heatmap_boxBlurV(const float* src, float* dst, int width, int height, int r, std::vector<double>& acc) {
+    const float scale = 1.0f / static_cast<float>(2 * r + 1);
+    acc.assign(width, 0.0);
+    for (int y = 0; y <= r && y < height; ++y) {
+        const float* row = src + static_cast<size_t>(y) * width;
+        for (int x = 0; x < width; ++x) acc[x] += row[x];
+    }
+    for (int y = 0; y < height; ++y) {
+        float* out = dst + static_cast<size_t>(y) * width;
+        for (int x = 0; x < width; ++x) out[x] = static_cast<float>(acc[x]) * scale;
+        const int add = y + r + 1;
+        const int remove = y - r;
+        if (add < height) {
+            const float* row = src + static_cast<size_t>(add) * width;
+            for (int x = 0; x < width; ++x) acc[x] += row[x];
+        }
+        if (remove >= 0) {
+            const float* row = src + static_cast<size_t>(remove) * width;
+            for (int x = 0; x < width; ++x) acc[x] -= row[x];
+        }
+    }
+}
+
+/**
+ * 与 Epanechnikov 核 K(d) = 1 - d²/R²（d < R）做二维卷积，只输出中心 size × size 区域
+ * 核在每一行上是 dx 的二次多项式，借助每行 Σg、Σu·g、Σu²·g 的前缀和，每个像素每行 O(1)，
+ * 总开销为 O(像素数 × 2R)；核按离散采样之和归一化，保持总权重
+ */
+static void heatmap_convolveEpanechnikov(const std::vector<float>& grid, int paddedSize, int margin, int size, int radius, std::vector<float>& out) {
+    if (radius <= 0) {
+        for (int y = 0; y < size; ++y) {
+            const float* src = &grid[static_cast<size_t>(y + margin) * paddedSize + margin];
+            std::copy(src, src + size, &out[static_cast<size_t>(y) * size]);
+        }
+        return;
+    }
+
+    const size_t stride = static_cast<size_t>(paddedSize) + 1;
+    std::vector<double> s0(stride * paddedSize, 0.0);
+    std::vector<double> s1(stride * paddedSize, 0.0);
+    std::vector<double> s2(stride * paddedSize, 0.0);
+    for (int row = 0; row < paddedSize; ++row) {
+        const float* src = &grid[static_cast<size_t>(row) * paddedSize];
+        const size_t base = static_cast<size_t>(row) * stride;
+        for (int u = 0; u < paddedSize; ++u) {
+            const double g = src[u];
+            s0[base + u + 1] = s0[base + u] + g;
+            s1[base + u + 1] = s1[base + u] + g * u;
+            s2[base + u + 1] = s2[base + u] + g * u * u;
+        }
+    }
+
+    const double r2 = static_cast<double>(radius) * radius;
+    std::vector<int> halfWidth(radius + 1);
+    double norm = 0.0;
+    for (int dy = -radius; dy <= radius; ++dy) {
+        const int w = static_cast<int>(std::floor(std::sqrt(r2 - static_cast<double>(dy) * dy)));
+        halfWidth[std::abs(dy)] = w;
+        for (int dx = -w; dx <= w; ++dx) {
+            norm += 1.0 - (static_cast<double>(dx) * dx + static_cast<double>(dy) * dy) / r2;
+        }
+    }
+    const double invNorm = 1.0 / norm;
+
+    for (int y = 0; y < size; ++y) {
+        const int cy = y + margin;
+        for (int x = 0; x < size; ++x) {
+            const int cx = x + margin;
+            const double fx = cx;
+            double sum = 0.0;
+            for (int dy = -radius; dy <= radius; ++dy) {
+                const int w = halfWidth[std::abs(dy)];
+                const size_t base = static_cast<size_t>(cy + dy) * stride;
+                const size_t lo = base + (cx - w);
+                const size_t hi = base + (cx + w + 1);
+                const double a0 = s0[hi] - s0[lo];
+                if (a0 == 0.0) continue;
+                const double a1 = s1[hi] - s1[lo];
+                const double a2 = s2[hi] - s2[lo];
+                // Σ g(u) · (1 - dy²/R² - (u - cx)²/R²)
+                sum += (1.0 - dy * dy / r2) * a0 - (a2 - 2.0 * fx * a1 + fx * fx * a0) / r2;
+            }
+            out[static_cast<size_t>(y) * size + x] = static_cast<float>(sum * invNorm);
+        }
+    }
+}
+
+HeatmapRaster rasterizeHeatmapTile(
+    const std::vector<HeatmapPoint>& points,
+    int tileX,
+    int tileY,
+    int zoom,
+    const HeatmapRasterOptions& options
+) {
+    HeatmapRaster raster;
+    if (options.tileSize <= 0 || zoom < 0 || zoom > 30) {
+        return raster;
+    }
+
+    const int size = options.tileSize;
+    const int margin = heatmap_kernelMargin(options);
+
+    // 在四周扩展 margin 的缓冲区上分摊与模糊，保证瓦片边缘处的核完整
+    const int paddedSize = size + 2 * margin;
+    std::vector<float> buffer(static_cast<size_t>(paddedSize) * paddedSize, 0.0f);
+
+    const double scale = static_cast<double>(size) / 256.0;
+    const double worldSize = std::ldexp(static_cast<double>(size), zoom);
+    const double originX = static_cast<double>(tileX) * size - margin;
+    const double originY = static_cast<double>(tileY) * size - margin;
+
+    for (const auto& p : points) {
+        if (!std::isfinite(p.lat) || !std::isfinite(p.lon) || !std::isfinite(p.weight) || p.weight == 0.0) {
+            continue;
+        }
+        const PixelResult pixel = latLngToPixel(p.lat, p.lon, zoom);
+        double px = pixel.x * scale - originX;
+        const double py = pixel.y * scale - originY;
+        if (!(py >= 0.0 && py < paddedSize - 1)) continue;
+        // 跨 180° 经线时取距离瓦片更近的世界副本
+        if (px < 0.0) px += worldSize;
+        else if (px >= paddedSize - 1) px -= worldSize;
+        if (!(px >= 0.0 && px < paddedSize - 1)) continue;
+
+        // 以像素中心为采样点，双线性分摊权重
+        const double fx = std::max(0.0, px - 0.5);
+        const double fy = std::max(0.0, py - 0.5);
+        const int x0 = static_cast<int>(fx);
+        const int y0 = static_cast<int>(fy);
+        const float tx = static_cast<float>(fx - x0);
+        const float ty = static_cast<float>(fy - y0);
+        const float w = static_cast<float>(p.weight);
+        float* cell = &buffer[static_cast<size_t>(y0) * paddedSize + x0];
+        cell[0] += w * (1.0f - tx) * (1.0f - ty);
+        cell[1] += w * tx * (1.0f - ty);
+        cell[paddedSize] += w * (1.0f - tx) * ty;
+        cell[paddedSize + 1] += w * tx * ty;
+    }
+
+    raster.width = size;
+    raster.height = size;
+    raster.values.resize(static_cast<size_t>(size) * size);
+    if (options.kernel == HeatmapKernel::Epanechnikov) {
+        heatmap_convolveEpanechnikov(buffer, paddedSize, margin, size, heatmap_epanechnikovRadius(options), raster.values);
+    } else {
+        std::vector<float> scratch(buffer.size());
+        std::vector<double> acc;
+        for (int r : heatmap_gaussianBoxRadii(options)) {
+            if (r <= 0) continue;
+            heatmap_boxBlurH(buffer.data(), scratch.data(), paddedSize, paddedSize, r);
+            heatmap_boxBlurV(scratch.data(), buffer.data(), paddedSize, paddedSize, r, acc);
+        }
+        for (int y = 0; y < size; ++y) {
+            const float* src = &buffer[static_cast<size_t>(y + margin) * paddedSize + margin];
+            std::copy(src, src + size, &raster.values[static_cast<size_t>(y) * size]);
+        }
+    }
+
+    float maxValue = 0.0f;
+    for (float v : raster.values) {
+        if (v > maxValue) maxValue = v;
+    }
+    // 滑动求和 / 前缀和的加减抵消会在核支撑范围外留下极小的残差（含负值），统一归零
+    const float epsilon = maxValue * 1e-6f;
+    for (float& v : raster.values) {
+        if (v <= epsilon) v = 0.0f;
+    }
+    raster.maxValue = maxValue;
+    return raster;
+}
+
+std::vector<uint8_t> quantizeHeatmap(const HeatmapRaster& raster, float maxIntensity) {
+    std::vector<uint8_t> result(raster.values.size(), 0);
+    const float maxValue = maxIntensity > 0.0f ? maxIntensity : raster.maxValue;
+    if (!(maxValue > 0.0f)) {
+        return result;
+    }
+
+    const float scale = 255.0f / maxValue;
+    for (size_t i = 0; i < raster.values.size(); ++i) {
+        const float v = raster.values[i] * scale + 0.5f;
+        result[i] = v >= 255.0f ? 255 : static_cast<uint8_t>(v);
+    }
+    return result;
+}
+
+static inline uint32_t heatmap_lerpColor(uint32_t from, uint32_t to, double t) {
+    uint32_t out = 0;
+    for (int shift = 0; shift < 32; shift += 8) {
+        const double a = static_cast<double>((from >> shift) & 0xFF);
+        const double b = static_cast<double>((to >> shift) & 0xFF);
+        const uint32_t c = static_cast<uint32_t>(std::lround(a + (b - a) * t));
+        out |= (std::min<uint32_t>(c, 255) << shift);
+    }
+    return out;
+}
+
+struct heatmap_GradientStop {
+    double position;
+    uint32_t color;
+};
+
+// 第一个色标位于 0 时，透明度在 [0, 该值] 的强度区间内淡入
+static constexpr double kHeatmapAlphaRampEnd = 0.2;
+
+static std::vector<uint32_t> heatmap_buildLut(std::vector<heatmap_GradientStop> stops) {
+    std::stable_sort(stops.begin(), stops.end(), [](const heatmap_GradientStop& a, const heatmap_GradientStop& b) {
+        return a.position < b.position;
+    });
+
+    std::vector<uint32_t> lut(256, 0);
+    size_t segment = 0;
+    for (int i = 1; i < 256; ++i) {
+        const double t = static_cast<double>(i) / 255.0;
+        while (segment + 1 < stops.size() && stops[segment + 1].position <= t) {
+            ++segment;
+        }
+        if (t <= stops.front().position) {
+            lut[i] = stops.front().color;
+        } else if (segment + 1 >= stops.size()) {
+            lut[i] = stops.back().color;
+        } else {
+            const heatmap_GradientStop& a = stops[segment];
+            const heatmap_GradientStop& b = stops[segment + 1];
+            const double span = b.position - a.position;
+            lut[i] = span > 0.0 ? heatmap_lerpColor(a.color, b.color, (t - a.position) / span) : b.color;
+        }
+    }
+
+    // 低强度区间内透明度从 0 线性增加到色标的透明度，热力斑块边缘淡入而不是硬边；
+    // 第一个色标位置 > 0 时在 [0, 该位置] 内淡入（与地图 SDK Gradient 的 startPoints 一致）
+    const double rampEnd = stops.front().position > 0.0 ? stops.front().position : kHeatmapAlphaRampEnd;
+    for (int i = 1; i < 256; ++i) {
+        const double t = static_cast<double>(i) / 255.0;
+        if (t >= rampEnd) break;
+        const uint32_t alpha = static_cast<uint32_t>(std::lround((lut[i] >> 24) * (t / rampEnd)));
+        lut[i] = (alpha << 24) | (lut[i] & 0x00FFFFFF);
+    }
+    return lut;
+}
+
+template <typename Color, typename ToArgb>
+static std::vector<uint32_t> heatmap_buildLutFrom(const std::vector<Color>& colors, const std::vector<double>& positions, ToArgb toArgb) {
+    if (colors.empty() || (!positions.empty() && positions.size() != colors.size())) {
+        return {};
+    }
+
+    std::vector<heatmap_GradientStop> stops;
+    stops.reserve(colors.size());
+    for (size_t i = 0; i < colors.size(); ++i) {
+        double position = positions.empty()
+            ? (colors.size() == 1 ? 1.0 : static_cast<double>(i) / static_cast<double>(colors.size() - 1))
+            : positions[i];
+        if (!std::isfinite(position)) return {};
+        stops.push_back({std::min(1.0, std::max(0.0, position)), toArgb(colors[i])});
+    }
+    return heatmap_buildLut(std::move(stops));
+}
+
+std::vector<uint32_t> buildHeatmapGradientLut(const std::vector<std::string>& colors, const std::vector<double>& positions) {
+    return heatmap_buildLutFrom(colors, positions, [](const std::string& color) { return parseColor(color); });
+}
+
+std::vector<uint32_t> buildHeatmapGradientLutArgb(const std::vector<uint32_t>& colors, const std::vector<double>& positions) {
+    return heatmap_buildLutFrom(colors, positions, [](uint32_t color) { return color; });
+}
+
+std::vector<uint32_t> colorizeHeatmap(const std::vector<uint8_t>& intensities, const std::vector<uint32_t>& lut) {
+    std::vector<uint32_t> pixels(intensities.size(), 0);
+    if (lut.size() < 256) {
+        return pixels;
+    }
+    for (size_t i = 0; i < intensities.size(); ++i) {
+        pixels[i] = lut[intensities[i]];
+    }
+    return pixels;
+}
+
+// --- 瓦片金字塔 ---
+
+// 点索引使用的网格级别：zoom 16（约 600 米），单元键为 (row << 32) | col
+static constexpr int kHeatmapIndexZoom = 16;
+static constexpr int64_t kHeatmapIndexCells = int64_t(1) << kHeatmapIndexZoom;
+static constexpr int kHeatmapMaxTileZoom = 28;
+// 重新估计的自动峰值与原值相差不超过该比例时沿用原值
+static constexpr float kHeatmapPeakTolerance = 0.1f;
+
+static inline int64_t heatmap_clampCell(double v01) {
+    const double cell = std::floor(v01 * static_cast<double>(kHeatmapIndexCells));
+    if (!(cell >= 0.0)) return 0;
+    if (cell >= static_cast<double>(kHeatmapIndexCells)) return kHeatmapIndexCells - 1;
+    return static_cast<int64_t>(cell);
+}
+
+static inline uint64_t heatmap_cellKey(int64_t row, int64_t col) {
+    return (static_cast<uint64_t>(row) << 32) | static_cast<uint64_t>(col);
+}
+
+static inline uint64_t heatmap_mixFingerprint(uint64_t hash, uint64_t value) {
+    hash ^= value + 0x9e3779b97f4a7c15ULL + (hash << 6) + (hash >> 2);
+    return hash;
+}
+
+static inline uint64_t heatmap_doubleBits(double value) {
+    uint64_t bits = 0;
+    std::memcpy(&bits, &value, sizeof(bits));
+    return bits;
+}
+
+// 未设置渐变时使用的默认色带：蓝 → 绿 → 红
+static const std::vector<uint32_t>& heatmap_defaultLut() {
+    static const std::vector<uint32_t> lut = buildHeatmapGradientLut(std::vector<std::string>{"#0000FF", "#00FF00", "#FF0000"}, {});
+    return lut;
+}
+
+HeatmapTileProvider::HeatmapTileProvider(size_t maxCachedTiles)
+    : maxCachedTiles(std::max<size_t>(1, maxCachedTiles)),
+      index(std::make_shared<const std::vector<IndexedPoint>>()),
+      lut(heatmap_defaultLut()) {
+}
+
+void HeatmapTileProvider::setPoints(const std::vector<HeatmapPoint>& points) {
+    auto indexed = std::make_shared<std::vector<IndexedPoint>>();
+    indexed->reserve(points.size());
+    for (const auto& p : points) {
+        if (!std::isfinite(p.lat) || !std::isfinite(p.lon) || !std::isfinite(p.weight) || p.weight == 0.0) {
+            continue;
+        }
+        // zoom 0 的像素坐标除以 256 即归一化的 Web Mercator 坐标
+        const PixelResult pixel = latLngToPixel(p.lat, p.lon, 0);
+        const int64_t col = heatmap_clampCell(pixel.x / 256.0);
+        const int64_t row = heatmap_clampCell(pixel.y / 256.0);
+        indexed->push_back({heatmap_cellKey(row, col), p});
+    }
+    // 稳定排序：同一单元内保持输入顺序，使未变化区域的指纹保持不变
+    std::stable_sort(indexed->begin(), indexed->end(), [](const IndexedPoint& a, const IndexedPoint& b) {
+        return a.cell < b.cell;
+    });
+
+    std::lock_guard<std::mutex> lock(mutex);
+    index = std::move(indexed);
+    ++dataGeneration;
+    // 自动峰值保留到下次请求该级别瓦片时重新估计，变化在容差内则沿用
+}
+
+void HeatmapTileProvider::setStyle(const HeatmapRasterOptions& newOptions, const std::vector<uint32_t>& newLut, float newMaxIntensity) {
+    std::lock_guard<std::mutex> lock(mutex);
+    // 不足 256 项（如 JS 清除了渐变）时恢复默认色带
+    const std::vector<uint32_t>& targetLut = newLut.size() >= 256 ? newLut : heatmap_defaultLut();
+    const bool lutChanged = targetLut != lut;
+    if (!lutChanged &&
+        newOptions.tileSize == options.tileSize &&
+        newOptions.radiusPx == options.radiusPx &&
+        newOptions.kernel == options.kernel &&
+        newMaxIntensity == maxIntensity) {
+        // 样式未变化时保留缓存，数据更新仍可按瓦片复用
+        return;
+    }
+    options = newOptions;
+    if (lutChanged) {
+        lut = targetLut;
+    }
+    maxIntensity = newMaxIntensity;
+    ++styleGeneration;
+    autoMaxIntensity.clear();
+    cache.clear();
+    lru.clear();
+}
+
+uint64_t HeatmapTileProvider::currentStyleGeneration() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return styleGeneration;
+}
+
+size_t HeatmapTileProvider::cachedTileCount() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return cache.size();
+}
+
+void HeatmapTileProvider::clearCache() {
+    std::lock_guard<std::mutex> lock(mutex);
+    cache.clear();
+    lru.clear();
+}
+
+uint64_t HeatmapTileProvider::collectTilePoints(
+    const std::vector<IndexedPoint>& index,
+    int x,
+    int y,
+    int z,
+    double marginTiles,
+    std::vector<HeatmapPoint>& out
+) {
+    const double tileCount = std::ldexp(1.0, z);
+    const double minX01 = (x - marginTiles) / tileCount;
+    const double maxX01 = (x + 1 + marginTiles) / tileCount;
+    const int64_t rowBegin = heatmap_clampCell((y - marginTiles) / tileCount);
+    const int64_t rowEnd = heatmap_clampCell((y + 1 + marginTiles) / tileCount);
+
+    // 经度方向可能跨越 180° 经线，拆成至多两段列区间
+    int64_t colRanges[2][2];
+    int rangeCount = 0;
+    if (maxX01 - minX01 >= 1.0) {
+        colRanges[rangeCount][0] = 0;
+        colRanges[rangeCount][1] = kHeatmapIndexCells - 1;
+        ++rangeCount;
+    } else {
+        if (minX01 < 0.0) {
+            colRanges[rangeCount][0] = heatmap_clampCell(minX01 + 1.0);
+            colRanges[rangeCount][1] = kHeatmapIndexCells - 1;
+            ++rangeCount;
+        }
+        if (maxX01 > 1.0) {
+            colRanges[rangeCount][0] = 0;
+            colRanges[rangeCount][1] = heatmap_clampCell(maxX01 - 1.0);
+            ++rangeCount;
+        }
+        colRanges[rangeCount][0] = heatmap_clampCell(std::max(0.0, minX01));
+        colRanges[rangeCount][1] = heatmap_clampCell(std::min(maxX01, 1.0 - 1e-12));
+        ++rangeCount;
+    }
+
+    auto inColumns = [&](uint64_t cell) {
+        const int64_t col = static_cast<int64_t>(cell & 0xffffffffULL);
+        for (int r = 0; r < rangeCount; ++r) {
+            if (col >= colRanges[r][0] && col <= colRanges[r][1]) return true;
+        }
+        return false;
+    };
+
+    uint64_t fingerprint = 0xcbf29ce484222325ULL;
+    auto take = [&](const IndexedPoint& p) {
+        out.push_back(p.point);
+        fingerprint = heatmap_mixFingerprint(fingerprint, heatmap_doubleBits(p.point.lat));
+        fingerprint = heatmap_mixFingerprint(fingerprint, heatmap_doubleBits(p.point.lon));
+        fingerprint = heatmap_mixFingerprint(fingerprint, heatmap_doubleBits(p.point.weight));
+    };
+    auto lowerBound = [&index](uint64_t key) {
+        return std::lower_bound(index.begin(), index.end(), key, [](const IndexedPoint& p, uint64_t k) {
+            return p.cell < k;
+        });
+    };
+
+    const auto first = lowerBound(heatmap_cellKey(rowBegin, 0));
+    const auto last = lowerBound(heatmap_cellKey(rowEnd + 1, 0));
+    const size_t span = static_cast<size_t>(last - first);
+    const size_t rows = static_cast<size_t>(rowEnd - rowBegin + 1);
+    const size_t searchCost = rows * static_cast<size_t>(rangeCount) * 32;
+
+    if (span <= searchCost) {
+        // 行区间内点不多（低缩放级别的大瓦片），直接顺序扫描
+        for (auto it = first; it != last; ++it) {
+            if (inColumns(it->cell)) take(*it);
+        }
+    } else {
+        // 每行对各列区间二分定位，只访问瓦片覆盖范围内的点
+        for (int64_t row = rowBegin; row <= rowEnd; ++row) {
+            for (int r = 0; r < rangeCount; ++r) {
+                const uint64_t endKey = heatmap_cellKey(row, colRanges[r][1]);
+                for (auto it = lowerBound(heatmap_cellKey(row, colRanges[r][0])); it != index.end() && it->cell <= endKey; ++it) {
+                    take(*it);
+                }
+            }
+        }
+    }
+    return heatmap_mixFingerprint(fingerprint, out.size());
+}
+
+float HeatmapTileProvider::estimateMaxIntensity(const std::vector<IndexedPoint>& index, int z, const HeatmapRasterOptions& options) {
+    const double binPx = std::max(1.0, options.radiusPx);
+    const double scale = std::ldexp(static_cast<double>(std::max(1, options.tileSize)), z) / binPx;
+    std::unordered_map<uint64_t, double> bins;
+    bins.reserve(std::min<size_t>(index.size(), size_t(1) << 20));
+    double maxSum = 0.0;
+    for (const auto& item : index) {
+        const PixelResult pixel = latLngToPixel(item.point.lat, item.point.lon, 0);
+        const uint64_t bx = static_cast<uint64_t>(std::max(0.0, std::floor(pixel.x / 256.0 * scale)));
+        const uint64_t by = static_cast<uint64_t>(std::max(0.0, std::floor(pixel.y / 256.0 * scale)));
+        double& sum = bins[(by << 32) | (bx & 0xffffffffULL)];
+        sum += item.point.weight;
+        if (sum > maxSum) maxSum = sum;
+    }
+    return static_cast<float>(maxSum / (binPx * binPx));
+}
+
+void HeatmapTileProvider::touch(CachedTile& tile) {
+    lru.splice(lru.begin(), lru, tile.lruIt);
+}
+
+void HeatmapTileProvider::insert(uint64_t key, TilePixels pixels, uint64_t fingerprint, float normalization) {
+    auto found = cache.find(key);
+    if (found != cache.end()) {
+        found->second.pixels = std::move(pixels);
+        found->second.fingerprint = fingerprint;
+        found->second.normalization = normalization;
+        found->second.generation = dataGeneration;
+        touch(found->second);
+        return;
+    }
+
+    while (cache.size() >= maxCachedTiles && !lru.empty()) {
+        cache.erase(lru.back());
+        lru.pop_back();
+    }
+    lru.push_front(key);
+    cache[key] = CachedTile{std::move(pixels), fingerprint, normalization, dataGeneration, lru.begin()};
+}
+
+HeatmapTileProvider::TilePixels HeatmapTileProvider::getTile(int x, int y, int z) {
+    static const TilePixels kEmptyTile = std::make_shared<const std::vector<uint32_t>>();
+    if (z < 0 || z > kHeatmapMaxTileZoom) {
+        return kEmptyTile;
+    }
+    const int64_t tileCount = int64_t(1) << z;
+    if (y < 0 || y >= tileCount) {
+        return kEmptyTile;
+    }
+    // 地图横向平铺时 x 可能超出 [0, 2^z)，归一化到主世界
+    const int64_t wrappedX = ((static_cast<int64_t>(x) % tileCount) + tileCount) % tileCount;
+    x = static_cast<int>(wrappedX);
+    const uint64_t key = (static_cast<uint64_t>(z) << 56) | (static_cast<uint64_t>(x) << 28) | static_cast<uint64_t>(y);
+
+    PointIndex indexSnapshot;
+    HeatmapRasterOptions optionsSnapshot;
+    std::vector<uint32_t> lutSnapshot;
+    float maxIntensitySnapshot = 0.0f;
+    uint64_t generation = 0;
+    uint64_t style = 0;
+    bool hasStaleEntry = false;
+    uint64_t staleFingerprint = 0;
+    float staleNormalization = 0.0f;
+    TilePixels stalePixels;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        auto found = cache.find(key);
+        if (found != cache.end()) {
+            touch(found->second);
+            if (found->second.generation == dataGeneration) {
+                return found->second.pixels;
+            }
+            hasStaleEntry = true;
+            staleFingerprint = found->second.fingerprint;
+            staleNormalization = found->second.normalization;
+            stalePixels = found->second.pixels;
+        }
+        indexSnapshot = index;
+        optionsSnapshot = options;
+        lutSnapshot = lut;
+        maxIntensitySnapshot = maxIntensity;
+        generation = dataGeneration;
+        style = styleGeneration;
+    }
+
+    const int tileSize = std::max(1, optionsSnapshot.tileSize);
+    const int margin = heatmap_kernelMargin(optionsSnapshot);
+
+    if (!(maxIntensitySnapshot > 0.0f)) {
+        bool current = false;
+        bool hasPrevious = false;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            auto found = autoMaxIntensity.find(z);
+            if (found != autoMaxIntensity.end() && style == styleGeneration) {
+                maxIntensitySnapshot = found->second.value;
+                hasPrevious = true;
+                current = found->second.generation == generation;
+            }
+        }
+        if (!current) {
+            const float estimated = estimateMaxIntensity(*indexSnapshot, z, optionsSnapshot);
+            if (!hasPrevious || std::abs(estimated - maxIntensitySnapshot) > kHeatmapPeakTolerance * maxIntensitySnapshot) {
+                maxIntensitySnapshot = estimated;
+            }
+            std::lock_guard<std::mutex> lock(mutex);
+            if (generation == dataGeneration && style == styleGeneration) {
+                auto found = autoMaxIntensity.find(z);
+                if (found != autoMaxIntensity.end() && found->second.generation == generation) {
+                    // 其他瓦片线程已完成本版本的估计，以其结果为准
+                    maxIntensitySnapshot = found->second.value;
+                } else {
+                    autoMaxIntensity[z] = AutoPeak{maxIntensitySnapshot, generation};
+                }
+            }
+        }
+    }
+
+    std::vector<HeatmapPoint> tilePoints;
+    const uint64_t fingerprint = collectTilePoints(
+        *indexSnapshot, x, y, z, static_cast<double>(margin) / tileSize, tilePoints);
+
+    TilePixels pixels;
+    if (hasStaleEntry && fingerprint == staleFingerprint && staleNormalization == maxIntensitySnapshot) {
+        // 数据已更新，但本瓦片的输入点与归一化基准都未变化，直接复用
+        pixels = stalePixels;
+    } else if (tilePoints.empty()) {
+        pixels = kEmptyTile;
+    } else {
+        const HeatmapRaster raster = rasterizeHeatmapTile(tilePoints, x, y, z, optionsSnapshot);
+        if (raster.maxValue > 0.0f) {
+            pixels = std::make_shared<const std::vector<uint32_t>>(
+                colorizeHeatmap(quantizeHeatmap(raster, maxIntensitySnapshot), lutSnapshot));
+        } else {
+            pixels = kEmptyTile;
+        }
+    }
+
+    std::lock_guard<std::mutex> lock(mutex);
+    // 计算期间样式或数据被替换时不写入缓存，避免缓存过期结果
+    if (style == styleGeneration && generation == dataGeneration) {
+        insert(key, pixels, fingerprint, maxIntensitySnapshot);
+    }
+    return pixels;
+}
+
+}
@@ -0,0 +1,333 @@
+#include "PathSimilarity.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace gaodemap {
+
+static constexpr double kSimilarityMetersPerDegree = 6371000.0 * 0.017453292519943295;
+static constexpr double kSimilarityInfinity = std::numeric_limits<double>::infinity();
+// 自动选择网格边长时的下限，以及网格数相对线段数的上限倍数
+static constexpr double kSimilarityMinCellMeters = 20.0;
+static constexpr double kSimilarityMaxCellsPerSegment = 4.0;
+
+static inline double similarity_wrapLon(double dLon) {
+    return dLon > 180.0 ? dLon - 360.0 : (dLon < -180.0 ? dLon + 360.0 : dLon);
+}
+
+static inline double similarity_cosDeg(double degrees) {
+    return std::cos(degrees * 0.017453292519943295);
+}
+
+PathSegmentIndex::PathSegmentIndex(const CoordSpan& path, double cellMeters)
+    : refLon(0.0), cosRef(1.0), cosMin(1.0), cellSize(1.0), minX(0.0), minY(0.0) {
+    const size_t n = path.size();
+    if (n == 0) return;
+
+    xs.resize(n);
+    ys.resize(n);
+    refLon = path.lonAt(0);
+    double minLat = path.latAt(0);
+    double maxLat = minLat;
+    xs[0] = refLon;
+    ys[0] = minLat;
+    for (size_t i = 1; i < n; ++i) {
+        // 相对上一个顶点展开经度，跨 180° 经线的路线保持连续
+        xs[i] = xs[i - 1] + similarity_wrapLon(path.lonAt(i) - path.lonAt(i - 1));
+        ys[i] = path.latAt(i);
+        minLat = std::min(minLat, ys[i]);
+        maxLat = std::max(maxLat, ys[i]);
+    }
+
+    // 网格投影取路线范围内最接近赤道的纬度作为经度缩放，网格距离不小于真实距离；
+    // 查询时再乘以最高纬度（或查询点纬度）处的缩放比得到真实距离的下界
+    const double nearestEquator = (minLat <= 0.0 && maxLat >= 0.0) ? 0.0 : std::min(std::abs(minLat), std::abs(maxLat));
+    const double farthestEquator = std::max(std::abs(minLat), std::abs(maxLat));
+    cosRef = std::max(similarity_cosDeg(nearestEquator), 1e-6);
+    cosMin = std::max(similarity_cosDeg(farthestEquator), 1e-6);
+
+    const double xScale = kSimilarityMetersPerDegree * cosRef;
+    double maxX = xs[0] * xScale;
+    double maxY = ys[0] * kSimilarityMetersPerDegree;
+    minX = maxX;
+    minY = maxY;
+    double length = 0.0;
+    for (size_t i = 0; i < n; ++i) {
+        const double gx = xs[i] * xScale;
+        const double gy = ys[i] * kSimilarityMetersPerDegree;
+        minX = std::min(minX, gx);
+        maxX = std::max(maxX, gx);
+        minY = std::min(minY, gy);
+        maxY = std::max(maxY, gy);
+        if (i > 0) {
+            length += std::hypot(gx - xs[i - 1] * xScale, gy - ys[i - 1] * kSimilarityMetersPerDegree);
+        }
+    }
+
+    const size_t segmentCount = n > 1 ? n - 1 : 1;
+    cellSize = cellMeters > 0.0 ? cellMeters : std::max(kSimilarityMinCellMeters, 2.0 * length / segmentCount);
+    const double width = maxX - minX;
+    const double height = maxY - minY;
+    const double maxCells = kSimilarityMaxCellsPerSegment * segmentCount + 1024.0;
+    const double cellCount = (width / cellSize + 1.0) * (height / cellSize + 1.0);
+    if (cellCount > maxCells) {
+        cellSize *= std::sqrt(cellCount / maxCells);
+    }
+    columns = static_cast<int>(width / cellSize) + 1;
+    rows = static_cast<int>(height / cellSize) + 1;
+
+    // 每条线段登记到它穿过的网格（DDA 遍历），两遍构建 CSR
+    cellStart.assign(static_cast<size_t>(columns) * rows + 1, 0);
+    auto traverse = [&](uint32_t segment, auto&& visit) {
+        const size_t a = segment;
+        const size_t b = std::min<size_t>(segment + 1, n - 1);
+        const double fx0 = (xs[a] * xScale - minX) / cellSize;
+        const double fy0 = (ys[a] * kSimilarityMetersPerDegree - minY) / cellSize;
+        const double fx1 = (xs[b] * xScale - minX) / cellSize;
+        const double fy1 = (ys[b] * kSimilarityMetersPerDegree - minY) / cellSize;
+        int cx = std::min(static_cast<int>(fx0), columns - 1);
+        int cy = std::min(static_cast<int>(fy0), rows - 1);
+        const int ex = std::min(static_cast<int>(fx1), columns - 1);
+        const int ey = std::min(static_cast<int>(fy1), rows - 1);
+        const double dx = fx1 - fx0;
+        const double dy = fy1 - fy0;
+        const int stepX = dx > 0.0 ? 1 : -1;
+        const int stepY = dy > 0.0 ? 1 : -1;
+        const double tDeltaX = dx != 0.0 ? std::abs(1.0 / dx) : kSimilarityInfinity;
+        const double tDeltaY = dy != 0.0 ? std::abs(1.0 / dy) : kSimilarityInfinity;
+        double tMaxX = dx > 0.0 ? (cx + 1 - fx0) / dx : (dx < 0.0 ? (fx0 - cx) / -dx : kSimilarityInfinity);
+        double tMaxY = dy > 0.0 ? (cy + 1 - fy0) / dy : (dy < 0.0 ? (fy0 - cy) / -dy : kSimilarityInfinity);
+        visit(static_cast<size_t>(cy) * columns + cx);
+        int steps = std::abs(ex - cx) + std::abs(ey - cy);
+        while ((cx != ex || cy != ey) && steps-- > 0) {
+            if (tMaxX < tMaxY) {
+                cx += stepX;
+                tMaxX += tDeltaX;
+            } else {
+                cy += stepY;
+                tMaxY += tDeltaY;
+            }
+            if (cx < 0 || cy < 0 || cx >= columns || cy >= rows) break;
+            visit(static_cast<size_t>(cy) * columns + cx);
+        }
+    };
+
+    for (uint32_t s = 0; s < segmentCount; ++s) {
+        traverse(s, [&](size_t cell) { ++cellStart[cell + 1]; });
+    }
+    for (size_t c = 1; c < cellStart.size(); ++c) {
+        cellStart[c] += cellStart[c - 1];
+    }
+    cellSegments.resize(cellStart.back());
+    std::vector<uint32_t> cursor(cellStart.begin(), cellStart.end() - 1);
+    for (uint32_t s = 0; s < segmentCount; ++s) {
+        traverse(s, [&](size_t cell) { cellSegments[cursor[cell]++] = s; });
+    }
+}
+
+double PathSegmentIndex::pointToSegment(double qx, double qy, double scale, uint32_t segment) const {
+    const size_t a = segment;
+    const size_t b = std::min<size_t>(segment + 1, xs.size() - 1);
+    const double ax = (xs[a] - qx) * scale;
+    const double ay = (ys[a] - qy) * kSimilarityMetersPerDegree;
+    const double dx = (xs[b] - xs[a]) * scale;
+    const double dy = (ys[b] - ys[a]) * kSimilarityMetersPerDegree;
+    const double l2 = dx * dx + dy * dy;
+    double t = l2 > 0.0 ? -(ax * dx + ay * dy) / l2 : 0.0;
+    t = std::max(0.0, std::min(1.0, t));
+    const double px = ax + t * dx;
+    const double py = ay + t * dy;
+    return std::sqrt(px * px + py * py);
+}
+
+double PathSegmentIndex::distanceTo(double lat, double lon, double maxDistanceMeters, double stopBelowMeters) const {
+    if (xs.empty()) return kSimilarityInfinity;
+
+    const double qx = refLon + similarity_wrapLon(lon - refLon);
+    const double cosLat = similarity_cosDeg(lat);
+    const double scale = kSimilarityMetersPerDegree * cosLat;
+    const double gx = (qx * kSimilarityMetersPerDegree * cosRef - minX) / cellSize;
+    const double gy = (lat * kSimilarityMetersPerDegree - minY) / cellSize;
+    const int cx = static_cast<int>(std::floor(gx));
+    const int cy = static_cast<int>(std::floor(gy));
+
+    // 从覆盖网格的第一圈开始，逐圈向外
+    const int startRing = std::max({0, -cx, cx - (columns - 1), -cy, cy - (rows - 1)});
+    const int endRing = std::max({cx, columns - 1 - cx, cy, rows - 1 - cy});
+    const double ringBound = cellSize * std::min(cosMin, cosLat) / cosRef;
+    double best = kSimilarityInfinity;
+
+    for (int r = startRing; r <= endRing; ++r) {
+        // 第 r 圈网格与查询点的距离不小于 (r - 1) 个网格
+        const double lowerBound = (r - 1) * ringBound;
+        if (best <= lowerBound || lowerBound > maxDistanceMeters) break;
+
+        const int x0 = std::max(cx - r, 0);
+        const int x1 = std::min(cx + r, columns - 1);
+        const int y0 = std::max(cy - r, 0);
+        const int y1 = std::min(cy + r, rows - 1);
+        for (int y = y0; y <= y1; ++y) {
+            const bool edgeRow = y == cy - r || y == cy + r;
+            const int step = (edgeRow || r == 0) ? 1 : 2 * r;
+            for (int x = edgeRow ? x0 : cx - r; x <= x1; x += step) {
+                if (x < x0) continue;
+                const size_t cell = static_cast<size_t>(y) * columns + x;
+                for (uint32_t k = cellStart[cell]; k < cellStart[cell + 1]; ++k) {
+                    best = std::min(best, pointToSegment(qx, lat, scale, cellSegments[k]));
+                }
+            }
+        }
+        if (best <= stopBelowMeters) break;
+    }
+    return best <= maxDistanceMeters ? best : kSimilarityInfinity;
+}
+
+PathDeviation measurePathDeviation(const PathSegmentIndex& path, const CoordSpan& points, double thresholdMeters) {
+    PathDeviation result;
+    if (points.empty() || path.pointCount() == 0) return result;
+    double sum = 0.0;
+    for (size_t i = 0; i < points.size(); ++i) {
+        const double d = path.distanceTo(points.latAt(i), points.lonAt(i));
+        sum += d;
+        result.maxMeters = std::max(result.maxMeters, d);
+        if (d > thresholdMeters) ++result.exceededCount;
+    }
+    result.averageMeters = sum / points.size();
+    return result;
+}
+
+double directedHausdorffDistance(const PathSegmentIndex& to, const CoordSpan& from, double thresholdMeters) {
+    if (from.empty()) return 0.0;
+    if (to.pointCount() == 0) return kSimilarityInfinity;
+    // 只需要知道每个点是否比当前最大值更远：找到不超过当前最大值的线段即可跳过该点
+    double result = 0.0;
+    for (size_t i = 0; i < from.size(); ++i) {
+        const double d = to.distanceTo(from.latAt(i), from.lonAt(i), thresholdMeters, result);
+        if (d == kSimilarityInfinity) return kSimilarityInfinity;
+        result = std::max(result, d);
+    }
+    return result;
+}
+
+double hausdorffDistance(const CoordSpan& a, const CoordSpan& b, double thresholdMeters) {
+    if (a.empty() && b.empty()) return 0.0;
+    if (a.empty() || b.empty()) return kSimilarityInfinity;
+    const double ab = directedHausdorffDistance(PathSegmentIndex(b), a, thresholdMeters);
+    if (ab == kSimilarityInfinity) return ab;
+    const double ba = directedHausdorffDistance(PathSegmentIndex(a), b, thresholdMeters);
+    return std::max(ab, ba);
+}
+
+namespace {
+
+// Fréchet 动态规划用的顶点表：经纬度与纬度余弦，距离平方在两点平均纬度处的等距投影上计算
+struct similarity_FrechetPoints {
+    std::vector<double> lat;
+    std::vector<double> lon;
+    std::vector<double> cosLat;
+
+    explicit similarity_FrechetPoints(const CoordSpan& points)
+        : lat(points.size()), lon(points.size()), cosLat(points.size()) {
+        for (size_t i = 0; i < points.size(); ++i) {
+            lat[i] = points.latAt(i);
+            lon[i] = points.lonAt(i);
+            cosLat[i] = similarity_cosDeg(lat[i]);
+        }
+    }
+};
+
+inline double similarity_distanceSq(const similarity_FrechetPoints& a, size_t i, const similarity_FrechetPoints& b, size_t j) {
+    const double dy = a.lat[i] - b.lat[j];
+    const double dx = similarity_wrapLon(a.lon[i] - b.lon[j]) * 0.5 * (a.cosLat[i] + b.cosLat[j]);
+    return (dx * dx + dy * dy) * (kSimilarityMetersPerDegree * kSimilarityMetersPerDegree);
+}
+
+}
+
+double discreteFrechetDistance(const CoordSpan& a, const CoordSpan& b, double thresholdMeters) {
+    const size_t n = a.size();
+    const size_t m = b.size();
+    if (n == 0 && m == 0) return 0.0;
+    if (n == 0 || m == 0) return kSimilarityInfinity;
+
+    const similarity_FrechetPoints pa(a);
+    const similarity_FrechetPoints pb(b);
+
+    // 贪心匹配：每步走向三个后继中最近的一对，得到一个合法耦合，其最大距离是 Fréchet 距离的上界
+    double upper = similarity_distanceSq(pa, 0, pb, 0);
+    for (size_t i = 0, j = 0; i + 1 < n || j + 1 < m;) {
+        double best = kSimilarityInfinity;
+        int move = 0;
+        if (i + 1 < n && j + 1 < m) {
+            best = similarity_distanceSq(pa, i + 1, pb, j + 1);
+            move = 3;
+        }
+        if (i + 1 < n) {
+            const double d = similarity_distanceSq(pa, i + 1, pb, j);
+            if (d < best) { best = d; move = 1; }
+        }
+        if (j + 1 < m) {
+            const double d = similarity_distanceSq(pa, i, pb, j + 1);
+            if (d < best) { best = d; move = 2; }
+        }
+        if (move & 1) ++i;
+        if (move & 2) ++j;
+        upper = std::max(upper, best);
+    }
+
+    const double threshold2 = thresholdMeters * thresholdMeters;
+    const double limit = std::min(upper, threshold2);
+
+    // 带状动态规划：只保留值不超过 limit 的格子，每行从上一行的第一个有效列开始，
+    // 超过上一行最后一个有效列且左侧不可达时结束
+    std::vector<double> prev(m, kSimilarityInfinity);
+    std::vector<double> cur(m, kSimilarityInfinity);
+    size_t prevLo = 0;
+    size_t prevHi = 0;
+
+    double value = similarity_distanceSq(pa, 0, pb, 0);
+    if (value > limit) return kSimilarityInfinity;
+    prev[0] = value;
+    for (size_t j = 1; j < m; ++j) {
+        value = std::max(value, similarity_distanceSq(pa, 0, pb, j));
+        if (value > limit) break;
+        prev[j] = value;
+        prevHi = j;
+    }
+
+    for (size_t i = 1; i < n; ++i) {
+        bool found = false;
+        size_t lo = 0;
+        size_t hi = 0;
+        double left = kSimilarityInfinity;
+        for (size_t j = prevLo; j < m; ++j) {
+            double best = left;
+            if (j <= prevHi) best = std::min(best, prev[j]);
+            if (j > prevLo && j - 1 <= prevHi) best = std::min(best, prev[j - 1]);
+            if (best == kSimilarityInfinity) {
+                if (j > prevHi) break;
+                cur[j] = kSimilarityInfinity;
+                left = kSimilarityInfinity;
+                continue;
+            }
+            double v = std::max(similarity_distanceSq(pa, i, pb, j), best);
+            if (v > limit) v = kSimilarityInfinity;
+            cur[j] = v;
+            left = v;
+            if (v != kSimilarityInfinity) {
+                if (!found) lo = j;
+                found = true;
+                hi = j;
+            }
+        }
+        if (!found) return kSimilarityInfinity;
+        prev.swap(cur);
+        prevLo = lo;
+        prevHi = hi;
+    }
+
+    if (prevHi != m - 1) return kSimilarityInfinity;
+    return std::sqrt(prev[m - 1]);
+}
+
+}
@@ -8,6 +8,16 @@ clang++ -std=c++17 \
     ../ColorParser.cpp \
     ../ClusterEngine.cpp \
     ../QuadTree.cpp \
+    ../HeatmapRasterizer.cpp \
+    ../HeatmapAccumulator.cpp \
+    ../CellId.cpp \
+    ../CollisionEngine.cpp \
+    ../Geodesic.cpp \
+    ../PolygonClipper.cpp \
+    ../Triangulator.cpp \
+    ../TrajectoryAnalyzer.cpp \
+    ../GpsSmoother.cpp \
+    ../PathSimilarity.cpp \
     -o test_runner
 
 # Run the test
@@ -3,6 +3,7 @@ import {
   dedupeAdjacentPoints,
   normalizeWebRoutePolyline,
   parsePolyline,
+  samplePolyline,
 } from '../route-geometry';
 
 describe('route-geometry helpers', () => {
@@ -10,6 +11,8 @@ describe('route-geometry helpers', () => {
     core: {
       distanceBetweenCoordinates: jest.Mock;
       simplifyPolyline: jest.Mock;
+      parsePolyline: jest.Mock;
+      resamplePolylineByCount: jest.Mock;
     };
   };
 
@@ -41,6 +44,38 @@ describe('route-geometry helpers', () => {
     ]);
   });
 
+  it('parsePolyline 优先使用原生解析结果', () => {
+    nativeMocks.core.parsePolyline.mockReturnValueOnce([
+      { latitude: 39.9, longitude: 116.4 },
+    ]);
+    expect(parsePolyline('116.4,39.9')).toEqual([{ latitude: 39.9, longitude: 116.4 }]);
+    expect(nativeMocks.core.parsePolyline).toHaveBeenCalledWith('116.4,39.9');
+  });
+
+  it('parsePolyline 的 JS 回退与原生一致，拒绝带多余字符的数值', () => {
+    expect(parsePolyline('116.1abc,39.9;116.2,39.9')).toEqual([
+      { latitude: 39.9, longitude: 116.2 },
+    ]);
+  });
+
+  it('samplePolyline 优先使用原生等距重采样', () => {
+    const resampled = [
+      { latitude: 39.9, longitude: 116.4 },
+      { latitude: 39.903, longitude: 116.403 },
+    ];
+    nativeMocks.core.resamplePolylineByCount.mockReturnValueOnce(resampled);
+    expect(samplePolyline(routePoints, 2)).toEqual(resampled);
+    expect(nativeMocks.core.resamplePolylineByCount).toHaveBeenCalledWith(routePoints, 2);
+  });
+
+  it('samplePolyline 原生不可用时回退到按下标抽样并保留终点', () => {
+    expect(samplePolyline(routePoints, 2)).toEqual([
+      { latitude: 39.9, longitude: 116.4 },
+      { latitude: 39.902, longitude: 116.402 },
+      { latitude: 39.903, longitude: 116.403 },
+    ]);
+  });
+
   it('normalizeWebRoutePolyline 会优先使用主折线，必要时回退到 steps', () => {
     expect(
       normalizeWebRoutePolyline({
@@ -7,6 +7,7 @@ describe('web-route-following', () => {
       simplifyPolyline: jest.Mock;
       getNearestPointOnPath: jest.Mock;
       calculatePathLength: jest.Mock;
+      comparePaths: jest.Mock;
     };
     navigation: {
       independentDriveRoute: jest.Mock;
@@ -88,6 +89,74 @@ describe('web-route-following', () => {
     expect(result.averageDeviationMeters).toBeGreaterThan(120);
   });
 
+  it('优先用原生 comparePaths 给候选路线打分', async () => {
+    const webPolyline = [
+      { latitude: 39.9, longitude: 116.4 },
+      { latitude: 39.905, longitude: 116.405 },
+      { latitude: 39.91, longitude: 116.41 },
+    ];
+    const routePolyline = [
+      { latitude: 39.9, longitude: 116.4 },
+      { latitude: 39.906, longitude: 116.404 },
+      { latitude: 39.91, longitude: 116.41 },
+    ];
+    nativeMocks.navigation.independentDriveRoute.mockResolvedValue({
+      independent: true,
+      token: 302,
+      count: 1,
+      mainPathIndex: 0,
+      routeIds: [12],
+      routes: [
+        {
+          id: 12,
+          start: { latitude: 39.9, longitude: 116.4 },
+          end: { latitude: 39.91, longitude: 116.41 },
+          distance: 1000,
+          duration: 600,
+          segments: [],
+          polyline: routePolyline,
+        },
+      ],
+    });
+    nativeMocks.core.comparePaths
+      .mockReturnValueOnce({
+        averageDeviationMeters: 150,
+        maxDeviationMeters: 400,
+        exceededCount: 2,
+        hausdorffMeters: 400,
+        frechetMeters: 420,
+      })
+      .mockReturnValueOnce({
+        averageDeviationMeters: 0,
+        maxDeviationMeters: 200,
+        exceededCount: 1,
+        hausdorffMeters: 200,
+        frechetMeters: 200,
+      });
+
+    const result = await followWebPlannedRoute({
+      from: { latitude: 39.9, longitude: 116.4 },
+      to: { latitude: 39.91, longitude: 116.41 },
+      webRoute: { polyline: webPolyline },
+      maxDeviationMeters: 120,
+    });
+
+    expect(nativeMocks.core.comparePaths).toHaveBeenNthCalledWith(1, webPolyline, routePolyline, 120);
+    expect(nativeMocks.core.comparePaths).toHaveBeenNthCalledWith(
+      2,
+      routePolyline,
+      [{ latitude: 39.905, longitude: 116.405 }],
+      120
+    );
+    expect(nativeMocks.core.getNearestPointOnPath).not.toHaveBeenCalled();
+    expect(result.candidateMatches[0]).toMatchObject({
+      averageDeviationMeters: 150,
+      maxDeviationMeters: 400,
+      missedAnchorCount: 1,
+    });
+    expect(result.mode).toBe('preview_only');
+  });
+
   it('会在 Web 线路点数不足时直接报错', async () => {
     await expect(
       followWebPlannedRoute({
@@ -225,7 +225,7 @@ export enum MapType {
 /**
  * 颜色值类型
  * 支持：
- * - 十六进制字符串: '#AARRGGBB' 或 '#RRGGBB'
+ * - 颜色字符串: '#RRGGBB'、'#RRGGBBAA'（透明度在最后）、'rgba(...)'、'hsl(...)' 或颜色名称
  * - 数字格式: 0xAARRGGBB (用于 Android)
  */
 export type ColorValue = string | number;
@@ -384,6 +384,29 @@ export interface ExpoGaodeMapModule extends NativeModule<ExpoGaodeMapModuleEvent
    */
   simplifyPolyline(points: LatLngPoint[], tolerance: number): LatLng[];
 
+  /**
+   * 沿路径按距离等距取 count 个点（含首尾）
+   * @param points 路径点
+   * @param count 点数
+   * @returns 重采样后的路径点
+   */
+  resamplePolylineByCount(points: LatLngPoint[], count: number): LatLng[];
+
+  /**
+   * 比较候选路线与参考路线（如 Web 规划线）的相似程度
+   * @param reference 参考路线
+   * @param points 候选路线
+   * @param thresholdMeters 统计超限顶点数的距离阈值(米)
+   * @returns 候选路线顶点到参考路线的平均/最大偏差、超限顶点数，以及双向 Hausdorff 与离散 Fréchet 距离；任一路线为空时返回 null
+   */
+  comparePaths(reference: LatLngPoint[], points: LatLngPoint[], thresholdMeters: number): {
+    averageDeviationMeters: number;
+    maxDeviationMeters: number;
+    exceededCount: number;
+    hausdorffMeters: number;
+    frechetMeters: number;
+  } | null;
+
   /**
    * 计算路径总长度
    * @param points 路径点
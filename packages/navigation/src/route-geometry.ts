@@ -6,11 +6,28 @@ import type {
 } from './types';
 
 
+/**
+ * 解析 "lng,lat;lng,lat" 字符串：优先走原生单次扫描，原生不可用时回退到 JS 实现
+ * 两者规则一致：跳过非法片段，数值后带多余字符（如 "116.1abc"）的片段视为非法
+ */
 export function parsePolyline(polyline?: string): NaviPoint[] {
   if (!polyline?.trim()) {
     return [];
   }
 
+  try {
+    const nativePoints = ExpoGaodeMapModule.parsePolyline(polyline);
+    if (nativePoints.length > 0) {
+      return nativePoints.map(({ latitude, longitude }) => ({ latitude, longitude }));
+    }
+  } catch {
+    // 回退到 JS 解析
+  }
+
+  return parsePolylineInJs(polyline);
+}
+
+function parsePolylineInJs(polyline: string): NaviPoint[] {
   return polyline
     .split(';')
     .map((segment) => segment.trim())
@@ -122,11 +139,65 @@ export function getDistanceToPathSafe(path: NaviPoint[], target: NaviPoint): num
   }, Number.POSITIVE_INFINITY);
 }
 
+/**
+ * 统计 points 各点到 reference 折线距离的平均值、最大值与超过阈值的点数
+ * 优先走原生 comparePaths（一次调用，线段网格索引剪枝），原生不可用时回退到逐点 getDistanceToPathSafe
+ */
+export function measurePathDeviationSafe(
+  reference: NaviPoint[],
+  points: NaviPoint[],
+  thresholdMeters: number
+): { averageDeviationMeters: number; maxDeviationMeters: number; exceededCount: number } {
+  if (points.length === 0) {
+    return { averageDeviationMeters: 0, maxDeviationMeters: 0, exceededCount: 0 };
+  }
+
+  if (reference.length > 0) {
+    try {
+      const comparison = ExpoGaodeMapModule.comparePaths(reference, points, thresholdMeters);
+      if (comparison) {
+        return {
+          averageDeviationMeters: comparison.averageDeviationMeters,
+          maxDeviationMeters: comparison.maxDeviationMeters,
+          exceededCount: comparison.exceededCount,
+        };
+      }
+    } catch {
+      // 回退到逐点计算
+    }
+  }
+
+  const distances = points.map((point) => getDistanceToPathSafe(reference, point));
+  return {
+    averageDeviationMeters:
+      distances.reduce((total, distance) => total + distance, 0) / distances.length,
+    maxDeviationMeters: Math.max(...distances),
+    exceededCount: distances.filter((distance) => distance > thresholdMeters).length,
+  };
+}
+
+/**
+ * 沿折线取约 targetSamples 个采样点：优先走原生按距离等距重采样，
+ * 原生不可用时回退到按下标等间隔抽取（顶点疏密不均时采样也随之不均）
+ */
 export function samplePolyline(points: NaviPoint[], targetSamples = 36): NaviPoint[] {
   if (points.length <= targetSamples) {
     return points;
   }
 
+  try {
+    const resampled = ExpoGaodeMapModule.resamplePolylineByCount(points, targetSamples);
+    if (resampled.length >= 2) {
+      return resampled.map(({ latitude, longitude }) => ({ latitude, longitude }));
+    }
+  } catch {
+    // 回退到 JS 抽样
+  }
+
+  return samplePolylineInJs(points, targetSamples);
+}
+
+function samplePolylineInJs(points: NaviPoint[], targetSamples: number): NaviPoint[] {
   const step = Math.max(1, Math.floor(points.length / targetSamples));
   const samples = points.filter((_, index) => index % step === 0);
   const lastPoint = points[points.length - 1];
@@ -145,6 +216,10 @@ export function samplePolyline(points: NaviPoint[], targetSamples = 36): NaviPoi
   return samples;
 }
 
+/**
+ * 从候选点中按下标均匀挑选 count 个
+ * 结果必须是候选点本身（作为途经点要落在 Web 线路上），不能换成沿线插值的重采样，因此保留 JS 实现
+ */
 export function selectEvenlySpacedPoints(points: NaviPoint[], count: number): NaviPoint[] {
   if (count <= 0 || points.length <= count) {
     return points;
@@ -1,5 +1,5 @@
 import ExpoGaodeMapNavigationModule from './ExpoGaodeMapNavigationModule';
-import { buildAnchorWaypointsFromWebRoute, calculatePathLengthSafe, dedupeAdjacentPoints, getDistanceToPathSafe, normalizeWebRoutePolyline, samplePolyline } from './route-geometry';
+import { buildAnchorWaypointsFromWebRoute, calculatePathLengthSafe, dedupeAdjacentPoints, measurePathDeviationSafe, normalizeWebRoutePolyline, samplePolyline } from './route-geometry';
 import type {
   FollowWebPlannedRouteCandidate,
   FollowWebPlannedRouteOptions,
@@ -65,17 +65,17 @@ function scoreIndependentRouteAgainstWebPolyline(
     return null;
   }
 
-  const sampledNativePoints = samplePolyline(nativePolyline);
-  const pointDistances = sampledNativePoints.map((point) =>
-    getDistanceToPathSafe(webPolyline, point)
+  // 偏差与漏掉的锚点各走一次原生比较，原生不可用时回退到逐点求距离
+  const { averageDeviationMeters, maxDeviationMeters } = measurePathDeviationSafe(
+    webPolyline,
+    samplePolyline(nativePolyline),
+    thresholdMeters
   );
-  const averageDeviationMeters =
-    pointDistances.reduce((total, distance) => total + distance, 0) / pointDistances.length;
-  const maxDeviationMeters = Math.max(...pointDistances);
-
-  const missedAnchorCount = anchorWaypoints.reduce((count, point) => (
-    getDistanceToPathSafe(nativePolyline, point) > thresholdMeters ? count + 1 : count
-  ), 0);
+  const missedAnchorCount = measurePathDeviationSafe(
+    nativePolyline,
+    anchorWaypoints,
+    thresholdMeters
+  ).exceededCount;
 
   return {
     routeId: resolveIndependentRouteId(result, route, routeIndex),